@@ -300,9 +300,17 @@ class Index
       // Loads the cache if the node is in a deeper level.
       Node[] cacheAux = cache;
       int j = INDEX_CACHE_SIZE;
+      LitebaseConnection driver = table.db.driver;
       while (--j >= 0)  
          if (cacheAux[j] != null && cacheAux[j].idx == idx)
+         {
+            if (driver != null)
+               driver.nodePoolHits++;
             return cacheAux[cacheI = j];
+         }
+      
+      if (driver != null)
+         driver.nodePoolMisses++;
       
       if (++cacheI >= INDEX_CACHE_SIZE)
          cacheI = 0;
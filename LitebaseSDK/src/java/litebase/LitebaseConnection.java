@@ -68,6 +68,11 @@ public class LitebaseConnection
     */
    public static boolean logOnlyChanges;
 
+   /**
+    * The memory budget of the hash tables used by the joins that compare a column without an index with an equality.
+    */
+   private static int joinMemoryBudget = 2097152;
+
    /**
     * Given the table name, returns the Table object.
     */
@@ -103,6 +108,17 @@ public class LitebaseConnection
     */
    private boolean useCrypto; // juliana@253_8: now Litebase supports weak cryptography.
    
+   /**
+    * Indicates if this connection was opened with the <code>wal</code> parameter. The tables are written directly here, so only the transaction 
+    * state is kept in order to behave like the device.
+    */
+   private boolean useWal;
+   
+   /**
+    * Indicates if a transaction was started by a <code>begin</code> command.
+    */
+   private boolean inTransaction;
+   
    // juliana@224_2: improved memory usage on BlackBerry.
    /**
     * A temporary date object.
@@ -125,6 +141,22 @@ public class LitebaseConnection
     */
    int[] nodes = new int[Node.MAX_IDX];
    
+   /**
+    * The memory budget of the index nodes. It is only kept for compatibility with the device, where the nodes of the deeper index levels are 
+    * shared by all the tables of the connection.
+    */
+   private int nodePoolBudget = 262144;
+   
+   /**
+    * How many times a node of a deeper index level was already loaded.
+    */
+   long nodePoolHits;
+   
+   /**
+    * How many times a node of a deeper index level had to be loaded.
+    */
+   long nodePoolMisses;
+   
    /**
     * A temporary buffer for strings.
     */
@@ -202,10 +234,12 @@ public class LitebaseConnection
     *
     * @param appCrid The creator id, which may be the same one of the current application and MUST be 4 characters long.
     * @param params Only the folder where it is desired to store the tables, <code>null</code>, if it is desired to use the current data 
-    * path, or <code>chars_type = chars_format; path = source_path[;crypto] </code>, where <code>chars_format</code> can be <code>ascii</code> or 
-    * <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, and crypto must be used if the tables of the 
-    * connection use cryptography. The params can be entered in any order. If only the path is passed as a parameter, unicode is used and there is no 
-    * cryptography. Notice that path must be absolute, not relative.
+    * path, or <code>chars_type = chars_format; path = source_path[;crypto][;wal][;mmap] </code>, where <code>chars_format</code> can be 
+    * <code>ascii</code> or <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, crypto must be used if 
+    * the tables of the connection use cryptography, wal makes the changes be written to a write-ahead log and committed after each command or 
+    * by <code>executeUpdate("commit")</code> after a <code>executeUpdate("begin")</code>, and mmap maps the table files into memory on POSIX 
+    * systems, so that reading them does not need a system call. The params can be entered in any order. If only the path 
+    * is passed as a parameter, unicode is used and there is no cryptography. Notice that path must be absolute, not relative.
     * <p>Note that databases belonging to multiple applications can be stored in the same path, since all tables are prefixed by the application's 
     * creator id.
     * <p>Also notice that to store Litebase files on card on Pocket PC, just set the second parameter to the correct directory path.
@@ -257,6 +291,10 @@ public class LitebaseConnection
                      path = tempParam.substring(tempParam.indexOf('=') + 1).trim();
                   else if (tempParam.startsWith("crypto")) // Cryptography param.
                      conn.useCrypto = true;
+                  else if (tempParam.equals("wal")) // Write-ahead log param.
+                     conn.useWal = true;
+                  else if (tempParam.equals("mmap")) // Memory-mapped files param: the files are already accessed directly by the JDK.
+                     continue;
                   else if (paramsSeparated.length == 1)
                      path = params; // Things do not change if there is only one parameter that is the path.
                   else // Invalid parameter // juliana@253_11: now a DriverException will be throw if an incorrect parameter is passed in LitebaseConnection.getInstance().
@@ -339,6 +377,8 @@ public class LitebaseConnection
             logger.log(Logger.INFO, sql, false);
          }
 
+      checkNoTransaction(); // Tables and indices can't be created inside a transaction.
+      
       try
       {
          int i;
@@ -499,6 +539,8 @@ public class LitebaseConnection
             }
             driverCreateTable(tableName, names, hashes, types, sizes, columnAttrs, defaultValues, primaryKeyCol, composedPK, composedPKCols);
          }
+         else if (parser.command == SQLElement.CMD_CREATE_INDEX && parser.isTrigram) 
+            checkTrigramColumn(getTable(parser.tableList[0].tableName), parser); // Only the native version keeps trigram indices.
          else if (parser.command == SQLElement.CMD_CREATE_INDEX)
          {
             // indexTableName ignored - formed internally.
@@ -593,11 +635,21 @@ public class LitebaseConnection
          
          switch (parser.command)
          {
+            case SQLElement.CMD_BEGIN: // BEGIN
+            case SQLElement.CMD_COMMIT: // COMMIT
+               litebaseTransaction(parser.command == SQLElement.CMD_BEGIN);
+               return 0;
             case SQLElement.CMD_DROP_TABLE: // DROP TABLE
+               checkNoTransaction();
                litebaseExecuteDropTable(parser);
                return 0;
             case SQLElement.CMD_DROP_INDEX: // DROP INDEX
+               checkNoTransaction();
                return litebaseExecuteDropIndex(parser);
+            case SQLElement.CMD_ANALYZE: // ANALYZE
+               checkNoTransaction();
+               getTable(parser.tableList[0].tableName); // There are no statistics here, but the table must exist.
+               return 0;
             case SQLElement.CMD_INSERT: // INSERT
                new SQLInsertStatement(parser, this).litebaseBindInsertStatement().litebaseDoInsert(this);
                return 1;
@@ -610,6 +662,7 @@ public class LitebaseConnection
             case SQLElement.CMD_ALTER_RENAME_TABLE: // RENAME TABLE
             case SQLElement.CMD_ALTER_RENAME_COLUMN: // RENAME COLUMN
             case SQLElement.CMD_ALTER_ADD_COLUMN: // ADD COLUMN // juliana@253_22: added command ALTER TABLE ADD column.
+               checkNoTransaction();
                litebaseExecuteAlter(parser); 
                return 0;
          }
@@ -629,6 +682,35 @@ public class LitebaseConnection
       return -1;
    }
 
+   /**
+    * Executes a <code>begin</code> or a <code>commit</code> command. 
+    *
+    * @param begin Indicates if the command is a <code>begin</code> or a <code>commit</code>.
+    * @throws DriverException If the connection was not opened with the <code>wal</code> parameter, a transaction is already started on a 
+    * <code>begin</code>, or there is no transaction on a <code>commit</code>.
+    */
+   private void litebaseTransaction(boolean begin) throws DriverException
+   {
+      if (!useWal)
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_WAL_DISABLED));
+      if (begin && inTransaction)
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_TRANSACTION_STARTED));
+      if (!begin && !inTransaction)
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_NO_TRANSACTION));
+      inTransaction = begin;
+   }
+   
+   /**
+    * Checks that there is no transaction in progress before a command which changes the table files directly.
+    *
+    * @throws DriverException If there is a transaction in progress.
+    */
+   private void checkNoTransaction() throws DriverException
+   {
+      if (inTransaction)
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_TRANSACTION_DDL));
+   }
+
    // juliana@253_22: added command ALTER TABLE ADD column.
    /**
     * Executes an alter statement.
@@ -1030,6 +1112,27 @@ public class LitebaseConnection
       }
    }
 
+   /**
+    * Checks the column of a trigram index created or dropped. The JDK version does not keep trigram indices, so <code>LIKE</code> reads all the 
+    * rows.
+    * 
+    * @param table The table of the index.
+    * @param parser The parser.
+    * @throws DriverException If the index does not have a single column or if it is not a <code>CHAR</code> or <code>VARCHAR</code> column.
+    */
+   private void checkTrigramColumn(Table table, LitebaseParser parser) throws DriverException
+   {
+      int column, 
+          type;
+      
+      if (parser.fieldNamesSize != 1)
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_TRIGRAM_INDEX));
+      if ((column = table.htName2index.get(parser.fieldNames[0].hashCode(), -1)) == -1) // Unknown column.
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_INVALID_COLUMN_NAME) + parser.fieldNames[0]);
+      if ((type = table.columnTypes[column]) != SQLElement.CHARS && type != SQLElement.CHARS_NOCASE)
+         throw new DriverException(LitebaseMessage.getMessage(LitebaseMessage.ERR_TRIGRAM_INDEX));
+   }
+   
    /**
     * Drops an index.
     * 
@@ -1052,6 +1155,8 @@ public class LitebaseConnection
       
       if (colName.equals("*")) // Drops all the indices.
          n = table.deleteAllIndices();
+      else if (parser.isTrigram) // Only the native version keeps trigram indices.
+         checkTrigramColumn(table, parser);
       else // Drops an especific index.
       if (parser.fieldNamesSize == 1) // Simple index.
       {
@@ -1356,6 +1461,39 @@ public class LitebaseConnection
       catch (InvalidDateException exception) {}
    }
 
+   /**
+    * Turns the bulk insertion mode of a table on or off. On the device, while it is on, the rows inserted or updated in the table only update its
+    * primary key and the other indices are rebuilt from their sorted keys when the mode is turned off, before the table is used by a query, an 
+    * update, or a delete, and when the connection is closed. This implementation keeps updating the indices on every insertion.
+    * 
+    * @param tableName The associated table name.
+    * @param bulk Indicates if the bulk insertion mode is to be turned on or off.
+    * @throws IllegalStateException If the driver is closed.
+    * @throws DriverException If an <code>IOException</code> occurs.
+    */
+   public void setBulkInsert(String tableName, boolean bulk) throws DriverException, IllegalStateException
+   {
+      if (htTables == null) // The driver can't be closed.
+         throw new IllegalStateException(LitebaseMessage.getMessage(LitebaseMessage.ERR_DRIVER_CLOSED));
+      
+      if (logger != null)
+         synchronized (logger)
+         {
+            sBuffer.setLength(0);
+            logger.logInfo(sBuffer.append("setBulkInsert ").append(tableName).append(' ').append(bulk));
+         }
+      
+      try
+      {
+         getTable(tableName);
+      }
+      catch (IOException exception)
+      {
+         throw new DriverException(exception);
+      }
+      catch (InvalidDateException exception) {}
+   }
+
    // juliana@230_27: if a public method in now called when its object is already closed, now an IllegalStateException will be thrown instead of a 
    // DriverException.
    /**
@@ -1503,6 +1641,8 @@ public class LitebaseConnection
 
          if (deleted > 0 || table.wasUpdated) // juliana@270_27: now purge will also really purge the table if it only suffers updates.
          {
+            checkNoTransaction();
+            
             PlainDB plainDB = table.db;
             NormalFile dbFile = (NormalFile)plainDB.db;
             
@@ -1722,6 +1862,59 @@ public class LitebaseConnection
          return null;
       }
    }
+   
+   /**
+    * Sets the memory budget of the pool of index nodes shared by all the tables of this connection. When the pool grows beyond it, the least 
+    * recently used nodes are evicted, after saving the ones that were changed. The pool always keeps some nodes, whatever its budget is. 
+    * 
+    * @param budget The budget in bytes. Negative values are treated as 0.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public void setNodePoolBudget(int budget) throws IllegalStateException
+   {
+      if (htTables == null) // The driver can't be closed.
+         throw new IllegalStateException(LitebaseMessage.getMessage(LitebaseMessage.ERR_DRIVER_CLOSED));
+      nodePoolBudget = budget < 0? 0 : budget;
+   }
+   
+   /**
+    * Gets the memory budget of the pool of index nodes shared by all the tables of this connection.
+    * 
+    * @return The budget in bytes.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public int getNodePoolBudget() throws IllegalStateException
+   {
+      if (htTables == null) // The driver can't be closed.
+         throw new IllegalStateException(LitebaseMessage.getMessage(LitebaseMessage.ERR_DRIVER_CLOSED));
+      return nodePoolBudget;
+   }
+   
+   /**
+    * Gets how many times an index node was found in the pool of index nodes of this connection.
+    * 
+    * @return The number of hits of the pool.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public long getNodePoolHits() throws IllegalStateException
+   {
+      if (htTables == null) // The driver can't be closed.
+         throw new IllegalStateException(LitebaseMessage.getMessage(LitebaseMessage.ERR_DRIVER_CLOSED));
+      return nodePoolHits;
+   }
+   
+   /**
+    * Gets how many times an index node had to be read into the pool of index nodes of this connection.
+    * 
+    * @return The number of misses of the pool.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public long getNodePoolMisses() throws IllegalStateException
+   {
+      if (htTables == null) // The driver can't be closed.
+         throw new IllegalStateException(LitebaseMessage.getMessage(LitebaseMessage.ERR_DRIVER_CLOSED));
+      return nodePoolMisses;
+   }
 
    // juliana@210_3: LitebaseConnection.getLogger() and LitebaseConnection.setLogger() are no longer deprecated.
    /**
@@ -1745,6 +1938,28 @@ public class LitebaseConnection
       LitebaseConnection.logger = logger;
    }
 
+   /**
+    * Gets the memory budget of the hash tables used by the joins that compare a column without an index with an equality.
+    * 
+    * @return The budget in bytes.
+    */
+   public static synchronized int getJoinMemoryBudget()
+   {
+      return joinMemoryBudget;
+   }
+
+   /**
+    * Sets the memory budget of the hash tables used by the joins that compare a column without an index with an equality. On the device, the 
+    * keys of the inner tables whose hash table is larger than the budget are sorted on a temporary file instead. This implementation only keeps 
+    * the value.
+    * 
+    * @param budget The budget in bytes. Negative values are treated as 0.
+    */
+   public static synchronized void setJoinMemoryBudget(int budget)
+   {
+      joinMemoryBudget = budget < 0? 0 : budget;
+   }
+
    // juliana@230_4: Litebase default logger is now a plain text file instead of a PDB file.                                                                
    /**                                                                                                                                                 
     * Gets the default Litebase logger. When this method is called for the first time, a new text file is created. In the subsequent calls, the same   
@@ -65,6 +65,11 @@ public class LitebaseConnection4D
     */
    int appCrid;
    
+   /**
+    * Indicates if the table files of this connection are mapped into memory.
+    */
+   private boolean useMmap;
+   
    /**
     * Given the table name, returns the Table structure.
     */
@@ -85,6 +90,21 @@ public class LitebaseConnection4D
     */
    long nodes; // juliana@253_6: the maximum number of keys of a index was duplicated. 
    
+   /**
+    * The pool of the index nodes shared by the tables of this connection.
+    */
+   long nodePool;
+   
+   /**
+    * The write-ahead log of this connection, if it was opened with the <code>wal</code> parameter.
+    */
+   long wal;
+   
+   /**
+    * The statements executed without being prepared which are kept parsed by this connection.
+    */
+   long stmtCache;
+   
    /**
     * Indicates if the native library is already attached.
     */
@@ -226,10 +246,12 @@ public class LitebaseConnection4D
     *
     * @param appCrid The creator id, which may be the same one of the current application and MUST be 4 characters long.
     * @param params Only the folder where it is desired to store the tables, <code>null</code>, if it is desired to use the current data 
-    * path, or <code>chars_type = chars_format; path = source_path[;crypto] </code>, where <code>chars_format</code> can be <code>ascii</code> or 
-    * <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, and crypto must be used if the tables of the 
-    * connection use cryptography. The params can be entered in any order. If only the path is passed as a parameter, unicode is used and there is no 
-    * cryptography. Notice that path must be absolute, not relative.
+    * path, or <code>chars_type = chars_format; path = source_path[;crypto][;wal][;mmap] </code>, where <code>chars_format</code> can be 
+    * <code>ascii</code> or <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, crypto must be used if 
+    * the tables of the connection use cryptography, wal makes the changes be written to a write-ahead log and committed after each command or 
+    * by <code>executeUpdate("commit")</code> after a <code>executeUpdate("begin")</code>, and mmap maps the table files into memory on POSIX 
+    * systems, so that reading them does not need a system call. The params can be entered in any order. If only the path 
+    * is passed as a parameter, unicode is used and there is no cryptography. Notice that path must be absolute, not relative.
     * <p>Note that databases belonging to multiple applications can be stored in the same path, since all tables are prefixed by the application's 
     * creator id.
     * <p>Also notice that to store Litebase files on card on Pocket PC, just set the second parameter to the correct directory path.
@@ -368,6 +390,24 @@ public class LitebaseConnection4D
     */
    public native void setRowInc(String tableName, int inc) throws IllegalArgumentException;
 
+   /**
+    * Turns the bulk insertion mode of a table on or off. While it is on, the rows inserted or updated in the table only update its primary key. 
+    * The other indices are rebuilt from their sorted keys, which is much faster than inserting the keys one by one, when the mode is turned off, 
+    * before the table is used by a query, an update, or a delete, and when the connection is closed. Connections with a write-ahead log always 
+    * keep the indices up to date.
+    *
+    * <pre>
+    * driver.setBulkInsert(&quot;table&quot;, true);
+    * // Fetch the data and insert them.
+    * driver.setBulkInsert(&quot;table&quot;, false);
+    * </pre>
+    *
+    * @param tableName The associated table name.
+    * @param bulk Indicates if the bulk insertion mode is to be turned on or off.
+    * @throws DriverException If an index can't be rebuilt.
+    */
+   public native void setBulkInsert(String tableName, boolean bulk) throws DriverException;
+
    // juliana@230_27: if a public method in now called when its object is already closed, now an IllegalStateException will be thrown instead of a 
    // DriverException.
    /**
@@ -429,6 +469,39 @@ public class LitebaseConnection4D
     */
    public native RowIterator4D getRowIterator(String tableName);
 
+   /**
+    * Sets the memory budget of the pool of index nodes shared by all the tables of this connection. When the pool grows beyond it, the least 
+    * recently used nodes are evicted, after saving the ones that were changed. The pool always keeps some nodes, whatever its budget is. 
+    * 
+    * @param budget The budget in bytes. Negative values are treated as 0.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public native void setNodePoolBudget(int budget) throws IllegalStateException;
+   
+   /**
+    * Gets the memory budget of the pool of index nodes shared by all the tables of this connection.
+    * 
+    * @return The budget in bytes.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public native int getNodePoolBudget() throws IllegalStateException;
+   
+   /**
+    * Gets how many times an index node was found in the pool of index nodes of this connection.
+    * 
+    * @return The number of hits of the pool.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public native long getNodePoolHits() throws IllegalStateException;
+   
+   /**
+    * Gets how many times an index node had to be read into the pool of index nodes of this connection.
+    * 
+    * @return The number of misses of the pool.
+    * @throws IllegalStateException If the driver is closed.
+    */
+   public native long getNodePoolMisses() throws IllegalStateException;
+
   // juliana@210_3: LitebaseConnection.getLogger() and LitebaseConnection.setLogger() are no longer deprecated.
   /**
    * Gets the Litebase logger. The fields should be used unless using the logger within threads.
@@ -472,6 +545,45 @@ public class LitebaseConnection4D
     */
    private static native void privateSetLogger(Logger logger);
 
+  /**
+   * Gets the memory budget of the hash tables used by the joins that compare a column without an index with an equality.
+   *
+   * @return The budget in bytes.
+   */
+  public static int getJoinMemoryBudget() {
+    while (!isDriverLoaded) {
+      Thread.yield();
+    }
+    return privateGetJoinMemoryBudget();
+  }
+
+   /**
+    * Gets the memory budget of the hash tables used by the joins that compare a column without an index with an equality.
+    * 
+    * @return The budget in bytes.
+    */
+   private static native int privateGetJoinMemoryBudget();
+
+  /**
+   * Sets the memory budget of the hash tables used by the joins that compare a column without an index with an equality. The keys of the
+   * inner tables whose hash table is larger than the budget are sorted on a temporary file instead, which is slower but uses little memory.
+   *
+   * @param budget The budget in bytes. Negative values are treated as 0, which makes the joins of tables stored on disk always use sorted keys.
+   */
+  public static void setJoinMemoryBudget(int budget) {
+    while (!isDriverLoaded) {
+      Thread.yield();
+    }
+    privateSetJoinMemoryBudget(budget);
+  }
+
+   /**
+    * Sets the memory budget of the hash tables used by the joins that compare a column without an index with an equality.
+    * 
+    * @param budget The budget in bytes.
+    */
+   private static native void privateSetJoinMemoryBudget(int budget);
+
   /**
    * Gets the default Litebase logger. When this method is called for the first time, a new <code>
    * PDBFile</code> is created and a log record started. In the subsequent calls, the same <code>
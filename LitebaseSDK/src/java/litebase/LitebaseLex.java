@@ -128,19 +128,22 @@ class LitebaseLex
 
       // juliana@213_7: changed to Hashtable.
       // Creates and populates the hash table of reserved words.
-      reserved = new ReservedHashtable(61);
+      reserved = new ReservedHashtable(66);
       
       // juliana@224_2: improved memory usage on BlackBerry.
       reserved.put("abs", LitebaseParser.TK_ABS);
       reserved.put("add", LitebaseParser.TK_ADD);
       reserved.put("alter", LitebaseParser.TK_ALTER);
+      reserved.put("analyze", LitebaseParser.TK_ANALYZE);
       reserved.put("and", LitebaseParser.TK_AND);
       reserved.put("as", LitebaseParser.TK_AS);
       reserved.put("asc", LitebaseParser.TK_ASC);
       reserved.put("avg", LitebaseParser.TK_AVG);
+      reserved.put("begin", LitebaseParser.TK_BEGIN);
       reserved.put("blob", LitebaseParser.TK_BLOB);
       reserved.put("by", LitebaseParser.TK_BY);
       reserved.put("char", LitebaseParser.TK_CHAR);
+      reserved.put("commit", LitebaseParser.TK_COMMIT);
       reserved.put("count", LitebaseParser.TK_COUNT);
       reserved.put("create", LitebaseParser.TK_CREATE);
       reserved.put("date", LitebaseParser.TK_DATE);
@@ -152,6 +155,7 @@ class LitebaseLex
       reserved.put("distinct", LitebaseParser.TK_DISTINCT);
       reserved.put("double", LitebaseParser.TK_DOUBLE);
       reserved.put("drop", LitebaseParser.TK_DROP);
+      reserved.put("explain", LitebaseParser.TK_EXPLAIN);
       reserved.put("float", LitebaseParser.TK_FLOAT);
       reserved.put("from", LitebaseParser.TK_FROM);
       reserved.put("group", LitebaseParser.TK_GROUP);
@@ -188,6 +192,7 @@ class LitebaseLex
       reserved.put("to", LitebaseParser.TK_TO);
       reserved.put("update", LitebaseParser.TK_UPDATE);
       reserved.put("upper", LitebaseParser.TK_UPPER);
+      reserved.put("using", LitebaseParser.TK_USING);
       reserved.put("values", LitebaseParser.TK_VALUES);
       reserved.put("varchar", LitebaseParser.TK_VARCHAR);
       reserved.put("where", LitebaseParser.TK_WHERE);
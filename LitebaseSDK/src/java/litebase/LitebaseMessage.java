@@ -464,10 +464,37 @@ class LitebaseMessage
     */
    static final int ERR_BLOBS_PREPARED = 84;
 
+   // Transaction errors.
+   /**
+    * "Transactions are only available on connections opened with the wal parameter."
+    */
+   static final int ERR_WAL_DISABLED = 85;
+
+   /**
+    * "A transaction was already started."
+    */
+   static final int ERR_TRANSACTION_STARTED = 86;
+
+   /**
+    * "There is no transaction to be committed."
+    */
+   static final int ERR_NO_TRANSACTION = 87;
+
+   /**
+    * "This operation can't be executed inside a transaction."
+    */
+   static final int ERR_TRANSACTION_DDL = 88;
+
+   // Trigram index errors.
+   /**
+    * "A trigram index must have a single CHAR or VARCHAR column."
+    */
+   static final int ERR_TRIGRAM_INDEX = 89;
+
    /**
     * Total Litebase possible errors.
     */
-   static final int TOTAL_ERRORS = 85;
+   static final int TOTAL_ERRORS = 90;
    
    // Error tables
    private static final String[] errorMsgs_en = new String[TOTAL_ERRORS];
@@ -612,6 +639,15 @@ class LitebaseMessage
       errorMsgs_en[ERR_COMP_BLOBS] = "It is not possible to compare BLOBs.";
       errorMsgs_en[ERR_BLOBS_PREPARED] = "It is only possible to insert or update a BLOB through prepared statements using setBlob().";
 
+      // Transaction errors.
+      errorMsgs_en[ERR_WAL_DISABLED] = "Transactions are only available on connections opened with the wal parameter.";
+      errorMsgs_en[ERR_TRANSACTION_STARTED] = "A transaction was already started.";
+      errorMsgs_en[ERR_NO_TRANSACTION] = "There is no transaction to be committed.";
+      errorMsgs_en[ERR_TRANSACTION_DDL] = "This operation can't be executed inside a transaction.";
+
+      // Trigram index errors.
+      errorMsgs_en[ERR_TRIGRAM_INDEX] = "A trigram index must have a single CHAR or VARCHAR column.";
+
       // Portuguese messages.
       // General errors.
       errorMsgs_pt[ERR_MESSAGE_START] = "Erro: ";
@@ -746,6 +782,15 @@ class LitebaseMessage
       errorMsgs_pt[ERR_BLOB_ORDER_GROUP] = "Tipos BLOB n�o podem estar em cl�usulas ORDER BY ou GROUP BY.";
       errorMsgs_pt[ERR_COMP_BLOBS] = "N�o � poss�vel comparar BLOBs.";
       errorMsgs_pt[ERR_BLOBS_PREPARED] = "S� � poss�vel inserir ou atualizar um BLOB atrav�s prepared statements usando setBlob().";
+
+      // Transaction errors.
+      errorMsgs_pt[ERR_WAL_DISABLED] = "Transa��es s� est�o dispon�veis em conex�es abertas com o par�metro wal.";
+      errorMsgs_pt[ERR_TRANSACTION_STARTED] = "Uma transa��o j� foi iniciada.";
+      errorMsgs_pt[ERR_NO_TRANSACTION] = "N�o h� transa��o para ser efetivada.";
+      errorMsgs_pt[ERR_TRANSACTION_DDL] = "Esta opera��o n�o pode ser executada dentro de uma transa��o.";
+
+      // Trigram index errors.
+      errorMsgs_pt[ERR_TRIGRAM_INDEX] = "Um �ndice de trigramas deve ter uma �nica coluna CHAR ou VARCHAR.";
    }
 
    /**
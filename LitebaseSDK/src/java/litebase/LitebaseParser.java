@@ -396,6 +396,31 @@ class LitebaseParser
     */
    final static int TK_DIFF = 75;
 
+   /**
+    * <code>BEGIN</code> keyword token.
+    */
+   final static int TK_BEGIN = 76;
+
+   /**
+    * <code>COMMIT</code> keyword token.
+    */
+   final static int TK_COMMIT = 77;
+
+   /**
+    * <code>ANALYZE</code> keyword token.
+    */
+   final static int TK_ANALYZE = 78;
+
+   /**
+    * <code>EXPLAIN</code> keyword token.
+    */
+   final static int TK_EXPLAIN = 79;
+
+   /**
+    * <code>USING</code> keyword token.
+    */
+   final static int TK_USING = 80;
+
    /**
     * The 'lval' (result) got from <code>yylex()</code>.
     */
@@ -465,6 +490,16 @@ class LitebaseParser
     */
    boolean isWhereClause = true;
    
+   /**
+    * Indicates that the select is preceded by <code>EXPLAIN</code>, so that its plan is returned instead of its rows.
+    */
+   boolean isExplain;
+   
+   /**
+    * Indicates that a create or drop index is followed by <code>USING TRIGRAM</code>.
+    */
+   boolean isTrigram;
+   
    /**
     * Contains field values (strings) used on insert/update statements.
     */
@@ -675,6 +710,24 @@ class LitebaseParser
             
             token = yylex();
             break;
+         
+         case TK_ANALYZE: // Gathers the statistics of a table.
+            if (yylex() != TK_IDENT)
+               yyerror(LitebaseMessage.ERR_SYNTAX_ERROR);
+            tableList[0] = new SQLResultSetTable(yylval); // There's no alias table name here.
+            command = SQLElement.CMD_ANALYZE;
+            token = yylex();
+            break;
+            
+         case TK_BEGIN: // Starts a transaction.
+            command = SQLElement.CMD_BEGIN;
+            token = yylex();
+            break;
+            
+         case TK_COMMIT: // Commits a transaction.
+            command = SQLElement.CMD_COMMIT;
+            token = yylex();
+            break;
                         
          case TK_CREATE:
          {
@@ -713,6 +766,8 @@ class LitebaseParser
             }  
             
             token = yylex();
+            if (command == SQLElement.CMD_CREATE_INDEX)
+               token = optIndexMethod(token); // Index method.
             break;
          }
          case TK_DELETE: // Delete.
@@ -755,6 +810,8 @@ class LitebaseParser
             } 
             
             token = yylex();
+            if (command == SQLElement.CMD_DROP_INDEX)
+               token = optIndexMethod(token); // Index method.
             break;
             
          case TK_INSERT: // Insert.
@@ -781,6 +838,12 @@ class LitebaseParser
             token = yylex();
             break;
             
+         case TK_EXPLAIN: // Explain select: returns the plan of the select.
+            if (yylex() != TK_SELECT)
+               yyerror(LitebaseMessage.ERR_SYNTAX_ERROR);
+            isExplain = true;
+            
+            // Falls through.
          case TK_SELECT: // Select.
             if ((token = yylex()) == TK_DISTINCT) 
                token = yylex();
@@ -1653,6 +1716,24 @@ class LitebaseParser
       return token;
    }
 
+   /**
+    * Deals with a possible index method of a create or drop index. The only method besides the default one is <code>USING TRIGRAM</code>.
+    * 
+    * @param token The token where if it is an index method.
+    * @return The token received if it is not an index method or the token after the index method.
+    */
+   private int optIndexMethod(int token)
+   {
+      if (token == TK_USING) // Index method.
+      {
+         if (yylex() != TK_IDENT || !yylval.equals("trigram"))
+            yyerror(LitebaseMessage.ERR_SYNTAX_ERROR);
+         isTrigram = true;
+         token = yylex();
+      }
+      return token;
+   }
+
    /**
     * Deals with an order by clause.
     * 
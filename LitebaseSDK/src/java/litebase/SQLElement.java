@@ -82,6 +82,21 @@ class SQLElement
     */
    static final int CMD_DELETE = 13;
    
+   /**
+    * Represents the SQL command <code>BEGIN</code>.
+    */
+   static final int CMD_BEGIN = 14;
+   
+   /**
+    * Represents the SQL command <code>COMMIT</code>.
+    */
+   static final int CMD_COMMIT = 15;
+   
+   /**
+    * Represents the SQL command <code>ANALYZE</code>.
+    */
+   static final int CMD_ANALYZE = 16;
+   
    // SQL Data Types.
    /**
     * Undefined type, which includes any type
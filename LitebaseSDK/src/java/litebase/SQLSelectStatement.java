@@ -39,6 +39,11 @@ class SQLSelectStatement extends SQLStatement
     * The order by clause of the statement.
     */
    SQLColumnListClause orderByClause;
+   
+   /**
+    * Indicates that the statement is preceded by <code>EXPLAIN</code>, so that its plan is returned instead of its rows.
+    */
+   boolean isExplain;
 
    /**
     * Creates a new select statement for a SQL <code>SELECT</code> query.
@@ -56,6 +61,7 @@ class SQLSelectStatement extends SQLStatement
       groupByClause = parser.groupBy; // Sets the group by clause.
       havingClause = parser.havingClause; // Sets the having clause.
       orderByClause = parser.orderBy; // Sets the order by clause.
+      isExplain = parser.isExplain;
    }
 
    /**
@@ -305,7 +311,7 @@ class SQLSelectStatement extends SQLStatement
       // juliana@114_10: simple selects do not use temporary tables.
       // juliana@212_4: if the select fields are in the table order beginning with rowid, do not build a temporary table.
       if (groupByClause == null && havingClause == null && orderByClause == null && whereClause == null && !selectClause.hasAggFunctions 
-       && selectClause.tableList.length == 1)
+       && selectClause.tableList.length == 1 && !isExplain)
       {
          isSimpleSelect = true;
          rsBaseTable = selectClause.tableList[0].table;
@@ -313,7 +319,7 @@ class SQLSelectStatement extends SQLStatement
       }
       else
       {
-         rsBaseTable = generateResultSetTable(driver); // Temporary table.
+         rsBaseTable = isExplain? createPlanTable(driver) : generateResultSetTable(driver); // Temporary table.
 
          if (rsBaseTable.name == null)
          {   
@@ -1651,6 +1657,65 @@ class SQLSelectStatement extends SQLStatement
       return table;
    }
    
+   /**
+    * Creates a temporary table with the plan of a query preceded by <code>EXPLAIN</code>. It has a row for each table of the query in the order 
+    * they are joined, with how its rows are read and the estimated number of rows and cost after it is joined. The fields of the select clause are 
+    * replaced by the columns of the plan. There are no statistics here, so every table is scanned.
+    * 
+    * @param driver The connection with Litebase.
+    * @return The table with the plan.
+    * @throws IOException If an internal method throws it.
+    * @throws InvalidDateException If an internal method throws it.
+    */
+   private Table createPlanTable(LitebaseConnection driver) throws IOException, InvalidDateException
+   {
+      String[] names = {"table", "access", "rows", "cost"};
+      byte[] types = {SQLElement.CHARS, SQLElement.CHARS, SQLElement.INT, SQLElement.DOUBLE};
+      int[] hashes = new int[4],
+            sizes = new int[4];
+      SQLResultSetTable[] tableList = selectClause.tableList;
+      SQLResultSetField[] fieldList = new SQLResultSetField[4];
+      SQLResultSetField field;
+      IntHashtable htName2index = selectClause.htName2index = new IntHashtable(4);
+      SQLValue[] record = SQLValue.newSQLValues(4);
+      Table table,
+            current;
+      double rows = 1,
+             cost = 0;
+      int i = tableList.length;
+      
+      sizes[1] = 10;
+      while (--i >= 0)
+         sizes[0] = Math.max(sizes[0], tableList[i].tableName.length());
+      
+      i = 4;
+      while (--i >= 0) // The columns of the plan.
+      {
+         (field = fieldList[i] = new SQLResultSetField()).alias = field.tableColName = names[i];
+         field.aliasHashCode = field.tableColHashCode = hashes[i] = names[i].hashCode();
+         field.dataType = types[i];
+         field.size = sizes[i];
+         field.tableColIndex = i;
+         htName2index.put(hashes[i], i);
+      }
+      selectClause.fieldList = fieldList;
+      selectClause.fieldsCount = 4;
+      
+      table = driver.driverCreateTable(null, null, hashes, types, sizes, null, null, Utils.NO_PRIMARY_KEY, Utils.NO_PRIMARY_KEY, null);
+      i = -1;
+      while (++i < tableList.length) // Writes a row for each table.
+      {
+         current = tableList[i].table;
+         record[0].asString = tableList[i].tableName;
+         record[1].asString = "scan";
+         cost += rows * (current.db.rowCount - current.deletedRowsCount);
+         record[2].asInt = (int)(rows *= current.db.rowCount - current.deletedRowsCount);
+         record[3].asDouble = cost;
+         table.writeRSRecord(record);
+      }
+      return table;
+   }
+   
    // juliana@230_14: removed temporary tables when there is no join, group by, order by, and aggregation.
    /**
     * Calculates the answer of a select without aggregation, join, order by, or group by without using a temporary table.
@@ -42,6 +42,16 @@ public class BenchLitebase extends MainWindow
     * The refresh rate of the inserts progress bar.
     */
    private final static int REFRESH_MOD = NRECS / 50;
+   
+   /**
+    * The number of records inserted through the write-ahead log.
+    */
+   private final static int NRECS_WAL = 2000;
+   
+   /**
+    * The number of inserts of each transaction when the write-ahead log is used with <code>begin</code> and <code>commit</code>.
+    */
+   private final static int WAL_BATCH = 100;
 
    static
    {
@@ -134,6 +144,61 @@ public class BenchLitebase extends MainWindow
       return time;
    }
 
+   /**
+    * Inserts records using a connection with a write-ahead log. Each insert is durable when it returns if there is no explicit transaction; 
+    * otherwise, the inserts are committed in batches.
+    * 
+    * @param walDriver The connection opened with the <code>wal</code> parameter.
+    * @param batch Indicates if the inserts are grouped in transactions.
+    * @return The time taken for the operation.
+    */
+   private int insertWithWal(LitebaseConnection walDriver, boolean batch)
+   {
+      StringBuffer sb = new StringBuffer("a"); // Saves some gc() time.
+      int time = Vm.getTimeStamp(),
+          i = 0;
+      PreparedStatement ps = walDriver.prepareStatement("insert into walperson values (?)");
+      
+      while (++i <= NRECS_WAL)
+      {
+         if (batch && i % WAL_BATCH == 1)
+            walDriver.executeUpdate("begin");
+         ps.setString(0, sb.append(i).toString());
+         ps.executeUpdate();
+         if (batch && (i % WAL_BATCH == 0 || i == NRECS_WAL))
+            walDriver.executeUpdate("commit");
+         sb.setLength(1);
+      }
+      
+      time = Vm.getTimeStamp() - time;
+      log("WAL " + (batch? "batches of " + WAL_BATCH : "autocommit") + ": " + time + "ms, " + (time == 0? NRECS_WAL * 1000 : NRECS_WAL * 1000 / time) 
+                                                                                                                                  + " inserts/s");
+      return time;
+   }
+   
+   /**
+    * Compares the inserts through the write-ahead log in autocommit mode and in transactions.
+    * 
+    * @return The time taken for the inserts in transactions.
+    */
+   private int benchWal()
+   {
+      LitebaseConnection walDriver = LitebaseConnection.getInstance("Test", "wal");
+      int time;
+      
+      try 
+      {
+         walDriver.executeUpdate("drop table walperson");
+      }
+      catch (DriverException exception) {}
+      
+      walDriver.execute("create table WALPERSON (NAME CHAR(8))");
+      insertWithWal(walDriver, false);
+      time = insertWithWal(walDriver, true);
+      walDriver.closeAll();
+      return time;
+   }
+
    /**
     * Selects the before last element.
     * 
@@ -344,12 +409,15 @@ public class BenchLitebase extends MainWindow
       int time13 = selectOrderBy();              
       pbTotal.setValue(14);
       
+      int time14 = benchWal();
+      
       // Logs the results.
       log(time1+ " " + time2);
       log(time3 + " " + time4 + " " + time5);
       log(time6 + " ");
       log(time7 + " " + time8 + " " + time9);
       log(time10 + " " + time11 + " " + time12 + " " + time13);
+      log(time14 + " ");
       log("total: " + (time1 + time2 + time3 + time4 + time5 + time6 + time7 + time8 + time9 + time10 + time11 + time12));
       log("Results are also in the console");
       
@@ -64,9 +64,74 @@ public class TestIndexIneqAndLike extends TestCase
       // nOme1, nOme2, nOme11-nOme19, nOme101-nOme109, nOme111-nOme119
       testResult(driver.executeQuery("select * from cliente where nome < 'Nome20'"),29); 
       
+      testTrigramIndex(driver);
       driver.closeAll();
    }
    
+   /**
+    * Tests <code>LIKE</code> with patterns in the middle or in the end of the strings of columns with trigram indices.
+    * 
+    * @param driver The connection with Litebase.
+    */
+   private void testTrigramIndex(LitebaseConnection driver)
+   {
+      if (driver.exists("trigram"))
+         driver.executeUpdate("drop table trigram");
+      driver.execute("create table trigram(id int, name char(30), email varchar(40) nocase)");
+      driver.execute("create index idx on trigram(name) using trigram"); // Created before and after the rows are inserted.
+      PreparedStatement ps = driver.prepareStatement("insert into trigram values (?,?,?)");
+      int i = -1;
+      while (++i < 100)
+      {
+         ps.setInt(0, i);
+         ps.setString(1, "Person " + i + (i % 2 == 0? " Silva" : " Souza"));
+         ps.setString(2, "p" + i + "@Mail.com");
+         ps.executeUpdate();
+      }
+      driver.execute("create index idx on trigram(email) using trigram");
+      
+      testResult(driver.executeQuery("select * from trigram where name like '%Silva%'"), 50);
+      testResult(driver.executeQuery("select * from trigram where name like '%silva%'"), 0); // The index ignores the case, but the like doesn't.
+      testResult(driver.executeQuery("select * from trigram where name like '%Sil%'"), 50);
+      testResult(driver.executeQuery("select * from trigram where name like '%Si%'"), 50); // Too short for a trigram.
+      testResult(driver.executeQuery("select * from trigram where name like '%son 1%'"), 11);
+      testResult(driver.executeQuery("select * from trigram where email like '%@MAIL.COM'"), 100);
+      testResult(driver.executeQuery("select * from trigram where email like 'P1%'"), 11);
+      testResult(driver.executeQuery("select * from trigram where name like '%Silva%' and email like '%8@%'"), 10);
+      testResult(driver.executeQuery("select * from trigram where name like '%Silva%' or email like '%7@%'"), 60);
+      
+      // The index must follow updates and deletes.
+      assertEquals(10, driver.executeUpdate("update trigram set name = 'Nobody' where id < 10"));
+      testResult(driver.executeQuery("select * from trigram where name like '%Silva%'"), 45);
+      testResult(driver.executeQuery("select * from trigram where name like '%obod%'"), 10);
+      assertEquals(10, driver.executeUpdate("delete from trigram where id >= 90"));
+      testResult(driver.executeQuery("select * from trigram where name like '%Silva%'"), 40);
+      assertEquals(40, driver.executeUpdate("delete from trigram where name like '%Souza%'"));
+      testResult(driver.executeQuery("select * from trigram where name like '%Souza%'"), 0);
+      
+      PreparedStatement psSelect = driver.prepareStatement("select * from trigram where email like ?");
+      psSelect.setString(0, "%2@mail%");
+      testResult(psSelect.executeQuery(), 9);
+      driver.purge("trigram");
+      testResult(psSelect.executeQuery(), 9);
+      
+      try // Only strings have trigrams.
+      {
+         driver.execute("create index idx on trigram(id) using trigram");
+         fail("1");
+      }
+      catch (DriverException exception) {}
+      try
+      {
+         driver.execute("create index idx on trigram(name) using btree");
+         fail("2");
+      }
+      catch (SQLParseException exception) {}
+      
+      assertEquals(1, driver.executeUpdate("drop index name on trigram using trigram"));
+      testResult(driver.executeQuery("select * from trigram where name like '%Silva%'"), 40);
+   }
+   
    /** 
     * Tests if the result set returned the expected number of rows.
     * 
@@ -119,6 +119,146 @@ public class TestIndexRebalance extends TestCase
       driver.executeUpdate("insert into t values (1)");
       driver.executeUpdate("delete from t where rowid = 16");
       
+      testNodePool(driver); // Tests the pool of index nodes shared by the tables of the connection.
+      testBulkInsert(driver); // Tests the indices built from their sorted keys.
       driver.closeAll();
+      try // The pool can't be used after closing the connection.
+      {
+         driver.getNodePoolBudget();
+         fail("Driver not closed!");
+      }
+      catch (IllegalStateException exception) {}
+   }
+   
+   /**
+    * Tests the pool of index nodes, which keeps the nodes of the deeper index levels of all the tables of a connection.
+    * 
+    * @param driver The connection with Litebase.
+    */
+   private void testNodePool(LitebaseConnection driver)
+   {
+      int budget = driver.getNodePoolBudget(),
+          i = -1;
+      
+      driver.setNodePoolBudget(-1);
+      assertEquals(0, driver.getNodePoolBudget());
+      driver.setNodePoolBudget(budget);
+      assertEquals(budget, driver.getNodePoolBudget());
+      
+      if (driver.exists("pool1"))
+         driver.executeUpdate("drop table pool1");
+      if (driver.exists("pool2"))
+         driver.executeUpdate("drop table pool2");
+      driver.execute("create table pool1 (x int primary key, y char(20))");
+      driver.execute("create table pool2 (x int primary key, y char(20))");
+      driver.execute("create index idx on pool2(y)");
+      
+      // A minimal budget makes the nodes of both tables be evicted all the time.
+      driver.setNodePoolBudget(0);
+      PreparedStatement ps1 = driver.prepareStatement("insert into pool1 values (?, ?)"),
+                        ps2 = driver.prepareStatement("insert into pool2 values (?, ?)");
+      while (++i < 3000)
+      {
+         ps1.setInt(0, i);
+         ps1.setString(1, "Name " + i);
+         assertEquals(1, ps1.executeUpdate());
+         ps2.setInt(0, 2999 - i);
+         ps2.setString(1, "Name " + (i % 500));
+         assertEquals(1, ps2.executeUpdate());
+      }
+      
+      long accesses = driver.getNodePoolHits() + driver.getNodePoolMisses();
+      ResultSet resultSet;
+      assertEquals(1000, (resultSet = driver.executeQuery("select * from pool1 where x >= 2000")).getRowCount());
+      resultSet.close();
+      assertEquals(6, (resultSet = driver.executeQuery("select * from pool2 where y = 'Name 7'")).getRowCount());
+      resultSet.close();
+      i = 3000;
+      while ((i -= 7) >= 0)
+      {
+         assertEquals(1, (resultSet = driver.executeQuery("select * from pool1 where x = " + i)).getRowCount());
+         resultSet.close();
+         assertEquals(1, (resultSet = driver.executeQuery("select * from pool2 where x = " + i)).getRowCount());
+         resultSet.close();
+      }
+      assertGreater(driver.getNodePoolHits() + driver.getNodePoolMisses(), accesses);
+      
+      // The nodes changed with a small budget must be the same ones read with the default budget.
+      driver.setNodePoolBudget(budget);
+      assertEquals(1500, driver.executeUpdate("delete from pool1 where x >= 1500"));
+      assertEquals(1500, (resultSet = driver.executeQuery("select * from pool1 where x > -1")).getRowCount());
+      resultSet.close();
+      assertEquals(3000, (resultSet = driver.executeQuery("select * from pool2 where y >= 'Name'")).getRowCount());
+      resultSet.close();
+      ps1.close();
+      ps2.close();
+      driver.executeUpdate("drop table pool1");
+      driver.executeUpdate("drop table pool2");
+   }
+   
+   /**
+    * Tests the indices built from their sorted keys, after bulk inserts or when they are created on a populated table.
+    * 
+    * @param driver The connection with Litebase.
+    */
+   private void testBulkInsert(LitebaseConnection driver)
+   {
+      int i = -1;
+      
+      if (driver.exists("bulk"))
+         driver.executeUpdate("drop table bulk");
+      driver.execute("create table bulk (x int primary key, y char(20), z long)");
+      driver.execute("create index idx on bulk(y)");
+      driver.execute("create index idx on bulk(z, y)");
+      driver.setBulkInsert("bulk", true);
+      
+      PreparedStatement ps = driver.prepareStatement("insert into bulk values (?, ?, ?)");
+      while (++i < 5000) // The keys are not inserted in order.
+      {
+         ps.setInt(0, (i * 7919) % 5000);
+         ps.setString(1, "Name " + (i % 700));
+         ps.setLong(2, i % 13);
+         assertEquals(1, ps.executeUpdate());
+      }
+      try // The primary key is still checked.
+      {
+         ps.executeUpdate();
+         fail("Primary key not violated!");
+      }
+      catch (PrimaryKeyViolationException exception) {}
+      
+      // A query rebuilds the indices.
+      ResultSet resultSet;
+      assertEquals(8, (resultSet = driver.executeQuery("select * from bulk where y = 'Name 7'")).getRowCount());
+      resultSet.close();
+      ps.setInt(0, 5000);
+      assertEquals(1, ps.executeUpdate());
+      assertEquals(1, driver.executeUpdate("delete from bulk where x = 5000"));
+      driver.setBulkInsert("bulk", false);
+      
+      assertEquals(385, (resultSet = driver.executeQuery("select * from bulk where z = 2 and y >= 'Name'")).getRowCount());
+      resultSet.close();
+      assertEquals(1000, (resultSet = driver.executeQuery("select * from bulk where x >= 4000")).getRowCount());
+      resultSet.close();
+      resultSet = driver.executeQuery("select y from bulk where y >= 'Name 69' order by y");
+      String last = "";
+      while (resultSet.next())
+      {
+         assertGreaterOrEqual(resultSet.getString(1).compareTo(last), 0);
+         last = resultSet.getString(1);
+      }
+      resultSet.close();
+      
+      // Indices created on populated tables are also built from their sorted keys.
+      driver.executeUpdate("drop index * on bulk");
+      driver.execute("create index idx on bulk(z)");
+      assertEquals(384, (resultSet = driver.executeQuery("select * from bulk where z = 12")).getRowCount());
+      resultSet.close();
+      assertEquals(4996, driver.executeUpdate("update bulk set y = 'Other' where x > 3"));
+      driver.execute("create index idx on bulk(y)");
+      assertEquals(4, (resultSet = driver.executeQuery("select * from bulk where y < 'Other'")).getRowCount());
+      resultSet.close();
+      ps.close();
+      driver.executeUpdate("drop table bulk");
    }
 }
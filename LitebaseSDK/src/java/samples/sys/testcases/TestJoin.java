@@ -32,6 +32,8 @@ public class TestJoin extends TestCase
       testComparisonInTheSameTable(); // Tests comparison of columns of the same table.
       testOrWithFalseConstantComparison(); // Tests join with or and false comparisons with constants.
       testOrderGroupBy(); // Tests join with order and group by.
+      testUnindexedEqualityJoin(); // Tests joins with equalities between columns without indices.
+      testAnalyzedJoins(); // Tests joins of tables with statistics and their plans.
       driver.closeAll();
    }
 
@@ -1366,4 +1368,226 @@ public class TestJoin extends TestCase
 + "AND P.SITUACAO = 1 AND ASS.IDPERGUNTA = P.IDPERGUNTA AND ASS1.IDASSGRUPOPERGUNTA = ASS.IDASSGRUPOPERGUNTA group by ASS.IDASSGRUPOPERGUNTA, P.IDPERGUNTA, P.DESCRICAO, P.FOTO")).getRowCount());
       resultSet.close();
    }
-}
\ No newline at end of file
+   
+   /**
+    * Tests joins with equalities between columns without indices, whose inner rows are looked up in a hash table or in keys sorted on disk.
+    */
+   private void testUnindexedEqualityJoin()
+   {
+      int budget = LitebaseConnection.getJoinMemoryBudget();
+      
+      // Drops existing tables.
+      dropTableIfExist("emp");
+      dropTableIfExist("dept");
+      dropTableIfExist("big");
+      dropTableIfExist("small");
+      
+      // Creates and populates the tables.
+      driver.execute("create table emp(eid int, did int, dname char(10) nocase)");
+      driver.execute("create table dept(did int, dname char(10) nocase)");
+      driver.execute("create table big(k int)");
+      driver.execute("create table small(k int)");
+      driver.executeUpdate("insert into emp values (1, 1, 'Sales')");
+      driver.executeUpdate("insert into emp values (2, 2, 'HR')");
+      driver.executeUpdate("insert into emp values (3, 1, 'sales')");
+      driver.executeUpdate("insert into emp values (4, null, null)");
+      driver.executeUpdate("insert into emp values (5, 3, 'IT')");
+      driver.executeUpdate("insert into dept values (1, 'SALES')");
+      driver.executeUpdate("insert into dept values (2, 'hr')");
+      driver.executeUpdate("insert into dept values (2, 'Hr')");
+      driver.executeUpdate("insert into dept values (null, null)");
+      driver.executeUpdate("insert into dept values (4, 'Ops')");
+      
+      PreparedStatement psInsert = driver.prepareStatement("insert into big values (?)");
+      int i = 5000;
+      while (--i >= 0)
+      {
+         psInsert.setInt(0, i % 1000);
+         psInsert.executeUpdate();
+      }
+      psInsert = driver.prepareStatement("insert into small values (?)");
+      i = 10;
+      while (--i >= 0)
+      {
+         psInsert.setInt(0, i);
+         psInsert.executeUpdate();
+      }
+      
+      // The same joins with the keys hashed in memory and sorted on disk.
+      LitebaseConnection.setJoinMemoryBudget(0);
+      assertEquals(0, LitebaseConnection.getJoinMemoryBudget());
+      assertUnindexedEqualityJoin();
+      LitebaseConnection.setJoinMemoryBudget(budget);
+      assertEquals(budget, LitebaseConnection.getJoinMemoryBudget());
+      assertUnindexedEqualityJoin();
+      
+      // Deleted rows are not joined.
+      driver.executeUpdate("delete from dept where dname = 'Hr'");
+      LitebaseConnection.setJoinMemoryBudget(0);
+      assertUnindexedEqualityJoinAfterDelete();
+      LitebaseConnection.setJoinMemoryBudget(budget);
+      assertUnindexedEqualityJoinAfterDelete();
+      
+      // Negative budgets are treated as 0.
+      LitebaseConnection.setJoinMemoryBudget(-1);
+      assertEquals(0, LitebaseConnection.getJoinMemoryBudget());
+      LitebaseConnection.setJoinMemoryBudget(budget);
+   }
+   
+   /**
+    * Asserts the results of the joins with equalities between columns without indices.
+    */
+   private void assertUnindexedEqualityJoin()
+   {
+      ResultSet resultSet;
+      
+      assertEquals(4, (resultSet = driver.executeQuery("select * from emp, dept where emp.did = dept.did")).getRowCount());
+      resultSet.close();
+      assertEquals(4, (resultSet = driver.executeQuery("select * from emp, dept where emp.dname = dept.dname")).getRowCount());
+      resultSet.close();
+      assertEquals(4, (resultSet = driver.executeQuery("select * from emp, dept where emp.did = dept.did and emp.dname = dept.dname"))
+                                                                                                                               .getRowCount());
+      resultSet.close();
+      assertEquals(3, (resultSet = driver.executeQuery("select * from emp, dept where emp.did = dept.did and emp.eid > 1")).getRowCount());
+      resultSet.close();
+      assertEquals(9, (resultSet = driver.executeQuery("select * from emp, dept where emp.did = dept.did or emp.eid = 5")).getRowCount());
+      resultSet.close();
+      
+      // Sales is the only department of the employees 1 and 3.
+      assertTrue((resultSet = driver.executeQuery("select emp.eid, dept.dname from emp, dept where emp.dname = dept.dname and dept.did = 1 "
+                                                                                                                + "order by emp.eid")).next());
+      assertEquals(1, resultSet.getInt(1));
+      assertEquals("SALES", resultSet.getString(2));
+      assertTrue(resultSet.next());
+      assertEquals(3, resultSet.getInt(1));
+      assertFalse(resultSet.next());
+      resultSet.close();
+      
+      assertEquals(50, (resultSet = driver.executeQuery("select * from big, small where big.k = small.k")).getRowCount());
+      resultSet.close();
+   }
+   
+   /**
+    * Asserts the results of the joins with equalities between columns without indices after deleting a row.
+    */
+   private void assertUnindexedEqualityJoinAfterDelete()
+   {
+      ResultSet resultSet;
+      
+      assertEquals(3, (resultSet = driver.executeQuery("select * from emp, dept where emp.did = dept.did")).getRowCount());
+      resultSet.close();
+      assertEquals(3, (resultSet = driver.executeQuery("select * from emp, dept where emp.dname = dept.dname")).getRowCount());
+      resultSet.close();
+   }
+   
+   /**
+    * Tests joins and filters of tables whose statistics were gathered by <code>ANALYZE</code>, which may change the order of the tables and the 
+    * indices used, but never the results. 
+    */
+   private void testAnalyzedJoins()
+   {
+      ResultSet resultSet;
+      
+      // Drops existing tables.
+      dropTableIfExist("orders");
+      dropTableIfExist("customer");
+      dropTableIfExist("region");
+      
+      // Creates and populates the tables.
+      driver.execute("create table orders(oid int, cid int, total double)");
+      driver.execute("create table customer(cid int primary key, rid int, name char(10))");
+      driver.execute("create table region(rid int, name char(10))");
+      driver.execute("create index idx on orders(oid)");
+      
+      PreparedStatement psInsert = driver.prepareStatement("insert into orders values (?, ?, ?)");
+      int i = 3000;
+      while (--i >= 0)
+      {
+         psInsert.setInt(0, i);
+         psInsert.setInt(1, i % 100);
+         psInsert.setDouble(2, i % 10);
+         psInsert.executeUpdate();
+      }
+      psInsert = driver.prepareStatement("insert into customer values (?, ?, ?)");
+      i = 100;
+      while (--i >= 0)
+      {
+         psInsert.setInt(0, i);
+         psInsert.setInt(1, i % 5);
+         psInsert.setString(2, "c" + i);
+         psInsert.executeUpdate();
+      }
+      i = 5;
+      while (--i >= 0)
+         driver.executeUpdate("insert into region values (" + i + ", 'r" + i + "')");
+      driver.executeUpdate("delete from orders where oid >= 2900");
+      
+      assertAnalyzedJoins();
+      assertEquals(0, driver.executeUpdate("analyze orders"));
+      assertEquals(0, driver.executeUpdate("analyze customer"));
+      assertEquals(0, driver.executeUpdate("analyze region"));
+      assertAnalyzedJoins();
+      
+      // The statistics are kept in the tables.
+      driver.closeAll();
+      driver = AllTests.getInstance("Test");
+      assertAnalyzedJoins();
+      
+      // EXPLAIN returns a row for each table in the order they are joined.
+      assertEquals(3, (resultSet = driver.executeQuery("explain select * from orders, customer, region where orders.cid = customer.cid "
+                                                                                           + "and customer.rid = region.rid")).getRowCount());
+      while (resultSet.next())
+      {
+         String name = resultSet.getString("table");
+         assertTrue(name.equals("orders") || name.equals("customer") || name.equals("region"));
+         assertNotNull(resultSet.getString("access"));
+         assertTrue(resultSet.getInt("rows") >= 0);
+         assertTrue(resultSet.getDouble("cost") >= 0);
+      }
+      resultSet.close();
+      assertTrue((resultSet = driver.executeQuery("explain select oid from orders where oid = 10")).next());
+      assertEquals("orders", resultSet.getString(1));
+      assertFalse(resultSet.next());
+      resultSet.close();
+      
+      // Adding a column drops the statistics.
+      driver.executeUpdate("alter table orders add note char(5)");
+      assertAnalyzedJoins();
+      assertEquals(0, driver.executeUpdate("analyze orders"));
+      assertAnalyzedJoins();
+      
+      try // The table must exist.
+      {
+         driver.executeUpdate("analyze nothere");
+         fail();
+      }
+      catch (DriverException exception) {}
+   }
+   
+   /**
+    * Asserts the results of the joins and filters of the tables which can be analyzed.
+    */
+   private void assertAnalyzedJoins()
+   {
+      ResultSet resultSet;
+      
+      assertEquals(2900, (resultSet = driver.executeQuery("select * from orders, customer where orders.cid = customer.cid")).getRowCount());
+      resultSet.close();
+      assertEquals(2900, (resultSet = driver.executeQuery("select * from orders, customer, region where orders.cid = customer.cid "
+                                                                                           + "and customer.rid = region.rid")).getRowCount());
+      resultSet.close();
+      assertEquals(580, (resultSet = driver.executeQuery("select * from region, customer, orders where orders.cid = customer.cid "
+                                                                     + "and customer.rid = region.rid and region.name = 'r1'")).getRowCount());
+      resultSet.close();
+      assertEquals(2800, (resultSet = driver.executeQuery("select * from orders where oid >= 100")).getRowCount());
+      resultSet.close();
+      assertEquals(10, (resultSet = driver.executeQuery("select * from orders where oid < 10")).getRowCount());
+      resultSet.close();
+      assertTrue((resultSet = driver.executeQuery("select cid from orders where oid = 250")).next());
+      assertEquals(50, resultSet.getInt(1));
+      assertFalse(resultSet.next());
+      resultSet.close();
+      assertEquals(290, (resultSet = driver.executeQuery("select * from orders where total = 3.0 and oid > 0")).getRowCount());
+      resultSet.close();
+   }
+}
@@ -24,6 +24,52 @@ public class TestMultipleConnection extends TestCase
       // Tests different ways of writing paths.
       TestConnections(tempPath + "/a");
       TestConnections(Convert.appendPath(tempPath, "\\b"));
+      testMmapConnection();
+   }
+
+   /**
+    * Tests a connection whose table files are mapped into memory, with files that outgrow their mappings, and the same table used afterwards by an 
+    * ordinary connection.
+    */
+   private void testMmapConnection()
+   {
+      LitebaseConnection driver = AllTests.getInstance("Test", Settings.appPath + "; mmap");
+      assertNotEquals(driver, AllTests.getInstance("Test", Settings.appPath)); // The parameter makes it a different connection.
+      if (driver.exists("mapped"))
+         driver.executeUpdate("drop table mapped");
+      driver.execute("create table mapped (id int primary key, name varchar(40))");
+      driver.closeAll();
+      
+      // The table is mapped when it is opened again.
+      driver = AllTests.getInstance("Test", Settings.appPath + "; mmap");
+      PreparedStatement ps = driver.prepareStatement("insert into mapped values (?, ?)");
+      int i = -1;
+      while (++i < 3000)
+      {
+         ps.setInt(0, i);
+         ps.setString(1, "Person number " + i);
+         ps.executeUpdate();
+      }
+      assertEquals(1000, driver.executeUpdate("update mapped set name = 'Changed' where id >= 2000"));
+      assertEquals(10, driver.executeUpdate("delete from mapped where id < 10"));
+      ResultSet rs = driver.executeQuery("select name from mapped where id = 1234");
+      assertTrue(rs.next());
+      assertEquals("Person number 1234", rs.getString(1));
+      rs.close();
+      driver.purge("mapped");
+      assertEquals(1, driver.executeUpdate("insert into mapped values (0, 'Person number 0')"));
+      driver.closeAll();
+      
+      // An ordinary connection must read what was written through the mappings.
+      driver = AllTests.getInstance("Test", Settings.appPath);
+      assertEquals(2991, (rs = driver.executeQuery("select * from mapped")).getRowCount());
+      rs.close();
+      assertEquals(1000, (rs = driver.executeQuery("select * from mapped where name = 'Changed'")).getRowCount());
+      rs.close();
+      assertEquals(5, (rs = driver.executeQuery("select * from mapped where id between 2995 and 3100")).getRowCount());
+      rs.close();
+      driver.executeUpdate("drop table mapped");
+      driver.closeAll();
    }
 
    /**
@@ -636,6 +636,67 @@ public class TestOrderBy extends TestCase
       driver.executeQuery("select rowid, name, age, district from person group by rowid, name, age, district").close();
       driver.executeQuery("select rowid, name, age, district from person group by rowid, name, age, district order by rowid, name, age, district").close();     
       driver.executeQuery("select * from person order by rowid").close();
+      testLargeSort(driver);
       driver.closeAll();
    }
+   
+   /**
+    * Tests the sort of a table whose keys don't fit in memory and are sorted in runs merged on disk.
+    * 
+    * @param driver The connection with Litebase.
+    */
+   private void testLargeSort(LitebaseConnection driver)
+   {
+      int i = -1;
+      
+      if (driver.exists("sorted"))
+         driver.executeUpdate("drop table sorted");
+      driver.execute("create table sorted (name char(1000), value int, amount double)");
+      
+      PreparedStatement ps = driver.prepareStatement("insert into sorted values (?, ?, ?)");
+      while (++i < 3000)
+      {
+         ps.setString(0, "Name " + (i % 37));
+         ps.setInt(1, (i * 7919) % 3000 - 1500);
+         ps.setDouble(2, i % 11 - 5.5);
+         assertEquals(1, ps.executeUpdate());
+      }
+      
+      ResultSet rs = driver.executeQuery("select name, value, amount from sorted order by name, amount desc, value");
+      String name,
+             lastName = "";
+      int value,
+          lastValue = 0;
+      double amount,
+             lastAmount = 0;
+      
+      assertEquals(3000, rs.getRowCount());
+      i = 0;
+      while (rs.next())
+      {
+         name = rs.getString(1);
+         value = rs.getInt(2);
+         amount = rs.getDouble(3);
+         if (i++ > 0)
+         {
+            assertGreaterOrEqual(name.compareTo(lastName), 0);
+            if (name.equals(lastName))
+            {
+               assertTrue(amount <= lastAmount);
+               if (amount == lastAmount)
+                  assertLower(lastValue, value);
+            }
+         }
+         lastName = name;
+         lastValue = value;
+         lastAmount = amount;
+      }
+      rs.close();
+      
+      assertEquals(37, (rs = driver.executeQuery("select name, count(*) as total from sorted group by name")).getRowCount());
+      while (rs.next())
+         assertGreaterOrEqual(rs.getInt(2), 81);
+      rs.close();
+      driver.executeUpdate("drop table sorted");
+   }
 }
\ No newline at end of file
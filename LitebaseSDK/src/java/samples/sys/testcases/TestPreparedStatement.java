@@ -672,6 +672,7 @@ public class TestPreparedStatement extends TestCase
       }
       catch (IllegalStateException exception) {}
       
+      testStatementCache(driver);
       driver.closeAll();
       
       try
@@ -682,6 +683,56 @@ public class TestPreparedStatement extends TestCase
       catch (IllegalStateException exception) {}
    }
 
+   /**
+    * Tests the statements executed without being prepared, which are kept parsed by the connection.
+    * 
+    * @param driver The connection with Litebase.
+    */
+   private void testStatementCache(LitebaseConnection driver)
+   {
+      if (driver.exists("cache"))
+         driver.executeUpdate("drop table cache");
+      if (driver.exists("cache2"))
+         driver.executeUpdate("drop table cache2");
+      driver.execute("create table cache (x int, y char(10))");
+      
+      int i = 3;
+      while (--i >= 0) // The same insert is executed again.
+         assertEquals(1, driver.executeUpdate("insert into cache values (1, 'a')"));
+      assertEquals(1, driver.executeUpdate("insert into cache values (2, 'b')"));
+      
+      // The first result set is still used after its statement is executed again and freed from the cache.
+      ResultSet resultSet = driver.executeQuery("select * from cache where x = 1");
+      assertEquals(3, executeQuery(driver, "select * from cache where x = 1"));
+      i = 20;
+      while (--i >= 0)
+         assertEquals(i == 2? 1 : 0, executeQuery(driver, "select * from cache where x = " + i));
+      assertEquals(3, resultSet.getRowCount());
+      assertTrue(resultSet.next());
+      assertEquals("a", resultSet.getString(2));
+      resultSet.close();
+      
+      assertEquals(3, driver.executeUpdate("update cache set y = 'c' where x = 1"));
+      assertEquals(3, executeQuery(driver, "select * from cache where y = 'c'"));
+      
+      // The cached statements are not used after their table is changed.
+      driver.executeUpdate("alter table cache rename to cache2");
+      try
+      {
+         driver.executeQuery("select * from cache where x = 1");
+         fail("25");
+      }
+      catch (DriverException exception) {}
+      try
+      {
+         driver.executeUpdate("insert into cache values (1, 'a')");
+         fail("26");
+      }
+      catch (DriverException exception) {}
+      assertEquals(4, driver.executeUpdate("delete from cache2"));
+      driver.executeUpdate("drop table cache2");
+   }
+   
    /**
     * Execute a query and returns the number of rows that answers the query.
     * 
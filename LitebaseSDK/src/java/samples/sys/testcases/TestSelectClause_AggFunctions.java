@@ -431,8 +431,71 @@ public class TestSelectClause_AggFunctions extends TestCase
       driver = AllTests.getInstance("Test"); 
       assertFalse((resultSet = driver.prepareStatement(" SELECT max(clienteId) as id FROM cliente ").executeQuery()).first());
       resultSet.close();
+      testManyGroups(driver);
       driver.closeAll();
    }
+   
+   /**
+    * Tests a group by with many groups, which are aggregated in memory or, if they don't fit in memory, sorted.
+    * 
+    * @param driver The connection with Litebase.
+    */
+   private void testManyGroups(LitebaseConnection driver)
+   {
+      ResultSet resultSet;
+      int i = -1,
+          count = 0;
+      
+      if (driver.exists("grouped"))
+         driver.executeUpdate("drop table grouped");
+      driver.execute("create table grouped (name char(600), code int, amount double)");
+      
+      PreparedStatement ps = driver.prepareStatement("insert into grouped values (?, ?, ?)");
+      while (++i < 3000)
+      {
+         ps.setString(0, "Name " + (10000 + i));
+         ps.setInt(1, i % 1000);
+         ps.setDouble(2, i % 7);
+         assertEquals(1, ps.executeUpdate());
+      }
+      
+      // Each code has 3 rows.
+      assertEquals(1000, (resultSet = driver.executeQuery("select code, count(*) as total, sum(amount) as total_amount, max(amount) as max_amount " 
+                                                                                        + "from grouped where code >= 0 group by code")).getRowCount());
+      i = 0;
+      while (resultSet.next())
+      {
+         assertEquals(i, resultSet.getInt("code"));
+         assertEquals(3, resultSet.getInt("total"));
+         assertEquals(i % 7 + (i + 1000) % 7 + (i + 2000) % 7, resultSet.getDouble("total_amount"), 1e-1);
+         assertEquals(Math.max(i % 7, Math.max((i + 1000) % 7, (i + 2000) % 7)), resultSet.getDouble("max_amount"), 1e-1);
+         if (i % 7 + (i + 1000) % 7 + (i + 2000) % 7 > 12)
+            count++;
+         i++;
+      }
+      resultSet.close();
+      
+      assertEquals(1000, (resultSet = driver.executeQuery("select code from grouped group by code order by code desc")).getRowCount());
+      i = 1000;
+      while (resultSet.next())
+         assertEquals(--i, resultSet.getInt(1));
+      resultSet.close();
+      
+      assertEquals(count, (resultSet = driver.executeQuery("select code, sum(amount) as total_amount from grouped group by code " 
+                                                                                                + "having total_amount > 12")).getRowCount());
+      resultSet.close();
+      
+      // The groups of the names don't fit in memory.
+      assertEquals(3000, (resultSet = driver.executeQuery("select name, count(*) as total from grouped group by name")).getRowCount());
+      i = 10000;
+      while (resultSet.next())
+      {
+         assertEquals("Name " + i++, resultSet.getString(1));
+         assertEquals(1, resultSet.getInt(2));
+      }
+      resultSet.close();
+      driver.executeUpdate("drop table grouped");
+   }
 
    /**
     *  Executes a query and returns the total number of record.
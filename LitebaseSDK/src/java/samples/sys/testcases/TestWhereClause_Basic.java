@@ -194,6 +194,11 @@ public class TestWhereClause_Basic extends TestCase
       assertEquals(8, executeQuery(driver, "select * from PERSON where salary_prev < 3000 or ((not years_exp_c >= years_exp_java) "
                                                                                           + "and not years_exp_java >= 10) or FIRST_NAME > 'r'"));
 
+      // Conjunctions whose numeric comparisons are tested before the string ones.
+      assertEquals(3, executeQuery(driver, "select * from PERSON where years_exp_java >= 10 and FIRST_NAME > 'r' and salary_cur < 5000"));
+      assertEquals(3, executeQuery(driver, "select * from PERSON where 10 <= years_exp_java and last_name like '%o%' and rowid > 2"));
+      assertEquals(1, executeQuery(driver, "select * from PERSON where salary_prev = 1.21 and FIRST_NAME = 'paulo'"));
+
       // Complex queries with update.
       assertEquals(8, driver.executeUpdate("update PERSON set FIRST_NAME = 'x' where salary_prev < 3000 or ((not years_exp_c >= years_exp_java) "
                                                                                   + "and not years_exp_java >= 10) or FIRST_NAME > 'r'"));
@@ -18,6 +18,8 @@ Hashtable htCreatedDrivers = { 0 }; // The hash table for the created connection
 XFilesList filesList; 
 #endif
 
+Wal* walList; // The write-ahead logs of the connections.
+
 // Globals for the parser.
 Hashtable reserved = { 0 };                 // Table containing the reserved words.
 MemoryUsageHT memoryUsage = { 0 };          // Indicates how much memory a select sql command uses in its temporary .db.
@@ -41,6 +43,7 @@ CharP names[10] = {"year", "month", "day", "hour", "minute", "second", "millis",
 uint8 bitsInNibble[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
 
 JChar questionMark[2] = {(JChar)'?', (JChar)'\0'}; // A jchar string representing "?".                           
+int32 joinMemoryBudget = JOIN_MEMORY_BUDGET;       // The memory budget of the hash table of a join without an index.
 
 // juliana@253_9: improved Litebase parser.
                                                                                        
@@ -50,9 +53,11 @@ TCClass loggerClass = { 0 };             // Logger
 
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 // Mutexes used.
-DECLARE_MUTEX(parser); // Mutex for the parser.
+DECLARE_MUTEX(parser); // Mutex for the memory usage of the queries.
 DECLARE_MUTEX(log);    // Mutex for logging.
 DECLARE_MUTEX(files);  // Mutex for the Litebase files list.
+DECLARE_MUTEX(wal);    // Mutex for the list of write-ahead logs.
+DECLARE_MUTEX(walSync); // Mutex for syncing the write-ahead logs.
 
 // rnovais@568_10 @570_1 juliana@226_5
 // Aggregate functions table.
@@ -101,6 +106,7 @@ createStringObjectWithLenFunc TC_createStringObjectWithLen = { 0 };
 debugFunc TC_debug = { 0 };
 double2strFunc TC_double2str = { 0 };
 executeMethodFunc TC_executeMethod = { 0 };
+gcWriteBarrierFunc TC_gcWriteBarrier = { 0 };
 getApplicationIdFunc TC_getApplicationId = { 0 };
 getAppPathFunc TC_getAppPath = { 0 };
 getDataPathFunc TC_getDataPath = { 0 };
@@ -134,6 +140,7 @@ privateHeapSetJumpFunc TC_privateHeapSetJump = { 0 };
 privateXfreeFunc TC_privateXfree = { 0 };
 privateXmallocFunc TC_privateXmalloc = { 0 };
 privateXreallocFunc TC_privateXrealloc = { 0 };
+runPoolJobsFunc TC_runPoolJobs = { 0 };
 setObjectLockFunc TC_setObjectLock = { 0 };
 str2doubleFunc TC_str2double = { 0 };
 str2intFunc TC_str2int = { 0 };
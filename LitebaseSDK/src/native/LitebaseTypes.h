@@ -41,6 +41,8 @@ TC_DeclareList(TCObject);
 
 // Typedefs for using Litebase file.
 typedef struct XFile XFile;
+typedef struct Wal Wal;
+typedef struct WalExtent WalExtent;
 typedef struct Key Key;
 typedef void (*setPosFunc)(XFile* xFile, int32 position);
 typedef bool (*growToFunc)(Context context, XFile* xFile, uint32 newSize);
@@ -65,16 +67,24 @@ typedef struct SQLSelectStatement SQLSelectStatement;
 typedef struct SQLUpdateStatement SQLUpdateStatement;
 typedef struct PlainDB PlainDB;
 typedef struct Table Table;
+typedef struct ColumnStatistics ColumnStatistics;
 typedef struct IntVector IntVector;
 typedef struct ShortVector ShortVector;
 typedef struct ResultSet ResultSet;
 typedef struct Node Node;
+typedef struct NodePool NodePool;
 typedef struct MarkBits MarkBits;
+typedef struct JoinKeys JoinKeys;
+typedef struct HashGroup HashGroup;
+typedef struct ScanPredicate ScanPredicate;
 typedef struct Index Index;
 typedef struct ComposedIndex ComposedIndex;
+typedef struct IndexBuilder IndexBuilder;
+typedef struct IndexSorter IndexSorter;
 typedef struct FirstLast FirstLast;
 typedef struct MemoryUsageEntry MemoryUsageEntry;
 typedef struct MemoryUsageHT MemoryUsageHT;
+typedef struct StatementCache StatementCache;
 typedef struct StringArray StringArray; // juliana@227_20
 
 /**
@@ -163,6 +173,36 @@ struct XFile
     */
    uint8 useCrypto; // juliana@crypto_1: now Litebase supports weak cryptography.
 
+   /**
+    * Indicates if the file was changed by the current transaction of its write-ahead log.
+    */
+   uint8 walChanged;
+
+   /**
+    * The size of the file on disk, which is smaller than its size while the growth of the current transaction is not committed.
+    */
+   uint32 walDiskSize;
+
+   /**
+    * The write-ahead log where the file changes are written before reaching the file, or <code>null</code> if the file is written directly.
+    */
+   Wal* wal;
+
+   /**
+    * The next file written through the same write-ahead log.
+    */
+   XFile* walNext;
+
+   /**
+    * The bytes written by the current transaction, which are only copied into the file after the transaction is committed.
+    */
+   WalExtent* walExtents;
+
+   /**
+    * The last range of bytes written by the current transaction.
+    */
+   WalExtent* walLastExtent;
+
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 #if defined(POSIX) || defined(ANDROID)
    /**
@@ -174,9 +214,123 @@ struct XFile
     * The timestamp of the last time the file was used.
     */ 
    int32 timeStamp;
+
+   /**
+    * The size of the memory mapping of the file, which is used as its cache, or zero if the file is read through a cache window.
+    */
+   uint32 mapSize;
 #endif
 };
 
+/**
+ * A range of bytes of a file written by a transaction that was not committed yet.
+ */
+struct WalExtent
+{
+   /**
+    * The range of the file written before this one.
+    */
+   WalExtent* prev;
+
+   /**
+    * The range of the file written after this one.
+    */
+   WalExtent* next;
+
+   /**
+    * The bytes of the range.
+    */
+   uint8* data;
+
+   /**
+    * The position of the range in the file.
+    */
+   int32 offset;
+
+   /**
+    * The number of bytes of the range.
+    */
+   int32 length;
+
+   /**
+    * The number of bytes allocated for the range, so that sequential writes can be appended to it.
+    */
+   int32 capacity;
+};
+
+/**
+ * The write-ahead log of a connection. The table files changes are appended to the log and are only copied into the files after the log is synced 
+ * with the commit of the transaction, so that the transaction is either completely done or not done at all after a crash.
+ */
+struct Wal
+{
+   /**
+    * The log file.
+    */
+   NATIVE_FILE file;
+
+   /**
+    * The log size.
+    */
+   int32 size;
+
+   /**
+    * The crc32 of the records of the current transaction.
+    */
+   int32 crc;
+
+   /**
+    * The number of transactions committed.
+    */
+   int32 commits;
+
+   /**
+    * The number of committed transactions already synced to the disk.
+    */
+   int32 synced;
+
+   /**
+    * The number of times the log was synced to the disk. Many commits from different connections can share a sync.
+    */
+   int32 syncs;
+
+   /**
+    * Indicates if a transaction was started with <code>BEGIN</code>, so that the statements are only committed with <code>COMMIT</code>.
+    */
+   uint8 inTransaction;
+
+   /**
+    * Indicates if a command of the current transaction failed. Its changes to the tables in memory can't be undone, so the transaction can't be 
+    * committed anymore and its changes are discarded when the connection is closed.
+    */
+   uint8 failed;
+
+   /**
+    * Indicates if the files are being written directly, which is done when executing commands that can't go through the log.
+    */
+   uint8 suspended;
+
+   /**
+    * The files written through the log.
+    */
+   XFile* files;
+
+   /**
+    * The next log of the list of logs of all the connections.
+    */
+   Wal* next;
+
+   /**
+    * The log file name.
+    */
+   char name[DBNAME_SIZE];
+
+   /**
+    * The log full path.
+    */
+   TCHAR fullPath[MAX_PATHNAME];
+};
+
 #if defined(POSIX) || defined(ANDROID)
 typedef struct XFilesList XFilesList;
 
@@ -329,6 +483,16 @@ struct SQLSelectClause
     */
    int32 sqlHashCode;
 
+   /**
+    * The number of open result sets of the select clause when it comes from the statement cache.
+    */
+   int32 resultSets;
+
+   /**
+    * Indicates if the statement of the select clause was freed from the statement cache while it still had open result sets.
+    */
+   uint8 isReleased;
+
 	/**
     * The resulting <code>ResultSet</code> table list.
     */
@@ -419,6 +583,16 @@ struct LitebaseParser
     */
    uint8 isWhereClause;
 
+   /**
+    * Indicates that the select is preceded by <code>EXPLAIN</code>.
+    */
+   uint8 isExplain;
+
+   /**
+    * Indicates that the index created or dropped is a trigram index.
+    */
+   uint8 isTrigram;
+
 	/**
     * The last position of the buffer read.
     */
@@ -1050,6 +1224,11 @@ struct SQLSelectStatement
     */
    uint8 type;
 
+   /**
+    * Indicates that the statement is preceded by <code>EXPLAIN</code>, so that its plan is returned instead of its rows.
+    */
+   uint8 isExplain;
+
    /**
     * The select clause of the statement.
     */
@@ -1254,6 +1433,32 @@ struct IntVector
    Heap heap;
 } ;
 
+/**
+ * The statistics of a column of a table, gathered from a sample of its rows by <code>ANALYZE</code>.
+ */
+struct ColumnStatistics
+{
+   /**
+    * The estimated number of distinct values of the column, or zero if it is unknown.
+    */
+   int32 distinctCount;
+
+   /**
+    * The estimated number of rows where the column is null.
+    */
+   int32 nullCount;
+
+   /**
+    * The number of buckets of the equi-depth histogram of a numeric column, or zero if it has no histogram.
+    */
+   int32 bucketsCount;
+
+   /**
+    * The bounds of the buckets of the histogram, from the minimum to the maximum sampled values. Each bucket has about the same number of rows.
+    */
+   double* bounds;
+};
+
 /**
  * The table structure.
  */
@@ -1289,6 +1494,16 @@ struct Table
     */
    uint8 wasUpdated; // juliana@270_27: now purge will also really purge the table if it only suffers updates.
 
+   /**
+    * Indicates if the rows inserted or updated in the table only update its primary key, leaving the other indices to be rebuilt later.
+    */
+   uint8 isBulkInsert;
+
+   /**
+    * Indicates if some indices of the table are out of date because of bulk inserts and must be rebuilt before being used.
+    */
+   uint8 hasDeferredIndices;
+
    /**
     * The primary key column.
     */
@@ -1330,6 +1545,11 @@ struct Table
     */
    int32 allRowsBitmapLength; // juliana@230_14: removed temporary tables when there is no join, group by, order by, and aggregation.
 
+   /**
+    * The number of rows of the table when it was analyzed, or zero if it has no statistics.
+    */
+   int32 analyzedRowCount;
+
    /**
     * The column attributes.
     */
@@ -1395,6 +1615,16 @@ struct Table
     * Existing column indices for each column, or <code>null</code> if the column has no index.
     */
    Index** columnIndexes;
+
+   /**
+    * Existing trigram indices for each column, or <code>null</code> if the table has no trigram index.
+    */
+   Index** columnTrigrams;
+
+   /**
+    * The statistics of each column gathered by the last <code>ANALYZE</code>, used only if <code>analyzedRowCount</code> is not zero.
+    */
+   ColumnStatistics* columnStatistics;
    
    /**
     * The corresponding files of the table.
@@ -1416,6 +1646,11 @@ struct Table
     */
    int32* nodes; // juliana@noidr_2: the maximum number of keys of a index was duplicated.
 
+   /**
+    * The pool of the index nodes of the connection.
+    */
+   NodePool* nodePool;
+
    /**
     * Existing composed column indices for each column, or <code>null</code> if the table has no composed index.
     */
@@ -1432,6 +1667,38 @@ struct Table
    Heap heap;
 };
 
+/**
+ * A comparison between a fixed size column and a constant of a WHERE clause conjunction, which is tested directly on the buffer of a row read 
+ * during a table scan, without evaluating the expression tree.
+ */
+struct ScanPredicate
+{
+   /**
+    * The index of the column.
+    */
+   uint8 colIndex;
+
+   /**
+    * Indicates if the column is the left operand of the comparison.
+    */
+   uint8 isLeft;
+
+   /**
+    * The type of the column.
+    */
+   int8 type;
+
+   /**
+    * The offset of the column in the row.
+    */
+   int32 offset;
+
+   /**
+    * The comparison.
+    */
+   SQLBooleanClauseTree* tree;
+};
+
 /**
  * Represents a set or rows resulting from a <code>LitebaseConnection.executeQuery()</code> method call.
  */
@@ -1464,6 +1731,26 @@ struct ResultSet
     */
    uint8 isPrepared;
 
+   /**
+    * Indicates that this <code>ResultSet</code> was generated by a select from the statement cache.
+    */
+   uint8 isCached;
+
+   /**
+    * Indicates if the WHERE clause was already split in the predicates tested directly on the rows and the remaining conditions.
+    */
+   uint8 isScanCompiled;
+
+   /**
+    * The number of predicates tested directly on the rows; if it is zero, the whole WHERE clause is evaluated.
+    */
+   uint8 scanPredicatesCount;
+
+   /**
+    * The number of the remaining conditions of the WHERE clause, evaluated after the predicates tested directly on the rows.
+    */
+   uint8 scanResidualsCount;
+
    /** 
     * The index of the correspodent result set. 
     */
@@ -1535,6 +1822,21 @@ struct ResultSet
     */
    MarkBits* markBits;
 
+   /**
+    * The keys used to find the rows of this result set that match an outer row of a join, or <code>null</code> if the join scans it.
+    */
+   JoinKeys* joinKeys;
+
+   /**
+    * The comparisons between fixed size columns and constants of the WHERE clause, which are tested directly on the rows read.
+    */
+   ScanPredicate scanPredicates[MAX_SCAN_PREDICATES];
+
+   /**
+    * The remaining conditions of the WHERE clause, which are only evaluated for the rows that satisfy <code>scanPredicates</code>.
+    */
+   SQLBooleanClauseTree* scanResiduals[MAX_SCAN_PREDICATES];
+
    /**
     * A heap to allocate the result set structure.
     */
@@ -1581,6 +1883,73 @@ struct Node // for B-tree
     * The keys that this node stores.
     */
    Key* keys;
+
+   /**
+    * The next node of the same node pool bucket.
+    */
+   Node* hashNext;
+
+   /**
+    * The node used right after this one in the node pool, or <code>null</code> if this is the most recently used node.
+    */
+   Node* newer;
+
+   /**
+    * The node used right before this one in the node pool, or <code>null</code> if this is the least recently used node.
+    */
+   Node* older;
+};
+
+/**
+ * The nodes from the deeper levels of all the indices of a connection. The nodes are found by a hash table and the least recently used ones are
+ * evicted when the pool goes over its memory budget.
+ */
+struct NodePool
+{
+   /**
+    * The number of nodes in the pool.
+    */
+   int32 count;
+
+   /**
+    * The memory used by the nodes in the pool.
+    */
+   int32 size;
+
+   /**
+    * The memory budget of the pool. The pool always accepts at least <code>NODE_POOL_MIN_NODES</code> nodes.
+    */
+   int32 budget;
+
+   /**
+    * The mask of the hash table buckets.
+    */
+   int32 mask;
+
+   /**
+    * The number of nodes found in the pool.
+    */
+   int64 hits;
+
+   /**
+    * The number of nodes that had to be loaded from the disk.
+    */
+   int64 misses;
+
+   /**
+    * The first node of each hash table bucket.
+    */
+   Node** buckets;
+
+   /**
+    * The most recently used node.
+    */
+   Node* newest;
+
+   /**
+    * The least recently used node.
+    */
+   Node* oldest;
 };
 
 /**
@@ -1624,6 +1993,140 @@ struct MarkBits
    Key rightKey;
 } ;
 
+/**
+ * The keys of the inner table of a join compared with an equality to a column of an outer table, when the inner column has no index. They replace 
+ * the scan of the inner table by a lookup of the rows with the key of the current outer row. The keys are hashed in memory if they fit in the join 
+ * memory budget; otherwise, they are sorted on a temporary file.
+ */
+struct JoinKeys
+{
+   /**
+    * Indicates if the keys are strings compared ignoring the case.
+    */
+   uint8 isCaseless;
+
+   /**
+    * Indicates if the keys are sorted on disk instead of hashed in memory.
+    */
+   uint8 isOnDisk;
+
+   /**
+    * The index of the result set of the outer column.
+    */
+   int8 outerRs;
+
+   /**
+    * The type of the keys.
+    */
+   int8 type;
+
+   /**
+    * The number of keys, which are the rows of the inner table whose column is not null.
+    */
+   int32 count;
+
+   /**
+    * The mask of the hash table buckets.
+    */
+   int32 mask;
+
+   /**
+    * The position of the outer row used in the last lookup, or -2 if no lookup was done yet.
+    */
+   int32 outerPos;
+
+   /**
+    * The first candidate of the last lookup: an index of the hash table chains or a key position in the file.
+    */
+   int32 first;
+
+   /**
+    * The next candidate of the last lookup, or -1 if there are no more candidates.
+    */
+   int32 next;
+
+   /**
+    * The hash of the key of the last lookup.
+    */
+   uint32 hash;
+
+   /**
+    * The first key of each hash table bucket or -1 if the bucket is empty.
+    */
+   int32* buckets;
+
+   /**
+    * The next key of the same bucket or -1. The keys of a bucket are chained in the order of their rows.
+    */
+   int32* chain;
+
+   /**
+    * The hashes of the keys.
+    */
+   uint32* hashes;
+
+   /**
+    * The rows of the keys.
+    */
+   int32* rows;
+
+   /**
+    * The hash of the first key of each block of <code>JOIN_BLOCK_PAIRS</code> keys of the file.
+    */
+   uint32* fences;
+
+   /**
+    * The equality between the outer and the inner columns.
+    */
+   SQLBooleanClauseTree* tree;
+
+   /**
+    * The temporary file with the pairs of hash and row of each key, sorted by hash and row.
+    */
+   XFile file;
+};
+
+/**
+ * A group of a GROUP BY aggregated in a hash table in memory. Its key, which is built as a sort key of the sort fields, follows the structure.
+ */
+struct HashGroup
+{
+   /**
+    * The hash of the key.
+    */
+   uint32 hash;
+
+   /**
+    * The number of rows of the group.
+    */
+   int32 rowsCount;
+
+   /**
+    * The next group of the same hash table bucket.
+    */
+   HashGroup* next;
+
+   /**
+    * The values of the columns of the select clause that are not aggregated functions, taken from the first row of the group.
+    */
+   SQLValue* values;
+
+   /**
+    * The running totals of the aggregated functions.
+    */
+   SQLValue* runTotals;
+
+   /**
+    * The number of rows of each aggregated function whose parameter is not null.
+    */
+   int32* groupCountCols;
+
+   /**
+    * The nulls of the columns of the select clause.
+    */
+   uint8* nulls;
+};
+
 /**
  * Represents a B-Tree header.
  */
@@ -1649,11 +2152,6 @@ struct Index // renamed from BTree to Index
     */
    uint8 btreeMaxNodes;
 
-   /**
-    * A cache of node.
-    */
-   uint8 cacheI;
-
    /**
     * The size of the keys.
     */
@@ -1702,9 +2200,9 @@ struct Index // renamed from BTree to Index
    // juliana@noidr_1: removed .idr files from all indices and changed its format.
 
    /**
-    * The cache of the index.
+    * The memory used by each node of the index kept in the node pool.
     */
-   Node* cache[CACHE_SIZE];
+   int32 poolNodeSize;
    
 // juliana@230_35: now the first level nodes of a b-tree index will be loaded in memory.
    /**
@@ -1759,6 +2257,136 @@ struct ComposedIndex
    Index* index;
 };
 
+/**
+ * Builds an index from its keys given in ascending order. The nodes are filled from the leaves to the root and each one is written once, when it 
+ * is full, so the index file grows sequentially. A full node keeps a free position for the last key of its level when the build finishes.
+ */
+struct IndexBuilder
+{
+   /**
+    * The number of levels of the index built so far.
+    */
+   int32 levels;
+
+   /**
+    * The index being built.
+    */
+   Index* index;
+
+   /**
+    * A heap to allocate the nodes being filled.
+    */
+   Heap heap;
+
+   /**
+    * The node being filled on each level, from the leaves to the root.
+    */
+   Node* nodes[INDEX_BUILD_LEVELS];
+};
+
+/**
+ * Sorts the keys of an index being built from the rows of its table, together with their records, and gives them to the index builder. Runs of 
+ * keys that fit in the sort memory are sorted in memory and written to a temporary file, which are then merged while the keys are given to the 
+ * builder. Keys of the indices beginning with the rowid are already in order and are not sorted.
+ */
+struct IndexSorter
+{
+   /**
+    * Indicates if the index is a primary key, which can't have duplicated keys.
+    */
+   uint8 isPKCreation;
+
+   /**
+    * Indicates if the record of a key is stored in the length of its first value instead of its time part.
+    */
+   uint8 isRecordInLength;
+
+   /**
+    * Indicates if the last key given to the builder is stored.
+    */
+   uint8 hasLast;
+
+   /**
+    * The number of keys of the current run.
+    */
+   int32 count;
+
+   /**
+    * The maximum number of keys of a run.
+    */
+   int32 capacity;
+
+   /**
+    * The number of runs written to the runs file.
+    */
+   int32 runCount;
+
+   /**
+    * The number of keys written to the runs file.
+    */
+   int32 total;
+
+   /**
+    * The size of a key in the runs file.
+    */
+   int32 keySize;
+
+   /**
+    * The index being built.
+    */
+   Index* index;
+
+   /**
+    * The keys of the current run.
+    */
+   SQLValue*** values;
+
+   /**
+    * A temporary array for the radix sort of the runs, or <code>null</code> if the keys are sorted with a quick sort.
+    */
+   SQLValue*** temp;
+
+   /**
+    * The last key given to the builder, used to find duplicated primary keys.
+    */
+   SQLValue** last;
+
+   /**
+    * The first key of each run being merged.
+    */
+   SQLValue*** heads;
+
+   /**
+    * The end of each run in the runs file followed by the position, the number of keys read, and the current key of each run being merged.
+    */
+   int32* runEnds;
+
+   /**
+    * The keys read from each run being merged.
+    */
+   uint8* blocks;
+
+   /**
+    * A buffer to write a key to the runs file.
+    */
+   uint8* buffer;
+
+   /**
+    * The runs file.
+    */
+   XFile runs;
+
+   /**
+    * The builder of the index.
+    */
+   IndexBuilder builder;
+
+   /**
+    * A heap to allocate the keys.
+    */
+   Heap heap;
+};
+
 /**
  * The information stored for each query concerning the temporary tables size.
  */
@@ -1811,6 +2439,28 @@ struct MemoryUsageHT
    int32 threshold;
 };
 
+/**
+ * The deletes, inserts, selects, and updates of a connection executed without being prepared, which are kept parsed and bound by their prepared 
+ * statements. The most recently used statement is the first one.
+ */
+struct StatementCache
+{
+   /**
+    * The number of statements in the cache.
+    */
+   int32 count;
+
+   /**
+    * The hash codes of the sql of the statements.
+    */
+   int32 hashCodes[STATEMENT_CACHE_SIZE];
+
+   /**
+    * The prepared statements.
+    */
+   TCObject statements[STATEMENT_CACHE_SIZE];
+};
+
 // juliana@227_20: corrected order by or group by with strings being too slow.
 /**
  * An structure used to sort tables with strings.
@@ -304,6 +304,19 @@ LB_API void lLC_getRowCount_s(NMParams p);
  */
 LB_API void lLC_setRowInc_si(NMParams p);
 
+/**
+ * Turns the bulk insertion mode of a table on or off. While it is on, the rows inserted or updated in the table only update its primary key. The 
+ * other indices are rebuilt from their sorted keys, which is much faster than inserting the keys one by one, when the mode is turned off, before 
+ * the table is used by a query, an update, or a delete, and when the connection is closed. Connections with a write-ahead log always keep the 
+ * indices up to date.
+ *
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->obj[1] The name of a table.
+ * @param p->i32[0] Indicates if the bulk insertion mode is to be turned on or off.
+ * @throws DriverException If an index can't be rebuilt.
+ */
+LB_API void lLC_setBulkInsert_sb(NMParams p);
+
 /**
  * Indicates if the given table already exists. This method can be used before a drop table.
  *
@@ -359,6 +372,43 @@ LB_API void lLC_getRowCountDeleted_s(NMParams p);
  */
 LB_API void lLC_getRowIterator_s(NMParams p);
 
+/**
+ * Sets the memory budget of the pool of the index nodes shared by the tables of the connection. The least recently used nodes are evicted, 
+ * after saving the dirty ones, when the pool grows beyond it, but the pool always keeps some nodes whatever its budget is.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->i32[0] The budget in bytes. Negative values are treated as 0.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_setNodePoolBudget_i(NMParams p);
+
+/**
+ * Gets the memory budget of the pool of the index nodes shared by the tables of the connection.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->retI receives the budget in bytes.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_getNodePoolBudget(NMParams p);
+
+/**
+ * Gets how many times an index node was found in the pool of the index nodes of the connection.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->retL receives the number of hits.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_getNodePoolHits(NMParams p);
+
+/**
+ * Gets how many times an index node had to be loaded into the pool of the index nodes of the connection.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->retL receives the number of misses.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_getNodePoolMisses(NMParams p);
+
 /**
  * Gets the Litebase logger. The fields should be used unless using the logger within threads. 
  * 
@@ -374,6 +424,21 @@ LB_API void lLC_privateGetLogger(NMParams p);
  */
 LB_API void lLC_privateSetLogger_l(NMParams p);
 
+/**
+ * Gets the memory budget of the hash tables used by the joins that compare a column without an index with an equality. 
+ * 
+ * @param p->retI receives the budget in bytes.
+ */
+LB_API void lLC_privateGetJoinMemoryBudget(NMParams p);
+
+/**
+ * Sets the memory budget of the hash tables used by the joins that compare a column without an index with an equality. The keys of the inner 
+ * tables whose hash table is larger than the budget are sorted on a temporary file instead. 
+ * 
+ * @param p->i32[0] The budget in bytes. Negative values are treated as 0, which makes all the lookups on tables stored on disk use sorted keys.
+ */
+LB_API void lLC_privateSetJoinMemoryBudget_i(NMParams p);
+
 /**                                                                                                                                                                                                                                                      
  * Gets the default Litebase logger. When this method is called for the first time, a new text file is created. In the subsequent calls, the same 
  * file is used.                                                                                                                                  
@@ -16,12 +16,12 @@
  * Creates a new node for an index.
  *
  * @param index The index of the node to be created.
+ * @param heap A heap to allocate the node.
  * @return The node created.
  */
-Node* createNode(Index* index)
+Node* createNode(Index* index, Heap heap)
 {
 	TRACE("createNode")
-   Heap heap = index->heap;
    Node* node = (Node*)TC_heapAlloc(heap, sizeof(Node));
    int32* colSizes = index->colSizes;
    int32 i = (node->index = index)->btreeMaxNodes, 
@@ -168,7 +168,7 @@ int32 nodeSave(Context context, Node* node, bool isNew, int32 left, int32 right)
       Key* newKeys;
       
       if (!newNode)
-         newNode = firstLevel[idx - 1] = createNode(index);
+         newNode = firstLevel[idx - 1] = createNode(index, index->heap);
       
       newKeys = newNode->keys;
       newNode->idx = idx;
@@ -292,3 +292,349 @@ bool nodeSetWriteDelayed(Context context, Node* node, bool delayed)
 		
    return true;
 }
+
+/**
+ * Creates the pool of the index nodes of a connection.
+ *
+ * @return The node pool or <code>null</code> if there is not enough memory to create it.
+ */
+NodePool* createNodePool()
+{
+   TRACE("createNodePool")
+   NodePool* pool = (NodePool*)xmalloc(sizeof(NodePool));
+   
+   if (pool && !(pool->buckets = (Node**)xmalloc(NODE_POOL_BUCKETS * sizeof(Node*))))
+   {
+      xfree(pool);
+      return null;
+   }
+   if (pool)
+   {
+      pool->mask = NODE_POOL_BUCKETS - 1;
+      pool->budget = NODE_POOL_BUDGET;
+   }
+   return pool;
+}
+
+/**
+ * Frees the pool of the index nodes of a connection. Its indices must have already been closed.
+ *
+ * @param pool The node pool.
+ */
+void freeNodePool(NodePool* pool)
+{
+   TRACE("freeNodePool")
+   Node* node;
+
+   if (pool)
+   {
+      while ((node = pool->oldest))
+      {
+         nodePoolUnlink(pool, node);
+         xfree(node);
+      }
+      xfree(pool->buckets);
+      xfree(pool);
+   }
+}
+
+/**
+ * Calculates the memory used by a node of an index kept in the node pool. Each part of the node is aligned to 8 bytes.
+ *
+ * @param index The index.
+ * @return The size of a pool node of the index.
+ */
+int32 nodePoolNodeSize(Index* index)
+{
+   TRACE("nodePoolNodeSize")
+   int32* colSizes = index->colSizes;
+   int32 keys = index->btreeMaxNodes,
+         numberColumns = index->numberColumns,
+         size = ((sizeof(Node) + 7) & ~7) + ((keys * sizeof(Key) + 7) & ~7) + ((((keys + 1) << 1) + 7) & ~7) 
+              + keys * ((numberColumns * sizeof(SQLValue) + 7) & ~7);
+
+   while (--numberColumns >= 0)
+      if (colSizes[numberColumns])
+         size += keys * (((colSizes[numberColumns] << 1) + 9) & ~7);
+   return size;
+}
+
+/**
+ * Creates a node for the node pool. Unlike the other nodes, it is allocated at once so that it can be freed when evicted.
+ *
+ * @param index The index of the node to be created.
+ * @return The node created or <code>null</code> if there is not enough memory to create it.
+ */
+Node* createPoolNode(Index* index)
+{
+   TRACE("createPoolNode")
+   int32* colSizes = index->colSizes;
+   int32 i = index->btreeMaxNodes, 
+         j,
+         numberColumns = index->numberColumns,
+         valuesSize = (numberColumns * sizeof(SQLValue) + 7) & ~7;
+   uint8* buffer = (uint8*)xmalloc(index->poolNodeSize);
+   Node* node = (Node*)buffer;
+   Key* key;
+
+   if (!buffer)
+      return null;
+   buffer += (sizeof(Node) + 7) & ~7;
+   node->index = index;
+   node->idx = -1;
+   node->keys = (Key*)buffer;
+   buffer += (i * sizeof(Key) + 7) & ~7;
+   node->children = (uint16*)buffer;
+   buffer += (((i + 1) << 1) + 7) & ~7;
+
+   while (--i >= 0)
+   {
+      key = &node->keys[i];
+      key->index = index;
+      key->keys = (SQLValue*)buffer;
+      buffer += valuesSize;
+      j = numberColumns;
+      while (--j >= 0)
+         if (colSizes[j])
+         {
+            key->keys[j].asChars = (JCharP)buffer;
+            buffer += ((colSizes[j] << 1) + 9) & ~7;
+         }
+   }
+   return node;
+}
+
+/**
+ * Hashes the index and the position of a node to find its node pool bucket.
+ *
+ * @param index The index of the node.
+ * @param idx The position of the node in the index.
+ * @return The hash of the node.
+ */
+uint32 nodePoolHash(Index* index, int32 idx)
+{
+   TRACE("nodePoolHash")
+   uint32 hash = (uint32)(((size_t)index >> 4) * 31 + idx) * 0x9E3779B1;
+   return hash ^ (hash >> 16);
+}
+
+/**
+ * Puts a node in the node pool as the most recently used one. The hash table is doubled when it has more nodes than buckets.
+ *
+ * @param pool The node pool.
+ * @param node The node to be put in the pool.
+ */
+void nodePoolLink(NodePool* pool, Node* node)
+{
+   TRACE("nodePoolLink")
+   Node** buckets;
+   Node* aux;
+   int32 mask = pool->mask;
+   uint32 hash;
+
+   if (++pool->count > mask + 1 && (buckets = (Node**)xmalloc(((mask + 1) << 1) * sizeof(Node*)))) // Rehashes the nodes.
+   {
+      xfree(pool->buckets);
+      pool->buckets = buckets;
+      pool->mask = mask = (mask << 1) | 1;
+      aux = pool->newest;
+      while (aux)
+      {
+         hash = nodePoolHash(aux->index, aux->idx) & mask;
+         aux->hashNext = buckets[hash];
+         buckets[hash] = aux;
+         aux = aux->older;
+      }
+   }
+
+   hash = nodePoolHash(node->index, node->idx) & pool->mask;
+   node->hashNext = pool->buckets[hash];
+   pool->buckets[hash] = node;
+   if ((node->older = pool->newest))
+      node->older->newer = node;
+   else
+      pool->oldest = node;
+   node->newer = null;
+   pool->newest = node;
+   pool->size += node->index->poolNodeSize;
+}
+
+/**
+ * Removes a node from the node pool without freeing it.
+ *
+ * @param pool The node pool.
+ * @param node The node to be removed from the pool.
+ */
+void nodePoolUnlink(NodePool* pool, Node* node)
+{
+   TRACE("nodePoolUnlink")
+   Node** previous = &pool->buckets[nodePoolHash(node->index, node->idx) & pool->mask];
+
+   while (*previous != node)
+      previous = &(*previous)->hashNext;
+   *previous = node->hashNext;
+   if (node->newer)
+      node->newer->older = node->older;
+   else
+      pool->newest = node->older;
+   if (node->older)
+      node->older->newer = node->newer;
+   else
+      pool->oldest = node->newer;
+   node->hashNext = node->newer = node->older = null;
+   pool->count--;
+   pool->size -= node->index->poolNodeSize;
+}
+
+/**
+ * Evicts the least recently used nodes from the node pool until a new node fits in its budget. The dirty nodes of indices with delayed writes are 
+ * saved before being evicted.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param pool The node pool.
+ * @param size The size of the new node or 0 to only shrink the pool to its budget.
+ * @param index The index of the new node.
+ * @return An evicted node of the same index that can be reused, or <code>null</code> if none was evicted or an error occurs.
+ */
+Node* nodePoolEvict(Context context, NodePool* pool, int32 size, Index* index)
+{
+   TRACE("nodePoolEvict")
+   Node* node;
+
+   while ((node = pool->oldest) && pool->count >= NODE_POOL_MIN_NODES && pool->size + size > pool->budget)
+   {
+      if (node->index->isWriteDelayed && node->isDirty && nodeSave(context, node, false, 0, node->size) < 0)
+         return null;
+      nodePoolUnlink(pool, node);
+      if (node->index == index && pool->size + size <= pool->budget)
+         return node;
+      xfree(node);
+   }
+   return null;
+}
+
+/**
+ * Gets a node from the deeper levels of an index, which are kept in the node pool of the connection. The nodes found in the pool become the most 
+ * recently used ones. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param index The index of the node.
+ * @param idx The position of the node in the index.
+ * @param evict Indicates if other nodes can be evicted to load this one. It must be <code>false</code> if nodes of the pool are being held, 
+ * since they may be freed.
+ * @return The node, or <code>null</code> if it is not in the pool and can't be loaded or an error occurs. 
+ * @throws OutOfMemoryError If there is not enough memory to create the node.
+ */
+Node* nodePoolGet(Context context, Index* index, int32 idx, bool evict)
+{
+   TRACE("nodePoolGet")
+   NodePool* pool = index->table->nodePool;
+   Node* node = pool->buckets[nodePoolHash(index, idx) & pool->mask];
+   int32 size = index->poolNodeSize;
+
+   while (node && (node->idx != idx || node->index != index))
+      node = node->hashNext;
+
+   if (node) // Found: makes it the most recently used node.
+   {
+      pool->hits++;
+      if (node->newer)
+      {
+         if ((node->newer->older = node->older))
+            node->older->newer = node->newer;
+         else
+            pool->oldest = node->newer;
+         (node->older = pool->newest)->newer = node;
+         node->newer = null;
+         pool->newest = node;
+      }
+      return node;
+   }
+
+   if (pool->count >= NODE_POOL_MIN_NODES && pool->size + size > pool->budget) // The pool is full.
+   {
+      if (!evict)
+         return null;
+      if (!(node = nodePoolEvict(context, pool, size, index)) && context->thrownException)
+         return null;
+   }
+   if (!node && !(node = createPoolNode(index)))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return null;
+   }
+
+   pool->misses++;
+   node->idx = idx;
+   nodePoolLink(pool, node);
+   if (!nodeLoad(context, node))
+   {
+      nodePoolUnlink(pool, node);
+      xfree(node);
+      return null;
+   }
+   return node;
+}
+
+/**
+ * Removes the nodes of an index from the node pool, without saving them. It must be called when the index is closed or emptied.
+ *
+ * @param index The index.
+ */
+void nodePoolRemoveIndex(Index* index)
+{
+   TRACE("nodePoolRemoveIndex")
+   NodePool* pool = index->table->nodePool;
+   Node* node = pool->oldest;
+   Node* newer;
+
+   while (node)
+   {
+      newer = node->newer;
+      if (node->index == index)
+      {
+         nodePoolUnlink(pool, node);
+         xfree(node);
+      }
+      node = newer;
+   }
+}
+
+/**
+ * Sets the flag that indicates if the nodes of an index kept in the node pool should have its write process delayed or not.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param index The index.
+ * @param delayed The new value of the flag.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool nodePoolSetWriteDelayed(Context context, Index* index, bool delayed)
+{
+   TRACE("nodePoolSetWriteDelayed")
+   Node* node = index->table->nodePool->newest;
+   bool ret = true;
+
+   while (node)
+   {
+      if (node->index == index)
+         ret &= nodeSetWriteDelayed(context, node, delayed);
+      node = node->older;
+   }
+   return ret;
+}
+
+/**
+ * Sets the memory budget of the node pool, evicting the nodes that don't fit in it anymore.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param pool The node pool.
+ * @param budget The new budget.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool nodePoolSetBudget(Context context, NodePool* pool, int32 budget)
+{
+   TRACE("nodePoolSetBudget")
+   pool->budget = budget;
+   nodePoolEvict(context, pool, 0, null);
+   return !context->thrownException;
+}
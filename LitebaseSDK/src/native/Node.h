@@ -17,9 +17,10 @@
  * Creates a new node for an index.
  *
  * @param index The index of the node to be created.
+ * @param heap A heap to allocate the node.
  * @return The node created.
  */
-Node* createNode(Index* index);
+Node* createNode(Index* index, Heap heap);
 
 /**
  * Loads a node.
@@ -98,4 +99,112 @@ bool nodeInsert(Context context, Node* node, Key* key, int32 leftChild, int32 ri
  */
 bool nodeSetWriteDelayed(Context context, Node* node, bool delayed);
 
+/**
+ * Creates the pool of the index nodes of a connection.
+ *
+ * @return The node pool or <code>null</code> if there is not enough memory to create it.
+ */
+NodePool* createNodePool();
+
+/**
+ * Frees the pool of the index nodes of a connection. Its indices must have already been closed.
+ *
+ * @param pool The node pool.
+ */
+void freeNodePool(NodePool* pool);
+
+/**
+ * Calculates the memory used by a node of an index kept in the node pool. Each part of the node is aligned to 8 bytes.
+ *
+ * @param index The index.
+ * @return The size of a pool node of the index.
+ */
+int32 nodePoolNodeSize(Index* index);
+
+/**
+ * Creates a node for the node pool. Unlike the other nodes, it is allocated at once so that it can be freed when evicted.
+ *
+ * @param index The index of the node to be created.
+ * @return The node created or <code>null</code> if there is not enough memory to create it.
+ */
+Node* createPoolNode(Index* index);
+
+/**
+ * Hashes the index and the position of a node to find its node pool bucket.
+ *
+ * @param index The index of the node.
+ * @param idx The position of the node in the index.
+ * @return The hash of the node.
+ */
+uint32 nodePoolHash(Index* index, int32 idx);
+
+/**
+ * Puts a node in the node pool as the most recently used one. The hash table is doubled when it has more nodes than buckets.
+ *
+ * @param pool The node pool.
+ * @param node The node to be put in the pool.
+ */
+void nodePoolLink(NodePool* pool, Node* node);
+
+/**
+ * Removes a node from the node pool without freeing it.
+ *
+ * @param pool The node pool.
+ * @param node The node to be removed from the pool.
+ */
+void nodePoolUnlink(NodePool* pool, Node* node);
+
+/**
+ * Evicts the least recently used nodes from the node pool until a new node fits in its budget. The dirty nodes of indices with delayed writes are 
+ * saved before being evicted.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param pool The node pool.
+ * @param size The size of the new node or 0 to only shrink the pool to its budget.
+ * @param index The index of the new node.
+ * @return An evicted node of the same index that can be reused, or <code>null</code> if none was evicted or an error occurs.
+ */
+Node* nodePoolEvict(Context context, NodePool* pool, int32 size, Index* index);
+
+/**
+ * Gets a node from the deeper levels of an index, which are kept in the node pool of the connection. The nodes found in the pool become the most 
+ * recently used ones. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param index The index of the node.
+ * @param idx The position of the node in the index.
+ * @param evict Indicates if other nodes can be evicted to load this one. It must be <code>false</code> if nodes of the pool are being held, 
+ * since they may be freed.
+ * @return The node, or <code>null</code> if it is not in the pool and can't be loaded or an error occurs. 
+ * @throws OutOfMemoryError If there is not enough memory to create the node.
+ */
+Node* nodePoolGet(Context context, Index* index, int32 idx, bool evict);
+
+/**
+ * Removes the nodes of an index from the node pool, without saving them. It must be called when the index is closed or emptied.
+ *
+ * @param index The index.
+ */
+void nodePoolRemoveIndex(Index* index);
+
+/**
+ * Sets the flag that indicates if the nodes of an index kept in the node pool should have its write process delayed or not.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param index The index.
+ * @param delayed The new value of the flag.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool nodePoolSetWriteDelayed(Context context, Index* index, bool delayed);
+
+/**
+ * Sets the memory budget of the node pool, evicting the nodes that don't fit in it anymore.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param pool The node pool.
+ * @param budget The new budget.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool nodePoolSetBudget(Context context, NodePool* pool, int32 budget);
+
 #endif
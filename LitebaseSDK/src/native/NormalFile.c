@@ -162,7 +162,8 @@ bool nfWriteBytes(Context context, XFile* xFile, uint8* buffer, int32 count)
 
 // juliana@227_3: improved table files flush dealing.
 /**
- * Enlarges the file. This function MUST be called to grow the file.
+ * Enlarges the file. This function MUST be called to grow the file. If the file is written through a write-ahead log, only its size is changed; 
+ * the file on disk grows when the transaction is committed.
  *
  * @param context The thread context where the function is being executed.
  * @param xFile A pointer to the normal file structure.
@@ -173,6 +174,26 @@ bool nfWriteBytes(Context context, XFile* xFile, uint8* buffer, int32 count)
 bool nfGrowTo(Context context, XFile* xFile, uint32 newSize)
 {
 	TRACE("nfGrowTo")
+   
+   if (!xFile->wal && !nfResize(context, xFile, xFile->size, newSize))
+      return false;
+   xFile->position = xFile->size = newSize;
+   return true;
+}
+
+/**
+ * Changes the size of the file on disk.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @param oldSize The current size of the file on disk.
+ * @param newSize The new size for the file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to grow the file.
+ */
+bool nfResize(Context context, XFile* xFile, uint32 oldSize, uint32 newSize)
+{
+	TRACE("nfResize")
    int32 ret;
 
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
@@ -189,14 +210,14 @@ bool nfGrowTo(Context context, XFile* xFile, uint32 newSize)
 
 // juliana@227_23: solved possible crashes when using a table recovered which was being used with setRowInc().
 #if !defined(POSIX) && !defined(ANDROID)
-   if (newSize - xFile->size > 0) // juliana@230_18: removed possible garbage in table files.
+   if (newSize > oldSize) // juliana@230_18: removed possible garbage in table files.
    {
       uint8 zeroBuf[1024];
-      int32 remains = newSize - xFile->size,
+      int32 remains = newSize - oldSize,
             written;
       xmemzero(zeroBuf, 1024);
 
-      if ((ret = lbfileSetPos(xFile->file, xFile->size)))
+      if ((ret = lbfileSetPos(xFile->file, oldSize)))
          goto error;
       while (remains > 0)
       {
@@ -206,9 +227,24 @@ bool nfGrowTo(Context context, XFile* xFile, uint32 newSize)
       }
       
    } 
+#else
+   UNUSED(oldSize)
+
+   if (xFile->mapSize) // The bytes of a mapped file end with the file. If it outgrows its mapping, it is mapped again.
+   {
+      if (newSize <= xFile->mapSize)
+         xFile->cacheEnd = newSize;
+      else
+      {
+         if (xFile->cacheIsDirty && !flushCache(context, xFile))
+            return false;
+         if ((ret = nfUnmap(xFile)))
+            goto error;
+         return nfMap(context, xFile);
+      }
+   }
 #endif
 
-   xFile->position = xFile->size = newSize;
    return true;
    
 error:
@@ -290,6 +326,7 @@ bool nfClose(Context context, XFile* xFile)
 {
 	TRACE("nfClose")
    int32 ret = 0;
+   bool detached = !xFile->wal || walDetach(context, xFile); // The pending changes are written directly into the file.
 
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 // Some files might have been closed if the maximum number of opened files was reached.
@@ -304,6 +341,14 @@ bool nfClose(Context context, XFile* xFile)
       if (xFile->cacheIsDirty) 
          flushCache(context, xFile);
       
+#if defined(POSIX) || defined(ANDROID)
+      if (xFile->mapSize) // The cache of a mapped file is its mapping.
+      {
+         if ((ret = nfUnmap(xFile)))
+            fileError(context, ret, xFile->name);
+      }
+      else
+#endif
       xfree(xFile->cache);
 
       // juliana@201_5: the .dbo file must be cropped so that it wont't be too large with zeros at the end of the file.
@@ -320,7 +365,7 @@ bool nfClose(Context context, XFile* xFile)
    removeFileFromList(xFile);
 #endif
 
-   return !ret;
+   return detached && !ret;
 }
 
 /** 
@@ -337,6 +382,7 @@ bool nfRemove(Context context, XFile* xFile, TCHARP sourcePath)
 	TRACE("nfRemove")
    TCHAR buffer[MAX_PATHNAME]; 
    int32 ret = 0;
+   bool detached = !xFile->wal || walDetach(context, xFile);
 
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 // Some files might have been closed if the maximum number of opened files was reached.
@@ -349,17 +395,25 @@ bool nfRemove(Context context, XFile* xFile, TCHARP sourcePath)
    if ((ret |= lbfileDelete(&xFile->file, buffer, true)))
       fileError(context, ret, xFile->name);
    fileInvalidate(xFile->file);
+
+#if defined(POSIX) || defined(ANDROID)
+   if (xFile->mapSize) // The cache of a mapped file is its mapping.
+      ret |= nfUnmap(xFile);
+   else
+#endif
    xfree(xFile->cache);
 
 #if defined(POSIX) || defined(ANDROID)
    removeFileFromList(xFile);
 #endif
 
-   return !ret;
+   return detached && !ret;
 }
 
 /**
- * The cache must be refreshed if what is desired is not inside it.
+ * The cache must be refreshed if what is desired is not inside it. If the file is written through a write-ahead log, the part of the file not yet
+ * on disk is read as zeros and the bytes written by the current transaction are placed over the bytes read. A mapped file is all inside its 
+ * cache, so it only gets here when the bytes are past its end, and it is enlarged as if the bytes were flushed there.
  *
  * @param context The thread context where the function is being executed.
  * @param xFile A pointer to the normal file structure.
@@ -373,6 +427,11 @@ bool refreshCache(Context context, XFile* xFile, int32 count)
 	TRACE("refreshCache")
    int32 bytes,
          ret;
+
+#if defined(POSIX) || defined(ANDROID)
+   if (xFile->mapSize)
+      return nfResize(context, xFile, xFile->cacheEnd, xFile->cachePos + count);
+#endif
    
    if (xFile->cacheIsDirty && !flushCache(context, xFile)) // Flushes the cache if necessary.
       return false;
@@ -404,6 +463,18 @@ error:
       return false;
    }
 
+   if (xFile->wal)
+   {
+      // The file on disk can be smaller than the file while the transaction is not committed.
+      if (bytes < xFile->cacheInitialSize && xFile->cachePos + bytes < (int32)xFile->size)
+      {
+         ret = MIN(xFile->cacheInitialSize, (int32)xFile->size - xFile->cachePos);
+         xmemzero(&xFile->cache[bytes], ret - bytes);
+         bytes = ret;
+      }
+      walReadExtents(xFile, xFile->cachePos, bytes);
+   }
+
    // Updates the cache parameters.
    xFile->cacheDirtyEnd = xFile->cacheIni = xFile->cachePos;
    xFile->cacheDirtyIni = xFile->cacheEnd = xFile->cacheIni + bytes;
@@ -412,7 +483,8 @@ error:
 }
 
 /**
- * Flushs the cache into the disk.
+ * Flushs the cache into the disk. If the file is written through a write-ahead log, the cache is flushed into the log. If the file is mapped, its
+ * changed pages are synced to the disk.
  *
  * @param context The thread context where the function is being executed.
  * @param xFile A pointer to the normal file structure.
@@ -425,9 +497,31 @@ bool flushCache(Context context, XFile* xFile)
    int32 written,
          ret;
 
+   if (xFile->wal)
+   {
+      if (xFile->cacheDirtyEnd > xFile->cacheDirtyIni && !walWrite(context, xFile, xFile->cacheDirtyIni, 
+                                                     &xFile->cache[xFile->cacheDirtyIni - xFile->cacheIni], xFile->cacheDirtyEnd - xFile->cacheDirtyIni))
+         return false;
+      xFile->cacheIsDirty = false;
+      return true;
+   }
+
+#if defined(POSIX) || defined(ANDROID)
+   // The bytes of a mapped file are already in the file. They are synced unless the file should not be flushed, which keeps it dirty until it is.
+   if (xFile->mapSize)
+   {
+      if (xFile->dontFlush)
+         return true;
+      if ((ret = lbfileSyncMap(xFile->cache, xFile->cacheDirtyIni, xFile->cacheDirtyEnd - xFile->cacheDirtyIni)))
+         goto error;
+      xFile->cacheIsDirty = false;
+      xFile->cacheDirtyIni = xFile->mapSize;
+      xFile->cacheDirtyEnd = 0;
+      return true;
+   }
+
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 // Some files might have been closed if the maximum number of opened files was reached.
-#if defined(POSIX) || defined(ANDROID)
    if ((ret = reopenFileIfNeeded(context, xFile)))
       goto error;
 #endif
@@ -470,8 +564,819 @@ void fileError(Context context, int32 errorCode, CharP fileName)
    TC_throwExceptionNamed(context, "litebase.DriverException", errorMsg);
 }
 
+/**
+ * Creates the write-ahead log of a connection and puts it in the list of logs, so that its commits can be synced together with the commits of the 
+ * other connections.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param name The name of the log file.
+ * @param sourcePath The path where the log file will be created.
+ * @return The log or <code>null</code> if an error occurs.
+ * @throws DriverException If the log file can't be created.
+ * @throws OutOfMemoryError If there is not enough memory to create the log.
+ */
+Wal* walCreate(Context context, CharP name, TCHARP sourcePath)
+{
+   TRACE("walCreate")
+   Wal* wal = (Wal*)xmalloc(sizeof(Wal));
+   int32 ret;
+
+   if (!wal)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return null;
+   }
+
+   xstrcpy(wal->name, name);
+   getFullFileName(name, sourcePath, wal->fullPath);
+   if ((ret = lbfileCreate(&wal->file, wal->fullPath, CREATE_EMPTY)))
+   {
+      fileError(context, ret, name);
+      xfree(wal);
+      return null;
+   }
+
+   LOCKVAR(wal);
+   wal->next = walList;
+   walList = wal;
+   UNLOCKVAR(wal);
+   return wal;
+}
+
+/**
+ * Closes the write-ahead log of a connection and removes its file. The log must have already been committed and checkpointed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to remove the log file.
+ */
+bool walClose(Context context, Wal* wal)
+{
+   TRACE("walClose")
+   Wal** previous;
+   int32 ret;
+   bool detached = true;
+
+   while (wal->files)
+      detached &= walDetach(context, wal->files);
+
+   // The log can't be removed from the list while other connection is syncing it.
+   LOCKVAR(walSync);
+   LOCKVAR(wal);
+   previous = &walList;
+   while (*previous != wal)
+      previous = &(*previous)->next;
+   *previous = wal->next;
+   UNLOCKVAR(wal);
+   UNLOCKVAR(walSync);
+
+   if ((ret = lbfileClose(&wal->file)) || (ret = lbfileDelete(null, wal->fullPath, false)))
+      fileError(context, ret, wal->name);
+   xfree(wal);
+   return detached && !ret;
+}
+
+/**
+ * Starts writing a file through a write-ahead log. A mapped file is unmapped, since its changes can't reach the file before being committed.
+ *
+ * @param wal The log.
+ * @param xFile A pointer to the normal file structure.
+ */
+void walAttach(Wal* wal, XFile* xFile)
+{
+   TRACE("walAttach")
+   if (!xFile->wal && *xFile->name)
+   {
+#if defined(POSIX) || defined(ANDROID)
+      if (xFile->mapSize) // Its bytes are already in the file: there is nothing to flush.
+         nfUnmap(xFile);
+#endif
+      xFile->wal = wal;
+      xFile->walDiskSize = xFile->size;
+      xFile->walNext = wal->files;
+      wal->files = xFile;
+   }
+}
+
+/**
+ * Stops writing a file through its write-ahead log. The bytes written by the current transaction are copied into the file without waiting for its
+ * commit, and the file is synced if the log still has committed bytes of the file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the file.
+ */
+bool walDetach(Context context, XFile* xFile)
+{
+   TRACE("walDetach")
+   Wal* wal = xFile->wal;
+   XFile** previous = &wal->files;
+   int32 ret = 0;
+   bool applied = true;
+
+   while (*previous != xFile)
+      previous = &(*previous)->walNext;
+   *previous = xFile->walNext;
+   
+   if (xFile->walChanged || xFile->size != xFile->walDiskSize)
+      applied = walApply(context, xFile);
+
+   if (wal->size)
+   {
+// juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
+// Some files might have been closed if the maximum number of opened files was reached.
+#if defined(POSIX) || defined(ANDROID)
+      if (!(ret = reopenFileIfNeeded(context, xFile)))
+#endif
+      ret = lbfileFlush(xFile->file);
+      if (ret)
+         fileError(context, ret, xFile->name);
+   }
+
+   xFile->wal = null;
+   xFile->walNext = null;
+   return applied && !ret;
+}
+
+/**
+ * Appends bytes to the write-ahead log. They are part of the current transaction until the next commit.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @param buffer The bytes to be appended.
+ * @param length The number of bytes to be appended.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the log.
+ */
+bool walAppend(Context context, Wal* wal, uint8* buffer, int32 length)
+{
+   TRACE("walAppend")
+   int32 written,
+         ret;
+
+   if ((ret = lbfileWriteBytes(wal->file, (CharP)buffer, 0, length, &written)))
+   {
+      fileError(context, ret, wal->name);
+      return false;
+   }
+   wal->crc = updateCRC32(buffer, length, wal->crc);
+   wal->size += length;
+   return true;
+}
+
+/**
+ * Writes bytes of a file into its write-ahead log. The bytes are kept in memory until the transaction is committed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @param offset The position of the bytes in the file.
+ * @param data The bytes written.
+ * @param length The number of bytes written.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the log.
+ * @throws OutOfMemoryError If there is not enough memory to keep the bytes written.
+ */
+bool walWrite(Context context, XFile* xFile, int32 offset, uint8* data, int32 length)
+{
+   TRACE("walWrite")
+   uint8 header[DBNAME_SIZE + 10];
+   int32 nameLength = xstrlen(xFile->name);
+
+   // type + name length + name + offset + length.
+   header[0] = WAL_RECORD_WRITE;
+   header[1] = (uint8)nameLength;
+   xmemmove(&header[2], xFile->name, nameLength);
+   xmove4(&header[nameLength + 2], &offset);
+   xmove4(&header[nameLength + 6], &length);
+   
+   xFile->walChanged = true;
+   return walAppend(context, xFile->wal, header, nameLength + 10) && walAppend(context, xFile->wal, data, length) 
+       && walAddExtent(context, xFile, offset, data, length);
+}
+
+/**
+ * Keeps the bytes written by the current transaction into a file. A sequential write is appended to the last range of bytes written and a rewrite
+ * of a range is done in place, so that the number of ranges is kept small. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @param offset The position of the bytes in the file.
+ * @param data The bytes written.
+ * @param length The number of bytes written.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enough memory to keep the bytes written.
+ */
+bool walAddExtent(Context context, XFile* xFile, int32 offset, uint8* data, int32 length)
+{
+   TRACE("walAddExtent")
+   WalExtent* extent = xFile->walLastExtent;
+   int32 end = offset + length;
+
+   if (extent && offset >= extent->offset && offset <= extent->offset + extent->length) // Appends to or rewrites the last range. 
+   {
+      int32 newLength = MAX(extent->length, end - extent->offset);
+
+      if (newLength > extent->capacity)
+      {
+         int32 capacity = MAX(newLength, extent->capacity << 1);
+         uint8* buffer = (uint8*)xrealloc(extent->data, capacity);
+
+         if (!buffer)
+         {
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+            return false;
+         }
+         extent->data = buffer;
+         extent->capacity = capacity;
+      }
+      xmemmove(&extent->data[offset - extent->offset], data, length);
+      extent->length = newLength;
+      return true;
+   }
+
+   // Finds the last range which overlaps the new one. The new bytes can only be written there if the range contains them.
+   while (extent && (end <= extent->offset || offset >= extent->offset + extent->length))
+      extent = extent->prev;
+   if (extent && offset >= extent->offset && end <= extent->offset + extent->length)
+   {
+      xmemmove(&extent->data[offset - extent->offset], data, length);
+      return true;
+   }
+
+   // Creates a new range.
+   if (!(extent = (WalExtent*)xmalloc(sizeof(WalExtent))) || !(extent->data = (uint8*)xmalloc(length)))
+   {
+      xfree(extent);
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+   xmemmove(extent->data, data, length);
+   extent->offset = offset;
+   extent->length = extent->capacity = length;
+   if ((extent->prev = xFile->walLastExtent))
+      extent->prev->next = extent;
+   else
+      xFile->walExtents = extent;
+   xFile->walLastExtent = extent;
+   return true;
+}
+
+/**
+ * Places the bytes written by the current transaction over the bytes of the file read into the cache.
+ *
+ * @param xFile A pointer to the normal file structure.
+ * @param position The position of the file read into the cache.
+ * @param length The number of bytes read into the cache.
+ */
+void walReadExtents(XFile* xFile, int32 position, int32 length)
+{
+   TRACE("walReadExtents")
+   WalExtent* extent = xFile->walExtents;
+   int32 end = position + length,
+         start,
+         stop;
+
+   while (extent) // The ranges are placed in the order they were written.
+   {
+      start = MAX(position, extent->offset);
+      stop = MIN(end, extent->offset + extent->length);
+      if (start < stop)
+         xmemmove(&xFile->cache[start - position], &extent->data[start - extent->offset], stop - start);
+      extent = extent->next;
+   }
+}
+
+/**
+ * Copies the bytes written by a committed transaction into the file and frees them. The file on disk also gets the size given to the file by the
+ * transaction.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the file.
+ */
+bool walApply(Context context, XFile* xFile)
+{
+   TRACE("walApply")
+   WalExtent* extent = xFile->walExtents;
+   WalExtent* next;
+   int32 size = xFile->size,
+         written,
+         ret = 0;
+
+   // The file grows before the bytes are written so that the zeros of the growth won't overwrite them.
+   if (xFile->walDiskSize != xFile->size)
+   {
+      if (!nfResize(context, xFile, xFile->walDiskSize, xFile->size))
+         return false;
+      xFile->walDiskSize = xFile->size;
+   }
+
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
+// Some files might have been closed if the maximum number of opened files was reached.
 #if defined(POSIX) || defined(ANDROID)
+   if (extent)
+      ret = reopenFileIfNeeded(context, xFile);
+#endif
+
+   while (extent)
+   {
+      // The bytes after the end of a file that shrank are discarded.
+      if (!ret && extent->offset < size && !(ret = lbfileSetPos(xFile->file, extent->offset)))
+         ret = lbfileWriteBytes(xFile->file, (CharP)extent->data, 0, MIN(extent->length, size - extent->offset), &written);
+      next = extent->next;
+      xfree(extent->data);
+      xfree(extent);
+      extent = next;
+   }
+   xFile->walExtents = xFile->walLastExtent = null;
+   xFile->walChanged = false;
+
+   if (ret)
+   {
+      fileError(context, ret, xFile->name);
+      return false;
+   }
+   return true;
+}
+
+/**
+ * Discards the current transaction of a write-ahead log. The bytes written by it are freed without being copied into the files, which get back the 
+ * sizes they have on disk. The records of the transaction in the log have no commit record, so they are never recovered.
+ *
+ * @param wal The log.
+ */
+void walDiscard(Wal* wal)
+{
+   TRACE("walDiscard")
+   XFile* xFile = wal->files;
+   WalExtent* extent;
+   WalExtent* next;
+
+   while (xFile)
+   {
+      extent = xFile->walExtents;
+      while (extent)
+      {
+         next = extent->next;
+         xfree(extent->data);
+         xfree(extent);
+         extent = next;
+      }
+      xFile->walExtents = xFile->walLastExtent = null;
+      xFile->walChanged = xFile->cacheIsDirty = false;
+      xFile->cacheDirtyIni = xFile->cacheDirtyEnd = 0;
+      xFile->cacheIni = xFile->cacheEnd = 0; // The cache may have bytes of the transaction.
+      xFile->size = xFile->walDiskSize;
+      xFile = xFile->walNext;
+   }
+   wal->crc = 0;
+}
+
+/**
+ * Commits the current transaction of a write-ahead log. The dirty caches and the new sizes of the files are written into the log, which is synced
+ * with the logs of the other connections that are also committing. Only then the bytes written by the transaction are copied into the files. The log
+ * is checkpointed if it became too big.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the log or to the files.
+ * @throws OutOfMemoryError If there is not enough memory to keep the bytes written.
+ */
+bool walCommit(Context context, Wal* wal)
+{
+   TRACE("walCommit")
+   XFile* xFile = wal->files;
+   uint8 record[DBNAME_SIZE + 6];
+   int32 nameLength;
+   bool changed = false;
+
+   while (xFile) // Writes the pending changes of the files into the log.
+   {
+      if (xFile->cacheIsDirty && !flushCache(context, xFile))
+         return false;
+      if (xFile->size != xFile->walDiskSize) // type + name length + name + size.
+      {
+         record[0] = WAL_RECORD_SIZE;
+         record[1] = (uint8)(nameLength = xstrlen(xFile->name));
+         xmemmove(&record[2], xFile->name, nameLength);
+         xmove4(&record[nameLength + 2], &xFile->size);
+         if (!walAppend(context, wal, record, nameLength + 6))
+            return false;
+         xFile->walChanged = true;
+      }
+      changed |= xFile->walChanged;
+      xFile = xFile->walNext;
+   }
+   if (!changed) // Nothing to be committed.
+      return true;
+
+   // The commit record has the crc32 of the transaction records so that a transaction partially written is not recovered.
+   record[0] = WAL_RECORD_COMMIT;
+   xmove4(&record[1], &wal->crc);
+   if (!walAppend(context, wal, record, 5))
+      return false;
+   wal->crc = 0;
+   if (!walSync(context, wal))
+      return false;
+
+   xFile = wal->files;
+   while (xFile) // The transaction is durable: copies it into the files.
+   {
+      if (xFile->walChanged && !walApply(context, xFile))
+         return false;
+      xFile = xFile->walNext;
+   }
+   return wal->size < WAL_CHECKPOINT || walCheckpoint(context, wal);
+}
+
+/**
+ * Syncs the log to the disk after a commit. If another connection is already syncing, waits for it and then syncs the logs of all the connections
+ * that committed meanwhile, so that concurrent commits share a single sync of each log. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to sync the log.
+ */
+bool walSync(Context context, Wal* wal)
+{
+   TRACE("walSync")
+   Wal* log;
+   int32 commit,
+         pending,
+         ret = 0;
+
+   LOCKVAR(wal);
+   commit = ++wal->commits;
+   UNLOCKVAR(wal);
+
+   // The logs are only removed from the list while holding the sync mutex.
+   LOCKVAR(walSync);
+   if (wal->synced < commit) // No other connection synced this commit.
+   {
+      LOCKVAR(wal);
+      log = walList;
+      UNLOCKVAR(wal);
+
+      while (log)
+      {
+         LOCKVAR(wal);
+         pending = log->commits;
+         UNLOCKVAR(wal);
+
+         if (log->synced < pending)
+         {
+            if (!(ret = lbfileFlush(log->file)))
+            {
+               log->synced = pending;
+               log->syncs++;
+            }
+            else if (log == wal)
+               break;
+            else // The other connection will sync its own log.
+               ret = 0;
+         }
+         log = log->next;
+      }
+   }
+   UNLOCKVAR(walSync);
+
+   if (ret)
+   {
+      fileError(context, ret, wal->name);
+      return false;
+   }
+   return true;
+}
+
+/**
+ * Checkpoints a write-ahead log: syncs its files, whose bytes were already copied from the log, and empties it.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to sync the files or to empty the log.
+ */
+bool walCheckpoint(Context context, Wal* wal)
+{
+   TRACE("walCheckpoint")
+   XFile* xFile = wal->files;
+   int32 ret = 0;
+
+   if (!wal->size)
+      return true;
+
+   while (xFile) 
+   {
+// juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
+// Some files might have been closed if the maximum number of opened files was reached.
+#if defined(POSIX) || defined(ANDROID)
+      if ((ret = reopenFileIfNeeded(context, xFile)))
+         goto error;
+#endif
+      if ((ret = lbfileFlush(xFile->file)))
+         goto error;
+      xFile = xFile->walNext;
+   }
+
+   if ((ret = lbfileSetSize(&wal->file, 0)) || (ret = lbfileSetPos(wal->file, 0)) || (ret = lbfileFlush(wal->file)))
+   {
+      fileError(context, ret, wal->name);
+      return false;
+   }
+   wal->size = wal->crc = 0;
+   return true;
+
+error:
+   fileError(context, ret, xFile->name);
+   return false;
+}
+
+/**
+ * Recovers the tables of the logs left by connections that were not closed, which happens if the application stops suddenly. The committed 
+ * transactions of each log are copied into the tables and the log is removed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param prefix The prefix of the names of the logs of the connection creator id.
+ * @param sourcePath The path where the tables are stored.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to read a log or to write to a table file.
+ * @throws OutOfMemoryError If there is not enough memory to read a log.
+ */
+bool walRecover(Context context, CharP prefix, TCHARP sourcePath)
+{
+   TRACE("walRecover")
+   TCHARPs* list = null;
+   TCHAR fullPath[MAX_PATHNAME];
+   char name[MAX_PATHNAME];
+   int32 count = 0,
+         length = xstrlen(prefix),
+         ret;
+   bool recovered = true;
+   Wal* wal;
+   Heap heap = heapCreate();
+
+   IF_HEAP_ERROR(heap)
+   {
+      heapDestroy(heap);
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+
+   if ((ret = TC_listFiles(sourcePath, 1, &list, &count, heap, 0))) // Lists all the files of the folder.
+   {
+      heapDestroy(heap);
+      fileError(context, ret, "");
+      return false;
+   }
+
+   LOCKVAR(wal);
+   while (recovered && --count >= 0)
+   {
+      TC_TCHARP2CharPBuf(list->value, name);
+      if (!xstrncmp(name, prefix, length) && (ret = xstrlen(name)) > 4 && !xstrcmp(&name[ret - 4], WAL_EXTENSION))
+      {
+         getFullFileName(name, sourcePath, fullPath);
+         wal = walList;
+         while (wal && tcscmp(wal->fullPath, fullPath))
+            wal = wal->next;
+            
+         if (!wal && (recovered = walReplay(context, name, fullPath, sourcePath)) // The log does not belong to an open connection.
+          && (ret = lbfileDelete(null, fullPath, false)))
+         {
+            fileError(context, ret, name);
+            recovered = false;
+         }
+      }
+      list = list->next;
+   }
+   UNLOCKVAR(wal);
+
+   heapDestroy(heap);
+   return recovered;
+}
+
+/**
+ * Copies the committed transactions of a log into the table files. A transaction whose records are incomplete or whose crc32 does not match was not
+ * committed and ends the recovery.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param name The name of the log file.
+ * @param fullPath The full path of the log file.
+ * @param sourcePath The path where the tables are stored.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to read the log or to write to a table file.
+ * @throws OutOfMemoryError If there is not enough memory to read the log.
+ */
+bool walReplay(Context context, CharP name, TCHARP fullPath, TCHARP sourcePath)
+{
+   TRACE("walReplay")
+   NATIVE_FILE log;
+   uint8* buffer = null;
+   int32 size = 0,
+         position = 0,
+         start = 0,
+         length,
+         crc,
+         ret;
+   bool replayed = true;
+
+   fileInvalidate(log);
+   if ((ret = lbfileCreate(&log, fullPath, READ_WRITE)) || (ret = lbfileGetSize(log, null, &size)))
+      goto error;
+
+   if (size)
+   {
+      if (!(buffer = (uint8*)xmalloc(size)))
+      {
+         TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+         replayed = false;
+         goto finish;
+      }
+      if ((ret = lbfileReadBytes(log, (CharP)buffer, 0, size, &size)))
+         goto error;
+   }
+
+   while (position < size)
+   {
+      switch (buffer[position])
+      {
+         case WAL_RECORD_WRITE: // type + name length + name + offset + length + data.
+            if (position + 2 > size || (position += buffer[position + 1] + 10) > size)
+               goto finish;
+            xmove4(&length, &buffer[position - 4]);
+            if (length < 0 || (position += length) > size)
+               goto finish;
+            break;
+
+         case WAL_RECORD_SIZE: // type + name length + name + size.
+            if (position + 2 > size || (position += buffer[position + 1] + 6) > size)
+               goto finish;
+            break;
+
+         case WAL_RECORD_COMMIT: // type + crc32.
+            if (position + 5 > size)
+               goto finish;
+            xmove4(&crc, &buffer[position + 1]);
+            if (updateCRC32(&buffer[start], position - start, 0) != crc)
+               goto finish;
+            if (!(replayed = walReplayTransaction(context, &buffer[start], position - start, sourcePath)))
+               goto finish;
+            start = position += 5;
+            break;
+
+         default: // A record partially written.
+            goto finish;
+      }
+   }
+   goto finish;
+
+error:
+   fileError(context, ret, name);
+   replayed = false;
+
+finish:
+   xfree(buffer);
+   if (fileIsValid(log))
+      lbfileClose(&log);
+   return replayed;
+}
+
+/**
+ * Copies the records of a committed transaction into the table files.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param records The records of the transaction, without its commit record.
+ * @param length The length of the records.
+ * @param sourcePath The path where the tables are stored.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to a table file.
+ */
+bool walReplayTransaction(Context context, uint8* records, int32 length, TCHARP sourcePath)
+{
+   TRACE("walReplayTransaction")
+   NATIVE_FILE file;
+   TCHAR fullPath[MAX_PATHNAME];
+   char fileName[DBNAME_SIZE],
+        name[DBNAME_SIZE];
+   uint8* end = records + length;
+   int32 nameLength,
+         value,
+         written,
+         ret = 0;
+
+   fileInvalidate(file);
+   fileName[0] = 0;
+   while (records < end)
+   {
+      // The name of the file of the record. Consecutive records usually belong to the same file.
+      xmemmove(name, &records[2], nameLength = records[1]);
+      name[nameLength] = 0;
+      if (xstrcmp(name, fileName))
+      {
+         if (fileIsValid(file) && ((ret = lbfileFlush(file)) || (ret = lbfileClose(&file))))
+            goto error;
+         fileInvalidate(file);
+         xstrcpy(fileName, name);
+         getFullFileName(name, sourcePath, fullPath);
+         if ((ret = lbfileCreate(&file, fullPath, READ_WRITE)))
+            goto error;
+      }
+
+      xmove4(&value, &records[nameLength + 2]);
+      if (*records == WAL_RECORD_WRITE)
+      {
+         xmove4(&length, &records[nameLength + 6]);
+         if ((ret = lbfileSetPos(file, value)) || (ret = lbfileWriteBytes(file, (CharP)&records[nameLength + 10], 0, length, &written)))
+            goto error;
+         records += nameLength + 10 + length;
+      }
+      else 
+      {
+         if ((ret = lbfileSetSize(&file, value)))
+            goto error;
+         records += nameLength + 6;
+      }
+   }
+
+   if (fileIsValid(file) && ((ret = lbfileFlush(file)) || (ret = lbfileClose(&file))))
+      goto error;
+   return true;
+
+error:
+   fileError(context, ret, name);
+   if (fileIsValid(file))
+      lbfileClose(&file);
+   return false;
+}
+
+#if defined(POSIX) || defined(ANDROID)
+/**
+ * Maps a file into memory, so that the mapping is used as its cache and a read of a part of the file not read before does not need a system call.
+ * The mapping is larger than the file so that it can grow without being mapped again. A file written through a write-ahead log is not mapped, as 
+ * well as the file if it can't be mapped, which keeps using a cache window.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to flush the cache.
+ */
+bool nfMap(Context context, XFile* xFile)
+{
+   TRACE("nfMap")
+   uint8* map;
+   int32 size,
+         mapSize,
+         ret;
+
+   if (xFile->mapSize || xFile->wal || !*xFile->name)
+      return true;
+
+   // The bytes of the cache and the ones buffered when writing the file must reach it before it is mapped.
+   if (xFile->cacheIsDirty && !flushCache(context, xFile))
+      return false;
+   if ((ret = reopenFileIfNeeded(context, xFile)) || (ret = lbfileFlush(xFile->file)) || (ret = lbfileGetSize(xFile->file, null, &size)))
+   {
+      fileError(context, ret, xFile->name);
+      return false;
+   }
+
+   mapSize = ((size + (size >> 1)) | (MAP_GROWTH_SIZE - 1)) + 1;
+   if (lbfileMap(xFile->file, mapSize, &map))
+      return true;
+
+   xfree(xFile->cache);
+   xFile->cache = map;
+   xFile->cacheInitialSize = xFile->cacheDirtyIni = xFile->mapSize = mapSize;
+   xFile->cacheIni = xFile->cacheDirtyEnd = 0;
+   xFile->cacheEnd = size;
+   xFile->cacheIsDirty = false;
+   return true;
+}
+
+/**
+ * Unmaps a mapped file, which goes back to be read through a cache window. Its changed bytes are already in the file, but they are only synced to 
+ * the disk if its cache was flushed before.
+ *
+ * @param xFile A pointer to the normal file structure.
+ * @return The error code if an error occurred or zero if the function succeeds.
+ */
+int32 nfUnmap(XFile* xFile)
+{
+   TRACE("nfUnmap")
+   int32 ret = lbfileUnmap(xFile->cache, xFile->mapSize);
+
+   xFile->cache = null;
+   xFile->cacheInitialSize = xFile->cacheIni = xFile->cacheEnd = xFile->mapSize = 0;
+   xFile->cacheIsDirty = false;
+   return ret;
+}
+
+// juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 /**
  * Opens a disk file to store tables and put it in the files list.
  *
@@ -501,7 +1406,8 @@ int32 openFile(Context context, XFile* xFile, int32 mode)
          if (list[ret]->timeStamp < minStamp)
             minStamp = list[oldest = ret]->timeStamp;
 
-      if ((file = list[oldest])->cacheIsDirty && !(ret = flushCache(context, file)))
+      // A file written through a write-ahead log keeps its cache, which is flushed into the log by the thread of its connection.
+      if ((file = list[oldest])->cacheIsDirty && !file->wal && !(ret = flushCache(context, file)))
       {
          UNLOCKVAR(files);
          return 1;
@@ -51,7 +51,8 @@ bool nfReadBytes(Context context, XFile* xFile, uint8* buffer, int32 count);
 bool nfWriteBytes(Context context, XFile* xFile, uint8* buffer, int32 count);
 
 /**
- * Enlarges the file. This function MUST be called to grow the file.
+ * Enlarges the file. This function MUST be called to grow the file. If the file is written through a write-ahead log, only its size is changed; 
+ * the file on disk grows when the transaction is committed.
  *
  * @param context The thread context where the function is being executed.
  * @param xFile A pointer to the normal file structure.
@@ -61,6 +62,18 @@ bool nfWriteBytes(Context context, XFile* xFile, uint8* buffer, int32 count);
  */
 bool nfGrowTo(Context context, XFile* xFile, uint32 newSize);
 
+/**
+ * Changes the size of the file on disk.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @param oldSize The current size of the file on disk.
+ * @param newSize The new size for the file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to grow the file.
+ */
+bool nfResize(Context context, XFile* xFile, uint32 oldSize, uint32 newSize);
+
 /**
  * Sets the current file position.
  *
@@ -103,7 +116,9 @@ bool nfClose(Context context, XFile* xFile);
 bool nfRemove(Context context, XFile* xFile, TCHARP sourcePath);
 
 /**
- * The cache must be refreshed if what is desired is not inside it.
+ * The cache must be refreshed if what is desired is not inside it. If the file is written through a write-ahead log, the part of the file not yet
+ * on disk is read as zeros and the bytes written by the current transaction are placed over the bytes read. A mapped file is all inside its 
+ * cache, so it only gets here when the bytes are past its end, and it is enlarged as if the bytes were flushed there.
  *
  * @param context The thread context where the function is being executed.
  * @param xFile A pointer to the normal file structure.
@@ -115,7 +130,8 @@ bool nfRemove(Context context, XFile* xFile, TCHARP sourcePath);
 bool refreshCache(Context context, XFile* xFile, int32 count);
 
 /**
- * Flushs the cache into the disk.
+ * Flushs the cache into the disk. If the file is written through a write-ahead log, the cache is flushed into the log. If the file is mapped, its
+ * changed pages are synced to the disk.
  *
  * @param context The thread context where the function is being executed.
  * @param xFile A pointer to the normal file structure.
@@ -134,8 +150,212 @@ bool flushCache(Context context, XFile* xFile);
  */
 void fileError(Context context, int32 errorCode, CharP fileName);
 
-// juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
+/**
+ * Creates the write-ahead log of a connection and puts it in the list of logs, so that its commits can be synced together with the commits of the 
+ * other connections.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param name The name of the log file.
+ * @param sourcePath The path where the log file will be created.
+ * @return The log or <code>null</code> if an error occurs.
+ * @throws DriverException If the log file can't be created.
+ * @throws OutOfMemoryError If there is not enough memory to create the log.
+ */
+Wal* walCreate(Context context, CharP name, TCHARP sourcePath);
+
+/**
+ * Closes the write-ahead log of a connection and removes its file. The log must have already been committed and checkpointed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to remove the log file.
+ */
+bool walClose(Context context, Wal* wal);
+
+/**
+ * Starts writing a file through a write-ahead log. A mapped file is unmapped, since its changes can't reach the file before being committed.
+ *
+ * @param wal The log.
+ * @param xFile A pointer to the normal file structure.
+ */
+void walAttach(Wal* wal, XFile* xFile);
+
+/**
+ * Stops writing a file through its write-ahead log. The bytes written by the current transaction are copied into the file without waiting for its
+ * commit, and the file is synced if the log still has committed bytes of the file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the file.
+ */
+bool walDetach(Context context, XFile* xFile);
+
+/**
+ * Appends bytes to the write-ahead log. They are part of the current transaction until the next commit.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @param buffer The bytes to be appended.
+ * @param length The number of bytes to be appended.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the log.
+ */
+bool walAppend(Context context, Wal* wal, uint8* buffer, int32 length);
+
+/**
+ * Writes bytes of a file into its write-ahead log. The bytes are kept in memory until the transaction is committed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @param offset The position of the bytes in the file.
+ * @param data The bytes written.
+ * @param length The number of bytes written.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the log.
+ * @throws OutOfMemoryError If there is not enough memory to keep the bytes written.
+ */
+bool walWrite(Context context, XFile* xFile, int32 offset, uint8* data, int32 length);
+
+/**
+ * Keeps the bytes written by the current transaction into a file. A sequential write is appended to the last range of bytes written and a rewrite
+ * of a range is done in place, so that the number of ranges is kept small. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @param offset The position of the bytes in the file.
+ * @param data The bytes written.
+ * @param length The number of bytes written.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enough memory to keep the bytes written.
+ */
+bool walAddExtent(Context context, XFile* xFile, int32 offset, uint8* data, int32 length);
+
+/**
+ * Places the bytes written by the current transaction over the bytes of the file read into the cache.
+ *
+ * @param xFile A pointer to the normal file structure.
+ * @param position The position of the file read into the cache.
+ * @param length The number of bytes read into the cache.
+ */
+void walReadExtents(XFile* xFile, int32 position, int32 length);
+
+/**
+ * Copies the bytes written by a committed transaction into the file and frees them. The file on disk also gets the size given to the file by the
+ * transaction.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the file.
+ */
+bool walApply(Context context, XFile* xFile);
+
+/**
+ * Discards the current transaction of a write-ahead log. The bytes written by it are freed without being copied into the files, which get back the 
+ * sizes they have on disk. The records of the transaction in the log have no commit record, so they are never recovered.
+ *
+ * @param wal The log.
+ */
+void walDiscard(Wal* wal);
+
+/**
+ * Commits the current transaction of a write-ahead log. The dirty caches and the new sizes of the files are written into the log, which is synced
+ * with the logs of the other connections that are also committing. Only then the bytes written by the transaction are copied into the files. The log
+ * is checkpointed if it became too big.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to the log or to the files.
+ * @throws OutOfMemoryError If there is not enough memory to keep the bytes written.
+ */
+bool walCommit(Context context, Wal* wal);
+
+/**
+ * Syncs the log to the disk after a commit. If another connection is already syncing, waits for it and then syncs the logs of all the connections
+ * that committed meanwhile, so that concurrent commits share a single sync of each log. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to sync the log.
+ */
+bool walSync(Context context, Wal* wal);
+
+/**
+ * Checkpoints a write-ahead log: syncs its files, whose bytes were already copied from the log, and empties it.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param wal The log.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to sync the files or to empty the log.
+ */
+bool walCheckpoint(Context context, Wal* wal);
+
+/**
+ * Recovers the tables of the logs left by connections that were not closed, which happens if the application stops suddenly. The committed 
+ * transactions of each log are copied into the tables and the log is removed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param prefix The prefix of the names of the logs of the connection creator id.
+ * @param sourcePath The path where the tables are stored.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to read a log or to write to a table file.
+ * @throws OutOfMemoryError If there is not enough memory to read a log.
+ */
+bool walRecover(Context context, CharP prefix, TCHARP sourcePath);
+
+/**
+ * Copies the committed transactions of a log into the table files. A transaction whose records are incomplete or whose crc32 does not match was not
+ * committed and ends the recovery.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param name The name of the log file.
+ * @param fullPath The full path of the log file.
+ * @param sourcePath The path where the tables are stored.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to read the log or to write to a table file.
+ * @throws OutOfMemoryError If there is not enough memory to read the log.
+ */
+bool walReplay(Context context, CharP name, TCHARP fullPath, TCHARP sourcePath);
+
+/**
+ * Copies the records of a committed transaction into the table files.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param records The records of the transaction, without its commit record.
+ * @param length The length of the records.
+ * @param sourcePath The path where the tables are stored.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to write to a table file.
+ */
+bool walReplayTransaction(Context context, uint8* records, int32 length, TCHARP sourcePath);
+
 #if defined(POSIX) || defined(ANDROID)
+/**
+ * Maps a file into memory, so that the mapping is used as its cache and a read of a part of the file not read before does not need a system call.
+ * The mapping is larger than the file so that it can grow without being mapped again. A file written through a write-ahead log is not mapped, as 
+ * well as the file if it can't be mapped, which keeps using a cache window.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile A pointer to the normal file structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to flush the cache.
+ */
+bool nfMap(Context context, XFile* xFile);
+
+/**
+ * Unmaps a mapped file, which goes back to be read through a cache window. Its changed bytes are already in the file, but they are only synced to 
+ * the disk if its cache was flushed before.
+ *
+ * @param xFile A pointer to the normal file structure.
+ * @return The error code if an error occurred or zero if the function succeeds.
+ */
+int32 nfUnmap(XFile* xFile);
+
+// juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 /**
  * Opens a disk file to store tables and put it in the files list.
  *
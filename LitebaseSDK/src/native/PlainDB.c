@@ -99,9 +99,13 @@ bool plainAdd(Context context, PlainDB* plainDB)
 
    if (--plainDB->rowAvail <= 0) // Checks if there are no more space pre-allocated.
    {
-      if (!plainDB->growTo(context, &plainDB->db, (plainDB->rowCount + plainDB->rowInc) * plainDB->rowSize + plainDB->headerSize))
+      // A file written through a write-ahead log grows one row at a time, which only changes its logical size. Otherwise, the rows pre-allocated
+      // by a committed transaction would be counted as table rows after a recovery.
+      int32 rowInc = plainDB->db.wal? 1 : plainDB->rowInc;
+
+      if (!plainDB->growTo(context, &plainDB->db, (plainDB->rowCount + rowInc) * plainDB->rowSize + plainDB->headerSize))
          return false;
-      plainDB->rowAvail = plainDB->rowInc;
+      plainDB->rowAvail = rowInc;
    }
    return plainSetPos(context, plainDB, plainDB->rowCount); // Sets the position to the start of the record.
 }
@@ -18,6 +18,72 @@
  */
 void freePreparedStatement(int32 unused, TCObject statement);
 
+/**
+ * Parses and binds the statement of a prepared statement of a delete, insert, select, or update command. The statement is kept by the prepared 
+ * statement, which is also added to the list of prepared statements of its tables.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param prepStmt The prepared statement.
+ * @param sqlChars The sql string.
+ * @param sqlLength The sql string length.
+ * @param isSelect Indicates if the sql command is a select.
+ * @return The heap of the statement or <code>null</code> if the command does not create a statement or an error occurs.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+Heap bindPreparedStatement(Context context, TCObject driver, TCObject prepStmt, JCharP sqlChars, int32 sqlLength, bool isSelect);
+
+/**
+ * Executes the select of a prepared statement whose parameters are all defined.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param statement The prepared statement.
+ * @return The result set of the select or <code>null</code> if an error occurs.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+TCObject psExecuteQuery(Context context, TCObject statement);
+
+/**
+ * Executes the insert, update, or delete of a prepared statement and commits it if there is no explicit transaction.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param statement The prepared statement.
+ * @return The number of rows affected or <code>-1</code> if an error occurs.
+ * @throws DriverException If there are undefined parameters.
+ */
+int32 psExecuteUpdate(Context context, TCObject statement);
+
+/**
+ * Gets a statement of a connection from its statement cache, where the deletes, inserts, selects, and updates executed without being prepared are 
+ * kept parsed and bound. If it is not there, it is parsed, bound, and stored in the cache as its most recently used statement, freeing the least 
+ * recently used one if the cache is full. Commands with parameters or which do not create statements are not cached.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param sqlChars The sql string.
+ * @param sqlLength The sql string length.
+ * @param isSelect Indicates if the sql command must be a select or an insert, update, or delete.
+ * @return The prepared statement of the sql command or <code>null</code> if it can't be cached or an error occurs.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+TCObject getCachedStatement(Context context, TCObject driver, JCharP sqlChars, int32 sqlLength, bool isSelect);
+
+/**
+ * Removes a prepared statement from the statement cache of its connection, if it is there. It must be called when the statement is freed because 
+ * one of its tables was closed. 
+ *
+ * @param statement The prepared statement.
+ */
+void removeCachedStatement(TCObject statement);
+
+/**
+ * Frees the statements of the statement cache of a connection. It must be called before the tables of the connection are changed by a command
+ * which does not create a statement, since the cached statements are bound to them.
+ *
+ * @param driver The connection with Litebase.
+ */
+void clearStatementCache(TCObject driver);
+
 /**
  * Sets numeric parameters in a prepared statement.
  *
@@ -48,6 +48,7 @@ void initTCVMLib()
    TC_debug = GETPROCADDRESS(debug);
    TC_double2str = GETPROCADDRESS(double2str);
    TC_executeMethod = GETPROCADDRESS(executeMethod);
+   TC_gcWriteBarrier = GETPROCADDRESS(gcWriteBarrier);
    TC_getApplicationId = GETPROCADDRESS(getApplicationId);
    TC_getAppPath = GETPROCADDRESS(getAppPath);
    //TC_getDataPath = GETPROCADDRESS(getDataPath);
@@ -80,6 +81,7 @@ void initTCVMLib()
    TC_privateXfree = GETPROCADDRESS(privateXfree);
    TC_privateXmalloc = GETPROCADDRESS(privateXmalloc);
    TC_privateXrealloc = GETPROCADDRESS(privateXrealloc);
+   TC_runPoolJobs = GETPROCADDRESS(runPoolJobs);
    TC_setObjectLock = GETPROCADDRESS(setObjectLock);
    TC_str2double = GETPROCADDRESS(str2double);
    TC_str2int = GETPROCADDRESS(str2int);
@@ -130,6 +132,7 @@ TESTCASE(initTCVMLib)
    ASSERT1_EQUALS(NotNull, TC_debug);
    ASSERT1_EQUALS(NotNull, TC_double2str);
    ASSERT1_EQUALS(NotNull, TC_executeMethod);
+   ASSERT1_EQUALS(NotNull, TC_gcWriteBarrier);
 	ASSERT1_EQUALS(NotNull, TC_getApplicationId);
    ASSERT1_EQUALS(NotNull, TC_getAppPath);
    ASSERT1_EQUALS(NotNull, TC_getDataPath);
@@ -162,6 +165,7 @@ TESTCASE(initTCVMLib)
    ASSERT1_EQUALS(NotNull, TC_privateXfree);
    ASSERT1_EQUALS(NotNull, TC_privateXmalloc);
    ASSERT1_EQUALS(NotNull, TC_privateXrealloc);
+   ASSERT1_EQUALS(NotNull, TC_runPoolJobs);
    ASSERT1_EQUALS(NotNull, TC_setObjectLock);
    ASSERT1_EQUALS(NotNull, TC_str2double);
    ASSERT1_EQUALS(NotNull, TC_str2int);
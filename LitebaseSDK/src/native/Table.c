@@ -106,6 +106,33 @@ bool driverDropIndex(Context context, Table* table, int32 column)
    return tableSaveMetaData(context, table, TSMD_ATLEAST_INDEXES); // guich@560_24
 }
 
+/**
+ * Drops a trigram index.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table whose index is to dropped.
+ * @param column The column of the index dropped.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If the column does not have a trigram index. 
+ */
+bool driverDropTrigramIndex(Context context, Table* table, int32 column)
+{
+   TRACE("driverDropTrigramIndex")
+   Index* index = table->columnTrigrams? table->columnTrigrams[column] : null;
+
+   if (!index) // Column does not have a trigram index.
+   {
+		TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_COLUMN_DOESNOT_HAVE_AN_INDEX), table->columnNames[column]);
+      return false;
+   }
+
+   if (!indexRemove(context, index)) // Deletes the index of this table.
+      return false;
+   table->columnTrigrams[column] = null; // Already freed.
+   table->columnAttrs[column] &= ~ATTR_COLUMN_HAS_TRIGRAM; 
+   return tableSaveMetaData(context, table, TSMD_ATLEAST_INDEXES);
+}
+
 /**
  * Drops a composed index.
  *
@@ -192,11 +219,13 @@ int32 deleteAllIndexes(Context context, Table* table)
          primaryKey = table->primaryKeyCol;
    bool ret = true;
    Index** columnIndexes = table->columnIndexes;
+   Index** columnTrigrams = table->columnTrigrams;
    uint8* columnAttrs = table->columnAttrs;
    ComposedIndex** composedIndexes = table->composedIndexes;
 
    // Unique index.
    while (--i >= 0)
+   {
       if (i != primaryKey && columnIndexes[i])  
       {
          ret &= indexRemove(context, columnIndexes[i]); 
@@ -204,6 +233,14 @@ int32 deleteAllIndexes(Context context, Table* table)
          columnAttrs[i] &= ATTR_COLUMN_HAS_NO_INDEX;
          count++;
       }
+      if (columnTrigrams && columnTrigrams[i]) // Trigram index.
+      {
+         ret &= indexRemove(context, columnTrigrams[i]); 
+         columnTrigrams[i] = null;
+         columnAttrs[i] &= ~ATTR_COLUMN_HAS_TRIGRAM;
+         count++;
+      }
+   }
 
 	// juliana@201_33: When all indices are dropped by the user, the composed primary key can't be deleted.
    i = table->numberComposedIndexes;
@@ -667,6 +704,56 @@ bool tableLoadMetaData(Context context, Table* table, bool throwException) // ju
    if ((columnCount = table->numberComposedPKCols = *ptr++) > 0) // Number of the composed primary key.
       xmemmove(table->composedPrimaryKeyCols = (uint8*)TC_heapAlloc(heap, columnCount), ptr, columnCount);
    
+   // Reads the statistics gathered by ANALYZE, if any.
+   ptr += columnCount;
+   readStatistics(table, ptr, plainDB->headerSize - (int32)(ptr - metadata));
+
+   indexName[nameLength] = '$';
+   indexName[nameLength + 1] = TRIGRAM_INDEX_PREFIX;
+   i = table->columnCount;
+   while (--i >= 0) // Loads the trigram indices.
+   { 
+      if ((columnAttrs[i] & ATTR_COLUMN_HAS_TRIGRAM))
+      {
+         idxHeap = heapCreate();
+         IF_HEAP_ERROR(idxHeap)
+         {
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+            heapDestroy(idxHeap);
+            if (table->columnTrigrams)
+               table->columnTrigrams[i] = null;
+            goto error;
+         }
+         
+         TC_CharP2TCHARPBuf(TC_int2str(i, intBuf), &indexName[nameLength + 2]);
+         tcscat(indexName, TEXT(IDK_EXT));
+
+         // As with the simple indices, the index of a table not closed properly is emptied and rebuilt by recoverTable().
+         if ((exist = lbfileExists(indexName)) && !flags)
+         {     
+            if ((exist = lbfileCreate(&idxFile, indexName, READ_WRITE))
+             || (exist = lbfileSetSize(&idxFile, 0)) || (exist = lbfileClose(&idxFile)))
+            {
+               char buffer[1024];
+               TC_TCHARP2CharPBuf(indexName, buffer);
+               fileError(context, exist, buffer);
+               heapDestroy(idxHeap);
+               goto error;
+            }
+            exist = false;
+         }
+
+         if (!indexCreateTrigramIndex(context, table, tableName, i, exist, idxHeap)
+          || (!exist && flags && (!tableReIndexTrigrams(context, table, i) || !setModified(context, table))))
+         {
+            heapDestroy(idxHeap);
+            if (table->columnTrigrams)
+               table->columnTrigrams[i] = null;
+            goto error;
+         }
+      }
+   }
+   
    if (plainDB->headerSize != DEFAULT_HEADER)
 	   xfree(metadata);
 	return true;
@@ -708,7 +795,7 @@ bool tableSaveMetaData(Context context, Table* table, int32 saveType)
    size = getTSMDSize(table, saveType);
    if (saveType == TSMD_EVERYTHING)
       size += getStringsTotalSize(table->columnNames, table->columnCount) + computeDefaultValuesMetadataSize(table) 
-           + computeComposedIndicesTotalSize(table);
+           + computeComposedIndicesTotalSize(table) + computeStatisticsSize(table);
       
    // Tries to use a static buffer if possible.
    if (size <= SECTOR_SIZE)
@@ -823,6 +910,9 @@ bool tableSaveMetaData(Context context, Table* table, int32 saveType)
                n = *ptr++ = table->numberComposedPKCols; // Number of columns on composed primary key. If 0, there's no composed primary key.
                xmemmove(ptr, table->composedPrimaryKeyCols, n); // Stores the composed primary key.
                ptr += n;
+
+               // Stores the statistics in the space left in the header, which can't grow anymore if the table has rows.
+               ptr = writeStatistics(table, ptr, plainDB->db.size? plainDB->headerSize - (int32)(ptr - ptr0) : 0);
             }
          }
       }
@@ -1006,6 +1096,435 @@ int32 computeComposedIndicesTotalSize(Table* table)
    return size;
 }
 
+/**
+ * Gets the size needed to store the statistics of a table with all the buckets of their histograms.
+ *
+ * @param table The table.
+ * @return The size of the statistics or zero if the table was not analyzed.
+ */
+int32 computeStatisticsSize(Table* table)
+{
+   TRACE("computeStatisticsSize")
+   ColumnStatistics* statistics = table->columnStatistics;
+   int32 i = table->columnCount,
+         size = 8 + 9 * i; // The marker + the row count + distinct count, null count, and number of buckets of each column.
+
+   if (!table->analyzedRowCount)
+      return 0;
+   while (--i >= 0)
+      if (statistics[i].bucketsCount)
+         size += (statistics[i].bucketsCount + 1) << 3; // The bounds of the histogram.
+   return size;
+}
+
+/**
+ * Writes the statistics of a table after its meta data. The header of .db can't grow after the table is created, so the histograms have their 
+ * buckets halved until the statistics fit in the space left. If not even the column counts fit, the statistics are not saved.
+ *
+ * @param table The table.
+ * @param ptr The position of the meta data buffer where the statistics are to be written.
+ * @param available The space left in the header.
+ * @return The position after the statistics.
+ */
+uint8* writeStatistics(Table* table, uint8* ptr, int32 available)
+{
+   TRACE("writeStatistics")
+   ColumnStatistics* statistics = table->columnStatistics;
+   int32 columnCount = table->columnCount,
+         size = 8 + 9 * columnCount,
+         histograms = 0,
+         buckets = STATISTICS_BUCKETS,
+         marker = STATISTICS_MARKER,
+         i = columnCount,
+         count,
+         j;
+
+   if (!table->analyzedRowCount || size > available)
+      return ptr;
+   while (--i >= 0)
+      if (statistics[i].bucketsCount)
+         histograms++;
+   while (buckets && size + histograms * ((buckets + 1) << 3) > available)
+      buckets >>= 1;
+
+   xmove4(ptr, &marker);
+   xmove4(ptr + 4, &table->analyzedRowCount);
+   ptr += 8;
+   i = -1;
+   while (++i < columnCount)
+   {
+      xmove4(ptr, &statistics[i].distinctCount);
+      xmove4(ptr + 4, &statistics[i].nullCount);
+      ptr[8] = count = MIN(statistics[i].bucketsCount, buckets);
+      ptr += 9;
+      
+      // A smaller histogram keeps evenly spaced bounds of the full one.
+      j = -1;
+      while (count && ++j <= count)
+      {
+         READ_DOUBLE(ptr, (uint8*)&statistics[i].bounds[j * statistics[i].bucketsCount / count]);
+         ptr += 8;
+      }
+   }
+   return ptr;
+}
+
+/**
+ * Reads the statistics of a table stored after its meta data, if there are any.
+ *
+ * @param table The table.
+ * @param ptr The position of the meta data buffer after the meta data.
+ * @param available The space left in the header.
+ */
+void readStatistics(Table* table, uint8* ptr, int32 available)
+{
+   TRACE("readStatistics")
+   ColumnStatistics* statistics;
+   int32 columnCount = table->columnCount,
+         marker = 0,
+         rowCount,
+         buckets,
+         i = -1,
+         j;
+   uint8* end = ptr + available;
+
+   if (available < 8 + 9 * columnCount)
+      return;
+   xmove4(&marker, ptr);
+   if (marker != STATISTICS_MARKER)
+      return;
+   xmove4(&rowCount, ptr + 4);
+   ptr += 8;
+   
+   statistics = table->columnStatistics = (ColumnStatistics*)TC_heapAlloc(table->heap, columnCount * sizeof(ColumnStatistics));
+   while (++i < columnCount)
+   {
+      if (ptr + 9 > end)
+         return;
+      xmove4(&statistics[i].distinctCount, ptr);
+      xmove4(&statistics[i].nullCount, ptr + 4);
+      buckets = ptr[8];
+      ptr += 9;
+      if (buckets)
+      {
+         if (buckets > STATISTICS_BUCKETS || ptr + ((buckets + 1) << 3) > end) // Corrupted statistics are ignored.
+            return;
+         statistics[i].bounds = (double*)TC_heapAlloc(table->heap, (STATISTICS_BUCKETS + 1) << 3);
+         statistics[i].bucketsCount = buckets;
+         j = -1;
+         while (++j <= buckets)
+         {
+            READ_DOUBLE((uint8*)&statistics[i].bounds[j], ptr);
+            ptr += 8;
+         }
+      }
+   }
+   table->analyzedRowCount = rowCount;
+}
+
+/**
+ * Gathers the statistics of a table and stores them in its header. A sample of evenly spaced rows is read. The number of distinct values of each 
+ * column is estimated from the sample by the Duj1 estimator, and the numeric, date, and datetime columns also get an equi-depth histogram.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+bool tableAnalyze(Context context, Table* table)
+{
+   TRACE("tableAnalyze")
+   PlainDB* plainDB = &table->db;
+   uint8* basbuf = plainDB->basbuf;
+   uint8* columnNulls = table->columnNulls;
+   uint16* columnOffsets = table->columnOffsets;
+   int8* columnTypes = table->columnTypes;
+   int32* columnSizes = table->columnSizes;
+   int32 columnCount = table->columnCount,
+         rowCount = plainDB->rowCount,
+         liveCount = rowCount - table->deletedRowsCount,
+         sampleCount = MIN(rowCount, STATISTICS_SAMPLE),
+         sampled = 0,
+         maxSize = 0,
+         nulls[MAXIMUMS + 1],
+         keysCount[MAXIMUMS + 1],
+         distinct,
+         once,
+         type,
+         i,
+         j,
+         k;
+   double* keys = null;
+   double* columnKeys;
+   ColumnStatistics* statistics;
+   SQLValue value;
+   bool ret = false;
+   Heap heap = heapCreate();
+
+   IF_HEAP_ERROR(heap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto finish;
+   }
+   if (liveCount <= 0) // An empty table has no statistics.
+   {
+      ret = true;
+      goto finish;
+   }
+   
+   i = columnCount;
+   while (--i >= 0)
+      if (columnTypes[i] == CHARS_TYPE || columnTypes[i] == CHARS_NOCASE_TYPE)
+         maxSize = MAX(maxSize, columnSizes[i]);
+   xmemzero(&value, sizeof(SQLValue));
+   value.asChars = (JCharP)TC_heapAlloc(heap, (maxSize << 1) + 2);
+   if (!(keys = (double*)xmalloc(columnCount * sampleCount * sizeof(double))))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto finish;
+   }
+   xmemzero(nulls, sizeof(nulls));
+   xmemzero(keysCount, sizeof(keysCount));
+
+   k = -1;
+   while (++k < sampleCount) // Reads the sample.
+   {
+      if (!plainRead(context, plainDB, (int32)((int64)k * rowCount / sampleCount)))
+         goto finish;
+      if (!recordNotDeleted(basbuf))
+         continue;
+      sampled++;
+      xmemmove(columnNulls, basbuf + columnOffsets[columnCount], NUMBEROFBYTES(columnCount));
+      
+      i = -1;
+      while (++i < columnCount)
+      {
+         if ((type = columnTypes[i]) == BLOB_TYPE)
+            continue;
+         if (isBitSet(columnNulls, i))
+         {
+            nulls[i]++;
+            continue;
+         }
+         if (!readValue(context, plainDB, &value, columnOffsets[i], type, basbuf, false, false, false, columnSizes[i], heap))
+            goto finish;
+         keys[i * sampleCount + keysCount[i]++] = statisticsKey(&value, type);
+      }
+   }
+   if (!sampled)
+   {
+      ret = true;
+      goto finish;
+   }
+
+   if (!(statistics = table->columnStatistics))
+      statistics = table->columnStatistics = (ColumnStatistics*)TC_heapAlloc(table->heap, columnCount * sizeof(ColumnStatistics));
+   i = -1;
+   while (++i < columnCount)
+   {
+      int32 count = keysCount[i];
+      
+      columnKeys = &keys[i * sampleCount];
+      statistics[i].nullCount = (int32)((double)nulls[i] * liveCount / sampled);
+      statistics[i].distinctCount = statistics[i].bucketsCount = 0;
+      if (!count)
+         continue;
+      
+      sortStatisticsKeys(columnKeys, count);
+      distinct = once = 0;
+      j = 0;
+      while (j < count) // Counts the distinct values and the ones that appear only once in the sample.
+      {
+         k = j;
+         while (++j < count && columnKeys[j] == columnKeys[k]);
+         distinct++;
+         if (j - k == 1)
+            once++;
+      }
+      
+      if (sampleCount == rowCount) // The whole table was read.
+         statistics[i].distinctCount = distinct;
+      else
+      {
+         double total = MAX(liveCount - statistics[i].nullCount, count),
+                estimate = count * (double)distinct / (count - once + once * count / total);
+         statistics[i].distinctCount = (int32)MAX(distinct, MIN(estimate, total));
+      }
+      
+      if ((type = columnTypes[i]) != CHARS_TYPE && type != CHARS_NOCASE_TYPE) // The hashes of the strings have no order.
+      {
+         int32 buckets = MAX(1, MIN(STATISTICS_BUCKETS, count - 1));
+         
+         if (!statistics[i].bounds)
+            statistics[i].bounds = (double*)TC_heapAlloc(table->heap, (STATISTICS_BUCKETS + 1) << 3);
+         statistics[i].bucketsCount = buckets;
+         j = -1;
+         while (++j <= buckets)
+            statistics[i].bounds[j] = columnKeys[(int32)((int64)j * (count - 1) / buckets)];
+      }
+   }
+   table->analyzedRowCount = liveCount;
+   ret = tableSaveMetaData(context, table, TSMD_EVERYTHING);
+   
+finish:
+   xfree(keys);
+   heapDestroy(heap);
+   return ret;
+}
+
+/**
+ * Gets the value of a column as a number used in its statistics. Numbers, dates, and datetimes keep their order. Strings are hashed, which only 
+ * allows counting their distinct values.
+ *
+ * @param value The value, which can't be null.
+ * @param type The type of the column.
+ * @return The key of the value.
+ */
+double statisticsKey(SQLValue* value, int32 type)
+{
+   TRACE("statisticsKey")
+   switch (type)
+   {
+      case SHORT_TYPE:
+         return value->asShort;
+      case INT_TYPE:
+      case DATE_TYPE:
+         return value->asInt;
+      case LONG_TYPE:
+         return (double)value->asLong;
+      case FLOAT_TYPE:
+         return value->asFloat;
+      case DOUBLE_TYPE:
+         return value->asDouble;
+      case DATETIME_TYPE:
+         return value->asDate * 1000000000.0 + value->asTime;
+      default:
+         return joinKeyHash(value, type, type == CHARS_NOCASE_TYPE);
+   }
+}
+
+/**
+ * Sorts the keys of a column in the sample of its table.
+ *
+ * @param keys The keys.
+ * @param count The number of keys.
+ */
+void sortStatisticsKeys(double* keys, int32 count)
+{
+   TRACE("sortStatisticsKeys")
+   int32 stack[64],
+         size = 0,
+         low,
+         high,
+         i,
+         j;
+   double pivot,
+          key;
+
+   if (count < 2)
+      return;
+   stack[size++] = 0;
+   stack[size++] = count - 1;
+   while (size)
+   {
+      high = stack[--size];
+      low = stack[--size];
+      while (low < high)
+      {
+         pivot = keys[(low + high) >> 1];
+         i = low;
+         j = high;
+         while (i <= j)
+         {
+            while (keys[i] < pivot)
+               i++;
+            while (keys[j] > pivot)
+               j--;
+            if (i <= j)
+            {
+               key = keys[i];
+               keys[i++] = keys[j];
+               keys[j--] = key;
+            }
+         }
+
+         // Stacks the larger partition and goes on with the smaller one so that the stack never has more than 31 partitions.
+         if (j - low < high - i)
+         {
+            if (i < high)
+            {
+               stack[size++] = i;
+               stack[size++] = high;
+            }
+            high = j;
+         }
+         else
+         {
+            if (low < j)
+            {
+               stack[size++] = low;
+               stack[size++] = j;
+            }
+            low = i;
+         }
+      }
+   }
+}
+
+/**
+ * Estimates the fraction of the rows of an analyzed table which satisfies a comparison between one of its columns and a constant. The equalities 
+ * use the number of distinct values of the column and the other comparisons with a known value interpolate it in the histogram of the column.
+ *
+ * @param table The table, which must have been analyzed.
+ * @param column The column.
+ * @param operator The comparison, which can be a relational operator, <code>IS</code>, or <code>IS NOT</code>.
+ * @param value The constant as a statistics key, or <code>null</code> if it is unknown.
+ * @return The estimated selectivity, from 0 to 1.
+ */
+double columnSelectivity(Table* table, int32 column, int32 operator, double* value)
+{
+   TRACE("columnSelectivity")
+   ColumnStatistics* statistics = &table->columnStatistics[column];
+   double nulls = MIN(1.0, (double)statistics->nullCount / table->analyzedRowCount),
+          equal = statistics->distinctCount? (1 - nulls) / statistics->distinctCount : DEFAULT_EQUAL_SELECTIVITY,
+          below;
+   double* bounds = statistics->bounds;
+   int32 buckets = statistics->bucketsCount,
+         i = 0;
+
+   switch (operator)
+   {
+      case OP_REL_EQUAL:
+         return equal;
+      case OP_REL_DIFF:
+         return MAX(0, 1 - nulls - equal);
+      case OP_PAT_IS:
+         return nulls;
+      case OP_PAT_IS_NOT:
+         return 1 - nulls;
+      case OP_REL_GREATER:
+      case OP_REL_GREATER_EQUAL:
+      case OP_REL_LESS:
+      case OP_REL_LESS_EQUAL:
+         if (!value || !buckets)
+            return DEFAULT_RANGE_SELECTIVITY;
+         
+         // Finds the fraction of the rows below the value, assuming that the values are uniformly distributed inside each bucket.
+         if (*value <= bounds[0])
+            below = 0;
+         else if (*value >= bounds[buckets])
+            below = 1;
+         else
+         {
+            while (*value > bounds[i + 1])
+               i++;
+            below = (i + (*value - bounds[i]) / (bounds[i + 1] - bounds[i])) / buckets;
+         }
+         return (1 - nulls) * ((operator == OP_REL_LESS || operator == OP_REL_LESS_EQUAL)? below : 1 - below);
+   }
+   return DEFAULT_RANGE_SELECTIVITY;
+}
+
 /**
  * Reorder the values of a statement to match the table definition.
  *
@@ -1065,173 +1584,575 @@ bool reorder(Context context, Table* table, CharP* fields, SQLValue** record, ui
 
 // juliana@220_3
 /**
- * Sorts a table, using an ORDER BY or GROUP BY clause.
+ * Sorts a table, using an ORDER BY or GROUP BY clause. A binary key is built for each row, so that the keys compared byte by byte have the order of
+ * the rows. The keys are sorted in memory in runs which are merged on disk if they don't fit in the sort memory budget. The rows are then moved to 
+ * their sorted positions.
  * 
  * @param context The thread context where the function is being executed.
  * @param table The table.
  * @param groupByClause The group by clause.
  * @param orderByClause The order by clause.
  * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
- * @throws OutOfMemoryError If a heap memory allocation fails. 
+ * @throws OutOfMemoryError If a memory allocation fails. 
+ * @throws DriverException If the runs file can't be created, read, or written.
  */
 bool sortTable(Context context, Table* table, SQLColumnListClause* groupByClause, SQLColumnListClause* orderByClause)
 {
 	TRACE("sortTable")
-   PlainDB* plainDB = &table->db;
-   int32 count = table->columnCount,
-         totalRecords = plainDB->rowCount;
    SQLColumnListClause* sortListClause;
-   uint8* bufAux; 
-   Heap heap = heapCreate();
+   SQLResultSetField** fieldList;
+   SQLResultSetField* field;
+   SQLValue value;
+   XFile runs;
+   char name[DBNAME_SIZE];
+   int32 sizes[MAXIMUMS + 1];
+   int32 rowCount = table->db.rowCount,
+         fieldsCount,
+         keySize = 4,
+         maxSize = 0,
+         capacity,
+         runCount = 0,
+         length = 0,
+         total = 0,
+         row = -1,
+         i;
+   uint8* keys = null;
+   uint8** pointers = null;
+   uint8** merged = null;
+   uint8** sorted;
+   int32* order = null;
+   int32* runEnds = null;
+   bool ret = false;
 
-   IF_HEAP_ERROR(heap)
+   // Binds the sort lists to the temp table columns.
+   if ((orderByClause && !bindColumnsSQLColumnListClause(context, orderByClause, &table->htName2index, table->columnTypes, null, 0))
+    || (groupByClause && !bindColumnsSQLColumnListClause(context, groupByClause, &table->htName2index, table->columnTypes, null, 0)))
+      return false;
+   if (rowCount < 2)
+      return true;
+  
+   // Picks one of the Column List clauses as the sort list.
+   // Each field of the key has a byte for its null followed by its value. Strings have all the characters of their columns and their lengths.
+   fieldList = (sortListClause = orderByClause? orderByClause : groupByClause)->fieldList;
+   i = fieldsCount = sortListClause->fieldsCount;
+   while (--i >= 0)
+   {
+      field = fieldList[i];
+      if (field->dataType == CHARS_TYPE || field->dataType == CHARS_NOCASE_TYPE)
+      {
+         // juliana@268_2: solved possible crash using order by when a string order by field does not appear in the select field.
+         sizes[i] = field->table->columnSizes[TC_htGet32(&field->table->htName2index, field->tableColHashCode)];
+         maxSize = MAX(maxSize, sizes[i]);
+         keySize += 3 + (sizes[i] << 1);
+      }
+      else
+      {
+         sizes[i] = 0;
+         keySize += 1 + typeSizes[field->dataType];
+      }
+   }
+   capacity = MIN(MAX(TABLE_RUN_KEYS, TABLE_SORT_BUDGET / (keySize + (TSIZE << 1))), rowCount);
+   
+   xmemzero(&runs, sizeof(XFile));
+   xmemzero(&value, sizeof(SQLValue));
+   if (!(keys = (uint8*)xmalloc(capacity * keySize)) || !(pointers = (uint8**)xmalloc(capacity * TSIZE)) 
+    || !(merged = (uint8**)xmalloc(capacity * TSIZE)) || !(order = (int32*)xmalloc(rowCount << 2)) || (maxSize && !(value.asChars = (JCharP)xmalloc((maxSize << 1) + 2))))
    {
       TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-      heapDestroy(heap);
-      return false;
+      goto finish;
    }
 
-   bufAux = TC_heapAlloc(heap, plainDB->rowSize); // juliana@114_8
+   if (rowCount > capacity) // More than one run is necessary.
+   {
+      xstrprintf(name, "%08X%s", (int32)(size_t)table, TSR_EXT); // A temporary table has no name.
+      if (!nfCreateFile(context, name, true, false, table->sourcePath, &runs, -1))
+         goto finish;
+      if (!(runEnds = (int32*)xmalloc((rowCount / capacity + 1) << 4)))
+      {
+         TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+         goto finish;
+      }
+   }
 
-   // Binds the sort lists to the temp table columns.
-   if ((orderByClause && !bindColumnsSQLColumnListClause(context, orderByClause, &table->htName2index, table->columnTypes, null, 0))
-    || (groupByClause && !bindColumnsSQLColumnListClause(context, groupByClause, &table->htName2index, table->columnTypes, null, 0)))
+   while (++row < rowCount) // Reads the keys, sorting and writing a run whenever the buffer is full.
    {
-      heapDestroy(heap);
-      return false;
+      if (!makeSortKey(context, table, fieldList, sizes, fieldsCount, &value, row, pointers[length] = &keys[length * keySize]))
+         goto finish;
+      if (++length == capacity && row < rowCount - 1)
+      {
+         sorted = sortTableRun(pointers, merged, length, keySize);
+         if (!writeSortKeys(context, &runs, sorted, length, keySize, total))
+            goto finish;
+         runEnds[runCount++] = total += length;
+         length = 0;
+      }
    }
-  
-   // Picks one of the Column List clauses as the sort list.
-   // Quick sorts the table.
-   // guich@223_16: corrected a bug that could crash the application on Windows 32 when the query has an order by or group by due to a compiler 
-   // error.
-   sortListClause = orderByClause? orderByClause : groupByClause;
-   return quickSort(context, table, newSQLValues(count, heap), newSQLValues(count, heap), newSQLValues(count, heap), sortListClause->fieldList, 
-                                                               bufAux, 0, totalRecords - 1, sortListClause->fieldsCount, heap);
+   sorted = sortTableRun(pointers, merged, length, keySize);
+
+   if (!runCount) // Only one run: the sorted keys already give the order of the rows.
+      while (--length >= 0)
+         order[length] = getSortKeyRow(sorted[length] + keySize - 4);
+   else
+   {
+      if (!writeSortKeys(context, &runs, sorted, length, keySize, total)) // The last run.
+         goto finish;
+      runEnds[runCount++] = total + length;
+      xfree(keys);
+      xfree(pointers);
+      xfree(merged);
+      if (!mergeSortRuns(context, &runs, runEnds, runCount, keySize, order))
+         goto finish;
+   }
+   ret = moveSortedRows(context, table, order);
+
+finish:
+   xfree(keys);
+   xfree(pointers);
+   xfree(merged);
+   xfree(order);
+   xfree(runEnds);
+   xfree(value.asChars);
+   if (runs.name[0] && !nfRemove(context, &runs, table->sourcePath))
+      ret = false;
+   return ret;
 }
 
-// juliana@250_1: corrected a possible crash when doing ordering operations.
-// juliana@220_3
-// juliana@227_20: corrected order by or group by with strings being too slow.
 /**
- * Quick sort method used to sort the table.
- * 
+ * Builds the sort key of a row of a table being sorted. The key ends with the row, so that no two keys are equal.
+ *
  * @param context The thread context where the function is being executed.
- * @param table The table.
- * @param pivot The pivot of this partition;
- * @param someRecord1 An auxiliar record to avoid re-creating it.
- * @param someRecord2 An auxiliar record to avoid re-creating it.
- * @param fieldList The order of comparison of the fields.
- * @param bufAux A buffer to store the records.
- * @param first The first index of this partition.
- * @param last The last index of this partition.
- * @param fieldsCount The number of fields in the field list.
- * @param heap A heap to allocate temporary sort structures.
+ * @param table The table being sorted.
+ * @param fieldList The fields of the sort.
+ * @param sizes The sizes of the string fields or 0 for the other fields.
+ * @param fieldsCount The number of fields of the sort.
+ * @param value A value to read the fields, whose string buffer can hold the largest string field.
+ * @param row The row.
+ * @param key The buffer where the key is built.
  * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
  */
-bool quickSort(Context context, Table* table, SQLValue** pivot, SQLValue** someRecord1, SQLValue** someRecord2, SQLResultSetField** fieldList, 
-                                                                uint8* bufAux, int32 first, int32 last, int32 fieldsCount, Heap heap)
+bool makeSortKey(Context context, Table* table, SQLResultSetField** fieldList, int32* sizes, int32 fieldsCount, SQLValue* value, int32 row, 
+                                                                                                                                      uint8* key)
 {
-	TRACE("quickSort")
-   PlainDB* plainDB = &table->db;   
+   TRACE("makeSortKey")
+   PlainDB* plainDB = &table->db;
    SQLResultSetField* field;
-   int32* vector = table->nodes;
    uint8* basbuf = plainDB->basbuf;
-   uint8* columnNulls1 = table->columnNulls;
-   uint8 columnNulls2[NUMBEROFBYTES(MAXIMUMS + 1)],
-         columnNulls3[NUMBEROFBYTES(MAXIMUMS + 1)];
-   int32 low,
-         count = fieldsCount,
-         high = last - first + 1, 
-         pivotIndex, // guich@212_3: now using random partition (improves worst case 2000x).
-         rowSize = plainDB->rowSize;
-   uint32 size = 2,
-         columnSize;
-   StringArray** stringArray = (StringArray**)TC_heapAlloc(heap, high * TSIZE);
-   StringArray* tempStringArray;
-
-   while (--high >= 0)
-      stringArray[high] = (StringArray*)TC_heapAlloc(heap, sizeof(StringArray) * fieldsCount);
-
-   // juliana@268_2: solved possible crash using order by when a string order by field does not appear in the select field.
-	while (--count >= 0) // Only loads columns used by the sorting process.
-	{
-      pivotIndex = (field = fieldList[count])->tableColIndex;
-		if ((columnSize = field->table->columnSizes[TC_htGet32(&field->table->htName2index, field->tableColHashCode)]))
-		{
-			pivot[pivotIndex]->asChars = (JCharP)TC_heapAlloc(heap, (columnSize << 1) + 2);
-			someRecord1[pivotIndex]->asChars = (JCharP)TC_heapAlloc(heap, (columnSize << 1) + 2);
-			someRecord2[pivotIndex]->asChars = (JCharP)TC_heapAlloc(heap, (columnSize << 1) + 2);
-		}
-	}
+   uint8* nulls = basbuf + table->columnOffsets[table->columnCount];
+   int32 i = -1,
+         column;
 
-   vector[0] = first;
-   vector[1] = last;
-   while (size) // guich@212_3: removed recursion (storing in a IntVector).
+   if (!plainRead(context, plainDB, row))
+      return false;
+   while (++i < fieldsCount)
    {
-      high = vector[--size];
-      low = vector[--size];
+      column = (field = fieldList[i])->tableColIndex;
       
-      // juliana@213_3: last can't be equal to first.		
-      if (!readRecord(context, table, pivot, pivotIndex = (last = high) == (first = low)? last : randBetween(first, last), columnNulls3, fieldList, 
-                                                                                                 fieldsCount, true, heap, stringArray))
-         goto error;
+      // juliana@230_12
+      if (isBitUnSet(nulls, column) 
+       && !readValue(context, plainDB, value, table->columnOffsets[column], table->columnTypes[column], basbuf, true, false, true, sizes[i], null))
+         return false;
+      key = putSortKeyValue(key, value, field->dataType, sizes[i], isBitSet(nulls, column), field->isAscending);
+   }
+   putSortKeyBits(key, row, 4);
+   return true;
+}
 
-		// Partition
-		while (true)
-		{
-			while (high >= low) // Finds the partitions.
-			{
-            // Only loads columns used by the sorting process.
-				if (!readRecord(context, table, someRecord1, low, columnNulls1, fieldList, fieldsCount, true, heap, stringArray))
-				   goto error;
-				if (compareRecords(someRecord1, pivot, columnNulls1, columnNulls3, fieldsCount, fieldList) >= 0)
-					break;
-				low++;
-			}
+/**
+ * Stores a field of a sort key. The fields of a key compared byte by byte have the same order as their values compared by 
+ * <code>compareRecords()</code>: nulls are greater than any value, numbers are stored in big endian with their sign bits flipped, strings have their
+ * characters followed by zeros and their lengths, and descending fields have all their bytes inverted. Equal values have equal fields.
+ *
+ * @param key The position of the sort key where the field is stored.
+ * @param value The value of the field.
+ * @param type The type of the field.
+ * @param size The size of a string field.
+ * @param isNull Indicates if the value is null.
+ * @param isAscending Indicates if the field is sorted in ascending order.
+ * @return The position of the sort key after the field.
+ */
+uint8* putSortKeyValue(uint8* key, SQLValue* value, int32 type, int32 size, bool isNull, bool isAscending)
+{
+   TRACE("putSortKeyValue")
+   uint8* end = key + (type == CHARS_TYPE || type == CHARS_NOCASE_TYPE? 3 + (size << 1) : 1 + typeSizes[type]);
+   JCharP chars;
+   int32 length;
+   uint32 bits;
+   uint64 longBits;
+
+   xmemzero(key, end - key);
+   if (isNull) // A null value is always considered to be the greatest value.
+      *key = 1;
+   else
+      switch (type)
+      {
+         case SHORT_TYPE:
+            putSortKeyBits(key + 1, (uint16)value->asShort ^ 0x8000, 2);
+            break;
+            
+         case DATE_TYPE:
+         case INT_TYPE:
+            putSortKeyBits(key + 1, (uint32)value->asInt ^ 0x80000000, 4);
+            break;
+            
+         case LONG_TYPE:
+            putSortKeyBits(key + 1, (uint64)value->asLong ^ ((uint64)1 << 63), 8);
+            break;
+            
+         case FLOAT_TYPE: // A negative number has all its bits inverted and -0 is equal to 0.
+            bits = 0;
+            if (value->asFloat != 0)
+               xmove4(&bits, &value->asFloat);
+            putSortKeyBits(key + 1, (bits & 0x80000000)? ~bits : bits | 0x80000000, 4);
+            break;
+            
+         case DOUBLE_TYPE:
+            longBits = 0;
+            if (value->asDouble != 0)
+               xmove8(&longBits, &value->asDouble);
+            putSortKeyBits(key + 1, (longBits & ((uint64)1 << 63))? ~longBits : longBits | ((uint64)1 << 63), 8);
+            break;
+            
+         case DATETIME_TYPE:
+            putSortKeyBits(key + 1, (uint32)value->asDate ^ 0x80000000, 4);
+            putSortKeyBits(key + 5, (uint32)value->asTime ^ 0x80000000, 4);
+            break;
+         
+         case CHARS_TYPE:
+         case CHARS_NOCASE_TYPE:
+            length = value->length;
+            chars = value->asChars;
+            while (--length >= 0)
+               putSortKeyBits(key + 1 + (length << 1), type == CHARS_NOCASE_TYPE? TC_JCharToLower(chars[length]) : chars[length], 2);
+            putSortKeyBits(end - 2, value->length, 2);
+      }
 
-			xmemmove(bufAux, basbuf, rowSize); // juliana@114_8
+   if (!isAscending)
+      while (key < end)
+         *key++ ^= 0xFF;
+   return end;
+}
 
-			while (high >= low)
-			{ 
-				if (!readRecord(context, table, someRecord2, high, columnNulls2, fieldList, fieldsCount, true, heap, stringArray))
-				   goto error;
-				if (compareRecords(someRecord2, pivot, columnNulls2, columnNulls3, fieldsCount, fieldList) <= 0)
-					break;
-				high--;
-			}
+/**
+ * Stores the lowest bytes of a number in a sort key in big endian.
+ *
+ * @param key The position of the sort key where the bytes are stored.
+ * @param bits The number.
+ * @param count The number of bytes to be stored.
+ */
+void putSortKeyBits(uint8* key, uint64 bits, int32 count)
+{
+   TRACE("putSortKeyBits")
+   while (--count >= 0)
+   {
+      key[count] = (uint8)bits;
+      bits >>= 8;
+   }
+}
 
-			if (low <= high) // Swap the records.
-			{
-				// juliana@114_8: optimized the swap of the records. Now the buffer is written at once.
-				tempStringArray = stringArray[low];
-            stringArray[low] = stringArray[high];
-            stringArray[high] = tempStringArray;
-            plainRewrite(context, plainDB, low++);
-				xmemmove(basbuf, bufAux, rowSize);
-				plainRewrite(context, plainDB, high--);
-			}
-			else break;
-		}
-		
-      // Sorts the partitions.
-      if (first < high) 
+/**
+ * Gets the row stored at the end of a sort key.
+ *
+ * @param key The last four bytes of the sort key.
+ * @return The row of the sort key.
+ */
+int32 getSortKeyRow(uint8* key)
+{
+   TRACE("getSortKeyRow")
+   return (key[0] << 24) | (key[1] << 16) | (key[2] << 8) | key[3];
+}
+
+/**
+ * The slices of a run being sorted by the worker pool of the VM.
+ */
+typedef struct
+{
+   uint8** keys;
+   int32 count;
+   int32 length;
+   int32 keySize;
+} SortSlices;
+
+/**
+ * Sorts a slice of a run. The workers only compare keys in memory: they never read the table nor touch the context.
+ *
+ * @param arg The slices of the run.
+ * @param slice The slice to be sorted.
+ * @param worker The thread sorting the slice.
+ */
+static void sortSlice(VoidP arg, int32 slice, int32 worker)
+{
+   SortSlices* slices = (SortSlices*)arg;
+   int32 start = slice * slices->length;
+   UNUSED(worker)
+   sortTableKeys(&slices->keys[start], MIN(slices->length, slices->count - start), slices->keySize);
+}
+
+/**
+ * Sorts the keys of a run of a table being sorted. A large run is split in slices, which are sorted by the worker pool of the VM and then merged.
+ * If there are no workers, or if another thread is using them, the slices are sorted by the calling thread. The keys are unique, so the result is
+ * always the same.
+ *
+ * @param keys The pointers to the keys to be sorted.
+ * @param merged Receives the pointers to the keys in their sorted order if the run is split in slices. It must have room for all the keys.
+ * @param count The number of keys.
+ * @param keySize The size of the keys.
+ * @return <code>keys</code> or <code>merged</code>, whichever has the sorted keys.
+ */
+uint8** sortTableRun(uint8** keys, uint8** merged, int32 count, int32 keySize)
+{
+   TRACE("sortTableRun")
+   SortSlices job;
+   int32 positions[TABLE_SORT_SLICES],
+         ends[TABLE_SORT_SLICES],
+         slices = MIN(TABLE_SORT_SLICES, count / TABLE_RUN_KEYS),
+         length,
+         lowest,
+         i,
+         j;
+
+   if (slices < 2)
+   {
+      sortTableKeys(keys, count, keySize);
+      return keys;
+   }
+
+   length = (count + slices - 1) / slices;
+   slices = (count + length - 1) / length;
+   job.keys = keys;
+   job.count = count;
+   job.length = length;
+   job.keySize = keySize;
+   TC_runPoolJobs(sortSlice, &job, slices);
+
+   i = slices;
+   while (--i >= 0)
+   {
+      positions[i] = i * length;
+      ends[i] = MIN(count, positions[i] + length);
+   }
+   for (j = 0; j < count; j++) // Merges the sorted slices.
+   {
+      lowest = -1;
+      i = slices;
+      while (--i >= 0)
+         if (positions[i] < ends[i] && (lowest == -1 || xmemcmp(keys[positions[i]], keys[positions[lowest]], keySize) < 0))
+            lowest = i;
+      merged[j] = keys[positions[lowest]++];
+   }
+   return merged;
+}
+
+/**
+ * Sorts the keys of a run of a table being sorted. It is a quick sort which uses a stack instead of recursion.
+ *
+ * @param keys The pointers to the keys to be sorted.
+ * @param count The number of keys.
+ * @param keySize The size of the keys.
+ */
+void sortTableKeys(uint8** keys, int32 count, int32 keySize)
+{
+   TRACE("sortTableKeys")
+   int32 stack[64],
+         size = 0,
+         low,
+         high,
+         i,
+         j;
+   uint8* pivot;
+   uint8* key;
+
+   if (count < 2)
+      return;
+   stack[size++] = 0;
+   stack[size++] = count - 1;
+   while (size)
+   {
+      high = stack[--size];
+      low = stack[--size];
+      while (low < high)
       {
-         vector[size++] = first;
-         vector[size++] = high;
+         pivot = keys[(low + high) >> 1];
+         i = low;
+         j = high;
+         while (i <= j)
+         {
+            while (xmemcmp(keys[i], pivot, keySize) < 0)
+               i++;
+            while (xmemcmp(keys[j], pivot, keySize) > 0)
+               j--;
+            if (i <= j)
+            {
+               key = keys[i];
+               keys[i++] = keys[j];
+               keys[j--] = key;
+            }
+         }
+
+         // Stacks the larger partition and goes on with the smaller one so that the stack never has more than 31 partitions.
+         if (j - low < high - i)
+         {
+            if (i < high)
+            {
+               stack[size++] = i;
+               stack[size++] = high;
+            }
+            high = j;
+         }
+         else
+         {
+            if (low < j)
+            {
+               stack[size++] = low;
+               stack[size++] = j;
+            }
+            low = i;
+         }
       }
-      if (low < last)
+   }
+}
+
+/**
+ * Writes a sorted run of keys of a table being sorted to the runs file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param runs The runs file.
+ * @param keys The pointers to the sorted keys.
+ * @param count The number of keys.
+ * @param keySize The size of the keys.
+ * @param total The number of keys already written to the runs file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool writeSortKeys(Context context, XFile* runs, uint8** keys, int32 count, int32 keySize, int32 total)
+{
+   TRACE("writeSortKeys")
+   int32 i = -1;
+
+   if ((uint32)(total + count) * keySize > runs->size && !nfGrowTo(context, runs, (total + count) * keySize))
+      return false;
+   nfSetPos(runs, total * keySize);
+   while (++i < count)
+      if (!nfWriteBytes(context, runs, keys[i], keySize))
+         return false;
+   return true;
+}
+
+/**
+ * Merges the sorted runs of keys of a table being sorted, giving the order of its rows. Each run has a block of keys read from the runs file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param runs The runs file.
+ * @param runEnds The end of each run in the runs file, with space for the position, the number of keys read, and the current key of each run.
+ * @param runCount The number of runs.
+ * @param keySize The size of the keys.
+ * @param order Receives the rows in their sorted order.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enough memory to merge the runs.
+ */
+bool mergeSortRuns(Context context, XFile* runs, int32* runEnds, int32 runCount, int32 keySize, int32* order)
+{
+   TRACE("mergeSortRuns")
+   int32* runPositions = &runEnds[runCount];
+   int32* runLengths = &runPositions[runCount];
+   int32* runIndexes = &runLengths[runCount];
+   int32 blockSize = TABLE_BLOCK_KEYS * keySize,
+         count = 0,
+         lowest,
+         i = runCount;
+   uint8* blocks = (uint8*)xmalloc(runCount * blockSize);
+   uint8* lowestKey = null;
+
+   if (!blocks)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+   while (--i >= 0)
+   {
+      runPositions[i] = i? runEnds[i - 1] : 0;
+      runLengths[i] = runIndexes[i] = 0;
+   }
+
+   while (true)
+   {
+      lowest = -1;
+      i = runCount;
+      while (--i >= 0)
       {
-         vector[size++] = low;
-         vector[size++] = last;
+         if (runIndexes[i] == runLengths[i] && runPositions[i] < runEnds[i]) // Reads the next block of the run.
+         {
+            runLengths[i] = MIN(TABLE_BLOCK_KEYS, runEnds[i] - runPositions[i]);
+            runIndexes[i] = 0;
+            nfSetPos(runs, runPositions[i] * keySize);
+            if (!nfReadBytes(context, runs, &blocks[i * blockSize], runLengths[i] * keySize))
+            {
+               xfree(blocks);
+               return false;
+            }
+            runPositions[i] += runLengths[i];
+         }
+         if (runIndexes[i] < runLengths[i] 
+          && (lowest == -1 || xmemcmp(&blocks[i * blockSize + runIndexes[i] * keySize], lowestKey, keySize) < 0))
+            lowestKey = &blocks[(lowest = i) * blockSize + runIndexes[i] * keySize];
       }
-	}
+      if (lowest == -1)
+         break;
+      order[count++] = getSortKeyRow(lowestKey + keySize - 4);
+      runIndexes[lowest]++;
+   }
+   xfree(blocks);
+   return true;
+}
 
-	heapDestroy(heap);
+/**
+ * Moves the rows of a table to their sorted positions. Each cycle of the permutation is followed, so that each row is read and written only once.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table being sorted.
+ * @param order The rows in their sorted order. It is destroyed.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enough memory to keep a row.
+ */
+bool moveSortedRows(Context context, Table* table, int32* order)
+{
+   TRACE("moveSortedRows")
+   PlainDB* plainDB = &table->db;
+   uint8* basbuf = plainDB->basbuf;
+   int32 rowCount = plainDB->rowCount,
+         rowSize = plainDB->rowSize,
+         row = -1,
+         position,
+         source;
+   uint8* first = (uint8*)xmalloc(rowSize);
+   
+   if (!first)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+   while (++row < rowCount)
+      if (order[row] != row && order[row] != -1)
+      {
+         // The first row of the cycle is kept and each position receives the row which goes there.
+         if (!plainRead(context, plainDB, position = row))
+            goto error;
+         xmemmove(first, basbuf, rowSize);
+         while ((source = order[position]) != row)
+         {
+            order[position] = -1;
+            if (!plainRead(context, plainDB, source) || !plainRewrite(context, plainDB, position))
+               goto error;
+            position = source;
+         }
+         order[position] = -1;
+         xmemmove(basbuf, first, rowSize);
+         if (!plainRewrite(context, plainDB, position))
+            goto error;
+      }
+   xfree(first);
    return true;
 
 error:
-   heapDestroy(heap);
+   xfree(first);
    return false;
 }
 
@@ -1257,7 +2178,7 @@ int32 compareSortRecords(int32 recSize, SQLValue** vals1, SQLValue** vals2, int8
          return result;
    
    // The values are equal. Compares with the record index.
-   if ((result = types[0] == DATETIME_TYPE) || result == LONG_TYPE || result == DOUBLE_TYPE)
+   if ((result = types[0]) == DATETIME_TYPE || result == LONG_TYPE || result == DOUBLE_TYPE)
 	{
 	   if (vals1[0]->length > vals2[0]->length)
          return MAX_SHORT_VALUE;
@@ -1538,11 +2459,12 @@ int64 radixPass(int32 start, SQLValue*** source, SQLValue*** dest, int32* count,
  * @param isAscii Indicates if the table strings are to be stored in the ascii format or in the unicode format.
  * @param useCrypto Indicates if the table uses cryptography.
  * @param nodes An array of nodes indices.
+ * @param nodePool The pool of the index nodes of the connection.
  * @param throwException Indicates that a TableNotClosedException should be thrown.
  * @param heap The table heap.
  * @return The table created or <code>null</code> if an error occurs.
  */
-Table* tableCreate(Context context, CharP name, TCHARP sourcePath, bool create, bool isAscii, bool useCrypto, int32* nodes, 
+Table* tableCreate(Context context, CharP name, TCHARP sourcePath, bool create, bool isAscii, bool useCrypto, int32* nodes, NodePool* nodePool,
                                                                                            bool throwException, Heap heap) // juliana@220_5
 {
    TRACE("tableCreate")
@@ -1554,6 +2476,7 @@ Table* tableCreate(Context context, CharP name, TCHARP sourcePath, bool create,
    table->sourcePath = sourcePath;
    table->heap = heap; 
    table->nodes = nodes;
+   table->nodePool = nodePool;
    
    IF_HEAP_ERROR(heap)
    {
@@ -1613,7 +2536,7 @@ Table* driverCreateTable(Context context, TCObject driver, CharP tableName, Char
    if (!tableName) // Temporary table.
 	{
 	   // rnovais@570_75 juliana@220_5
-		if (!(table = tableCreate(context, null, sourcePath, true, false, false, getLitebaseNodes(driver), true, heap))) 
+		if (!(table = tableCreate(context, null, sourcePath, true, false, false, getLitebaseNodes(driver), getLitebaseNodePool(driver), true, heap))) 
          return null; 
 
       table->db.headerSize = 0;
@@ -1645,7 +2568,7 @@ Table* driverCreateTable(Context context, TCObject driver, CharP tableName, Char
 		// juliana@220_5
 		// juliana@253_8: now Litebase supports weak cryptography.  
 		if (!(table = tableCreate(context, name, sourcePath, true, OBJ_LitebaseIsAscii(driver), OBJ_LitebaseUseCrypto(driver), 
-                                                                                              getLitebaseNodes(driver), true, heap)))
+                                                                                              getLitebaseNodes(driver), getLitebaseNodePool(driver), true, heap)))
 		   goto error;
 
       IF_HEAP_ERROR(heap)
@@ -1696,6 +2619,7 @@ bool renameTable(Context context, TCObject driver, Table* table, CharP newTableN
          length;
 	Hashtable* htTables = getLitebaseHtTables(driver);
    Index** columnIndexes = table->columnIndexes;
+   Index** columnTrigrams = table->columnTrigrams;
    ComposedIndex** composedIndexes = table->composedIndexes;
 
    // Gets the real name.
@@ -1722,6 +2646,19 @@ bool renameTable(Context context, TCObject driver, Table* table, CharP newTableN
       }
    }
 
+   // Renames the trigram indices.
+   i = columnTrigrams? table->columnCount : 0;
+   result[length + 1] = TRIGRAM_INDEX_PREFIX;
+   while (--i >= 0)
+   {
+		if (columnTrigrams[i])
+      {
+			xstrcpy(&result[length + 2], TC_int2str(i, intBuf));
+         if (!indexRename(context, columnTrigrams[i], result)) // Renames the index files.
+            return false;
+      }
+   }
+
    // juliana@220_17: rename table now renames the composed indices.
    i = table->numberComposedIndexes;
    result[length] = '&';
@@ -1790,7 +2727,7 @@ bool renameTableColumn(Context context, Table* table, CharP oldColumn, CharP new
 
 // juliana@201_3: if an index is created after populating or purging the table, its nodes will be full in order to improve its usage and search speed.
 /**
- * Re-builds an index of a table.
+ * Re-builds an index of a table. Its keys are sorted and the index is built from the leaves to the root.
  *
  * @param context The thread context where the function is being executed.
  * @param table The table being re-indexed.
@@ -1805,200 +2742,280 @@ bool tableReIndex(Context context, Table* table, int32 column, bool isPKCreation
 {
    TRACE("tableReIndex")
    Heap heap;
+   IndexSorter sorter;
    PlainDB* plainDB = &table->db;
    uint8* basbuf = plainDB->basbuf;
    Index* index = (column != -1)? table->columnIndexes[column] : composedIndex->index; // Gets the index.
-   int32 n = plainDB->rowCount,  
-         i = -1;
-	bool isDelayed = index->isWriteDelayed;
+   int32 n = plainDB->rowCount, // juliana@284_1: Solved a possible application crash when recreating indices.
+         i = -1,
+         j,
+         columnCount = table->columnCount,
+         indexSize = index->numberColumns,
+         bytes = NUMBEROFBYTES(columnCount),
+         offset = 0;
+	bool isDelayed = index->isWriteDelayed,
+        isNull;
+   SQLValue** values;
+   uint8* columnNulls0 = table->columnNulls;
+   uint8* nullsPosition = basbuf + table->columnOffsets[columnCount];
+   uint8* columns = null;
+   uint16* columnOffsets = table->columnOffsets;
+   int8* types = index->types;
+   int32* sizes = index->colSizes;
 
 	if (!indexDeleteAllRows(context, index)) // Cleans the index values.
       return false;
    if (!indexSetWriteDelayed(context, index, true)) // This makes the index creation faster.
       goto error1;
+   if (!n) // juliana@223_14: solved possible memory problems.
+      return indexSetWriteDelayed(context, index, isDelayed);
 
-   if (index->isOrdered && !composedIndex) // Simple index using rowid.
+   xmemzero(&sorter, sizeof(IndexSorter));
+
+   // juliana@223_14: solved possible memory problems.
+   heap = heapCreate();
+	IF_HEAP_ERROR(heap)
 	{
-		SQLValue emptyValue;
-	   SQLValue* value = &emptyValue;
-		xmemzero(&emptyValue, sizeof(SQLValue));
+		TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+		goto error2;
+	}
 
-      while (++i < n)
-		{
-         if (!plainRead(context, plainDB, i)) // Reads the row.
-            goto error1;
-         if (!recordNotDeleted(basbuf)) // Only gets non-deleted records.
-            continue;  
-            
-         // juliana@230_12
-			if (!readValue(context, plainDB, &emptyValue, 0, INT_TYPE, basbuf, false, false, false, -1, null) // juliana@220_3
-          || !indexAddKey(context, index, &value, i))
-            goto error1;
-		}
+   IF_HEAP_ERROR(table->heap) // juliana@223_14: solved possible memory problems.
+   {
+		TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+		goto error2;
 	}
-	else
-	{
-		int32 k = 0,
-            rows = plainDB->rowCount, // juliana@284_1: Solved a possible application crash when recreating indices.
-            j = rows,
-            columnCount = table->columnCount,
-            indexCount = index->numberColumns,
-            bytes = NUMBEROFBYTES(columnCount),
-            indexSize = index->numberColumns,
-            type,
-            offset = 0,
-            compare;
-		bool isNull;
-      SQLValue*** values;
-      uint8* columnNulls0 = table->columnNulls;
-      uint8* nullsPosition = basbuf + table->columnOffsets[columnCount];
-      uint8* columns = null;
-      uint16* columnOffsets = table->columnOffsets;
-      int8* types = index->types;
-      
-      if (!rows) // juliana@223_14: solved possible memory problems.
-         return indexSetWriteDelayed(context, index, isDelayed);
 
-      // juliana@223_14: solved possible memory problems.
-      heap = heapCreate();
-		IF_HEAP_ERROR(heap)
-		{
-			TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-			goto error2;
-		}
+   // juliana@270_25: solved a possible crash when an OutOfMemoryError occurs when creating or recreating indices.
+   IF_HEAP_ERROR(index->heap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+		goto error2;
+   }
 
-      IF_HEAP_ERROR(table->heap) // juliana@223_14: solved possible memory problems.
-      {
-			TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-			goto error2;
-		}
+   if (column != -1)
+      offset = columnOffsets[column];
+   else
+      columns = composedIndex->columns;
+	
+   // The keys are kept in memory while they fit in the sort memory. An index beginning with rowid is always ordered and its keys are not sorted.
+   if (!indexSortStart(context, &sorter, index, n, isPKCreation, heap))
+      goto error2;
 
-      // juliana@270_25: solved a possible crash when an OutOfMemoryError occurs when creating or recreating indices.
-      IF_HEAP_ERROR(index->heap)
-      {
-         TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-			goto error2;
-      }
+	while (++i < n)
+	{
+      isNull = false; // Resets the null info.
 
-      type = *types;
-      if (column != -1)
-         offset = columnOffsets[column];
-      else
-         columns = composedIndex->columns;
-		
-      // Allocates the records for the sorting.
-      values = (SQLValue***)TC_heapAlloc(heap, TSIZE * rows);
-	   while (--j >= 0)
-		   values[j] = (SQLValue**)TC_heapAlloc(heap, TSIZE * indexCount);
+		if (!plainRead(context, plainDB, i)) // Reads the row.
+         goto error2;
+		if (!recordNotDeleted(basbuf)) // Only gets non-deleted records.
+         continue;
 
-		while (++i < n)
-		{
-         isNull = false; // Resets the null info.
+		// juliana@201_22: the null columns information wasn't being read when re-creating an index.
+		xmemmove(columnNulls0, nullsPosition, bytes);
 
-			if (!plainRead(context, plainDB, i)) // Reads the row.
+      if (!(values = indexSortNext(context, &sorter)))
+         goto error2;
+		
+      if (column != -1)
+		{
+		   // juliana@230_12
+			if (!readValue(context, plainDB, *values, offset, *types, basbuf, false, isNull = isBitSet(columnNulls0, column), false, *sizes, heap))
+			   goto error2;
+
+			// juliana@202_12: Corrected null values dealing when building an index.
+			// juliana@202_10: Corrected a bug that would cause a DriverException if there was a null in an index field when creating it after the table is populated.
+			if (isPKCreation && columnNulls0 && isNull)
+			{				
+            TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_PK_CANT_BE_NULL), 0);
             goto error2;
-			if (!recordNotDeleted(basbuf)) // Only gets non-deleted records.
-            continue;
-
-			// juliana@201_22: the null columns information wasn't being read when re-creating an index.
-			xmemmove(columnNulls0, nullsPosition, bytes);
-
-         j = indexSize;
+			}
+		}
+		else
+		{
+			j = indexSize;
          while (--j >= 0)
-			   values[k][j] = (SQLValue*)TC_heapAlloc(heap, sizeof(SQLValue));
-			
-         if (column != -1)
 			{
 			   // juliana@230_12
-				if (!readValue(context, plainDB, *values[k], offset, type, basbuf, false, isNull = isBitSet(columnNulls0, column), false, -1, heap))
-				   goto error2;
-
+				if (!readValue(context, plainDB, values[j], columnOffsets[columns[j]], types[j], basbuf, false, isNull |= isBitSet(columnNulls0, columns[j]), false, sizes[j], heap))
+			      goto error2;
+			   
 				// juliana@202_12: Corrected null values dealing when building an index.
 				// juliana@202_10: Corrected a bug that would cause a DriverException if there was a null in an index field when creating it after the table is populated.
 				if (isPKCreation && columnNulls0 && isNull)
-				{				
-               TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_PK_CANT_BE_NULL), 0);
-               goto error2;
-				}
-			}
-			else
-			{
-				j = indexSize;
-            while (--j >= 0)
 				{
-				   // juliana@230_12
-					if (!readValue(context, plainDB, values[k][j], columnOffsets[columns[j]], types[j], basbuf, false, isNull |= isBitSet(columnNulls0, columns[j]), false, -1, heap))
-				      goto error2;
-				   
-					// juliana@202_12: Corrected null values dealing when building an index.
-					// juliana@202_10: Corrected a bug that would cause a DriverException if there was a null in an index field when creating it after the table is populated.
-					if (isPKCreation && columnNulls0 && isNull)
-					{
-						TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_PK_CANT_BE_NULL));
-                  goto error2;
-					}
+					TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_PK_CANT_BE_NULL));
+               goto error2;
 				}
 			}
+		}
 
-			if (isNull) // Do not store null records.
-				rows--;
-			else
-				// juliana@202_7: Corrected a bug that would cause long and double indices to be built incorrectly.
-				// The record value is stored in an empty field of the first record column value.
-            if (type == DATETIME_TYPE || type == LONG_TYPE || type == DOUBLE_TYPE)
-					(*values[k++])->length = i;
-				else
-					(*values[k++])->asTime = i;
-      }
+		if (!isNull && !indexSortAdd(context, &sorter, i)) // Do not store null records.
+         goto error2;
+   }
 
-      rows = k; // juliana@270_22: solved a possible crash when the table is corrupted on Android and possibly on other platforms.
-		if (!index->isOrdered)
-		{
-         // A radix sort is done for integer types. It is much more efficient than quick sort.
-			if (indexSize == 1 && (type == SHORT_TYPE || type == INT_TYPE || type == LONG_TYPE || type == DATE_TYPE))
-			{
-				SQLValue*** tempValues = (SQLValue***)TC_heapAlloc(heap, rows * TSIZE);
-				radixSort(values, rows, type, tempValues);
-			}
-			else
-				sortRecords(values, indexSize, types, 0, rows - 1, table->nodes); 
-			index->isOrdered = true; // The index elements will be inserted in the right order.
-      }		
+   if (!indexSortFinish(context, &sorter) || !indexSortClose(context, &sorter))
+      goto error2;
+   heapDestroy(heap);
+	return indexSetWriteDelayed(context, index, isDelayed); // Uses the user desired delayed settings again. 
+	
+error2:
+   if (sorter.index)
+      indexSortClose(context, &sorter);
+   heapDestroy(heap);
+error1:
+   indexSetWriteDelayed(context, index, isDelayed);
+   return false;
+}
 
-      k = -1;
-      while (++k < rows)
-		{
-         // If it is primary key, check first if there is violation.
-			if (isPKCreation && k > 0 && (!(compare = compareSortRecords(indexSize, values[k], values[k - 1], types)) || compare == MIN_SHORT_VALUE 
-			                                                                                                          || compare == MAX_SHORT_VALUE))
-			{
-				TC_throwExceptionNamed(context, "litebase.PrimaryKeyViolationException", getMessage(ERR_STATEMENT_CREATE_DUPLICATED_PK), table->name);
-			   
-            goto error2; // juliana@223_14: solved possible memory problems.
-			}
+/**
+ * Re-builds a trigram index of a table. The trigrams of the strings of all the rows are sorted and the index is built from the leaves to the root.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table being re-indexed.
+ * @param column The table column number of the index.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a heap memory allocation fails. 
+ */
+bool tableReIndexTrigrams(Context context, Table* table, int32 column)
+{
+   TRACE("tableReIndexTrigrams")
+   Heap heap;
+   IndexSorter sorter;
+   PlainDB* plainDB = &table->db;
+   uint8* basbuf = plainDB->basbuf;
+   uint8* nullsPosition = basbuf + table->columnOffsets[table->columnCount];
+   Index* index = table->columnTrigrams[column];
+   int32 n = plainDB->rowCount,
+         i = -1,
+         j,
+         count,
+         offset = table->columnOffsets[column],
+         type = table->columnTypes[column],
+         size = table->columnSizes[column],
+         perRow = MAX(size - 2, 1); // The maximum number of trigrams of a string of the column.
+	bool isDelayed = index->isWriteDelayed;
+   int32* trigrams;
+   SQLValue** values;
+   SQLValue value;
 
-			// juliana@202_7: Corrected a bug that would cause long and double indices to be built incorrectly.
-			if (((type == DATETIME_TYPE || type == LONG_TYPE || type == DOUBLE_TYPE) && !indexAddKey(context, index, values[k], (*values[k])->length))
-			 || (type != DATETIME_TYPE && type != LONG_TYPE && type != DOUBLE_TYPE && !indexAddKey(context, index, values[k], (*values[k])->asTime)))
-            goto error2; // juliana@223_14: solved possible memory problems.
-		}
+	if (!indexDeleteAllRows(context, index)) // Cleans the index values.
+      return false;
+   if (!indexSetWriteDelayed(context, index, true)) // This makes the index creation faster.
+      goto error1;
+   if (!n)
+      return indexSetWriteDelayed(context, index, isDelayed);
 
-		if (!composedIndex || column) // An index beggining with rowid is always ordered.
-         index->isOrdered = false;
-      heapDestroy(heap);
+   xmemzero(&sorter, sizeof(IndexSorter));
+   heap = heapCreate();
+	IF_HEAP_ERROR(heap)
+	{
+		TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+		goto error2;
 	}
-	
+   IF_HEAP_ERROR(index->heap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+		goto error2;
+   }
+
+   xmemzero(&value, sizeof(SQLValue));
+   value.asChars = (JCharP)TC_heapAlloc(heap, (size << 1) + 2);
+   trigrams = (int32*)TC_heapAlloc(heap, perRow << 2);
+
+   // The number of keys is not known before the rows are read, so the sorter is prepared for the maximum number of trigrams of all the rows.
+   if (!indexSortStart(context, &sorter, index, (int32)MIN((int64)n * perRow, 0x7FFFFFFF), false, heap))
+      goto error2;
+
+	while (++i < n)
+	{
+		if (!plainRead(context, plainDB, i)) // Reads the row.
+         goto error2;
+		if (!recordNotDeleted(basbuf) || isBitSet(nullsPosition, column)) // Only gets the strings of non-deleted records.
+         continue;
+      if (!readValue(context, plainDB, &value, offset, type, basbuf, false, false, false, size, heap))
+		   goto error2;
+
+      count = computeTrigrams(value.asChars, value.length, trigrams);
+      j = -1;
+      while (++j < count)
+      {
+         if (!(values = indexSortNext(context, &sorter)))
+            goto error2;
+         (*values)->asInt = trigrams[j];
+         if (!indexSortAdd(context, &sorter, i))
+            goto error2;
+      }
+   }
+
+   if (!indexSortFinish(context, &sorter) || !indexSortClose(context, &sorter))
+      goto error2;
+   heapDestroy(heap);
 	return indexSetWriteDelayed(context, index, isDelayed); // Uses the user desired delayed settings again. 
 	
 error2:
+   if (sorter.index)
+      indexSortClose(context, &sorter);
    heapDestroy(heap);
-   if (column) // An index beggining with rowid is always ordered.
-      index->isOrdered = false;  
 error1:
    indexSetWriteDelayed(context, index, isDelayed);
    return false;
 }
 
+/**
+ * Re-builds all the trigram indices of a table.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table being re-indexed.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a heap memory allocation fails. 
+ */
+bool tableReIndexAllTrigrams(Context context, Table* table)
+{
+   TRACE("tableReIndexAllTrigrams")
+   Index** columnTrigrams = table->columnTrigrams;
+   int32 i = columnTrigrams? table->columnCount : 0;
+
+   while (--i >= 0)
+      if (columnTrigrams[i] && !tableReIndexTrigrams(context, table, i))
+         return false;
+   return true;
+}
+
+/**
+ * Rebuilds the indices of a table left out of date by bulk inserts. The primary key is always up to date.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a heap memory allocation fails. 
+ */
+bool tableBuildDeferredIndices(Context context, Table* table)
+{
+   TRACE("tableBuildDeferredIndices")
+   Index** columnIndexes = table->columnIndexes;
+   ComposedIndex** composedIndexes = table->composedIndexes;
+   int32 i = table->columnCount;
+
+   if (!table->hasDeferredIndices)
+      return true;
+
+   while (--i >= 0) // Simple indices.
+      if (columnIndexes[i] && i != table->primaryKeyCol && !tableReIndex(context, table, i, false, null))
+         return false;
+
+   i = table->numberComposedIndexes;
+   while (--i >= 0) // Composed indices.
+      if (i != table->composedPK && !tableReIndex(context, table, -1, false, composedIndexes[i]))
+         return false;
+
+   if (!tableReIndexAllTrigrams(context, table)) // Trigram indices.
+      return false;
+
+   table->hasDeferredIndices = false;
+   return true;
+}
+
 /**
  * Creates a simple index for the table for the given column.
  *
@@ -2034,6 +3051,43 @@ bool indexCreateIndex(Context context, Table* table, CharP fullTableName, int32
    return true;
 }
 
+/**
+ * Creates a trigram index for the table for the given column. Its keys are the trigrams of the strings of the column, stored as ints, and its 
+ * records are the rows which have them.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @param fullTableName The table disk name.
+ * @param column The column of the index.
+ * @param exist Indicates that the index files already exist. 
+ * @param heap A heap to allocate the index structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool indexCreateTrigramIndex(Context context, Table* table, CharP fullTableName, int32 column, bool exist, Heap heap)
+{
+	TRACE("indexCreateTrigramIndex")
+   char indexName[DBNAME_SIZE];
+   IntBuf intBuf;
+   int32 tableLen = xstrlen(fullTableName);
+   int8* keyTypes = (int8*)TC_heapAlloc(heap, 1);
+   int32* keySizes = (int32*)TC_heapAlloc(heap, 4);
+
+   // The index name.
+   xstrcpy(indexName, fullTableName);
+   indexName[tableLen] = '$';
+   indexName[tableLen + 1] = TRIGRAM_INDEX_PREFIX;
+   xstrcpy(&indexName[tableLen + 2], TC_int2str(column, intBuf));
+
+   if (!table->columnTrigrams) // The first trigram index of the table.
+      table->columnTrigrams = (Index**)TC_heapAlloc(table->heap, table->columnCount * TSIZE);
+   
+   *keyTypes = INT_TYPE;
+   if (!(table->columnTrigrams[column] = createIndex(context, table, keyTypes, keySizes, indexName, 1, exist, heap))) 
+      return false;
+   table->columnAttrs[column] |= ATTR_COLUMN_HAS_TRIGRAM;
+   return true;
+}
+
 /**
  * Creates a composed index for a given table.
  *
@@ -2310,6 +3364,8 @@ bool writeRecord(Context context, Table* table, SQLValue** values, int32 recPos,
       isNull = isBitSet(columnNulls0, i);
 		idx = columnIndexes[i]; // If a new value is being written, the table index (if any) needs to be updated.
       hasIndex = (valueOk = (values[i] || isNull)) && idx; // Only if this row is being updated.
+      if (hasIndex && table->isBulkInsert && i != primaryKeyCol) // Bulk inserts only update the primary key.
+         hasIndex = false;
       type = columnTypes[i];
       offset = columnOffsets[i];
       changePos = false;
@@ -2370,8 +3426,30 @@ bool writeRecord(Context context, Table* table, SQLValue** values, int32 recPos,
             }
          }
       }
+
+      // The trigrams of the old string are removed before the ones of the new string are added, since both may share trigrams.
+      if (valueOk && !table->isBulkInsert && table->columnTrigrams && (idx = table->columnTrigrams[i]) 
+       && (addingNewRecord || valueCompareTo(null, vOlds[i], values[i], type, isNullVOld, isNull, null)))
+      {
+         oldPos = dbo->position;
+         j = db->position;
+         IF_HEAP_ERROR(idx->heap)
+         {
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+            return false;
+         }
+         if (!addingNewRecord && !isNullVOld && !indexUpdateTrigrams(context, idx, vOlds[i], writePos, true))
+            return false;
+         if (!isNull && !indexUpdateTrigrams(context, idx, values[i], writePos, false))
+            return false;
+         dbo->position = oldPos;
+         nfSetPos(db, j);
+      }
    }
 
+   if (table->isBulkInsert) // The other indices will be rebuilt before being used.
+      table->hasDeferredIndices = true;
+
    if ((j = i = table->numberComposedIndexes)) // Fills the composed indices.
    {
       ComposedIndex* compIndex;
@@ -2398,6 +3476,9 @@ bool writeRecord(Context context, Table* table, SQLValue** values, int32 recPos,
       // will be stored in a composed index only if all values are not null. This is a project choice.
       while (--i >= 0)
       {
+         if (table->isBulkInsert && i != table->composedPK) // Bulk inserts only update the primary key.
+            continue;
+
          compIndex = composedIndexes[i];
          index = compIndex->index;
          j = compIndex->numberColumns;
@@ -2857,7 +3938,7 @@ int32 rowUpdated(int32 id)
 }
 
 /**
- * Frees a table when closing a Litebase connection.
+ * Frees a table when closing a Litebase connection. The indices left out of date by bulk inserts are rebuilt before.
  *
  * @param context The thread context where the function is being executed.
  * @param table The table.
@@ -2866,7 +3947,8 @@ int32 rowUpdated(int32 id)
 bool freeTableHT(Context context, Table* table)
 {
    TRACE("freeTableHT")
-   return freeTable(context, table, 0, true);
+   bool ret = tableBuildDeferredIndices(context, table);
+   return freeTable(context, table, 0, true) && ret;
 }
 
 /**
@@ -2909,6 +3991,18 @@ bool freeTable(Context context, Table* table, bool isDelete, bool updatePos)
             }
          }
 
+      if ((columnIndexes = table->columnTrigrams)) // Frees the trigram indices.
+      {
+         n = table->columnCount;
+         while (--n >= 0)
+            if ((idx = columnIndexes[n]))
+            {
+               if (!indexClose(context, idx))
+                  ret = false;
+               columnIndexes[n] = null; 
+            }
+      }
+
       if (*table->name && (i = table->numberComposedIndexes)) // Frees the composed indices in a normal table.
       {
          while (--i >= 0)
@@ -2941,6 +4035,7 @@ bool freeTable(Context context, Table* table, bool isDelete, bool updatePos)
                htPS = getLitebaseHtPS(OBJ_PreparedStatementDriver(obj));
 				   sqlObj = OBJ_PreparedStatementSqlExpression(obj);
                TC_htRemove(htPS, TC_JCharPHashCode(String_charsStart(sqlObj), String_charsLen(sqlObj)));
+               removeCachedStatement(obj);
                freePreparedStatement(0, obj);
             }
 			   list = TC_TCObjectsRemove(list, obj);
@@ -3115,7 +4210,7 @@ Table* getTable(Context context, TCObject driver, CharP tableName)
          // juliana@220_5
          // juliana@253_8: now Litebase supports weak cryptography.
          if ((table = tableCreate(context, name, getLitebaseSourcePath(driver), false, OBJ_LitebaseIsAscii(driver), OBJ_LitebaseUseCrypto(driver), 
-                                                                                       getLitebaseNodes(driver), true, heap)) && table->db.db.size)
+                                                                                       getLitebaseNodes(driver), getLitebaseNodePool(driver), true, heap)) && table->db.db.size)
          {
             if (!TC_htPutPtr(htTables, hashCode, table)) // Puts the table hash code in the hash table of opened tables.
             {
@@ -3123,6 +4218,12 @@ Table* getTable(Context context, TCObject driver, CharP tableName)
                TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
                return null;
             }
+            if (getLitebaseWal(driver) && !getLitebaseWal(driver)->suspended) // The table files are written through the connection log.
+               tableAttachWal(table, getLitebaseWal(driver));
+#if defined(POSIX) || defined(ANDROID)
+            else if (OBJ_LitebaseUseMmap(driver) && !tableMapFiles(context, table)) // The table files are mapped into memory.
+               return null;
+#endif
          }
          else
             return null;
@@ -3131,6 +4232,64 @@ Table* getTable(Context context, TCObject driver, CharP tableName)
    return table;
 }
 
+/**
+ * Makes the writes to the files of a table go through the write-ahead log of its connection. 
+ *
+ * @param table The table.
+ * @param wal The log of the connection.
+ */
+void tableAttachWal(Table* table, Wal* wal)
+{
+   TRACE("tableAttachWal")
+   Index** columnIndexes = table->columnIndexes;
+   ComposedIndex** composedIndexes = table->composedIndexes;
+   int32 i = table->columnCount;
+
+   walAttach(wal, &table->db.db);
+   walAttach(wal, &table->db.dbo);
+   while (--i >= 0)
+   {
+      if (columnIndexes[i])
+         walAttach(wal, &columnIndexes[i]->fnodes);
+      if (table->columnTrigrams && table->columnTrigrams[i])
+         walAttach(wal, &table->columnTrigrams[i]->fnodes);
+   }
+   i = table->numberComposedIndexes;
+   while (--i >= 0)
+      walAttach(wal, &composedIndexes[i]->index->fnodes);
+}
+
+#if defined(POSIX) || defined(ANDROID)
+/**
+ * Maps the files of a table into memory, so that they are used as their caches. The indices created afterwards keep using cache windows until the
+ * table is opened again.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to flush a cache.
+ */
+bool tableMapFiles(Context context, Table* table)
+{
+   TRACE("tableMapFiles")
+   Index** columnIndexes = table->columnIndexes;
+   ComposedIndex** composedIndexes = table->composedIndexes;
+   int32 i = table->columnCount;
+
+   if (!nfMap(context, &table->db.db) || !nfMap(context, &table->db.dbo))
+      return false;
+   while (--i >= 0)
+      if ((columnIndexes[i] && !nfMap(context, &columnIndexes[i]->fnodes))
+       || (table->columnTrigrams && table->columnTrigrams[i] && !nfMap(context, &table->columnTrigrams[i]->fnodes)))
+         return false;
+   i = table->numberComposedIndexes;
+   while (--i >= 0)
+      if (!nfMap(context, &composedIndexes[i]->index->fnodes))
+         return false;
+   return true;
+}
+#endif
+
 /**
  * Reads a string from a buffer.
  *
@@ -3223,7 +4382,8 @@ uint8* writeString16(uint8* buffer, JCharP string, int32 length)
 }
 
 /**
- * Changes a table to the modified state whenever it is modified.
+ * Changes a table to the modified state whenever it is modified. The tables written through a write-ahead log are never marked, since the log 
+ * already restores them after a crash.
  * 
  * @param context The thread context where the function is being executed.
  * @param table The table to be set as modified.
@@ -3233,7 +4393,7 @@ bool setModified(Context context, Table* table)
 {
    TRACE("setModified")
 
-   if (!table->isModified)
+   if (!table->isModified && !table->db.db.wal)
    {
       PlainDB* plainDB = &table->db;
       XFile* dbFile = &plainDB->db;
@@ -3284,4 +4444,44 @@ TESTCASE(rowUpdated)
 finish: ;
 }
 
+/**
+ * Tests if sortTableRun() sorts the slices of a large run and merges them correctly. 
+ * 
+ * @param testSuite The test structure.
+ * @param currentContext The thread context where the test is being executed.
+ */
+TESTCASE(sortTableRun)
+{
+   int32 count = TABLE_RUN_KEYS * TABLE_SORT_SLICES + 5, // The last slice is shorter than the others.
+         i;
+   uint8* keys = (uint8*)xmalloc(count << 2);
+   uint8** pointers = (uint8**)xmalloc(count * TSIZE);
+   uint8** merged = (uint8**)xmalloc(count * TSIZE);
+   uint8** sorted;
+   UNUSED(currentContext)
+
+   ASSERT1_EQUALS(NotNull, keys);
+   ASSERT1_EQUALS(NotNull, pointers);
+   ASSERT1_EQUALS(NotNull, merged);
+   i = count;
+   while (--i >= 0) // The rows in a scrambled order.
+   {
+      int32 row = (int32)(((uint32)i * 7919) % (uint32)count);
+      uint8* key = pointers[i] = &keys[i << 2];
+      key[0] = (uint8)(row >> 24);
+      key[1] = (uint8)(row >> 16);
+      key[2] = (uint8)(row >> 8);
+      key[3] = (uint8)row;
+   }
+   sorted = sortTableRun(pointers, merged, count, 4);
+   i = count;
+   while (--i >= 0)
+      ASSERT2_EQUALS(I32, i, getSortKeyRow(sorted[i]));
+
+finish:
+   xfree(keys);
+   xfree(pointers);
+   xfree(merged);
+}
+
 #endif
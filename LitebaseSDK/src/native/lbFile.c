@@ -13,6 +13,7 @@
    #include "win/File_c.h"
 #else
    #include "posix/File_c.h"
+   #include <sys/mman.h>
 #endif
 
 Err lbfileCreate(NATIVE_FILE* fref, TCHARP path, int32 mode)
@@ -63,3 +64,24 @@ Err lbfileFlush(NATIVE_FILE fref)
 {                                    
    return fileFlush(fref);
 }
+
+#if defined(POSIX) || defined(ANDROID)
+Err lbfileMap(NATIVE_FILE fref, int32 size, uint8** map)
+{
+   uint8* address = (uint8*)mmap(null, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(fref.handle), 0);
+
+   if (address == MAP_FAILED)
+      return errno;
+   *map = address;
+   return NO_ERROR;
+}
+Err lbfileUnmap(uint8* map, int32 size)
+{
+   return munmap(map, size)? errno : NO_ERROR;
+}
+Err lbfileSyncMap(uint8* map, int32 offset, int32 length)
+{
+   int32 start = offset & ~(int32)(sysconf(_SC_PAGESIZE) - 1); // msync() only accepts addresses aligned to pages.
+   return msync(map + start, offset + length - start, MS_SYNC)? errno : NO_ERROR;
+}
+#endif
@@ -25,4 +25,10 @@ extern Err lbfileWriteBytes(NATIVE_FILE fref, CharP bytes, int32 offset, int32 l
 extern Err lbfileSetSize(NATIVE_FILE* fref, int32 newSize);
 extern Err lbfileFlush(NATIVE_FILE fref);
 
+#if defined(POSIX) || defined(ANDROID)
+extern Err lbfileMap(NATIVE_FILE fref, int32 size, uint8** map);
+extern Err lbfileUnmap(uint8* map, int32 size);
+extern Err lbfileSyncMap(uint8* map, int32 offset, int32 length);
+#endif
+
 #endif
@@ -156,6 +156,16 @@ void initLitebaseMessage(void)
    errorMsgs_en[ERR_COMP_BLOBS] = "It is not possible to compare BLOBs.";
    errorMsgs_en[ERR_BLOBS_PREPARED] = "It is only possible to insert or update a BLOB through prepared statements using setBlob().";
 
+   // Transaction errors.
+   errorMsgs_en[ERR_WAL_DISABLED] = "Transactions are only available on connections opened with the wal parameter.";
+   errorMsgs_en[ERR_TRANSACTION_STARTED] = "A transaction was already started.";
+   errorMsgs_en[ERR_NO_TRANSACTION] = "There is no transaction to be committed.";
+   errorMsgs_en[ERR_TRANSACTION_DDL] = "This operation can't be executed inside a transaction.";
+   errorMsgs_en[ERR_TRANSACTION_FAILED] = "A command of the transaction failed, so it can't be committed. Close the connection to discard it.";
+
+   // Trigram index errors.
+   errorMsgs_en[ERR_TRIGRAM_INDEX] = "A trigram index must have a single CHAR or VARCHAR column.";
+
    // Portuguese messages.
 	// General errors.
    errorMsgs_pt[ERR_MESSAGE_START] = "Erro: ";
@@ -293,6 +303,16 @@ void initLitebaseMessage(void)
    errorMsgs_pt[ERR_BLOB_ORDER_GROUP] = "Tipos BLOB n�o podem estar em cl�usulas ORDER BY ou GROUP BY.";
    errorMsgs_pt[ERR_COMP_BLOBS] = "N�o � poss�vel comparar BLOBs.";
    errorMsgs_pt[ERR_BLOBS_PREPARED] = "S� � poss�vel inserir ou atualizar um BLOB atrav�s prepared statements usando setBlob().";
+
+   // Transaction errors.
+   errorMsgs_pt[ERR_WAL_DISABLED] = "Transa��es s� est�o dispon�veis em conex�es abertas com o par�metro wal.";
+   errorMsgs_pt[ERR_TRANSACTION_STARTED] = "Uma transa��o j� foi iniciada.";
+   errorMsgs_pt[ERR_NO_TRANSACTION] = "N�o h� transa��o para ser efetivada.";
+   errorMsgs_pt[ERR_TRANSACTION_DDL] = "Esta opera��o n�o pode ser executada dentro de uma transa��o.";
+   errorMsgs_pt[ERR_TRANSACTION_FAILED] = "Um comando da transa��o falhou, ent�o ela n�o pode ser efetivada. Feche a conex�o para descart�-la.";
+
+   // Trigram index errors.
+   errorMsgs_pt[ERR_TRIGRAM_INDEX] = "Um �ndice de trigramas deve ter uma �nica coluna CHAR ou VARCHAR.";
 }
 
 /**
@@ -463,6 +483,14 @@ TESTCASE(getMessage)
    ASSERT2_EQUALS(Sz, getMessage(ERR_COMP_BLOBS), "It is not possible to compare BLOBs.");
    ASSERT2_EQUALS(Sz, getMessage(ERR_BLOBS_PREPARED), "It is only possible to insert or update a BLOB through prepared statements using setBlob().");
 
+   // Transaction errors.
+   ASSERT2_EQUALS(Sz, getMessage(ERR_WAL_DISABLED), "Transactions are only available on connections opened with the wal parameter.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRANSACTION_STARTED), "A transaction was already started.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_NO_TRANSACTION), "There is no transaction to be committed.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRANSACTION_DDL), "This operation can't be executed inside a transaction.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRANSACTION_FAILED), "A command of the transaction failed, so it can't be committed. Close the connection to discard it.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRIGRAM_INDEX), "A trigram index must have a single CHAR or VARCHAR column.");
+
    // Portuguese messages.
    litebaseConnectionClass->i32StaticValues[4] = LANGUAGE_PT;
 
@@ -608,6 +636,14 @@ TESTCASE(getMessage)
    ASSERT2_EQUALS(Sz, getMessage(ERR_COMP_BLOBS), "N�o � poss�vel comparar BLOBs.");
    ASSERT2_EQUALS(Sz, getMessage(ERR_BLOBS_PREPARED), "S� � poss�vel inserir ou atualizar um BLOB atrav�s prepared statements usando setBlob().");
 
+   // Transaction errors.
+   ASSERT2_EQUALS(Sz, getMessage(ERR_WAL_DISABLED), "Transa��es s� est�o dispon�veis em conex�es abertas com o par�metro wal.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRANSACTION_STARTED), "Uma transa��o j� foi iniciada.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_NO_TRANSACTION), "N�o h� transa��o para ser efetivada.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRANSACTION_DDL), "Esta opera��o n�o pode ser executada dentro de uma transa��o.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRANSACTION_FAILED), "Um comando da transa��o falhou, ent�o ela n�o pode ser efetivada. Feche a conex�o para descart�-la.");
+   ASSERT2_EQUALS(Sz, getMessage(ERR_TRIGRAM_INDEX), "Um �ndice de trigramas deve ter uma �nica coluna CHAR ou VARCHAR.");
+
    litebaseConnectionClass->i32StaticValues[4] = LANGUAGE_EN;
 
 finish: ;
@@ -761,6 +797,15 @@ TESTCASE(initLitebaseMessage)
    ASSERT2_EQUALS(Sz, errorMsgs_en[88], "It is not possible to compare BLOBs.");
    ASSERT2_EQUALS(Sz, errorMsgs_en[89], "It is only possible to insert or update a BLOB through prepared statements using setBlob().");
 
+   // Transaction errors.
+   ASSERT2_EQUALS(Sz, errorMsgs_en[90], "Transactions are only available on connections opened with the wal parameter.");
+   ASSERT2_EQUALS(Sz, errorMsgs_en[91], "A transaction was already started.");
+   ASSERT2_EQUALS(Sz, errorMsgs_en[92], "There is no transaction to be committed.");
+   ASSERT2_EQUALS(Sz, errorMsgs_en[93], "This operation can't be executed inside a transaction.");
+
+   // Trigram index errors.
+   ASSERT2_EQUALS(Sz, errorMsgs_en[94], "A trigram index must have a single CHAR or VARCHAR column.");
+
    // Portuguese messages.
 	// General errors.
    ASSERT2_EQUALS(Sz, errorMsgs_pt[0], "Erro: ");
@@ -899,6 +944,15 @@ TESTCASE(initLitebaseMessage)
    ASSERT2_EQUALS(Sz, errorMsgs_pt[88], "N�o � poss�vel comparar BLOBs.");
    ASSERT2_EQUALS(Sz, errorMsgs_pt[89], "S� � poss�vel inserir ou atualizar um BLOB atrav�s prepared statements usando setBlob().");
 
+   // Transaction errors.
+   ASSERT2_EQUALS(Sz, errorMsgs_pt[90], "Transa��es s� est�o dispon�veis em conex�es abertas com o par�metro wal.");
+   ASSERT2_EQUALS(Sz, errorMsgs_pt[91], "Uma transa��o j� foi iniciada.");
+   ASSERT2_EQUALS(Sz, errorMsgs_pt[92], "N�o h� transa��o para ser efetivada.");
+   ASSERT2_EQUALS(Sz, errorMsgs_pt[93], "Esta opera��o n�o pode ser executada dentro de uma transa��o.");
+
+   // Trigram index errors.
+   ASSERT2_EQUALS(Sz, errorMsgs_pt[94], "Um �ndice de trigramas deve ter uma �nica coluna CHAR ou VARCHAR.");
+
 finish : ;
 }
 
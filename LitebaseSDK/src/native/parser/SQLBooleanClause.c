@@ -283,6 +283,12 @@ void applyIndexToBranch(SQLBooleanClause* booleanClause, SQLBooleanClauseTree* b
       {
          SQLBooleanClauseTree* parent = branch->parent;
 
+         // If the statistics of the table show that the comparison selects too many rows, scanning the table is cheaper than using the index. 
+         // An index can't be skipped in an OR, since the other ones would not be enough.
+         if (booleanClause->appliedIndexesBooleanOp != OP_BOOLEAN_OR && indexesMap[column]->table->analyzedRowCount 
+          && estimateSelectivity(branch, 0) > INDEX_MAX_SELECTIVITY)
+            return;
+
          // Adds the index to the list of applied indexes.
          int32 n = booleanClause->appliedIndexesCount++;
          appliedIndexesCols[n] = column;
@@ -605,8 +611,133 @@ bool sqlBooleanClausePreVerify(Context context, SQLBooleanClause* booleanClause)
 int32 sqlBooleanClauseSatisfied(Context context, SQLBooleanClause* booleanClause, ResultSet* resultSet, Heap heap)
 {
 	TRACE("sqlBooleanClauseSatisfied")
+   int32 i = -1,
+         ret;
+   Table* table;
+
    booleanClause->resultSet = resultSet;
-   return booleanTreeEvaluate(context, booleanClause->expressionTree, heap);
+   if (!resultSet->isScanCompiled)
+      compileScanPredicates(booleanClause, resultSet);
+   if (!resultSet->scanPredicatesCount)
+      return booleanTreeEvaluate(context, booleanClause->expressionTree, heap);
+   
+   // The comparisons of fixed size columns are tested first on the row buffer. Only the rows that satisfy all of them have their remaining 
+   // conditions evaluated, which may need to load strings from the .dbo.
+   while (++i < resultSet->scanPredicatesCount)
+      if ((ret = scanPredicateSatisfied(context, resultSet, &resultSet->scanPredicates[i])) != true)
+         return ret;
+   
+   // The nulls of the row are kept as if the whole expression tree had been evaluated.
+   table = resultSet->table;
+   xmemmove(table->columnNulls, table->db.basbuf + table->columnOffsets[table->columnCount], NUMBEROFBYTES(table->columnCount));
+
+   i = -1;
+   while (++i < resultSet->scanResidualsCount)
+      if ((ret = booleanTreeEvaluate(context, resultSet->scanResiduals[i], heap)) != true)
+         return ret;
+   return true;
+}
+
+/**
+ * Splits the WHERE clause of a result set in the comparisons between fixed size columns and constants, which are tested directly on the rows, and
+ * the remaining conditions. It is done when the first row is evaluated, after the indices were applied. If the clause is not a conjunction or has
+ * no such comparisons, the whole expression tree will be evaluated for each row.
+ *
+ * @param booleanClause A pointer to a <code>SQLBooleanClause</code> structure.
+ * @param resultSet The result set whose table is scanned.
+ */
+void compileScanPredicates(SQLBooleanClause* booleanClause, ResultSet* resultSet)
+{
+   TRACE("compileScanPredicates")
+   resultSet->isScanCompiled = true;
+   if (!booleanClause->expressionTree || !addScanConjunct(booleanClause, resultSet, booleanClause->expressionTree))
+      resultSet->scanPredicatesCount = resultSet->scanResidualsCount = 0;
+}
+
+/**
+ * Adds a condition of a WHERE clause conjunction to the predicates tested directly on the rows or to the remaining conditions.
+ *
+ * @param booleanClause A pointer to a <code>SQLBooleanClause</code> structure.
+ * @param resultSet The result set whose table is scanned.
+ * @param tree The condition.
+ * @return <code>false</code> if the conditions can't be split; <code>true</code>, otherwise.
+ */
+bool addScanConjunct(SQLBooleanClause* booleanClause, ResultSet* resultSet, SQLBooleanClauseTree* tree)
+{
+   TRACE("addScanConjunct")
+   int32 operandType = tree->operandType;
+
+   if (operandType == OP_BOOLEAN_AND)
+      return tree->leftTree && tree->rightTree && addScanConjunct(booleanClause, resultSet, tree->leftTree) 
+                                               && addScanConjunct(booleanClause, resultSet, tree->rightTree);
+   
+   // Only comparisons between a column without data type functions and a constant of numeric or date types can be tested on the row buffer.
+   if (operandType >= OP_REL_EQUAL && operandType <= OP_REL_LESS_EQUAL && tree->valueType >= SHORT_TYPE && tree->valueType <= DATETIME_TYPE 
+    && tree->valueType != CHARS_NOCASE_TYPE && tree->valueType != BOOLEAN_TYPE && !tree->bothAreIdentifier && tree->leftTree && tree->rightTree && tree->leftTree->valueType != -1 && tree->rightTree->valueType != -1)
+   {
+      SQLBooleanClauseTree* column = null;
+      bool isLeft = false;
+      
+      if (tree->leftTree->operandType == OP_IDENTIFIER && tree->rightTree->operandType != OP_IDENTIFIER)
+      {
+         column = tree->leftTree;
+         isLeft = true;
+      }
+      else if (tree->rightTree->operandType == OP_IDENTIFIER && tree->leftTree->operandType != OP_IDENTIFIER)
+         column = tree->rightTree;
+      
+      if (column && booleanClause->fieldList[getFieldIndex(column)]->sqlFunction == FUNCTION_DT_NONE)
+      {
+         Table* table = resultSet->table;
+         int32 type = table->columnTypes[column->colIndex];
+
+         if (type >= SHORT_TYPE && type <= DATETIME_TYPE && type != CHARS_NOCASE_TYPE && type != BOOLEAN_TYPE)
+         {
+            ScanPredicate* predicate;
+            
+            if (resultSet->scanPredicatesCount == MAX_SCAN_PREDICATES)
+               return false;
+            predicate = &resultSet->scanPredicates[resultSet->scanPredicatesCount++];
+            predicate->tree = tree;
+            predicate->colIndex = column->colIndex;
+            predicate->isLeft = isLeft;
+            predicate->type = type;
+            predicate->offset = table->columnOffsets[column->colIndex];
+            return true;
+         }
+      }
+   }
+
+   if (resultSet->scanResidualsCount == MAX_SCAN_PREDICATES)
+      return false;
+   resultSet->scanResiduals[resultSet->scanResidualsCount++] = tree;
+   return true;
+}
+
+/**
+ * Tests a comparison between a fixed size column and a constant directly on the buffer of the current row of the table of a result set.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set whose table is scanned.
+ * @param predicate The comparison.
+ * @return 1, if the current row satisfies the comparison; 0 if it does not satisfy it; -1, if an error occurs.
+ */
+int32 scanPredicateSatisfied(Context context, ResultSet* resultSet, ScanPredicate* predicate)
+{
+   TRACE("scanPredicateSatisfied")
+   Table* table = resultSet->table;
+   uint8* basbuf = table->db.basbuf;
+   SQLBooleanClauseTree* tree = predicate->tree;
+   SQLValue value;
+
+   if (isBitSet(basbuf + table->columnOffsets[table->columnCount], predicate->colIndex)) // A null never satisfies a comparison.
+      return false;
+   
+   xmemzero(&value, sizeof(SQLValue));
+   if (!readValue(context, &table->db, &value, predicate->offset, predicate->type, basbuf, !*table->name, false, false, -1, null))
+      return -1;
+   return predicate->isLeft? compareNumericValues(context, tree, value, tree->rightTree->operandValue) 
+                           : compareNumericValues(context, tree, tree->leftTree->operandValue, value);
 }
 
 /**
@@ -96,6 +96,36 @@ bool sqlBooleanClausePreVerify(Context context, SQLBooleanClause* booleanClause)
  * boolean clause; -1, otherwise.
  */
 int32 sqlBooleanClauseSatisfied(Context context, SQLBooleanClause* booleanClause, ResultSet* resultSet, Heap heap);
+
+/**
+ * Splits the WHERE clause of a result set in the comparisons between fixed size columns and constants, which are tested directly on the rows, and
+ * the remaining conditions. It is done when the first row is evaluated, after the indices were applied. If the clause is not a conjunction or has
+ * no such comparisons, the whole expression tree will be evaluated for each row.
+ *
+ * @param booleanClause A pointer to a <code>SQLBooleanClause</code> structure.
+ * @param resultSet The result set whose table is scanned.
+ */
+void compileScanPredicates(SQLBooleanClause* booleanClause, ResultSet* resultSet);
+
+/**
+ * Adds a condition of a WHERE clause conjunction to the predicates tested directly on the rows or to the remaining conditions.
+ *
+ * @param booleanClause A pointer to a <code>SQLBooleanClause</code> structure.
+ * @param resultSet The result set whose table is scanned.
+ * @param tree The condition.
+ * @return <code>false</code> if the conditions can't be split; <code>true</code>, otherwise.
+ */
+bool addScanConjunct(SQLBooleanClause* booleanClause, ResultSet* resultSet, SQLBooleanClauseTree* tree);
+
+/**
+ * Tests a comparison between a fixed size column and a constant directly on the buffer of the current row of the table of a result set.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set whose table is scanned.
+ * @param predicate The comparison.
+ * @return 1, if the current row satisfies the comparison; 0 if it does not satisfy it; -1, if an error occurs.
+ */
+int32 scanPredicateSatisfied(Context context, ResultSet* resultSet, ScanPredicate* predicate);
                                                                           
 /**
  * Binds the column information of the underlying table list to the boolean clause.
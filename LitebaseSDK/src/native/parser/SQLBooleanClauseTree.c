@@ -465,24 +465,10 @@ bool compareNullOperands(SQLBooleanClauseTree* booleanClauseTree)
 int32 compareNumericOperands(Context context, SQLBooleanClauseTree* booleanClauseTree)
 {
 	TRACE("compareNumericOperands")
-   bool result = false;
    SQLBooleanClauseTree* leftTree = booleanClauseTree->leftTree;
    SQLBooleanClauseTree* rightTree = booleanClauseTree->rightTree;
    SQLValue leftValue,
             rightValue;
-   int32 leftValueType = leftTree->valueType,
-         rightValueType = rightTree->valueType,
-         assignType = booleanClauseTree->isFloatingPointType? DOUBLE_TYPE 
-                    : leftValueType != LONG_TYPE && rightValueType != LONG_TYPE && leftValueType != DATETIME_TYPE? INT_TYPE : LONG_TYPE,
-         compareType = leftValueType == DATETIME_TYPE? DATETIME_TYPE : assignType,
-         leftValueAsInt = 0,
-         rightValueAsInt = 0, 
-         leftValueAsTime = 0,
-         rightValueAsTime = 0;
-   int64 leftValueAsLong = 0,
-         rightValueAsLong = 0;
-   double leftValueAsDouble = 0,
-          rightValueAsDouble = 0;
    
    // Gets the values.
    if (booleanClauseTree->bothAreIdentifier)
@@ -499,6 +485,37 @@ int32 compareNumericOperands(Context context, SQLBooleanClauseTree* booleanClaus
 
    if (leftValue.isNull || rightValue.isNull) // One of the values is a null value.
       return false;
+   return compareNumericValues(context, booleanClauseTree, leftValue, rightValue);
+}
+
+/**
+ * Compares two numerical values already fetched for the operands of a comparison.
+ * 
+ * @param context The thread context where the function is being executed.
+ * @param booleanClauseTree A pointer to a <code>SQLBooleanClauseTree</code> structure. 
+ * @param leftValue The value of the left operand, which can't be null.
+ * @param rightValue The value of the right operand, which can't be null.
+ * @return The evaluation of the comparison expression or -1 if an error occurs.
+ */
+int32 compareNumericValues(Context context, SQLBooleanClauseTree* booleanClauseTree, SQLValue leftValue, SQLValue rightValue)
+{
+	TRACE("compareNumericValues")
+   bool result = false;
+   SQLBooleanClauseTree* leftTree = booleanClauseTree->leftTree;
+   SQLBooleanClauseTree* rightTree = booleanClauseTree->rightTree;
+   int32 leftValueType = leftTree->valueType,
+         rightValueType = rightTree->valueType,
+         assignType = booleanClauseTree->isFloatingPointType? DOUBLE_TYPE 
+                    : leftValueType != LONG_TYPE && rightValueType != LONG_TYPE && leftValueType != DATETIME_TYPE? INT_TYPE : LONG_TYPE,
+         compareType = leftValueType == DATETIME_TYPE? DATETIME_TYPE : assignType,
+         leftValueAsInt = 0,
+         rightValueAsInt = 0, 
+         leftValueAsTime = 0,
+         rightValueAsTime = 0;
+   int64 leftValueAsLong = 0,
+         rightValueAsLong = 0;
+   double leftValueAsDouble = 0,
+          rightValueAsDouble = 0;
 
    switch (leftValueType) // Getting left value.
    {
@@ -1494,3 +1511,126 @@ SQLBooleanClauseTree* cloneTree(SQLBooleanClauseTree* booleanClauseTree, SQLBool
       (tree->rightTree = cloneTree(booleanClauseTree->rightTree, destTree? destTree->rightTree : null,  heap))->parent = tree;
    return tree;
 }
+
+/**
+ * Estimates the fraction of the rows of a table of the query which satisfies an expression tree using the statistics of the table. The 
+ * comparisons which don't involve only a column of the table and a constant, and the tables that were not analyzed, don't restrict the rows. 
+ *
+ * @param booleanClauseTree A pointer to a <code>SQLBooleanClauseTree</code> structure. 
+ * @param indexRs The index of the table in the table list of the query.
+ * @return The estimated selectivity, from 0 to 1.
+ */
+double estimateSelectivity(SQLBooleanClauseTree* booleanClauseTree, int32 indexRs)
+{
+   TRACE("estimateSelectivity")
+   SQLBooleanClauseTree* leftTree = booleanClauseTree->leftTree;
+   SQLBooleanClauseTree* rightTree = booleanClauseTree->rightTree;
+   SQLBooleanClauseTree* columnTree;
+   SQLBooleanClauseTree* valueTree;
+   SQLResultSetField* field;
+   int32 operator = booleanClauseTree->operandType,
+         index,
+         type;
+   double left,
+          right,
+          key;
+
+   switch (operator)
+   {
+      case OP_BOOLEAN_AND:
+         return estimateSelectivity(leftTree, indexRs) * estimateSelectivity(rightTree, indexRs);
+      case OP_BOOLEAN_OR:
+         left = estimateSelectivity(leftTree, indexRs);
+         right = estimateSelectivity(rightTree, indexRs);
+         return left + right - left * right;
+      case OP_REL_EQUAL:
+      case OP_REL_DIFF:
+      case OP_REL_GREATER:
+      case OP_REL_LESS:
+      case OP_REL_GREATER_EQUAL:
+      case OP_REL_LESS_EQUAL:
+      case OP_PAT_MATCH_LIKE:
+      case OP_PAT_MATCH_NOT_LIKE:
+      case OP_PAT_IS:
+      case OP_PAT_IS_NOT:
+         if ((leftTree->operandType == OP_IDENTIFIER) == (rightTree->operandType == OP_IDENTIFIER))
+            return 1;
+         if (leftTree->operandType == OP_IDENTIFIER)
+         {
+            columnTree = leftTree;
+            valueTree = rightTree;
+         }
+         else
+         {
+            columnTree = rightTree;
+            valueTree = leftTree;
+            
+            // The comparison is seen from the column side.
+            if (operator == OP_REL_GREATER || operator == OP_REL_GREATER_EQUAL)
+               operator++;
+            else if (operator == OP_REL_LESS || operator == OP_REL_LESS_EQUAL)
+               operator--;
+         }
+         
+         if ((index = getFieldIndex(columnTree)) < 0 
+          || (field = booleanClauseTree->booleanClause->fieldList[index])->indexRs != indexRs || field->isDataTypeFunction 
+          || !field->table || !field->table->analyzedRowCount)
+            return 1;
+         if (operator == OP_PAT_MATCH_LIKE)
+            return valueTree->patternMatchType == PAT_MATCH_EQUAL? columnSelectivity(field->table, field->tableColIndex, OP_REL_EQUAL, null) 
+                                                                 : DEFAULT_RANGE_SELECTIVITY;
+         if (operator == OP_PAT_MATCH_NOT_LIKE)
+            return 1 - DEFAULT_RANGE_SELECTIVITY;
+         
+         // Only the numbers known when planning can be placed in the histogram.
+         type = valueTree->valueType;
+         if (type >= SHORT_TYPE && type <= DOUBLE_TYPE && type == field->table->columnTypes[field->tableColIndex] 
+          && (!valueTree->isParameter || valueTree->isParamValueDefined))
+         {
+            key = statisticsKey(&valueTree->operandValue, type);
+            return columnSelectivity(field->table, field->tableColIndex, operator, &key);
+         }
+         return columnSelectivity(field->table, field->tableColIndex, operator, null);
+   }
+   return 1;
+}
+
+/**
+ * Estimates the fraction of the rows of a table of the query found by the indices of the comparisons between its columns and constants joined to 
+ * the expression tree by <code>AND</code>s. The most selective index is taken.
+ *
+ * @param booleanClauseTree A pointer to a <code>SQLBooleanClauseTree</code> structure. 
+ * @param indexRs The index of the table in the table list of the query.
+ * @return The estimated selectivity of the best index, or 1 if no index can be used.
+ */
+double estimateIndexSelectivity(SQLBooleanClauseTree* booleanClauseTree, int32 indexRs)
+{
+   TRACE("estimateIndexSelectivity")
+   SQLBooleanClauseTree* leftTree = booleanClauseTree->leftTree;
+   SQLBooleanClauseTree* rightTree = booleanClauseTree->rightTree;
+   SQLBooleanClauseTree* columnTree;
+   SQLResultSetField* field;
+   int32 index;
+
+   switch (booleanClauseTree->operandType)
+   {
+      case OP_BOOLEAN_AND:
+         return MIN(estimateIndexSelectivity(leftTree, indexRs), estimateIndexSelectivity(rightTree, indexRs));
+      case OP_REL_EQUAL:
+      case OP_REL_GREATER:
+      case OP_REL_LESS:
+      case OP_REL_GREATER_EQUAL:
+      case OP_REL_LESS_EQUAL:
+         if ((leftTree->operandType == OP_IDENTIFIER) == (rightTree->operandType == OP_IDENTIFIER))
+            return 1;
+         columnTree = leftTree->operandType == OP_IDENTIFIER? leftTree : rightTree;
+         if ((index = getFieldIndex(columnTree)) < 0 
+          || (field = booleanClauseTree->booleanClause->fieldList[index])->indexRs != indexRs || field->isDataTypeFunction 
+          || !field->table || !field->table->columnIndexes[field->tableColIndex])
+            return 1;
+         if (field->table->analyzedRowCount)
+            return estimateSelectivity(booleanClauseTree, indexRs);
+         return booleanClauseTree->operandType == OP_REL_EQUAL? DEFAULT_EQUAL_SELECTIVITY : DEFAULT_RANGE_SELECTIVITY;
+   }
+   return 1;
+}
@@ -113,6 +113,17 @@ bool compareNullOperands(SQLBooleanClauseTree* booleanClauseTree);
  */
 int32 compareNumericOperands(Context context, SQLBooleanClauseTree* booleanClauseTree);
 
+/**
+ * Compares two numerical values already fetched for the operands of a comparison.
+ * 
+ * @param context The thread context where the function is being executed.
+ * @param booleanClauseTree A pointer to a <code>SQLBooleanClauseTree</code> structure. 
+ * @param leftValue The value of the left operand, which can't be null.
+ * @param rightValue The value of the right operand, which can't be null.
+ * @return The evaluation of the comparison expression or -1 if an error occurs.
+ */
+int32 compareNumericValues(Context context, SQLBooleanClauseTree* booleanClauseTree, SQLValue leftValue, SQLValue rightValue);
+
 /** 
  * Compares two strings using LIKE and NOT LIKE.
  * 
@@ -204,4 +215,24 @@ int32 getFieldIndex(SQLBooleanClauseTree* booleanClauseTree);
  */
 SQLBooleanClauseTree* cloneTree(SQLBooleanClauseTree* booleanClauseTree, SQLBooleanClauseTree* destTree, Heap heap);
 
+/**
+ * Estimates the fraction of the rows of a table of the query which satisfies an expression tree using the statistics of the table. The 
+ * comparisons which don't involve only a column of the table and a constant, and the tables that were not analyzed, don't restrict the rows. 
+ *
+ * @param booleanClauseTree A pointer to a <code>SQLBooleanClauseTree</code> structure. 
+ * @param indexRs The index of the table in the table list of the query.
+ * @return The estimated selectivity, from 0 to 1.
+ */
+double estimateSelectivity(SQLBooleanClauseTree* booleanClauseTree, int32 indexRs);
+
+/**
+ * Estimates the fraction of the rows of a table of the query found by the indices of the comparisons between its columns and constants joined to 
+ * the expression tree by <code>AND</code>s. The most selective index is taken.
+ *
+ * @param booleanClauseTree A pointer to a <code>SQLBooleanClauseTree</code> structure. 
+ * @param indexRs The index of the table in the table list of the query.
+ * @return The estimated selectivity of the best index, or 1 if no index can be used.
+ */
+double estimateIndexSelectivity(SQLBooleanClauseTree* booleanClauseTree, int32 indexRs);
+
 #endif
@@ -28,6 +28,7 @@ SQLSelectStatement* initSQLSelectStatement(LitebaseParser* parser, bool isPrepar
 	int32 count;
 
 	selectStmt->type = CMD_SELECT; // Sets the type of statement.
+	selectStmt->isExplain = parser->isExplain;
 	parser->select.heap = heap;
    
 	// Sets the select clause, its field list, and its hash table.
@@ -259,13 +260,15 @@ TCObject litebaseDoSelect(Context context, TCObject driver, SQLSelectStatement*
 			TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_CANT_READ), tableList[i]->tableName);
 			return null;
 		}
+      if (!tableBuildDeferredIndices(context, tableList[i]->table)) // The indices left out of date by bulk inserts must be rebuilt.
+         return null;
 	}
 
    // juliana@212_4: if the select fields are in the table order beginning with rowid, do not build a temporary table. 
    // juliana@230_14: removed temporary tables when there is no join, group by, order by, and aggregation.
 	// juliana@210_1: select * from table_name does not create a temporary table anymore.
 	if (!selectStmt->groupByClause && !selectStmt->havingClause && !selectStmt->orderByClause && !selectStmt->whereClause
-	 && selectClause->tableListSize == 1 && !selectClause->hasAggFunctions)
+	 && selectClause->tableListSize == 1 && !selectClause->hasAggFunctions && !selectStmt->isExplain)
 	{
 		isSimpleSelect = true;
 		rsBaseTable = (*tableList)->table;
@@ -273,16 +276,16 @@ TCObject litebaseDoSelect(Context context, TCObject driver, SQLSelectStatement*
 	}
 	else // Generates the result set and stores it in a temporary table if necessary.  
 	{
-		SQLResultSetField** fieldList = selectClause->fieldList;
-		int32 fieldListLen = selectClause->fieldsCount;
-		if (!(rsBaseTable = generateResultSetTable(context, driver, selectStmt))) // Temporary table.
+		// A query preceded by EXPLAIN returns its plan instead of its rows.
+		if (!(rsBaseTable = selectStmt->isExplain? createPlanTable(context, driver, selectStmt) 
+		                                         : generateResultSetTable(context, driver, selectStmt))) // Temporary table.
 			return null;
 
       if (!*rsBaseTable->name)
       {
          // Remaps the table column names to use the aliases of the select statement instead of the original column names.
 		   // Releases the unused memory (rowinc is 100 by default for result sets). This must be used only for temporary tables.
-         if (!remapColumnsNames2Aliases(context, rsBaseTable, fieldList, fieldListLen)
+         if (!remapColumnsNames2Aliases(context, rsBaseTable, selectClause->fieldList, selectClause->fieldsCount)
           || !plainShrinkToSize(context, &rsBaseTable->db)) // guich@201_9: always shrink the .db and .dbo memory files.
 		   {
 			   freeTable(context, rsBaseTable, false, true);
@@ -366,7 +369,9 @@ bool litebaseBindSelectStatement(Context context, TCObject driver, SQLSelectStat
  * Tries to put as inner table a table that has an index used more often in the where clause, when the where clause has a comparison between 
  * fields from different tables. e.g.: <code>select * from table1, table2 where table1.field1 = table2.field2 </code> If only 
  * <code>table1.field1</code> has index, changes the select to: <code>select * from table2, table1 where table1.field1 = table2.field2</code>. 
- * If both tables has the same level of index using, sorts them by the row count.
+ * If both tables has the same level of index using, sorts them by the row count. An inner table compared with an equality to a column without an 
+ * index has its keys looked up when the join starts, so the smaller tables are better as inner tables. If all the tables were analyzed and there
+ * are not too many of them, the order chosen is the one with the smallest estimated cost instead.
  *
  * @param selectStmt A SQL select statement.
  */
@@ -388,6 +393,7 @@ void orderTablesToJoin(SQLSelectStatement* selectStmt)
 			highest;
 	uint8 startedIndex[MAXIMUMS],
          changedTo[MAXIMUMS];
+   bool isAnalyzed = true;
   
 	if (size == 1) // size == 1 is not a join.
       return; 
@@ -397,33 +403,97 @@ void orderTablesToJoin(SQLSelectStatement* selectStmt)
    {
       tableList[i]->table->weight = 0;
       startedIndex[i] = changedTo[i] = i;
+      if (!tableList[i]->table->analyzedRowCount)
+         isAnalyzed = false;
    }
-	if (whereClause)
-		weightTheTree(whereClause->expressionTree);
-
-   i = size;
-	while (--i >= 0) // Reorders the tables according to the weight.
+   
+   if (whereClause && whereClause->expressionTree && size <= PLANNER_MAX_TABLES && isAnalyzed) // Compares the costs of all the orders.
    {
-      highest = -1;
-      tableAux1 = (rsTableAux1 = tableList[j = i])->table;
-      while (--j >= 0)
-         // juliana@238_2: improved join table reordering.
-         // Takes the table size into consideration.
-         if (tableAux1->weight > (tableAux2 = (rsTableAux2 = tableList[j])->table)->weight 
-          || (tableAux1->weight == tableAux2->weight && tableAux1->db.rowCount > tableAux2->db.rowCount))
+      SQLResultSetTable* aux[PLANNER_MAX_TABLES];
+      SQLBooleanClauseTree* tree = whereClause->expressionTree;
+      uint8 order[PLANNER_MAX_TABLES],
+            bestOrder[PLANNER_MAX_TABLES],
+            tables[MAXIMUMS + 1],
+            columns[MAXIMUMS + 1];
+      double filters[PLANNER_MAX_TABLES],
+             indexFilters[PLANNER_MAX_TABLES],
+             bestCost = -1,
+             cost;
+      int32 count = collectJoinEqualities(tree, tables, columns, 0);
+      
+      i = size;
+      while (--i >= 0)
+      {
+         aux[i] = tableList[i];
+         order[i] = bestOrder[i] = i;
+         filters[i] = estimateSelectivity(tree, i);
+         indexFilters[i] = estimateIndexSelectivity(tree, i);
+      }
+      
+      while (true) // Goes through the orders in lexicographic order.
+      {
+         cost = estimateJoinCost(aux, order, size, filters, indexFilters, tables, columns, count, bestCost, null, null, null);
+         if (bestCost < 0 || cost < bestCost)
+         {
+            bestCost = cost;
+            xmemmove(bestOrder, order, size);
+         }
+         
+         // Finds the next order.
+         i = size - 1;
+         while (--i >= 0 && order[i] > order[i + 1]);
+         if (i < 0)
+            break;
+         j = size;
+         while (order[--j] < order[i]);
+         k = order[i];
+         order[i] = order[j];
+         order[j] = k;
+         j = size;
+         while (++i < --j)
          {
-            rsTableAux1 = rsTableAux2;
-            highest = j;
+            k = order[i];
+            order[i] = order[j];
+            order[j] = k;
          }
+      }
+      
+      i = size;
+      while (--i >= 0)
+      {
+         tableList[i] = aux[bestOrder[i]];
+         changedTo[bestOrder[i]] = i;
+      }
+   }
+   else
+   {
+	   if (whereClause)
+		   weightTheTree(whereClause->expressionTree);
 
-      if (highest != -1) // Changes table order.
+      i = size;
+	   while (--i >= 0) // Reorders the tables according to the weight.
       {
-         tableList[highest] = tableList[i];
-         tableList[i] = rsTableAux1;
-         changedTo[startedIndex[highest]] = i;
-         changedTo[k = startedIndex[i]] = highest;
-         startedIndex[i] = startedIndex[highest];
-         startedIndex[highest] = k;
+         highest = -1;
+         tableAux1 = (rsTableAux1 = tableList[j = i])->table;
+         while (--j >= 0)
+            // juliana@238_2: improved join table reordering.
+            // Takes the table size into consideration.
+            if (tableAux1->weight > (tableAux2 = (rsTableAux2 = tableList[j])->table)->weight 
+             || (tableAux1->weight == tableAux2->weight && tableAux1->db.rowCount > tableAux2->db.rowCount))
+            {
+               rsTableAux1 = rsTableAux2;
+               highest = j;
+            }
+
+         if (highest != -1) // Changes table order.
+         {
+            tableList[highest] = tableList[i];
+            tableList[i] = rsTableAux1;
+            changedTo[startedIndex[highest]] = i;
+            changedTo[k = startedIndex[i]] = highest;
+            startedIndex[i] = startedIndex[highest];
+            startedIndex[highest] = k;
+         }
       }
    }
    if (whereClause) // Rearranges the indexRs of the where clause field list.
@@ -434,6 +504,178 @@ void orderTablesToJoin(SQLSelectStatement* selectStmt)
 	}
 }
 
+/**
+ * Collects the equalities between columns of different tables which are joined to the where clause by <code>AND</code>s. 
+ *
+ * @param tree The expression tree of the where clause or one of its branches.
+ * @param tables Receives the indices of the tables of the two sides of each equality in the table list.
+ * @param columns Receives the columns of the two sides of each equality.
+ * @param count The number of equalities already collected.
+ * @return The number of equalities collected.
+ */
+int32 collectJoinEqualities(SQLBooleanClauseTree* tree, uint8* tables, uint8* columns, int32 count)
+{
+   TRACE("collectJoinEqualities")
+   SQLBooleanClauseTree* leftTree = tree->leftTree;
+   SQLBooleanClauseTree* rightTree = tree->rightTree;
+
+   if (tree->operandType == OP_BOOLEAN_AND)
+   {
+      if (leftTree)
+         count = collectJoinEqualities(leftTree, tables, columns, count);
+      if (rightTree)
+         count = collectJoinEqualities(rightTree, tables, columns, count);
+   }
+   else if (tree->operandType == OP_REL_EQUAL && leftTree->operandType == OP_IDENTIFIER && rightTree->operandType == OP_IDENTIFIER 
+         && count < (MAXIMUMS + 1) >> 1)
+   {
+      SQLResultSetField** fieldList = tree->booleanClause->fieldList;
+      int32 leftIndex = getFieldIndex(leftTree),
+            rightIndex = getFieldIndex(rightTree);
+      SQLResultSetField* leftField;
+      SQLResultSetField* rightField;
+
+      if (leftIndex < 0 || rightIndex < 0 || (leftField = fieldList[leftIndex])->isDataTypeFunction
+       || (rightField = fieldList[rightIndex])->isDataTypeFunction || leftField->indexRs == rightField->indexRs)
+         return count;
+      tables[count << 1] = leftField->indexRs;
+      columns[count << 1] = leftField->tableColIndex;
+      tables[(count << 1) + 1] = rightField->indexRs;
+      columns[(count << 1) + 1] = rightField->tableColIndex;
+      count++;
+   }
+   return count;
+}
+
+/**
+ * Estimates the cost of a join with its tables in a given order, which is the estimated number of rows and index nodes read. The first table is 
+ * scanned or, if an index of a comparison with a constant is selective enough, read through it. Each inner table is read through an index of an 
+ * equality with a table before it, through the sorted keys of such an equality, or by a scan for each row of the tables before it.
+ *
+ * @param tableList The tables of the join.
+ * @param order The order of the tables, from the outer to the innermost one.
+ * @param size The number of tables.
+ * @param filters The estimated selectivity of the where clause for each table.
+ * @param indexFilters The estimated selectivity of the best index of the where clause for each table.
+ * @param tables The indices of the tables of the two sides of each equality between tables.
+ * @param columns The columns of the two sides of each equality between tables.
+ * @param count The number of equalities.
+ * @param bound The cost above which the estimate can stop, or a negative value to compute the whole cost.
+ * @param access Receives how each table is read, if not <code>null</code>.
+ * @param rows Receives the estimated number of rows after each table is joined, if not <code>null</code>.
+ * @param costs Receives the estimated cost after each table is joined, if not <code>null</code>.
+ * @return The estimated cost, which may be partial if it is above the bound.
+ */
+double estimateJoinCost(SQLResultSetTable** tableList, uint8* order, int32 size, double* filters, double* indexFilters, uint8* tables, 
+                                                        uint8* columns, int32 count, double bound, uint8* access, double* rows, double* costs)
+{
+   TRACE("estimateJoinCost")
+   Table* table;
+   uint8 placed[MAXIMUMS];
+   int32 position = -1,
+         current,
+         other,
+         plan,
+         i;
+   double cost = 0,
+          total = 0,
+          number,
+          depth,
+          selectivity,
+          matches,
+          distinct;
+
+   xmemzero(placed, size);
+   while (++position < size)
+   {
+      table = tableList[current = order[position]]->table;
+      number = MAX(1, table->db.rowCount - table->deletedRowsCount);
+      depth = 1;
+      while ((1 << (int32)depth) < number && depth < 31) // The height of an index of the table.
+         depth++;
+      
+      if (!position)
+      {
+         if (indexFilters[current] <= INDEX_MAX_SELECTIVITY)
+         {
+            plan = PLAN_INDEX;
+            cost = depth + number * indexFilters[current];
+         }
+         else
+         {
+            plan = PLAN_SCAN;
+            cost = number;
+         }
+         total = number * filters[current];
+      }
+      else
+      {
+         plan = PLAN_SCAN;
+         selectivity = 1;
+         i = count;
+         while (--i >= 0) // Finds the equalities with the tables already joined.
+         {
+            if (tables[i << 1] == current && placed[tables[(i << 1) + 1]])
+            {
+               other = (i << 1) + 1;
+               if (table->columnIndexes[columns[i << 1]])
+                  plan = PLAN_JOIN_INDEX;
+               else if (plan == PLAN_SCAN)
+                  plan = PLAN_JOIN_KEYS;
+               distinct = statisticsDistinct(table, columns[i << 1]);
+            }
+            else if (tables[(i << 1) + 1] == current && placed[tables[i << 1]])
+            {
+               other = i << 1;
+               if (table->columnIndexes[columns[(i << 1) + 1]])
+                  plan = PLAN_JOIN_INDEX;
+               else if (plan == PLAN_SCAN)
+                  plan = PLAN_JOIN_KEYS;
+               distinct = statisticsDistinct(table, columns[(i << 1) + 1]);
+            }
+            else
+               continue;
+            selectivity /= MAX(distinct, statisticsDistinct(tableList[tables[other]]->table, columns[other]));
+         }
+         
+         matches = number * selectivity;
+         if (plan == PLAN_JOIN_INDEX)
+            cost += total * (depth + 1 + matches);
+         else if (plan == PLAN_JOIN_KEYS)
+            cost += number * depth + total * (1 + matches);
+         else
+            cost += total * number;
+         total *= matches * filters[current];
+      }
+      
+      placed[current] = true;
+      if (access)
+      {
+         access[position] = plan;
+         rows[position] = total;
+         costs[position] = cost;
+      }
+      if (bound >= 0 && cost > bound)
+         break;
+   }
+   return cost;
+}
+
+/**
+ * Gets the number of distinct values of a column used to estimate the rows of a join. A column of a table not analyzed is taken as a key.
+ *
+ * @param table The table.
+ * @param column The column.
+ * @return The estimated number of distinct values, which is at least 1.
+ */
+double statisticsDistinct(Table* table, int32 column)
+{
+   TRACE("statisticsDistinct")
+   if (table->analyzedRowCount)
+      return MAX(1, table->columnStatistics[column].distinctCount);
+   return MAX(1, table->db.rowCount - table->deletedRowsCount);
+}
+
 /**
  * Binds the SQLSelectStatement to the select clause tables.
  *
@@ -825,6 +1067,33 @@ Table* generateResultSetTable(Context context, TCObject driver, SQLSelectStateme
       if (sortListClause && ((whereClause && whereClause->expressionTree) || selectClause->hasAggFunctions || numTables != 1))
          sortListClause->index = -1;
 
+      // A GROUP BY of a single table is aggregated in memory if its groups fit in the budget. Otherwise, its rows are written to a temporary table
+      // which is sorted.
+      if (groupByClause && numTables == 1 && sortListClause->index == -1)
+      {
+         if (!hashGroupBy(context, driver, selectStmt, rsTemp, aggFunctionsCodes, aggFunctionsParamCols, aggFunctionsColsCount, &tempTable2, heap))
+            goto error;
+         if (tempTable2)
+         {
+            if (!havingClause || !tempTable2->db.rowCount)
+            {
+               heapDestroy(heap);
+               return tempTable2;
+            }
+
+            // The HAVING clause uses the types and aliases of the select clause.
+            i = size = selectFieldsCount;
+            fieldList = selectClause->fieldList;
+            while (--i >= 0)
+            {
+               columnTypes[i] = (field = fieldList[i])->dataType;
+               columnSizes[i] = field->size;
+               columnHashes[i] = field->aliasHashCode;
+            }
+            goto having;
+         }
+      }
+
       // juliana@230_14: removed temporary tables when there is no join, group by, order by, and aggregation.
       if ((sortListClause && sortListClause->index == -1) || countQueryWithWhere || numTables != 1)
       {
@@ -1222,6 +1491,7 @@ Table* generateResultSetTable(Context context, TCObject driver, SQLSelectStateme
 		return tempTable2;
    }
 
+having:
    heap_3 = heapCreate();
    IF_HEAP_ERROR(heap_3)
    { 
@@ -1273,6 +1543,293 @@ error:
    return null;
 }
 
+/**
+ * Aggregates the groups of a GROUP BY of a single table in a hash table in memory, so that the rows don't need to be written to a temporary table 
+ * and sorted. Each group keeps the running totals of its aggregated functions and is found by a key built as a sort key of the sort fields. The 
+ * groups are then sorted by their keys and written to the result table. If the groups do not fit in the budget, the aggregation is given up.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param selectStmt The select statement.
+ * @param resultSet The result set of the table, using the WHERE clause.
+ * @param aggFunctionsCodes The codes of the aggregated functions.
+ * @param aggFunctionsParamCols The columns of the select clause that are aggregated functions.
+ * @param aggFunctionsColsCount The number of aggregated functions.
+ * @param table Receives the result table or <code>null</code> if the groups don't fit in the budget.
+ * @param heap A heap to perform some memory allocations.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+bool hashGroupBy(Context context, TCObject driver, SQLSelectStatement* selectStmt, ResultSet* resultSet, int8* aggFunctionsCodes, 
+                                                  int32* aggFunctionsParamCols, int32 aggFunctionsColsCount, Table** table, Heap heap)
+{
+   TRACE("hashGroupBy")
+   SQLSelectClause* selectClause = selectStmt->selectClause;
+   SQLColumnListClause* sortListClause = selectStmt->orderByClause? selectStmt->orderByClause : selectStmt->groupByClause;
+   SQLResultSetField** fieldList = selectClause->fieldList;
+   SQLResultSetField** sortList = sortListClause->fieldList;
+   SQLResultSetField* field;
+   SQLResultSetField* param;
+   Table* rsTable = resultSet->table;
+   Table* tempTable = null;
+   PlainDB* plainDB;
+   HashGroup* group;
+   HashGroup** buckets = null;
+   HashGroup** newBuckets;
+   uint8** keys = null;
+   uint8** newKeys;
+   SQLValue** values;
+   SQLValue** record;
+   int8* types = rsTable->columnTypes;
+   int32* sizes = rsTable->columnSizes;
+   uint8* nulls = rsTable->columnNulls;
+   uint8* buffer = rsTable->db.basbuf + rsTable->columnOffsets[rsTable->columnCount];
+   uint8* key;
+   uint8* block;
+   int8 columnTypes[MAXIMUMS];
+   uint8 isRead[NUMBEROFBYTES(MAXIMUMS + 1)];
+   int32 columnHashes[MAXIMUMS],
+         columnSizes[MAXIMUMS],
+         sortColumns[MAXIMUMS],
+         selectColumns[MAXIMUMS],
+         realParamCols[MAXIMUMS],
+         charsSizes[MAXIMUMS];
+   int32 fieldsCount = selectClause->fieldsCount,
+         sortCount = sortListClause->fieldsCount,
+         columnCount = rsTable->columnCount,
+         nullsSize = NUMBEROFBYTES(fieldsCount),
+         keySize = 0,
+         groupSize,
+         groupsCount = 0,
+         keysLength = GROUP_BY_BUCKETS,
+         mask = GROUP_BY_BUCKETS - 1,
+         budget = GROUP_BY_BUDGET,
+         column,
+         i,
+         j;
+   uint32 hash;
+   bool ret = false;
+   Heap groupsHeap = heapCreate(),
+        tableHeap = null;
+
+   IF_HEAP_ERROR(groupsHeap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto finish;
+   }
+
+   // Each row reads only its sort fields, the selected columns, and the parameters of the aggregated functions.
+   xmemzero(isRead, sizeof(isRead));
+   i = sortCount;
+   while (--i >= 0)
+   {
+      column = sortColumns[i] = TC_htGet32(&rsTable->htName2index, sortList[i]->tableColHashCode);
+      setBitOn(isRead, column);
+      keySize += (types[column] == CHARS_TYPE || types[column] == CHARS_NOCASE_TYPE)? 3 + (sizes[column] << 1) : 1 + typeSizes[types[column]];
+   }
+   groupSize = sizeof(HashGroup) + ((keySize + 7) & ~7) + (fieldsCount + aggFunctionsColsCount) * sizeof(SQLValue) + (aggFunctionsColsCount << 2) 
+                                                                                                                   + nullsSize;
+   i = fieldsCount;
+   while (--i >= 0)
+   {
+      columnHashes[i] = (field = fieldList[i])->aliasHashCode;
+      columnTypes[i] = field->dataType;
+      columnSizes[i] = field->size;
+      if (!field->isAggregatedFunction)
+      {
+         selectColumns[i] = field->tableColIndex;
+         setBitOn(isRead, field->tableColIndex);
+      }
+   }
+   i = aggFunctionsColsCount;
+   while (--i >= 0)
+   {
+      charsSizes[i] = 0;
+      if ((param = fieldList[aggFunctionsParamCols[i]]->parameter))
+      {
+         realParamCols[i] = param->tableColIndex;
+         setBitOn(isRead, param->tableColIndex);
+         if (sizes[param->tableColIndex]) // The MAX() and MIN() of strings keep their values in the groups.
+            groupSize += charsSizes[i] = (sizes[param->tableColIndex] << 1) + 2;
+      }
+      else
+         realParamCols[i] = -1;
+   }
+
+   values = (SQLValue**)TC_heapAlloc(groupsHeap, columnCount * TSIZE);
+   i = columnCount;
+   while (--i >= 0)
+      if (isBitSet(isRead, i))
+      {
+         values[i] = (SQLValue*)TC_heapAlloc(groupsHeap, sizeof(SQLValue));
+         if (types[i] == CHARS_TYPE || types[i] == CHARS_NOCASE_TYPE)
+            values[i]->asChars = (JCharP)TC_heapAlloc(groupsHeap, (sizes[i] << 1) + 2);
+      }
+   key = (uint8*)TC_heapAlloc(groupsHeap, keySize);
+   
+   if (!(buckets = (HashGroup**)xmalloc(GROUP_BY_BUCKETS * TSIZE)) || !(keys = (uint8**)xmalloc(keysLength * TSIZE)))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto finish;
+   }
+
+   resultSet->pos = -1;
+   while (getNextRecord(context, resultSet, heap))
+   {
+      xmemmove(nulls, buffer, NUMBEROFBYTES(columnCount)); // Reads the bytes of the nulls.
+      i = columnCount;
+      while (--i >= 0)
+         if (isBitSet(isRead, i) && isBitUnSet(nulls, i) && !getTableColValue(context, resultSet, i, values[i]))
+            goto finish;
+
+      // Finds the group of the row by its key.
+      block = key;
+      i = -1;
+      while (++i < sortCount)
+      {
+         column = sortColumns[i];
+         block = putSortKeyValue(block, values[column], types[column], sizes[column], isBitSet(nulls, column), sortList[i]->isAscending);
+      }
+      hash = 0;
+      i = keySize;
+      while (--i >= 0)
+         hash = 31 * hash + key[i];
+      group = buckets[(hash *= 0x9E3779B1) & mask]; // Spreads the keys over the buckets.
+      while (group && (group->hash != hash || xmemcmp(group + 1, key, keySize)))
+         group = group->next;
+
+      if (!group) // A new group.
+      {
+         if ((budget -= groupSize + (TSIZE << 2)) < 0) // The groups don't fit in the budget: the rows will be sorted instead.
+         {
+            ret = true;
+            goto finish;
+         }
+
+         // The key, the values, the running totals, and the nulls of the group are allocated at once after the structure.
+         group = (HashGroup*)(block = (uint8*)TC_heapAlloc(groupsHeap, groupSize));
+         xmemmove(block += sizeof(HashGroup), key, keySize);
+         group->values = (SQLValue*)(block += (keySize + 7) & ~7);
+         group->runTotals = (SQLValue*)(block += fieldsCount * sizeof(SQLValue));
+         group->groupCountCols = (int32*)(block += aggFunctionsColsCount * sizeof(SQLValue));
+         block += aggFunctionsColsCount << 2;
+         i = aggFunctionsColsCount;
+         while (--i >= 0)
+            if (charsSizes[i])
+            {
+               group->runTotals[i].asChars = (JCharP)block;
+               block += charsSizes[i];
+            }
+         group->nulls = block;
+         i = fieldsCount;
+         while (--i >= 0)
+            if (!fieldList[i]->isAggregatedFunction)
+            {
+               // Strings are not loaded in the result table: only their positions and tables are needed.
+               xmemmove(&group->values[i], values[column = selectColumns[i]], sizeof(SQLValue));
+               setBit(group->nulls, i, isBitSet(nulls, column));
+            }
+
+         group->next = buckets[(group->hash = hash) & mask];
+         buckets[hash & mask] = group;
+         if (groupsCount == keysLength)
+         {
+            if (!(newKeys = (uint8**)xrealloc((uint8*)keys, (keysLength <<= 1) * TSIZE)))
+            {
+               TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+               goto finish;
+            }
+            keys = newKeys;
+         }
+         keys[groupsCount++] = (uint8*)(group + 1);
+
+         if (groupsCount > mask) // Doubles the number of buckets.
+         {
+            if (!(newBuckets = (HashGroup**)xmalloc(((mask + 1) << 1) * TSIZE)))
+            {
+               TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+               goto finish;
+            }
+            mask = (mask << 1) + 1;
+            i = groupsCount;
+            while (--i >= 0)
+            {
+               group = ((HashGroup*)keys[i]) - 1;
+               group->next = newBuckets[group->hash & mask];
+               newBuckets[group->hash & mask] = group;
+            }
+            xfree(buckets);
+            buckets = newBuckets;
+            group = ((HashGroup*)keys[groupsCount - 1]) - 1;
+         }
+      }
+
+      group->rowsCount++;
+      performAggFunctionsCalc(context, values, nulls, group->runTotals, aggFunctionsCodes, realParamCols, aggFunctionsColsCount, types, 
+                                                                                                               group->groupCountCols);
+   }
+
+   // Creates the result table and writes the groups in the order of their keys.
+   tableHeap = heapCreate();
+   IF_HEAP_ERROR(tableHeap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto finish;
+   }
+   tableHeap->greedyAlloc = true;
+   if (!(tempTable = driverCreateTable(context, driver, null, null, duplicateIntArray(columnHashes, fieldsCount, tableHeap), 
+                                       duplicateByteArray(columnTypes, fieldsCount, tableHeap), 
+                                       duplicateIntArray(columnSizes, fieldsCount, tableHeap), null, null, NO_PRIMARY_KEY, NO_PRIMARY_KEY, null, 0, 
+                                                                                                                          fieldsCount, tableHeap)))
+      goto finish;
+   tableHeap = null;
+   plainDB = &tempTable->db;
+   if (!mfGrowTo(context, &plainDB->db, (plainDB->rowAvail = groupsCount + 1) * plainDB->rowSize))
+      goto finish;
+
+   record = (SQLValue**)TC_heapAlloc(groupsHeap, fieldsCount * TSIZE);
+   j = aggFunctionsColsCount;
+   while (--j >= 0)
+   {
+      record[i = aggFunctionsParamCols[j]] = (SQLValue*)TC_heapAlloc(groupsHeap, sizeof(SQLValue));
+      if (charsSizes[j])
+         record[i]->asChars = (JCharP)TC_heapAlloc(groupsHeap, charsSizes[j]);
+   }
+
+   sortTableKeys(keys, groupsCount, keySize);
+   j = -1;
+   while (++j < groupsCount)
+   {
+      group = ((HashGroup*)keys[j]) - 1;
+      i = fieldsCount;
+      while (--i >= 0)
+         if (!fieldList[i]->isAggregatedFunction)
+            record[i] = &group->values[i];
+      endAggFunctionsCalc(record, group->rowsCount, group->runTotals, aggFunctionsCodes, aggFunctionsParamCols, realParamCols, aggFunctionsColsCount, 
+                                                                                                                       types, group->groupCountCols);
+      
+      // Takes the null values for the non-aggregate fields into consideration.
+      xmemmove(tempTable->columnNulls, group->nulls, nullsSize);
+      i = aggFunctionsColsCount;
+      while (--i >= 0)
+         setBit(tempTable->columnNulls, aggFunctionsParamCols[i], !group->groupCountCols[i]);
+      if (!writeRSRecord(context, tempTable, record))
+         goto finish;
+   }
+   *table = tempTable;
+   tempTable = null;
+   ret = true;
+
+finish:
+   if (tempTable)
+      freeTable(context, tempTable, false, false);
+   heapDestroy(tableHeap);
+   heapDestroy(groupsHeap);
+   xfree(keys);
+   xfree(buckets);
+   return ret;
+}
+
 /**
  * Generates a table to store the result set.
  *
@@ -1308,6 +1865,11 @@ bool createListResultSetForSelect(Context context, SQLResultSetTable** tableList
          setIndexRsOnTree((*rsList)->whereClause->expressionTree);
       if (!generateIndexedRowsMap(context, rsList, size, hasComposedIndex, heap))
          return false;
+      
+      // The remaining equalities between columns without indices can look up the inner rows instead of scanning them.
+      if (size > 1 && (whereClause = (*rsList)->whereClause) && whereClause->expressionTree 
+       && whereClause->appliedIndexesBooleanOp != OP_BOOLEAN_OR)
+         planJoinKeys(whereClause->expressionTree, rsList, heap);
    }
    return true;
 }
@@ -1349,7 +1911,7 @@ bool generateIndexedRowsMap(Context context, ResultSet** rsList, int32 size, boo
 		} 
 		else
          if (!applyTableIndexes(whereClause, table->columnIndexes, table->columnCount, hasComposedIndex))
-				return true;
+				return !table->columnTrigrams || applyTrigramIndexes(context, rsBag, whereClause->expressionTree, heap);
  
       count = whereClause->appliedIndexesCount;
       appliedComposedIndexes = whereClause->appliedComposedIndexes;
@@ -1365,6 +1927,11 @@ bool generateIndexedRowsMap(Context context, ResultSet** rsList, int32 size, boo
 
       if (!computeIndex(context, rsList, size, size > 1, -1, null, -1, -1, heap))
          return false;
+
+      // The rows found by the other indices can only be narrowed by the trigram indices if they are ANDed with the remaining clause.
+      if (size == 1 && table->columnTrigrams && whereClause->expressionTree && rsBag->rowsBitmapBoolOp == OP_BOOLEAN_AND
+       && !applyTrigramIndexes(context, rsBag, whereClause->expressionTree, heap))
+         return false;
  
       if (!whereClause->expressionTree)
          while (--size >= 0) // There is no where clause left, since all rows can be returned using the indexes.
@@ -1373,6 +1940,80 @@ bool generateIndexedRowsMap(Context context, ResultSet** rsList, int32 size, boo
    return true;
 }
 
+/**
+ * Narrows the rows of a result set using the trigram indices of the columns compared with <code>LIKE</code> to a pattern with at least three 
+ * characters in a row. The candidate rows are the ones that have all the trigrams of the pattern, and the <code>LIKE</code> is kept in the where 
+ * clause to discard the ones that don't match it.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of a table with trigram indices.
+ * @param tree The remaining expression tree of the where clause, whose <code>AND</code>ed branches are searched for <code>LIKE</code>s.
+ * @param heap A heap to allocate the bitmaps.
+ * @return <code>true</code> if the function executed correctly; <code>false</code>, otherwise.
+ */
+bool applyTrigramIndexes(Context context, ResultSet* resultSet, SQLBooleanClauseTree* tree, Heap heap)
+{
+   TRACE("applyTrigramIndexes")
+   IntVector* rowsBitmap = &resultSet->rowsBitmap;
+   SQLBooleanClause* whereClause = resultSet->whereClause;
+   SQLResultSetField** fieldList = whereClause->fieldList;
+   SQLBooleanClauseTree* leftTree;
+   SQLBooleanClauseTree* rightTree;
+   Index* index;
+   IntVector bitmap;
+   MarkBits markBits;
+   SQLValue trigram;
+   int32 trigrams[TRIGRAM_BUFFER_SIZE];
+   int32 i = whereClause->fieldsCount,
+         count;
+   uint8 operator = OP_REL_EQUAL;
+   bool isFirst;
+
+   if (!tree)
+      return true;
+   if (tree->operandType == OP_BOOLEAN_AND) // Both sides of an AND can narrow the rows.
+      return applyTrigramIndexes(context, resultSet, tree->leftTree, heap) && applyTrigramIndexes(context, resultSet, tree->rightTree, heap);
+
+   // Only a LIKE of a column with a trigram index with a pattern that has a trigram can use the index.
+   if (tree->operandType != OP_PAT_MATCH_LIKE || (leftTree = tree->leftTree)->operandType != OP_IDENTIFIER 
+    || (rightTree = tree->rightTree)->operandType == OP_IDENTIFIER || !(index = resultSet->table->columnTrigrams[leftTree->colIndex])
+    || rightTree->lenToMatch < 3 || (rightTree->patternMatchType != PAT_MATCH_CONTAINS && rightTree->patternMatchType != PAT_MATCH_ENDS_WITH 
+                                  && rightTree->patternMatchType != PAT_MATCH_STARTS_WITH))
+      return true;
+   while (--i >= 0) // An index cannot be applied to a function in the where clause.
+      if (fieldList[i]->tableColIndex == leftTree->colIndex && fieldList[i]->isDataTypeFunction) 
+         return true;
+
+   // The trigrams of the beginning of a long pattern are enough to select the candidate rows.
+   count = computeTrigrams(rightTree->strToMatch, MIN(rightTree->lenToMatch, TRIGRAM_BUFFER_SIZE + 2), trigrams);
+
+   xmemzero(&markBits, sizeof(MarkBits));
+   xmemzero(&trigram, sizeof(SQLValue));
+   markBits.leftKey.keys = &trigram;
+   markBits.leftOp = markBits.rightOp = &operator;
+   bitmap = newIntBits(resultSet->table->db.rowCount, heap);
+   if ((isFirst = !rowsBitmap->size)) // No other index was applied.
+   {
+      *rowsBitmap = newIntBits(resultSet->table->db.rowCount, heap);
+      resultSet->rowsBitmapBoolOp = OP_BOOLEAN_AND;
+   }
+
+   while (--count >= 0) // The rows must have all the trigrams of the pattern.
+   {
+      markBitsReset(&markBits, isFirst? rowsBitmap : &bitmap);
+      trigram.asInt = trigrams[count];
+      markBits.leftKey.index = index;
+      markBits.leftKey.record = NO_VALUE;
+      if (!indexGetValue(context, &markBits.leftKey, &markBits))
+         return false;
+      if (isFirst)
+         isFirst = false;
+      else
+         mergeBitmaps(rowsBitmap, &bitmap, OP_BOOLEAN_AND);
+   }
+   return true;
+}
+
 /**
  * Finds the rows that satisfy the query clause using the indices.
  *
@@ -1771,6 +2412,130 @@ Table* createIntValueTable(Context context, TCObject driver, int32 intValue, Cha
    return null;
 }
 
+/**
+ * Creates a temporary table with the plan of a query preceded by <code>EXPLAIN</code>. It has a row for each table of the query in the order they
+ * are joined, with how its rows are read and the estimated number of rows and cost after it is joined. The fields of the select clause are 
+ * replaced by the columns of the plan.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param selectStmt A SQL select statement.
+ * @return The table if the method executes correctlty; <code>null</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enougth memory alloc memory. 
+ */
+Table* createPlanTable(Context context, TCObject driver, SQLSelectStatement* selectStmt)
+{
+   TRACE("createPlanTable")
+   SQLSelectClause* selectClause = selectStmt->selectClause;
+   SQLResultSetTable** tableList = selectClause->tableList;
+   SQLBooleanClauseTree* tree = selectStmt->whereClause? selectStmt->whereClause->expressionTree : null;
+   SQLResultSetField** fieldList;
+   SQLResultSetField* field;
+   Table* table = null;
+   SQLValue values[4];
+   SQLValue* record[4];
+   CharP names[] = {"table", "access", "rows", "cost"};
+   CharP accessNames[] = {"scan", "index", "join index", "join keys"};
+   int8* types;
+   int32* hashes;
+   int32* sizes;
+   int32 size = selectClause->tableListSize,
+         count = 0,
+         i = size;
+   uint8* order;
+   uint8* access;
+   uint8 tables[MAXIMUMS + 1],
+         columns[MAXIMUMS + 1];
+   double* filters;
+   double* indexFilters;
+   double* rows;
+   double* costs;
+   bool written;
+   Heap selectHeap = selectClause->heap,
+        heap = heapCreate();
+   
+   IF_HEAP_ERROR(heap)
+   {
+      heapDestroy(heap);
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return null;
+   }
+   
+   // Estimates the plan of the tables in the order they will be joined.
+   order = (uint8*)TC_heapAlloc(heap, size);
+   access = (uint8*)TC_heapAlloc(heap, size);
+   filters = (double*)TC_heapAlloc(heap, size << 3);
+   indexFilters = (double*)TC_heapAlloc(heap, size << 3);
+   rows = (double*)TC_heapAlloc(heap, size << 3);
+   costs = (double*)TC_heapAlloc(heap, size << 3);
+   if (tree)
+      count = collectJoinEqualities(tree, tables, columns, 0);
+   while (--i >= 0)
+   {
+      order[i] = i;
+      filters[i] = tree? estimateSelectivity(tree, i) : 1;
+      indexFilters[i] = tree? estimateIndexSelectivity(tree, i) : 1;
+   }
+   estimateJoinCost(tableList, order, size, filters, indexFilters, tables, columns, count, -1, access, rows, costs);
+   
+   // The columns of the plan.
+   hashes = (int32*)TC_heapAlloc(heap, 16);
+   types = (int8*)TC_heapAlloc(heap, 4);
+   sizes = (int32*)TC_heapAlloc(heap, 16);
+   types[0] = types[1] = CHARS_TYPE;
+   types[2] = INT_TYPE;
+   types[3] = DOUBLE_TYPE;
+   sizes[1] = 10;
+   i = size;
+   while (--i >= 0)
+      sizes[0] = MAX(sizes[0], (int32)xstrlen(tableList[i]->tableName));
+   
+   fieldList = (SQLResultSetField**)TC_heapAlloc(selectHeap, 4 * TSIZE);
+   selectClause->htName2index = TC_htNew(4, selectHeap);
+   i = 4;
+   while (--i >= 0)
+   {
+      field = fieldList[i] = (SQLResultSetField*)TC_heapAlloc(selectHeap, sizeof(SQLResultSetField));
+      field->alias = field->tableColName = names[i];
+      field->aliasHashCode = field->tableColHashCode = hashes[i] = TC_hashCode(names[i]);
+      field->dataType = types[i];
+      field->size = sizes[i];
+      field->tableColIndex = i;
+      TC_htPut32(&selectClause->htName2index, hashes[i], i);
+      record[i] = &values[i];
+   }
+   selectClause->fieldList = fieldList;
+   selectClause->fieldsCount = 4;
+   
+   // juliana@223_14: solved possible memory problems.
+   if (!(table = driverCreateTable(context, driver, null, null, hashes, types, sizes, null, null, NO_PRIMARY_KEY, NO_PRIMARY_KEY, null, 0, 4, heap)))
+   {
+      heapDestroy(heap);
+      return null;
+   }
+   
+   i = -1;
+   while (++i < size) // Writes a row for each table.
+   {
+      xmemzero(values, sizeof(values));
+      values[0].asChars = TC_CharP2JCharP(tableList[i]->tableName, values[0].length = xstrlen(tableList[i]->tableName));
+      values[1].asChars = TC_CharP2JCharP(accessNames[access[i]], values[1].length = xstrlen(accessNames[access[i]]));
+      values[2].asInt = (int32)MIN(rows[i], 0x7FFFFFFF);
+      values[3].asDouble = costs[i];
+      written = values[0].asChars && values[1].asChars && writeRSRecord(context, table, record);
+      xfree(values[0].asChars);
+      xfree(values[1].asChars);
+      if (!written)
+      {
+         if (!context->thrownException)
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+         freeTable(context, table, false, true);
+         return null;
+      }
+   }
+   return table;
+}
+
 /** 
  * Binds the column information of the underlying tables to the select clause. 
  *
@@ -2283,6 +3048,12 @@ int32 performJoin(Context context, ResultSet** list, int32 numTables, Table* tab
          values[length]->asChars = (JCharP)TC_heapAlloc(heap, (sizes[length] << 1) + 2);
    }
 
+   // Builds the lookups of the inner tables before the join starts, since a self join shares the row buffer.
+   rsCount = numTables;
+   while (--rsCount >= 0)
+      if (list[rsCount]->joinKeys && !buildJoinKeys(context, list[rsCount], heap))
+         goto error;
+
    while (currentIndexTable >= 0)
    {
       currentRs = list[currentIndexTable];
@@ -2308,7 +3079,7 @@ int32 performJoin(Context context, ResultSet** list, int32 numTables, Table* tab
 
                // If it is null, just skips.
                if ((colIndex != -1) && !bitSet && !getTableColValue(context, currentRs, colIndex, values[position])) // juliana@220_3
-                  return -1;
+                  goto error;
 
                if (colIndex != -1)
                   setBit(nulls0, position, bitSet); // Sets the null values from the temporary table.
@@ -2327,7 +3098,7 @@ int32 performJoin(Context context, ResultSet** list, int32 numTables, Table* tab
                   if (writeRSRecord(context, table, values)) // Writes the record.  
                      totalRecords++;
                   else
-                     return -1;
+                     goto error;
                }
             }
             else // VALIDATION_RECORD_INCOMPLETE
@@ -2341,10 +3112,17 @@ int32 performJoin(Context context, ResultSet** list, int32 numTables, Table* tab
          {
             currentIndexTable--;
             currentRs->pos = -1; // Restarts the current resultset to the next iteration.
+            break;
          }
+         case -1:
+            goto error;
       }
    }
-   return totalRecords;
+   return freeJoinKeys(context, list, numTables)? totalRecords : -1;
+
+error:
+   freeJoinKeys(context, list, numTables);
+   return -1;
 }
 
 /**
@@ -2369,9 +3147,32 @@ int32 getNextRecordJoin(Context context, int32 rsIndex, bool verifyWhereConditio
    uint8* basbuf = plainDB->basbuf;
    IntVector rowsBitmap = (resultSet->auxRowsBitmap.size > 0)? resultSet->auxRowsBitmap : resultSet->rowsBitmap;
    SQLBooleanClause* whereClause = resultSet->whereClause;
+   JoinKeys* joinKeys = resultSet->joinKeys;
    int32 rowCountLess1 = plainDB->rowCount - 1,
          ret;
 
+   // Only the rows whose key may be equal to the key of the current outer row are evaluated.
+   if (joinKeys && verifyWhereCondition && whereClause && joinKeys->outerPos == rsList[joinKeys->outerRs]->pos)
+   {
+      int32 position;
+
+      if (resultSet->pos == -1) // Restarts the lookup for a new outer row.
+         joinKeys->next = joinKeys->first;
+      while ((position = nextJoinKeysRow(context, joinKeys)) >= 0)
+      {
+         if (resultSet->rowsBitmap.size && !IntVectorisBitSet(&resultSet->rowsBitmap, position))
+            continue;
+         if (!plainRead(context, plainDB, resultSet->pos = position))
+            return -1;
+         if (recordNotDeleted(basbuf))
+         {
+            whereClause->resultSet = resultSet;
+            return booleanTreeEvaluateJoin(context, whereClause->expressionTree, rsList, totalRs, heap);
+         }
+      }
+      return (position == -1)? NO_RECORD : -1;
+   }
+
    // Desired rows partially computed using the indexes?
    if (rowsBitmap.size && verifyWhereCondition)
    {
@@ -2498,7 +3299,9 @@ int32 booleanTreeEvaluateJoin(Context context, SQLBooleanClauseTree* tree, Resul
                valueJoin->asChars = (JCharP)TC_heapAlloc(heap, 2 * resultSet->table->columnSizes[leftTree->colIndex] + 2);
             if (!getOperandValue(context, leftTree, valueJoin)) 
                return -1;
-				if (rightTree->hasIndex && boolOp <= 1)
+            if (rsBag->joinKeys && rsBag->joinKeys->tree == tree) // Looks up the inner rows with this key.
+               findJoinKeys(rsBag->joinKeys, valueJoin, resultSet->pos);
+				else if (rightTree->hasIndex && boolOp <= 1)
             {
                // juliana@225_13: join now behaves well with functions in columns with an index.
                SQLBooleanClause* booleanClause = tree->booleanClause;
@@ -2650,6 +3453,608 @@ int32 booleanTreeEvaluateJoin(Context context, SQLBooleanClauseTree* tree, Resul
    return VALIDATION_RECORD_INCOMPLETE;
 }
 
+/**
+ * Chooses the joins whose inner rows are looked up by the key of the outer row instead of being found by a scan of the inner table. The 
+ * comparison must be an equality between columns of the same type without data type functions and the inner column can't have an index, which is 
+ * used instead. Only the equalities that are joined to the where clause by <code>AND</code>s can be used, because they must hold for every row of 
+ * the answer.
+ *
+ * @param tree The expression tree of the where clause or one of its branches.
+ * @param rsList The list of the result sets.
+ * @param heap A heap to allocate the join keys.
+ */
+void planJoinKeys(SQLBooleanClauseTree* tree, ResultSet** rsList, Heap heap)
+{
+   TRACE("planJoinKeys")
+   SQLBooleanClauseTree* leftTree = tree->leftTree;
+   SQLBooleanClauseTree* rightTree = tree->rightTree;
+
+   if (tree->operandType == OP_BOOLEAN_AND)
+   {
+      if (leftTree)
+         planJoinKeys(leftTree, rsList, heap);
+      if (rightTree)
+         planJoinKeys(rightTree, rsList, heap);
+   }
+   else if (tree->operandType == OP_REL_EQUAL && tree->bothAreIdentifier && leftTree->indexRs < rightTree->indexRs && !rightTree->hasIndex 
+         && leftTree->valueType == tree->valueType && rightTree->valueType == tree->valueType)
+   {
+      SQLResultSetField** fieldList = tree->booleanClause->fieldList;
+      ResultSet* resultSet = rsList[rightTree->indexRs];
+      JoinKeys* joinKeys;
+
+      switch (tree->valueType)
+      {
+         case CHARS_TYPE:
+         case CHARS_NOCASE_TYPE:
+         case SHORT_TYPE:
+         case INT_TYPE:
+         case LONG_TYPE:
+         case FLOAT_TYPE:
+         case DOUBLE_TYPE:
+         case DATE_TYPE:
+         case DATETIME_TYPE:
+            break;
+         default:
+            return;
+      }
+
+      // Only one lookup per inner table. The rows already selected by the indices must be kept together with the lookup.
+      if (resultSet->joinKeys || resultSet->table->columnIndexes[rightTree->colIndex] 
+       || (resultSet->rowsBitmap.size && resultSet->rowsBitmapBoolOp != OP_BOOLEAN_AND)
+       || fieldList[getFieldIndex(leftTree)]->sqlFunction != FUNCTION_DT_NONE 
+       || fieldList[getFieldIndex(rightTree)]->sqlFunction != FUNCTION_DT_NONE)
+         return;
+
+      joinKeys = resultSet->joinKeys = (JoinKeys*)TC_heapAlloc(heap, sizeof(JoinKeys));
+      joinKeys->tree = tree;
+      joinKeys->type = tree->valueType;
+      joinKeys->isCaseless = tree->valueType == CHARS_NOCASE_TYPE;
+      joinKeys->outerRs = leftTree->indexRs;
+      joinKeys->outerPos = -2;
+      joinKeys->first = joinKeys->next = -1;
+   }
+}
+
+/**
+ * Hashes a join key. Equal keys, as compared by the join, must have the same hash.
+ *
+ * @param value The key.
+ * @param type The type of the key.
+ * @param isCaseless Indicates if a string key is compared ignoring the case.
+ * @return The hash of the key.
+ */
+uint32 joinKeyHash(SQLValue* value, int32 type, bool isCaseless)
+{
+   TRACE("joinKeyHash")
+   uint32 hash = 0;
+
+   switch (type)
+   {
+      case CHARS_TYPE:
+      case CHARS_NOCASE_TYPE:
+      {
+         JCharP chars = value->asChars;
+         int32 length = value->length;
+
+         if (isCaseless)
+            while (--length >= 0)
+               hash = 31 * hash + TC_JCharToLower(*chars++);
+         else
+            while (--length >= 0)
+               hash = 31 * hash + *chars++;
+         break;
+      }
+      case SHORT_TYPE:
+         hash = value->asShort;
+         break;
+      case INT_TYPE:
+      case DATE_TYPE:
+         hash = value->asInt;
+         break;
+      case LONG_TYPE:
+         hash = (uint32)value->asLong ^ (uint32)(value->asLong >> 32);
+         break;
+      case FLOAT_TYPE:
+      case DOUBLE_TYPE:
+      {
+         double number = (type == FLOAT_TYPE)? value->asFloat : value->asDouble;
+         int64 bits;
+
+         if (number != 0) // 0.0 and -0.0 are equal.
+         {
+            xmemmove(&bits, &number, 8);
+            hash = (uint32)bits ^ (uint32)(bits >> 32);
+         }
+         break;
+      }
+      case DATETIME_TYPE:
+         hash = 31 * value->asDate + value->asTime;
+   }
+   return hash * 0x9E3779B1; // Spreads the keys over the buckets.
+}
+
+/**
+ * Reads the key of a row of the inner table of a join.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of the inner table.
+ * @param row The row to be read.
+ * @param value Receives the key.
+ * @param hash Receives the hash of the key.
+ * @return 1 if the row has a key; 0 if the row is deleted or its key is null; -1 if an error occurs.
+ */
+int32 readJoinKey(Context context, ResultSet* resultSet, int32 row, SQLValue* value, uint32* hash)
+{
+   TRACE("readJoinKey")
+   JoinKeys* joinKeys = resultSet->joinKeys;
+   Table* table = resultSet->table;
+   uint8* basbuf = table->db.basbuf;
+   int32 column = joinKeys->tree->rightTree->colIndex;
+
+   if (!plainRead(context, &table->db, row))
+      return -1;
+   if (!recordNotDeleted(basbuf))
+      return 0;
+   xmemmove(table->columnNulls, basbuf + table->columnOffsets[table->columnCount], NUMBEROFBYTES(table->columnCount));
+   if (isBitSet(table->columnNulls, column)) // Null keys are never equal to anything.
+      return 0;
+   if (!getTableColValue(context, resultSet, column, value))
+      return -1;
+   *hash = joinKeyHash(value, joinKeys->type, joinKeys->isCaseless);
+   return 1;
+}
+
+/**
+ * Sorts pairs of hash and row of join keys using an iterative quick sort.
+ *
+ * @param pairs The pairs to be sorted, with the hash in the high word and the row in the low word.
+ * @param count The number of pairs.
+ */
+void sortJoinPairs(uint64* pairs, int32 count)
+{
+   TRACE("sortJoinPairs")
+   int32 stack[64],
+         size = 0,
+         low,
+         high,
+         i,
+         j;
+   uint64 pivot,
+          pair;
+
+   if (count < 2)
+      return;
+   stack[size++] = 0;
+   stack[size++] = count - 1;
+   while (size)
+   {
+      high = stack[--size];
+      low = stack[--size];
+      while (low < high)
+      {
+         pivot = pairs[(low + high) >> 1];
+         i = low;
+         j = high;
+         while (i <= j)
+         {
+            while (pairs[i] < pivot)
+               i++;
+            while (pairs[j] > pivot)
+               j--;
+            if (i <= j)
+            {
+               pair = pairs[i];
+               pairs[i++] = pairs[j];
+               pairs[j--] = pair;
+            }
+         }
+
+         // Stacks the larger partition and goes on with the smaller one so that the stack never has more than 31 partitions.
+         if (j - low < high - i)
+         {
+            if (i < high)
+            {
+               stack[size++] = i;
+               stack[size++] = high;
+            }
+            high = j;
+         }
+         else
+         {
+            if (low < j)
+            {
+               stack[size++] = low;
+               stack[size++] = j;
+            }
+            low = i;
+         }
+      }
+   }
+}
+
+/**
+ * Writes pairs of hash and row of join keys to a temporary file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile The temporary file.
+ * @param pairs The pairs to be written.
+ * @param count The number of pairs.
+ * @param position The position of the first pair in the file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool writeJoinPairs(Context context, XFile* xFile, uint64* pairs, int32 count, int32 position)
+{
+   TRACE("writeJoinPairs")
+   int32 length;
+
+   if ((uint32)(position + count) << 3 > xFile->size && !nfGrowTo(context, xFile, (position + count) << 3))
+      return false;
+   nfSetPos(xFile, position << 3);
+   while (count > 0) // Writes a block at a time so that the file cache does not grow to the size of a run.
+   {
+      length = (count < JOIN_BLOCK_PAIRS)? count : JOIN_BLOCK_PAIRS;
+      if (!nfWriteBytes(context, xFile, (uint8*)pairs, length << 3))
+         return false;
+      pairs += length;
+      count -= length;
+   }
+   return true;
+}
+
+/**
+ * Appends a pair of hash and row to the sorted join keys file, keeping the hash of the first pair of each block as its fence.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param joinKeys The join keys.
+ * @param block The block being filled.
+ * @param pair The pair to be appended.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool appendJoinPair(Context context, JoinKeys* joinKeys, uint64* block, uint64 pair)
+{
+   TRACE("appendJoinPair")
+   int32 count = joinKeys->count++,
+         length = count % JOIN_BLOCK_PAIRS;
+
+   if (!length)
+      joinKeys->fences[count / JOIN_BLOCK_PAIRS] = (uint32)(pair >> 32);
+   block[length++] = pair;
+   if (length == JOIN_BLOCK_PAIRS)
+      return writeJoinPairs(context, &joinKeys->file, block, length, count + 1 - length);
+   return true;
+}
+
+/**
+ * Sorts the keys of the inner table of a join on a temporary file, when they don't fit in the join memory budget. Runs of keys that fit in the 
+ * budget are sorted in memory and written to a runs file, which are then merged into the keys file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of the inner table.
+ * @param value A buffer for the keys.
+ * @param heap A heap to allocate the fences of the keys file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool sortJoinKeysOnDisk(Context context, ResultSet* resultSet, SQLValue* value, Heap heap)
+{
+   TRACE("sortJoinKeysOnDisk")
+   JoinKeys* joinKeys = resultSet->joinKeys;
+   Table* table = resultSet->table;
+   TCHARP sourcePath = table->sourcePath;
+   XFile runs;
+   char name[DBNAME_SIZE];
+   int32 rowCount = table->db.rowCount,
+         capacity = MAX(JOIN_RUN_PAIRS, joinMemoryBudget >> 3),
+         runCount = 0,
+         length = 0,
+         total = 0,
+         row = -1,
+         i,
+         lowest;
+   uint32 hash;
+   uint64* pairs;
+   uint64* block;
+   int32* runEnds = null;
+   int32* runPositions;
+   int32* runLengths;
+   int32* runIndexes;
+   bool ret = false;
+
+   xmemzero(&runs, sizeof(XFile));
+   capacity = MIN(capacity, MAX(rowCount, 1));
+   joinKeys->fences = (uint32*)TC_heapAlloc(heap, ((rowCount + JOIN_BLOCK_PAIRS - 1) / JOIN_BLOCK_PAIRS + 1) << 2);
+   if (!(pairs = (uint64*)xmalloc(capacity << 3)))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+
+   // Creates the keys file and, if more than one run is necessary, the runs file.
+   xstrprintf(name, "%s%d%s", table->db.name, resultSet->indexRs, JTK_EXT); // A self join may look up the same table twice.
+   if (!nfCreateFile(context, name, true, false, sourcePath, &joinKeys->file, -1))
+      goto finish;
+   joinKeys->isOnDisk = true;
+   if (rowCount > capacity)
+   {
+      xstrprintf(name, "%s%d%s", table->db.name, resultSet->indexRs, JTR_EXT);
+      if (!nfCreateFile(context, name, true, false, sourcePath, &runs, -1))
+         goto finish;
+      if (!(runEnds = (int32*)xmalloc((rowCount / capacity + 1) << 4)))
+      {
+         TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+         goto finish;
+      }
+   }
+
+   while (++row < rowCount) // Reads the keys, sorting and writing a run whenever the buffer is full.
+   {
+      switch (readJoinKey(context, resultSet, row, value, &hash))
+      {
+         case -1:
+            goto finish;
+         case 1:
+            pairs[length++] = ((uint64)hash << 32) | (uint32)row;
+      }
+      if (length == capacity && row < rowCount - 1)
+      {
+         sortJoinPairs(pairs, length);
+         if (!writeJoinPairs(context, &runs, pairs, length, total))
+            goto finish;
+         runEnds[runCount++] = total += length;
+         length = 0;
+      }
+   }
+   sortJoinPairs(pairs, length);
+
+   if (!runCount) // Only one run: it is already the keys file.
+   {
+      i = 0;
+      while (i < length)
+      {
+         joinKeys->fences[i / JOIN_BLOCK_PAIRS] = (uint32)(pairs[i] >> 32);
+         i += JOIN_BLOCK_PAIRS;
+      }
+      if (!writeJoinPairs(context, &joinKeys->file, pairs, joinKeys->count = length, 0))
+         goto finish;
+      ret = true;
+      goto finish;
+   }
+
+   if (length) // The last run.
+   {
+      if (!writeJoinPairs(context, &runs, pairs, length, total))
+         goto finish;
+      runEnds[runCount++] = total += length;
+   }
+   xfree(pairs);
+
+   // Merges the runs. Each run has a block of pairs read from the runs file and there is one more block for the keys file.
+   if (!(pairs = (uint64*)xmalloc((runCount + 1) * JOIN_BLOCK_PAIRS << 3)))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto finish;
+   }
+   block = &pairs[runCount * JOIN_BLOCK_PAIRS];
+   runPositions = &runEnds[runCount];
+   runLengths = &runPositions[runCount];
+   runIndexes = &runLengths[runCount];
+   i = runCount;
+   while (--i >= 0)
+   {
+      runPositions[i] = i? runEnds[i - 1] : 0;
+      runLengths[i] = runIndexes[i] = 0;
+   }
+   if (!nfGrowTo(context, &joinKeys->file, total << 3))
+      goto finish;
+
+   while (true)
+   {
+      lowest = -1;
+      i = runCount;
+      while (--i >= 0)
+      {
+         if (runIndexes[i] == runLengths[i] && runPositions[i] < runEnds[i]) // Reads the next block of the run.
+         {
+            runLengths[i] = MIN(JOIN_BLOCK_PAIRS, runEnds[i] - runPositions[i]);
+            runIndexes[i] = 0;
+            nfSetPos(&runs, runPositions[i] << 3);
+            if (!nfReadBytes(context, &runs, (uint8*)&pairs[i * JOIN_BLOCK_PAIRS], runLengths[i] << 3))
+               goto finish;
+            runPositions[i] += runLengths[i];
+         }
+         if (runIndexes[i] < runLengths[i] 
+          && (lowest == -1 || pairs[i * JOIN_BLOCK_PAIRS + runIndexes[i]] < pairs[lowest * JOIN_BLOCK_PAIRS + runIndexes[lowest]]))
+            lowest = i;
+      }
+      if (lowest == -1)
+         break;
+      if (!appendJoinPair(context, joinKeys, block, pairs[lowest * JOIN_BLOCK_PAIRS + runIndexes[lowest]++]))
+         goto finish;
+   }
+   if ((length = joinKeys->count % JOIN_BLOCK_PAIRS)) // Writes the last block.
+      ret = writeJoinPairs(context, &joinKeys->file, block, length, joinKeys->count - length);
+   else
+      ret = true;
+
+finish:
+   xfree(pairs);
+   xfree(runEnds);
+   if (runs.name[0] && !nfRemove(context, &runs, sourcePath))
+      ret = false;
+   return ret;
+}
+
+/**
+ * Builds the lookup of the keys of the inner table of a join. The keys are put in a hash table if it fits in the join memory budget; otherwise, 
+ * they are sorted on a temporary file. Tables in memory are always hashed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of the inner table.
+ * @param heap A heap to allocate the lookup.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool buildJoinKeys(Context context, ResultSet* resultSet, Heap heap)
+{
+   TRACE("buildJoinKeys")
+   JoinKeys* joinKeys = resultSet->joinKeys;
+   Table* table = resultSet->table;
+   int32 rowCount = table->db.rowCount,
+         column = joinKeys->tree->rightTree->colIndex,
+         mask = 15,
+         count = 0,
+         row = -1,
+         bucket;
+   uint32 hash;
+   int32* buckets;
+   int32* chain;
+   uint32* hashes;
+   int32* rows;
+   SQLValue value;
+
+   xmemzero(&value, sizeof(SQLValue));
+   if (joinKeys->type == CHARS_TYPE || joinKeys->type == CHARS_NOCASE_TYPE)
+      value.asChars = (JCharP)TC_heapAlloc(heap, (table->columnSizes[column] << 1) + 2);
+   while (mask < rowCount)
+      mask = (mask << 1) | 1;
+
+   // The keys are sorted on disk if the hash table does not fit in the budget.
+   if (*table->db.name && (int64)rowCount * 12 + ((int64)mask + 1) * 4 > joinMemoryBudget)
+      return sortJoinKeysOnDisk(context, resultSet, &value, heap);
+
+   joinKeys->mask = mask;
+   joinKeys->buckets = buckets = (int32*)TC_heapAlloc(heap, (mask + 1) << 2);
+   joinKeys->chain = chain = (int32*)TC_heapAlloc(heap, (rowCount + 1) << 2);
+   joinKeys->hashes = hashes = (uint32*)TC_heapAlloc(heap, (rowCount + 1) << 2);
+   joinKeys->rows = rows = (int32*)TC_heapAlloc(heap, (rowCount + 1) << 2);
+   
+   while (++row < rowCount)
+      switch (readJoinKey(context, resultSet, row, &value, &hash))
+      {
+         case -1:
+            return false;
+         case 1:
+            hashes[count] = hash;
+            rows[count++] = row;
+      }
+
+   // Chains the keys backwards so that the rows of each bucket are returned in ascending order.
+   xmemset(buckets, 0xFF, (mask + 1) << 2);
+   joinKeys->count = row = count;
+   while (--row >= 0)
+   {
+      chain[row] = buckets[bucket = hashes[row] & mask];
+      buckets[bucket] = row;
+   }
+   return true;
+}
+
+/**
+ * Looks up the keys of the inner table of a join that may be equal to the key of the current outer row. 
+ *
+ * @param joinKeys The join keys of the inner table.
+ * @param value The key of the outer row.
+ * @param outerPos The position of the outer row.
+ */
+void findJoinKeys(JoinKeys* joinKeys, SQLValue* value, int32 outerPos)
+{
+   TRACE("findJoinKeys")
+   uint32 hash;
+   uint32* fences;
+   int32 low,
+         high,
+         middle;
+
+   joinKeys->outerPos = outerPos;
+   joinKeys->first = joinKeys->next = -1;
+   if (value->isNull || !joinKeys->count) // A null key does not match any row.
+      return;
+   joinKeys->hash = hash = joinKeyHash(value, joinKeys->type, joinKeys->isCaseless);
+   if (joinKeys->isOnDisk)
+   {
+      // Finds the last block whose fence is lower than the hash, since the first pair with the hash can be at its end.
+      fences = joinKeys->fences;
+      low = 0;
+      high = (joinKeys->count - 1) / JOIN_BLOCK_PAIRS;
+      while (low < high)
+      {
+         middle = (low + high + 1) >> 1;
+         if (fences[middle] < hash)
+            low = middle;
+         else
+            high = middle - 1;
+      }
+      joinKeys->first = low * JOIN_BLOCK_PAIRS;
+   }
+   else
+      joinKeys->first = joinKeys->buckets[hash & joinKeys->mask];
+   joinKeys->next = joinKeys->first;
+}
+
+/**
+ * Gets the next row of the inner table of a join whose key has the hash of the last lookup.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param joinKeys The join keys of the inner table.
+ * @return The next row, -1 if there are no more rows, or -2 if an error occurs.
+ */
+int32 nextJoinKeysRow(Context context, JoinKeys* joinKeys)
+{
+   TRACE("nextJoinKeysRow")
+   int32 next;
+
+   if (joinKeys->isOnDisk)
+   {
+      XFile* xFile = &joinKeys->file;
+      uint64 pair;
+      uint32 hash;
+
+      while ((next = joinKeys->next) >= 0 && next < joinKeys->count)
+      {
+         nfSetPos(xFile, next << 3);
+         if (!nfReadBytes(context, xFile, (uint8*)&pair, 8))
+            return -2;
+         joinKeys->next++;
+         if ((hash = (uint32)(pair >> 32)) == joinKeys->hash)
+            return (int32)(uint32)pair;
+         if (hash > joinKeys->hash) // The pairs are sorted, so there are no more rows with this hash.
+            break;
+      }
+      joinKeys->next = -1;
+      return -1;
+   }
+
+   while ((next = joinKeys->next) >= 0)
+   {
+      joinKeys->next = joinKeys->chain[next];
+      if (joinKeys->hashes[next] == joinKeys->hash)
+         return joinKeys->rows[next];
+   }
+   return -1;
+}
+
+/**
+ * Removes the temporary files of the join keys of the result sets of a join.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param list The list of the result sets.
+ * @param numTables The number of tables of the select.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool freeJoinKeys(Context context, ResultSet** list, int32 numTables)
+{
+   TRACE("freeJoinKeys")
+   JoinKeys* joinKeys;
+   bool ret = true;
+
+   while (--numTables >= 0)
+      if ((joinKeys = list[numTables]->joinKeys) && joinKeys->isOnDisk)
+      {
+         joinKeys->isOnDisk = false;
+         ret &= nfRemove(context, &joinKeys->file, list[numTables]->table->sourcePath);
+      }
+   return ret;
+}
+
 /**
  * Calculates aggregation functions. 
  *
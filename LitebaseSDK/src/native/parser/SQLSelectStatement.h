@@ -89,12 +89,56 @@ bool litebaseBindSelectStatement(Context context, TCObject driver, SQLSelectStat
  * Tries to put as inner table a table that has an index used more often in the where clause, when the where clause has a comparison between 
  * fields from different tables. e.g.: <code>select * from table1, table2 where table1.field1 = table2.field2 </code> If only 
  * <code>table1.field1</code> has index, changes the select to: <code>select * from table2, table1 where table1.field1 = table2.field2</code>. 
- * If both tables has the same level of index using, sorts them by the row count.
+ * If both tables has the same level of index using, sorts them by the row count. An inner table compared with an equality to a column without an 
+ * index has its keys looked up when the join starts, so the smaller tables are better as inner tables. If all the tables were analyzed and there
+ * are not too many of them, the order chosen is the one with the smallest estimated cost instead.
  *
  * @param selectStmt A SQL select statement.
  */
 void orderTablesToJoin(SQLSelectStatement* selectStmt);
 
+/**
+ * Collects the equalities between columns of different tables which are joined to the where clause by <code>AND</code>s. 
+ *
+ * @param tree The expression tree of the where clause or one of its branches.
+ * @param tables Receives the indices of the tables of the two sides of each equality in the table list.
+ * @param columns Receives the columns of the two sides of each equality.
+ * @param count The number of equalities already collected.
+ * @return The number of equalities collected.
+ */
+int32 collectJoinEqualities(SQLBooleanClauseTree* tree, uint8* tables, uint8* columns, int32 count);
+
+/**
+ * Estimates the cost of a join with its tables in a given order, which is the estimated number of rows and index nodes read. The first table is 
+ * scanned or, if an index of a comparison with a constant is selective enough, read through it. Each inner table is read through an index of an 
+ * equality with a table before it, through the sorted keys of such an equality, or by a scan for each row of the tables before it.
+ *
+ * @param tableList The tables of the join.
+ * @param order The order of the tables, from the outer to the innermost one.
+ * @param size The number of tables.
+ * @param filters The estimated selectivity of the where clause for each table.
+ * @param indexFilters The estimated selectivity of the best index of the where clause for each table.
+ * @param tables The indices of the tables of the two sides of each equality between tables.
+ * @param columns The columns of the two sides of each equality between tables.
+ * @param count The number of equalities.
+ * @param bound The cost above which the estimate can stop, or a negative value to compute the whole cost.
+ * @param access Receives how each table is read, if not <code>null</code>.
+ * @param rows Receives the estimated number of rows after each table is joined, if not <code>null</code>.
+ * @param costs Receives the estimated cost after each table is joined, if not <code>null</code>.
+ * @return The estimated cost, which may be partial if it is above the bound.
+ */
+double estimateJoinCost(SQLResultSetTable** tableList, uint8* order, int32 size, double* filters, double* indexFilters, uint8* tables, 
+                                                        uint8* columns, int32 count, double bound, uint8* access, double* rows, double* costs);
+
+/**
+ * Gets the number of distinct values of a column used to estimate the rows of a join. A column of a table not analyzed is taken as a key.
+ *
+ * @param table The table.
+ * @param column The column.
+ * @return The estimated number of distinct values, which is at least 1.
+ */
+double statisticsDistinct(Table* table, int32 column);
+
 /**
  * Binds the SQLSelectStatement to the select clause tables.
  *
@@ -127,6 +171,26 @@ bool validateSelectStatement(Context context, SQLSelectStatement* selectStmt);
  */
 Table* generateResultSetTable(Context context, TCObject driver, SQLSelectStatement* selectStmt);
 
+/**
+ * Aggregates the groups of a GROUP BY of a single table in a hash table in memory, so that the rows don't need to be written to a temporary table 
+ * and sorted. Each group keeps the running totals of its aggregated functions and is found by a key built as a sort key of the sort fields. The 
+ * groups are then sorted by their keys and written to the result table. If the groups do not fit in the budget, the aggregation is given up.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param selectStmt The select statement.
+ * @param resultSet The result set of the table, using the WHERE clause.
+ * @param aggFunctionsCodes The codes of the aggregated functions.
+ * @param aggFunctionsParamCols The columns of the select clause that are aggregated functions.
+ * @param aggFunctionsColsCount The number of aggregated functions.
+ * @param table Receives the result table or <code>null</code> if the groups don't fit in the budget.
+ * @param heap A heap to perform some memory allocations.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+bool hashGroupBy(Context context, TCObject driver, SQLSelectStatement* selectStmt, ResultSet* resultSet, int8* aggFunctionsCodes, 
+                                                  int32* aggFunctionsParamCols, int32 aggFunctionsColsCount, Table** table, Heap heap);
+
 /**
  * Generates a table to store the result set.
  *
@@ -152,6 +216,19 @@ bool createListResultSetForSelect(Context context, SQLResultSetTable** tableList
  */
 bool generateIndexedRowsMap(Context context, ResultSet** rsList, int32 size, bool hasComposedIndex, Heap heap);
 
+/**
+ * Narrows the rows of a result set using the trigram indices of the columns compared with <code>LIKE</code> to a pattern with at least three 
+ * characters in a row. The candidate rows are the ones that have all the trigrams of the pattern, and the <code>LIKE</code> is kept in the where 
+ * clause to discard the ones that don't match it.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of a table with trigram indices.
+ * @param tree The remaining expression tree of the where clause, whose <code>AND</code>ed branches are searched for <code>LIKE</code>s.
+ * @param heap A heap to allocate the bitmaps.
+ * @return <code>true</code> if the function executed correctly; <code>false</code>, otherwise.
+ */
+bool applyTrigramIndexes(Context context, ResultSet* resultSet, SQLBooleanClauseTree* tree, Heap heap);
+
 /**
  * Finds the rows that satisfy the query clause using the indices.
  *
@@ -205,6 +282,19 @@ void endAggFunctionsCalc(SQLValue** record, int32 groupCount, SQLValue* aggFunct
  */
 Table* createIntValueTable(Context context, TCObject driver, int32 intValue, CharP colName);
 
+/**
+ * Creates a temporary table with the plan of a query preceded by <code>EXPLAIN</code>. It has a row for each table of the query in the order they
+ * are joined, with how its rows are read and the estimated number of rows and cost after it is joined. The fields of the select clause are 
+ * replaced by the columns of the plan.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param selectStmt A SQL select statement.
+ * @return The table if the method executes correctlty; <code>null</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enougth memory alloc memory. 
+ */
+Table* createPlanTable(Context context, TCObject driver, SQLSelectStatement* selectStmt);
+
 /** 
  * Binds the column information of the underlying tables to the select clause. 
  *
@@ -298,6 +388,122 @@ int32 getNextRecordJoin(Context context, int32 rsIndex, bool verifyWhereConditio
  */
 int32 booleanTreeEvaluateJoin(Context context, SQLBooleanClauseTree* tree, ResultSet** rsList, int32 totalRs, Heap heap);
 
+/**
+ * Chooses the joins whose inner rows are looked up by the key of the outer row instead of being found by a scan of the inner table. The 
+ * comparison must be an equality between columns of the same type without data type functions and the inner column can't have an index, which is 
+ * used instead. Only the equalities that are joined to the where clause by <code>AND</code>s can be used, because they must hold for every row of 
+ * the answer.
+ *
+ * @param tree The expression tree of the where clause or one of its branches.
+ * @param rsList The list of the result sets.
+ * @param heap A heap to allocate the join keys.
+ */
+void planJoinKeys(SQLBooleanClauseTree* tree, ResultSet** rsList, Heap heap);
+
+/**
+ * Hashes a join key. Equal keys, as compared by the join, must have the same hash.
+ *
+ * @param value The key.
+ * @param type The type of the key.
+ * @param isCaseless Indicates if a string key is compared ignoring the case.
+ * @return The hash of the key.
+ */
+uint32 joinKeyHash(SQLValue* value, int32 type, bool isCaseless);
+
+/**
+ * Reads the key of a row of the inner table of a join.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of the inner table.
+ * @param row The row to be read.
+ * @param value Receives the key.
+ * @param hash Receives the hash of the key.
+ * @return 1 if the row has a key; 0 if the row is deleted or its key is null; -1 if an error occurs.
+ */
+int32 readJoinKey(Context context, ResultSet* resultSet, int32 row, SQLValue* value, uint32* hash);
+
+/**
+ * Sorts pairs of hash and row of join keys using an iterative quick sort.
+ *
+ * @param pairs The pairs to be sorted, with the hash in the high word and the row in the low word.
+ * @param count The number of pairs.
+ */
+void sortJoinPairs(uint64* pairs, int32 count);
+
+/**
+ * Writes pairs of hash and row of join keys to a temporary file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param xFile The temporary file.
+ * @param pairs The pairs to be written.
+ * @param count The number of pairs.
+ * @param position The position of the first pair in the file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool writeJoinPairs(Context context, XFile* xFile, uint64* pairs, int32 count, int32 position);
+
+/**
+ * Appends a pair of hash and row to the sorted join keys file, keeping the hash of the first pair of each block as its fence.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param joinKeys The join keys.
+ * @param block The block being filled.
+ * @param pair The pair to be appended.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool appendJoinPair(Context context, JoinKeys* joinKeys, uint64* block, uint64 pair);
+
+/**
+ * Sorts the keys of the inner table of a join on a temporary file, when they don't fit in the join memory budget. Runs of keys that fit in the 
+ * budget are sorted in memory and written to a runs file, which are then merged into the keys file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of the inner table.
+ * @param value A buffer for the keys.
+ * @param heap A heap to allocate the fences of the keys file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool sortJoinKeysOnDisk(Context context, ResultSet* resultSet, SQLValue* value, Heap heap);
+
+/**
+ * Builds the lookup of the keys of the inner table of a join. The keys are put in a hash table if it fits in the join memory budget; otherwise, 
+ * they are sorted on a temporary file. Tables in memory are always hashed.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param resultSet The result set of the inner table.
+ * @param heap A heap to allocate the lookup.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool buildJoinKeys(Context context, ResultSet* resultSet, Heap heap);
+
+/**
+ * Looks up the keys of the inner table of a join that may be equal to the key of the current outer row. 
+ *
+ * @param joinKeys The join keys of the inner table.
+ * @param value The key of the outer row.
+ * @param outerPos The position of the outer row.
+ */
+void findJoinKeys(JoinKeys* joinKeys, SQLValue* value, int32 outerPos);
+
+/**
+ * Gets the next row of the inner table of a join whose key has the hash of the last lookup.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param joinKeys The join keys of the inner table.
+ * @return The next row, -1 if there are no more rows, or -2 if an error occurs.
+ */
+int32 nextJoinKeysRow(Context context, JoinKeys* joinKeys);
+
+/**
+ * Removes the temporary files of the join keys of the result sets of a join.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param list The list of the result sets.
+ * @param numTables The number of tables of the select.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool freeJoinKeys(Context context, ResultSet** list, int32 numTables);
+
 /**
  * Calculates aggregation functions. 
  *
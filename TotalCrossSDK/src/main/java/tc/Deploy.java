@@ -346,6 +346,12 @@ public class Deploy {
             DeploySettings.exclusionList.addElement(exc[j].replace('.', '/'));
           }
           break;
+        case 'u':
+          String[] unc = totalcross.sys.Convert.tokenizeString(args[++i], ',');
+          for (int j = 0; j < unc.length; j++) {
+            DeploySettings.uncompressedList.addElement(unc[j].replace('.', '/'));
+          }
+          break;
         case 'k':
           Deployer4WinCE.keepExe = true;
           Deployer4WinCE.keepExeAndDontCreateCabFiles = op.equals("/kn");
@@ -436,6 +442,8 @@ public class Deploy {
         + "The SDK must be in the path or in the TOTALCROSS3_HOME environment variable. "
         + "The files are always installed at the same folder of the application, so each application will have its own vm.\n"
         + "   /t      : Just test the classes to see if there are any invalid references. Images are not converted, and nothing is written to disk.\n"
+        + "   /u list : Comma-separated list of class names that are stored without compression (in a starts-with manner), "
+        + "so the vm maps them instead of inflating them. Use it for the classes loaded at startup. E.G.: \"/u com/app/ui/\" \n"
         + "   /v      : Verbose output for information messages\n"
         + "   /w      : Waits for a key press if an error occurs\n"
         + "   /x list : Comma-separated list of class names that must be excluded (in a starts-with manner). E.G.: \"/x com/framework/\" \n"
@@ -90,6 +90,7 @@ public final class J2TC implements JConstants, TCConstants {
   public TCClass converted;
   /** The bytes of the stored class */
   public byte[] bytes;
+  public boolean stored; // bytes are the uncompressed tclass
   public static Vector callForName = new Vector(4);
   public static boolean notResolvedForNameFound;
   public static String currentClass, currentMethod;
@@ -116,8 +117,13 @@ public final class J2TC implements JConstants, TCConstants {
       tcbasz.reset();
       converted.write(new DataStreamLE(tcbas));
       //if (dump) {System.out.println(jc.className); byte[] bytes = tcbas.toByteArray(); System.out.println(TCZ.toString(bytes,0,bytes.length));}
-      tc.tools.converter.Storage.compressAndWrite(tcbas, new DataStream(tcbasz));
-      bytes = tcbasz.toByteArray();
+      if (inUncompressedList(jc.className)) {
+        stored = true;
+        bytes = tcbas.toByteArray();
+      } else {
+        tc.tools.converter.Storage.compressAndWrite(tcbas, new DataStream(tcbasz));
+        bytes = tcbasz.toByteArray();
+      }
     } else {
       Utils.println("Replacing " + jc.className + " by its 4D");
     }
@@ -929,7 +935,9 @@ public final class J2TC implements JConstants, TCConstants {
             bytes = j2.bytes; // replace the bytes by the tclass ones
             System.out.print("Adding " + j2.converted.className);
             if (!DeploySettings.testClass) {
-              vout.addElement(new TCZ.Entry(bytes, j2.converted.className, len)); // note that all files must be added - use the real package name
+              TCZ.Entry entry = new TCZ.Entry(bytes, j2.converted.className, j2.stored ? bytes.length : len); // note that all files must be added - use the real package name
+              entry.stored = j2.stored;
+              vout.addElement(entry);
             }
           }
         } else if (!DeploySettings.testClass) {
@@ -1096,6 +1104,15 @@ public final class J2TC implements JConstants, TCConstants {
     return false;
   }
 
+  private static boolean inUncompressedList(String c) {
+    for (int i = DeploySettings.uncompressedList.size() - 1; i >= 0; i--) {
+      if (c.startsWith((String) DeploySettings.uncompressedList.items[i])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   private static void setupHt() {
     htValidExtensions.put(".bin", "");
     htValidExtensions.put(".txt", "");
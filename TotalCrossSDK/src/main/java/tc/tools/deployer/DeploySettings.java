@@ -67,6 +67,7 @@ public class DeploySettings {
   public static String baseDir;
   public static String mainClassDir;
   public static Vector exclusionList = new Vector(10);
+  public static Vector uncompressedList = new Vector(10); // classes stored without compression in the tcz
   public static IntVector appletFontSizes = new IntVector();
   public static String javaVersion = System.getProperty("java.version");
   public static String osName = System.getProperty("os.name").toLowerCase();
@@ -638,6 +638,20 @@ public final class Vm {
    */
   public static final int TWEAK_TRACE_METHODS = 8;
 
+  /** Makes the garbage collector mark the objects in small slices while the program runs, instead of 
+   * stopping everything until all objects are visited. This reduces the pauses in programs with big heaps,
+   * at the cost of a higher memory usage, since the objects are only released when the marking ends.
+   * @since TotalCross 6.2
+   */
+  public static final int TWEAK_INCREMENTAL_GC = 9;
+
+  /** Makes the software renderer split the large drawings, like full screen fills, polygons, gradients and screen
+   * fades, in bands of rows that are drawn in parallel by a pool of threads, one for each processor. The result is
+   * exactly the same of the single-threaded drawing. Has no effect when the screen is drawn with OpenGL or Skia.
+   * @since TotalCross 6.2
+   */
+  public static final int TWEAK_TILED_RASTER = 10;
+
   /**
    * Tweak some parameters of the virtual machine. Note that these
    * parameters are only available at the device, NOT when running as Java.
@@ -68,7 +68,7 @@ public class ClippedContainer extends Container {
           break;
         }
         if (pw == null || !child.isObscured(pw)) {
-          child.onPaint(child.getGraphics());
+          child.paintRetained(child.getGraphics());
           if (child.asContainer != null) {
             child.asContainer.paintChildren();
           }
@@ -80,13 +80,14 @@ public class ClippedContainer extends Container {
         if (child.isVisibleAndInside(bagClipX0, bagClipY0, bagClipXf, bagClipYf)
             && (pw == null || !child.isObscured(pw))) {
           if (child.asContainer != null && child.asContainer.offscreen != null) {
+            repaintCounters[REPAINT_OFFSCREEN]++;
             Graphics g = getGraphics();
             g.drawImage(child.asContainer.offscreen, child.x, child.y);
             if (child.asContainer.offscreen0 != null) {
               g.drawImage(child.asContainer.offscreen0, child.x, child.y);
             }
           } else {
-            child.onPaint(child.getGraphics());
+            child.paintRetained(child.getGraphics());
             if (child.asContainer != null) {
               child.asContainer.paintChildren();
             }
@@ -508,13 +508,14 @@ public class Container extends Control {
       if (child.visible) // guich@200: ignore hidden controls - note: a window added to a container may not be painted correctly
       {
         if (child.offscreen != null) {
+          repaintCounters[REPAINT_OFFSCREEN]++;
           Graphics g = getGraphics();
           g.drawImage(child.offscreen, child.x, child.y);
           if (child.offscreen0 != null) {
             g.drawImage(child.offscreen0, child.x, child.y);
           }
         } else {
-          child.onPaint(child.getGraphics());
+          child.paintRetained(child.getGraphics());
           if (child.asContainer != null) {
             child.asContainer.paintChildren();
           }
@@ -341,6 +341,29 @@ public class Control extends GfxSurface {
    */
   public Image offscreen, offscreen0;
 
+  /** Set to true to keep the primitives drawn by onPaint in a display list, which is replayed in the next paints of
+   * this control instead of calling onPaint again. The list is discarded when the bounds, font, colors or enabled state
+   * change, and when repaintNow is called; if the appearance of the control depends on anything else, call
+   * invalidateDisplayList when it changes. Controls whose appearance never changes can use takeScreenShot instead,
+   * which keeps an offscreen bitmap.
+   * @see #invalidateDisplayList()
+   * @see #repaintCounters
+   */
+  public boolean useDisplayList;
+  private Object[] displayList;
+
+  /** Index in repaintCounters of the number of times onPaint was called by the paint loop. */
+  public static final int REPAINT_PAINTED = 0;
+  /** Index in repaintCounters of the number of paints that were replayed from a display list. */
+  public static final int REPAINT_REPLAYED = 1;
+  /** Index in repaintCounters of the number of display lists recorded. */
+  public static final int REPAINT_RECORDED = 2;
+  /** Index in repaintCounters of the number of paints that used the offscreen bitmap. */
+  public static final int REPAINT_OFFSCREEN = 3;
+  /** Counters of the paints done by Container.paintChildren and repaintNow, indexed by the REPAINT_* constants.
+   * They are never reset by the system, so you can zero them to measure a given interval. */
+  public static int[] repaintCounters = new int[4];
+
   /** Keep the control disabled even if enabled is true. */
   public boolean keepDisabled;
 
@@ -616,6 +639,7 @@ public class Control extends GfxSurface {
     this.setFont = this.font = font;
     this.fm = font.fm;
     this.fmH = fm.height;
+    displayList = null;
     onFontChanged();
     postEvent(new FontChangeEvent(this, font));
   }
@@ -1375,6 +1399,7 @@ public class Control extends GfxSurface {
       updateTemporary();
     }
     Window.needsPaint = true;
+    displayList = null;
     onBoundsChanged(screenChanged);
     if (asContainer != null) {
       if (!asContainer.started) // guich@340_15
@@ -1589,7 +1614,8 @@ public class Control extends GfxSurface {
       } else {
         Graphics g = refreshGraphics(gfx, 0, null, 0, 0);
         if (g != null) {
-          onPaint(g);
+          displayList = null;
+          paintRetained(g);
           if (asContainer != null) {
             asContainer.paintChildren();
           }
@@ -1599,6 +1625,58 @@ public class Control extends GfxSurface {
     }
   }
 
+  /** Discards the display list of this control, so the next paint calls onPaint again.
+   * @see #useDisplayList
+   */
+  public void invalidateDisplayList() {
+    displayList = null;
+  }
+
+  /** Paints this control in the given Graphics, replaying its display list if there's a valid one, or calling onPaint
+   * otherwise. Used by the paint loop; the children are not painted.
+   */
+  void paintRetained(Graphics g) {
+    if (useDisplayList && displayList != null && replayDisplayList(g, displayList)) {
+      repaintCounters[REPAINT_REPLAYED]++;
+      return;
+    }
+    repaintCounters[REPAINT_PAINTED]++;
+    if (!useDisplayList) {
+      onPaint(g);
+      return;
+    }
+    boolean painted = false;
+    startDisplayList(g);
+    try {
+      onPaint(g);
+      painted = true;
+    } finally {
+      Object[] list = endDisplayList();
+      displayList = painted ? list : null;
+    }
+    if (displayList != null) {
+      repaintCounters[REPAINT_RECORDED]++;
+    }
+  }
+
+  /** Starts recording the primitives drawn in the given Graphics. Only one recording can be active at a time. */
+  @ReplacedByNativeOnDeploy
+  static void startDisplayList(Graphics g) {
+  }
+
+  /** Stops the recording and returns the display list, or null if something that cannot be replayed was drawn. */
+  @ReplacedByNativeOnDeploy
+  static Object[] endDisplayList() {
+    return null;
+  }
+
+  /** Replays the display list in the given Graphics, using its current translation and clip. Returns false if the
+   * list is invalid. */
+  @ReplacedByNativeOnDeploy
+  static boolean replayDisplayList(Graphics g, Object[] list) {
+    return false;
+  }
+
   /** Sets the given Point to the absolute coordinate relative to the origin Window.
    * @since SuperWaba 5.5
    */
@@ -1744,6 +1822,7 @@ public class Control extends GfxSurface {
   public boolean internalSetEnabled(boolean enabled, boolean post) {
     if (enabled != this.enabled) {
       this.enabled = enabled;
+      displayList = null;
       onColorsChanged(false);
       if (post) {
         post();
@@ -1817,6 +1896,7 @@ public class Control extends GfxSurface {
   {
     this.backColor = back;
     this.foreColor = fore;
+    displayList = null;
     onColorsChanged(true);
   }
 
@@ -1824,6 +1904,7 @@ public class Control extends GfxSurface {
    @since SuperWaba 2.0 */
   public void setForeColor(int c) {
     this.foreColor = c;
+    displayList = null;
     onColorsChanged(true);
   }
 
@@ -1831,6 +1912,7 @@ public class Control extends GfxSurface {
    @since SuperWaba 2.0 */
   public void setBackColor(int c) {
     this.backColor = c;
+    displayList = null;
     onColorsChanged(true);
   }
 
@@ -28,7 +28,7 @@ import totalcross.util.Vector;
     <ul>
     <li> length      (4 bytes)
     <li> offsets array (length+1) - offset[i+1]-offset[i] gives the compressed size
-    <li> uncompressed sizes array (length)
+    <li> uncompressed sizes array (length) - a negative size means that the chunk is stored without compression
     <li> names array (length)
     </ul>
 
@@ -48,6 +48,9 @@ public class TCZ {
     public String name;
     /** The size of the block when it is uncompressed. */
     public int uncompressedSize;
+    /** If true, the bytes are not compressed, so the vm reads them directly from the file instead of inflating them.
+     * Used for the classes loaded at startup. */
+    public boolean stored;
     /** Anything you want to hold here. */
     public Object extra; // JavaClass for the converter
 
@@ -161,7 +164,7 @@ public class TCZ {
       names[i] = of.name2write;
       ofs += of.bytes.length;
       offsets[i + 1] = ofs;
-      uncompressedSizes[i] = of.uncompressedSize;
+      uncompressedSizes[i] = of.stored ? -of.uncompressedSize : of.uncompressedSize;
     }
 
     // prepare the header
@@ -234,7 +237,8 @@ public class TCZ {
 
   /** Returns the size of the next available chunk */
   public int getNextChunkSize() {
-    return uncompressedSizes[idx];
+    int s = uncompressedSizes[idx];
+    return s < 0 ? -s : s;
   }
 
   /** Fills the given stream with the next available chunk.
@@ -244,8 +248,17 @@ public class TCZ {
    */
   public void readNextChunk(Stream out) throws IOException {
     int s = offsets[idx + 1] - offsets[idx];
-    idx++;
-    ZLib.inflate(in, out, s);
+    if (uncompressedSizes[idx++] >= 0) {
+      ZLib.inflate(in, out, s);
+    } else {
+      byte[] buf = new byte[s]; // stored chunk
+      for (int r = 0, n; r < s; r += n) {
+        if ((n = in.readBytes(buf, r, s - r)) <= 0) {
+          throw new IOException("Unexpected end of the tcz file");
+        }
+      }
+      out.writeBytes(buf, 0, s);
+    }
   }
 
   /** Finds the position of the given name in this tcz. */
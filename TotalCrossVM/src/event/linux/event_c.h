@@ -194,6 +194,9 @@ void privatePumpEvent(Context currentContext)
          }
          TCSDL_Present();
       }
+      if(TCSDL_IsFrameEvent(&event)) { // a frame updated by TCSDL_UpdateTexture
+         TCSDL_Present();
+      }
       if(event.type >= SDL_FINGERDOWN && event.type <= SDL_FINGERMOTION) { // Finger Touch Events
          handleFingerTouchEvent(event);
       }
@@ -132,6 +132,10 @@ uint32 markedAsUsed = 1; // starts as 1
 uint32 objCreated = 0;
 uint32 skippedGC = 0;
 uint32 objLocked = 0; // a few counters
+uint32 minorGCCount = 0;
+uint32 youngPromoted = 0;
+bool incrementalMarking = 0;
+uint32 gcSlices = 0;
 int32 lastGC = 0, markedImages = 0;
 Heap ommHeap = NULL;
 Heap chunksHeap = NULL;
@@ -110,6 +110,9 @@ extern TCObjectArray usedList; // the array with lists of used objects (allocate
 extern TCObjectArray lockList; // locked objects list
 extern uint32 markedAsUsed; // starts as 1
 extern uint32 objCreated,skippedGC,objLocked; // a few counters
+extern uint32 minorGCCount,youngPromoted; // minor collections and young objects that survived them
+extern bool incrementalMarking; // true while an incremental gc cycle is marking objects
+extern uint32 gcSlices; // incremental marking slices
 extern int32 lastGC, markedImages;
 extern Heap ommHeap;
 extern Heap chunksHeap;
@@ -164,6 +164,9 @@ void fillNativeProcAddressesTC()
    htPutPtr(&htNativeProcAddresses, hashCode("tufFM_charWidth_si"), &tufFM_charWidth_si);
    htPutPtr(&htNativeProcAddresses, hashCode("tueE_isAvailable"), &tueE_isAvailable);
    htPutPtr(&htNativeProcAddresses, hashCode("tuC_updateScreen"), &tuC_updateScreen);
+   htPutPtr(&htNativeProcAddresses, hashCode("tuC_startDisplayList_g"), &tuC_startDisplayList_g);
+   htPutPtr(&htNativeProcAddresses, hashCode("tuC_endDisplayList"), &tuC_endDisplayList);
+   htPutPtr(&htNativeProcAddresses, hashCode("tuC_replayDisplayList_gO"), &tuC_replayDisplayList_gO);
    htPutPtr(&htNativeProcAddresses, hashCode("tuMW_exit_i"), &tuMW_exit_i);
    htPutPtr(&htNativeProcAddresses, hashCode("tuMW_setTimerInterval_i"), &tuMW_setTimerInterval_i);
    htPutPtr(&htNativeProcAddresses, hashCode("tuMW_minimize"), &tuMW_minimize);
@@ -21,6 +21,8 @@ typedef enum
    VMTWEAK_TRACE_LOCKED_OBJS,
    VMTWEAK_TRACE_OBJECTS_LEFT_BETWEEN_2_GCS,
    VMTWEAK_TRACE_METHODS,
+   VMTWEAK_INCREMENTAL_GC,    /// Marks the objects in small slices, instead of running the whole gc at once
+   VMTWEAK_TILED_RASTER,      /// Splits the large software drawings in bands of rows, drawn by a pool of threads
 } VmTweak;
 
 #define IS_VMTWEAK_ON(x) (vmTweaks & (1 << (x-1))) // guich@tc114_19: better use this macro
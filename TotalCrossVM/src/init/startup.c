@@ -23,6 +23,8 @@ bool initGraphicsBeforeSettings(Context currentContext, int16 appTczAttr);
 bool initGraphicsAfterSettings(Context currentContext);
 void destroyGraphics();
 
+static char classImagePath[MAX_PATHNAME];
+
 static Context initAll(CharP* args)
 {
    Context c = null;
@@ -53,6 +55,7 @@ static Context initAll(CharP* args)
    ok = ok && (c=initContexts()) != null;
    ok = ok && initObjectMemoryManager();
    ok = ok && initClassInfo();
+   ok = ok && initJit();
    initNativeProcAddresses();
    if (ok) registerWake(true);
    return ok ? c : null;
@@ -72,8 +75,10 @@ static void destroyAll() // must be in inverse order of initAll calls
    destroyObjectMemoryManager(); // must be before ClassInfo destroy
    destroyNativeProcAddresses();
    destroyClassInfo();
+   destroyJit(); // the compiled code belongs to the methods of the classes
    xmemzero(&tcSettings, sizeof(tcSettings));
    destroyTCZ();
+   closeClassImage(); // after the classes and constant pools, which use its strings
    destroyMem();    
    destroyDebug(); // must be after destroy mem, because mem leaks may be written to the debug
    destroyGlobals();
@@ -230,6 +235,10 @@ TC_API int32 startProgram(Context currentContext)
       retrieveSettingsChangedAtStaticInitializer(currentContext);
       // 5. create an instance and call the constructor
       mainClass = createObject(currentContext, mainClassName); // keep it locked
+      if (writeClassImage)
+         debug("Startup took %d ms, %d classes restored from the class image", getTimeStamp() - firstTS, restoredClassCount);
+      if (writeClassImage && currentContext->thrownException == null) // the main window is constructed
+         saveClassImage(classImagePath);
    }
    if (currentContext->thrownException == null && mainClass != null) // no unhandled exception was thrown?
    {
@@ -311,6 +320,9 @@ TC_API int32 startVM(CharP argsOriginal, Context* cOut)
    if (currentContext == null)
       return 100;
 
+   xstrprintf(classImagePath, "%s/%s", appPath, CLASS_IMAGE_NAME);
+   openClassImage(classImagePath); // must be before the first tcz
+
    if (!tczLoad(currentContext, tcbase))
    {
       alert("TCBase not found or corrupted. Please reinstall TotalCross");
@@ -384,6 +396,12 @@ TC_API int32 startVM(CharP argsOriginal, Context* cOut)
                      goto jumpArgument;
                   }
                   break;
+                  case 's': // writes the class image after the main window is constructed
+                  {
+                     writeClassImage = true;
+                     goto jumpArgument;
+                  }
+                  break;
                   case 'p': // required on systems that can't determine the executable directory of the current process
                   {
                      closeDebug(); // close debug file before an appPath change, not terrible :-(
@@ -493,6 +511,7 @@ jumpArgument:
     The loader's name must be the same of the TCZ file that stores the classes.
     Optionally, you may pass as arguments:
       -t trace the program
+      -s writes the class image (startup.tci) after the main window is constructed, to speed up the next launches
       -testsuite: runs the test suite and quits.
 */
 TC_API int32 executeProgram(CharP argsOriginal)
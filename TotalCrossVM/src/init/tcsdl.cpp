@@ -18,6 +18,20 @@ static SDL_Texture* texture = NULL;
 static SDL_Window *window = NULL; 
 static SDL_Surface *surface = NULL;
 static bool usesTexture;
+static int bytesPerPixel;
+
+// SDL renderers may only be used by the thread that created the window,
+// which also pumps its events. The threads that update the screen copy
+// the changed rows to the frame, add them to the dirty union and push a
+// frame event; the window thread uploads that union to the texture when
+// it gets the event and presents it. Skia keeps drawing on screen->pixels
+// while the frame waits, and the texture holds the last presented image.
+static SDL_mutex* frameLock = NULL;
+static uint8* frame = NULL;
+static int framePitch;
+static SDL_Rect frameDirty;
+static bool framePending; // a frame event is in the queue
+static Uint32 frameEvent = (Uint32) -1;
 
 /*
  * Init steps to create a window and texture to Skia handling
@@ -215,39 +229,103 @@ bool TCSDL_Init(ScreenSurface screen, const char* title, bool fullScreen) {
 	SCREEN_EX(screen)->texture = texture;
 	SCREEN_EX(screen)->surface = surface;
 
+	bytesPerPixel = pixelformat->BytesPerPixel;
+
+	if (usesTexture) {
+		framePitch = screen->pitch;
+		frameDirty.w = frameDirty.h = 0;
+		framePending = false;
+		if (IS_NULL(frame = (uint8*) malloc(framePitch * screen->screenH))
+		 || IS_NULL(frameLock = SDL_CreateMutex())
+		 || (frameEvent = SDL_RegisterEvents(1)) == (Uint32) -1) {
+			std::cerr << "Failed to create the frame: " << SDL_GetError() << '\n';
+			return false;
+		}
+	}
+
 	SDL_FreeFormat(pixelformat);
 
 	return true;
 }
 
 /*
- * Update the given texture rectangle with new pixel data.
+ * Update the given rectangle of the screen with new pixel data
  *
- * # MUST BE REVIEWED
+ * Args:
+ * - x, y, w, h: the changed rectangle
+ * - pitch: the size of a row of the pixels
+ * - pixels: the whole screen
  *
- * SDL_UpdateTexture it's too slow and our implementation
- * depends on it
+ * With a texture, the rectangle is copied to the frame and a frame event
+ * is pushed, so the window thread uploads and presents it when it pumps
+ * the events. Returns right away, from any thread.
  */
-void TCSDL_UpdateTexture(int w, int h, int pitch, void* pixels) {
+void TCSDL_UpdateTexture(int x, int y, int w, int h, int pitch, void* pixels) {
+	SDL_Rect rect = {x, y, w, h};
+
+	if (SDL_RectEmpty(&rect)) {
+		return;
+	}
 	if(usesTexture) {
-		// Update the given texture rectangle with new pixel data.
-		SDL_UpdateTexture(texture, NULL, pixels, pitch);
+		uint8* src = (uint8*) pixels + y * pitch + x * bytesPerPixel;
+		uint8* dst = frame + y * framePitch + x * bytesPerPixel;
+		int length = w * bytesPerPixel;
+		bool push;
+
+		SDL_LockMutex(frameLock);
+		for (; h > 0; h--, src += pitch, dst += framePitch) {
+			memcpy(dst, src, length);
+		}
+		SDL_UnionRect(&frameDirty, &rect, &frameDirty);
+		push = !framePending;
+		framePending = true;
+		SDL_UnlockMutex(frameLock);
+
+		if (push) {
+			SDL_Event event;
+			SDL_zero(event);
+			event.type = frameEvent;
+			if (SDL_PushEvent(&event) <= 0) { // the next window event presents it
+				SDL_LockMutex(frameLock);
+				framePending = false;
+				SDL_UnlockMutex(frameLock);
+			}
+		}
+	} else {
+		SDL_UpdateWindowSurfaceRects(window, &rect, 1);
 	}
-	// Call SDL render present
-	TCSDL_Present();
 }
 
 /*
- * Update the screen with rendering performed
+ * Returns true if the event was pushed by TCSDL_UpdateTexture, and must
+ * be handled by calling TCSDL_Present
+ */
+bool TCSDL_IsFrameEvent(SDL_Event* event) {
+	return usesTexture && event->type == frameEvent;
+}
+
+/*
+ * Update the screen with rendering performed. Must be called by the
+ * window thread: with a texture, uploads the dirty union of the frame
+ * first. The frame is locked only during the upload; the present, which
+ * may wait for the vsync, is not.
  */
 void TCSDL_Present() {
   if(usesTexture) {
-    // Copy a portion of the texture to the current rendering target
+    SDL_LockMutex(frameLock);
+    if (!SDL_RectEmpty(&frameDirty)) {
+      SDL_UpdateTexture(texture, &frameDirty, frame + frameDirty.y * framePitch + frameDirty.x * bytesPerPixel, framePitch);
+    }
+    frameDirty.w = frameDirty.h = 0;
+    framePending = false;
+    SDL_UnlockMutex(frameLock);
+
+    // Clears the entire rendering target
+    SDL_RenderClear(renderer);
+    // Copy the texture to the current rendering target
     SDL_RenderCopy(renderer, texture, NULL, NULL);
     // Update the screen with rendering performed
     SDL_RenderPresent(renderer);
-    // Clears the entire rendering targe
-    SDL_RenderClear(renderer);
   } else {
     SDL_UpdateWindowSurface(window);
   }
@@ -257,6 +335,13 @@ void TCSDL_Present() {
  * Destroy all SDL allocated variables
  */
 void TCSDL_Destroy(ScreenSurface screen) {
+	if (frameLock != NULL) {
+		SDL_DestroyMutex(frameLock);
+		frameLock = NULL;
+	}
+	free(frame);
+	frame = NULL;
+
 	if (usesTexture && screen->pixels != NULL) {
 		free(screen->pixels);
 	}
@@ -19,8 +19,9 @@ extern "C" {
     #include "GraphicsPrimitives.h"
 
     bool TCSDL_Init(ScreenSurface screen, const char* title, bool fullScreen);
-    void TCSDL_UpdateTexture(int w, int h, int pitch,void *pixels);
+    void TCSDL_UpdateTexture(int x, int y, int w, int h, int pitch, void *pixels);
     void TCSDL_Present();
+    bool TCSDL_IsFrameEvent(SDL_Event* event);
     void TCSDL_Destroy(ScreenSurface screen);
     void TCSDL_GetWindowSize(ScreenSurface screen, int32* width, int32* height);
 
@@ -46,7 +46,9 @@ VM_FILES =                                    \
 	$(TC_SRCDIR)/tcvm/tcfield.c                \
 	$(TC_SRCDIR)/tcvm/context.c                \
 	$(TC_SRCDIR)/tcvm/tcexception.c            \
-	$(TC_SRCDIR)/tcvm/tcvm.c
+	$(TC_SRCDIR)/tcvm/tcvm.c                   \
+	$(TC_SRCDIR)/tcvm/jit.c                    \
+	$(TC_SRCDIR)/tcvm/classimage.c
 
 INIT_FILES =                                  \
 	$(TC_SRCDIR)/init/demo.c                   \
@@ -153,13 +155,16 @@ NM_UI_FILES =                                 \
 	$(TC_SRCDIR)/nm/ui/gfx_Graphics.c          \
 	$(TC_SRCDIR)/nm/ui/event_Event.c           \
 	$(TC_SRCDIR)/nm/ui/Control.c               \
+	$(TC_SRCDIR)/nm/ui/DisplayList.c           \
 	$(TC_SRCDIR)/nm/ui/font_Font.c             \
 	$(TC_SRCDIR)/nm/ui/font_FontMetrics.c      \
 	$(TC_SRCDIR)/nm/ui/image_Image.c           \
 	$(TC_SRCDIR)/nm/ui/MainWindow.c            \
+	$(TC_SRCDIR)/nm/ui/PixelKernels.c          \
 	$(TC_SRCDIR)/nm/ui/media_Sound.c           \
 	$(TC_SRCDIR)/nm/ui/media_MediaClip.c       \
 	$(TC_SRCDIR)/nm/ui/media_Camera.c          \
+	$(TC_SRCDIR)/nm/ui/TileRaster.c            \
 	$(TC_SRCDIR)/nm/ui/Window.c
 
 NM_UTIL_FILES =                               \
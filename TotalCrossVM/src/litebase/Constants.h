@@ -16,6 +16,10 @@
 #define DB_EXT   ".db"  // Database files.
 #define DBO_EXT  ".dbo" // Database object files.
 #define IDK_EXT  ".idk" // Index b-tree files.
+#define JTK_EXT  ".jtk" // Sorted join keys temporary files.
+#define JTR_EXT  ".jtr" // Sorted join keys runs temporary files.
+#define ISR_EXT  ".isr" // Sorted index keys runs temporary files.
+#define TSR_EXT  ".tsr" // Sorted temporary table keys runs temporary files.
 
 // juliana@noidr_1: removed .idr files from all indices and changed its format. 
 
@@ -44,7 +48,6 @@
 
 // Constants for tables and indices.
 #define DEFAULT_ROW_INC  10    // The default record increment when growing the table file.  
-#define CACHE_SIZE       20    // The index cache size.
 #define RECGROWSIZE      64    // The record increment for indices.
 #define SECTOR_SIZE      512   // The record size used to calculate the number of keys per b-tree node.
 #define MAX_IDX          65534 // The maximum number of nodes of an index. // juliana@noidr_2
@@ -53,6 +56,56 @@
 #define DEFAULT_HEADER   512   // The default header size.
 #define VERSION_TABLE    203   // The current table format version. // juliana@230_12
 
+// The pool of the index nodes of a connection.
+#define NODE_POOL_MIN_NODES 20     // The minimum number of nodes kept by the pool, whatever its budget is.
+#define NODE_POOL_BUDGET    262144 // The default memory budget of the pool.
+#define NODE_POOL_BUCKETS   64     // The initial number of buckets of the pool hash table.
+
+// The build of an index from its sorted keys.
+#define INDEX_SORT_BUDGET  2097152 // The memory used to sort the keys of an index. Larger indices have their keys sorted in runs merged on disk.
+#define INDEX_RUN_KEYS     4096    // The minimum number of keys of each run sorted in memory before being merged on disk.
+#define INDEX_BLOCK_KEYS   64      // The number of keys read at once from a sorted run.
+#define INDEX_BUILD_LEVELS 17      // The maximum height of an index built from its leaves, whose nodes have at least two children.
+
+// The sort of a temporary table for ORDER BY or GROUP BY.
+#define TABLE_SORT_BUDGET 2097152 // The memory used by the keys of a sorted table. Larger tables have their keys sorted in runs merged on disk.
+#define TABLE_RUN_KEYS    1024    // The minimum number of keys of each run sorted in memory before being merged on disk.
+#define TABLE_BLOCK_KEYS  64      // The number of keys read at once from a sorted run.
+#define TABLE_SORT_SLICES 8       // The maximum number of slices of a run sorted by different threads and then merged in memory.
+
+// The aggregation of a GROUP BY of a single table in a hash table of groups.
+#define GROUP_BY_BUDGET  2097152 // The memory used by the groups. Queries with more groups have their rows written to a temporary table and sorted.
+#define GROUP_BY_BUCKETS 64      // The initial number of buckets of the hash table of the groups.
+
+// The statistics of the tables gathered by ANALYZE and the plans chosen with them.
+#define STATISTICS_MARKER     0x54415453 // Marks the statistics stored in the header of .db after the table meta data.
+#define STATISTICS_SAMPLE     2048       // The maximum number of rows read to compute the statistics of a table.
+#define STATISTICS_BUCKETS    16         // The maximum number of buckets of the equi-depth histogram of a numeric column.
+#define INDEX_MAX_SELECTIVITY 0.2        // The fraction of the rows above which a comparison of an analyzed table is evaluated without its index.
+#define PLANNER_MAX_TABLES    6          // The maximum number of tables of a join whose orders are all compared by the planner.
+#define DEFAULT_EQUAL_SELECTIVITY 0.1    // The fraction of the rows which satisfies an equality of a column without statistics.
+#define DEFAULT_RANGE_SELECTIVITY 0.33   // The fraction of the rows which satisfies any other comparison without statistics.
+
+// The access to a table in a plan shown by EXPLAIN.
+#define PLAN_SCAN       0 // All the rows are read.
+#define PLAN_INDEX      1 // The rows are found by an index.
+#define PLAN_JOIN_INDEX 2 // The rows of an inner table are found by an index with the key of the outer row.
+#define PLAN_JOIN_KEYS  3 // The rows of an inner table are found by the sorted keys of the join.
+
+// The trigram indices, which find the rows whose strings may contain a substring searched by LIKE '%...%'.
+#define TRIGRAM_INDEX_PREFIX 't' // Follows the '$' in the name of the file of a trigram index, to tell it apart from a simple index.
+#define TRIGRAM_BUFFER_SIZE  64  // The number of trigrams of a string computed without allocating memory.
+
+// The cache of the statements of a connection.
+#define STATEMENT_CACHE_SIZE 16 // The number of statements executed without being prepared which are kept parsed by a connection.
+
+// The write-ahead log of a connection.
+#define WAL_EXTENSION      ".lbw"  // The extension of the log files.
+#define WAL_RECORD_WRITE   1       // A record with bytes written to a table file.
+#define WAL_RECORD_SIZE    2       // A record with the new size of a table file.
+#define WAL_RECORD_COMMIT  3       // A record that ends a transaction, followed by the crc32 of its records.
+#define WAL_CHECKPOINT     1048576 // The log size that makes a commit copy the log contents into the table files and empty it.
+
 // Aggregate Functions supported
 #define FUNCTION_AGG_NONE   -1 // No function.
 #define FUNCTION_AGG_COUNT  0  // COUNT()
@@ -125,6 +178,9 @@
 #define CMD_INSERT               11 // INSERT INTO ...
 #define CMD_UPDATE               12 // UPDATE ...
 #define CMD_DELETE               13 // DELETE ...
+#define CMD_BEGIN                14 // BEGIN
+#define CMD_COMMIT               15 // COMMIT
+#define CMD_ANALYZE              16 // ANALYZE ...
 
 #define HCROWID    108705909   // hash code for the rowid.
 #define LOGS_INT   1280264019  // LOGS_INT = Convert.chars2int("LOGS");
@@ -143,6 +199,7 @@
 #define ATTR_COLUMN_HAS_INDEX    1   // This column has an index.
 #define ATTR_COLUMN_HAS_DEFAULT  2   // This column has default value.
 #define ATTR_COLUMN_IS_NOT_NULL  4   // This column can't be null.
+#define ATTR_COLUMN_HAS_TRIGRAM  8   // This column has a trigram index.
 #define ATTR_COLUMN_HAS_NO_INDEX -2  // ~ATTR_COLUMN_HAS_INDEX // juliana@227_6
 #define ATTR_DEFAULT_AUX_ROWID   -1  // rnovais@570_61: Auxiliar default rowid.
 
@@ -168,17 +225,20 @@
 #define PARSER_ERROR   -2 // Parser error.  
 
 // Reserved words.
-#define NUM_RESERVED 61          // Number of reserved words.
+#define NUM_RESERVED 66          // Number of reserved words.
 #define HT_ABS			96370       // ABS reserved word hash code.
 #define HT_ADD			96417       // ADD reserved word hash code.
 #define HT_ALTER		92913686    // ALTER reserved word hash code.
+#define HT_ANALYZE	-864330420  // ANALYZE reserved word hash code.
 #define HT_AND			96727       // AND reserved word hash code. 
 #define HT_AS			3122        // AS reserved word hash code.
 #define HT_ASC			96881       // ASC reserved word hash code.
 #define HT_AVG			96978       // AVG reserved word hash code.
+#define HT_BEGIN		93616297    // BEGIN reserved word hash code.
 #define HT_BLOB		3026845     // BLOB reserved word hash code.
 #define HT_BY			3159        // BY reserved word hash code.
 #define HT_CHAR		3052374     // CHAR reserved word hash code.
+#define HT_COMMIT		-1354815177 // COMMIT reserved word hash code.
 #define HT_COUNT		94851343    // COUNT reserved word hash code.
 #define HT_CREATE		-1352294148 // CREATE reserved word hash code.
 #define HT_DATE		3076014     // DATE reserved word hash code. 
@@ -190,6 +250,7 @@
 #define HT_DISTINCT  288698108   // DISTINCT reserved word hash code.
 #define HT_DOUBLE		-1325958191 // DOUBLE reserved word hash code.
 #define HT_DROP		3092207     // DROP reserved word hash code.
+#define HT_EXPLAIN	-1309162249 // EXPLAIN reserved word hash code.
 #define HT_FLOAT		97526364    // FLOAT reserved word hash code.
 #define HT_FROM		3151786     // FROM reserved word hash code.
 #define HT_GROUP		98629247    // GROUP reserved word hash code.
@@ -226,6 +287,7 @@
 #define HT_TO			3707        // TO reserved word hash code.
 #define HT_UPDATE		-838846263  // UPDATE reserved word hash code.
 #define HT_UPPER		111499426   // UPPER reserved word hash code.
+#define HT_USING		111582340   // USING reserved word hash code.
 #define HT_VALUES		-823812830  // VALUES reserved word hash code.
 #define HT_VARCHAR	236613373   // VARCHAR reserved word hash code.
 #define HT_WHERE		113097959   // WHERE reserved word hash code.
@@ -311,6 +373,11 @@
 #define TK_GREATER_EQUAL   73 // '>=' token.
 #define TK_LESS_EQUAL      74 // '<=' token.
 #define TK_DIFF            75 // '<>' or '!=' token.
+#define TK_BEGIN           76 // BEGIN reserved word token.
+#define TK_COMMIT          77 // COMMIT reserved word token.
+#define TK_ANALYZE         78 // ANALYZE reserved word token.
+#define TK_EXPLAIN         79 // EXPLAIN reserved word token.
+#define TK_USING           80 // USING reserved word token.
 
 // Litebase languages.
 #define LANGUAGE_EN  1 // English language.
@@ -459,9 +526,20 @@
 #define ERR_COMP_BLOBS          88 // "It is not possible to compare BLOBs."
 #define ERR_BLOBS_PREPARED      89 // "It is only possible to insert or update a BLOB through prepared statements."
 
-#define TOTAL_ERRORS  90 // Total Litebase possible errors.
+// Transaction errors.
+#define ERR_WAL_DISABLED        90 // "Transactions are only available on connections opened with the wal parameter."
+#define ERR_TRANSACTION_STARTED 91 // "A transaction was already started."
+#define ERR_NO_TRANSACTION      92 // "There is no transaction to be committed."
+#define ERR_TRANSACTION_DDL     93 // "This operation can't be executed inside a transaction."
+#define ERR_TRANSACTION_FAILED  95 // "A command of the transaction failed, so it can't be committed. Close the connection to discard it."
+
+// Trigram index errors.
+#define ERR_TRIGRAM_INDEX       94 // "A trigram index must have a single CHAR or VARCHAR column."
+
+#define TOTAL_ERRORS  96 // Total Litebase possible errors.
 
 #define MAX_NUM_INDEXES_APPLIED 32 // The maximum number of indexes to be applied. 
+#define MAX_SCAN_PREDICATES      8 // The maximum number of conditions of a WHERE clause split to be tested directly on the rows.
 
 // Pattern matching types.
 #define PAT_MATCH_STARTS_WITH  1 // %...
@@ -477,6 +555,7 @@
 #define COUNT_WITH_WHERE  1 // select count(*) from table_name where ... 
 
 #define CACHE_INITIAL_SIZE  2048 // Table files initial cache size.
+#define MAP_GROWTH_SIZE     65536 // The granularity of the memory mappings of table files, which are reserved larger than the files.
 #define INDEX_SORT_MAX_TIME 40   // The maximum time (in seconds) that will be taken to sort a table before creating the index.
 
 // Join operation constants.
@@ -486,6 +565,11 @@
 #define VALIDATION_RECORD_INCOMPLETE     3 // Must continue the validation.
 #define VALIDATION_RECORD_INCOMPLETE_OK  4 // Used internally on booleanTreeEvaluateJoin(). The current branch was validated as true.
 
+// Lookup of the rows of a join compared with an equality to a column without an index.
+#define JOIN_MEMORY_BUDGET 2097152 // The default memory budget of the join keys hash table. Larger tables have their keys sorted on disk.
+#define JOIN_RUN_PAIRS     4096    // The minimum number of keys of each run sorted in memory before being merged on disk.
+#define JOIN_BLOCK_PAIRS   256     // The number of keys read at once from a sorted run and the distance between two fences of the sorted keys.
+
 // guich@_300: addes support for basic synchronization.
 #define ROW_ATTR_SYNCED   0X00000000L // Indicates if the a row was synced. 
 #define ROW_ATTR_NEW      0X40000000L // Indicates if the row is new.
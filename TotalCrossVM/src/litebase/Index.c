@@ -69,13 +69,14 @@ Index* createIndex(Context context, Table* table, int8* keyTypes, int32* colSize
    index->nodeRecSize = 2 + index->btreeMaxNodes * (index->keyRecSize = keyRecSize) + ((index->btreeMaxNodes + 1) << 1); 
    
    index->heap = heap;
+   index->poolNodeSize = nodePoolNodeSize(index);
    
 // juliana@230_35: now the first level nodes of a b-tree index will be loaded in memory.
    index->firstLevel = (Node**)TC_heapAlloc(heap, index->btreeMaxNodes * TSIZE); // Creates the first index level. 
    
    // juliana@223_14: solved possible memory problems.
    // Creates the root node.
-   index->root = createNode(index); 
+   index->root = createNode(index, index->heap); 
    // juliana@230_32 
    index->root->idx = 0;
    
@@ -217,6 +218,147 @@ error:
    return false; 
 }
 
+/**
+ * Creates a trigram index, which maps the trigrams of the strings of a column to the rows that have them.
+ * 
+ * @param context The thread context where the function is being executed.
+ * @param table The table whose index is to be created.
+ * @param columnHash The hash of the index column.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the column for the index does not exist or is not a <code>CHAR</code> or <code>VARCHAR</code> column.
+ * @throws AlreadyCreatedException If the column already has a trigram index.
+ */
+bool driverCreateTrigramIndex(Context context, Table* table, int32 columnHash)
+{
+   TRACE("driverCreateTrigramIndex")
+   int32 column = TC_htGet32Inv(&table->htName2index, columnHash), 
+         type;
+   Heap heap;
+
+   if (column < 0) // Column not found.
+   {
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_COLUMN_NOT_FOUND), "");
+      return false;
+   }
+   if ((type = table->columnTypes[column]) != CHARS_TYPE && type != CHARS_NOCASE_TYPE) // Only strings have trigrams.
+   {
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_TRIGRAM_INDEX));
+      return false;
+   }
+   if (table->columnTrigrams && table->columnTrigrams[column])
+   {
+      TC_throwExceptionNamed(context, "litebase.AlreadyCreatedException", getMessage(ERR_INDEX_ALREADY_CREATED), table->columnNames[column]);
+      return false;
+   }
+
+   // juliana@250_10: removed some cases when a table was marked as not closed properly without being changed.
+   if (!setModified(context, table))
+      return false;
+
+   heap = heapCreate();
+   IF_HEAP_ERROR(heap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      heapDestroy(heap);
+      return false;
+   }
+   if (!indexCreateTrigramIndex(context, table, table->name, column, false, heap))
+   {
+      heapDestroy(heap);
+      return false;
+   }
+
+   if (table->db.rowCount > 0 && !tableReIndexTrigrams(context, table, column)) // The rows already inserted are indexed.
+   {
+      driverDropTrigramIndex(context, table, column);
+      return false;
+   }
+   return tableSaveMetaData(context, table, TSMD_ATLEAST_INDEXES);
+}
+
+/**
+ * Computes the distinct trigrams of a string, which are its sequences of three consecutive characters. The characters are converted to lower 
+ * case so that the trigrams serve to both case sensitive and caseless searches. Each trigram is encoded in an int with ten bits per character; 
+ * characters beyond the first 1024 ones may give the same code to different trigrams, which only makes an index return rows that don't match.
+ *
+ * @param chars The characters of the string.
+ * @param length The length of the string.
+ * @param trigrams Receives the codes of the trigrams in ascending order. It must have room for <code>length - 2</code> codes. 
+ * @return The number of distinct trigrams.
+ */
+int32 computeTrigrams(JCharP chars, int32 length, int32* trigrams)
+{
+   TRACE("computeTrigrams")
+   int32 count = 0,
+         i = -1,
+         j,
+         code;
+
+   while (++i < length - 2)
+   {
+      code = ((TC_JCharToLower(chars[i]) & 0x3FF) << 20) | ((TC_JCharToLower(chars[i + 1]) & 0x3FF) << 10) 
+           | (TC_JCharToLower(chars[i + 2]) & 0x3FF);
+
+      // Inserts the code in order, unless it is repeated.
+      j = count;
+      while (--j >= 0 && trigrams[j] > code);
+      if (j < 0 || trigrams[j] != code)
+      {
+         xmemmove(&trigrams[j + 2], &trigrams[j + 1], (count++ - j - 1) << 2);
+         trigrams[j + 1] = code;
+      }
+   }
+   return count;
+}
+
+/**
+ * Adds or removes the trigrams of a string of a row to or from a trigram index.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param index The trigram index.
+ * @param value The string.
+ * @param record The row of the string.
+ * @param isRemove Indicates if the trigrams are to be removed instead of added.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+bool indexUpdateTrigrams(Context context, Index* index, SQLValue* value, int32 record, bool isRemove)
+{
+   TRACE("indexUpdateTrigrams")
+   int32 buffer[TRIGRAM_BUFFER_SIZE];
+   int32* trigrams = buffer;
+   int32 count;
+   bool ret = true;
+   SQLValue trigram;
+   SQLValue* trigramPtr = &trigram;
+   Key key;
+
+   if (value->length > TRIGRAM_BUFFER_SIZE + 2 && !(trigrams = (int32*)xmalloc((value->length - 2) << 2)))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+
+   xmemzero(&trigram, sizeof(SQLValue));
+   key.keys = &trigram;
+   count = computeTrigrams(value->asChars, value->length, trigrams);
+   while (ret && --count >= 0)
+   {
+      trigram.asInt = trigrams[count];
+      if (isRemove)
+      {
+         keySet(&key, &trigramPtr, index, 1);
+         ret = indexRemoveValue(context, &key, record);
+      }
+      else
+         ret = indexAddKey(context, index, &trigramPtr, record);
+   }
+
+   if (trigrams != buffer)
+      xfree(trigrams);
+   return ret;
+}
+
 /**
  * Removes a value from the index.
  *
@@ -306,7 +448,6 @@ bool indexRemoveValue(Context context, Key* key, int32 record)
 Node* indexLoadNode(Context context, Index* index, int32 idx)
 {
 	TRACE("indexLoadNode")
-   int32 i = CACHE_SIZE;
    Node* cand;
    Node** nodes;
    
@@ -323,7 +464,7 @@ Node* indexLoadNode(Context context, Index* index, int32 idx)
    {
       if (!(cand = (nodes = index->firstLevel)[idx - 1]))
       {
-         (cand = nodes[idx - 1] = createNode(index))->idx = idx;
+         (cand = nodes[idx - 1] = createNode(index, index->heap))->idx = idx;
          nodeLoad(context, cand);
       }
       else if (cand->idx == (uint16)-1)
@@ -334,33 +475,9 @@ Node* indexLoadNode(Context context, Index* index, int32 idx)
       return cand;
    }
    
-   // Loads the cache if the node is in a deeper level.
-   nodes = index->cache;
-   while (--i >= 0) // Loads the cache.
-      if (nodes[i] && nodes[i]->idx == idx) 
-         return nodes[index->cacheI = i];
-   
-   if (++index->cacheI >= CACHE_SIZE)
-      index->cacheI = 0;
-
-   IF_HEAP_ERROR(index->heap) // juliana@223_14: solved possible memory problems.
-   {
-      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-      return null;
-   }
-   
+   // The nodes of the deeper levels are kept in the node pool of the connection.
    // juliana@230_25: solved a bug with index with repeated keys which could not be built correctly.
-	if (!(cand = nodes[index->cacheI]))
-      cand = nodes[index->cacheI] = createNode(index);
-   
-   if (index->isWriteDelayed && cand->isDirty && nodeSave(context, cand, false, 0, cand->size) < 0) // Saves this one if it is dirty.
-      return null;
-   cand->idx = idx;
-   
-   // Loads the node.
-   if (!nodeLoad(context, cand))
-      return null;
-   return cand;
+   return nodePoolGet(context, index, idx, true);
 }
 
 /**
@@ -478,7 +595,7 @@ bool indexClimbGreaterOrEqual(Context context, Node* node, int32 start, MarkBits
 		if (index->nodesArrayCount > 0) 
 			curr = (Node*)index->nodes[--index->nodesArrayCount];
 		else 
-         curr = createNode(index); // juliana@230_32: corrected a bug of inequality searches in big indices not returning all the results.
+         curr = createNode(index, index->heap); // juliana@230_32: corrected a bug of inequality searches in big indices not returning all the results.
 
       while (!(*stop) && ++start <= size)
       {
@@ -646,6 +763,7 @@ bool indexRemove(Context context, Index* index)
    if (index->heap && !nfRemove(context, &index->fnodes, table->sourcePath))
       return false;
    
+   nodePoolRemoveIndex(index);
    heapDestroy(index->heap);
    return true;
 }
@@ -664,6 +782,7 @@ bool indexClose(Context context, Index* index)
       
    index->fnodes.finalPos = index->nodeCount * index->nodeRecSize; // Calculated the used space; the file will have no zeros at the end. 
    ret = nfClose(context, &index->fnodes);
+   nodePoolRemoveIndex(index);
    heapDestroy(index->heap);
    return ret;
 }
@@ -680,31 +799,14 @@ bool indexDeleteAllRows(Context context, Index* index)
 {
 	TRACE("indexDeleteAllRows")
    int32 i;
-   Node** cache = index->cache;
    Node** firstLevel = index->firstLevel;
    XFile* fnodes = &index->fnodes;
 
-// juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
-// Some files might have been closed if the maximum number of opened files was reached.
-#if defined(POSIX) || defined(ANDROID)
-   if ((i = reopenFileIfNeeded(context, fnodes)))
-   {
-      fileError(context, i, fnodes->name);
-      return false;
-   }
-#endif
-
    // It is faster truncating a file than re-creating it again. 
-   if ((i = lbfileSetSize(&fnodes->file, 0)))
-   {
-      fileError(context, i, fnodes->name);
+   if (!nfResize(context, fnodes, fnodes->size, 0))
       return false;
-   }
    
-   i = CACHE_SIZE;
-   while (--i >= 0) // Erases the cache.
-      if (cache[i])
-			cache[i]->idx = -1;
+   nodePoolRemoveIndex(index); // Erases the nodes kept in the node pool.
 	
 	i = index->btreeMaxNodes;
 	while (--i >= 0) // Erases the first level nodes.
@@ -712,7 +814,6 @@ bool indexDeleteAllRows(Context context, Index* index)
          firstLevel[i]->idx = -1;
 
    // juliana@220_6: The node count should be reseted when recreating the indices.
-   index->cacheI = 0;
    index->nodeCount = fnodes->size = fnodes->position = fnodes->finalPos = fnodes->cachePos = fnodes->cacheIsDirty = 0;
    return true;
 }
@@ -740,11 +841,7 @@ bool indexSetWriteDelayed(Context context, Index* index, bool delayed)
    while (--i >= 0)
       ret &= nodeSetWriteDelayed(context, nodes[i], delayed);
    
-   // Commits the pending cache nodes.
-   nodes = index->cache;
-   i = CACHE_SIZE;
-   while (--i >= 0)
-      ret &= nodeSetWriteDelayed(context, nodes[i], delayed);
+   ret &= nodePoolSetWriteDelayed(context, index, delayed); // Commits the pending nodes of the node pool.
       
    if (!delayed) // Shrinks the values.
       ret &= nfGrowTo(context, &index->fnodes, index->nodeCount * index->nodeRecSize);
@@ -849,6 +946,580 @@ bool indexAddKey(Context context, Index* index, SQLValue** values, int32 record)
    return true;
 }
 
+/**
+ * Starts the build of an index from its keys given in ascending order. The index must be empty.
+ *
+ * @param builder The index builder.
+ * @param index The index being built.
+ * @param heap A heap to allocate the nodes being filled.
+ */
+void indexBuildStart(IndexBuilder* builder, Index* index, Heap heap)
+{
+   TRACE("indexBuildStart")
+   xmemzero(builder, sizeof(IndexBuilder));
+   builder->index = index;
+   builder->heap = heap;
+}
+
+/**
+ * Adds a key to an index being built. The key must not be less than the keys already added, with the keys of the same value ordered by their 
+ * records. When the leaf being filled is full, its last key goes up as the separator of the leaf and the next one, which may fill the node above
+ * it, and the leaf is written.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param builder The index builder.
+ * @param values The key to be added.
+ * @param record The record of the key in the table.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the index gets too large.
+ */
+bool indexBuildAdd(Context context, IndexBuilder* builder, SQLValue** values, int32 record)
+{
+   TRACE("indexBuildAdd")
+   Index* index = builder->index;
+   Node** nodes = builder->nodes;
+   Node* node;
+   Key* from;
+   Key key;
+   SQLValue keys[MAXIMUMS + 1];
+   int32 max = index->btreeMaxNodes - 1,
+         level = 0,
+         left = LEAF,
+         size;
+
+   if (max < 2) // The nodes are too small to keep a free position: inserts the key from the root.
+      return indexAddKey(context, index, values, record);
+
+   if (!builder->levels) // The first key reserves the root position.
+   {
+      index->root->size = 0;
+      if (nodeSave(context, index->root, true, 0, 0) < 0)
+         return false;
+   }
+
+   key.keys = keys;
+   keySet(from = &key, values, index, index->numberColumns);
+   key.record = record;
+
+   while (true)
+   {
+      if (level == builder->levels) // The index gets a new level.
+         (nodes[builder->levels++] = createNode(index, builder->heap))->size = 0;
+      
+      if ((size = (node = nodes[level])->size) < max) // There is room for the key.
+      {
+         keySetFromKey(&node->keys[size], from);
+         node->children[size] = left;
+         node->size++;
+         return true;
+      }
+
+      // The node is full. Its last key has the last child as its left child and goes to the level above. The key being added starts the node 
+      // again.
+      if ((size = nodeSave(context, node, true, 0, max - 1)) < 0)
+         return false;
+      keySetFromKey(node->keys, from);
+      *node->children = left;
+      node->size = 1;
+      from = &node->keys[max - 1];
+      left = size;
+      level++;
+   }
+}
+
+/**
+ * Finishes the build of an index, writing the last node of each level. The node of the top level becomes the root.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param builder The index builder.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the index gets too large.
+ */
+bool indexBuildFinish(Context context, IndexBuilder* builder)
+{
+   TRACE("indexBuildFinish")
+   Node* root = builder->index->root;
+   Node* node;
+   int32 top = builder->levels - 1,
+         level = -1,
+         left = LEAF,
+         i;
+
+   if (top < 0) // No keys.
+      return true;
+
+   while (++level < top)
+   {
+      node = builder->nodes[level];
+      node->children[node->size] = left;
+      if ((left = nodeSave(context, node, true, 0, node->size)) < 0)
+         return false;
+   }
+
+   node = builder->nodes[top];
+   node->children[i = node->size] = left;
+   xmemmove(root->children, node->children, (i + 1) << 1);
+   root->size = i;
+   while (--i >= 0)
+      keySetFromKey(&root->keys[i], &node->keys[i]);
+   return nodeSave(context, root, false, 0, root->size) >= 0;
+}
+
+/**
+ * Starts sorting the keys of an index being built from the rows of its table. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param index The index being built, which must be empty.
+ * @param rows The number of rows of the table.
+ * @param isPKCreation Indicates that the index is of a primary key.
+ * @param heap A heap to allocate the keys.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the runs file can't be created.
+ * @throws OutOfMemoryError If there is not enough memory to allocate the runs information.
+ */
+bool indexSortStart(Context context, IndexSorter* sorter, Index* index, int32 rows, bool isPKCreation, Heap heap)
+{
+   TRACE("indexSortStart")
+   int8* types = index->types;
+   int32* sizes = index->colSizes;
+   int32 type = *types,
+         n = index->numberColumns,
+         keySize = 4,
+         memory = TSIZE + TSIZE,
+         i = n;
+   char name[DBNAME_SIZE];
+
+   xmemzero(sorter, sizeof(IndexSorter));
+   sorter->index = index;
+   sorter->heap = heap;
+   sorter->isPKCreation = isPKCreation;
+   sorter->isRecordInLength = type == DATETIME_TYPE || type == LONG_TYPE || type == DOUBLE_TYPE;
+   indexBuildStart(&sorter->builder, index, heap);
+
+   // A string key is stored in the runs file with its position in the .dbo, its length, and its characters.
+   while (--i >= 0)
+   {
+      keySize += sizes[i]? 6 + (sizes[i] << 1) : typeSizes[types[i]];
+      memory += TSIZE + sizeof(SQLValue) + (sizes[i]? (sizes[i] << 1) + 2 : 0);
+   }
+   sorter->keySize = keySize;
+
+   if (index->isOrdered) // The keys are given to the builder as they are read.
+      sorter->capacity = 1;
+   else
+   {
+      sorter->capacity = MIN(MAX(INDEX_RUN_KEYS, INDEX_SORT_BUDGET / memory), MAX(rows, 1));
+      if (n == 1 && (type == SHORT_TYPE || type == INT_TYPE || type == LONG_TYPE || type == DATE_TYPE)) // Integers use a radix sort.
+         sorter->temp = (SQLValue***)TC_heapAlloc(heap, sorter->capacity * TSIZE);
+   }
+   sorter->values = indexSortAllocKeys(sorter, sorter->capacity);
+   if (isPKCreation)
+      sorter->last = *indexSortAllocKeys(sorter, 1);
+
+   if (!index->isOrdered && rows > sorter->capacity) // More than one run may be necessary.
+   {
+      xstrcpy(name, index->name);
+      xstrcat(name, ISR_EXT);
+      if (!nfCreateFile(context, name, true, false, index->table->sourcePath, &sorter->runs, -1))
+         return false;
+      sorter->buffer = (uint8*)TC_heapAlloc(heap, keySize);
+      if (!(sorter->runEnds = (int32*)xmalloc((rows / sorter->capacity + 1) << 4)))
+      {
+         TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+         return false;
+      }
+   }
+   return true;
+}
+
+/**
+ * Allocates keys for the sort of an index, with the space for the characters of their strings.
+ *
+ * @param sorter The index sorter.
+ * @param count The number of keys.
+ * @return The keys allocated.
+ */
+SQLValue*** indexSortAllocKeys(IndexSorter* sorter, int32 count)
+{
+   TRACE("indexSortAllocKeys")
+   Heap heap = sorter->heap;
+   int32* sizes = sorter->index->colSizes;
+   int32 n = sorter->index->numberColumns,
+         i;
+   SQLValue*** keys = (SQLValue***)TC_heapAlloc(heap, count * TSIZE);
+   SQLValue* value;
+
+   while (--count >= 0)
+   {
+      keys[count] = (SQLValue**)TC_heapAlloc(heap, n * TSIZE);
+      i = n;
+      while (--i >= 0)
+      {
+         value = keys[count][i] = (SQLValue*)TC_heapAlloc(heap, sizeof(SQLValue));
+         if (sizes[i])
+            value->asChars = (JCharP)TC_heapAlloc(heap, (sizes[i] << 1) + 2);
+      }
+   }
+   return keys;
+}
+
+/**
+ * Gets the key where the next key of an index being built is to be read into. If the current run is full, it is sorted and written to the runs
+ * file before.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return The key or <code>null</code> if an error occurs.
+ */
+SQLValue** indexSortNext(Context context, IndexSorter* sorter)
+{
+   TRACE("indexSortNext")
+   if (sorter->count == sorter->capacity && !indexSortWriteRun(context, sorter))
+      return null;
+   return sorter->values[sorter->count];
+}
+
+/**
+ * Adds the key read into the key returned by <code>indexSortNext()</code> to the keys of an index being built.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param record The record of the key in the table.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws PrimaryKeyViolationException If the index is ordered and has a duplicated primary key.
+ */
+bool indexSortAdd(Context context, IndexSorter* sorter, int32 record)
+{
+   TRACE("indexSortAdd")
+   SQLValue** values = sorter->values[sorter->count];
+
+   // juliana@202_7: Corrected a bug that would cause long and double indices to be built incorrectly.
+   // The record value is stored in an empty field of the first record column value.
+   if (sorter->isRecordInLength)
+      (*values)->length = record;
+   else
+      (*values)->asTime = record;
+
+   if (sorter->index->isOrdered)
+      return indexSortEmit(context, sorter, values);
+   sorter->count++;
+   return true;
+}
+
+/**
+ * Sorts the keys of the current run of an index being built. A radix sort is done for integer types. It is much more efficient than quick sort.
+ *
+ * @param sorter The index sorter.
+ */
+void indexSortRun(IndexSorter* sorter)
+{
+   TRACE("indexSortRun")
+   Index* index = sorter->index;
+
+   if (sorter->count < 2)
+      return;
+   if (sorter->temp)
+      radixSort(sorter->values, sorter->count, *index->types, sorter->temp);
+   else
+      sortRecords(sorter->values, index->numberColumns, index->types, 0, sorter->count - 1, index->table->nodes); 
+}
+
+/**
+ * Sorts the keys of the current run of an index being built and writes them to the runs file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the runs file can't be written.
+ */
+bool indexSortWriteRun(Context context, IndexSorter* sorter)
+{
+   TRACE("indexSortWriteRun")
+   XFile* runs = &sorter->runs;
+   SQLValue*** values = sorter->values;
+   uint8* buffer = sorter->buffer;
+   int32 count = sorter->count,
+         keySize = sorter->keySize,
+         i = -1;
+
+   indexSortRun(sorter);
+   if ((uint32)(sorter->total + count) * keySize > runs->size && !nfGrowTo(context, runs, (sorter->total + count) * keySize))
+      return false;
+   nfSetPos(runs, sorter->total * keySize);
+   while (++i < count)
+   {
+      indexSortSaveKey(sorter, values[i], buffer);
+      if (!nfWriteBytes(context, runs, buffer, keySize))
+         return false;
+   }
+   sorter->runEnds[sorter->runCount++] = sorter->total += count;
+   sorter->count = 0;
+   return true;
+}
+
+/**
+ * Saves a key of an index being built in the format of the runs file.
+ *
+ * @param sorter The index sorter.
+ * @param values The key to be saved.
+ * @param buffer The buffer where the key is saved.
+ */
+void indexSortSaveKey(IndexSorter* sorter, SQLValue** values, uint8* buffer)
+{
+   TRACE("indexSortSaveKey")
+   Index* index = sorter->index;
+   SQLValue* value;
+   int8* types = index->types;
+   int32* sizes = index->colSizes;
+   int32 n = index->numberColumns,
+         i = -1,
+         length;
+
+   length = sorter->isRecordInLength? (*values)->length : (*values)->asTime;
+   xmove4(buffer, &length);
+   buffer += 4;
+   while (++i < n)
+   {
+      value = values[i];
+      if (sizes[i])
+      {
+         length = value->length;
+         xmove4(buffer, &value->asInt);
+         xmove2(buffer + 4, &length);
+         xmemmove(buffer + 6, value->asChars, length << 1);
+         buffer += 6 + (sizes[i] << 1);
+      }
+      else
+      {
+         // Note: since primitive types are being written, it is possible to use any PlainDB available.
+         writeValue(null, null, value, buffer, types[i], 0, true, true, false, false);
+         buffer += typeSizes[types[i]];
+      }
+   }
+}
+
+/**
+ * Loads a key of an index being built from the format of the runs file.
+ *
+ * @param sorter The index sorter.
+ * @param values The key to be loaded.
+ * @param buffer The buffer where the key is stored.
+ */
+void indexSortLoadKey(IndexSorter* sorter, SQLValue** values, uint8* buffer)
+{
+   TRACE("indexSortLoadKey")
+   Index* index = sorter->index;
+   PlainDB* plainDB = &index->table->db;
+   SQLValue* value;
+   int8* types = index->types;
+   int32* sizes = index->colSizes;
+   int32 n = index->numberColumns,
+         i = -1,
+         record,
+         length;
+
+   xmove4(&record, buffer);
+   buffer += 4;
+   while (++i < n)
+   {
+      value = values[i];
+      if (sizes[i])
+      {
+         length = 0;
+         xmove4(&value->asInt, buffer);
+         xmove2(&length, buffer + 4);
+         xmemmove(value->asChars, buffer + 6, (value->length = length) << 1);
+         buffer += 6 + (sizes[i] << 1);
+      }
+      else
+      {
+         // juliana@230_12
+         // Must pass true to isTemporary so that the method does not think that the number is a rowid.
+         readValue(null, plainDB, value, 0, types[i], buffer, true, false, false, -1, null);
+         buffer += typeSizes[types[i]];
+      }
+   }
+
+   if (sorter->isRecordInLength)
+      (*values)->length = record;
+   else
+      (*values)->asTime = record;
+}
+
+/**
+ * Gives a key of an index being built to its builder, in ascending order. If the index is a primary key, the key is compared with the previous one.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param values The key.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws PrimaryKeyViolationException If there is a duplicated primary key.
+ * @throws DriverException If the index gets too large.
+ */
+bool indexSortEmit(Context context, IndexSorter* sorter, SQLValue** values)
+{
+   TRACE("indexSortEmit")
+   Index* index = sorter->index;
+   int32 n = index->numberColumns,
+         compare;
+
+   if (sorter->isPKCreation)
+   {
+      SQLValue** last = sorter->last;
+      int32* sizes = index->colSizes;
+
+      if (sorter->hasLast && (!(compare = compareSortRecords(n, values, last, index->types)) || compare == MIN_SHORT_VALUE 
+                                                                                               || compare == MAX_SHORT_VALUE))
+      {
+         TC_throwExceptionNamed(context, "litebase.PrimaryKeyViolationException", getMessage(ERR_STATEMENT_CREATE_DUPLICATED_PK), 
+                                                                                                                               index->table->name);
+         return false;
+      }
+
+      sorter->hasLast = true;
+      while (--n >= 0) // Keeps the key, which may be overwritten, to compare it with the next one.
+      {
+         if (sizes[n])
+            xmemmove(last[n]->asChars, values[n]->asChars, (last[n]->length = values[n]->length) << 1);
+         else
+            xmemmove(last[n], values[n], sizeof(SQLValue));
+      }
+   }
+
+   return indexBuildAdd(context, &sorter->builder, values, sorter->isRecordInLength? (*values)->length : (*values)->asTime);
+}
+
+/**
+ * Reads the next key of a run being merged, reading a new block of keys from the runs file if necessary.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param run The run.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ */
+bool indexSortReadRun(Context context, IndexSorter* sorter, int32 run)
+{
+   TRACE("indexSortReadRun")
+   int32 runCount = sorter->runCount,
+         keySize = sorter->keySize;
+   int32* runEnds = sorter->runEnds;
+   int32* runPositions = &runEnds[runCount];
+   int32* runLengths = &runPositions[runCount];
+   int32* runIndexes = &runLengths[runCount];
+   uint8* block = &sorter->blocks[run * INDEX_BLOCK_KEYS * keySize];
+
+   if (runIndexes[run] == runLengths[run] && runPositions[run] < runEnds[run]) // Reads the next block of the run.
+   {
+      runLengths[run] = MIN(INDEX_BLOCK_KEYS, runEnds[run] - runPositions[run]);
+      runIndexes[run] = 0;
+      nfSetPos(&sorter->runs, runPositions[run] * keySize);
+      if (!nfReadBytes(context, &sorter->runs, block, runLengths[run] * keySize))
+         return false;
+      runPositions[run] += runLengths[run];
+   }
+   if (runIndexes[run] < runLengths[run])
+      indexSortLoadKey(sorter, sorter->heads[run], &block[runIndexes[run] * keySize]);
+   return true;
+}
+
+/**
+ * Finishes the build of an index, giving its keys to the builder in ascending order. If no run was written to the runs file, the keys are sorted in
+ * memory; otherwise, the last run is written and the runs are merged.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws PrimaryKeyViolationException If there is a duplicated primary key.
+ * @throws DriverException If the index gets too large or the runs file can't be read or written.
+ * @throws OutOfMemoryError If there is not enough memory to merge the runs.
+ */
+bool indexSortFinish(Context context, IndexSorter* sorter)
+{
+   TRACE("indexSortFinish")
+   SQLValue*** heads;
+   int32* runIndexes;
+   int32* runLengths;
+   int32* runPositions;
+   int32* runEnds;
+   int32 runCount,
+         count = sorter->count,
+         i = -1,
+         lowest,
+         n = sorter->index->numberColumns;
+   int8* types = sorter->index->types;
+
+   if (!sorter->runCount) // Only one run: it is sorted in memory.
+   {
+      SQLValue*** values = sorter->values;
+
+      indexSortRun(sorter);
+      while (++i < count)
+         if (!indexSortEmit(context, sorter, values[i]))
+            return false;
+      return indexBuildFinish(context, &sorter->builder);
+   }
+
+   if (count && !indexSortWriteRun(context, sorter)) // The last run.
+      return false;
+
+   // Merges the runs. Each run has a block of keys read from the runs file and its first key.
+   runCount = sorter->runCount;
+   if (!(sorter->blocks = (uint8*)xmalloc(runCount * INDEX_BLOCK_KEYS * sorter->keySize)))
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return false;
+   }
+   heads = sorter->heads = indexSortAllocKeys(sorter, runCount);
+   runPositions = &(runEnds = sorter->runEnds)[runCount];
+   runLengths = &runPositions[runCount];
+   runIndexes = &runLengths[runCount];
+   i = runCount;
+   while (--i >= 0)
+   {
+      runPositions[i] = i? runEnds[i - 1] : 0;
+      runLengths[i] = runIndexes[i] = 0;
+      if (!indexSortReadRun(context, sorter, i))
+         return false;
+   }
+
+   while (true)
+   {
+      lowest = -1;
+      i = runCount;
+      while (--i >= 0)
+         if (runIndexes[i] < runLengths[i] && (lowest == -1 || compareSortRecords(n, heads[i], heads[lowest], types) < 0))
+            lowest = i;
+      if (lowest == -1)
+         break;
+      if (!indexSortEmit(context, sorter, heads[lowest]))
+         return false;
+      runIndexes[lowest]++;
+      if (!indexSortReadRun(context, sorter, lowest))
+         return false;
+   }
+   return indexBuildFinish(context, &sorter->builder);
+}
+
+/**
+ * Frees the resources used to sort the keys of an index and removes its runs file. It can be called more than once.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the runs file can't be removed.
+ */
+bool indexSortClose(Context context, IndexSorter* sorter)
+{
+   TRACE("indexSortClose")
+   bool ret = !*sorter->runs.name || nfRemove(context, &sorter->runs, sorter->index->table->sourcePath);
+
+   xfree(sorter->blocks);
+   xfree(sorter->runEnds);
+   *sorter->runs.name = 0;
+   return ret;
+}
+
 /**
  * Renames the index files.
  *
@@ -874,26 +1545,25 @@ bool indexRename(Context context, Index* index, CharP newName)
 }
 
 /**
- * Returns a node already loaded or loads it if there is empty space in the cache node to avoid loading already loaded nodes.
+ * Returns a node already loaded or loads it if there is empty space in the node pool to avoid loading already loaded nodes.
  * 
  * @param context The thread context where the function is being executed.
  * @param index The index where a node is going to be fetched.
- * @return The loaded node, a new cache node with the requested node loaded, or <code>null</code> if it is not 
- * already loaded and its cache is full.
+ * @return The loaded node, a new node of the node pool with the requested node loaded, or <code>null</code> if it is not 
+ * already loaded and the node pool is full.
  */
 Node* getLoadedNode(Context context, Index* index, int32 idx) 
 {
    TRACE("getLoadedNode")
    Node* node;
    Node** nodes;
-   int32 i = -1;
    
    // Tries to find the node in the nodes of the first level.
    if (idx <= index->btreeMaxNodes)
    {
       if (!(node = (nodes = index->firstLevel)[idx - 1]))
       {
-         (node = nodes[idx - 1] = createNode(index))->idx = idx;
+         (node = nodes[idx - 1] = createNode(index, index->heap))->idx = idx;
          nodeLoad(context, node);
       }
       else if (node->idx == (uint16)-1)
@@ -904,20 +1574,9 @@ Node* getLoadedNode(Context context, Index* index, int32 idx)
       return node;
    }
    
-   // Tries to get an already loaded node if it is a node from a deeper level.
-   nodes = index->cache;
-   while (++i < CACHE_SIZE && nodes[i]) 
-      if (nodes[i]->idx == idx)
-         return nodes[index->cacheI = i];   
-   
-   if (i < CACHE_SIZE) // Loads the node if there is enough space in the node cache.
-   {
-      (node = nodes[index->cacheI = i] = createNode(index))->idx = idx;
-      nodeLoad(context, node);
-      return node;
-   }
-   
-   return null;
+   // Tries to get an already loaded node if it is a node from a deeper level, or loads it if the node pool is not full. No node can be evicted 
+   // because the ones being climbed might be freed.
+   return nodePoolGet(context, index, idx, false);
 }
 
 // juliana@230_21: MAX() and MIN() now use indices on simple queries.   
@@ -55,6 +55,43 @@ Index* createIndex(Context context, Table* table, int8* keyTypes, int32* colSize
  */
 bool driverCreateIndex(Context context, Table* table, int32* columnHashes, bool isPKCreation, int32 indexCount, uint8* composedPKCols);
 
+/**
+ * Creates a trigram index, which maps the trigrams of the strings of a column to the rows that have them.
+ * 
+ * @param context The thread context where the function is being executed.
+ * @param table The table whose index is to be created.
+ * @param columnHash The hash of the index column.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the column for the index does not exist or is not a <code>CHAR</code> or <code>VARCHAR</code> column.
+ * @throws AlreadyCreatedException If the column already has a trigram index.
+ */
+bool driverCreateTrigramIndex(Context context, Table* table, int32 columnHash);
+
+/**
+ * Computes the distinct trigrams of a string, which are its sequences of three consecutive characters. The characters are converted to lower 
+ * case so that the trigrams serve to both case sensitive and caseless searches. Each trigram is encoded in an int with ten bits per character; 
+ * characters beyond the first 1024 ones may give the same code to different trigrams, which only makes an index return rows that don't match.
+ *
+ * @param chars The characters of the string.
+ * @param length The length of the string.
+ * @param trigrams Receives the codes of the trigrams in ascending order. It must have room for <code>length - 2</code> codes. 
+ * @return The number of distinct trigrams.
+ */
+int32 computeTrigrams(JCharP chars, int32 length, int32* trigrams);
+
+/**
+ * Adds or removes the trigrams of a string of a row to or from a trigram index.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param index The trigram index.
+ * @param value The string.
+ * @param record The row of the string.
+ * @param isRemove Indicates if the trigrams are to be removed instead of added.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+bool indexUpdateTrigrams(Context context, Index* index, SQLValue* value, int32 record, bool isRemove);
+
 /**
  * Removes a value from the index.
  *
@@ -173,6 +210,164 @@ bool indexSetWriteDelayed(Context context, Index* index, bool delayed);
  */
 bool indexAddKey(Context context, Index* index, SQLValue** values, int32 record);
 
+/**
+ * Starts the build of an index from its keys given in ascending order. The index must be empty.
+ *
+ * @param builder The index builder.
+ * @param index The index being built.
+ * @param heap A heap to allocate the nodes being filled.
+ */
+void indexBuildStart(IndexBuilder* builder, Index* index, Heap heap);
+
+/**
+ * Adds a key to an index being built. The key must not be less than the keys already added, with the keys of the same value ordered by their 
+ * records. When the leaf being filled is full, its last key goes up as the separator of the leaf and the next one, which may fill the node above
+ * it, and the leaf is written.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param builder The index builder.
+ * @param values The key to be added.
+ * @param record The record of the key in the table.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the index gets too large.
+ */
+bool indexBuildAdd(Context context, IndexBuilder* builder, SQLValue** values, int32 record);
+
+/**
+ * Finishes the build of an index, writing the last node of each level. The node of the top level becomes the root.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param builder The index builder.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the index gets too large.
+ */
+bool indexBuildFinish(Context context, IndexBuilder* builder);
+
+/**
+ * Starts sorting the keys of an index being built from the rows of its table. 
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param index The index being built, which must be empty.
+ * @param rows The number of rows of the table.
+ * @param isPKCreation Indicates that the index is of a primary key.
+ * @param heap A heap to allocate the keys.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the runs file can't be created.
+ * @throws OutOfMemoryError If there is not enough memory to allocate the runs information.
+ */
+bool indexSortStart(Context context, IndexSorter* sorter, Index* index, int32 rows, bool isPKCreation, Heap heap);
+
+/**
+ * Allocates keys for the sort of an index, with the space for the characters of their strings.
+ *
+ * @param sorter The index sorter.
+ * @param count The number of keys.
+ * @return The keys allocated.
+ */
+SQLValue*** indexSortAllocKeys(IndexSorter* sorter, int32 count);
+
+/**
+ * Gets the key where the next key of an index being built is to be read into. If the current run is full, it is sorted and written to the runs
+ * file before.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return The key or <code>null</code> if an error occurs.
+ */
+SQLValue** indexSortNext(Context context, IndexSorter* sorter);
+
+/**
+ * Adds the key read into the key returned by <code>indexSortNext()</code> to the keys of an index being built.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param record The record of the key in the table.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws PrimaryKeyViolationException If the index is ordered and has a duplicated primary key.
+ */
+bool indexSortAdd(Context context, IndexSorter* sorter, int32 record);
+
+/**
+ * Sorts the keys of the current run of an index being built. A radix sort is done for integer types. It is much more efficient than quick sort.
+ *
+ * @param sorter The index sorter.
+ */
+void indexSortRun(IndexSorter* sorter);
+
+/**
+ * Sorts the keys of the current run of an index being built and writes them to the runs file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the runs file can't be written.
+ */
+bool indexSortWriteRun(Context context, IndexSorter* sorter);
+
+/**
+ * Saves a key of an index being built in the format of the runs file.
+ *
+ * @param sorter The index sorter.
+ * @param values The key to be saved.
+ * @param buffer The buffer where the key is saved.
+ */
+void indexSortSaveKey(IndexSorter* sorter, SQLValue** values, uint8* buffer);
+
+/**
+ * Loads a key of an index being built from the format of the runs file.
+ *
+ * @param sorter The index sorter.
+ * @param values The key to be loaded.
+ * @param buffer The buffer where the key is stored.
+ */
+void indexSortLoadKey(IndexSorter* sorter, SQLValue** values, uint8* buffer);
+
+/**
+ * Gives a key of an index being built to its builder, in ascending order. If the index is a primary key, the key is compared with the previous one.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param values The key.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws PrimaryKeyViolationException If there is a duplicated primary key.
+ * @throws DriverException If the index gets too large.
+ */
+bool indexSortEmit(Context context, IndexSorter* sorter, SQLValue** values);
+
+/**
+ * Reads the next key of a run being merged, reading a new block of keys from the runs file if necessary.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @param run The run.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ */
+bool indexSortReadRun(Context context, IndexSorter* sorter, int32 run);
+
+/**
+ * Finishes the build of an index, giving its keys to the builder in ascending order. If no run was written to the runs file, the keys are sorted in
+ * memory; otherwise, the last run is written and the runs are merged.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws PrimaryKeyViolationException If there is a duplicated primary key.
+ * @throws DriverException If the index gets too large or the runs file can't be read or written.
+ * @throws OutOfMemoryError If there is not enough memory to merge the runs.
+ */
+bool indexSortFinish(Context context, IndexSorter* sorter);
+
+/**
+ * Frees the resources used to sort the keys of an index and removes its runs file. It can be called more than once.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param sorter The index sorter.
+ * @return <code>false</code> if an error occured; <code>true</code>, otherwise.
+ * @throws DriverException If the runs file can't be removed.
+ */
+bool indexSortClose(Context context, IndexSorter* sorter);
+
 /**
  * Renames the index files.
  *
@@ -216,12 +411,12 @@ bool findMaxValue(Context context, Index* index, SQLValue* sqlValue, IntVector*
 bool loadStringForMaxMin(Context context, Index* index, SQLValue* sqlValue);
 
 /**
- * Returns a node already loaded or loads it if there is empty space in the cache node to avoid loading already loaded nodes.
+ * Returns a node already loaded or loads it if there is empty space in the node pool to avoid loading already loaded nodes.
  * 
  * @param context The thread context where the function is being executed.
  * @param index The index where a node is going to be fetched.
- * @return The loaded node, a new cache node with the requested node loaded, a first level node, or <code>null</code> if it is not 
- * already loaded and its cache is full.
+ * @return The loaded node, a new node of the node pool with the requested node loaded, a first level node, or <code>null</code> if it is not 
+ * already loaded and the node pool is full.
  */
 Node* getLoadedNode(Context context, Index* index, int32 idx);
 
@@ -79,10 +79,11 @@ LB_API bool LibOpen(OpenParams params)
       test_valueCompareTo(&testSuite, currentContext);
       test_initTCVMLib(&testSuite, currentContext);
       test_rowUpdated(&testSuite, currentContext);
+      test_sortTableRun(&testSuite, currentContext);
       currentContext->thrownException = null;
       
       // The test results.
-      TC_alert("%02d test total\n%02d succeeded\n%02d failed", 30, 30 - testSuite.failed, testSuite.failed);
+      TC_alert("%02d test total\n%02d succeeded\n%02d failed", 31, 31 - testSuite.failed, testSuite.failed);
    }
 #endif
    return true;
@@ -103,6 +104,8 @@ LB_API void LibClose()
    // Destroy the mutexes.
    DESTROY_MUTEX(parser);
    DESTROY_MUTEX(log);
+   DESTROY_MUTEX(wal);
+   DESTROY_MUTEX(walSync);
 }
 
 /**
@@ -121,12 +124,15 @@ bool initVars(OpenParams params)
 #if defined(POSIX) || defined(ANDROID)
    xmemzero(&filesList, sizeof(XFilesList));
 #endif
+   walList = null;
 
    // Initializes the mutexes.
 	SETUP_MUTEX;
    INIT_MUTEX(parser);
    INIT_MUTEX(log);
    INIT_MUTEX(files);
+   INIT_MUTEX(wal);
+   INIT_MUTEX(walSync);
 
    memoryUsage.items = null;
    reserved.items = null;
@@ -165,10 +171,12 @@ bool initVars(OpenParams params)
  * @param context The thread context where the function is being executed.
  * @param crid The creator id, which may be the same one of the current application and MUST be 4 characters long.
  * @param objParams Only the folder where it is desired to store the tables, <code>null</code>, if it is desired to use the current data 
- * path, or <code>chars_type = chars_format; path = source_path[;crypto] </code>, where <code>chars_format</code> can be <code>ascii</code> or 
- * <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, and crypto must be used if the tables of the 
- * connection use cryptography. The params can be entered in any order. If only the path is passed as a parameter, unicode is used and there is no 
- * cryptography. Notice that path must be absolute, not relative.
+ * path, or <code>chars_type = chars_format; path = source_path[;crypto][;wal][;mmap] </code>, where <code>chars_format</code> can be 
+ * <code>ascii</code> or <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, crypto must be used if 
+ * the tables of the connection use cryptography, wal makes the changes be written to a write-ahead log and committed after each command or 
+ * by <code>executeUpdate("commit")</code> after a <code>executeUpdate("begin")</code>, and mmap maps the table files into memory on POSIX 
+ * systems, so that reading them does not need a system call. The params can be entered in any order. If only the path 
+ * is passed as a parameter, unicode is used and there is no cryptography. Notice that path must be absolute, not relative.
  * <p>Note that databases belonging to multiple applications can be stored in the same path, since all tables are prefixed by the application's 
  * creator id.
  * <p>Also notice that to store Litebase files on card on Pocket PC, just set the second parameter to the correct directory path.
@@ -188,7 +196,9 @@ TCObject create(Context context, int32 crid, TCObject objParams)
           logger = litebaseConnectionClass->objStaticValues[1];
    int32 hash;
    bool isAscii = false,
-        useCrypto = false;
+        useCrypto = false,
+        useWal = false,
+        useMmap = false;
    TCHAR sourcePath[1024];
 	TCHARP path = null;
    char params[1024];
@@ -227,30 +237,21 @@ error:
 
    if (objParams)
 	{
-	   CharP tempParams[3];
+	   CharP tempParams[5];
 		int32 i = 1,
 		      numParams;
 		
       params[0] = 0;
-      tempParams[0] = tempParams[1] = tempParams[2] = null;
+      tempParams[0] = tempParams[1] = tempParams[2] = tempParams[3] = tempParams[4] = null;
 
       // juliana@250_4: now getInstance() can receive only the parameter chars_type = ...
       // juliana@210_2: now Litebase supports tables with ascii strings.
       TC_JCharP2CharPBuf(String_charsStart(objParams), String_charsLen(objParams), params);
 		tempParams[0] = params;
-      tempParams[1] = xstrchr(params, ';'); // Separates the parameters.
-		if (tempParams[1])
+      while (i < 5 && (tempParams[i] = xstrchr(tempParams[i - 1], ';'))) // Separates the parameters.
 		{
-		   tempParams[1][0] = 0;
-		   tempParams[2] = xstrchr(++tempParams[1], ';');
-		   i++;
-		   
-		   if (tempParams[2])
-		   {
-		      tempParams[2][0] = 0;
-		      tempParams[2]++;
-		      i++;
-		   }
+		   tempParams[i][0] = 0;
+		   tempParams[i++]++;
 		}
 
       numParams = i;
@@ -263,6 +264,10 @@ error:
             path = TC_CharP2TCHARPBuf(&xstrchr(tempParams[i], '=')[1], sourcePath);
 			else if (xstrstr(tempParams[i], "crypto")) // Cryptography param.
 			   useCrypto = true;   
+			else if (!xstrcmp(tempParams[i], "wal")) // Write-ahead log param.
+			   useWal = true;
+			else if (!xstrcmp(tempParams[i], "mmap")) // Memory-mapped files param, which only changes anything on POSIX systems.
+			   useMmap = true;
 	      else if (numParams == 1) 
             path = TC_CharP2TCHARPBuf(tempParams[0], sourcePath); // Things do not change if there is only one parameter.
 		   else // juliana@253_11: now a DriverException will be throw if an incorrect parameter is passed in LitebaseConnection.getInstance().
@@ -282,7 +287,7 @@ error:
 
    // fdie@555_2: driver not already created? Creates one.
    // If there is no connections with this key, creates a new one.
-   if (!(driver = TC_htGetPtr(&htCreatedDrivers, (hash = TC_hashCodeFmt("ixiis", crid, context->thread, isAscii, useCrypto, sourcePath? TC_TCHARP2CharPBuf(sourcePath, params): "null"))))) 
+   if (!(driver = TC_htGetPtr(&htCreatedDrivers, (hash = TC_hashCodeFmt("ixiiiis", crid, context->thread, isAscii, useCrypto, useWal, useMmap, sourcePath? TC_TCHARP2CharPBuf(sourcePath, params): "null"))))) 
    {
 		Hashtable htTables,
                 htPS;
@@ -293,6 +298,7 @@ error:
       OBJ_LitebaseAppCrid(driver) = crid; // juliana@210a_10
 	   OBJ_LitebaseIsAscii(driver) = isAscii;
 	   OBJ_LitebaseUseCrypto(driver) = useCrypto;
+	   OBJ_LitebaseUseMmap(driver) = useMmap;
 	   OBJ_LitebaseKey(driver) = hash;
 		
       // SourcePath.
@@ -325,6 +331,37 @@ error1:
       if (!setLitebaseNodes(driver, xmalloc(MAX_IDX << 2)))
          goto error1;
 
+      // The pool of the deeper index nodes of all the tables of the connection.
+      if (!setLitebaseNodePool(driver, createNodePool()))
+         goto error1;
+
+      // The statements executed without being prepared which are kept parsed.
+      if (!setLitebaseStmtCache(driver, xmalloc(sizeof(StatementCache))))
+         goto error1;
+
+      // Replays the logs left by connections of this application which were not closed, such as after a crash. Then creates the log of this 
+      // connection if it was asked for.
+      TC_int2CRID(crid, params);
+      xstrcat(params, "-");
+      if (!walRecover(context, params, sourcePath))
+      {
+error2:
+         freeLitebase(context, (size_t)driver);
+         TC_setObjectLock(driver, UNLOCKED);
+         return null;
+      }
+      if (useWal)
+      {
+         char intBuf[20];
+         Wal* wal;
+
+         xstrcat(params, TC_int2str(hash, intBuf));
+         xstrcat(params, WAL_EXTENSION);
+         if (!(wal = walCreate(context, params, sourcePath)))
+            goto error2;
+         setLitebaseWal(driver, wal);
+      }
+
       // Stores the driver into the drivers hash table.
       if (!TC_htPutPtr(&htCreatedDrivers, hash, driver))
          goto error1;
@@ -347,6 +384,20 @@ void freeLitebase(Context context, size_t driver)
    int32* nodes = getLitebaseNodes(driver); // juliana@253_6: the maximum number of keys of a index was duplicated.
 	Hashtable* htTables = getLitebaseHtTables(driver);
    Hashtable* htPs = getLitebaseHtPS(driver);
+   Wal* wal = getLitebaseWal(driver);
+   StatementCache* stmtCache = getLitebaseStmtCache(driver);
+
+   if (wal) // Closing the connection commits its pending changes, which are then copied to the tables, or discards a failed transaction. 
+   {
+      if (wal->failed? litebaseDiscard((TCObject)driver) : litebaseCommit(context, (TCObject)driver))
+         walCheckpoint(context, wal);
+      walClose(context, wal);
+      setLitebaseWal(driver, null);
+   }
+
+   clearStatementCache((TCObject)driver); // The cached statements are removed from their tables before they are closed.
+   xfree(stmtCache);
+   setLitebaseStmtCache(driver, null);
 
 	if (htTables) // Frees all the openned tables and the their hash table. 
 	{
@@ -362,10 +413,212 @@ void freeLitebase(Context context, size_t driver)
 
    xfree(sourcePath); // Frees the source path.
    xfree(nodes); // juliana@253_6: the maximum number of keys of a index was duplicated.
+   freeNodePool(getLitebaseNodePool(driver)); // The indices were already closed.
 	TC_htRemove(&htCreatedDrivers, OBJ_LitebaseKey((TCObject)driver)); // fdie@555_2: removes this instance from the drivers hash table.
 	OBJ_LitebaseDontFinalize((TCObject)driver) = true; // This object shouldn't be finalized again.
 }
 
+/**
+ * Commits the changes done in the tables of a connection which uses a write-ahead log. The pending index nodes are written to the index files and
+ * the log is synced, even if there is no explicit transaction.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool litebaseCommit(Context context, TCObject driver)
+{
+   TRACE("litebaseCommit")
+   Wal* wal = getLitebaseWal(driver);
+   Hashtable* htTables = getLitebaseHtTables(driver);
+   HtEntry* entry;
+   Table* table;
+   Index** columnIndexes;
+   ComposedIndex** composedIndexes;
+   int32 i = htTables->size? htTables->hash + 1 : 0,
+         j;
+   bool ret = true;
+
+   if (wal->failed)
+   {
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_TRANSACTION_FAILED));
+      return false;
+   }
+
+   while (--i >= 0) // Writes the nodes of the indices which are written delayed.
+   {
+      entry = htTables->items[i];
+      while (entry)
+      {
+         table = (Table*)entry->ptr;
+         if (table->db.db.wal)
+         {
+            columnIndexes = table->columnIndexes;
+            composedIndexes = table->composedIndexes;
+            j = table->columnCount;
+            while (--j >= 0)
+            {
+               if (columnIndexes[j] && columnIndexes[j]->isWriteDelayed)
+                  ret &= indexSetWriteDelayed(context, columnIndexes[j], false) && indexSetWriteDelayed(context, columnIndexes[j], true);
+               if (table->columnTrigrams && table->columnTrigrams[j] && table->columnTrigrams[j]->isWriteDelayed)
+                  ret &= indexSetWriteDelayed(context, table->columnTrigrams[j], false) 
+                      && indexSetWriteDelayed(context, table->columnTrigrams[j], true);
+            }
+            j = table->numberComposedIndexes;
+            while (--j >= 0)
+               if (composedIndexes[j]->index->isWriteDelayed)
+                  ret &= indexSetWriteDelayed(context, composedIndexes[j]->index, false) 
+                      && indexSetWriteDelayed(context, composedIndexes[j]->index, true);
+         }
+         entry = entry->next;
+      }
+   }
+   return ret && walCommit(context, wal);
+}
+
+/**
+ * Discards the changes of a transaction which can't be committed because one of its commands failed. The tables changed by it are closed as not 
+ * closed properly, since their indices may still have the keys of the discarded rows, so they must be recovered before being used again.
+ *
+ * @param driver The current Litebase connection.
+ * @return <code>true</code>.
+ */
+bool litebaseDiscard(TCObject driver)
+{
+   TRACE("litebaseDiscard")
+   Wal* wal = getLitebaseWal(driver);
+   Hashtable* htTables = getLitebaseHtTables(driver);
+   HtEntry* entry;
+   PlainDB* plainDB;
+   int32 i = htTables->size? htTables->hash + 1 : 0;
+
+   while (--i >= 0)
+   {
+      entry = htTables->items[i];
+      while (entry)
+      {
+         plainDB = &((Table*)entry->ptr)->db;
+         if (plainDB->db.wal && (plainDB->db.walChanged || plainDB->db.cacheIsDirty || plainDB->db.size != plainDB->db.walDiskSize 
+                              || plainDB->dbo.walChanged || plainDB->dbo.cacheIsDirty || plainDB->dbo.size != plainDB->dbo.walDiskSize))
+            plainDB->wasNotSavedCorrectly = true;
+         entry = entry->next;
+      }
+   }
+   walDiscard(wal);
+   wal->failed = wal->inTransaction = false;
+   return true;
+}
+
+/**
+ * Commits the changes of the last command of a connection if it uses a write-ahead log and there is no explicit transaction. A command that fails 
+ * inside a transaction makes it fail, since the changes it did can't be undone.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool litebaseAutoCommit(Context context, TCObject driver)
+{
+   TRACE("litebaseAutoCommit")
+   Wal* wal = getLitebaseWal(driver);
+   if (wal && wal->inTransaction && context->thrownException)
+      wal->failed = true;
+   return !wal || wal->inTransaction || context->thrownException || litebaseCommit(context, driver);
+}
+
+/**
+ * Executes a <code>begin</code> or a <code>commit</code> command. <code>begin</code> makes the next commands of the connection be committed 
+ * together by the next <code>commit</code>.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @param begin Indicates if the command is a <code>begin</code> or a <code>commit</code>.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If the connection does not use a write-ahead log, a transaction is already started on a <code>begin</code>, there is
+ * no transaction on a <code>commit</code>, or a command of the transaction failed.
+ */
+bool litebaseTransaction(Context context, TCObject driver, bool begin)
+{
+   TRACE("litebaseTransaction")
+   Wal* wal = getLitebaseWal(driver);
+
+   if (!wal)
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_WAL_DISABLED));
+   else if (begin && wal->inTransaction)
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_TRANSACTION_STARTED));
+   else if (!begin && !wal->inTransaction)
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_NO_TRANSACTION));
+   else if (begin) // Changes left by commands which failed are committed before the transaction starts.
+   {
+      if (litebaseCommit(context, driver))
+         return wal->inTransaction = true;
+   }
+   else
+   {
+      wal->inTransaction = false;
+      return litebaseCommit(context, driver);
+   }
+   return false;
+}
+
+/**
+ * Makes the tables of a connection be written directly to their files before a command that does not go through the write-ahead log, such as 
+ * <code>drop</code>, <code>alter</code>, <code>create</code> or a purge. The pending changes are committed and copied to the tables first.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If there is a transaction in progress.
+ */
+bool litebaseSuspendWal(Context context, TCObject driver)
+{
+   TRACE("litebaseSuspendWal")
+   Wal* wal = getLitebaseWal(driver);
+
+   if (!wal || wal->suspended)
+      return true;
+   if (wal->inTransaction)
+   {
+      TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_TRANSACTION_DDL));
+      return false;
+   }
+   if (!litebaseCommit(context, driver) || !walCheckpoint(context, wal))
+      return false;
+   while (wal->files)
+      if (!walDetach(context, wal->files))
+         return false;
+   return wal->suspended = true;
+}
+
+/**
+ * Makes the tables of a connection use its write-ahead log again after <code>litebaseSuspendWal()</code>. 
+ *
+ * @param driver The current Litebase connection.
+ */
+void litebaseResumeWal(TCObject driver)
+{
+   TRACE("litebaseResumeWal")
+   Wal* wal = getLitebaseWal(driver);
+
+   if (wal && wal->suspended)
+   {
+      Hashtable* htTables = getLitebaseHtTables(driver);
+      HtEntry* entry;
+      int32 i = htTables->size? htTables->hash + 1 : 0;
+
+      wal->suspended = false;
+      while (--i >= 0)
+      {
+         entry = htTables->items[i];
+         while (entry)
+         {
+            tableAttachWal((Table*)entry->ptr, wal);
+            entry = entry->next;
+         }
+      }
+   }
+}
+
 /**
  * Used to execute a <code>create table</code> or <code>create index</code> SQL commands.
  * 
@@ -391,7 +644,6 @@ void litebaseExecute(Context context, TCObject driver, JCharP sqlStr, uint32 sql
 	TRACE("litebaseExecute")
    char tableName[DBNAME_SIZE];
    LitebaseParser* parser;
-	bool locked = true;
    int32 i;
    int32* hashes;
    CharP* names;
@@ -399,23 +651,20 @@ void litebaseExecute(Context context, TCObject driver, JCharP sqlStr, uint32 sql
         heap = null;
 
    // Does de parsing.
-	LOCKVAR(parser);
 	IF_HEAP_ERROR(heapParser)
    {
-		if (locked)
-         UNLOCKVAR(parser);
       TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
 error:
       heapDestroy(heapParser);
 	   heapDestroy(heap);
+      litebaseResumeWal(driver);
       return;
    }
    heapParser->greedyAlloc = true;
 	parser = initLitebaseParser(context, sqlStr, sqlLen, false, heapParser);
-   UNLOCKVAR(parser);
-	locked = false;
-   if (!parser)
+   if (!parser || !litebaseSuspendWal(context, driver)) // Tables and indices are created directly on their files. 
       goto error;
+   clearStatementCache(driver); // The cached statements may be bound to the table changed.
 
    if (parser->command == CMD_CREATE_TABLE)
    {
@@ -599,7 +848,16 @@ error:
       xstrcpy(tableName, parser->tableList[0]->tableName); // indexTableName ignored - formed internally.
       table = getTable(context, driver, tableName);
 
-      if (table)
+      if (table && parser->isTrigram) // A trigram index has only one string column.
+      {
+         if (parser->fieldNamesSize != 1)
+         {
+            TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_TRIGRAM_INDEX));
+            goto error;
+         }
+         driverCreateTrigramIndex(context, table, TC_hashCode(parser->fieldNames[0]));
+      }
+      else if (table)
       {
          Hashtable htTable = TC_htNew((i = parser->fieldNamesSize) + 1, heapParser);
        
@@ -627,6 +885,7 @@ error:
 	else
 		TC_throwExceptionNamed(context, "litebase.SQLParseException", getMessage(ERR_ONLY_CREATE_TABLE_INDEX_IS_ALLOWED));
    heapDestroy(heapParser);
+   litebaseResumeWal(driver);
 }
 
 /**
@@ -646,54 +905,88 @@ error:
  * @param driver The current Litebase connection.
  * @param sqlStr The SQL creation command.
  * @param sqlLen The SQL string length.
- * @return The number of rows affected or <code>0</code> if a drop or alter operation was successful.
+ * @return The number of rows affected or <code>0</code> if a drop, alter, or analyze operation was successful.
  * @throws OutOfMemoryError If a memory allocation fails.
  */
 int32 litebaseExecuteUpdate(Context context, TCObject driver, JCharP sqlStr, int32 sqlLen)
 {
    TRACE("litebaseExecuteUpdate")
    LitebaseParser* parser;
+   TCObject statement;
    int32 returnVal = -1;
-	Heap heapParser = heapCreate();
-	bool locked = true;
+	Heap heapParser;
 
-   // Does de parsing.
-	LOCKVAR(parser);
+   // The inserts, updates, and deletes executed before are kept parsed and bound.
+   if ((statement = getCachedStatement(context, driver, sqlStr, sqlLen, false)))
+      return psExecuteUpdate(context, statement);
+   if (context->thrownException)
+      return -1;
+
+   // Does de parsing. The parser structure belongs to the thread context, so it does not need to be locked.
+   heapParser = heapCreate();
 	IF_HEAP_ERROR(heapParser)
    {
-		if (locked)
-         UNLOCKVAR(parser);
       TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
       goto finish;
    }
    heapParser->greedyAlloc = true;
 	parser = initLitebaseParser(context, sqlStr, sqlLen, false, heapParser);
-   UNLOCKVAR(parser);
-	locked = false;
    if (!parser)
       goto finish;
 
    switch (parser->command)
    {
+      case CMD_BEGIN:
+      case CMD_COMMIT:
+         if (litebaseTransaction(context, driver, parser->command == CMD_BEGIN))
+            returnVal = 0;
+         goto finish;
+      
+      // The drops and alters write the table files directly, so the write-ahead log is suspended while they are executed.
       case CMD_DROP_TABLE:
+         if (!litebaseSuspendWal(context, driver))
+            goto finish;
+         clearStatementCache(driver); // The cached statements may be bound to the table changed.
          litebaseExecuteDropTable(context, driver, parser);
+         litebaseResumeWal(driver);
          return 0;
       case CMD_DROP_INDEX:
-         return litebaseExecuteDropIndex(context, driver, parser);
+         if (!litebaseSuspendWal(context, driver))
+            goto finish;
+         clearStatementCache(driver); // The cached statements may be bound to the table changed.
+         returnVal = litebaseExecuteDropIndex(context, driver, parser);
+         litebaseResumeWal(driver);
+         return returnVal;
       case CMD_ALTER_DROP_PK:
       case CMD_ALTER_ADD_PK:
       case CMD_ALTER_RENAME_TABLE:
       case CMD_ALTER_RENAME_COLUMN:
       case CMD_ALTER_ADD_COLUMN:
+         if (!litebaseSuspendWal(context, driver))
+            goto finish;
+         clearStatementCache(driver); // The cached statements may be bound to the table changed.
          litebaseExecuteAlter(context, driver, parser);
+         litebaseResumeWal(driver);
          return 0;
+      case CMD_ANALYZE:
+      {
+         Table* table;
+         
+         if (!litebaseSuspendWal(context, driver))
+            goto finish;
+         clearStatementCache(driver); // The cached statements may have been planned with the old statistics.
+         if ((table = getTable(context, driver, parser->tableList[0]->tableName)) && tableAnalyze(context, table))
+            returnVal = 0;
+         litebaseResumeWal(driver);
+         goto finish;
+      }
       case CMD_INSERT:
       {
          SQLInsertStatement* insertStmt = initSQLInsertStatement(context, driver, parser);
 			
          if (insertStmt && litebaseBindInsertStatement(context, insertStmt))
 		      returnVal = litebaseDoInsert(context, insertStmt);
-		   goto finish;   
+		   goto commit;   
 		   
       }
       case CMD_UPDATE:
@@ -702,17 +995,20 @@ int32 litebaseExecuteUpdate(Context context, TCObject driver, JCharP sqlStr, int
          
          if (updateStmt && litebaseBindUpdateStatement(context, updateStmt))
             returnVal = litebaseDoUpdate(context, updateStmt);
-         goto finish;
+         goto commit;
       }
       case CMD_DELETE:
       {
         SQLDeleteStatement* deleteStmt = initSQLDeleteStatement(parser, false);
         if (litebaseBindDeleteStatement(context, driver, deleteStmt))
 		     returnVal = litebaseDoDelete(context, deleteStmt);
-        goto finish;
+        goto commit;
       }
    }
-   
+   goto finish;
+
+commit:
+   litebaseAutoCommit(context, driver); // Commits the changes if there is no explicit transaction.
 finish:      
    heapDestroy(heapParser);
    return returnVal;
@@ -738,15 +1034,30 @@ finish:
 TCObject litebaseExecuteQuery(Context context, TCObject driver, JCharP strSql, int32 length)
 {
    TRACE("litebaseExecuteQuery")
-	Heap heapParser = heapCreate();
+	Heap heapParser;
    LitebaseParser* parser;
 	SQLSelectStatement* selectStmt;
    ResultSet* resultSetBag;
-	TCObject resultSet;
+	TCObject resultSet,
+            statement;
    PlainDB* plainDB;
    bool locked = false;
 
-   // Does the parsing.
+   // The selects executed before are kept parsed and bound. Their select clauses are kept while their result sets are open. 
+   if ((statement = getCachedStatement(context, driver, strSql, length, true)))
+   {
+      if ((resultSet = psExecuteQuery(context, statement)) && (resultSetBag = getResultSetBag(resultSet))->selectClause)
+      {
+         resultSetBag->isCached = true;
+         resultSetBag->selectClause->resultSets++;
+      }
+      return resultSet;
+   }
+   if (context->thrownException)
+      return null;
+
+   // Does the parsing. The parser structure belongs to the thread context, so it does not need to be locked.
+   heapParser = heapCreate();
 	IF_HEAP_ERROR(heapParser)
    {
 nomem:
@@ -757,12 +1068,8 @@ error:
       heapDestroy(heapParser);
       return null;
    }
-	locked = true;
-	LOCKVAR(parser);
 	heapParser->greedyAlloc = true;
 	parser = initLitebaseParser(context, strSql, length, true, heapParser);
-   UNLOCKVAR(parser);
-	locked = false;
    if (!parser)
       goto error;
 
@@ -821,11 +1128,17 @@ void litebaseExecuteDropTable(Context context, TCObject driver, LitebaseParser*
       i = table->columnCount;
       TC_htRemove(htTables, hashCode);
 
-      while (--i >= 0) // Drops its simple indices.
+      while (--i >= 0) // Drops its simple and trigram indices.
       {
          if (columnIndexes[i] && !indexRemove(context, columnIndexes[i]))
             goto finish;
          columnIndexes[i] = null;
+         if (table->columnTrigrams && table->columnTrigrams[i])
+         {
+            if (!indexRemove(context, table->columnTrigrams[i]))
+               goto finish;
+            table->columnTrigrams[i] = null;
+         }
       }
 
       // juliana@223_14: solved possible memory problems.
@@ -926,7 +1239,23 @@ int32 litebaseExecuteDropIndex(Context context, TCObject driver, LitebaseParser*
       int32 column = TC_htGet32Inv(&table->htName2index, TC_hashCode(fieldNames[0])),
             fieldNamesSize = parser->fieldNamesSize;
       
-      if (fieldNamesSize == 1) // Simple index.
+      if (parser->isTrigram) // Trigram index.
+      {
+         if (fieldNamesSize != 1)
+         {
+            TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_TRIGRAM_INDEX));
+            goto finish;
+         }
+         if (column < 0) // Unknown column. 
+         {
+            TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_INVALID_COLUMN_NAME), fieldNames[0]);
+            goto finish;
+         }
+      
+         driverDropTrigramIndex(context, table, column);
+         count = 1;
+      }
+      else if (fieldNamesSize == 1) // Simple index.
       {
          if (column < 0) // Unknown column. 
          {
@@ -1196,6 +1525,10 @@ void litebaseExecuteAlter(Context context, TCObject driver, LitebaseParser* pars
             else
                columnNulls = table->columnNulls;
             
+            // The statistics of the table don't have the new column.
+            table->analyzedRowCount = 0;
+            table->columnStatistics = null;
+            
             // Increases all the columns.              
             
             // Column attrs.
@@ -1278,6 +1611,14 @@ void litebaseExecuteAlter(Context context, TCObject driver, LitebaseParser* pars
             xmemmove(newIndices, table->columnIndexes, oldCount * TSIZE);
             table->columnIndexes = newIndices;
             
+            // Trigram indices. The rows keep their positions, so they don't need to be rebuilt.
+            if (table->columnTrigrams)
+            {
+               Index** newTrigrams = (Index**)TC_heapAlloc(heap, newCount * TSIZE);
+               xmemmove(newTrigrams, table->columnTrigrams, oldCount * TSIZE);
+               table->columnTrigrams = newTrigrams;
+            }
+            
             // Sets the new plain db.
             xstrcpy(tempName, table->name);
             xstrcat(tempName, "_");
@@ -1897,6 +2238,7 @@ TESTCASE(LibOpen)
    ASSERT1_EQUALS(NotNull, TC_debug);
    ASSERT1_EQUALS(NotNull, TC_double2str);
    ASSERT1_EQUALS(NotNull, TC_executeMethod);
+   ASSERT1_EQUALS(NotNull, TC_gcWriteBarrier);
 	ASSERT1_EQUALS(NotNull, TC_getApplicationId);
    ASSERT1_EQUALS(NotNull, TC_getAppPath);
    ASSERT1_EQUALS(NotNull, TC_getDataPath);
@@ -1929,6 +2271,7 @@ TESTCASE(LibOpen)
    ASSERT1_EQUALS(NotNull, TC_privateXfree);
    ASSERT1_EQUALS(NotNull, TC_privateXmalloc);
    ASSERT1_EQUALS(NotNull, TC_privateXrealloc);
+   ASSERT1_EQUALS(NotNull, TC_runPoolJobs);
    ASSERT1_EQUALS(NotNull, TC_setObjectLock);
    ASSERT1_EQUALS(NotNull, TC_str2double);
    ASSERT1_EQUALS(NotNull, TC_str2int);
@@ -2676,6 +3019,7 @@ TESTCASE(initVars)
    ASSERT1_EQUALS(NotNull, TC_debug);
    ASSERT1_EQUALS(NotNull, TC_double2str);
    ASSERT1_EQUALS(NotNull, TC_executeMethod);
+   ASSERT1_EQUALS(NotNull, TC_gcWriteBarrier);
 	ASSERT1_EQUALS(NotNull, TC_getApplicationId);
    ASSERT1_EQUALS(NotNull, TC_getAppPath);
    ASSERT1_EQUALS(NotNull, TC_getDataPath);
@@ -2708,6 +3052,7 @@ TESTCASE(initVars)
    ASSERT1_EQUALS(NotNull, TC_privateXfree);
    ASSERT1_EQUALS(NotNull, TC_privateXmalloc);
    ASSERT1_EQUALS(NotNull, TC_privateXrealloc);
+   ASSERT1_EQUALS(NotNull, TC_runPoolJobs);
    ASSERT1_EQUALS(NotNull, TC_setObjectLock);
    ASSERT1_EQUALS(NotNull, TC_str2double);
    ASSERT1_EQUALS(NotNull, TC_str2int);
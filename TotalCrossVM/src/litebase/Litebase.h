@@ -76,10 +76,12 @@ bool initVars(OpenParams params);
  * @param context The thread context where the function is being executed.
  * @param crid The creator id, which may be the same one of the current application and MUST be 4 characters long.
  * @param objParams Only the folder where it is desired to store the tables, <code>null</code>, if it is desired to use the current data 
- * path, or <code>chars_type = chars_format; path = source_path[;crypto] </code>, where <code>chars_format</code> can be <code>ascii</code> or 
- * <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, and crypto must be used if the tables of the 
- * connection use cryptography. The params can be entered in any order. If only the path is passed as a parameter, unicode is used and there is no 
- * cryptography. Notice that path must be absolute, not relative.
+ * path, or <code>chars_type = chars_format; path = source_path[;crypto][;wal][;mmap] </code>, where <code>chars_format</code> can be 
+ * <code>ascii</code> or <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, crypto must be used if 
+ * the tables of the connection use cryptography, wal makes the changes be written to a write-ahead log and committed after each command or 
+ * by <code>executeUpdate("commit")</code> after a <code>executeUpdate("begin")</code>, and mmap maps the table files into memory on POSIX 
+ * systems, so that reading them does not need a system call. The params can be entered in any order. If only the path 
+ * is passed as a parameter, unicode is used and there is no cryptography. Notice that path must be absolute, not relative.
  * <p>Note that databases belonging to multiple applications can be stored in the same path, since all tables are prefixed by the application's 
  * creator id.
  * <p>Also notice that to store Litebase files on card on Pocket PC, just set the second parameter to the correct directory path.
@@ -102,6 +104,66 @@ TCObject create(Context context, int32 crid, TCObject objParams);
  */
 void freeLitebase(Context context, size_t driver);
 
+/**
+ * Commits the changes done in the tables of a connection which uses a write-ahead log. The pending index nodes are written to the index files and
+ * the log is synced, even if there is no explicit transaction.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool litebaseCommit(Context context, TCObject driver);
+
+/**
+ * Discards the changes of a transaction which can't be committed because one of its commands failed. The tables changed by it are closed as not 
+ * closed properly, since their indices may still have the keys of the discarded rows, so they must be recovered before being used again.
+ *
+ * @param driver The current Litebase connection.
+ * @return <code>true</code>.
+ */
+bool litebaseDiscard(TCObject driver);
+
+/**
+ * Commits the changes of the last command of a connection if it uses a write-ahead log and there is no explicit transaction. A command that fails 
+ * inside a transaction makes it fail, since the changes it did can't be undone.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool litebaseAutoCommit(Context context, TCObject driver);
+
+/**
+ * Executes a <code>begin</code> or a <code>commit</code> command. <code>begin</code> makes the next commands of the connection be committed 
+ * together by the next <code>commit</code>.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @param begin Indicates if the command is a <code>begin</code> or a <code>commit</code>.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If the connection does not use a write-ahead log, a transaction is already started on a <code>begin</code>, there is
+ * no transaction on a <code>commit</code>, or a command of the transaction failed.
+ */
+bool litebaseTransaction(Context context, TCObject driver, bool begin);
+
+/**
+ * Makes the tables of a connection be written directly to their files before a command that does not go through the write-ahead log, such as 
+ * <code>drop</code>, <code>alter</code>, <code>create</code> or a purge. The pending changes are committed and copied to the tables first.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The current Litebase connection.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If there is a transaction in progress.
+ */
+bool litebaseSuspendWal(Context context, TCObject driver);
+
+/**
+ * Makes the tables of a connection use its write-ahead log again after <code>litebaseSuspendWal()</code>. 
+ *
+ * @param driver The current Litebase connection.
+ */
+void litebaseResumeWal(TCObject driver);
+
 /**
  * Used to execute a <code>create table</code> or <code>create index</code> SQL commands.
  * 
@@ -22,6 +22,8 @@ extern Hashtable htCreatedDrivers; // The hash table for the created connections
 extern XFilesList filesList; 
 #endif
 
+extern Wal* walList; // The write-ahead logs of the connections.
+
 // Globals for the parser.
 extern Hashtable reserved;              // Table containing the reserved words.
 extern MemoryUsageHT memoryUsage;       // Indicates how much memory a select sql command uses in its temporary .db.
@@ -30,6 +32,7 @@ extern int8 function_x_datatype[10][7]; // Matrix of data types which applies to
 extern CharP names[10];                 // An array with the names of the SQL data functions.
 extern uint8 bitsInNibble[16];          // Used to count bits in an index bitmap.
 extern JChar questionMark[2];           // A jchar string representing "?".                                    
+extern int32 joinMemoryBudget;          // The memory budget of the hash table of a join without an index.
                 
 // juliana@parser_1: improved Litebase parser.                
                                                                                               
@@ -39,9 +42,11 @@ extern TCClass loggerClass;             // Logger
 
 // juliana@closeFiles_1: removed possible problem of the IOException with the message "Too many open files".
 // Mutexes used.
-extern DECLARE_MUTEX(parser); // Mutex for the parser.
+extern DECLARE_MUTEX(parser); // Mutex for the memory usage of the queries.
 extern DECLARE_MUTEX(log);    // Mutex for logging.
 extern DECLARE_MUTEX(files);  // Mutex for the Litebase files list.
+extern DECLARE_MUTEX(wal);    // Mutex for the list of write-ahead logs.
+extern DECLARE_MUTEX(walSync); // Mutex for syncing the write-ahead logs.
 
 // rnovais@568_10 @570_1 
 extern int8 aggregateFunctionsTypes[FUNCTION_AGG_SUM + 1];  // Aggregate functions table. 
@@ -83,6 +88,7 @@ extern createStringObjectWithLenFunc TC_createStringObjectWithLen;
 extern debugFunc TC_debug;
 extern double2strFunc TC_double2str;
 extern executeMethodFunc TC_executeMethod;
+extern gcWriteBarrierFunc TC_gcWriteBarrier;
 extern getApplicationIdFunc TC_getApplicationId;
 extern getAppPathFunc TC_getAppPath;
 extern getDataPathFunc TC_getDataPath;
@@ -116,6 +122,7 @@ extern privateHeapSetJumpFunc TC_privateHeapSetJump;
 extern privateXfreeFunc TC_privateXfree;
 extern privateXmallocFunc TC_privateXmalloc;
 extern privateXreallocFunc TC_privateXrealloc;
+extern runPoolJobsFunc TC_runPoolJobs;
 extern setObjectLockFunc TC_setObjectLock;
 extern str2doubleFunc TC_str2double;
 extern str2intFunc TC_str2int;
@@ -59,6 +59,7 @@
 #define OBJ_LitebaseDontFinalize(o) FIELD_I32(o, 2)					// LitebaseConnection.dontFinalize
 #define OBJ_LitebaseKey(o)          FIELD_I32(o, 3)					// LitebaseConnection.key 
 #define OBJ_LitebaseAppCrid(o)      FIELD_I32(o, 4)					// LitebaseConnection.appCrid
+#define OBJ_LitebaseUseMmap(o)      FIELD_I32(o, 5)					// LitebaseConnection.useMmap
 
 // LitebaseConnection.htTables
 #define getLitebaseHtTables(o)    ((Hashtable*)(size_t)FIELD_I64(o, OBJ_CLASS(o), 0))
@@ -77,6 +78,18 @@
 #define getLitebaseNodes(o)    ((int32*)(size_t)FIELD_I64(o, OBJ_CLASS(o), 3))
 #define setLitebaseNodes(o, v) (FIELD_I64(o, OBJ_CLASS(o), 3) = (size_t)v)
 
+// LitebaseConnection.nodePool 
+#define getLitebaseNodePool(o)    ((NodePool*)(size_t)FIELD_I64(o, OBJ_CLASS(o), 4))
+#define setLitebaseNodePool(o, v) (FIELD_I64(o, OBJ_CLASS(o), 4) = (size_t)v)
+
+// LitebaseConnection.wal 
+#define getLitebaseWal(o)    ((Wal*)(size_t)FIELD_I64(o, OBJ_CLASS(o), 5))
+#define setLitebaseWal(o, v) (FIELD_I64(o, OBJ_CLASS(o), 5) = (size_t)v)
+
+// LitebaseConnection.stmtCache 
+#define getLitebaseStmtCache(o)    ((StatementCache*)(size_t)FIELD_I64(o, OBJ_CLASS(o), 6))
+#define setLitebaseStmtCache(o, v) (FIELD_I64(o, OBJ_CLASS(o), 6) = (size_t)v)
+
 // PreparedStatement
 #define OBJ_PreparedStatementType(o)          FIELD_I32(o, 0)               // PreparedStatement.type  
 #define OBJ_PreparedStatementStoredParams(o)  FIELD_I32(o, 1)               // PreparedStatement.storedParams
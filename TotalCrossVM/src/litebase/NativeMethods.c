@@ -479,10 +479,12 @@ LB_API void lLC_privateGetInstance_s(NMParams p)
  *
  * @param p->obj[0] The creator id, which may be the same one of the current application.
  * @param p->obj[1] Only the folder where it is desired to store the tables, <code>null</code>, if it is desired to use the current data 
- * path, or <code>chars_type = chars_format; path = source_path[;crypto] </code>, where <code>chars_format</code> can be <code>ascii</code> or 
- * <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, and crypto must be used if the tables of the 
- * connection use cryptography. The params can be entered in any order. If only the path is passed as a parameter, unicode is used and there is no 
- * cryptography. Notice that path must be absolute, not relative. 
+ * path, or <code>chars_type = chars_format; path = source_path[;crypto][;wal][;mmap] </code>, where <code>chars_format</code> can be 
+ * <code>ascii</code> or <code>unicode</code>, <code>source_path</code> is the folder where the tables will be stored, crypto must be used if 
+ * the tables of the connection use cryptography, wal makes the changes be written to a write-ahead log and committed after each command or 
+ * by <code>executeUpdate("commit")</code> after a <code>executeUpdate("begin")</code>, and mmap maps the table files into memory on POSIX 
+ * systems, so that reading them does not need a system call. The params can be entered in any order. If only the path 
+ * is passed as a parameter, unicode is used and there is no cryptography. Notice that path must be absolute, not relative. 
  * <p>Note that databases belonging to multiple applications can be stored in the same path, since all tables are prefixed by the application's 
  * creator id.
  * <p>Also notice that to store Litebase files on card on Pocket PC, just set the second parameter to the correct directory path.
@@ -711,7 +713,6 @@ LB_API void lLC_prepareStatement_s(NMParams p) // litebase/LitebaseConnection pu
              prepStmt = null;
       Context context = p->currentContext;
       Heap heapParser = null;
-      LitebaseParser* parse;
       Hashtable* htPS;
 	   JCharP sqlChars = String_charsStart(sqlObj),
              sqlCharsAux;
@@ -754,6 +755,8 @@ LB_API void lLC_prepareStatement_s(NMParams p) // litebase/LitebaseConnection pu
       // The prepared statement.
 	   if (!(prepStmt = p->retO = TC_createObject(context, "litebase.PreparedStatement")))
 		   goto finish;
+	   TC_gcWriteBarrier(prepStmt, driver); // the statement is old, while the parameters may be young
+	   TC_gcWriteBarrier(prepStmt, sqlObj);
 	   OBJ_PreparedStatementDriver(prepStmt) = driver;
 	   OBJ_PreparedStatementSqlExpression(prepStmt) = sqlObj;
       
@@ -770,174 +773,9 @@ LB_API void lLC_prepareStatement_s(NMParams p) // litebase/LitebaseConnection pu
       if (xstrstr(command, "create"))
          OBJ_PreparedStatementType(p->retO) = CMD_CREATE_TABLE;
       else if (xstrstr(command, "delete") || xstrstr(command, "insert") || (isSelect = (xstrstr(command, "select") != null)) || xstrstr(command, "update"))
-      {
-         bool locked = false;
-         Table* table;
-         
-         heapParser = heapCreate();
-	      IF_HEAP_ERROR(heapParser)
-         {
-		      if (locked)
-               UNLOCKVAR(parser);
-            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-            
-free:
-            heapDestroy(heapParser);
-            goto finish;
-         }
-
-         // Parses the sql string.
-	      locked = true;
-	      LOCKVAR(parser);
-	      parse = initLitebaseParser(context, sqlChars, sqlLength, isSelect, heapParser);
-         UNLOCKVAR(parser);
-	      locked = false;
-         
-         // Error checking.
-         if (!parse)
-            goto free;
-         IF_HEAP_ERROR(heapParser)
-         {
-            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-            goto free;
-         }
-
-         // juliana@226_15: corrected a bug that would make a prepared statement with where clause and indices not work correctly after the first 
-         // execution.
-         switch (parse->command) // Gets the command in the SQL expression and creates the apropriate statement.
-         {
-            case CMD_DELETE:
-            {
-               SQLDeleteStatement* deleteStmt = initSQLDeleteStatement(parse, true);  
-               
-               if (litebaseBindDeleteStatement(context, driver, deleteStmt))
-			      {
-				      SQLBooleanClause* whereClause = deleteStmt->whereClause;
-
-                  if (whereClause)
-                     whereClause->expressionTreeBak = cloneTree(whereClause->expressionTree, null, heapParser);
-                  
-                  table = deleteStmt->rsTable->table;
-				      IF_HEAP_ERROR(table->heap)
-                  {
-                     TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-                     goto free;
-                  }
-                  OBJ_PreparedStatementType(prepStmt) = CMD_DELETE;
-                  setPreparedStatementStatement(prepStmt, deleteStmt);
-			         table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
-			      }
-			      else
-                  goto free;
-               break;
-            }
-
-            case CMD_INSERT:
-            {
-               SQLInsertStatement* insertStmt = initSQLInsertStatement(context, driver, parse);
-               
-               if (!insertStmt || !litebaseBindInsertStatement(context, insertStmt))
-                  goto free;
-
-			      OBJ_PreparedStatementType(prepStmt) = CMD_INSERT;
-			      table = insertStmt->table;
-               IF_HEAP_ERROR(table->heap)
-               {
-                  TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-                  goto free;
-               }
-               setPreparedStatementStatement(prepStmt, insertStmt);
-			      table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
-               break;
-            }
-
-            case CMD_SELECT:
-            {
-               SQLSelectStatement* selectStmt = initSQLSelectStatement(parse, true);
-
-               if (litebaseBindSelectStatement(context, driver, selectStmt))
-			      {
-                  SQLSelectClause* selectClause = selectStmt->selectClause;
-				      SQLResultSetTable** tableList = selectClause->tableList;
-                  int32 len = selectClause->tableListSize;
-                  SQLBooleanClause* whereClause = selectStmt->whereClause;
-                  SQLColumnListClause* orderByClause = selectStmt->orderByClause;
-                  SQLColumnListClause* groupByClause = selectStmt->groupByClause;
-                  SQLResultSetField** fieldList;
-                  uint8* fieldTableColIndexesBak;
-                  Heap heap = selectClause->heap;
-                  int32 count;
-
-                  IF_HEAP_ERROR(heap)
-                  {
-                     TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-                     goto free;
-                  }
-
-                  if (orderByClause)
-                  {
-                     fieldList = orderByClause->fieldList;
-                     count = orderByClause->fieldsCount;
-                     fieldTableColIndexesBak = orderByClause->fieldTableColIndexesBak = TC_heapAlloc(heap, count);
-                     while (--count >= 0)
-                        fieldTableColIndexesBak[count] = fieldList[count]->tableColIndex;
-                  }
-
-                  // juliana@226_14: corrected a bug that would make a prepared statement with group by not work correctly after the first execution.
-                  if (groupByClause)
-                  {
-                     fieldList = groupByClause->fieldList;
-                     count = groupByClause->fieldsCount;
-                     fieldTableColIndexesBak = groupByClause->fieldTableColIndexesBak = TC_heapAlloc(heap, count);
-                     while (--count >= 0)
-                        fieldTableColIndexesBak[count] = fieldList[count]->tableColIndex;
-                  }
-
-                  if (whereClause)
-                     whereClause->expressionTreeBak = cloneTree(whereClause->expressionTree, null, heapParser);
-
-				      OBJ_PreparedStatementType(prepStmt) = CMD_SELECT;
-				      setPreparedStatementStatement(prepStmt, selectStmt);
-			         selectStmt->selectClause->sqlHashCode = TC_JCharPHashCode(sqlChars, sqlLength);
-				      while (--len >= 0)
-				      {
-					      table = tableList[len]->table;
-                     IF_HEAP_ERROR(table->heap)
-                     {
-                        TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-                        goto free;
-                     }
-				         table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
-				      }
-			      }
-			      else
-                  goto free;
-               break;
-            }
-
-            case CMD_UPDATE:
-            {
-               SQLUpdateStatement* updateStmt = initSQLUpdateStatement(context, driver, parse, true);
-               SQLBooleanClause* whereClause;
-
-               if (!updateStmt || !litebaseBindUpdateStatement(context, updateStmt))
-                  goto free;
-
-               if ((whereClause = (updateStmt->whereClause)))
-                  whereClause->expressionTreeBak = cloneTree(whereClause->expressionTree, null, heapParser);
-
-               OBJ_PreparedStatementType(prepStmt) = CMD_UPDATE;
-			      table = updateStmt->rsTable->table;
-               IF_HEAP_ERROR(table->heap)
-               {
-                  TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-                  goto free;
-               }
-               setPreparedStatementStatement(prepStmt, updateStmt);
-		         table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
-            }
-         }
-      }
+         heapParser = bindPreparedStatement(context, driver, prepStmt, sqlChars, sqlLength, isSelect);
+      if (context->thrownException)
+         goto finish;
 
       if ((i = sqlLength)) // Tokenizes the sql string looking for '?'.
          while (--i)
@@ -956,6 +794,11 @@ free:
          int16* paramsLength;
          JCharP* paramsAsStrs;
          
+         IF_HEAP_ERROR(heapParser)
+         {
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+            goto finish;
+         }
          if (numParams > 0)
          {
             // Creates the array of parameters.
@@ -1181,9 +1024,13 @@ LB_API void lLC_setRowInc_si(NMParams p)
          XFile* dboFile = &plainDB->dbo;
 
          plainDB->rowInc = setting? inc : DEFAULT_ROW_INC;
-         while (--i >= 0) // Flushes the simple indices.
+         while (--i >= 0) // Flushes the simple and trigram indices.
+         {
             if (columnIndexes[i])
                indexSetWriteDelayed(context, columnIndexes[i], setting);
+            if (table->columnTrigrams && table->columnTrigrams[i])
+               indexSetWriteDelayed(context, table->columnTrigrams[i], setting);
+         }
 			
 		   // juliana@202_18: The composed indices must also be written delayed when setting row increment to a value different to -1.
 		   i = table->numberComposedIndexes;
@@ -1208,6 +1055,60 @@ finish: ;
    MEMORY_TEST_END
 }
 
+//////////////////////////////////////////////////////////////////////////
+// litebase/LitebaseConnection public native void setBulkInsert(String tableName, boolean bulk) throws DriverException;
+/**
+ * Turns the bulk insertion mode of a table on or off. While it is on, the rows inserted or updated in the table only update its primary key. The 
+ * other indices are rebuilt from their sorted keys, which is much faster than inserting the keys one by one, when the mode is turned off, before 
+ * the table is used by a query, an update, or a delete, and when the connection is closed. Connections with a write-ahead log always keep the 
+ * indices up to date.
+ *
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->obj[1] The name of a table.
+ * @param p->i32[0] Indicates if the bulk insertion mode is to be turned on or off.
+ * @throws DriverException If an index can't be rebuilt.
+ */
+LB_API void lLC_setBulkInsert_sb(NMParams p) 
+{
+	TRACE("lLC_setBulkInsert_sb")
+
+   MEMORY_TEST_START
+
+   if (checkParamAndDriver(p, "tableName")) // The driver can't be closed and the table name can't be null.
+   {
+      Context context = p->currentContext;
+      TCObject driver = p->obj[0],
+             tableName = p->obj[1],
+	          logger = litebaseConnectionClass->objStaticValues[1];
+      Table* table;
+      
+      if (logger)
+		{
+			TCObject logSBuffer = litebaseConnectionClass->objStaticValues[2];
+         
+         LOCKVAR(log);
+
+         // Builds the logger StringBuffer contents.
+         StringBuffer_count(logSBuffer) = 0;
+         if (TC_appendCharP(context, logSBuffer, "setBulkInsert ")
+          && TC_appendJCharP(context, logSBuffer, String_charsStart(tableName), String_charsLen(tableName))
+          && TC_appendCharP(context, logSBuffer, p->i32[0]? " true" : " false"))
+            
+         TC_executeMethod(context, loggerLogInfo, logger, logSBuffer); // Logs the Litebase operation.  
+         
+         UNLOCKVAR(log);
+         if (context->thrownException)
+            goto finish;
+		}
+      
+      if ((table = getTableFromName(context, driver, tableName)) && !(table->isBulkInsert = p->i32[0] && !getLitebaseWal(driver)))
+         tableBuildDeferredIndices(context, table);
+   }
+
+finish: ;
+   MEMORY_TEST_END
+}
+
 //////////////////////////////////////////////////////////////////////////
 // juliana@230_27: if a public method in now called when its object is already closed, now an IllegalStateException will be thrown instead of a 
 // DriverException.
@@ -1374,7 +1275,8 @@ LB_API void lLC_purge_s(NMParams p)
       }
 
       // juliana@270_27: now purge will also really purge the table if it only suffers updates.
-      if (table && ((deleted = table->deletedRowsCount) > 0 || table->wasUpdated)) // Removes the deleted records from the table.
+      // Removes the deleted records from the table. Its files are rewritten directly, so the write-ahead log is suspended.
+      if (table && ((deleted = table->deletedRowsCount) > 0 || table->wasUpdated) && litebaseSuspendWal(context, driver)) 
       {
          PlainDB* plainDB = &table->db;
          XFile* dbFile = &plainDB->db;
@@ -1529,11 +1431,8 @@ free:
          {
             XFile* dbo = &plainDB->dbo;
 
-            if ((i = lbfileSetSize(&dbFile->file, 0)) || (i = lbfileSetSize(&dbo->file, 0)))
-            {
-               fileError(context, i, dbFile->name);
+            if (!nfResize(context, dbFile, dbFile->size, 0) || !nfResize(context, dbo, dbo->size, 0))
                goto finish;
-            }
             
             dbo->finalPos = dbFile->finalPos = dbFile->size = dbo->size = plainDB->rowAvail = plainDB->rowCount = 0;
          }
@@ -1555,6 +1454,9 @@ free:
                if (!tableReIndex(context, table, -1, false, composedIndexes[i]))
                   goto finish;
 
+         if (!tableReIndexAllTrigrams(context, table)) // Recreates the trigram indices.
+            goto finish;
+
          // juliana@115_8: saving metadata before recreating the indices does not let .db header become empty.
          // Updates the metadata.
          plainDB->useOldCrypto = false;
@@ -1568,8 +1470,11 @@ free:
          
          // juliana@250_6: corrected a bug on LitebaseConnection.purge() that could corrupt the table.
          plainDB->rowAvail = 0;
-         if ((i = lbfileSetSize(&dbFile->file, dbFile->size = plainDB->rowCount * plainDB->rowSize + plainDB->headerSize))
-          || (i = lbfileFlush(dbFile->file)))
+         i = plainDB->rowCount * plainDB->rowSize + plainDB->headerSize;
+         if (!nfResize(context, dbFile, dbFile->size, i))
+            goto finish;
+         dbFile->size = i;
+         if ((i = lbfileFlush(dbFile->file)))
          {
             fileError(context, i, dbFile->name);
             goto finish;
@@ -1579,7 +1484,8 @@ free:
       
    }
      
-finish: ;
+finish:
+   litebaseResumeWal(p->obj[0]);
    MEMORY_TEST_END
 }
 
@@ -1687,6 +1593,7 @@ LB_API void lLC_getRowIterator_s(NMParams p) // litebase/LitebaseConnection publ
             setRowIteratorTable(rowIterator, table);
             OBJ_RowIteratorRowNumber(rowIterator) = -1;
             OBJ_RowIteratorData(rowIterator) = TC_createArrayObject(context, BYTE_ARRAY, table->db.rowSize);
+            TC_gcWriteBarrier(rowIterator, driver);
             OBJ_RowIteratorDriver(rowIterator) = driver;
             TC_setObjectLock(OBJ_RowIteratorData(rowIterator), UNLOCKED);
          }
@@ -1698,6 +1605,99 @@ finish: ;
    MEMORY_TEST_END
 }
 
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Sets the memory budget of the pool of the index nodes shared by the tables of the connection. The least recently used nodes are evicted, 
+ * after saving the dirty ones, when the pool grows beyond it, but the pool always keeps some nodes whatever its budget is.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->i32[0] The budget in bytes. Negative values are treated as 0.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_setNodePoolBudget_i(NMParams p) // litebase/LitebaseConnection public native void setNodePoolBudget(int budget) throws IllegalStateException;
+{
+	TRACE("lLC_setNodePoolBudget_i")
+   TCObject driver = p->obj[0];
+
+   MEMORY_TEST_START
+
+   if (OBJ_LitebaseDontFinalize(driver)) // The driver can't be closed.
+      TC_throwExceptionNamed(p->currentContext, "java.lang.IllegalStateException", getMessage(ERR_DRIVER_CLOSED));
+   else
+      nodePoolSetBudget(p->currentContext, getLitebaseNodePool(driver), MAX(p->i32[0], 0));
+
+   MEMORY_TEST_END
+}
+
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Gets the memory budget of the pool of the index nodes shared by the tables of the connection.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->retI receives the budget in bytes.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_getNodePoolBudget(NMParams p) // litebase/LitebaseConnection public native int getNodePoolBudget() throws IllegalStateException;
+{
+	TRACE("lLC_getNodePoolBudget")
+   TCObject driver = p->obj[0];
+
+   MEMORY_TEST_START
+
+   if (OBJ_LitebaseDontFinalize(driver)) // The driver can't be closed.
+      TC_throwExceptionNamed(p->currentContext, "java.lang.IllegalStateException", getMessage(ERR_DRIVER_CLOSED));
+   else
+      p->retI = getLitebaseNodePool(driver)->budget;
+
+   MEMORY_TEST_END
+}
+
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Gets how many times an index node was found in the pool of the index nodes of the connection.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->retL receives the number of hits.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_getNodePoolHits(NMParams p) // litebase/LitebaseConnection public native long getNodePoolHits() throws IllegalStateException;
+{
+	TRACE("lLC_getNodePoolHits")
+   TCObject driver = p->obj[0];
+
+   MEMORY_TEST_START
+
+   if (OBJ_LitebaseDontFinalize(driver)) // The driver can't be closed.
+      TC_throwExceptionNamed(p->currentContext, "java.lang.IllegalStateException", getMessage(ERR_DRIVER_CLOSED));
+   else
+      p->retL = getLitebaseNodePool(driver)->hits;
+
+   MEMORY_TEST_END
+}
+
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Gets how many times an index node had to be loaded into the pool of the index nodes of the connection.
+ * 
+ * @param p->obj[0] The connection with Litebase.
+ * @param p->retL receives the number of misses.
+ * @throws IllegalStateException If the driver is closed.
+ */
+LB_API void lLC_getNodePoolMisses(NMParams p) // litebase/LitebaseConnection public native long getNodePoolMisses() throws IllegalStateException;
+{
+	TRACE("lLC_getNodePoolMisses")
+   TCObject driver = p->obj[0];
+
+   MEMORY_TEST_START
+
+   if (OBJ_LitebaseDontFinalize(driver)) // The driver can't be closed.
+      TC_throwExceptionNamed(p->currentContext, "java.lang.IllegalStateException", getMessage(ERR_DRIVER_CLOSED));
+   else
+      p->retL = getLitebaseNodePool(driver)->misses;
+
+   MEMORY_TEST_END
+}
+
 //////////////////////////////////////////////////////////////////////////
 /**
  * Gets the Litebase logger. The fields should be used unless using the logger within threads. 
@@ -1731,6 +1731,35 @@ LB_API void lLC_privateSetLogger_l(NMParams p) // litebase/LitebaseConnection pu
 	MEMORY_TEST_END
 }
 
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Gets the memory budget of the hash tables used by the joins that compare a column without an index with an equality. 
+ * 
+ * @param p->retI receives the budget in bytes.
+ */
+LB_API void lLC_privateGetJoinMemoryBudget(NMParams p) // litebase/LitebaseConnection private static native int privateGetJoinMemoryBudget();
+{
+	TRACE("lLC_privateGetJoinMemoryBudget")
+   MEMORY_TEST_START
+   p->retI = joinMemoryBudget;
+	MEMORY_TEST_END
+}
+
+//////////////////////////////////////////////////////////////////////////
+/**
+ * Sets the memory budget of the hash tables used by the joins that compare a column without an index with an equality. The keys of the inner 
+ * tables whose hash table is larger than the budget are sorted on a temporary file instead. 
+ * 
+ * @param p->i32[0] The budget in bytes. Negative values are treated as 0, which makes all the lookups on tables stored on disk use sorted keys.
+ */
+LB_API void lLC_privateSetJoinMemoryBudget_i(NMParams p) // litebase/LitebaseConnection private static native void privateSetJoinMemoryBudget(int budget);
+{
+	TRACE("lLC_privateSetJoinMemoryBudget_i")
+   MEMORY_TEST_START
+   joinMemoryBudget = MAX(p->i32[0], 0);
+	MEMORY_TEST_END
+}
+
 // juliana@230_4: Litebase default logger is now a plain text file instead of a PDB file.                                                                                             
 //////////////////////////////////////////////////////////////////////////                                                                           
  // litebase/LitebaseConnection public static native totalcross.util.Logger getDefaultLogger() throws DriverException;
@@ -1824,6 +1853,7 @@ finish: ;
       context->thrownException = null;
       TC_throwExceptionNamed(context, "litebase.DriverException", msgError);
 
+      TC_gcWriteBarrier(context->thrownException, exception);
       if (strEq(OBJ_CLASS(context->thrownException)->name, "litebase.DriverException"))
 		   OBJ_DriverExceptionCause(context->thrownException) = exception;
    }
@@ -2023,6 +2053,7 @@ LB_API void lLC_privateProcessLogs_Ssb(NMParams p)
             context->thrownException = null;
             TC_throwExceptionNamed(context, "litebase.DriverException", msgError);
 
+            TC_gcWriteBarrier(context->thrownException, exception);
             if (strEq(OBJ_CLASS(context->thrownException)->name, "litebase.DriverException"))
 				   OBJ_DriverExceptionCause(context->thrownException) = exception;
 			   break;
@@ -2190,7 +2221,7 @@ LB_API void lLC_recoverTable_s(NMParams p)
           // juliana@253_6: the maximum number of keys of a index was duplicated.
 	      // Opens the table even if it was not cloded properly.
 	      if (!(table = tableCreate(context, name, sourcePath, false, (bool)OBJ_LitebaseIsAscii(driver), useCrypto, getLitebaseNodes(driver), 
-	                                                                                                                      false, heap)))
+	                                                                                               getLitebaseNodePool(driver), false, heap)))
             goto finish;
 
 	      i = rows = (plainDB = &table->db)->rowCount;
@@ -2308,6 +2339,9 @@ LB_API void lLC_recoverTable_s(NMParams p)
                   goto finish;
 	      }
 
+         if (!tableReIndexAllTrigrams(context, table)) // Trigram indices.
+            goto finish;
+
          plainDB->wasNotSavedCorrectly = false;
 
          // juliana@224_3: corrected a bug that would make Litebase not use the correct rowid after a recoverTable().	   
@@ -2486,7 +2520,7 @@ LB_API void lLC_convert_s(NMParams p)
           // juliana@253_6: the maximum number of keys of a index was duplicated.
 	      // Opens the table even if it was not cloded properly.
 	      if (!(table = tableCreate(context, name, sourcePath, false, (bool)OBJ_LitebaseIsAscii(driver), useCrypto, getLitebaseNodes(driver), 
-	                                                                                                                      false, heap)))
+	                                                                                               getLitebaseNodePool(driver), false, heap)))
             goto finish;
 
 	      dbFile = (plainDB = &table->db)->db;
@@ -2929,6 +2963,7 @@ LB_API void lRS_getResultSetMetaData(NMParams p) // litebase/ResultSet public na
    if (testRSClosed(p->currentContext, resultSet) && (p->retO = rsMetaData = TC_createObject(p->currentContext, "litebase.ResultSetMetaData")))
    {
       TC_setObjectLock(rsMetaData, UNLOCKED);
+      TC_gcWriteBarrier(rsMetaData, resultSet);
       OBJ_ResultSetMetaData_ResultSet(rsMetaData) = resultSet;	   
    }
    
@@ -4846,17 +4881,11 @@ LB_API void lPS_executeQuery(NMParams p)
       else 
       {
          SQLSelectStatement* selectStmt = (SQLSelectStatement*)getPreparedStatementStatement(stmt); // The select statement.
-         TCObject driver = OBJ_PreparedStatementDriver(stmt);
 
          if (!allParamValuesDefinedSel(selectStmt)) // All the parameters of the select statement must be defined.
             TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_NOT_ALL_PARAMETERS_DEFINED));
          else
          {
-            ResultSet* resultSetBag;
-            SQLSelectClause* selectClause = selectStmt->selectClause;
-            Heap heap = selectClause->heap;
-            bool locked = false;
-            PlainDB* plainDB;
             TCObject logger = litebaseConnectionClass->objStaticValues[1];
           
             // juliana@253_18: now it is possible to log only changes during Litebase operation.
@@ -4877,36 +4906,7 @@ LB_API void lPS_executeQuery(NMParams p)
                   goto finish;
             }
 
-	         resetWhereClause(selectStmt->whereClause, heap);
-
-            IF_HEAP_ERROR(heap)
-            {
-               TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-               goto finish;
-            }
-
-            // guich@554_37: tableColIndex may change between runs of a prepared statement with a sort field so we have to cache the tableColIndex of 
-            // the order by fields.
-            resetColumnListClause(selectStmt->orderByClause);
-
-            // juliana@226_14: corrected a bug that would make a prepared statement with group by not work correctly after the first execution.
-            resetColumnListClause(selectStmt->groupByClause);
-
-            selectClause->isPrepared = true;
-            TC_setObjectLock(p->retO = litebaseDoSelect(context, driver, selectStmt), UNLOCKED);
-
-            if (p->retO)
-            {
-               // Gets the query result table size and stores it.
-               locked = true;
-	            LOCKVAR(parser);
-               resultSetBag = (ResultSet*)getResultSetBag(p->retO);
-               plainDB = &resultSetBag->table->db;
-               if (!muPut(&memoryUsage, selectStmt->selectClause->sqlHashCode, plainDB->db.size, plainDB->dbo.size))
-                  TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
-	            UNLOCKVAR(parser);
-	            locked = false;
-            }
+            TC_setObjectLock(p->retO = psExecuteQuery(context, stmt), UNLOCKED);
          }
       }
    }
@@ -4967,36 +4967,10 @@ LB_API void lPS_executeUpdate(NMParams p) // litebase/PreparedStatement public n
          switch (OBJ_PreparedStatementType(stmt)) // Returns the number of rows affected or if the command was successfully executed.
          {
             case CMD_INSERT:
-            {
-               SQLInsertStatement* insertStmt = (SQLInsertStatement*)getPreparedStatementStatement(stmt);
-   			   
-               rearrangeNullsInTable(insertStmt->table, insertStmt->record, insertStmt->storeNulls, insertStmt->paramDefined, 
-                                                        insertStmt->paramIndexes, insertStmt->nFields, insertStmt->paramCount);
-               if (convertStringsToValues(context, insertStmt->table, insertStmt->record, insertStmt->nFields))
-                  p->retI = litebaseDoInsert(context, insertStmt);
-               break;
-            }
             case CMD_UPDATE:
-            {
-               SQLUpdateStatement* updateStmt = (SQLUpdateStatement*)getPreparedStatementStatement(stmt);
-            
-               resetWhereClause(updateStmt->whereClause, updateStmt->heap); // guich@554_13            
-               rearrangeNullsInTable(updateStmt->rsTable->table, updateStmt->record, updateStmt->storeNulls, updateStmt->paramDefined, 
-                                                                 updateStmt->paramIndexes, updateStmt->nValues, updateStmt->paramCount); 
-               if (allParamValuesDefinedUpd(updateStmt) 
-                && convertStringsToValues(context, updateStmt->rsTable->table, updateStmt->record, updateStmt->nValues))
-                  p->retI = litebaseDoUpdate(context, updateStmt);
-               break;
-            }
             case CMD_DELETE:
-            {
-               SQLDeleteStatement* deleteStmt = (SQLDeleteStatement*)getPreparedStatementStatement(stmt);
-               
-               resetWhereClause(deleteStmt->whereClause, deleteStmt->heap); // guich@554_13
-               if (allParamValuesDefinedDel(deleteStmt))
-                  p->retI = litebaseDoDelete(context, deleteStmt);
+               p->retI = psExecuteUpdate(context, stmt);
                break;
-            }
             case CMD_CREATE_TABLE:
             {
                TCObject sqlExpression = OBJ_PreparedStatementSqlExpression(stmt);
@@ -69,7 +69,11 @@ void freePreparedStatement(int32 unused, TCObject statement)
 					table->preparedStmts = psList;
 				}
 
-            heap = selectClause->heap;
+            // The result sets of a statement of the statement cache still use its select clause, which is freed by the last one to be closed.
+            if (selectClause->resultSets)
+               selectClause->isReleased = true;
+            else
+               heap = selectClause->heap;
             break;
          }
          case CMD_UPDATE:
@@ -95,6 +99,400 @@ void freePreparedStatement(int32 unused, TCObject statement)
    }
 }
 
+/**
+ * Parses and binds the statement of a prepared statement of a delete, insert, select, or update command. The statement is kept by the prepared 
+ * statement, which is also added to the list of prepared statements of its tables.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param prepStmt The prepared statement.
+ * @param sqlChars The sql string.
+ * @param sqlLength The sql string length.
+ * @param isSelect Indicates if the sql command is a select.
+ * @return The heap of the statement or <code>null</code> if the command does not create a statement or an error occurs.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+Heap bindPreparedStatement(Context context, TCObject driver, TCObject prepStmt, JCharP sqlChars, int32 sqlLength, bool isSelect)
+{
+   TRACE("bindPreparedStatement")
+   LitebaseParser* parse;
+   Table* table;
+   Heap heapParser = heapCreate();
+   
+   IF_HEAP_ERROR(heapParser)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      
+free:
+      if (!getPreparedStatementStatement(prepStmt)) // Otherwise, the heap is destroyed when the prepared statement is freed.
+         heapDestroy(heapParser);
+      return null;
+   }
+
+   // Parses the sql string. The parser structure belongs to the thread context, so it does not need to be locked.
+   if (!(parse = initLitebaseParser(context, sqlChars, sqlLength, isSelect, heapParser)))
+      goto free;
+   IF_HEAP_ERROR(heapParser)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      goto free;
+   }
+
+   // juliana@226_15: corrected a bug that would make a prepared statement with where clause and indices not work correctly after the first 
+   // execution.
+   switch (parse->command) // Gets the command in the SQL expression and creates the apropriate statement.
+   {
+      case CMD_DELETE:
+      {
+         SQLDeleteStatement* deleteStmt = initSQLDeleteStatement(parse, true);  
+         
+         if (litebaseBindDeleteStatement(context, driver, deleteStmt))
+         {
+            SQLBooleanClause* whereClause = deleteStmt->whereClause;
+
+            if (whereClause)
+               whereClause->expressionTreeBak = cloneTree(whereClause->expressionTree, null, heapParser);
+            
+            table = deleteStmt->rsTable->table;
+            IF_HEAP_ERROR(table->heap)
+            {
+               TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+               goto free;
+            }
+            OBJ_PreparedStatementType(prepStmt) = CMD_DELETE;
+            setPreparedStatementStatement(prepStmt, deleteStmt);
+            table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
+         }
+         else
+            goto free;
+         break;
+      }
+
+      case CMD_INSERT:
+      {
+         SQLInsertStatement* insertStmt = initSQLInsertStatement(context, driver, parse);
+         
+         if (!insertStmt || !litebaseBindInsertStatement(context, insertStmt))
+            goto free;
+
+         OBJ_PreparedStatementType(prepStmt) = CMD_INSERT;
+         table = insertStmt->table;
+         IF_HEAP_ERROR(table->heap)
+         {
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+            goto free;
+         }
+         setPreparedStatementStatement(prepStmt, insertStmt);
+         table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
+         break;
+      }
+
+      case CMD_SELECT:
+      {
+         SQLSelectStatement* selectStmt = initSQLSelectStatement(parse, true);
+
+         if (litebaseBindSelectStatement(context, driver, selectStmt))
+         {
+            SQLSelectClause* selectClause = selectStmt->selectClause;
+            SQLResultSetTable** tableList = selectClause->tableList;
+            int32 len = selectClause->tableListSize;
+            SQLBooleanClause* whereClause = selectStmt->whereClause;
+            SQLColumnListClause* orderByClause = selectStmt->orderByClause;
+            SQLColumnListClause* groupByClause = selectStmt->groupByClause;
+            SQLResultSetField** fieldList;
+            uint8* fieldTableColIndexesBak;
+            Heap heap = selectClause->heap;
+            int32 count;
+
+            IF_HEAP_ERROR(heap)
+            {
+               TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+               goto free;
+            }
+
+            if (orderByClause)
+            {
+               fieldList = orderByClause->fieldList;
+               count = orderByClause->fieldsCount;
+               fieldTableColIndexesBak = orderByClause->fieldTableColIndexesBak = TC_heapAlloc(heap, count);
+               while (--count >= 0)
+                  fieldTableColIndexesBak[count] = fieldList[count]->tableColIndex;
+            }
+
+            // juliana@226_14: corrected a bug that would make a prepared statement with group by not work correctly after the first execution.
+            if (groupByClause)
+            {
+               fieldList = groupByClause->fieldList;
+               count = groupByClause->fieldsCount;
+               fieldTableColIndexesBak = groupByClause->fieldTableColIndexesBak = TC_heapAlloc(heap, count);
+               while (--count >= 0)
+                  fieldTableColIndexesBak[count] = fieldList[count]->tableColIndex;
+            }
+
+            if (whereClause)
+               whereClause->expressionTreeBak = cloneTree(whereClause->expressionTree, null, heapParser);
+
+            OBJ_PreparedStatementType(prepStmt) = CMD_SELECT;
+            setPreparedStatementStatement(prepStmt, selectStmt);
+            selectStmt->selectClause->sqlHashCode = TC_JCharPHashCode(sqlChars, sqlLength);
+            while (--len >= 0)
+            {
+               table = tableList[len]->table;
+               IF_HEAP_ERROR(table->heap)
+               {
+                  TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+                  goto free;
+               }
+               table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
+            }
+         }
+         else
+            goto free;
+         break;
+      }
+
+      case CMD_UPDATE:
+      {
+         SQLUpdateStatement* updateStmt = initSQLUpdateStatement(context, driver, parse, true);
+         SQLBooleanClause* whereClause;
+
+         if (!updateStmt || !litebaseBindUpdateStatement(context, updateStmt))
+            goto free;
+
+         if ((whereClause = (updateStmt->whereClause)))
+            whereClause->expressionTreeBak = cloneTree(whereClause->expressionTree, null, heapParser);
+
+         OBJ_PreparedStatementType(prepStmt) = CMD_UPDATE;
+         table = updateStmt->rsTable->table;
+         IF_HEAP_ERROR(table->heap)
+         {
+            TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+            goto free;
+         }
+         setPreparedStatementStatement(prepStmt, updateStmt);
+         table->preparedStmts = TC_TCObjectsAdd(table->preparedStmts, prepStmt, table->heap);
+      }
+   }
+   
+   if (!getPreparedStatementStatement(prepStmt))
+      goto free;
+   return heapParser;
+}
+
+/**
+ * Executes the select of a prepared statement whose parameters are all defined.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param statement The prepared statement.
+ * @return The result set of the select or <code>null</code> if an error occurs.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+TCObject psExecuteQuery(Context context, TCObject statement)
+{
+   TRACE("psExecuteQuery")
+   SQLSelectStatement* selectStmt = (SQLSelectStatement*)getPreparedStatementStatement(statement);
+   SQLSelectClause* selectClause = selectStmt->selectClause;
+   Heap heap = selectClause->heap;
+   TCObject resultSet;
+   PlainDB* plainDB;
+
+   IF_HEAP_ERROR(heap)
+   {
+      TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      return null;
+   }
+   resetWhereClause(selectStmt->whereClause, heap);
+
+   // guich@554_37: tableColIndex may change between runs of a prepared statement with a sort field so we have to cache the tableColIndex of 
+   // the order by fields.
+   resetColumnListClause(selectStmt->orderByClause);
+
+   // juliana@226_14: corrected a bug that would make a prepared statement with group by not work correctly after the first execution.
+   resetColumnListClause(selectStmt->groupByClause);
+
+   selectClause->isPrepared = true;
+   if ((resultSet = litebaseDoSelect(context, OBJ_PreparedStatementDriver(statement), selectStmt)))
+   {
+      // Gets the query result table size and stores it.
+      LOCKVAR(parser);
+      plainDB = &getResultSetBag(resultSet)->table->db;
+      if (!muPut(&memoryUsage, selectClause->sqlHashCode, plainDB->db.size, plainDB->dbo.size))
+         TC_throwExceptionNamed(context, "java.lang.OutOfMemoryError", null);
+      UNLOCKVAR(parser);
+   }
+   return resultSet;
+}
+
+/**
+ * Executes the insert, update, or delete of a prepared statement and commits it if there is no explicit transaction.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param statement The prepared statement.
+ * @return The number of rows affected or <code>-1</code> if an error occurs.
+ * @throws DriverException If there are undefined parameters.
+ */
+int32 psExecuteUpdate(Context context, TCObject statement)
+{
+   TRACE("psExecuteUpdate")
+   int32 returnVal = -1;
+
+   // juliana@226_15: corrected a bug that would make a prepared statement with where clause and indices not work correctly after the first 
+   // execution.
+   switch (OBJ_PreparedStatementType(statement)) 
+   {
+      case CMD_INSERT:
+      {
+         SQLInsertStatement* insertStmt = (SQLInsertStatement*)getPreparedStatementStatement(statement);
+   			   
+         rearrangeNullsInTable(insertStmt->table, insertStmt->record, insertStmt->storeNulls, insertStmt->paramDefined, insertStmt->paramIndexes, 
+                                                                                             insertStmt->nFields, insertStmt->paramCount);
+         if (convertStringsToValues(context, insertStmt->table, insertStmt->record, insertStmt->nFields))
+            returnVal = litebaseDoInsert(context, insertStmt);
+         break;
+      }
+      case CMD_UPDATE:
+      {
+         SQLUpdateStatement* updateStmt = (SQLUpdateStatement*)getPreparedStatementStatement(statement);
+            
+         resetWhereClause(updateStmt->whereClause, updateStmt->heap); // guich@554_13            
+         rearrangeNullsInTable(updateStmt->rsTable->table, updateStmt->record, updateStmt->storeNulls, updateStmt->paramDefined, 
+                                                           updateStmt->paramIndexes, updateStmt->nValues, updateStmt->paramCount); 
+         if (allParamValuesDefinedUpd(updateStmt) 
+          && convertStringsToValues(context, updateStmt->rsTable->table, updateStmt->record, updateStmt->nValues))
+            returnVal = litebaseDoUpdate(context, updateStmt);
+         break;
+      }
+      case CMD_DELETE:
+      {
+         SQLDeleteStatement* deleteStmt = (SQLDeleteStatement*)getPreparedStatementStatement(statement);
+               
+         resetWhereClause(deleteStmt->whereClause, deleteStmt->heap); // guich@554_13
+         if (allParamValuesDefinedDel(deleteStmt))
+            returnVal = litebaseDoDelete(context, deleteStmt);
+      }
+   }
+
+   litebaseAutoCommit(context, OBJ_PreparedStatementDriver(statement)); // Commits the changes if there is no explicit transaction.
+   return returnVal;
+}
+
+/**
+ * Gets a statement of a connection from its statement cache, where the deletes, inserts, selects, and updates executed without being prepared are 
+ * kept parsed and bound. If it is not there, it is parsed, bound, and stored in the cache as its most recently used statement, freeing the least 
+ * recently used one if the cache is full. Commands with parameters or which do not create statements are not cached.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param driver The connection with Litebase.
+ * @param sqlChars The sql string.
+ * @param sqlLength The sql string length.
+ * @param isSelect Indicates if the sql command must be a select or an insert, update, or delete.
+ * @return The prepared statement of the sql command or <code>null</code> if it can't be cached or an error occurs.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+TCObject getCachedStatement(Context context, TCObject driver, JCharP sqlChars, int32 sqlLength, bool isSelect)
+{
+   TRACE("getCachedStatement")
+   StatementCache* cache = getLitebaseStmtCache(driver);
+   TCObject* statements = cache->statements;
+   int32* hashCodes = cache->hashCodes;
+   TCObject statement, 
+            sqlObj;
+   JCharP sqlCharsAux = sqlChars;
+   char command[MAX_RESERVED_SIZE];
+   int32 sqlLengthAux = sqlLength,
+         hashCode = TC_JCharPHashCode(sqlChars, sqlLength),
+         i = -1;
+
+   while (++i < cache->count) // Finds the statement by the hash code of its sql, which is then compared.
+   {
+      statement = statements[i];
+      if (hashCodes[i] == hashCode && (sqlObj = OBJ_PreparedStatementSqlExpression(statement))
+       && TC_JCharPEqualsJCharP(String_charsStart(sqlObj), sqlChars, String_charsLen(sqlObj), sqlLength))
+      {
+         // Turns it into the most recently used statement.
+         xmemmove(&statements[1], statements, i * TSIZE);
+         xmemmove(&hashCodes[1], hashCodes, i << 2);
+         statements[0] = statement;
+         hashCodes[0] = hashCode;
+         return statement;
+      }
+   }
+   
+   // Only parses commands that create statements.
+   sqlCharsAux = str16LeftTrim(sqlCharsAux, &sqlLengthAux);
+   TC_CharPToLower(TC_JCharP2CharPBuf(sqlCharsAux, min32(8, sqlLengthAux), command)); // The trimmed sql may be shorter than a command.
+   if (isSelect? !xstrstr(command, "select") : !xstrstr(command, "delete") && !xstrstr(command, "insert") && !xstrstr(command, "update"))
+      return null;
+   i = sqlLength;
+   while (--i >= 0)
+      if (sqlChars[i] == '?')
+         return null;
+
+   if (!(statement = TC_createObject(context, "litebase.PreparedStatement")))
+      return null;
+   TC_gcWriteBarrier(statement, driver);
+   OBJ_PreparedStatementDriver(statement) = driver;
+   if (!(sqlObj = OBJ_PreparedStatementSqlExpression(statement) = TC_createStringObjectWithLen(context, sqlLength)))
+      goto error;
+   xmemmove(String_charsStart(sqlObj), sqlChars, sqlLength << 1);
+   TC_setObjectLock(sqlObj, UNLOCKED);
+   if (!bindPreparedStatement(context, driver, statement, sqlChars, sqlLength, isSelect))
+      goto error;
+
+   if (cache->count == STATEMENT_CACHE_SIZE) // Frees the least recently used statement.
+      freePreparedStatement(0, statements[--cache->count]);
+   xmemmove(&statements[1], statements, cache->count * TSIZE);
+   xmemmove(&hashCodes[1], hashCodes, cache->count++ << 2);
+   statements[0] = statement;
+   hashCodes[0] = hashCode;
+   return statement;
+
+error:
+   freePreparedStatement(0, statement);
+   return null;
+}
+
+/**
+ * Removes a prepared statement from the statement cache of its connection, if it is there. It must be called when the statement is freed because 
+ * one of its tables was closed. 
+ *
+ * @param statement The prepared statement.
+ */
+void removeCachedStatement(TCObject statement)
+{
+   TRACE("removeCachedStatement")
+   StatementCache* cache = getLitebaseStmtCache(OBJ_PreparedStatementDriver(statement));
+   int32 i;
+
+   if (cache)
+   {
+      i = cache->count;
+      while (--i >= 0)
+         if (cache->statements[i] == statement)
+         {
+            xmemmove(&cache->statements[i], &cache->statements[i + 1], (--cache->count - i) * TSIZE);
+            xmemmove(&cache->hashCodes[i], &cache->hashCodes[i + 1], (cache->count - i) << 2);
+            break;
+         }
+   }
+}
+
+/**
+ * Frees the statements of the statement cache of a connection. It must be called before the tables of the connection are changed by a command
+ * which does not create a statement, since the cached statements are bound to them.
+ *
+ * @param driver The connection with Litebase.
+ */
+void clearStatementCache(TCObject driver)
+{
+   TRACE("clearStatementCache")
+   StatementCache* cache = getLitebaseStmtCache(driver);
+
+   if (cache)
+      while (cache->count > 0)
+         freePreparedStatement(0, cache->statements[--cache->count]);
+}
+
 // juliana@230_27: if a public method in now called when its object is already closed, now an IllegalStateException will be thrown instead of a 
 // DriverException.
 /**
@@ -37,6 +37,8 @@ void freeResultSet(ResultSet* resultSet)
    // Only frees the select clause if it is not from a prepared statement, which might be used again.
    if (resultSet->selectClause && !resultSet->isPrepared)
       heapDestroy(resultSet->selectClause->heap);
+   else if (resultSet->isCached && !--resultSet->selectClause->resultSets && resultSet->selectClause->isReleased)
+      heapDestroy(resultSet->selectClause->heap); // The statement of the select was already freed from the statement cache.
    
    // juliana@263_3: corrected a bug where a new result set data could overlap an older result set data if both were related to the same table.
    xfree(resultSet->allRowsBitmap);
@@ -36,6 +36,17 @@ int32 verifyIfIndexAlreadyExists(Context context, Table* table, uint8* columnNum
  */
 bool driverDropIndex(Context context, Table* table, int32 column);
 
+/**
+ * Drops a trigram index.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table whose index is to dropped.
+ * @param column The column of the index dropped.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If the column does not have a trigram index. 
+ */
+bool driverDropTrigramIndex(Context context, Table* table, int32 column);
+
 /**
  * Drops a composed index.
  *
@@ -148,6 +159,75 @@ int32 computeDefaultValuesMetadataSize(Table* table);
  */
 int32 computeComposedIndicesTotalSize(Table* table);
 
+/**
+ * Gets the size needed to store the statistics of a table with all the buckets of their histograms.
+ *
+ * @param table The table.
+ * @return The size of the statistics or zero if the table was not analyzed.
+ */
+int32 computeStatisticsSize(Table* table);
+
+/**
+ * Writes the statistics of a table after its meta data. The header of .db can't grow after the table is created, so the histograms have their 
+ * buckets halved until the statistics fit in the space left. If not even the column counts fit, the statistics are not saved.
+ *
+ * @param table The table.
+ * @param ptr The position of the meta data buffer where the statistics are to be written.
+ * @param available The space left in the header.
+ * @return The position after the statistics.
+ */
+uint8* writeStatistics(Table* table, uint8* ptr, int32 available);
+
+/**
+ * Reads the statistics of a table stored after its meta data, if there are any.
+ *
+ * @param table The table.
+ * @param ptr The position of the meta data buffer after the meta data.
+ * @param available The space left in the header.
+ */
+void readStatistics(Table* table, uint8* ptr, int32 available);
+
+/**
+ * Gathers the statistics of a table and stores them in its header. A sample of evenly spaced rows is read. The number of distinct values of each 
+ * column is estimated from the sample by the Duj1 estimator, and the numeric, date, and datetime columns also get an equi-depth histogram.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a memory allocation fails.
+ */
+bool tableAnalyze(Context context, Table* table);
+
+/**
+ * Gets the value of a column as a number used in its statistics. Numbers, dates, and datetimes keep their order. Strings are hashed, which only 
+ * allows counting their distinct values.
+ *
+ * @param value The value, which can't be null.
+ * @param type The type of the column.
+ * @return The key of the value.
+ */
+double statisticsKey(SQLValue* value, int32 type);
+
+/**
+ * Sorts the keys of a column in the sample of its table.
+ *
+ * @param keys The keys.
+ * @param count The number of keys.
+ */
+void sortStatisticsKeys(double* keys, int32 count);
+
+/**
+ * Estimates the fraction of the rows of an analyzed table which satisfies a comparison between one of its columns and a constant. The equalities 
+ * use the number of distinct values of the column and the other comparisons with a known value interpolate it in the histogram of the column.
+ *
+ * @param table The table, which must have been analyzed.
+ * @param column The column.
+ * @param operator The comparison, which can be a relational operator, <code>IS</code>, or <code>IS NOT</code>.
+ * @param value The constant as a statistics key, or <code>null</code> if it is unknown.
+ * @return The estimated selectivity, from 0 to 1.
+ */
+double columnSelectivity(Table* table, int32 column, int32 operator, double* value);
+
 /**
  * Reorder the values of a statement to match the table definition.
  *
@@ -164,35 +244,127 @@ int32 computeComposedIndicesTotalSize(Table* table);
 bool reorder(Context context, Table* table, CharP* fields, SQLValue** record, uint8* storeNulls, uint8* nValues, uint8* paramIndexes);
 
 /**
- * Sorts a table, using an ORDER BY or GROUP BY clause.
+ * Sorts a table, using an ORDER BY or GROUP BY clause. A binary key is built for each row, so that the keys compared byte by byte have the order of
+ * the rows. The keys are sorted in memory in runs which are merged on disk if they don't fit in the sort memory budget. The rows are then moved to 
+ * their sorted positions.
  * 
  * @param context The thread context where the function is being executed.
  * @param table The table.
  * @param groupByClause The group by clause.
  * @param orderByClause The order by clause.
  * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
- * @throws OutOfMemoryError If a heap memory allocation fails. 
+ * @throws OutOfMemoryError If a memory allocation fails. 
+ * @throws DriverException If the runs file can't be created, read, or written.
  */
 bool sortTable(Context context, Table* table, SQLColumnListClause* groupByClause, SQLColumnListClause* orderByClause);
 
 /**
- * Quick sort method used to sort the table.
- * 
+ * Builds the sort key of a row of a table being sorted. The key ends with the row, so that no two keys are equal.
+ *
  * @param context The thread context where the function is being executed.
- * @param table The table.
- * @param pivot The pivot of this partition;
- * @param someRecord1 An auxiliar record to avoid re-creating it.
- * @param someRecord2 An auxiliar record to avoid re-creating it.
- * @param fieldList The order of comparison of the fields.
- * @param bufAux A buffer to store the records.
- * @param first The first index of this partition.
- * @param last The last index of this partition.
- * @param fieldsCount The number of fields in the field list.
- * @param heap A heap to allocate temporary sort structures.
+ * @param table The table being sorted.
+ * @param fieldList The fields of the sort.
+ * @param sizes The sizes of the string fields or 0 for the other fields.
+ * @param fieldsCount The number of fields of the sort.
+ * @param value A value to read the fields, whose string buffer can hold the largest string field.
+ * @param row The row.
+ * @param key The buffer where the key is built.
  * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
  */
-bool quickSort(Context context, Table* table, SQLValue** pivot, SQLValue** someRecord1, SQLValue** someRecord2, SQLResultSetField** fieldList, 
-                                                                uint8* bufAux, int32 first, int32 last, int32 fieldsCount, Heap heap);
+bool makeSortKey(Context context, Table* table, SQLResultSetField** fieldList, int32* sizes, int32 fieldsCount, SQLValue* value, int32 row, 
+                                                                                                                                      uint8* key);
+
+/**
+ * Stores a field of a sort key. The fields of a key compared byte by byte have the same order as their values compared by 
+ * <code>compareRecords()</code>: nulls are greater than any value, numbers are stored in big endian with their sign bits flipped, strings have their
+ * characters followed by zeros and their lengths, and descending fields have all their bytes inverted. Equal values have equal fields.
+ *
+ * @param key The position of the sort key where the field is stored.
+ * @param value The value of the field.
+ * @param type The type of the field.
+ * @param size The size of a string field.
+ * @param isNull Indicates if the value is null.
+ * @param isAscending Indicates if the field is sorted in ascending order.
+ * @return The position of the sort key after the field.
+ */
+uint8* putSortKeyValue(uint8* key, SQLValue* value, int32 type, int32 size, bool isNull, bool isAscending);
+
+/**
+ * Stores the lowest bytes of a number in a sort key in big endian.
+ *
+ * @param key The position of the sort key where the bytes are stored.
+ * @param bits The number.
+ * @param count The number of bytes to be stored.
+ */
+void putSortKeyBits(uint8* key, uint64 bits, int32 count);
+
+/**
+ * Gets the row stored at the end of a sort key.
+ *
+ * @param key The last four bytes of the sort key.
+ * @return The row of the sort key.
+ */
+int32 getSortKeyRow(uint8* key);
+
+/**
+ * Sorts the keys of a run of a table being sorted. A large run is split in slices, which are sorted by the worker pool of the VM and then merged.
+ * If there are no workers, or if another thread is using them, the slices are sorted by the calling thread. The keys are unique, so the result is
+ * always the same.
+ *
+ * @param keys The pointers to the keys to be sorted.
+ * @param merged Receives the pointers to the keys in their sorted order if the run is split in slices. It must have room for all the keys.
+ * @param count The number of keys.
+ * @param keySize The size of the keys.
+ * @return <code>keys</code> or <code>merged</code>, whichever has the sorted keys.
+ */
+uint8** sortTableRun(uint8** keys, uint8** merged, int32 count, int32 keySize);
+
+/**
+ * Sorts the keys of a run of a table being sorted. It is a quick sort which uses a stack instead of recursion.
+ *
+ * @param keys The pointers to the keys to be sorted.
+ * @param count The number of keys.
+ * @param keySize The size of the keys.
+ */
+void sortTableKeys(uint8** keys, int32 count, int32 keySize);
+
+/**
+ * Writes a sorted run of keys of a table being sorted to the runs file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param runs The runs file.
+ * @param keys The pointers to the sorted keys.
+ * @param count The number of keys.
+ * @param keySize The size of the keys.
+ * @param total The number of keys already written to the runs file.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool writeSortKeys(Context context, XFile* runs, uint8** keys, int32 count, int32 keySize, int32 total);
+
+/**
+ * Merges the sorted runs of keys of a table being sorted, giving the order of its rows. Each run has a block of keys read from the runs file.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param runs The runs file.
+ * @param runEnds The end of each run in the runs file, with space for the position, the number of keys read, and the current key of each run.
+ * @param runCount The number of runs.
+ * @param keySize The size of the keys.
+ * @param order Receives the rows in their sorted order.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enough memory to merge the runs.
+ */
+bool mergeSortRuns(Context context, XFile* runs, int32* runEnds, int32 runCount, int32 keySize, int32* order);
+
+/**
+ * Moves the rows of a table to their sorted positions. Each cycle of the permutation is followed, so that each row is read and written only once.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table being sorted.
+ * @param order The rows in their sorted order. It is destroyed.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If there is not enough memory to keep a row.
+ */
+bool moveSortedRows(Context context, Table* table, int32* order);
 
 /**
  * Compares two records. Used for sorting the table to build the indices from scratch.
@@ -255,11 +427,12 @@ int64 radixPass(int32 start, SQLValue*** source, SQLValue*** dest, int32* count,
  * @param isAscii Indicates if the table strings are to be stored in the ascii format or in the unicode format.
  * @param useCrypto Indicates if the table uses cryptography.
  * @param nodes An array of nodes indices.
+ * @param nodePool The pool of the index nodes of the connection.
  * @param throwException Indicates that a TableNotClosedException should be thrown.
  * @param heap The table heap.
  * @return The table created or <code>null</code> if an error occurs.
  */
-Table* tableCreate(Context context, CharP name, TCHARP sourcePath, bool create, bool isAscii, bool useCrypto, int32* nodes, 
+Table* tableCreate(Context context, CharP name, TCHARP sourcePath, bool create, bool isAscii, bool useCrypto, int32* nodes, NodePool* nodePool,
                                                                                                               bool throwException, Heap heap); 
 
 /**
@@ -314,7 +487,7 @@ bool renameTable(Context context, TCObject driver, Table* table, CharP newTableN
 bool renameTableColumn(Context context, Table* table, CharP oldColumn, CharP newColumn, bool reuseSpace); // rnovais@566_17
 
 /**
- * Re-builds an index of a table.
+ * Re-builds an index of a table. Its keys are sorted and the index is built from the leaves to the root.
  *
  * @param context The thread context where the function is being executed.
  * @param table The table being re-indexed.
@@ -327,6 +500,37 @@ bool renameTableColumn(Context context, Table* table, CharP oldColumn, CharP new
  */
 bool tableReIndex(Context context, Table* table, int32 column, bool isPKCreation, ComposedIndex* composedIndex);
 
+/**
+ * Re-builds a trigram index of a table. The trigrams of the strings of all the rows are sorted and the index is built from the leaves to the root.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table being re-indexed.
+ * @param column The table column number of the index.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a heap memory allocation fails. 
+ */
+bool tableReIndexTrigrams(Context context, Table* table, int32 column);
+
+/**
+ * Re-builds all the trigram indices of a table.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table being re-indexed.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a heap memory allocation fails. 
+ */
+bool tableReIndexAllTrigrams(Context context, Table* table);
+
+/**
+ * Rebuilds the indices of a table left out of date by bulk inserts. The primary key is always up to date.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws OutOfMemoryError If a heap memory allocation fails. 
+ */
+bool tableBuildDeferredIndices(Context context, Table* table);
+
 // juliana@noidr_1: removed .idr files from all indices and changed its format. 
 /**
  * Creates a simple index for the table for the given column.
@@ -344,6 +548,20 @@ bool tableReIndex(Context context, Table* table, int32 column, bool isPKCreation
 bool indexCreateIndex(Context context, Table* table, CharP fullTableName, int32 columnIndex, int32* columnSizes, int8* columnTypes, bool exist, 
                                                                                                                                     Heap heap);
 
+/**
+ * Creates a trigram index for the table for the given column. Its keys are the trigrams of the strings of the column, stored as ints, and its 
+ * records are the rows which have them.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @param fullTableName The table disk name.
+ * @param column The column of the index.
+ * @param exist Indicates that the index files already exist. 
+ * @param heap A heap to allocate the index structure.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ */
+bool indexCreateTrigramIndex(Context context, Table* table, CharP fullTableName, int32 column, bool exist, Heap heap);
+
 // juliana@noidr_1: removed .idr files from all indices and changed its format. 
 /**
  * Creates a composed index for a given table.
@@ -479,7 +697,7 @@ bool resetAuxRowId(Context context, Table* table);
 int32 rowUpdated(int32 id);
 
 /**
- * Frees a table when closing a Litebase connection.
+ * Frees a table when closing a Litebase connection. The indices left out of date by bulk inserts are rebuilt before.
  *
  * @param context The thread context where the function is being executed.
  * @param table The table.
@@ -556,6 +774,27 @@ Table* getTableFromName(Context context, TCObject driver, TCObject name);
  */
 Table* getTable(Context context, TCObject driver, CharP tableName);
 
+/**
+ * Makes the writes to the files of a table go through the write-ahead log of its connection. 
+ *
+ * @param table The table.
+ * @param wal The log of the connection.
+ */
+void tableAttachWal(Table* table, Wal* wal);
+
+#if defined(POSIX) || defined(ANDROID)
+/**
+ * Maps the files of a table into memory, so that they are used as their caches. The indices created afterwards keep using cache windows until the
+ * table is opened again.
+ *
+ * @param context The thread context where the function is being executed.
+ * @param table The table.
+ * @return <code>false</code> if an error occurs; <code>true</code>, otherwise.
+ * @throws DriverException If it is not possible to flush a cache.
+ */
+bool tableMapFiles(Context context, Table* table);
+#endif
+
 /**
  * Reads a string from a buffer.
  *
@@ -607,7 +846,8 @@ uint8* writeStringArray(uint8* buffer, CharP* strings, int32 count);
 uint8* writeString16(uint8* buffer, JCharP string, int32 length);
 
 /**
- * Changes a table to the modified state whenever it is modified.
+ * Changes a table to the modified state whenever it is modified. The tables written through a write-ahead log are never marked, since the log 
+ * already restores them after a crash.
  * 
  * @param context The thread context where the function is being executed.
  * @param table The table to be set as modified.
@@ -634,6 +874,14 @@ int32 randBetween(int32 low, int32 high);
  */
 void test_rowUpdated(TestSuite* testSuite, Context currentContext);
 
+/**
+ * Tests if sortTableRun() sorts the slices of a large run and merges them correctly. 
+ * 
+ * @param testSuite The test structure.
+ * @param currentContext The thread context where the test is being executed.
+ */
+void test_sortTableRun(TestSuite* testSuite, Context currentContext);
+
 #endif
 
 #endif
@@ -31,13 +31,20 @@ void fillNativeProcAddressesLB()
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_getCurrentRowId_s"), &lLC_getCurrentRowId_s);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_getRowCount_s"), &lLC_getRowCount_s);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_setRowInc_si"), &lLC_setRowInc_si);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_setBulkInsert_sb"), &lLC_setBulkInsert_sb);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_exists_s"), &lLC_exists_s);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_closeAll"), &lLC_closeAll);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_purge_s"), &lLC_purge_s);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_getRowCountDeleted_s"), &lLC_getRowCountDeleted_s);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_getRowIterator_s"), &lLC_getRowIterator_s);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_setNodePoolBudget_i"), &lLC_setNodePoolBudget_i);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_getNodePoolBudget"), &lLC_getNodePoolBudget);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_getNodePoolHits"), &lLC_getNodePoolHits);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_getNodePoolMisses"), &lLC_getNodePoolMisses);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateGetLogger"), &lLC_privateGetLogger);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateSetLogger_l"), &lLC_privateSetLogger_l);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateGetJoinMemoryBudget"), &lLC_privateGetJoinMemoryBudget);
+   htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateSetJoinMemoryBudget_i"), &lLC_privateSetJoinMemoryBudget_i);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateGetDefaultLogger"), &lLC_privateGetDefaultLogger);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateDeleteLogFiles"), &lLC_privateDeleteLogFiles);
    htPutPtr(&htNativeProcAddresses, hashCode("lLC_privateProcessLogs_Ssb"), &lLC_privateProcessLogs_Ssb);
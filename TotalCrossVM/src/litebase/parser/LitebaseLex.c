@@ -239,13 +239,16 @@ bool initLex()
       TC_htPut32(&reserved, HT_ABS, TK_ABS);
       TC_htPut32(&reserved, HT_ADD, TK_ADD);
       TC_htPut32(&reserved, HT_ALTER, TK_ALTER);
+      TC_htPut32(&reserved, HT_ANALYZE, TK_ANALYZE);
       TC_htPut32(&reserved, HT_AND, TK_AND);
       TC_htPut32(&reserved, HT_AS, TK_AS);
       TC_htPut32(&reserved, HT_ASC, TK_ASC);
       TC_htPut32(&reserved, HT_AVG, TK_AVG);
+      TC_htPut32(&reserved, HT_BEGIN, TK_BEGIN);
       TC_htPut32(&reserved, HT_BLOB, TK_BLOB);
       TC_htPut32(&reserved, HT_BY, TK_BY);
       TC_htPut32(&reserved, HT_CHAR, TK_CHAR);
+      TC_htPut32(&reserved, HT_COMMIT, TK_COMMIT);
       TC_htPut32(&reserved, HT_COUNT, TK_COUNT);
       TC_htPut32(&reserved, HT_CREATE, TK_CREATE);
       TC_htPut32(&reserved, HT_DATE, TK_DATE);
@@ -257,6 +260,7 @@ bool initLex()
       TC_htPut32(&reserved, HT_DISTINCT, TK_DISTINCT);
       TC_htPut32(&reserved, HT_DOUBLE, TK_DOUBLE);
       TC_htPut32(&reserved, HT_DROP, TK_DROP);
+      TC_htPut32(&reserved, HT_EXPLAIN, TK_EXPLAIN);
       TC_htPut32(&reserved, HT_FLOAT, TK_FLOAT);
       TC_htPut32(&reserved, HT_FROM, TK_FROM);
       TC_htPut32(&reserved, HT_GROUP, TK_GROUP);
@@ -293,6 +297,7 @@ bool initLex()
       TC_htPut32(&reserved, HT_TO, TK_TO);
       TC_htPut32(&reserved, HT_UPDATE, TK_UPDATE);
       TC_htPut32(&reserved, HT_UPPER, TK_UPPER);
+      TC_htPut32(&reserved, HT_USING, TK_USING);
       TC_htPut32(&reserved, HT_VALUES, TK_VALUES);
       TC_htPut32(&reserved, HT_VARCHAR, TK_VARCHAR);
       TC_htPut32(&reserved, HT_WHERE, TK_WHERE);
@@ -392,13 +397,16 @@ TESTCASE(initLex)
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("abs")), TK_ABS); 
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("add")), TK_ADD);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("alter")), TK_ALTER);
+   ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("analyze")), TK_ANALYZE);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("and")), TK_AND);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("as")), TK_AS);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("asc")), TK_ASC);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("avg")), TK_AVG);
+   ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("begin")), TK_BEGIN);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("blob")), TK_BLOB);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("by")), TK_BY);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("char")), TK_CHAR);
+   ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("commit")), TK_COMMIT);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("count")), TK_COUNT);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("create")), TK_CREATE);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("date")), TK_DATE);
@@ -410,6 +418,7 @@ TESTCASE(initLex)
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("distinct")), TK_DISTINCT);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("double")), TK_DOUBLE);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("drop")), TK_DROP);
+   ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("explain")), TK_EXPLAIN);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("float")), TK_FLOAT);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("from")), TK_FROM);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("group")), TK_GROUP);
@@ -446,6 +455,7 @@ TESTCASE(initLex)
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("to")), TK_TO);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("update")), TK_UPDATE);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("upper")), TK_UPPER);
+   ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("using")), TK_USING);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("values")), TK_VALUES);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("varchar")), TK_VARCHAR);
    ASSERT2_EQUALS(I32, TC_htGet32(&reserved, TC_hashCode("where")), TK_WHERE);
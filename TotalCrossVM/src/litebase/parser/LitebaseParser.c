@@ -298,6 +298,24 @@ bool yyparse(LitebaseParser* parser)
          
          token = yylex(parser);
          break;
+      
+      case TK_ANALYZE: // Gathers the statistics of a table.
+         if (yylex(parser) != TK_IDENT)
+            return lbError(ERR_SYNTAX_ERROR, parser);
+         parser->tableList[0] = initSQLResultSetTable(parser->yylval, null, parser->heap); // There's no alias table name here.
+         parser->command = CMD_ANALYZE;
+         token = yylex(parser);
+         break;
+      
+      case TK_BEGIN: // Starts a transaction.
+         parser->command = CMD_BEGIN;
+         token = yylex(parser);
+         break;
+         
+      case TK_COMMIT: // Commits a transaction.
+         parser->command = CMD_COMMIT;
+         token = yylex(parser);
+         break;
                      
       case TK_CREATE:
       {
@@ -336,6 +354,8 @@ bool yyparse(LitebaseParser* parser)
          }  
          
          token = yylex(parser);
+         if (parser->command == CMD_CREATE_INDEX)
+            token = optIndexMethod(token, parser); // Index method.
          break;
       }
       case TK_DELETE: // Delete.
@@ -378,6 +398,8 @@ bool yyparse(LitebaseParser* parser)
          } 
          
          token = yylex(parser);
+         if (parser->command == CMD_DROP_INDEX)
+            token = optIndexMethod(token, parser); // Index method.
          break;
          
       case TK_INSERT: // Insert.
@@ -408,6 +430,12 @@ bool yyparse(LitebaseParser* parser)
          token = yylex(parser);
          break;
          
+      case TK_EXPLAIN: // Explain select: returns the plan of the select.
+         if (yylex(parser) != TK_SELECT)
+            return lbError(ERR_SYNTAX_ERROR, parser);
+         parser->isExplain = true;
+         
+         // Falls through.
       case TK_SELECT: // Select.
          if ((token = yylex(parser)) == TK_DISTINCT) 
             token = yylex(parser);
@@ -1341,6 +1369,25 @@ int32 optWhereClause(int32 token, LitebaseParser* parser)
    return token;
 }
 
+/**
+ * Deals with a possible index method of a create or drop index. The only method besides the default one is <code>USING TRIGRAM</code>.
+ * 
+ * @param token The token where if it is an index method.
+ * @param parser The parser structure.
+ * @return The token received if it is not an index method or the token after the index method.
+ */
+int32 optIndexMethod(int32 token, LitebaseParser* parser)
+{
+   if (token == TK_USING) // Index method.
+   {
+      if (yylex(parser) != TK_IDENT || xstrcmp(parser->yylval, "trigram"))
+         return lbError(ERR_SYNTAX_ERROR, parser);
+      parser->isTrigram = true;
+      token = yylex(parser);
+   }
+   return token;
+}
+
 /**
  * Deals with an order by clause.
  * 
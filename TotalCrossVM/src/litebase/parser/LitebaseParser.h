@@ -248,6 +248,15 @@ int32 aggFunction(int32 token, LitebaseParser* parser);
  */
 int32 optWhereClause(int32 token, LitebaseParser* parser);
 
+/**
+ * Deals with a possible index method of a create or drop index. The only method besides the default one is <code>USING TRIGRAM</code>.
+ * 
+ * @param token The token where if it is an index method.
+ * @param parser The parser structure.
+ * @return The token received if it is not an index method or the token after the index method.
+ */
+int32 optIndexMethod(int32 token, LitebaseParser* parser);
+
 /**
  * Deals with an order by clause.
  * 
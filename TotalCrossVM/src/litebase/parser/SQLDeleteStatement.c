@@ -158,6 +158,7 @@ int32 litebaseDoDelete(Context context, SQLDeleteStatement* deleteStmt)
    Table* table = deleteStmt->rsTable->table;
 	SQLBooleanClause* whereClause = deleteStmt->whereClause;
 	Index** columnIndexes;
+	Index** columnTrigrams;
 	ComposedIndex* compIndex;
 	ComposedIndex** composedIndexes;
 	PlainDB* plainDB;
@@ -177,6 +178,8 @@ int32 litebaseDoDelete(Context context, SQLDeleteStatement* deleteStmt)
 		TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_CANT_READ), deleteStmt->rsTable->tableName);
       return -1;
 	}
+   if (!tableBuildDeferredIndices(context, table)) // The indices left out of date by bulk inserts must be rebuilt.
+      return -1;
 
    dbFile = &(plainDB = &table->db)->db;
 	basbuf = plainDB->basbuf;
@@ -184,10 +187,11 @@ int32 litebaseDoDelete(Context context, SQLDeleteStatement* deleteStmt)
 	// If there are indices, this is needed to remove the values from them.
 	numberComposedIndexes = table->numberComposedIndexes;
 	columnIndexes = table->columnIndexes;
+	columnTrigrams = table->columnTrigrams;
 	hasIndexes = (composedIndexes = table->composedIndexes) != null; // juliana@201_6
 	i = columnCount = table->columnCount;
 	while (--i >= 0)
-		if (columnIndexes[i])
+		if (columnIndexes[i] || (columnTrigrams && columnTrigrams[i]))
 		{
 			hasIndexes = true;
 			break;
@@ -205,7 +209,8 @@ int32 litebaseDoDelete(Context context, SQLDeleteStatement* deleteStmt)
 		{
 			i = columnCount;
 			while (--i >= 0)
-				if (columnIndexes[i] && !indexDeleteAllRows(context, columnIndexes[i]))
+				if ((columnIndexes[i] && !indexDeleteAllRows(context, columnIndexes[i]))
+             || (columnTrigrams && columnTrigrams[i] && !indexDeleteAllRows(context, columnTrigrams[i])))
 			      return -1;
 
 			if ((i = numberComposedIndexes)) // juliana@201_6: It now deletes the erases the composed index when deleting the whole table. 
@@ -277,7 +282,7 @@ int32 litebaseDoDelete(Context context, SQLDeleteStatement* deleteStmt)
          i = columnCount;
 			while (--i >= 0) 
 			{
-				if ((index = columnIndexes[i])) // The max size of a char column of a simple index.
+				if ((index = columnIndexes[i]) || (columnTrigrams && columnTrigrams[i])) // The max size of a char column of a simple or trigram index.
 			      maxSize0 = MAX(maxSize0, columnSizes[i]);
 			   
 			   // Calculates the maximum char column size for each column index of all the composed indices. 
@@ -316,6 +321,18 @@ int32 litebaseDoDelete(Context context, SQLDeleteStatement* deleteStmt)
 						   goto error;
 					}
 
+            if (columnTrigrams) // Trigram indices.
+            {
+               i = columnCount;
+               while (--i >= 0)
+					   if ((index = columnTrigrams[i]) && isBitUnSet(nulls, i))
+                  {
+                     if (!readValue(context, plainDB, keys[0], columnOffsets[i], columnTypes[i], basbuf, false, false, false, -1, null)
+                      || !indexUpdateTrigrams(context, index, keys[0], rs->pos, true))
+						      goto error;
+                  }
+            }
+
 				if ((i = numberComposedIndexes)) // Composed index.
 					while (--i >= 0)
 					{
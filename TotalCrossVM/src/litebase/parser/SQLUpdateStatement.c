@@ -393,6 +393,8 @@ int32 litebaseDoUpdate(Context context, SQLUpdateStatement* updateStmt)
       TC_throwExceptionNamed(context, "litebase.DriverException", getMessage(ERR_CANT_READ), updateStmt->rsTable->tableName);
 		goto error;
 	}
+   if (!tableBuildDeferredIndices(context, table)) // The indices left out of date by bulk inserts must be rebuilt.
+      goto error;
 
    // juliana@250_10: removed some cases when a table was marked as not closed properly without being changed.
    // juliana@226_4: now a table won't be marked as not closed properly if the application stops suddenly and the table was not modified since its 
@@ -186,6 +186,9 @@ TC_API void tufFM_sbWidth_sii(NMParams p);
 TC_API void tufFM_charWidth_si(NMParams p);
 TC_API void tueE_isAvailable(NMParams p);
 TC_API void tuC_updateScreen(NMParams p);
+TC_API void tuC_startDisplayList_g(NMParams p);
+TC_API void tuC_endDisplayList(NMParams p);
+TC_API void tuC_replayDisplayList_gO(NMParams p);
 TC_API void tuMW_exit_i(NMParams p);
 TC_API void tuMW_setTimerInterval_i(NMParams p);
 TC_API void tuMW_minimize(NMParams p);
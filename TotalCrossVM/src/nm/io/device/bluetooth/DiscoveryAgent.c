@@ -256,6 +256,7 @@ TC_API void tidbDA_startInquiry_id(NMParams p) // totalcross/io/device/bluetooth
             else if ((p->retI = inquiryStarted) == true)
             {
                deviceSearchP->inquiryStatus = OPERATION_IN_PROGRESS; // inquiryStarted return true, set status to OPERATION_IN_PROGRESS.
+               WRITE_BARRIER(discoveryAgent, listener);
                DiscoveryAgent_deviceInquiryListener(discoveryAgent) = listener;
             }
          }
@@ -57,6 +57,12 @@ TC_API void jlO_clone(NMParams p) // java/lang/Object native protected Object cl
       if (!(p->retO = cloneObj = createArrayObject(p->currentContext, thisClass->name, length = ARRAYOBJ_LEN(thisObj))))
          return;
       xmemmove(ARRAYOBJ_START(cloneObj), ARRAYOBJ_START(thisObj), TC_ARRAYSIZE(thisClass, length));
+      if (thisClass->flags.isObjectArray) // the clone is old, while the elements may be young
+      {
+         TCObjectArray oa = (TCObjectArray)ARRAYOBJ_START(cloneObj);
+         while (length-- > 0)
+            WRITE_BARRIER(cloneObj, *oa++);
+      }
       setObjectLock(cloneObj, UNLOCKED);
    }
    else if ((p->retO = cloneObj = createObject(p->currentContext, thisClass->name)) != null)
@@ -85,7 +91,10 @@ TC_API void jlO_clone(NMParams p) // java/lang/Object native protected Object cl
       fields = allFields[RegO];
       length = ARRAYLENV(fields);
       while (--length >= 0)
+      {
+         WRITE_BARRIER(cloneObj, FIELD_OBJ(thisObj, thisClass, length));
          FIELD_OBJ(cloneObj, thisClass, length) = FIELD_OBJ(thisObj, thisClass, length);
+      }
       
       setObjectLock(cloneObj, UNLOCKED);
    }
@@ -193,7 +193,10 @@ static void field(NMParams p, Type srcType, bool isGet, void* value)
                if (isGet) 
                   *ovalue = *field; 
                else 
+               {
+                  WRITE_BARRIER(o, *ovalue); // o is null for static fields
                   *field = *ovalue;
+               }
                break;
             }
             case Type_Long:
@@ -405,7 +408,10 @@ TC_API void jlrA_set_oio(NMParams p) // totalcross/lang/reflect/Array public sta
       if (c->name[1] != '&') // object array? - note: we assume that it is valid to set the object array with a null value
       {
          if (checkArrayRange(p->currentContext, array, 0, index))
+         {
+            WRITE_BARRIER(array, value);
             ((TCObject*)ARRAYOBJ_START(array))[index] = value;
+         }
       }
       else // primitive array
       if (value == null)
@@ -407,6 +407,7 @@ TC_API void tsC_fill_Oiio(NMParams p) // totalcross/sys/Convert native public st
    if (checkArrayRange(p->currentContext, ao, from, to-from))
    {
       TCObject* a = (TCObject*)ARRAYOBJ_START(ao);
+      WRITE_BARRIER(ao, value);
       for (a += from; from < to; from++)
          *a++ = value;
    }
@@ -50,7 +50,7 @@ TC_API void tsV_arrayCopy_oioii(NMParams p) // totalcross/sys/Vm native public s
    else
    {
       bool isObjectArray;
-      isObjectArray = OBJ_PROPERTIES(srcArray)->class_->flags.isObjectArray;
+      isObjectArray = OBJ_CLASS(srcArray)->flags.isObjectArray;
       if (isObjectArray && p->currentContext != gcContext) // prevent another thread from calling the gc while running this method, which can change objects in memory and result in a crash
          LOCKVAR(omm);
       if (dstStart < 0)
@@ -81,10 +81,16 @@ TC_API void tsV_arrayCopy_oioii(NMParams p) // totalcross/sys/Vm native public s
             TCObjectArray pdst = (TCObjectArray)dst;
             if (src == dst && srcStart < dstStart) // copy arrays overlap?
                for (psrc += srcStart + length - 1, pdst += dstStart + length - 1;  --length >= 0; ) // must go backwards to allow copy into overlapping array
+               {
+                  WRITE_BARRIER(dstArray, *psrc);
                   *pdst-- = *psrc--;
+               }
             else
                for (psrc += srcStart, pdst += dstStart;  --length >= 0; )
+               {
+                  WRITE_BARRIER(dstArray, *psrc);
                   *pdst++ = *psrc++;
+               }
          }
          else
          {
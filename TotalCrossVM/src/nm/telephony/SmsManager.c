@@ -37,6 +37,7 @@ TC_API void ttSM_registerSmsReceiver_si(NMParams p) // totalcross/telephony/SmsM
    TCObject smsManager = p->obj[0];
    TCObject smsReceiver = p->obj[1];
    int32 port = p->i32[0];
+   WRITE_BARRIER(smsManager, smsReceiver);
    SmsManager_smsReceiver(smsManager) = smsReceiver;
    
 #if defined (ANDROID)   
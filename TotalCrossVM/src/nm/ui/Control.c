@@ -6,6 +6,7 @@
 
 
 #include "tcvm.h"
+#include "DisplayList.h"
 
 void updateScreen(Context currentContext);
 
@@ -14,6 +15,21 @@ TC_API void tuC_updateScreen(NMParams p) // totalcross/ui/Control native public
 {
    updateScreen(p->currentContext);
 }
+//////////////////////////////////////////////////////////////////////////
+TC_API void tuC_startDisplayList_g(NMParams p) // totalcross/ui/Control native static void startDisplayList(totalcross.ui.gfx.Graphics g);
+{
+   startDisplayList(p->currentContext, p->obj[0]);
+}
+//////////////////////////////////////////////////////////////////////////
+TC_API void tuC_endDisplayList(NMParams p) // totalcross/ui/Control native static Object[] endDisplayList();
+{
+   p->retO = endDisplayList(p->currentContext);
+}
+//////////////////////////////////////////////////////////////////////////
+TC_API void tuC_replayDisplayList_gO(NMParams p) // totalcross/ui/Control native static boolean replayDisplayList(totalcross.ui.gfx.Graphics g, Object []list);
+{
+   p->retI = replayDisplayList(p->currentContext, p->obj[0], p->obj[1]);
+}
 
 #ifdef ENABLE_TEST_SUITE
 #include "Control_test.h"
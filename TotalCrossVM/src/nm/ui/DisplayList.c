@@ -0,0 +1,348 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#include "DisplayList.h"
+#include "nm/NativeMethods.h"
+
+#define DL_STATE_SIZE 12          // transX, transY, clipX1, clipY1, clipX2, clipY2, foreColor, backColor, useAA, alpha, isVerticalText, font
+#define DL_MAX_COMMANDS (64*1024) // bigger lists are not worth keeping
+#define DL_MAX_I32 11
+#define DL_MAX_OBJ 2
+
+typedef struct
+{
+   NativeMethod proc;
+   uint8 i32Count, dblCount, objCount; // objCount does not include the Graphics
+   bool copyArrays; // the objects are int arrays, which may be changed after the call
+} TDisplayListOp;
+
+static TDisplayListOp ops[DL_STATE] = // same order of DisplayListOp
+{
+   {tugG_setPixel_ii,                   2, 0, 0, false},
+   {tugG_setPixels_IIi,                 1, 0, 2, true },
+   {tugG_drawLine_iiii,                 4, 0, 0, false},
+   {tugG_drawLine_iiiii,                5, 0, 0, false},
+   {tugG_drawDots_iiii,                 4, 0, 0, false},
+   {tugG_drawRect_iiii,                 4, 0, 0, false},
+   {tugG_fillRect_iiii,                 4, 0, 0, false},
+   {tugG_drawRoundRect_iiiii,           5, 0, 0, false},
+   {tugG_fillRoundRect_iiiii,           5, 0, 0, false},
+   {tugG_drawRoundGradient_iiiiiiiii,  11, 0, 0, false},
+   {tugG_drawPolygon_IIi,               1, 0, 2, true },
+   {tugG_drawPolyline_IIi,              1, 0, 2, true },
+   {tugG_fillPolygon_IIi,               1, 0, 2, true },
+   {tugG_fillPolygonGradient_IIi,       1, 0, 2, true },
+   {tugG_drawEllipse_iiii,              4, 0, 0, false},
+   {tugG_fillEllipse_iiii,              4, 0, 0, false},
+   {tugG_fillEllipseGradient_iiii,      4, 0, 0, false},
+   {tugG_drawCircle_iii,                3, 0, 0, false},
+   {tugG_fillCircle_iii,                3, 0, 0, false},
+   {tugG_fillCircleGradient_iii,        3, 0, 0, false},
+   {tugG_drawArc_iiidd,                 3, 2, 0, false},
+   {tugG_drawPie_iiidd,                 3, 2, 0, false},
+   {tugG_fillPie_iiidd,                 3, 2, 0, false},
+   {tugG_fillPieGradient_iiidd,         3, 2, 0, false},
+   {tugG_drawEllipticalArc_iiiidd,      4, 2, 0, false},
+   {tugG_drawEllipticalPie_iiiidd,      4, 2, 0, false},
+   {tugG_fillEllipticalPie_iiiidd,      4, 2, 0, false},
+   {tugG_fillEllipticalPieGradient_i,   4, 2, 0, false},
+   {tugG_drawText_siii,                 3, 0, 1, false},
+   {tugG_drawImage_iii,                 2, 0, 1, false},
+   {tugG_drawImage_iiib,                3, 0, 1, false},
+   {tugG_copyImageRect_iiiiib,          5, 0, 1, false},
+};
+
+typedef struct
+{
+   int32* cmds;
+   int32 count, capacity;
+   TCObject refs;  // locked Object[] with the objects used by the commands. The first position is reserved for the commands
+   int32 refCount;
+   int32 transX, transY; // translation at the start of the recording
+   int32 state[DL_STATE_SIZE];
+   TCObject font;
+   bool hasState, broken;
+} TDisplayListRecorder;
+
+TCObject displayListGraphics;
+static TDisplayListRecorder rec;
+
+static bool ensureCommands(int32 n)
+{
+   if (rec.count + n > rec.capacity)
+   {
+      int32 capacity = max32(rec.capacity * 2, max32(64, rec.count + n));
+      int32* cmds;
+      if (rec.count + n > DL_MAX_COMMANDS || (cmds = (int32*)xmalloc(capacity * sizeof(int32))) == null)
+         return false;
+      if (rec.count > 0)
+         xmemmove(cmds, rec.cmds, rec.count * sizeof(int32));
+      xfree(rec.cmds);
+      rec.cmds = cmds;
+      rec.capacity = capacity;
+   }
+   return true;
+}
+
+// returns the index of the object in the references, or -1 if there's no memory
+static int32 addReference(Context currentContext, TCObject o, bool copyArray)
+{
+   TCObject* refs = (TCObject*)ARRAYOBJ_START(rec.refs);
+   int32 i;
+   if (!copyArray)
+      for (i = 1; i < rec.refCount; i++)
+         if (refs[i] == o)
+            return i;
+   if (rec.refCount == (int32)ARRAYOBJ_LEN(rec.refs))
+   {
+      TCObject bigger = createArrayObject(currentContext, "[java.lang.Object", rec.refCount * 2); // created locked
+      TCObject* biggerRefs;
+      if (bigger == null)
+         return -1;
+      biggerRefs = (TCObject*)ARRAYOBJ_START(bigger);
+      for (i = 1; i < rec.refCount; i++)
+      {
+         WRITE_BARRIER(bigger, refs[i]);
+         biggerRefs[i] = refs[i];
+      }
+      setObjectLock(rec.refs, UNLOCKED);
+      rec.refs = bigger;
+      refs = biggerRefs;
+   }
+   if (copyArray)
+   {
+      TCObject copy = createIntArray(currentContext, ARRAYOBJ_LEN(o));
+      if (copy == null)
+         return -1;
+      xmemmove(ARRAYOBJ_START(copy), ARRAYOBJ_START(o), ARRAYOBJ_LEN(o) * sizeof(int32));
+      refs[rec.refCount] = copy;
+      setObjectLock(copy, UNLOCKED); // kept by the locked references
+   }
+   else
+   {
+      WRITE_BARRIER(rec.refs, o);
+      refs[rec.refCount] = o;
+   }
+   return rec.refCount++;
+}
+
+static bool recordState(Context currentContext, TCObject g)
+{
+   int32 s[DL_STATE_SIZE];
+   TCObject font = Graphics_font(g);
+   s[0] = Graphics_transX(g) - rec.transX;
+   s[1] = Graphics_transY(g) - rec.transY;
+   s[2] = Graphics_clipX1(g) - rec.transX;
+   s[3] = Graphics_clipY1(g) - rec.transY;
+   s[4] = Graphics_clipX2(g) - rec.transX;
+   s[5] = Graphics_clipY2(g) - rec.transY;
+   s[6] = Graphics_foreColor(g);
+   s[7] = Graphics_backColor(g);
+   s[8] = Graphics_useAA(g);
+   s[9] = Graphics_alpha(g);
+   s[10] = Graphics_isVerticalText(g);
+   if (!rec.hasState || font != rec.font)
+   {
+      if (font == null)
+         s[11] = 0;
+      else
+      if ((s[11] = addReference(currentContext, font, false)) < 0)
+         return false;
+      rec.font = font;
+   }
+   else s[11] = rec.state[11];
+   if (rec.hasState && xmemcmp(s, rec.state, sizeof(s)) == 0)
+      return true;
+   if (!ensureCommands(1 + DL_STATE_SIZE))
+      return false;
+   rec.cmds[rec.count++] = DL_STATE;
+   xmemmove(rec.cmds + rec.count, s, sizeof(s));
+   rec.count += DL_STATE_SIZE;
+   xmemmove(rec.state, s, sizeof(s));
+   rec.hasState = true;
+   return true;
+}
+
+void recordDisplayList(NMParams p, DisplayListOp op)
+{
+   TDisplayListOp* o = &ops[op];
+   int32 i, idx[DL_MAX_OBJ], *c;
+
+   if (rec.broken)
+      return;
+   for (i = 1; i <= o->objCount; i++)
+      if (p->obj[i] == null) // the native draws nothing
+         return;
+   if (!recordState(p->currentContext, p->obj[0]))
+      goto error;
+   for (i = 0; i < o->objCount; i++)
+      if ((idx[i] = addReference(p->currentContext, p->obj[i+1], o->copyArrays)) < 0)
+         goto error;
+   if (!ensureCommands(1 + o->i32Count + o->dblCount * 2 + o->objCount))
+      goto error;
+   c = rec.cmds + rec.count;
+   *c++ = op;
+   xmemmove(c, p->i32, o->i32Count * sizeof(int32));
+   c += o->i32Count;
+   if (o->dblCount > 0)
+   {
+      xmemmove(c, p->dbl, o->dblCount * sizeof(double));
+      c += o->dblCount * 2;
+   }
+   for (i = 0; i < o->objCount; i++)
+      *c++ = idx[i];
+   rec.count = (int32)(c - rec.cmds);
+   return;
+error:
+   rec.broken = true;
+}
+
+void breakDisplayList()
+{
+   rec.broken = true;
+}
+
+bool startDisplayList(Context currentContext, TCObject g)
+{
+   if (g == null || displayListGraphics != null)
+      return false;
+   xmemzero(&rec, sizeof(rec));
+   if ((rec.refs = createArrayObject(currentContext, "[java.lang.Object", 8)) == null) // created locked
+      return false;
+   rec.refCount = 1;
+   rec.transX = Graphics_transX(g);
+   rec.transY = Graphics_transY(g);
+   displayListGraphics = g;
+   return true;
+}
+
+TCObject endDisplayList(Context currentContext)
+{
+   TCObject list = null, cmds;
+   if (displayListGraphics == null)
+      return null;
+   displayListGraphics = null;
+   if (!rec.broken && (cmds = createIntArray(currentContext, rec.count)) != null)
+   {
+      if (rec.count > 0)
+         xmemmove(ARRAYOBJ_START(cmds), rec.cmds, rec.count * sizeof(int32));
+      *((TCObject*)ARRAYOBJ_START(rec.refs)) = cmds;
+      setObjectLock(cmds, UNLOCKED);
+      list = rec.refs;
+   }
+   setObjectLock(rec.refs, UNLOCKED);
+   xfree(rec.cmds);
+   rec.refs = null;
+   return list;
+}
+
+static bool isValidDisplayList(TCObject list)
+{
+   TCObject* refs = (TCObject*)ARRAYOBJ_START(list);
+   int32 nrefs = ARRAYOBJ_LEN(list), *c, *end, n, i;
+   TDisplayListOp* o;
+
+   if (nrefs == 0 || refs[0] == null || !strEq(OBJ_CLASS(refs[0])->name, INT_ARRAY))
+      return false;
+   c = (int32*)ARRAYOBJ_START(refs[0]);
+   end = c + ARRAYOBJ_LEN(refs[0]);
+   for (; c < end; c += n)
+   {
+      int32 op = *c++;
+      if (op == DL_STATE)
+      {
+         n = DL_STATE_SIZE;
+         if (end - c < n || c[11] < 0 || c[11] >= nrefs)
+            return false;
+         continue;
+      }
+      if (op < 0 || op > DL_STATE)
+         return false;
+      o = &ops[op];
+      n = o->i32Count + o->dblCount * 2 + o->objCount;
+      if (end - c < n)
+         return false;
+      for (i = n - o->objCount; i < n; i++)
+         if (c[i] <= 0 || c[i] >= nrefs || refs[c[i]] == null)
+            return false;
+   }
+   return true;
+}
+
+bool replayDisplayList(Context currentContext, TCObject g, TCObject list)
+{
+   TCObject *refs, args[1 + DL_MAX_OBJ], recording, font;
+   int32 *c, *end, i32[DL_MAX_I32], tx, ty, x1, y1, x2, y2, fore, back, useAA, alpha, vertical, i;
+   double dbl[2];
+   TNMParams params;
+   TDisplayListOp* o;
+
+   if (g == null || list == null || !isValidDisplayList(list))
+      return false;
+   refs = (TCObject*)ARRAYOBJ_START(list);
+   c = (int32*)ARRAYOBJ_START(refs[0]);
+   end = c + ARRAYOBJ_LEN(refs[0]);
+
+   // save the state, since the commands change it
+   tx = Graphics_transX(g);     ty = Graphics_transY(g);
+   x1 = Graphics_clipX1(g);     y1 = Graphics_clipY1(g);
+   x2 = Graphics_clipX2(g);     y2 = Graphics_clipY2(g);
+   fore = Graphics_foreColor(g);  back = Graphics_backColor(g);
+   useAA = Graphics_useAA(g);     alpha = Graphics_alpha(g);
+   vertical = Graphics_isVerticalText(g);
+   font = Graphics_font(g);
+   recording = displayListGraphics; // a list replayed while another one is recorded is not recorded again
+   displayListGraphics = null;
+
+   xmemzero(&params, sizeof(params));
+   params.currentContext = currentContext;
+   params.i32 = i32;
+   params.dbl = dbl;
+   params.obj = args;
+   args[0] = g;
+   while (c < end)
+   {
+      int32 op = *c++;
+      if (op == DL_STATE)
+      {
+         Graphics_transX(g) = tx + c[0];
+         Graphics_transY(g) = ty + c[1];
+         Graphics_clipX1(g) = max32(x1, tx + c[2]);
+         Graphics_clipY1(g) = max32(y1, ty + c[3]);
+         Graphics_clipX2(g) = min32(x2, tx + c[4]);
+         Graphics_clipY2(g) = min32(y2, ty + c[5]);
+         Graphics_foreColor(g) = c[6];
+         Graphics_backColor(g) = c[7];
+         Graphics_useAA(g) = c[8];
+         Graphics_alpha(g) = c[9];
+         Graphics_isVerticalText(g) = c[10];
+         Graphics_font(g) = c[11] == 0 ? font : refs[c[11]];
+         c += DL_STATE_SIZE;
+         continue;
+      }
+      o = &ops[op];
+      xmemmove(i32, c, o->i32Count * sizeof(int32));
+      c += o->i32Count;
+      if (o->dblCount > 0)
+      {
+         xmemmove(dbl, c, o->dblCount * sizeof(double));
+         c += o->dblCount * 2;
+      }
+      for (i = 1; i <= o->objCount; i++)
+         args[i] = refs[*c++];
+      o->proc(&params);
+   }
+
+   Graphics_transX(g) = tx;     Graphics_transY(g) = ty;
+   Graphics_clipX1(g) = x1;     Graphics_clipY1(g) = y1;
+   Graphics_clipX2(g) = x2;     Graphics_clipY2(g) = y2;
+   Graphics_foreColor(g) = fore;  Graphics_backColor(g) = back;
+   Graphics_useAA(g) = useAA;     Graphics_alpha(g) = alpha;
+   Graphics_isVerticalText(g) = vertical;
+   WRITE_BARRIER(g, font); // the replayed commands may had changed it
+   Graphics_font(g) = font;
+   displayListGraphics = recording;
+   return true;
+}
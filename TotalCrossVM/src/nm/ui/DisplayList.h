@@ -0,0 +1,86 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#ifndef DISPLAYLIST_H
+#define DISPLAYLIST_H
+
+#include "tcvm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Display lists keep the Graphics natives called by a Control's onPaint, so the next paints can replay them instead of
+ * running onPaint again. While a Graphics is being recorded, each native that draws in it stores its opcode and its
+ * arguments in a command buffer; whenever the translation, clip, colors or font of the Graphics change, a state command
+ * is stored before the next one. Coordinates are kept relative to the translation at the start of the recording, so the
+ * list can be replayed in any position, inside the clip of the target Graphics.
+ *
+ * The finished list is an Object[] whose first element is the int[] with the commands and the others are the objects
+ * the commands refer to (images, strings, fonts and copies of the point arrays), so the list is collected along with
+ * the Control that keeps it. Natives that read the surface or copy from another one can't be replayed, and make the
+ * recording fail. Only one Graphics can be recorded at a time; painting is done by the main thread.
+ */
+
+typedef enum
+{
+   DL_SET_PIXEL,
+   DL_SET_PIXELS,
+   DL_DRAW_LINE,
+   DL_DRAW_LINE_COLOR,
+   DL_DRAW_DOTS,
+   DL_DRAW_RECT,
+   DL_FILL_RECT,
+   DL_DRAW_ROUND_RECT,
+   DL_FILL_ROUND_RECT,
+   DL_DRAW_ROUND_GRADIENT,
+   DL_DRAW_POLYGON,
+   DL_DRAW_POLYLINE,
+   DL_FILL_POLYGON,
+   DL_FILL_POLYGON_GRADIENT,
+   DL_DRAW_ELLIPSE,
+   DL_FILL_ELLIPSE,
+   DL_FILL_ELLIPSE_GRADIENT,
+   DL_DRAW_CIRCLE,
+   DL_FILL_CIRCLE,
+   DL_FILL_CIRCLE_GRADIENT,
+   DL_DRAW_ARC,
+   DL_DRAW_PIE,
+   DL_FILL_PIE,
+   DL_FILL_PIE_GRADIENT,
+   DL_DRAW_ELLIPTICAL_ARC,
+   DL_DRAW_ELLIPTICAL_PIE,
+   DL_FILL_ELLIPTICAL_PIE,
+   DL_FILL_ELLIPTICAL_PIE_GRADIENT,
+   DL_DRAW_TEXT,
+   DL_DRAW_IMAGE,
+   DL_DRAW_IMAGE_CLIP,
+   DL_COPY_IMAGE_RECT,
+   DL_STATE // not a native: changes the translation, clip, colors and font of the Graphics
+} DisplayListOp;
+
+/// The Graphics being recorded, or null
+extern TCObject displayListGraphics;
+
+/// Call at the beginning of a Graphics native that draws something that can be replayed
+#define RECORD_DISPLAY_LIST(p, op) do {if (displayListGraphics != null && (p)->obj[0] == displayListGraphics) recordDisplayList(p, op);} while (0)
+/// Call at the beginning of a Graphics native whose result can't be replayed
+#define BREAK_DISPLAY_LIST(g) do {if (displayListGraphics != null && (g) == displayListGraphics) breakDisplayList();} while (0)
+
+void recordDisplayList(NMParams p, DisplayListOp op);
+void breakDisplayList();
+/// Starts recording the given Graphics. Returns false if another one is already being recorded
+bool startDisplayList(Context currentContext, TCObject g);
+/// Finishes the recording, returning the display list, or null if it can't be replayed or there's no memory
+TCObject endDisplayList(Context currentContext);
+/// Replays the list in the given Graphics, with its current translation and clip. Returns false if the list is invalid
+bool replayDisplayList(Context currentContext, TCObject g, TCObject list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
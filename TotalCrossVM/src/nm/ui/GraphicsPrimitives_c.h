@@ -6,6 +6,8 @@
 #include "tcvm.h"
 #include "PalmFont.h"
 #include "GraphicsPrimitives.h"
+#include "PixelKernels.h"
+#include "TileRaster.h"
 #include "math.h"
 
 #if defined (WP8)
@@ -360,34 +362,10 @@ static void drawSurface(Context currentContext, TCObject dstSurf, TCObject srcSu
 #endif
    for (i=0; i < (uint32)height; i++) // in opengl, only case of image drawing on image
    {
-      PixelConv *ps = (PixelConv*)srcPixels;
-      PixelConv *pt = (PixelConv*)dstPixels;
-      uint32 count = width;
       if (isSrcScreen)
-         for (;count != 0; pt++,ps++, count--)
-         {
-            pt->pixel = ps->pixel;
-            pt->a = 0xFF;
-         }
+         copyOpaquePixels((PixelConv*)dstPixels, (PixelConv*)srcPixels, width);
       else
-         for (;count != 0; pt++,ps++, count--)
-         {
-            int32 a = ps->a * alphaMask;
-            a = (a+1 + (a >> 8)) >> 8; // alphaMask * a / 255
-            if (a == 0xFF)
-               pt->pixel = ps->pixel;
-            else
-            if (a != 0)
-            {
-               int32 ma = 0xFF-a;
-               int32 r = (a * ps->r + ma * pt->r);
-               int32 g = (a * ps->g + ma * pt->g);
-               int32 b = (a * ps->b + ma * pt->b);
-               pt->r = (r+1 + (r >> 8)) >> 8; // fast way to divide by 255
-               pt->g = (g+1 + (g >> 8)) >> 8;
-               pt->b = (b+1 + (b >> 8)) >> 8;
-            }
-         }
+         blendPixels((PixelConv*)dstPixels, (PixelConv*)srcPixels, width, alphaMask);
       srcPixels += srcPitch;
       dstPixels += Graphics_pitch(dstSurf);
    }
@@ -611,10 +589,7 @@ static void drawHLine(Context currentContext, TCObject g, int32 x, int32 y, int3
          pTgt = getGraphicsPixels(g) + y * Graphics_pitch(g) + x;
          if (!currentContext->fullDirty && !Graphics_isImageSurface(g)) markScreenDirty(currentContext, x, y, width, 1);
          if (pixel1 == pixel2) // same color?
-         {
-            while (width-- > 0)
-               *pTgt++ = pixel1;          // plot the pixel
-         }
+            fillPixels(pTgt, pixel1, width);
          else
          {
             int32 i=0;
@@ -908,7 +883,7 @@ static void drawDottedLine(Context currentContext, TCObject g, int32 x1, int32 y
     skia_drawDottedLine(0, x1, y1, x2, y2, pixel1 | Graphics_alpha(g), pixel2 | Graphics_alpha(g));
     skia_restoreClip();
 
-    markDirty(currentContext, g, min32(x1, x2), min32(y1, y2), abs(x2 - x1), abs(y2 - y1));
+    markDirty(currentContext, g, min32(x1, x2), min32(y1, y2), abs(x2 - x1) + 1, abs(y2 - y1) + 1);
 }
 #endif
 
@@ -935,7 +910,7 @@ static void drawLine(Context currentContext, TCObject g, int32 x1, int32 y1, int
    skia_drawLine(0, x1, y1, x2, y2, pixel | Graphics_alpha(g));
    skia_restoreClip();
 
-   markDirty(currentContext, g, min32(x1, x2), min32(y1, y2), abs(x2 - x1), abs(y2 - y1));
+   markDirty(currentContext, g, min32(x1, x2), min32(y1, y2), abs(x2 - x1) + 1, abs(y2 - y1) + 1);
 }
 #endif
 
@@ -961,6 +936,77 @@ static void drawRect(Context currentContext, TCObject g, int32 x, int32 y, int32
 }
 #endif
 
+#ifndef SKIA_H
+// Splits the given rectangle in bands of rows to be drawn by runTiles, clipping each one with translateAndClip. If g is
+// null, the rectangle is already in absolute coordinates and is not clipped. Returns the number of bands
+static int32 splitTiles(TCObject g, int32 x, int32 y, int32 w, int32 h, TileClip* tiles)
+{
+   int32 rows, n = 0, i, bx, by, bw, bh;
+   if (g != null)
+   {
+      if (!translateAndClip(g, &x, &y, &w, &h))
+         return 0;
+      x -= Graphics_transX(g); // back to the coordinates of g
+      y -= Graphics_transY(g);
+   }
+   rows = getTileRows(h);
+   for (i = 0; i < h; i += rows)
+   {
+      bx = x; by = y + i;
+      bw = w; bh = min32(rows, h - i);
+      if (g == null || translateAndClip(g, &bx, &by, &bw, &bh))
+      {
+         tiles[n].x1 = bx;
+         tiles[n].y1 = by;
+         tiles[n].x2 = bx + bw;
+         tiles[n].y2 = by + bh;
+         n++;
+      }
+   }
+   return n;
+}
+
+// All the bands have the same columns, so the area drawn is the rectangle from the first band to the last one
+static void markTilesDirty(Context currentContext, TCObject g, TileClip* tiles, int32 count)
+{
+   if (count > 0 && !currentContext->fullDirty && !Graphics_isImageSurface(g))
+      markScreenDirty(currentContext, tiles[0].x1, tiles[0].y1, tiles[0].x2 - tiles[0].x1, tiles[count-1].y2 - tiles[0].y1);
+}
+
+// Fills the pixels of the row from x to x+width-1 clipping them to the tile, like drawHLine does with the clip
+static void fillTileSpan(TileClip* tile, Pixel* row, int32 x, int32 width, Pixel pixel)
+{
+   if (x < tile->x1)
+   {
+      width -= tile->x1 - x;
+      x = tile->x1;
+   }
+   if ((x+width) > tile->x2)
+      width = tile->x2 - x;
+   if (width > 0)
+      fillPixels(row + x, pixel, width);
+}
+
+typedef struct
+{
+   Pixel* pixels;
+   int32 pitch;
+   Pixel pixel;
+} FillTiles;
+
+static void fillRectTile(VoidP job, TileClip* tile, int32 worker)
+{
+   FillTiles* f = (FillTiles*)job;
+   int32 w = tile->x2 - tile->x1, y;
+   Pixel* to = f->pixels + tile->y1 * f->pitch + tile->x1;
+   if (w == f->pitch)
+      fillPixels(to, f->pixel, w * (tile->y2 - tile->y1));
+   else
+      for (y = tile->y1; y < tile->y2; y++, to += f->pitch)
+         fillPixels(to, f->pixel, w);
+}
+#endif
+
 // Description:
 //   Device specific routine.
 //   Fills a rectangle with the given color
@@ -1004,25 +1050,24 @@ static void fillRect(Context currentContext, TCObject g, int32 x, int32 y, int32
       else
 #endif
       {
-         uint32 count;
          int32 pitch = Graphics_pitch(g);
          Pixel* to = getGraphicsPixels(g) + y * pitch + x;
          if (!currentContext->fullDirty && !Graphics_isImageSurface(g)) markScreenDirty(currentContext, x, y, width, height);
-         if (x == 0 && width == pitch) // filling with full width?
+         if (useTiles(width*height))
          {
-            int32* t = (int32*)to;
-            int32 p2 = pixel;
-            count = width*height;
-            for (; count != 0; count--)
-               *t++ = p2;
+            TileClip tiles[TILE_MAX_COUNT];
+            FillTiles job;
+            job.pixels = getGraphicsPixels(g);
+            job.pitch = pitch;
+            job.pixel = pixel;
+            runTiles(fillRectTile, &job, tiles, splitTiles(g, x - Graphics_transX(g), y - Graphics_transY(g), width, height, tiles));
          }
          else
-         {
-            uint32 i = width, j = height;
-            for (pitch -= width; j != 0;  to += pitch, i=width, j--)
-               for (; i != 0; i--)
-                  *to++ = pixel;
-         }
+         if (x == 0 && width == pitch) // filling with full width?
+            fillPixels(to, pixel, width*height);
+         else
+            for (; height != 0; to += pitch, height--)
+               fillPixels(to, pixel, width);
       }
    }
 }
@@ -1054,7 +1099,7 @@ static void fadeScreen(Context currentContext, int32 amount) {
 #define INTERP(j,f,shift) (j + (((f - j) * transparency) >> shift)) & 0xFF
 
 static uint8 _ands8[8] = {0x80,0x40,0x20,0x10,0x08,0x04,0x02,0x01};
-uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32 w, int32 h);
+uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32 w, int32 h, int32* pitch); // must be used with the fonts lock held
 
 static void drawText(Context currentContext, TCObject g, JCharP text, int32 chrCount, int32 x0, int32 y0, Pixel foreColor, int32 justifyWidth)
 {
@@ -1331,11 +1376,12 @@ static void drawText(Context currentContext, TCObject g, JCharP text, int32 chrC
                                uf->ubase->maxW, uf->ubase->maxH, &fc, 255);              // total bitmap size
                else
                {                         
-                  uint8* alpha = getResizedCharPixels(currentContext, uf->ubase, ch, width+diffW, height);
+                  uint8* alpha;
+                  LOCKVAR(fonts); // the resized char may be replaced by another thread
+                  alpha = getResizedCharPixels(currentContext, uf->ubase, ch, width+diffW, height, &rowWIB);
                   if (alpha)
                   {                             
                      int32 nn=0;
-                     rowWIB = width+diffW;
                      start = alpha + istart * rowWIB;
                      xya = glXYA;
                      for (; r < rmax; start+=rowWIB, r++,y++)    // draw each row
@@ -1358,15 +1404,17 @@ static void drawText(Context currentContext, TCObject g, JCharP text, int32 chrC
                      if (nn > 0) // flush vertices buffer
                         glDrawPixels(nn,foreColor);
                   }
+                  UNLOCKVAR(fonts);
                }
             }
             else
    #endif // case 2
             {
-               uint8* alpha = getResizedCharPixels(currentContext, uf->ubase, ch, width+diffW, height);
+               uint8* alpha;
+               LOCKVAR(fonts); // the resized char may be replaced by another thread
+               alpha = getResizedCharPixels(currentContext, uf->ubase, ch, width+diffW, height, &rowWIB);
                if (alpha)
                {                             
-                  rowWIB = width+diffW;
                   start = alpha + istart * rowWIB;
                   for (row=row0; r < rmax; start+=rowWIB, r++,row += pitch)    // draw each row
                   {
@@ -1388,6 +1436,7 @@ static void drawText(Context currentContext, TCObject g, JCharP text, int32 chrC
                      }
                   }
                }
+               UNLOCKVAR(fonts);
             }
          }
       }
@@ -1432,7 +1481,8 @@ static void drawText(Context currentContext, TCObject g, JCharP text, int32 chrC
    skia_drawText(0, text, chrCount * sizeof(JChar), x, y + fontSize, foreColor | Graphics_alpha(g), justifyWidth, fontSize, typefaceIndex);
    skia_restoreClip();
 
-   markDirty(currentContext, g, x, y, skia_stringWidth(text, chrCount * sizeof(JChar), typefaceIndex, fontSize), fontSize);
+   // the baseline is at y + fontSize, so the descenders go below it; half of the size covers them in any typeface
+   markDirty(currentContext, g, x, y, skia_stringWidth(text, chrCount * sizeof(JChar), typefaceIndex, fontSize) + 1, fontSize * 3 / 2 + 1);
 }
 #endif
 
@@ -1564,7 +1614,7 @@ static void ellipseDrawAndFill(Context currentContext, TCObject g, int32 xc, int
    skia_ellipseDrawAndFill(0, xc, yc, rx, ry, pc1 | Graphics_alpha(g), pc2 | Graphics_alpha(g), fill, gradient);
    skia_restoreClip();
 
-   markDirty(currentContext, g, xc - rx, yc + ry, rx * 2, ry * 2);
+   markDirty(currentContext, g, xc - rx, yc - ry, rx * 2 + 1, ry * 2 + 1);
 }
 #endif
 
@@ -1598,23 +1648,142 @@ static void qsortInts(int32 *items, int32 first, int32 last)
       qsortInts(items, low,last);
 }
 
-static TCObject growIntArray(Context currentContext, TCObject oldArrayObj, int32 newLen) // must unlock the returned obj
+// Stores in ints the x coordinates where the edges of the polygons cross the row y, returning how many were found. There can
+// be one for each edge at most, so ints must have room for the sum of the number of points of both polygons
+static int32 getPolygonIntersections(int32 **axPoints, int32 **ayPoints, int32 *anPoints, int32 tx, int32 ty, int32 y, int32 maxy, int32 *ints)
+{
+   int32 x1, y1, x2, y2, temp, i, j, a, n = 0;
+   for (a = 0; a < 2; a++)
+   {
+      int32 nPoints = anPoints[a];
+      int32* xPoints = axPoints[a];
+      int32* yPoints = ayPoints[a];
+      j = nPoints-1;
+      for (i = 0; i < nPoints; j=i,i++)
+      {
+         y1 = yPoints[j]+ty;
+         y2 = yPoints[i]+ty;
+         if (y1 == y2)
+            continue;
+         if (y1 > y2) // invert
+         {
+            temp = y1;
+            y1 = y2;
+            y2 = temp;
+         }
+         // compute next x point
+         if ( (y1 <= y && y < y2) || (y == maxy && y1 < y && y <= y2) )
+         {
+            if (yPoints[j] < yPoints[i])
+            {
+               x1 = xPoints[j]+tx;
+               x2 = xPoints[i]+tx;
+            }
+            else
+            {
+               x2 = xPoints[j]+tx;
+               x1 = xPoints[i]+tx;
+            }
+            ints[n++] = (y - y1) * (x2 - x1) / (y2 - y1) + x1;
+         }
+      }
+   }
+   return n;
+}
+
+typedef struct
 {
-   TCObject newArrayObj = createArrayObject(currentContext, INT_ARRAY, newLen);
-   int32 *newArray,*oldArray, oldLen;
-   if (newArrayObj != null)
+   int32 *axPoints[2], *ayPoints[2], anPoints[2];
+   int32 tx, ty, miny, maxy, transX, transY;
+   int32 *ints, maxInts; // scratch buffer with maxInts for each worker
+   Pixel* pixels;
+   int32 pitch;
+   Pixel pixel;
+} PolygonTiles;
+
+static void fillPolygonTile(VoidP p, TileClip* tile, int32 worker)
+{
+   PolygonTiles* job = (PolygonTiles*)p;
+   int32 *ints = job->ints + worker * job->maxInts, *yp;
+   int32 y = max32(job->miny, tile->y1 - job->transY), lastY = min32(job->maxy, tile->y2 - 1 - job->transY), n;
+   Pixel* row;
+   for (; y <= lastY; y++)
+   {
+      row = job->pixels + (y + job->transY) * job->pitch;
+      n = getPolygonIntersections(job->axPoints, job->ayPoints, job->anPoints, job->tx, job->ty, y, job->maxy, ints);
+      if (n == 2)
+      {
+         if (ints[1] > ints[0])
+            fillTileSpan(tile, row, ints[0] + job->transX, ints[1]-ints[0], job->pixel);
+         else
+            fillTileSpan(tile, row, ints[1] + job->transX, ints[0]-ints[1], job->pixel);
+      }
+      else
+      if (n > 2)
+      {
+         qsortInts(ints, 0, n-1);
+         for (n>>=1, yp = ints; --n >= 0; yp+=2)
+            fillTileSpan(tile, row, yp[0] + job->transX, yp[1]-yp[0], job->pixel);
+      }
+   }
+}
+
+// The rows of a polygon without gradient don't depend on each other, so they can be filled in tiles
+static bool fillPolygonInTiles(Context currentContext, TCObject g, int32 **axPoints, int32 **ayPoints, int32 *anPoints, int32 tx, int32 ty,
+   int32 miny, int32 maxy, Pixel pixel)
+{
+   TileClip tiles[TILE_MAX_COUNT];
+   PolygonTiles job;
+   int32 clipX = Graphics_clipX1(g) - Graphics_transX(g), clipW = Graphics_clipX2(g) - Graphics_clipX1(g), count, a, i, x, y, w, h;
+   int32 minx = *axPoints[0], maxx = minx;
+
+   if (Graphics_useOpenGL(g))
+      return false;
+   for (a = 0; a < 2; a++)
+      for (i = anPoints[a]; --i >= 0;)
+      {
+         if (axPoints[a][i] < minx) minx = axPoints[a][i];
+         if (axPoints[a][i] > maxx) maxx = axPoints[a][i];
+      }
+   if (!useTiles((maxx - minx + 1) * (maxy - miny + 1)))
+      return false;
+   // the bands have all the columns of the clip, like the lines drawn by drawHLine
+   count = splitTiles(g, clipX, miny, clipW, maxy - miny + 1, tiles);
+   job.maxInts = max32(2, anPoints[0] + anPoints[1]);
+   if (count > 0 && (job.ints = (int32*)xmalloc(TILE_MAX_WORKERS * job.maxInts * sizeof(int32))) == null)
+      return false;
+   if (count > 0)
    {
-      newArray = (int32*)ARRAYOBJ_START(newArrayObj);
-      oldArray = (int32*)ARRAYOBJ_START(oldArrayObj);
-      oldLen = ARRAYOBJ_LEN(oldArrayObj);
-      xmemmove(newArray, oldArray, oldLen * 4);
+      for (a = 0; a < 2; a++)
+      {
+         job.axPoints[a] = axPoints[a];
+         job.ayPoints[a] = ayPoints[a];
+         job.anPoints[a] = anPoints[a];
+      }
+      job.tx = tx;
+      job.ty = ty;
+      job.miny = miny;
+      job.maxy = maxy;
+      job.transX = Graphics_transX(g);
+      job.transY = Graphics_transY(g);
+      job.pixels = getGraphicsPixels(g);
+      job.pitch = Graphics_pitch(g);
+      job.pixel = pixel;
+      runTiles(fillPolygonTile, &job, tiles, count);
+      xfree(job.ints);
+      x = minx + tx; // the spans are inside the bounds of the points
+      y = miny;
+      w = maxx - minx + 1;
+      h = maxy - miny + 1;
+      if (!currentContext->fullDirty && !Graphics_isImageSurface(g) && translateAndClip(g, &x, &y, &w, &h))
+         markScreenDirty(currentContext, x, y, w, h);
    }
-   return newArrayObj;
+   return true;
 }
 
 static void fillPolygon(Context currentContext, TCObject g, int32 *xPoints1, int32 *yPoints1, int32 nPoints1, int32 *xPoints2, int32 *yPoints2, int32 nPoints2, int32 tx, int32 ty, Pixel c1, Pixel c2, bool gradient, bool isPie)
 {
-   int32 x1, y1, x2, y2,y,n=0,temp, i,j, miny, maxy, a, numSteps=0, startRed=0, startGreen=0, startBlue=0, endRed=0, endGreen=0, endBlue=0, redInc=0, greenInc=0, blueInc=0, red=0, green=0, blue=0;
+   int32 y,n=0,i, miny, maxy, maxInts, numSteps=0, startRed=0, startGreen=0, startBlue=0, endRed=0, endGreen=0, endBlue=0, redInc=0, greenInc=0, blueInc=0, red=0, green=0, blue=0;
    int32 *yp;
    int32 *axPoints[2], *ayPoints[2], anPoints[2];
    TCObject *intsObj = &Graphics_ints(g);
@@ -1654,11 +1823,16 @@ static void fillPolygon(Context currentContext, TCObject g, int32 *xPoints1, int
    miny += ty;
    maxy += ty;
 
-   if (ints == null)
+   if (!gradient && fillPolygonInTiles(currentContext, g, axPoints, ayPoints, anPoints, tx, ty, miny, maxy, c1))
+      return;
+
+   maxInts = max32(2, nPoints1 + nPoints2); // a row can't cross more edges than the polygons have
+   if (ints == null || (int32)ARRAYOBJ_LEN(*intsObj) < maxInts)
    {
-      *intsObj = createArrayObject(currentContext, INT_ARRAY, 2); // 2 is the most used length
-      if (*intsObj == null)
+      TCObject newIntsObj = createArrayObject(currentContext, INT_ARRAY, maxInts);
+      if (newIntsObj == null)
          return;
+      *intsObj = newIntsObj;
       setObjectLock(*intsObj, UNLOCKED);
       ints = (int32*)ARRAYOBJ_START(*intsObj);
    }
@@ -1684,51 +1858,7 @@ static void fillPolygon(Context currentContext, TCObject g, int32 *xPoints1, int
    else c.pixel = c1;
    for (y = miny; y <= maxy; y++)
    {
-      n = 0;
-      for (a = 0; a < 2; a++)
-      {
-         int32 nPoints = anPoints[a];
-         int32* xPoints = axPoints[a];
-         int32* yPoints = ayPoints[a];
-         j = nPoints-1;
-         for (i = 0; i < nPoints; j=i,i++)
-         {
-            y1 = yPoints[j]+ty;
-            y2 = yPoints[i]+ty;
-            if (y1 == y2)
-               continue;
-            if (y1 > y2) // invert
-            {
-               temp = y1;
-               y1 = y2;
-               y2 = temp;
-            }
-            // compute next x point
-            if ( (y1 <= y && y < y2) || (y == maxy && y1 < y && y <= y2) )
-            {
-               if (n == (int32)ARRAYOBJ_LEN(*intsObj)) // have to grow the ints array?
-               {
-                  TCObject newIntsObj = growIntArray(currentContext, *intsObj, n * 2);
-                  if (newIntsObj == null)
-                     return;
-                  *intsObj = newIntsObj;
-                  setObjectLock(*intsObj, UNLOCKED);
-                  ints = (int32*)ARRAYOBJ_START(*intsObj);
-               }
-               if (yPoints[j] < yPoints[i])
-               {
-                  x1 = xPoints[j]+tx;
-                  x2 = xPoints[i]+tx;
-               }
-               else
-               {
-                  x2 = xPoints[j]+tx;
-                  x1 = xPoints[i]+tx;
-               }
-               ints[n++] = (y - y1) * (x2 - x1) / (y2 - y1) + x1;
-            }
-         }
-      }
+      n = getPolygonIntersections(axPoints, ayPoints, anPoints, tx, ty, y, maxy, ints);
       if (n >= 2)
       {
          if (gradient)
@@ -1818,7 +1948,7 @@ static void arcPiePointDrawAndFill(Context currentContext, TCObject g, int32 xc,
    skia_arcPiePointDrawAndFill(0, xc, yc, rx, ry, startAngle, endAngle, c | Graphics_alpha(g), c2 | Graphics_alpha(g), fill, pie, gradient);
    skia_restoreClip();
 
-   markDirty(currentContext, g, xc - rx, yc + ry, rx * 2, ry * 2);
+   markDirty(currentContext, g, xc - rx, yc - ry, rx * 2 + 1, ry * 2 + 1);
 }
 #else
 static void arcPiePointDrawAndFill(Context currentContext, TCObject g, int32 xc, int32 yc, int32 rx, int32 ry, double startAngle, double endAngle, Pixel c, Pixel c2, bool fill, bool pie, bool gradient)
@@ -2359,6 +2489,76 @@ static void checkKeyboardAndSIP(Context currentContext, int32 *shiftY, int32 *sh
 int32 desiredScreenShiftY=UNDEFINED_SHIFTY;
 void setShiftYgl(int32 shiftY);
 
+#if !defined(SKIA_H) && !defined(__gl2_h_)
+typedef struct
+{
+   PixelConv* pixels;
+   int32 width, fadeValue;
+} FadeTiles;
+
+static void fadeScreenTile(VoidP p, TileClip* tile, int32 worker)
+{
+   FadeTiles* job = (FadeTiles*)p;
+   PixelConv *pixels = job->pixels + tile->y1 * job->width;
+   int32 fadeValue = job->fadeValue, len, r, g, b;
+   for (len = (tile->y2 - tile->y1) * job->width; len-- > 0; pixels++)
+   {
+      r = pixels->r * fadeValue; pixels->r = (r+1 + (r >> 8)) >> 8;
+      g = pixels->g * fadeValue; pixels->g = (g+1 + (g >> 8)) >> 8;
+      b = pixels->b * fadeValue; pixels->b = (b+1 + (b >> 8)) >> 8;
+   }
+}
+
+// Multiplies the colors of the main window by fadeValue/255. The screen must be locked by the caller
+static void fadeScreenPixels(int32 fadeValue)
+{
+   TileClip tiles[TILE_MAX_COUNT];
+   FadeTiles job;
+   job.pixels = (PixelConv*)ARRAYOBJ_START(screen.mainWindowPixels);
+   job.width = screen.screenW;
+   job.fadeValue = fadeValue;
+   if (useTiles(screen.screenW * screen.screenH))
+      runTiles(fadeScreenTile, &job, tiles, splitTiles(null, 0, 0, screen.screenW, screen.screenH, tiles));
+   else
+   {
+      tiles[0].x1 = tiles[0].y1 = 0;
+      tiles[0].x2 = screen.screenW;
+      tiles[0].y2 = screen.screenH;
+      fadeScreenTile(&job, tiles, 0);
+   }
+}
+
+typedef struct
+{
+   PixelConv* from;
+   Pixel565* to;
+   int32 width, shiftY, shiftH;
+   Pixel565 gray;
+} ScreenTiles;
+
+// Converts the rows of the main window to the 565 screen, shifted up by shiftY, painting in gray the rows below shiftH
+static void updateScreenTile(VoidP p, TileClip* tile, int32 worker)
+{
+   ScreenTiles* job = (ScreenTiles*)p;
+   Pixel565 *t = job->to + tile->y1 * job->width;
+   PixelConv *f;
+   int32 y, count;
+   for (y = tile->y1; y < tile->y2; y++)
+   {
+      if (job->shiftY != 0 && y >= job->shiftH)
+         for (count = job->width; count != 0; count--)
+            *t++ = job->gray;
+      else
+         for (f = job->from + (y + job->shiftY) * job->width, count = job->width; count != 0; f++,count--)
+            #if defined(WIN32) && !defined(WP8)
+            SETPIXEL565_(t, f->pixel)
+            #else
+            *t++ = (Pixel565)SETPIXEL565(f->r, f->g, f->b);
+            #endif
+   }
+}
+#endif
+
 #ifndef SKIA_H
 // not used with opengl
 static bool updateScreenBits(Context currentContext) // copy the 888 pixels to the native format
@@ -2450,6 +2650,19 @@ static bool updateScreenBits(Context currentContext) // copy the 888 pixels to t
       {
          PixelConv *f = (PixelConv*)ARRAYOBJ_START(screen.mainWindowPixels);
          Pixel565 *t = (Pixel565*)screen.pixels;
+         if (useTiles(screenH * screenW))
+         {
+            TileClip tiles[TILE_MAX_COUNT];
+            ScreenTiles job;
+            job.from = f;
+            job.to = t;
+            job.width = screenW;
+            job.shiftY = shiftY;
+            job.shiftH = shiftH;
+            job.gray = grayp;
+            runTiles(updateScreenTile, &job, tiles, splitTiles(null, 0, 0, screenW, screenH, tiles));
+         }
+         else
          if (shiftY == 0)
             for (count = screenH * screenW; count != 0; f++,count--)
                #if defined(WIN32) && !defined(WP8)
@@ -2721,6 +2934,74 @@ static void drawFadedPixel(Context currentContext, TCObject g, int32 xx, int32 y
    }
 }
 
+static void getGradientOffsets(int32 i, int32 numSteps, int32 topLeftRadius, int32 topRightRadius, int32 bottomLeftRadius, int32 bottomRightRadius,
+   int32* pLeftOffset, int32* pRightOffset)
+{
+   int32 leftOffset = 0, rightOffset = 0;
+
+   if (topLeftRadius > 0 && i < topLeftRadius)
+      leftOffset = getOffset(topLeftRadius, topLeftRadius - i - 1) - 1;
+   else
+   if (bottomLeftRadius > 0 && i > numSteps - bottomLeftRadius)
+      leftOffset = getOffset(bottomLeftRadius, bottomLeftRadius - (numSteps - i + 1)) - 1;
+
+   if (topRightRadius > 0 && i < topRightRadius)
+      rightOffset = getOffset(topRightRadius, topRightRadius - i - 1) - 1;
+   else
+   if (bottomRightRadius > 0 && i > numSteps - bottomRightRadius)
+      rightOffset = getOffset(bottomRightRadius, bottomRightRadius - (numSteps - i + 1)) - 1;
+
+   *pLeftOffset = leftOffset < 0 ? 0 : leftOffset;
+   *pRightOffset = rightOffset < 0 ? 0 : rightOffset;
+}
+
+typedef struct
+{
+   int32 startX, startY, endX, numSteps;
+   int32 topLeftRadius, topRightRadius, bottomLeftRadius, bottomRightRadius;
+   int32 red, green, blue, redInc, greenInc, blueInc;
+   int32 transX, transY;
+   Pixel* pixels;
+   int32 pitch;
+} GradientTiles;
+
+// Same as drawFadedPixel, for a pixel of the row inside the tile
+static void fadeTilePixel(TileClip* tile, Pixel* row, int32 x, int32 c)
+{
+   if (tile->x1 <= x && x < tile->x2)
+   {
+      PixelConv c1,c2;
+      c1.pixel = c;
+      c2.pixel = row[x];
+      row[x] = interpolate(c1, c2, 20*255/100);
+   }
+}
+
+// Draws the rows of the vertical gradient that are inside the tile. The color of each row is computed from its index, which
+// gives the same values accumulated by drawRoundGradient
+static void drawRoundGradientTile(VoidP p, TileClip* tile, int32 worker)
+{
+   GradientTiles* job = (GradientTiles*)p;
+   int32 i = max32(0, tile->y1 - job->transY - job->startY), last = min32(job->numSteps, tile->y2 - job->transY - job->startY);
+   int32 leftOffset = 0, rightOffset = 0, x1, x2;
+   Pixel* row;
+   Pixel c;
+   for (; i < last; i++)
+   {
+      getGradientOffsets(i, job->numSteps, job->topLeftRadius, job->topRightRadius, job->bottomLeftRadius, job->bottomRightRadius,
+         &leftOffset, &rightOffset);
+      c = makePixel((job->red + i * job->redInc) >> 16, (job->green + i * job->greenInc) >> 16, (job->blue + i * job->blueInc) >> 16);
+      row = job->pixels + (job->startY + i + job->transY) * job->pitch;
+      x1 = job->startX + leftOffset + job->transX;
+      x2 = job->endX - rightOffset + job->transX;
+      fillTileSpan(tile, row, min32(x1, x2), abs32(x2 - x1) + 1, c); // same of drawLine
+      if (rightOffset != 0)
+         fadeTilePixel(tile, row, x2 + 1, c);
+      if (leftOffset != 0)
+         fadeTilePixel(tile, row, x1 - 1, c);
+   }
+}
+
 static void drawRoundGradient(Context currentContext, TCObject g, int32 startX, int32 startY, int32 endX, int32 endY, int32 topLeftRadius, int32 topRightRadius, int32 bottomLeftRadius, int32 bottomRightRadius, int32 startColor, int32 endColor, bool vertical)
 {
    int32 numSteps = max32(1, vertical ? abs32(endY - startY) : abs32(endX - startX)); // guich@tc110_11: support horizontal gradient - guich@gc114_41: prevent div by 0 if numsteps is 0
@@ -2763,27 +3044,39 @@ static void drawRoundGradient(Context currentContext, TCObject g, int32 startX,
       endY = temp;
    }
 
+   if (vertical && drawFadedPixels && useTiles((endX - startX + 1) * numSteps)) // the rows don't depend on each other
+   {
+      TileClip tiles[TILE_MAX_COUNT];
+      GradientTiles job;
+      int32 clipX = Graphics_clipX1(g) - Graphics_transX(g), clipW = Graphics_clipX2(g) - Graphics_clipX1(g);
+      int32 count = splitTiles(g, clipX, startY, clipW, numSteps, tiles); // all the columns of the clip, like drawLine
+      job.startX = startX;
+      job.startY = startY;
+      job.endX = endX;
+      job.numSteps = numSteps;
+      job.topLeftRadius = topLeftRadius;
+      job.topRightRadius = topRightRadius;
+      job.bottomLeftRadius = bottomLeftRadius;
+      job.bottomRightRadius = bottomRightRadius;
+      job.red = red;
+      job.green = green;
+      job.blue = blue;
+      job.redInc = redInc;
+      job.greenInc = greenInc;
+      job.blueInc = blueInc;
+      job.transX = Graphics_transX(g);
+      job.transY = Graphics_transY(g);
+      job.pixels = getGraphicsPixels(g);
+      job.pitch = Graphics_pitch(g);
+      runTiles(drawRoundGradientTile, &job, tiles, count);
+      markTilesDirty(currentContext, g, tiles, count);
+      return;
+   }
+
    for (i = 0; i < numSteps; i++)
    {
       if (hasRadius)
-      {
-         leftOffset = rightOffset = 0;
-
-         if (topLeftRadius > 0 && i < topLeftRadius)
-            leftOffset = getOffset(topLeftRadius, topLeftRadius - i - 1) - 1;
-         else
-         if (bottomLeftRadius > 0 && i > numSteps - bottomLeftRadius)
-            leftOffset = getOffset(bottomLeftRadius, bottomLeftRadius - (numSteps - i + 1)) - 1;
-
-         if (topRightRadius > 0 && i < topRightRadius)
-            rightOffset = getOffset(topRightRadius, topRightRadius - i - 1) - 1;
-         else
-         if (bottomRightRadius > 0 && i > numSteps - bottomRightRadius)
-            rightOffset = getOffset(bottomRightRadius, bottomRightRadius - (numSteps - i + 1)) - 1;
-
-         if (leftOffset < 0) leftOffset = 0;
-         if (rightOffset < 0) rightOffset = 0;
-      }
+         getGradientOffsets(i, numSteps, topLeftRadius, topRightRadius, bottomLeftRadius, bottomRightRadius, &leftOffset, &rightOffset);
       p = makePixel(red >> 16, green >> 16, blue >> 16);
       if (!optimize || leftOffset != 0 || rightOffset != 0)
       {
@@ -2997,6 +3290,7 @@ static void dither(Context currentContext, TCObject g, int32 x0, int32 y0, int32
 /////////////// Start of Device-dependant functions ///////////////
 static bool startupGraphics(int16 appTczAttr) // there are no threads running at this point
 {
+    initPixelKernels();
     return graphicsStartup(&screen, appTczAttr);
 }
 
@@ -3126,5 +3420,6 @@ void graphicsDestroyPrimitives()
    xfree(lookupB);
    xfree(lookupGray);
    fontDestroy();
+   destroyPoolWorkers();
 }
 /////////////// End of Device-dependant functions ///
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: LGPL-2.1-only
 
 #include <math.h>
+#include "PixelKernels.h"
 #if defined WP8
 #include "openglWrapper.h"
 #endif
@@ -48,12 +49,7 @@ static void applyColor(TCObject obj, Pixel color) // guich@tc112_24
    mg = (int32) (sqrt((c.g + k) / k) * 0x10000);
    mb = (int32) (sqrt((c.b + k) / k) * 0x10000);
 
-   for (; len-- > 0; pixels++)
-   {
-      pixels->r = min32(255,(mr * pixels->r) >> 16);
-      pixels->g = min32(255,(mg * pixels->g) >> 16);
-      pixels->b = min32(255,(mb * pixels->b) >> 16);
-   }
+   transformPixels(pixels, pixels, len, mr, mg, mb, 0);
    if (frameCount != 1)
    {
       Image_currentFrame(obj) = 2;
@@ -75,9 +71,8 @@ static bool getSmoothScaledInstance(TCObject thisObj, TCObject newObj) // guich@
    int32 newHeight = Image_height(newObj);
    TCObject pixelsObj = (frameCount == 1) ? Image_pixels(thisObj) : Image_pixelsOfAllFrames(thisObj);
    PixelConv *ib = (PixelConv*)ARRAYOBJ_START(pixelsObj);
-   PixelConv pval;                                                                                                                                   
 
-   int32 i=0, j, n, s, iweight,a,r,g,b;
+   int32 i=0, j, n, s, iweight;
    double xScale, yScale;
 
    // Temporary values
@@ -174,33 +169,11 @@ static bool getSmoothScaledInstance(TCObject thisObj, TCObject newObj) // guich@
    {
       int32 wsum = v_wsum[i];
       int32 count = v_count[i];
-      for (n = 0; n < height; n++)
-      {
-         p_weight = v_weight + i * maxContribs;
-         p_pixel  = v_pixel  + i * maxContribs;
-
-         a = r = g = b = 0;
-         for (j=0; j < count; j++)
-         {
-            int32 iweight = *p_weight++;
-            pval.pixel = ib[*p_pixel++ + n * width].pixel;
-            // Acting on color components
-            a += pval.a * iweight;
-            r += pval.r * iweight;
-            g += pval.g * iweight;
-            b += pval.b * iweight;
-         }
-         if (wsum == 0) continue;
-         a /= wsum; if (a > 255) a = 255; else if (a < 0) a = 0;
-         r /= wsum; if (r > 255) r = 255; else if (r < 0) r = 0;
-         g /= wsum; if (g > 255) g = 255; else if (g < 0) g = 0;
-         b /= wsum; if (b > 255) b = 255; else if (b < 0) b = 0;
-         pval.a = a;
-         pval.r = r;
-         pval.g = g;
-         pval.b = b;
-         tb[i+n*newWidth] = pval;
-      }
+      p_weight = v_weight + i * maxContribs;
+      p_pixel  = v_pixel  + i * maxContribs;
+      if (wsum != 0)
+         for (n = 0; n < height; n++)
+            tb[i+n*newWidth].pixel = resamplePixel(ib + n * width, 1, p_pixel, p_weight, count, wsum); // acting on color components
    }
 
    /* Going to vertical stuff */
@@ -261,32 +234,10 @@ static bool getSmoothScaledInstance(TCObject thisObj, TCObject newObj) // guich@
    {
       int32 wsum = v_wsum[i];
       int32 count = v_count[i];
+      p_weight = v_weight + i * maxContribs;
+      p_pixel  = v_pixel  + i * maxContribs;
       for (n = 0; n < newWidth; n++)
-      {
-         p_weight = v_weight + i * maxContribs;
-         p_pixel  = v_pixel  + i * maxContribs;
-
-         a = r = g = b = 0;
-         for (j = 0; j < count; j++)
-         {
-            int iweight = *p_weight++;
-            pval = tb[ n + newWidth * *p_pixel++]; // Using val as temporary storage 
-            // Acting on color components 
-            a += pval.a * iweight;
-            r += pval.r * iweight;
-            g += pval.g * iweight;
-            b += pval.b * iweight;
-         }
-         a /= wsum; if (a > 255) a = 255; else if (a < 0) a = 0;
-         r /= wsum; if (r > 255) r = 255; else if (r < 0) r = 0;
-         g /= wsum; if (g > 255) g = 255; else if (g < 0) g = 0;
-         b /= wsum; if (b > 255) b = 255; else if (b < 0) b = 0;
-         ob->a = a;
-         ob->r = r;
-         ob->g = g;
-         ob->b = b;
-         ob++;
-      }
+         (ob++)->pixel = resamplePixel(tb + n, newWidth, p_pixel, p_weight, count, wsum); // acting on color components
    }
 
    fSuccess = true;
@@ -504,13 +455,7 @@ static void getTouchedUpInstance(TCObject thisObj, TCObject newObj, int32 iBrigh
    switch (touchup)
    {
       case BRITE_TOUCHUP:
-         for (; len-- > 0; in++,out++)
-         {
-            out->a = in->a;
-            out->r = min32(255, (in->r * m + k) >> 16);
-            out->g = min32(255, (in->g * m + k) >> 16);
-            out->b = min32(255, (in->b * m + k) >> 16);
-         }
+         transformPixels(out, in, len, m, m, m, k);
          break;
       case CONTRAST_TOUCHUP:
          for (; len-- > 0; in++,out++)
@@ -522,21 +467,26 @@ static void getTouchedUpInstance(TCObject thisObj, TCObject newObj, int32 iBrigh
          }
          break;
       default: // case CTRSTBRITE_TOUCHUP:
-         for (; len-- > 0; in++,out++)
+      {
+         PixelConv* out0 = out;
+         int32 n = len;
+         for (; n-- > 0; in++,out++) // apply the contrast first, then the brightness over its results
          {
             out->a = in->a;
-            out->r = min32(255, (table[in->r] * m + k) >> 16);
-            out->g = min32(255, (table[in->g] * m + k) >> 16);
-            out->b = min32(255, (table[in->b] * m + k) >> 16);
+            out->r = table[in->r];
+            out->g = table[in->g];
+            out->b = table[in->b];
          }
+         transformPixels(out0, out0, len, m, m, m, k);
          break;
+      }
    }
 }
 
 static void getFadedInstance(TCObject thisObj, TCObject newObj, int32 backColor) // guich@tc110_50
 {
-   PixelConv *in, *out,back;
-   int32 len,r,g,b;
+   PixelConv *in, *out;
+   int32 len;
    int32 frameCount = Image_frameCount(thisObj);
    TCObject pixelsObj = frameCount == 1 ? Image_pixels(thisObj) : Image_pixelsOfAllFrames(thisObj);
 
@@ -544,23 +494,7 @@ static void getFadedInstance(TCObject thisObj, TCObject newObj, int32 backColor)
    out= (PixelConv*)ARRAYOBJ_START(Image_pixels(newObj));
    len = ARRAYOBJ_LEN(pixelsObj);
 
-   back.pixel = backColor;
-   r = back.r;
-   g = back.g;
-   b = back.b;
-   for (; len-- > 0; in++,out++)
-   {
-      out->a = in->a;
-      out->r = (in->r + (int32)r) >> 1;
-      out->g = (in->g + (int32)g) >> 1;
-      out->b = (in->b + (int32)b) >> 1;
-      {
-         out->a = in->a;
-         out->r = (in->r + (int32)r) >> 1;
-         out->g = (in->g + (int32)g) >> 1;
-         out->b = (in->b + (int32)b) >> 1;
-      }
-   }
+   fadePixels(out, in, len, (Pixel)backColor);
 }
 
 static void getAlphaInstance(TCObject thisObj, TCObject newObj, int32 delta) // guich@tc110_50
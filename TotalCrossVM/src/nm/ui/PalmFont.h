@@ -35,13 +35,6 @@ typedef struct
 typedef struct TUserFont TUserFont;
 typedef TUserFont* UserFont;
 
-typedef struct
-{
-   uint8* alpha;
-   uint16 size;
-   JChar ch;
-} *CharSizeCache, TCharSizeCache;
-
 struct TUserFont
 {
    uint8 *bitmapTable;
@@ -58,8 +51,6 @@ struct TUserFont
    int32 *charPixels; // for one char
    // gl fonts: used by the inherited font. fontP.maxHeight will contain the target size
    struct TUserFont* ubase;
-   // used only when drawing on images
-   VoidPs* charSizeCache[256];
    int32 tempbufssize;
    uint8* tempbufs;          
    bool isDefaultFont;
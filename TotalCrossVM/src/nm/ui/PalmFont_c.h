@@ -64,6 +64,9 @@ static void destroyUF(int32 i32, VoidP ptr)
    }   
 }
 
+static void destroyGlyphAtlas();
+static void clearWidthCache();
+
 void fontDestroy()
 {
    VoidPs *list, *head;
@@ -80,6 +83,8 @@ void fontDestroy()
       } while (list != head);
    }
    openFonts = null;
+   destroyGlyphAtlas();
+   clearWidthCache(); // the entries are keyed by the address of the fonts, which may be reused after a restart
    heapDestroy(fontsHeap);
    htFree(&htUF, null);
    htFree(&htBaseFonts, null);
@@ -175,7 +180,222 @@ FontFile loadFontFile(char *fontName)
 #define BIAS (1<<BIAS_BITS)
 
 typedef uint8 alpha_t;
-uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32 newWidth, int32 newHeight) // access directly the font bits and return an array of alpha only
+
+// The chars of the anti-aliased fonts drawn in a size other than the one in the font file are resized once and kept in a
+// single alpha atlas, which is split in shelves as high as the chars stored in them. When the atlas gets full, the shelf
+// used least recently is emptied and reused. The chars are found through a 4-way set associative table keyed by the user
+// font, the char and its size (these fonts have a single color mode: 8bpp alpha); each entry stores the generation of its
+// shelf, so the entries of an emptied shelf become invalid without being searched. The chars too high for a shelf are
+// kept apart, each one in its own buffer, and the one used least recently is replaced. The returned pixels are valid
+// only while the fonts lock is held.
+#define GLYPH_ATLAS_W 512
+#define GLYPH_ATLAS_H 512
+#define GLYPH_SHELVES 64
+#define GLYPH_SETS 256
+#define GLYPH_WAYS 4
+#define GLYPH_LARGE 8
+#define IS_LARGE_GLYPH(w,h) ((w) > GLYPH_ATLAS_W || (h) > GLYPH_ATLAS_H / 4)
+
+typedef struct
+{
+   UserFont uf;
+   JChar ch;
+   uint16 w, h, x;
+   int32 shelf;
+   uint32 generation; // 0: empty entry
+   uint32 lastUse;
+} TGlyphEntry;
+
+typedef struct
+{
+   uint16 y, h;
+   uint16 used; // width already taken by the chars
+   uint32 generation;
+   uint32 lastUse;
+} TGlyphShelf;
+
+typedef struct
+{
+   UserFont uf;
+   JChar ch;
+   uint16 w, h;
+   alpha_t* pixels;
+   int32 size;
+   uint32 lastUse; // 0: empty entry
+} TLargeGlyph;
+
+static alpha_t* glyphAtlas;
+static TLargeGlyph glyphLarge[GLYPH_LARGE];
+static TGlyphEntry glyphEntries[GLYPH_SETS][GLYPH_WAYS];
+static TGlyphShelf glyphShelves[GLYPH_SHELVES];
+static int32 glyphShelfCount, glyphAtlasUsedH;
+static uint32 glyphTick, glyphGeneration;
+static int32 glyphHits, glyphMisses, glyphEvictions;
+
+static TGlyphEntry* getGlyphSet(UserFont uf, JChar ch, int32 w, int32 h)
+{
+   uint32 hash = (uint32)(size_t)uf;
+   hash = (hash >> 4) ^ (hash >> 12) ^ (ch * 31) ^ (h * 131) ^ w;
+   return glyphEntries[(hash ^ (hash >> 8)) & (GLYPH_SETS-1)];
+}
+
+// returns the position of the given char in the atlas or in the large chars, or null if it is not there
+static alpha_t* findGlyph(UserFont uf, JChar ch, int32 w, int32 h, int32* pitch)
+{
+   TGlyphEntry* e;
+   TLargeGlyph* l;
+   int32 i;
+   if (IS_LARGE_GLYPH(w, h))
+   {
+      for (i = 0, l = glyphLarge; i < GLYPH_LARGE; i++, l++)
+         if (l->lastUse != 0 && l->uf == uf && l->ch == ch && l->w == w && l->h == h)
+         {
+            l->lastUse = ++glyphTick;
+            glyphHits++;
+            *pitch = w;
+            return l->pixels;
+         }
+      return null;
+   }
+   for (i = 0, e = getGlyphSet(uf, ch, w, h); i < GLYPH_WAYS; i++, e++)
+      if (e->generation != 0 && e->uf == uf && e->ch == ch && e->w == w && e->h == h)
+      {
+         TGlyphShelf* shelf = &glyphShelves[e->shelf];
+         if (e->shelf >= glyphShelfCount || shelf->generation != e->generation) // shelf was emptied
+         {
+            e->generation = 0;
+            break;
+         }
+         e->lastUse = shelf->lastUse = ++glyphTick;
+         glyphHits++;
+         *pitch = GLYPH_ATLAS_W;
+         return glyphAtlas + shelf->y * GLYPH_ATLAS_W + e->x;
+      }
+   return null;
+}
+
+// returns the shelf where a char with the given size can be stored, emptying one if needed
+static TGlyphShelf* getGlyphShelf(int32 w, int32 h)
+{
+   TGlyphShelf *shelf, *best = null;
+   int32 i;
+   for (i = 0, shelf = glyphShelves; i < glyphShelfCount; i++, shelf++) // the tightest shelf with room
+      if (shelf->h >= h && shelf->h <= h + h/4 && shelf->used + w <= GLYPH_ATLAS_W && (best == null || shelf->h < best->h))
+         best = shelf;
+   if (best == null && glyphShelfCount < GLYPH_SHELVES && glyphAtlasUsedH + h <= GLYPH_ATLAS_H) // a new shelf
+   {
+      best = &glyphShelves[glyphShelfCount++];
+      best->y = (uint16)glyphAtlasUsedH;
+      best->h = (uint16)h;
+      best->used = 0;
+      best->generation = ++glyphGeneration;
+      glyphAtlasUsedH += h;
+   }
+   if (best == null) // the least recently used shelf that is high enough
+   {
+      for (i = 0, shelf = glyphShelves; i < glyphShelfCount; i++, shelf++)
+         if (shelf->h >= h && (best == null || shelf->lastUse < best->lastUse))
+            best = shelf;
+      glyphEvictions++;
+      if (best == null) // all shelves are too low: start over
+      {
+         glyphShelfCount = glyphAtlasUsedH = 0;
+         return getGlyphShelf(w, h);
+      }
+      best->used = 0;
+      best->generation = ++glyphGeneration;
+   }
+   best->lastUse = ++glyphTick;
+   return best;
+}
+
+// returns the buffer where a char too high for the atlas must be resized to, replacing the least recently used one
+static alpha_t* addLargeGlyph(UserFont uf, JChar ch, int32 w, int32 h, int32* pitch)
+{
+   TLargeGlyph *l, *victim = glyphLarge;
+   int32 i;
+   for (i = 0, l = glyphLarge; i < GLYPH_LARGE; i++, l++)
+   {
+      if (l->lastUse == 0)
+      {
+         victim = l;
+         break;
+      }
+      if (l->lastUse < victim->lastUse)
+         victim = l;
+   }
+   if (victim->lastUse != 0)
+      glyphEvictions++;
+   victim->lastUse = 0; // the entry is only valid after the char is resized to its buffer
+   if (victim->size < w * h)
+   {
+      xfree(victim->pixels);
+      victim->size = 0;
+      if ((victim->pixels = (alpha_t*)xmalloc(w * h)) == null)
+         return null;
+      victim->size = w * h;
+   }
+   victim->uf = uf;
+   victim->ch = ch;
+   victim->w = (uint16)w;
+   victim->h = (uint16)h;
+   victim->lastUse = ++glyphTick;
+   *pitch = w;
+   return victim->pixels;
+}
+
+// returns where the given char must be resized to, adding it to the atlas if it fits there
+static alpha_t* addGlyph(UserFont uf, JChar ch, int32 w, int32 h, int32* pitch)
+{
+   TGlyphEntry *e, *victim;
+   TGlyphShelf* shelf;
+   int32 i;
+
+   glyphMisses++;
+   if (IS_LARGE_GLYPH(w, h))
+      return addLargeGlyph(uf, ch, w, h, pitch);
+   if (glyphAtlas == null && (glyphAtlas = (alpha_t*)xmalloc(GLYPH_ATLAS_W * GLYPH_ATLAS_H)) == null)
+      return null;
+
+   shelf = getGlyphShelf(w, h);
+   victim = e = getGlyphSet(uf, ch, w, h);
+   for (i = 0; i < GLYPH_WAYS; i++, e++)
+   {
+      if (e->generation == 0 || e->shelf >= glyphShelfCount || glyphShelves[e->shelf].generation != e->generation)
+      {
+         victim = e;
+         break;
+      }
+      if (e->lastUse < victim->lastUse)
+         victim = e;
+   }
+   victim->uf = uf;
+   victim->ch = ch;
+   victim->w = (uint16)w;
+   victim->h = (uint16)h;
+   victim->x = shelf->used;
+   victim->shelf = (int32)(shelf - glyphShelves);
+   victim->generation = shelf->generation;
+   victim->lastUse = glyphTick;
+   shelf->used += w;
+   *pitch = GLYPH_ATLAS_W;
+   return glyphAtlas + shelf->y * GLYPH_ATLAS_W + victim->x;
+}
+
+static void destroyGlyphAtlas()
+{
+   int32 i;
+   xfree(glyphAtlas);
+   for (i = 0; i < GLYPH_LARGE; i++)
+      xfree(glyphLarge[i].pixels);
+   glyphShelfCount = glyphAtlasUsedH = 0;
+   xmemzero(glyphEntries, sizeof(glyphEntries));
+   xmemzero(glyphLarge, sizeof(glyphLarge));
+}
+
+// access directly the font bits and return an array of alpha only. The caller must hold the fonts lock while using it,
+// since another thread may replace the char by another one
+uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32 newWidth, int32 newHeight, int32* pitch)
 {
    bool fSuccess = false;
    // font bits
@@ -206,33 +426,18 @@ uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32
    int32 maxContribs, maxContribsXY;   // Almost-const: max number of contribution for current sampling
    double scaledRadius, scaledRadiusY;   // Almost-const: scaled radius for downsampling operations
    double filterFactor;   // Almost-const: filter factor for downsampling operations
-   CharSizeCache csc;
-   VoidPs *csclist, *csclist0;
 
    LOCKVAR(fonts);
-   IF_HEAP_ERROR(fontsHeap)
+   // check if its in the atlas
+   if ((ob0 = findGlyph(uf, ch, newWidth, newHeight, pitch)) != null)
    {
-      goto Cleanup;
+      UNLOCKVAR(fonts);
+      return ob0;
    }
 
-   // check if its in the cache
-   csclist0 = csclist = uf->charSizeCache[ch & 0xFF];
-   if (csclist != null)
-   do
-   {
-      CharSizeCache csc = (CharSizeCache)csclist->value;
-      if (csc->ch == ch && csc->size == newHeight)
-      {
-         UNLOCKVAR(fonts);
-         return csc->alpha;
-      }
-      csclist = csclist->next;
-   } while (csclist != csclist0);
-
    xScale = ((double)newWidth / width);
    yScale = ((double)newHeight / height);
 
-   ob0 = ob = (alpha_t*)heapAlloc(fontsHeap, newWidth * newHeight);
    ib = (alpha_t*)&uf->bitmapTable[offset];
 
    if (newWidth > width)
@@ -273,6 +478,8 @@ uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32
    v_pixel = (int32 *)tempbuf; tempbuf += s * maxContribsXY * sizeof(int32); /* the contributing pixels */
    v_count = (int32 *)tempbuf; tempbuf += s * sizeof(int32); /* how many contributions for the target pixel */
    v_wsum = (int32 *)tempbuf; tempbuf += s * sizeof(int32); /* sum of the weights for the target pixel */
+   if ((ob0 = addGlyph(uf, ch, newWidth, newHeight, pitch)) == null)
+      goto Cleanup;
 
    /* Pre-calculate weights contribution for a row */
    for (i = 0; i < newWidth; i++)
@@ -389,6 +596,7 @@ uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32
    {
       int32 wsum = v_wsum[i];
       int32 count = v_count[i];
+      ob = ob0 + i * *pitch;
       for (n = 0; n < newWidth; n++)
       {
          p_weight = v_weight + i * maxContribs;
@@ -402,19 +610,12 @@ uint8* getResizedCharPixels(Context currentContext, UserFont uf, JChar ch, int32
             // Acting on color components
             a += (int32)pval * iweight;
          }
-         if (wsum == 0) continue;
-         a /= wsum;
+         if (wsum == 0) a = 0; else a /= wsum; // the atlas is reused, so all pixels must be written
          if (a > 255) a = 255; else if (a < 0) a = 0;
          *ob++ = a;
       }
    }
 
-   // add to the cache
-   csc = newXH(CharSizeCache, fontsHeap);
-   csc->ch = ch;
-   csc->size = newHeight;
-   csc->alpha = ob0;
-   uf->charSizeCache[ch & 0xFF] = VoidPsAdd(csclist0, csc, fontsHeap);
    fSuccess = true;
 
 Cleanup: /* CLEANUP */
@@ -715,6 +916,65 @@ UserFont loadUserFontFromFontObj(Context currentContext, TCObject fontObj, JChar
    }
 }
 
+// Widths of the strings measured recently, so the ones measured repeatedly (like the ones in lists) become lookups. The
+// entries are found by a hash of the font and the string, but are only used if the string is the same
+#define WIDTH_CACHE_SIZE 256
+#define WIDTH_CACHE_MAX_LEN 32
+
+typedef struct
+{
+   VoidP font;
+   int32 key;
+   int32 len; // 0: empty entry
+   int32 width;
+   JChar chars[WIDTH_CACHE_MAX_LEN];
+} TWidthEntry;
+
+static TWidthEntry widthCache[WIDTH_CACHE_SIZE];
+
+static void clearWidthCache()
+{
+   xmemzero(widthCache, sizeof(widthCache));
+}
+
+static TWidthEntry* getWidthEntry(VoidP font, int32 key, JCharP s, int32 len)
+{
+   uint32 hash = (uint32)(size_t)font ^ (key * 31) ^ len;
+   while (len-- > 0)
+      hash = hash * 31 + *s++;
+   return &widthCache[(hash ^ (hash >> 16)) & (WIDTH_CACHE_SIZE-1)];
+}
+
+static bool getCachedStringWidth(VoidP font, int32 key, JCharP s, int32 len, int32* width)
+{
+   TWidthEntry* e;
+   bool found;
+   if (len < 2 || len > WIDTH_CACHE_MAX_LEN) // single chars are already a lookup
+      return false;
+   LOCKVAR(fonts);
+   e = getWidthEntry(font, key, s, len);
+   found = e->len == len && e->font == font && e->key == key && xmemcmp(e->chars, s, len * sizeof(JChar)) == 0;
+   if (found)
+      *width = e->width;
+   UNLOCKVAR(fonts);
+   return found;
+}
+
+static void putCachedStringWidth(VoidP font, int32 key, JCharP s, int32 len, int32 width)
+{
+   TWidthEntry* e;
+   if (len < 2 || len > WIDTH_CACHE_MAX_LEN)
+      return;
+   LOCKVAR(fonts);
+   e = getWidthEntry(font, key, s, len);
+   e->font = font;
+   e->key = key;
+   e->len = len;
+   e->width = width;
+   xmemmove(e->chars, s, len * sizeof(JChar));
+   UNLOCKVAR(fonts);
+}
+
 #if defined ANDROID || defined darwin || defined HEADLESS
 #include "android/skia.h"
 
@@ -725,7 +985,15 @@ int32 getJCharWidth(Context currentContext, TCObject fontObj, JChar ch) {
 
 int32 getJCharPWidth(Context currentContext, TCObject fontObj, JCharP s, int32 len) {
    int32 fontSize = (int)(Font_size(fontObj) * (*tcSettings.screenDensityPtr));
-    return len == 0? 0: skia_stringWidth(s, len * sizeof(JChar), Font_skiaIndex(fontObj), fontSize);
+   int32 typefaceIndex = Font_skiaIndex(fontObj), width;
+   if (len == 0)
+      return 0;
+   if (!getCachedStringWidth((VoidP)(size_t)(typefaceIndex + 1), fontSize, s, len, &width))
+   {
+      width = skia_stringWidth(s, len * sizeof(JChar), typefaceIndex, fontSize);
+      putCachedStringWidth((VoidP)(size_t)(typefaceIndex + 1), fontSize, s, len, width);
+   }
+   return width;
 }
 #else
 int32 getJCharWidth(Context currentContext, TCObject fontObj, JChar ch)
@@ -750,9 +1018,14 @@ int32 getJCharWidth(Context currentContext, TCObject fontObj, JChar ch)
 
 int32 getJCharPWidth(Context currentContext, TCObject fontObj, JCharP s, int32 len)
 {
-   int sum = 0;
-   while (len-- > 0)
-      sum += getJCharWidth(currentContext, fontObj, *s++);
+   int32 sum = 0, n;
+   UserFont uf = loadUserFontFromFontObj(currentContext, fontObj, ' '); // the user font of the other chars depend on it
+   if (uf != null && getCachedStringWidth(uf, *tabSizeField, s, len, &sum))
+      return sum;
+   for (n = 0; n < len; n++)
+      sum += getJCharWidth(currentContext, fontObj, s[n]);
+   if (uf != null)
+      putCachedStringWidth(uf, *tabSizeField, s, len, sum);
    return sum;
 }
 #endif
@@ -0,0 +1,471 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#include "tcvm.h"
+#include "PixelKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define PK_SSE2
+ #include <emmintrin.h>
+ #if (defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__))) || (defined(_MSC_VER) && _MSC_VER >= 1700)
+  #define PK_AVX2
+  #include <immintrin.h>
+  #ifdef _MSC_VER
+   #include <intrin.h>
+   #define PK_AVX2_FUNC
+  #else
+   #define PK_AVX2_FUNC __attribute__((target("avx2")))
+  #endif
+ #endif
+#elif defined(ENABLE_NEON_KERNELS) && (defined(__ARM_NEON) || defined(__ARM_NEON__)) // not yet tested on devices: ARM uses the C kernels by default
+ #define PK_NEON
+ #include <arm_neon.h>
+#endif
+
+FillPixelsFunc fillPixels = fillPixelsC;
+BlendPixelsFunc blendPixels = blendPixelsC;
+CopyOpaquePixelsFunc copyOpaquePixels = copyOpaquePixelsC;
+FadePixelsFunc fadePixels = fadePixelsC;
+TransformPixelsFunc transformPixels = transformPixelsC;
+ResamplePixelFunc resamplePixel = resamplePixelC;
+static CharP kernelsName = "C";
+
+//////////////////////////////////////////////////////////////////////////
+// Scalar reference kernels. The vectorized ones must give exactly the same results
+
+void fillPixelsC(Pixel* dst, Pixel pixel, int32 count)
+{
+   for (; count > 0; count--)
+      *dst++ = pixel;
+}
+
+void blendPixelsC(PixelConv* dst, PixelConv* src, int32 count, int32 alphaMask)
+{
+   for (; count > 0; dst++, src++, count--)
+   {
+      int32 a = src->a * alphaMask;
+      a = (a+1 + (a >> 8)) >> 8; // alphaMask * a / 255
+      if (a == 0xFF)
+         dst->pixel = src->pixel;
+      else
+      if (a != 0)
+      {
+         int32 ma = 0xFF-a;
+         int32 r = (a * src->r + ma * dst->r);
+         int32 g = (a * src->g + ma * dst->g);
+         int32 b = (a * src->b + ma * dst->b);
+         dst->r = (r+1 + (r >> 8)) >> 8; // fast way to divide by 255
+         dst->g = (g+1 + (g >> 8)) >> 8;
+         dst->b = (b+1 + (b >> 8)) >> 8;
+      }
+   }
+}
+
+void copyOpaquePixelsC(PixelConv* dst, PixelConv* src, int32 count)
+{
+   for (; count > 0; dst++, src++, count--)
+   {
+      dst->pixel = src->pixel;
+      dst->a = 0xFF;
+   }
+}
+
+void fadePixelsC(PixelConv* dst, PixelConv* src, int32 count, Pixel back)
+{
+   PixelConv b;
+   b.pixel = back;
+   for (; count > 0; dst++, src++, count--)
+   {
+      dst->a = src->a;
+      dst->r = (src->r + (int32)b.r) >> 1;
+      dst->g = (src->g + (int32)b.g) >> 1;
+      dst->b = (src->b + (int32)b.b) >> 1;
+   }
+}
+
+void transformPixelsC(PixelConv* dst, PixelConv* src, int32 count, int32 mr, int32 mg, int32 mb, int32 k)
+{
+   for (; count > 0; dst++, src++, count--)
+   {
+      dst->a = src->a;
+      dst->r = min32(255, (src->r * mr + k) >> 16);
+      dst->g = min32(255, (src->g * mg + k) >> 16);
+      dst->b = min32(255, (src->b * mb + k) >> 16);
+   }
+}
+
+Pixel resamplePixelC(PixelConv* base, int32 stride, int32* pixels, int32* weights, int32 count, int32 wsum)
+{
+   PixelConv p, out;
+   int32 a = 0, r = 0, g = 0, b = 0;
+   for (; count > 0; count--)
+   {
+      int32 w = *weights++;
+      p.pixel = base[*pixels++ * stride].pixel;
+      a += p.a * w;
+      r += p.r * w;
+      g += p.g * w;
+      b += p.b * w;
+   }
+   a /= wsum; if (a > 255) a = 255; else if (a < 0) a = 0;
+   r /= wsum; if (r > 255) r = 255; else if (r < 0) r = 0;
+   g /= wsum; if (g > 255) g = 255; else if (g < 0) g = 0;
+   b /= wsum; if (b > 255) b = 255; else if (b < 0) b = 0;
+   out.a = a;
+   out.r = r;
+   out.g = g;
+   out.b = b;
+   return out.pixel;
+}
+
+#if defined(PK_SSE2) || defined(PK_NEON)
+// divides the sums of the resampled components, each one in the position of its byte in the pixel, as resamplePixelC does
+static Pixel divideSums(int32* sums, int32 wsum)
+{
+   Pixel out;
+   uint8* o = (uint8*)&out;
+   int32 i;
+   for (i = 0; i < 4; i++)
+   {
+      int32 c = sums[i] / wsum;
+      o[i] = (uint8)(c > 255 ? 255 : c < 0 ? 0 : c);
+   }
+   return out;
+}
+#endif
+
+#ifdef PK_SSE2
+//////////////////////////////////////////////////////////////////////////
+// SSE2: 4 pixels per iteration, each one unpacked to four 16-bit lanes in the a,b,g,r memory order
+
+static void fillPixelsSSE2(Pixel* dst, Pixel pixel, int32 count)
+{
+   __m128i p = _mm_set1_epi32((int)pixel);
+   for (; count >= 4; dst += 4, count -= 4)
+      _mm_storeu_si128((__m128i*)dst, p);
+   fillPixelsC(dst, pixel, count);
+}
+
+// blends 8 unpacked pixels; the 16-bit products never overflow because a * s + (255 - a) * d <= 255 * 255
+#define BLEND_LANES(s, d, mask, alphaLanes, v255, one, out) \
+   { \
+      __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0), 0); \
+      __m128i r, opaque; \
+      a = _mm_mullo_epi16(a, mask); \
+      a = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(a, one), _mm_srli_epi16(a, 8)), 8); \
+      r = _mm_add_epi16(_mm_mullo_epi16(a, s), _mm_mullo_epi16(_mm_sub_epi16(v255, a), d)); \
+      r = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(r, one), _mm_srli_epi16(r, 8)), 8); \
+      opaque = _mm_and_si128(_mm_cmpeq_epi16(a, v255), v255); \
+      out = _mm_or_si128(_mm_andnot_si128(alphaLanes, r), _mm_and_si128(alphaLanes, _mm_or_si128(d, opaque))); \
+   }
+
+static void blendPixelsSSE2(PixelConv* dst, PixelConv* src, int32 count, int32 alphaMask)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i mask = _mm_set1_epi16((short)alphaMask);
+   __m128i v255 = _mm_set1_epi16(0xFF);
+   __m128i one = _mm_set1_epi16(1);
+   __m128i alphaLanes = _mm_set_epi16(0,0,0,-1,0,0,0,-1);
+   for (; count >= 4; dst += 4, src += 4, count -= 4)
+   {
+      __m128i s = _mm_loadu_si128((__m128i*)src);
+      __m128i d = _mm_loadu_si128((__m128i*)dst);
+      __m128i lo, hi;
+      BLEND_LANES(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), mask, alphaLanes, v255, one, lo);
+      BLEND_LANES(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), mask, alphaLanes, v255, one, hi);
+      _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+   }
+   blendPixelsC(dst, src, count, alphaMask);
+}
+
+static void copyOpaquePixelsSSE2(PixelConv* dst, PixelConv* src, int32 count)
+{
+   __m128i alpha = _mm_set1_epi32(0xFF); // the alpha is the first byte of each pixel
+   for (; count >= 4; dst += 4, src += 4, count -= 4)
+      _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_loadu_si128((__m128i*)src), alpha));
+   copyOpaquePixelsC(dst, src, count);
+}
+
+static void fadePixelsSSE2(PixelConv* dst, PixelConv* src, int32 count, Pixel back)
+{
+   __m128i b = _mm_set1_epi32((int)back);
+   __m128i alphaBytes = _mm_set1_epi32(0xFF);
+   __m128i low7 = _mm_set1_epi8(0x7F);
+   for (; count >= 4; dst += 4, src += 4, count -= 4)
+   {
+      __m128i s = _mm_loadu_si128((__m128i*)src);
+      // (s + b) >> 1 without carrying out of each byte: (s & b) + ((s ^ b) >> 1)
+      __m128i avg = _mm_add_epi8(_mm_and_si128(s, b), _mm_and_si128(_mm_srli_epi16(_mm_xor_si128(s, b), 1), low7));
+      _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_andnot_si128(alphaBytes, avg), _mm_and_si128(alphaBytes, s)));
+   }
+   fadePixelsC(dst, src, count, back);
+}
+
+// (c * m + k) >> 16 = c * mh + kh + ((c * ml + kl) >> 16), being m = mh:ml and k = kh:kl. mh is 0 or 1
+#define TRANSFORM_LANES(c, ml, mh, kl, kh, sign, out) \
+   { \
+      __m128i prod = _mm_mullo_epi16(c, ml); \
+      __m128i sum = _mm_add_epi16(prod, kl); \
+      __m128i carry = _mm_cmpgt_epi16(_mm_xor_si128(prod, sign), _mm_xor_si128(sum, sign)); \
+      out = _mm_add_epi16(_mm_add_epi16(_mm_mulhi_epu16(c, ml), kh), _mm_mullo_epi16(c, mh)); \
+      out = _mm_sub_epi16(out, carry); \
+   }
+
+static void transformPixelsSSE2(PixelConv* dst, PixelConv* src, int32 count, int32 mr, int32 mg, int32 mb, int32 k)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i sign = _mm_set1_epi16((short)0x8000);
+   short hr = (short)(mr >> 16), hg = (short)(mg >> 16), hb = (short)(mb >> 16), lk = (short)k, hk = (short)(k >> 16);
+   __m128i ml = _mm_set_epi16((short)mr, (short)mg, (short)mb, 0, (short)mr, (short)mg, (short)mb, 0);
+   __m128i mh = _mm_set_epi16(hr, hg, hb, 1, hr, hg, hb, 1);
+   __m128i kl = _mm_set_epi16(lk, lk, lk, 0, lk, lk, lk, 0);
+   __m128i kh = _mm_set_epi16(hk, hk, hk, 0, hk, hk, hk, 0);
+   for (; count >= 4; dst += 4, src += 4, count -= 4)
+   {
+      __m128i s = _mm_loadu_si128((__m128i*)src);
+      __m128i lo, hi, cl = _mm_unpacklo_epi8(s, zero), ch = _mm_unpackhi_epi8(s, zero);
+      TRANSFORM_LANES(cl, ml, mh, kl, kh, sign, lo);
+      TRANSFORM_LANES(ch, ml, mh, kl, kh, sign, hi);
+      _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi)); // packus does the min(255, x)
+   }
+   transformPixelsC(dst, src, count, mr, mg, mb, k);
+}
+
+// two pixels per iteration, with their components interleaved in 16-bit lanes, so madd multiplies and adds both. The
+// weights don't fit in 16 bits, so w * c = (w >> 15) * c << 15 + (w & 0x7FFF) * c, which gives the same sums (even when
+// they overflow) of the scalar version
+static Pixel resamplePixelSSE2(PixelConv* base, int32 stride, int32* pixels, int32* weights, int32 count, int32 wsum)
+{
+   __m128i zero = _mm_setzero_si128();
+   __m128i sumLow = zero, sumHigh = zero;
+   int32 sums[4];
+   for (; count > 0; pixels += 2, weights += 2, count -= 2)
+   {
+      int32 w0 = weights[0], w1 = count > 1 ? weights[1] : 0;
+      Pixel p0 = base[pixels[0] * stride].pixel, p1 = count > 1 ? base[pixels[1] * stride].pixel : 0;
+      __m128i c = _mm_unpacklo_epi8(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)p0), _mm_cvtsi32_si128((int)p1)), zero);
+      sumLow = _mm_add_epi32(sumLow, _mm_madd_epi16(c, _mm_set1_epi32(((w1 & 0x7FFF) << 16) | (w0 & 0x7FFF))));
+      sumHigh = _mm_add_epi32(sumHigh, _mm_madd_epi16(c, _mm_set1_epi32((int)(((uint32)(w1 >> 15) << 16) | ((uint32)(w0 >> 15) & 0xFFFF)))));
+   }
+   _mm_storeu_si128((__m128i*)sums, _mm_add_epi32(sumLow, _mm_slli_epi32(sumHigh, 15)));
+   return divideSums(sums, wsum);
+}
+#endif
+
+#ifdef PK_AVX2
+//////////////////////////////////////////////////////////////////////////
+// AVX2: the same as SSE2, but with 8 pixels per iteration. Unpacking and packing are done inside each 128-bit half, so the
+// pixel order is kept
+
+static PK_AVX2_FUNC void blendPixelsAVX2(PixelConv* dst, PixelConv* src, int32 count, int32 alphaMask)
+{
+   __m256i zero = _mm256_setzero_si256();
+   __m256i mask = _mm256_set1_epi16((short)alphaMask);
+   __m256i v255 = _mm256_set1_epi16(0xFF);
+   __m256i one = _mm256_set1_epi16(1);
+   __m256i alphaLanes = _mm256_set1_epi64x(0xFFFF);
+   for (; count >= 8; dst += 8, src += 8, count -= 8)
+   {
+      __m256i s = _mm256_loadu_si256((__m256i*)src);
+      __m256i d = _mm256_loadu_si256((__m256i*)dst);
+      __m256i out[2], sl[2], dl[2];
+      int32 i;
+      sl[0] = _mm256_unpacklo_epi8(s, zero); dl[0] = _mm256_unpacklo_epi8(d, zero);
+      sl[1] = _mm256_unpackhi_epi8(s, zero); dl[1] = _mm256_unpackhi_epi8(d, zero);
+      for (i = 0; i < 2; i++)
+      {
+         __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sl[i], 0), 0);
+         __m256i r, opaque;
+         a = _mm256_mullo_epi16(a, mask);
+         a = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(a, one), _mm256_srli_epi16(a, 8)), 8);
+         r = _mm256_add_epi16(_mm256_mullo_epi16(a, sl[i]), _mm256_mullo_epi16(_mm256_sub_epi16(v255, a), dl[i]));
+         r = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(r, one), _mm256_srli_epi16(r, 8)), 8);
+         opaque = _mm256_and_si256(_mm256_cmpeq_epi16(a, v255), v255);
+         out[i] = _mm256_blendv_epi8(r, _mm256_or_si256(dl[i], opaque), alphaLanes);
+      }
+      _mm256_storeu_si256((__m256i*)dst, _mm256_packus_epi16(out[0], out[1]));
+   }
+   blendPixelsSSE2(dst, src, count, alphaMask);
+}
+
+static PK_AVX2_FUNC void transformPixelsAVX2(PixelConv* dst, PixelConv* src, int32 count, int32 mr, int32 mg, int32 mb, int32 k)
+{
+   __m256i zero = _mm256_setzero_si256();
+   __m256i sign = _mm256_set1_epi16((short)0x8000);
+   __m256i ml = _mm256_set1_epi64x(((int64)(mr & 0xFFFF) << 48) | ((int64)(mg & 0xFFFF) << 32) | ((int64)(mb & 0xFFFF) << 16));
+   __m256i mh = _mm256_set1_epi64x(((int64)(mr >> 16) << 48) | ((int64)(mg >> 16) << 32) | ((int64)(mb >> 16) << 16) | 1);
+   __m256i kl = _mm256_set1_epi64x(((int64)(k & 0xFFFF) << 48) | ((int64)(k & 0xFFFF) << 32) | ((int64)(k & 0xFFFF) << 16));
+   __m256i kh = _mm256_set1_epi64x(((int64)(k >> 16) << 48) | ((int64)(k >> 16) << 32) | ((int64)(k >> 16) << 16));
+   for (; count >= 8; dst += 8, src += 8, count -= 8)
+   {
+      __m256i s = _mm256_loadu_si256((__m256i*)src);
+      __m256i c[2], out[2];
+      int32 i;
+      c[0] = _mm256_unpacklo_epi8(s, zero);
+      c[1] = _mm256_unpackhi_epi8(s, zero);
+      for (i = 0; i < 2; i++)
+      {
+         __m256i prod = _mm256_mullo_epi16(c[i], ml);
+         __m256i sum = _mm256_add_epi16(prod, kl);
+         __m256i carry = _mm256_cmpgt_epi16(_mm256_xor_si256(prod, sign), _mm256_xor_si256(sum, sign));
+         out[i] = _mm256_add_epi16(_mm256_add_epi16(_mm256_mulhi_epu16(c[i], ml), kh), _mm256_mullo_epi16(c[i], mh));
+         out[i] = _mm256_sub_epi16(out[i], carry);
+      }
+      _mm256_storeu_si256((__m256i*)dst, _mm256_packus_epi16(out[0], out[1]));
+   }
+   transformPixelsSSE2(dst, src, count, mr, mg, mb, k);
+}
+
+static bool cpuHasAVX2()
+{
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 0);
+   if (info[0] < 7)
+      return false;
+   __cpuid(info, 1);
+   if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) // the os must save the ymm registers
+      return false;
+   __cpuidex(info, 7, 0);
+   return (info[1] & (1 << 5)) != 0;
+#else
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+#ifdef PK_NEON
+//////////////////////////////////////////////////////////////////////////
+// NEON: 8 pixels per iteration, deinterleaved by vld4 in one vector per channel: val[0] is a, val[1] is b, val[2] is g
+// and val[3] is r
+
+static void fillPixelsNEON(Pixel* dst, Pixel pixel, int32 count)
+{
+   uint32x4_t p = vdupq_n_u32(pixel);
+   for (; count >= 4; dst += 4, count -= 4)
+      vst1q_u32(dst, p);
+   fillPixelsC(dst, pixel, count);
+}
+
+static void blendPixelsNEON(PixelConv* dst, PixelConv* src, int32 count, int32 alphaMask)
+{
+   uint8x8_t mask = vdup_n_u8((uint8)alphaMask);
+   uint8x8_t v255 = vdup_n_u8(0xFF);
+   uint16x8_t one = vdupq_n_u16(1);
+   for (; count >= 8; dst += 8, src += 8, count -= 8)
+   {
+      uint8x8x4_t s = vld4_u8((uint8*)src);
+      uint8x8x4_t d = vld4_u8((uint8*)dst);
+      uint16x8_t a16 = vmull_u8(s.val[0], mask);
+      uint8x8_t a, ma;
+      int32 i;
+      a = vshrn_n_u16(vaddq_u16(vaddq_u16(a16, one), vshrq_n_u16(a16, 8)), 8);
+      ma = vsub_u8(v255, a);
+      for (i = 1; i < 4; i++)
+      {
+         uint16x8_t r = vmlal_u8(vmull_u8(a, s.val[i]), ma, d.val[i]);
+         d.val[i] = vshrn_n_u16(vaddq_u16(vaddq_u16(r, one), vshrq_n_u16(r, 8)), 8);
+      }
+      d.val[0] = vorr_u8(d.val[0], vceq_u8(a, v255));
+      vst4_u8((uint8*)dst, d);
+   }
+   blendPixelsC(dst, src, count, alphaMask);
+}
+
+static void copyOpaquePixelsNEON(PixelConv* dst, PixelConv* src, int32 count)
+{
+   uint32x4_t alpha = vdupq_n_u32(0xFF); // the alpha is the first byte of each pixel
+   for (; count >= 4; dst += 4, src += 4, count -= 4)
+      vst1q_u32((uint32*)dst, vorrq_u32(vld1q_u32((uint32*)src), alpha));
+   copyOpaquePixelsC(dst, src, count);
+}
+
+static void fadePixelsNEON(PixelConv* dst, PixelConv* src, int32 count, Pixel back)
+{
+   PixelConv b;
+   uint8x8_t br, bg, bb;
+   b.pixel = back;
+   br = vdup_n_u8(b.r); bg = vdup_n_u8(b.g); bb = vdup_n_u8(b.b);
+   for (; count >= 8; dst += 8, src += 8, count -= 8)
+   {
+      uint8x8x4_t s = vld4_u8((uint8*)src);
+      s.val[1] = vhadd_u8(s.val[1], bb);
+      s.val[2] = vhadd_u8(s.val[2], bg);
+      s.val[3] = vhadd_u8(s.val[3], br);
+      vst4_u8((uint8*)dst, s);
+   }
+   fadePixelsC(dst, src, count, back);
+}
+
+static uint8x8_t transformChannelNEON(uint8x8_t c, uint32 m, uint32x4_t k)
+{
+   uint16x8_t c16 = vmovl_u8(c);
+   uint32x4_t lo = vshrq_n_u32(vmlaq_n_u32(k, vmovl_u16(vget_low_u16(c16)), m), 16);
+   uint32x4_t hi = vshrq_n_u32(vmlaq_n_u32(k, vmovl_u16(vget_high_u16(c16)), m), 16);
+   return vqmovn_u16(vcombine_u16(vqmovn_u32(lo), vqmovn_u32(hi)));
+}
+
+static void transformPixelsNEON(PixelConv* dst, PixelConv* src, int32 count, int32 mr, int32 mg, int32 mb, int32 k)
+{
+   uint32x4_t kv = vdupq_n_u32((uint32)k);
+   for (; count >= 8; dst += 8, src += 8, count -= 8)
+   {
+      uint8x8x4_t s = vld4_u8((uint8*)src);
+      s.val[1] = transformChannelNEON(s.val[1], (uint32)mb, kv);
+      s.val[2] = transformChannelNEON(s.val[2], (uint32)mg, kv);
+      s.val[3] = transformChannelNEON(s.val[3], (uint32)mr, kv);
+      vst4_u8((uint8*)dst, s);
+   }
+   transformPixelsC(dst, src, count, mr, mg, mb, k);
+}
+
+static Pixel resamplePixelNEON(PixelConv* base, int32 stride, int32* pixels, int32* weights, int32 count, int32 wsum)
+{
+   int32x4_t sum = vdupq_n_s32(0);
+   int32 sums[4];
+   for (; count > 0; count--)
+   {
+      uint8x8_t p = vreinterpret_u8_u32(vdup_n_u32(base[*pixels++ * stride].pixel));
+      sum = vmlaq_n_s32(sum, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(p)))), *weights++);
+   }
+   vst1q_s32(sums, sum);
+   return divideSums(sums, wsum);
+}
+#endif
+
+void initPixelKernels()
+{
+#if defined(PK_SSE2)
+   fillPixels = fillPixelsSSE2;
+   blendPixels = blendPixelsSSE2;
+   copyOpaquePixels = copyOpaquePixelsSSE2;
+   fadePixels = fadePixelsSSE2;
+   transformPixels = transformPixelsSSE2;
+   resamplePixel = resamplePixelSSE2;
+   kernelsName = "SSE2";
+ #ifdef PK_AVX2
+   if (cpuHasAVX2())
+   {
+      blendPixels = blendPixelsAVX2;
+      transformPixels = transformPixelsAVX2;
+      kernelsName = "AVX2";
+   }
+ #endif
+#elif defined(PK_NEON)
+   fillPixels = fillPixelsNEON;
+   blendPixels = blendPixelsNEON;
+   copyOpaquePixels = copyOpaquePixelsNEON;
+   fadePixels = fadePixelsNEON;
+   transformPixels = transformPixelsNEON;
+   resamplePixel = resamplePixelNEON;
+   kernelsName = "NEON";
+#endif
+}
+
+CharP getPixelKernelsName()
+{
+   return kernelsName;
+}
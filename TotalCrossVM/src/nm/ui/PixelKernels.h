@@ -0,0 +1,62 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include "GraphicsPrimitives.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Inner loops of the software pixel pipeline. Each kernel has a scalar reference version (the *C functions), which is the
+ * one used by the correctness tests, and vectorized versions (SSE2 and AVX2 on x86, NEON on ARM if built with
+ * ENABLE_NEON_KERNELS) that are selected once, at startup, by initPixelKernels, according to what the cpu supports. The
+ * kernels are called through the pointers below.
+ */
+
+/// Fills count pixels with the given one
+typedef void (*FillPixelsFunc)(Pixel* dst, Pixel pixel, int32 count);
+/// Draws count source pixels over the destination ones, weighting the alpha of each source pixel by alphaMask (0-255)
+typedef void (*BlendPixelsFunc)(PixelConv* dst, PixelConv* src, int32 count, int32 alphaMask);
+/// Copies count screen pixels, which have no alpha, setting it to 0xFF
+typedef void (*CopyOpaquePixelsFunc)(PixelConv* dst, PixelConv* src, int32 count);
+/// Averages the color of count pixels with the given background color, keeping their alpha
+typedef void (*FadePixelsFunc)(PixelConv* dst, PixelConv* src, int32 count, Pixel back);
+/// Computes min(255, (c * m + k) >> 16) for each color component of count pixels, keeping their alpha. The multipliers are
+/// 16.16 fixed point values between 0 and 2.0, and k is between 0 and 0x1000000: the vectorized kernels compute the sums
+/// without sign, so they would saturate where the scalar one truncates
+typedef void (*TransformPixelsFunc)(PixelConv* dst, PixelConv* src, int32 count, int32 mr, int32 mg, int32 mb, int32 k);
+/// Returns the pixel whose components are the sums of the components of the count pixels base[pixels[i] * stride], each
+/// one multiplied by weights[i], divided by wsum and clamped to 0-255. It is the inner loop of the Catmull-Rom scaling,
+/// whose weights are 16.16 fixed point values, some of them negative
+typedef Pixel (*ResamplePixelFunc)(PixelConv* base, int32 stride, int32* pixels, int32* weights, int32 count, int32 wsum);
+
+extern FillPixelsFunc fillPixels;
+extern BlendPixelsFunc blendPixels;
+extern CopyOpaquePixelsFunc copyOpaquePixels;
+extern FadePixelsFunc fadePixels;
+extern TransformPixelsFunc transformPixels;
+extern ResamplePixelFunc resamplePixel;
+
+/// Selects the fastest version of each kernel for the running cpu. Can be called more than once
+void initPixelKernels();
+/// Returns the name of the instruction set used by the selected kernels
+CharP getPixelKernelsName();
+
+void fillPixelsC(Pixel* dst, Pixel pixel, int32 count);
+void blendPixelsC(PixelConv* dst, PixelConv* src, int32 count, int32 alphaMask);
+void copyOpaquePixelsC(PixelConv* dst, PixelConv* src, int32 count);
+void fadePixelsC(PixelConv* dst, PixelConv* src, int32 count, Pixel back);
+void transformPixelsC(PixelConv* dst, PixelConv* src, int32 count, int32 mr, int32 mg, int32 mb, int32 k);
+Pixel resamplePixelC(PixelConv* base, int32 stride, int32* pixels, int32* weights, int32 count, int32 wsum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
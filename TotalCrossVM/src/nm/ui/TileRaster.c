@@ -0,0 +1,253 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#include "tcvm.h"
+#include "TileRaster.h"
+
+#if !defined(WIN32)
+#include <unistd.h>
+#endif
+
+int32 tileMinPixels = 64*1024;
+
+static volatile int32 workersStarted;
+static volatile int32 poolBusy; // set while a thread is using the workers
+static int32 workerCount; // started threads, not counting the calling one
+static PoolJobFunc jobFunc;
+static VoidP jobArg;
+static int32 jobCount;
+static volatile int32 nextJob;
+static volatile int32 busyWorkers;
+static volatile bool stopWorkers;
+
+// each thread takes the next job not yet taken, until there are none left
+static void runPendingJobs(int32 worker)
+{
+   int32 i;
+   while ((i = ATOMIC_ADD(&nextJob, 1) - 1) < jobCount)
+      jobFunc(jobArg, i, worker);
+}
+
+#if defined(WP8)
+static int32 getCpuCount()
+{
+   return 1; // the emulated threads can't wait for events
+}
+static bool startWorker(int32 worker) {return false;}
+static void wakeWorkers() {}
+static void waitWorkers() {}
+static void stopAllWorkers() {}
+#elif defined(WIN32)
+static HANDLE workerThreads[POOL_MAX_WORKERS];
+static HANDLE workerEvents[POOL_MAX_WORKERS]; // auto-reset: one for each worker
+static HANDLE doneEvent;
+
+static int32 getCpuCount()
+{
+   SYSTEM_INFO si;
+   GetSystemInfo(&si);
+   return (int32)si.dwNumberOfProcessors;
+}
+
+static DWORD WINAPI poolWorker(LPVOID arg)
+{
+   int32 worker = (int32)(size_t)arg;
+   for (;;)
+   {
+      WaitForSingleObject(workerEvents[worker], INFINITE);
+      if (stopWorkers)
+         break;
+      runPendingJobs(worker);
+      if (ATOMIC_ADD(&busyWorkers, -1) == 0)
+         SetEvent(doneEvent);
+   }
+   return 0;
+}
+
+static bool startWorker(int32 worker)
+{
+   if (doneEvent == null && (doneEvent = CreateEvent(null, false, false, null)) == null)
+      return false;
+   if ((workerEvents[worker] = CreateEvent(null, false, false, null)) == null)
+      return false;
+   if ((workerThreads[worker] = CreateThread(null, 0, poolWorker, (LPVOID)(size_t)worker, 0, null)) == null)
+   {
+      CloseHandle(workerEvents[worker]);
+      return false;
+   }
+   return true;
+}
+
+static void wakeWorkers()
+{
+   int32 i;
+   for (i = 1; i <= workerCount; i++)
+      SetEvent(workerEvents[i]);
+}
+
+static void waitWorkers()
+{
+   WaitForSingleObject(doneEvent, INFINITE);
+}
+
+static void stopAllWorkers()
+{
+   int32 i;
+   for (i = 1; i <= workerCount; i++)
+   {
+      SetEvent(workerEvents[i]);
+      WaitForSingleObject(workerThreads[i], INFINITE);
+      CloseHandle(workerThreads[i]);
+      CloseHandle(workerEvents[i]);
+   }
+   if (doneEvent != null)
+      CloseHandle(doneEvent);
+   doneEvent = null;
+}
+#else
+static pthread_t workerThreads[POOL_MAX_WORKERS];
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t doneCond = PTHREAD_COND_INITIALIZER;
+static int32 generation; // incremented each time the workers are woken up
+
+static int32 getCpuCount()
+{
+   return (int32)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+static void* poolWorker(void* arg)
+{
+   int32 worker = (int32)(size_t)arg, seen = 0; // the workers are started before the first generation
+   pthread_mutex_lock(&poolMutex);
+   for (;;)
+   {
+      while (generation == seen && !stopWorkers)
+         pthread_cond_wait(&workCond, &poolMutex);
+      if (stopWorkers)
+         break;
+      seen = generation;
+      pthread_mutex_unlock(&poolMutex);
+      runPendingJobs(worker);
+      pthread_mutex_lock(&poolMutex);
+      if (--busyWorkers == 0)
+         pthread_cond_signal(&doneCond);
+   }
+   pthread_mutex_unlock(&poolMutex);
+   return null;
+}
+
+static bool startWorker(int32 worker)
+{
+   return pthread_create(&workerThreads[worker], null, poolWorker, (void*)(size_t)worker) == 0;
+}
+
+static void wakeWorkers()
+{
+   pthread_mutex_lock(&poolMutex);
+   generation++;
+   pthread_cond_broadcast(&workCond);
+   pthread_mutex_unlock(&poolMutex);
+}
+
+static void waitWorkers()
+{
+   pthread_mutex_lock(&poolMutex);
+   while (busyWorkers > 0)
+      pthread_cond_wait(&doneCond, &poolMutex);
+   pthread_mutex_unlock(&poolMutex);
+}
+
+static void stopAllWorkers()
+{
+   int32 i;
+   pthread_mutex_lock(&poolMutex);
+   pthread_cond_broadcast(&workCond);
+   pthread_mutex_unlock(&poolMutex);
+   for (i = 1; i <= workerCount; i++)
+      pthread_join(workerThreads[i], null);
+   generation = 0;
+}
+#endif
+
+static void startPoolWorkers()
+{
+   int32 n = min32(getCpuCount(), POOL_MAX_WORKERS) - 1, i;
+   stopWorkers = false;
+   for (i = 1; i <= n && startWorker(i); i++) // the calling thread is the worker 0
+      ;
+   MEMORY_BARRIER();
+   workerCount = i - 1; // only now the workers can be used
+}
+
+TC_API void runPoolJobs(PoolJobFunc func, VoidP arg, int32 count)
+{
+   int32 i;
+   if (count > 1 && workersStarted == 0 && ATOMIC_CAS(&workersStarted, 0, 1))
+      startPoolWorkers();
+   if (workerCount == 0 || count < 2 || !ATOMIC_CAS(&poolBusy, 0, 1)) // another thread may be using the pool
+   {
+      for (i = 0; i < count; i++)
+         func(arg, i, 0);
+      return;
+   }
+   jobFunc = func;
+   jobArg = arg;
+   jobCount = count;
+   nextJob = 0;
+   busyWorkers = workerCount;
+   MEMORY_BARRIER();
+   wakeWorkers();
+   runPendingJobs(0);
+   waitWorkers();
+   jobFunc = null;
+   jobArg = null;
+   MEMORY_BARRIER();
+   poolBusy = 0;
+}
+
+void destroyPoolWorkers()
+{
+   if (workersStarted)
+   {
+      stopWorkers = true;
+      MEMORY_BARRIER();
+      stopAllWorkers();
+   }
+   workerCount = 0;
+   workersStarted = 0;
+}
+
+bool useTiles(int32 pixels)
+{
+   return IS_VMTWEAK_ON(VMTWEAK_TILED_RASTER) && pixels >= tileMinPixels; // even without workers, so the tiles are drawn the same way in any cpu
+}
+
+int32 getTileRows(int32 height)
+{
+   return max32(TILE_MIN_ROWS, (height + TILE_MAX_COUNT - 1) / TILE_MAX_COUNT);
+}
+
+typedef struct
+{
+   TileFunc func;
+   VoidP job;
+   TileClip* tiles;
+} TileJobs;
+
+static void runTile(VoidP arg, int32 job, int32 worker)
+{
+   TileJobs* t = (TileJobs*)arg;
+   t->func(t->job, &t->tiles[job], worker);
+}
+
+void runTiles(TileFunc func, VoidP job, TileClip* tiles, int32 count)
+{
+   TileJobs t;
+   t.func = func;
+   t.job = job;
+   t.tiles = tiles;
+   runPoolJobs(runTile, &t, count);
+}
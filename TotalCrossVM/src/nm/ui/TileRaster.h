@@ -0,0 +1,51 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#ifndef TILERASTER_H
+#define TILERASTER_H
+
+#include "tcvm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Tiled rasterization of the software pixel loops. When the Vm.TWEAK_TILED_RASTER tweak is on, the primitives that
+ * cover a large area split it in bands of rows, each one clipped by the caller, and runTiles hands the bands to the
+ * worker pool (see runPoolJobs), with the calling thread also drawing. The size of the bands depends only on the height
+ * of the area, never on the number of threads, and each band writes only its own pixels, so the result is exactly the
+ * same of the single-threaded one. The tile functions must not allocate objects nor touch the Context: the caller marks the
+ * screen dirty once, before or after running the tiles.
+ */
+
+/// A band of the surface, in absolute coordinates; x2 and y2 are exclusive
+typedef struct
+{
+   int32 x1, y1, x2, y2;
+} TileClip;
+
+/// Draws the given tile of the job. worker is below TILE_MAX_WORKERS, and can be used to index scratch buffers
+typedef void (*TileFunc)(VoidP job, TileClip* tile, int32 worker);
+
+#define TILE_MIN_ROWS    16
+#define TILE_MAX_COUNT   64
+#define TILE_MAX_WORKERS POOL_MAX_WORKERS
+
+/// Areas with less pixels than this are not split. The default is 64K pixels
+extern int32 tileMinPixels;
+
+/// Returns true if an area with the given number of pixels must be split in tiles
+bool useTiles(int32 pixels);
+/// Returns the number of rows of each band when splitting an area with the given height
+int32 getTileRows(int32 height);
+/// Runs func for each one of the tiles and waits until all of them are done
+void runTiles(TileFunc func, VoidP job, TileClip* tiles, int32 count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -154,10 +154,16 @@ void initSkia(int w, int h, void * pixels, int pitch, uint32_t pixelformat)
 }
 
 void flushSkia()
+{
+    flushSkiaRect(0, 0, bitmap.width(), bitmap.height());
+}
+
+// Flushes the canvas, showing only the given rectangle, which must contain everything changed since the last flush
+void flushSkiaRect(int32 x, int32 y, int32 w, int32 h)
 {
     canvas->flush();
 #ifdef HEADLESS
-    TCSDL_UpdateTexture(bitmap.width(), bitmap.height(), bitmap.rowBytes(),bitmap.getPixels());
+    TCSDL_UpdateTexture(x, y, w, h, bitmap.rowBytes(), bitmap.getPixels());
 #endif
 }
 
@@ -21,6 +21,7 @@ int32 colorType(uint32 pixelformat);
 #endif
 void initSkia(int w, int h, void * pixels, int pitch, uint32 pixelformat);
 void flushSkia();
+void flushSkiaRect(int32 x, int32 y, int32 w, int32 h);
 
 int skia_makeTypeface(char* name, void *data, int32 size);
 int32 skia_getTypefaceIndex(char* name);
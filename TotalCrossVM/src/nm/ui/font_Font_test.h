@@ -64,6 +64,69 @@ TESTCASE(tufF_fontCreate_f) // totalcross/ui/font/Font native static void fontCr
    finish: ;
 }
 
+TESTCASE(GlyphCache) // resized chars must come from the atlas after the first time, and be the same after being evicted
+{
+   TUserFont uf;
+   uint16 bitIndex[3] = {0, 0, 4}; // char 1 is 4 pixels wide
+   uint8 bitmap[4*8], copy[8*16];
+   JChar s1[] = {'a','b','c'}, s2[] = {'a','b','d'};
+   uint8 *first, *alpha;
+   int32 pitch, i, y, hits, width;
+
+   for (i = 0; i < (int32)sizeof(bitmap); i++)
+      bitmap[i] = (uint8)(i * 8);
+   xmemzero(&uf, sizeof(uf));
+   uf.fontP.antialiased = AA_8BPP;
+   uf.fontP.maxWidth = 4;
+   uf.fontP.maxHeight = 8;
+   uf.rowWidthInBytes = 4;
+   uf.bitIndexTable = bitIndex;
+   uf.bitmapTable = bitmap;
+
+   first = getResizedCharPixels(currentContext, &uf, 1, 8, 16, &pitch);
+   ASSERT1_EQUALS(NotNull, first);
+   ASSERT2_EQUALS(I32, pitch, GLYPH_ATLAS_W);
+   for (y = 0; y < 16; y++)
+      xmemmove(copy + y * 8, first + y * pitch, 8);
+   hits = glyphHits;
+   alpha = getResizedCharPixels(currentContext, &uf, 1, 8, 16, &pitch);
+   ASSERT2_EQUALS(Ptr, alpha, first);
+   ASSERT2_EQUALS(I32, glyphHits, hits + 1);
+
+   for (i = 0; i < 500; i++) // many sizes, to fill the atlas
+      ASSERT1_EQUALS(NotNull, getResizedCharPixels(currentContext, &uf, 1, (17 + i % 100) / 2 + (i & 1), 17 + i % 100, &pitch));
+   ASSERT1_EQUALS(True, glyphEvictions > 0);
+   alpha = getResizedCharPixels(currentContext, &uf, 1, 8, 16, &pitch);
+   ASSERT1_EQUALS(NotNull, alpha);
+   for (y = 0; y < 16; y++)
+      ASSERT1_EQUALS(True, xmemcmp(copy + y * 8, alpha + y * pitch, 8) == 0);
+
+   first = getResizedCharPixels(currentContext, &uf, 1, 100, GLYPH_ATLAS_H, &pitch); // too high for the atlas
+   ASSERT1_EQUALS(NotNull, first);
+   ASSERT2_EQUALS(I32, pitch, 100);
+   hits = glyphHits;
+   alpha = getResizedCharPixels(currentContext, &uf, 1, 100, GLYPH_ATLAS_H, &pitch);
+   ASSERT2_EQUALS(Ptr, alpha, first);
+   ASSERT2_EQUALS(I32, glyphHits, hits + 1);
+   for (i = 1; i < GLYPH_LARGE; i++) // the large chars are kept apart, and the first one is still there
+      ASSERT1_EQUALS(NotNull, getResizedCharPixels(currentContext, &uf, 1, 100, GLYPH_ATLAS_H + i, &pitch));
+   ASSERT2_EQUALS(Ptr, getResizedCharPixels(currentContext, &uf, 1, 100, GLYPH_ATLAS_H, &pitch), first);
+   ASSERT1_EQUALS(NotNull, getResizedCharPixels(currentContext, &uf, 1, 100, GLYPH_ATLAS_H + GLYPH_LARGE, &pitch)); // replaces the least recently used
+   hits = glyphHits;
+   ASSERT2_EQUALS(Ptr, getResizedCharPixels(currentContext, &uf, 1, 100, GLYPH_ATLAS_H, &pitch), first);
+   ASSERT2_EQUALS(I32, glyphHits, hits + 1);
+
+   putCachedStringWidth(&uf, 4, s1, 3, 123);
+   ASSERT1_EQUALS(True, getCachedStringWidth(&uf, 4, s1, 3, &width));
+   ASSERT2_EQUALS(I32, width, 123);
+   ASSERT1_EQUALS(False, getCachedStringWidth(&uf, 4, s2, 3, &width));
+   ASSERT1_EQUALS(False, getCachedStringWidth(&uf, 8, s1, 3, &width));
+   finish:
+   xfree(uf.tempbufs);
+   destroyGlyphAtlas();
+   clearWidthCache();
+}
+
 TESTCASE(tufF_FontTestCleanup_f) // just do cleanups on the font and fontmetrics tests  #DEPENDS(Graphics)
 {
    UNUSED(tc);
@@ -12,6 +12,7 @@
 #define Graphics_backPixel(o)      makePixelRGB(Graphics_backColor(o))
 #endif
 #include "GraphicsPrimitives_c.h"
+#include "DisplayList.h"
 
 #ifdef WP8
 #include "wp8/gfx_Graphics_c.h"
@@ -75,126 +76,147 @@ TC_API void tugG_create_g(NMParams p) // totalcross/ui/gfx/Graphics native prote
 TC_API void tugG_drawEllipse_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawEllipse(int xc, int yc, int rx, int ry);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_ELLIPSE);
    ellipseDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_forePixel(g), Graphics_forePixel(g), false, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillEllipse_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void fillEllipse(int xc, int yc, int rx, int ry);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_ELLIPSE);
    ellipseDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_backPixel(g), Graphics_backPixel(g), true, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillEllipseGradient_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void fillEllipseGradient(int xc, int yc, int rx, int ry);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_ELLIPSE_GRADIENT);
    ellipseDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_forePixel(g), Graphics_backPixel(g), true, true);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawArc_iiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void drawArc(int xc, int yc, int r, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_ARC);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_forePixel(g), false, false, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawPie_iiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void drawPie(int xc, int yc, int r, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_PIE);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_forePixel(g), false, true, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillPie_iiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void fillPie(int xc, int yc, int r, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_PIE);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_backPixel(g), true, true, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillPieGradient_iiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void fillPieGradient(int xc, int yc, int r, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_PIE_GRADIENT);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_backPixel(g), true, true, true);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawEllipticalArc_iiiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void drawEllipticalArc(int xc, int yc, int rx, int ry, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_ELLIPTICAL_ARC);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_forePixel(g), false, false, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawEllipticalPie_iiiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void drawEllipticalPie(int xc, int yc, int rx, int ry, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_ELLIPTICAL_PIE);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_forePixel(g), false, true, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillEllipticalPie_iiiidd(NMParams p) // totalcross/ui/gfx/Graphics native public void fillEllipticalPie(int xc, int yc, int rx, int ry, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_ELLIPTICAL_PIE);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_backPixel(g), true, true, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillEllipticalPieGradient_i(NMParams p) // totalcross/ui/gfx/Graphics native public void fillEllipticalPieGradient(int xc, int yc, int rx, int ry, double startAngle, double endAngle);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_ELLIPTICAL_PIE_GRADIENT);
    arcPiePointDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], p->dbl[0], p->dbl[1], Graphics_forePixel(g), Graphics_backPixel(g), true, true, true);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawCircle_iii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawCircle(int xc, int yc, int r);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_CIRCLE);
    ellipseDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], Graphics_forePixel(g), Graphics_forePixel(g), false, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillCircle_iii(NMParams p) // totalcross/ui/gfx/Graphics native public void fillCircle(int xc, int yc, int r);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_CIRCLE);
    ellipseDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], Graphics_backPixel(g), Graphics_backPixel(g), true, false);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillCircleGradient_iii(NMParams p) // totalcross/ui/gfx/Graphics native public void fillCircleGradient(int xc, int yc, int r);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_CIRCLE_GRADIENT);
    ellipseDrawAndFill(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[2], Graphics_foreColor(g), Graphics_backPixel(g), true, true);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_getPixel_ii(NMParams p) // totalcross/ui/gfx/Graphics native public int getPixel(int x, int y);
 {
    TCObject g = p->obj[0];
+   BREAK_DISPLAY_LIST(g);
    p->retI = getPixel(g, p->i32[0], p->i32[1]);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_setPixel_ii(NMParams p) // totalcross/ui/gfx/Graphics native public void setPixel(int x, int y);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_SET_PIXEL);
    setPixel(p->currentContext, g, p->i32[0], p->i32[1], Graphics_forePixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawLine_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawLine(int ax, int ay, int bx, int by);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_LINE);
    drawLine(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_forePixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawLine_iiiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawLine(int ax, int ay, int bx, int by, int c);
 {
     TCObject g = p->obj[0];
+    RECORD_DISPLAY_LIST(p, DL_DRAW_LINE_COLOR);
     drawLine(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->i32[4]);
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawDots_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawDots(int ax, int ay, int bx, int by);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_DOTS);
    drawDottedLine(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_forePixel(g), Graphics_backPixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawRect_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawRect(int x, int y, int w, int h);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_RECT);
    drawRect(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_forePixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillRect_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void fillRect(int x, int y, int w, int h);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_RECT);
    fillRect(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], Graphics_backPixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
@@ -207,6 +229,7 @@ TC_API void tugG_fillPolygon_IIi(NMParams p) // totalcross/ui/gfx/Graphics nativ
    // fdie@ the vm has a 4bytes pointer!
    int32* xp = (int32 *)ARRAYOBJ_START(xPoints);
    int32* yp = (int32 *)ARRAYOBJ_START(yPoints);
+   RECORD_DISPLAY_LIST(p, DL_FILL_POLYGON);
 
    if (checkArrayRange(p->currentContext, xPoints, 0, nPoints) && checkArrayRange(p->currentContext, yPoints, 0, nPoints))
       fillPolygon(p->currentContext, g, xp, yp, nPoints, 0, 0, 0, 0, 0, Graphics_backPixel(g), Graphics_backPixel(g), false, false);
@@ -221,6 +244,7 @@ TC_API void tugG_fillPolygonGradient_IIi(NMParams p) // totalcross/ui/gfx/Graphi
    // fdie@ the vm has a 4bytes pointer!
    int32* xp = (int32 *)ARRAYOBJ_START(xPoints);
    int32* yp = (int32 *)ARRAYOBJ_START(yPoints);
+   RECORD_DISPLAY_LIST(p, DL_FILL_POLYGON_GRADIENT);
 
    if (checkArrayRange(p->currentContext, xPoints, 0, nPoints) && checkArrayRange(p->currentContext, yPoints, 0, nPoints))
       fillPolygon(p->currentContext, g, xp, yp, nPoints, 0, 0, 0, 0, 0, Graphics_forePixel(g), Graphics_backPixel(g), true, false);
@@ -235,6 +259,7 @@ TC_API void tugG_drawPolygon_IIi(NMParams p) // totalcross/ui/gfx/Graphics nativ
    // fdie@ the vm has a 4bytes pointer!
    int32* xp = (int32 *)ARRAYOBJ_START(xPoints);
    int32* yp = (int32 *)ARRAYOBJ_START(yPoints);
+   RECORD_DISPLAY_LIST(p, DL_DRAW_POLYGON);
 
    if (checkArrayRange(p->currentContext, xPoints, 0, nPoints) && checkArrayRange(p->currentContext, yPoints, 0, nPoints))
    {
@@ -252,6 +277,7 @@ TC_API void tugG_drawPolyline_IIi(NMParams p) // totalcross/ui/gfx/Graphics nati
    // fdie@ the vm has a 4bytes pointer!
    int32* xp = (int32 *)ARRAYOBJ_START(xPoints);
    int32* yp = (int32 *)ARRAYOBJ_START(yPoints);
+   RECORD_DISPLAY_LIST(p, DL_DRAW_POLYLINE);
 
    if (checkArrayRange(p->currentContext, xPoints, 0, nPoints) && checkArrayRange(p->currentContext, yPoints, 0, nPoints))
       drawPolygon(p->currentContext, g, xp, yp, nPoints, 0, 0, 0, 0, 0, Graphics_forePixel(g));
@@ -261,6 +287,7 @@ TC_API void tugG_drawText_siii(NMParams p) // totalcross/ui/gfx/Graphics native
 {
 	TCObject text;
 	TCObject g = p->obj[0];
+	RECORD_DISPLAY_LIST(p, DL_DRAW_TEXT);
 	if ((text = p->obj[1]) != null)
 		drawText(p->currentContext, g, String_charsStart(text), String_charsLen(text), p->i32[0], p->i32[1], Graphics_forePixel(g), p->i32[2]);
 }
@@ -268,12 +295,14 @@ TC_API void tugG_drawText_siii(NMParams p) // totalcross/ui/gfx/Graphics native
 TC_API void tugG_drawRoundRect_iiiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawRoundRect(int x, int y, int width, int height, int r);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_ROUND_RECT);
    drawRoundRect(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->i32[4], Graphics_forePixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_fillRoundRect_iiiii(NMParams p) // totalcross/ui/gfx/Graphics native public void fillRoundRect(int x, int y, int width, int height, int r);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_FILL_ROUND_RECT);
    fillRoundRect(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->i32[4], Graphics_backPixel(g));
 }
 //////////////////////////////////////////////////////////////////////////
@@ -281,6 +310,7 @@ TC_API void tugG_copyRect_giiiiii(NMParams p) // totalcross/ui/gfx/Graphics nati
 {
    TCObject hDest = p->obj[0];
    TCObject hOrig = p->obj[1];
+   BREAK_DISPLAY_LIST(hDest);
    if (hOrig)
       drawSurface(p->currentContext, hDest, hOrig, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->i32[4], p->i32[5], true);
 }
@@ -288,6 +318,7 @@ TC_API void tugG_copyRect_giiiiii(NMParams p) // totalcross/ui/gfx/Graphics nati
 TC_API void tugG_drawRoundGradient_iiiiiiiii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawRoundGradient(int startX, int startY, int endX, int endY, int topLeftRadius, int topRightRadius, int bottomLeftRadius, int bottomRightRadius,int startColor, int endColor);
 {
    TCObject g = p->obj[0];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_ROUND_GRADIENT);
    drawRoundGradient(p->currentContext, g, p->i32[0],p->i32[1],p->i32[2],p->i32[3],p->i32[4],p->i32[5],p->i32[6],p->i32[7],p->i32[8],p->i32[9], p->i32[10]);
 }
 //////////////////////////////////////////////////////////////////////////
@@ -295,6 +326,7 @@ TC_API void tugG_drawImage_iiib(NMParams p) // totalcross/ui/gfx/Graphics native
 {
    TCObject surfDest = p->obj[0];
    TCObject surfOrig = p->obj[1];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_IMAGE_CLIP);
    if (surfOrig) drawSurface(p->currentContext, surfDest, surfOrig, 0, 0, (int32)(Image_width(surfOrig) * Image_hwScaleW(surfOrig)), (int32)(Image_height(surfOrig) * Image_hwScaleH(surfOrig)), p->i32[0], p->i32[1], (bool)p->i32[2]);
 }
 //////////////////////////////////////////////////////////////////////////
@@ -302,6 +334,7 @@ TC_API void tugG_copyImageRect_iiiiib(NMParams p) // totalcross/ui/gfx/Graphics
 {
    TCObject surfDest = p->obj[0];
    TCObject surfOrig = p->obj[1];
+   RECORD_DISPLAY_LIST(p, DL_COPY_IMAGE_RECT);
    if (surfOrig) drawSurface(p->currentContext, surfDest, surfOrig, p->i32[0], p->i32[1], p->i32[2], p->i32[3], 0,0, (bool)p->i32[4]);
 }
 //////////////////////////////////////////////////////////////////////////
@@ -316,6 +349,7 @@ TC_API void tugG_setPixels_IIi(NMParams p) // totalcross/ui/gfx/Graphics native
    // fdie@ the vm has a 4bytes pointer!
    int32 * xp = (int32 *)ARRAYOBJ_START(xPoints);
    int32 * yp = (int32 *)ARRAYOBJ_START(yPoints);
+   RECORD_DISPLAY_LIST(p, DL_SET_PIXELS);
 
    if (checkArrayRange(p->currentContext, xPoints, 0, nPoints) && checkArrayRange(p->currentContext, yPoints, 0, nPoints))
       while (nPoints-- > 0)
@@ -343,7 +377,11 @@ TC_API void tugG_refresh_iiiiiif(NMParams p) // totalcross/ui/gfx/Graphics nativ
    Graphics_clipY2(g) = Graphics_maxY(g) = min32(p->i32[1]+p->i32[3],scrH);
    Graphics_transX(g) = p->i32[4];
    Graphics_transY(g) = p->i32[5];
-   if (p->obj[1]) Graphics_font(g) = p->obj[1];
+   if (p->obj[1])
+   {
+      WRITE_BARRIER(g, p->obj[1]);
+      Graphics_font(g) = p->obj[1];
+   }
 }
 //////////////////////////////////////////////////////////////////////////
 TC_API void tugG_drawImage_iii(NMParams p) // totalcross/ui/gfx/Graphics native public void drawImage(totalcross.ui.image.Image image, int x, int y);
@@ -351,6 +389,7 @@ TC_API void tugG_drawImage_iii(NMParams p) // totalcross/ui/gfx/Graphics native
    //copyRect(image, 0, 0, image.getWidth(),image.getHeight(), x, y);
    TCObject surfDest = p->obj[0];
    TCObject surfOrig = p->obj[1];
+   RECORD_DISPLAY_LIST(p, DL_DRAW_IMAGE);
    if (surfOrig) drawSurface(p->currentContext, surfDest, surfOrig, 0,0, (int32)(Image_width(surfOrig) * Image_hwScaleW(surfOrig)), (int32)(Image_height(surfOrig) * Image_hwScaleH(surfOrig)), p->i32[0], p->i32[1], true);
 }
 //////////////////////////////////////////////////////////////////////////
@@ -358,6 +397,7 @@ TC_API void tugG_getRGB_Iiiiii(NMParams p) // totalcross/ui/gfx/Graphics native
 {
    TCObject g = p->obj[0];
    TCObject data = p->obj[1];
+   BREAK_DISPLAY_LIST(g);
    p->retI = getsetRGB(p->currentContext, g, data, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->i32[4],true);
 }
 //////////////////////////////////////////////////////////////////////////
@@ -365,6 +405,7 @@ TC_API void tugG_setRGB_Iiiiii(NMParams p) // totalcross/ui/gfx/Graphics native
 {
    TCObject g = p->obj[0];
    TCObject data = p->obj[1];
+   BREAK_DISPLAY_LIST(g);
    p->retI = getsetRGB(p->currentContext, g, data, p->i32[0], p->i32[1], p->i32[2], p->i32[3], p->i32[4],false);
 }
 //////////////////////////////////////////////////////////////////////////
@@ -376,14 +417,7 @@ TC_API void tugG_fadeScreen_i(NMParams p) // totalcross/ui/gfx/Graphics native p
 #else   
    if (graphicsLock(&screen, true))
    {
-      int32 fadeValue = p->i32[0], len,r,g,b;
-      PixelConv *pixels = (PixelConv*)ARRAYOBJ_START(screen.mainWindowPixels);
-      for (len = screen.screenH * screen.screenW; len-- > 0; pixels++)
-      {
-         r = pixels->r * fadeValue; pixels->r = (r+1 + (r >> 8)) >> 8;
-         g = pixels->g * fadeValue; pixels->g = (g+1 + (g >> 8)) >> 8;
-         b = pixels->b * fadeValue; pixels->b = (b+1 + (b >> 8)) >> 8;
-      }
+      fadeScreenPixels(p->i32[0]);
       graphicsLock(&screen, false);
    }                          
 #endif
@@ -396,6 +430,7 @@ TC_API void tugG_fadeScreen_i(NMParams p) // totalcross/ui/gfx/Graphics native p
 TC_API void tugG_dither_iiii(NMParams p) // totalcross/ui/gfx/Graphics native public void dither(int x, int y, int w, int h);
 {
    TCObject g = p->obj[0];
+   BREAK_DISPLAY_LIST(g);
    dither(p->currentContext, g, p->i32[0], p->i32[1], p->i32[2], p->i32[3]);
 }
 
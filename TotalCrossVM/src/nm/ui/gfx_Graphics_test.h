@@ -251,3 +251,191 @@ TESTCASE(Graphics) // #DEPENDS(tuiI_imageLoad_s)
    s = getTimeStamp();  testFillRect(currentContext, g);  debugTime(12, s);  Sleep(TEST_SLEEP); // no blank
    finish: ;
 }
+
+TESTCASE(PixelKernels) // the kernels selected for this cpu must give the same results of the scalar ones
+{
+   #define KERNEL_PIXELS 67 // not a multiple of the vector sizes, so the remaining pixels are also tested
+   PixelConv src[KERNEL_PIXELS], dst[KERNEL_PIXELS], ref[KERNEL_PIXELS];
+   int32 pixels[KERNEL_PIXELS], weights[KERNEL_PIXELS];
+   uint32 seed = 12345;
+   int32 i, j, alphaMask, wsum;
+
+   initPixelKernels();
+   debug("pixel kernels: %s", getPixelKernelsName());
+   for (j = 0; j < 256; j++)
+   {
+      for (i = 0; i < KERNEL_PIXELS; i++)
+      {
+         seed = seed * 1103515245 + 12345;
+         src[i].pixel = seed;
+         seed = seed * 1103515245 + 12345;
+         dst[i].pixel = ref[i].pixel = seed;
+         if ((i % 5) == 0) src[i].a = 0xFF; // the fully opaque and transparent cases take other paths
+         if ((i % 7) == 0) src[i].a = 0;
+      }
+      alphaMask = j == 0 ? 0xFF : j;
+      blendPixelsC(ref, src, KERNEL_PIXELS, alphaMask);
+      blendPixels(dst, src, KERNEL_PIXELS, alphaMask);
+      ASSERT1_EQUALS(True, xmemcmp(dst, ref, sizeof(ref)) == 0);
+
+      copyOpaquePixelsC(ref, src, KERNEL_PIXELS - j % 4);
+      copyOpaquePixels(dst, src, KERNEL_PIXELS - j % 4);
+      ASSERT1_EQUALS(True, xmemcmp(dst, ref, sizeof(ref)) == 0);
+
+      fadePixelsC(ref, src, KERNEL_PIXELS, seed);
+      fadePixels(dst, src, KERNEL_PIXELS, seed);
+      ASSERT1_EQUALS(True, xmemcmp(dst, ref, sizeof(ref)) == 0);
+
+      transformPixelsC(ref, src, KERNEL_PIXELS, (seed >> 15) & 0x1FFFF, j << 9, 0x10000, (j & 1) ? 0 : j << 16);
+      transformPixels(dst, src, KERNEL_PIXELS, (seed >> 15) & 0x1FFFF, j << 9, 0x10000, (j & 1) ? 0 : j << 16);
+      ASSERT1_EQUALS(True, xmemcmp(dst, ref, sizeof(ref)) == 0);
+
+      fillPixelsC((Pixel*)ref, seed, KERNEL_PIXELS - j % 8);
+      fillPixels((Pixel*)dst, seed, KERNEL_PIXELS - j % 8);
+      ASSERT1_EQUALS(True, xmemcmp(dst, ref, sizeof(ref)) == 0);
+
+      for (i = wsum = 0; i < KERNEL_PIXELS; i++) // Catmull-Rom weights go from about -0.075 to 1.0
+      {
+         seed = seed * 1103515245 + 12345;
+         pixels[i] = (seed >> 8) % (KERNEL_PIXELS / 2);
+         weights[i] = (i % 3) == 0 ? -(int32)((seed >> 4) % 0x1300) : (i % 11) == 0 ? 0x10000 : (int32)((seed >> 12) % 0x10000);
+         wsum += weights[i];
+      }
+      for (i = 0; i < 8; i++) // odd and even number of contributions, strides of both passes
+      {
+         ASSERT2_EQUALS(I32, resamplePixel(src, 2, pixels, weights, j % 13 + i, wsum / (i + 1) + 1), resamplePixelC(src, 2, pixels, weights, j % 13 + i, wsum / (i + 1) + 1));
+         ASSERT2_EQUALS(I32, resamplePixel(src + i, 1, pixels + j % 7, weights, KERNEL_PIXELS / 2, -(i + 1) * 0x10000), resamplePixelC(src + i, 1, pixels + j % 7, weights, KERNEL_PIXELS / 2, -(i + 1) * 0x10000));
+      }
+   }
+   finish: ;
+}
+
+TESTCASE(DisplayList) // a replayed list must draw the same pixels, with the translation and clip of the target
+{
+   TCObject g, list;
+   TNMParams p;
+   TCObject obj[2];
+   int32 i32[5], rectColor, lineColor, white;
+
+   g = createObjectWithoutCallingDefaultConstructor(currentContext, "totalcross.ui.gfx.Graphics");
+   setObjectLock(g, UNLOCKED);
+   ASSERT1_EQUALS(NotNull, g);
+   xmemzero(&p, sizeof(p));
+   p.currentContext = currentContext;
+   p.obj = obj;
+   p.i32 = i32;
+   obj[0] = g;
+   obj[1] = null;
+   tugG_create_g(&p);
+   fillRect(currentContext, g, 0, 0, screen.screenW, screen.screenH, makePixel(0xFF, 0xFF, 0xFF));
+   white = getPixel(g, 1, 1);
+
+   // lists that can't be replayed
+   list = createArrayObject(currentContext, "[java.lang.Object", 1);
+   setObjectLock(list, UNLOCKED);
+   ASSERT1_EQUALS(False, replayDisplayList(currentContext, g, list));
+   ASSERT1_EQUALS(True, startDisplayList(currentContext, g));
+   ASSERT1_EQUALS(False, startDisplayList(currentContext, g)); // only one at a time
+   i32[0] = i32[1] = 1;
+   tugG_getPixel_ii(&p);
+   ASSERT1_EQUALS(Null, endDisplayList(currentContext));
+
+   // records a rectangle and a line, checking the pixels they draw
+   Graphics_backColor(g) = 0x102030;
+   Graphics_foreColor(g) = 0x405060;
+   ASSERT1_EQUALS(True, startDisplayList(currentContext, g));
+   i32[0] = 2; i32[1] = 3; i32[2] = 4; i32[3] = 5;
+   tugG_fillRect_iiii(&p);
+   i32[0] = 10; i32[1] = 1; i32[2] = 10; i32[3] = 8;
+   tugG_drawLine_iiii(&p);
+   list = endDisplayList(currentContext); // no objects are created from now on, so the list is not collected
+   ASSERT1_EQUALS(NotNull, list);
+   rectColor = getPixel(g, 3, 4);
+   lineColor = getPixel(g, 10, 5);
+   ASSERT1_EQUALS(True, rectColor != white && lineColor != white);
+
+   // replays in another position, with other colors
+   fillRect(currentContext, g, 0, 0, screen.screenW, screen.screenH, makePixel(0xFF, 0xFF, 0xFF));
+   Graphics_backColor(g) = Graphics_foreColor(g) = 0;
+   Graphics_transX(g) = 20;
+   Graphics_transY(g) = 30;
+   ASSERT1_EQUALS(True, replayDisplayList(currentContext, g, list));
+   ASSERT2_EQUALS(I32, getPixel(g, 3, 4), rectColor);
+   ASSERT2_EQUALS(I32, getPixel(g, 10, 5), lineColor);
+   ASSERT2_EQUALS(I32, getPixel(g, 1, 1), white);
+   ASSERT2_EQUALS(I32, Graphics_transX(g), 20); // the state of the target is restored
+   ASSERT2_EQUALS(I32, Graphics_backColor(g), 0);
+
+   // replays inside a smaller clip
+   fillRect(currentContext, g, -20, -30, screen.screenW, screen.screenH, makePixel(0xFF, 0xFF, 0xFF));
+   Graphics_clipX2(g) = 24;
+   ASSERT1_EQUALS(True, replayDisplayList(currentContext, g, list));
+   Graphics_clipX2(g) = screen.screenW;
+   ASSERT2_EQUALS(I32, getPixel(g, 3, 4), rectColor);
+   ASSERT2_EQUALS(I32, getPixel(g, 4, 4), white);
+   ASSERT2_EQUALS(I32, getPixel(g, 10, 5), white);
+   finish: ;
+}
+
+TESTCASE(TiledRaster) // the drawings split in tiles must give exactly the same pixels of the single-threaded ones
+{
+#ifndef SKIA_H
+   TCObject g;
+   TNMParams p;
+   TCObject obj[2];
+   int32 xs[5], ys[5], holeX[4], holeY[4], w = screen.screenW, h = screen.screenH, size, pass;
+   int32 oldTweaks = vmTweaks, oldMinPixels = tileMinPixels;
+   Pixel *ref = null, *pixels = null;
+
+   g = createObjectWithoutCallingDefaultConstructor(currentContext, "totalcross.ui.gfx.Graphics");
+   setObjectLock(g, UNLOCKED);
+   ASSERT1_EQUALS(NotNull, g);
+   xmemzero(&p, sizeof(p));
+   p.currentContext = currentContext;
+   p.obj = obj;
+   obj[0] = g;
+   obj[1] = null;
+   tugG_create_g(&p);
+   size = h * Graphics_pitch(g);
+   ref = (Pixel*)xmalloc(size * sizeof(Pixel));
+   ASSERT1_EQUALS(NotNull, ref);
+
+   // a self-intersecting star that crosses the clip, with a hole
+   xs[0] = -10; xs[1] = w/2; xs[2] = w+10; xs[3] = w/4;  xs[4] = w*3/4;
+   ys[0] = h/3; ys[1] = -10; ys[2] = h/3;  ys[3] = h+10; ys[4] = h+10;
+   holeX[0] = holeX[3] = w/3; holeX[1] = holeX[2] = w*2/3;
+   holeY[0] = holeY[1] = h/3; holeY[2] = holeY[3] = h*2/3;
+
+   tileMinPixels = 0; // split even the small screens
+   for (pass = 0; pass < 2; pass++)
+   {
+      if (pass == 1)
+         vmTweaks |= 1 << (VMTWEAK_TILED_RASTER-1);
+      Graphics_transX(g) = Graphics_transY(g) = 0;
+      Graphics_clipX1(g) = Graphics_clipY1(g) = 0;
+      Graphics_clipX2(g) = w;
+      Graphics_clipY2(g) = h;
+      fillRect(currentContext, g, 0, 0, w, h, makePixel(0xFF, 0xFF, 0xFF));
+      Graphics_transX(g) = 3;
+      Graphics_transY(g) = 5;
+      Graphics_clipX1(g) = 5;
+      Graphics_clipY1(g) = 7;
+      Graphics_clipX2(g) = w - 9;
+      Graphics_clipY2(g) = h - 11;
+      drawRoundGradient(currentContext, g, 10, 20, w - 20, h - 10, 8, 8, 12, 12, 0x2040FF, 0xFFC000, true);
+      fillPolygon(currentContext, g, xs, ys, 5, holeX, holeY, 4, 7, 2, makePixel(0xC0, 0x10, 0x20), 0, false, false);
+      fillRect(currentContext, g, w/5, h/5, w/2, h/2, makePixel(0x10, 0x80, 0x40));
+#ifndef __gl2_h_
+      fadeScreenPixels(160);
+#endif
+      pixels = getGraphicsPixels(g);
+      if (pass == 0)
+         xmemmove(ref, pixels, size * sizeof(Pixel));
+   }
+   ASSERT1_EQUALS(True, xmemcmp(ref, pixels, size * sizeof(Pixel)) == 0);
+   finish:
+   vmTweaks = oldTweaks;
+   tileMinPixels = oldMinPixels;
+   xfree(ref);
+#endif
+}
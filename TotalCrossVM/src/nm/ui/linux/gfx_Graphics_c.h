@@ -79,7 +79,15 @@ bool graphicsCreateScreenSurface(ScreenSurface screen)
 void graphicsUpdateScreen(Context currentContext, ScreenSurface screen) // screen's already locked
 {            
 #ifdef SKIA_H
-   flushSkia();
+   if (currentContext->fullDirty)
+      flushSkia();
+   else // only the dirty rectangle is uploaded, padded by a pixel for the antialiasing and clipped to the screen
+   {
+      int32 x1 = max32(0, currentContext->dirtyX1 - 1), y1 = max32(0, currentContext->dirtyY1 - 1);
+      int32 x2 = min32(screen->screenW, currentContext->dirtyX2 + 1), y2 = min32(screen->screenH, currentContext->dirtyY2 + 1);
+      if (x1 < x2 && y1 < y2)
+         flushSkiaRect(x1, y1, x2 - x1, y2 - y1);
+   }
 #elif !defined HEADLESS
    DFBRegion bounds;
    bounds.x1 = currentContext->dirtyX1;
@@ -434,6 +434,7 @@ TC_API void tuzZS_putNextEntry_z(NMParams p) // totalcross/util/zip/ZipStream na
    else
    {
       zipNativeP->method = method;
+      WRITE_BARRIER(zipStream, zipEntryObj);
       *ZipStream_lastEntry(zipStream) = zipEntryObj;
    }
    xfree(zipEntryCommentP);
@@ -0,0 +1,695 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#include "tcvm.h"
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* The class image is a snapshot of the classes and constant pools loaded until the main window is
+ * constructed, so the next launches don't need to inflate and parse them again. It has the following format:
+ * . header
+ * . tczs: one entry for each tcz that has a constant pool
+ * . classes
+ * . records: each class and constant pool is a relocatable record. The pointers to its own data are stored
+ *   as offsets from the record's start, so it is restored with a copy followed by a pass that adds the address
+ *   of the copy to them.
+ * . strings: the names used by all records, which are used directly from the image.
+ * References to other classes are stored by name and resolved with loadClass, the references to the constant
+ * pool are kept as indexes, and the vtables are built again. The image is valid only for the vm that wrote it, and
+ * the classes of a tcz that changed since then are loaded from the tcz.
+ * Static initializers still run, since the objects they create live in the garbage collected heap.
+ */
+
+#define CLASS_IMAGE_MAGIC 0x31494354 // "TCI1"
+
+typedef struct
+{
+   int32 magic;
+   uint16 tczVersion, opcodeCount;
+   uint16 pointerSize, classSize, methodSize, cpSize;
+   int32 tczCount, classCount;
+   int32 recordsOfs, stringsOfs, size;
+} TClassImageHeader;
+
+typedef struct
+{
+   uint32 fingerprint; // see tczFingerprint
+   int32 cpOfs, cpSize; // the constant pool record
+} TClassImageTCZ;
+
+typedef struct
+{
+   int32 hash; // hashCodeSlash2Dot of the class name
+   int32 tczIdx;
+   int32 ofs, size;
+} TClassImageEntry;
+
+bool writeClassImage;
+int32 restoredClassCount;
+bool classImageInUse;
+
+static uint8* image; // the whole file
+static int32 imageSize;
+static TClassImageHeader* imageHeader;
+static TClassImageTCZ* imageTCZs;
+static TClassImageEntry* imageClasses;
+static uint8 *imageRecords, *imageStrings;
+static Hashtable htImageClasses; // class hash -> index in imageClasses + 1
+
+extern DECLARE_MUTEX(classLoaderLock);
+
+// identifies the contents of a tcz by its offsets, sizes, first name and the data of all its entries, so a tcz rebuilt
+// with entries of the same sizes (e.g., after changing a numeric constant) doesn't match
+static uint32 tczFingerprint(TCZFileHeader h)
+{
+   int32 n = ARRAYLEN(h->names);
+   uLong crc = crc32(tczEntriesCRC(h), (Bytef*)h->offsets, (n+1) * 4);
+   crc = crc32(crc, (Bytef*)h->uncompressedSizes, n * 4);
+   if (n > 0)
+      crc = crc32(crc, (Bytef*)h->names[0], xstrlen(h->names[0]));
+   return (uint32)crc;
+}
+
+// the index of the given tcz in the image, or -1 if it isn't there or if it changed after the image was written
+static int32 imageTCZIndex(TCZFileHeader h)
+{
+   if (h->classImageIdx == 0)
+   {
+      uint32 fp = tczFingerprint(h);
+      int32 i;
+      h->classImageIdx = -1;
+      for (i = 0; i < imageHeader->tczCount; i++)
+         if (imageTCZs[i].fingerprint == fp)
+         {
+            h->classImageIdx = i+1;
+            break;
+         }
+   }
+   return h->classImageIdx > 0 ? h->classImageIdx-1 : -1;
+}
+
+static void resetTCZIndexes() // the indexes refer to the image that was open
+{
+   VoidPs *list = openTCZs, *head = openTCZs;
+   if (head != null)
+      do
+      {
+         ((TCZFile)list->value)->header->classImageIdx = 0;
+         list = list->next;
+      } while (list != head);
+}
+
+static bool sameClassName(CharP a, CharP b) // '/' and '.' are the same separator
+{
+   for (; *a && *b; a++, b++)
+      if (*a != *b && !((*a == '/' || *a == '.') && (*b == '/' || *b == '.')))
+         return false;
+   return *a == *b;
+}
+
+bool openClassImage(CharP path)
+{
+   FILE* f;
+   int32 i;
+   if (classImageInUse)
+   {
+      debug("Class image %s not opened: the classes restored from the current one are still loaded", path);
+      return false;
+   }
+   closeClassImage();
+   if ((f = fopen(path, "rb")) == null)
+      return false;
+#ifndef WIN32
+   {
+      struct stat st;
+      if (fstat(fileno(f), &st) == 0 && st.st_size >= (off_t)sizeof(TClassImageHeader))
+      {
+         void* map = mmap(null, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f), 0); // the pages are only copied if written
+         if (map != MAP_FAILED)
+         {
+            image = (uint8*)map;
+            imageSize = (int32)st.st_size;
+         }
+      }
+   }
+#else
+   fseek(f, 0, SEEK_END);
+   imageSize = (int32)ftell(f);
+   fseek(f, 0, SEEK_SET);
+   if (imageSize >= (int32)sizeof(TClassImageHeader) && (image = xmalloc(imageSize)) != null && (int32)fread(image, 1, imageSize, f) != imageSize)
+      xfree(image);
+#endif
+   fclose(f);
+   if (image == null)
+      return false;
+   imageHeader = (TClassImageHeader*)image;
+   if (imageHeader->magic != CLASS_IMAGE_MAGIC || imageHeader->size != imageSize || imageHeader->tczVersion != TCZ_VERSION || imageHeader->opcodeCount != OPCODE_LENGTH ||
+       imageHeader->pointerSize != TSIZE || imageHeader->classSize != sizeof(TTCClass) || imageHeader->methodSize != sizeof(TMethod) || imageHeader->cpSize != sizeof(TConstantPool))
+   {
+      debug("Class image %s was not written by this vm; ignoring it", path);
+      closeClassImage();
+      return false;
+   }
+   imageTCZs = (TClassImageTCZ*)(imageHeader + 1);
+   imageClasses = (TClassImageEntry*)(imageTCZs + imageHeader->tczCount);
+   imageRecords = image + imageHeader->recordsOfs;
+   imageStrings = image + imageHeader->stringsOfs;
+   htImageClasses = htNew(imageHeader->classCount * 2, null);
+   if (!htImageClasses.items)
+   {
+      closeClassImage();
+      return false;
+   }
+   for (i = 0; i < imageHeader->classCount; i++)
+      htPut32(&htImageClasses, imageClasses[i].hash, i+1);
+   resetTCZIndexes();
+   return true;
+}
+
+void closeClassImage()
+{
+   if (image != null)
+   {
+#ifndef WIN32
+      munmap(image, imageSize);
+      image = null;
+#else
+      xfree(image);
+#endif
+      htFree(&htImageClasses, null);
+      resetTCZIndexes();
+   }
+   imageHeader = null;
+   classImageInUse = false;
+}
+
+/***********************************************/
+/**               RESTORING                   **/
+/***********************************************/
+
+#define RELOCATE(p)     p = (void*)((p) ? base + (size_t)(p) : null)
+#define RELOCATE_STR(p) p = (CharP)((p) ? imageStrings + (size_t)(p) : null)
+
+static void relocateFields(FieldArray f)
+{
+   int32 n;
+   for (n = ARRAYLENV(f); n-- > 0; f++)
+   {
+      RELOCATE_STR(f->name);
+      RELOCATE_STR(f->sourceClassName);
+      RELOCATE_STR(f->targetClassName);
+   }
+}
+
+bool restoreConstantPool(Context currentContext, ConstantPool t, TCZFile tcz, Heap heap)
+{
+   TClassImageTCZ* it;
+   uint8* base;
+   int32 idx, i;
+
+   if (image == null || (idx = imageTCZIndex(tcz->header)) < 0 || (it = &imageTCZs[idx])->cpSize == 0)
+      return false;
+   base = (uint8*)heapAlloc(heap, it->cpSize);
+   xmemmove(base, imageRecords + it->cpOfs, it->cpSize);
+   xmemmove(t, base, sizeof(TConstantPool));
+   RELOCATE(t->i32);
+   RELOCATE(t->i64);
+   RELOCATE(t->dbl);
+   RELOCATE(t->sfieldField);
+   RELOCATE(t->sfieldClass);
+   RELOCATE(t->ifieldField);
+   RELOCATE(t->ifieldClass);
+   RELOCATE(t->mtdLens);
+   RELOCATE(t->hashNames);
+   RELOCATE(t->hashParams);
+   RELOCATE(t->cls);
+   for (i = ARRAYLENV(t->cls); --i >= 0;)
+      RELOCATE_STR(t->cls[i]);
+   RELOCATE(t->mtdfld);
+   for (i = ARRAYLENV(t->mtdfld); --i >= 0;)
+      RELOCATE_STR(t->mtdfld[i]);
+   RELOCATE(t->mtd);
+   for (i = ARRAYLENV(t->mtd); --i >= 0;)
+      RELOCATE(t->mtd[i]);
+   // the caches of bound fields and methods are always empty
+   if (t->sfieldCount > 0)
+      t->boundSField = newPtrArrayOf(VoidP, t->sfieldCount, heap);
+   if (t->ifieldCount > 0)
+   {
+      t->boundIField = newPtrArrayOf(UInt16, t->ifieldCount, heap);
+      xmemset(t->boundIField,255, t->ifieldCount<<1);
+   }
+   if (t->mtdCount > 0)
+   {
+      t->boundNormal = (MethodPtrArray)newArray(sizeof(Method), t->mtdCount, heap);
+      t->boundVirtualMethod = (MethodPtrArray)newArray(sizeof(Method), t->mtdCount, heap);
+      t->boundInterfaceMethod = (MethodPtrArray)newArray(sizeof(Method), t->mtdCount, heap);
+   }
+   t->heap = heap;
+   classImageInUse = true;
+   // the strings are created last, like in readConstantPool
+   RELOCATE(t->str);
+   for (i = ARRAYLENV(t->str); --i >= 0;)
+      if (t->str[i] != null) // the string is stored as its length followed by its chars
+      {
+         int32* s = (int32*)(base + (size_t)t->str[i]);
+         if ((t->str[i] = createStringObjectWithLen(currentContext, *s)) == null)
+            HEAP_ERROR(heap, HEAP_MEMORY_ERROR);
+         xmemmove(String_charsStart(t->str[i]), s+1, *s * 2);
+      }
+   return true;
+}
+
+bool restoreClass(Context currentContext, TCZFile tcz, CharP className, TCClass* ret)
+{
+   TClassImageEntry* e;
+   CharP superName;
+   volatile Heap heap;
+   uint8* base;
+   TCClass c;
+   Method m;
+   Exception ex;
+   int32 idx, i, j;
+
+   if (image == null || (idx = htGet32(&htImageClasses, hashCodeSlash2Dot(className))) == 0)
+      return false;
+   e = &imageClasses[idx-1];
+   if (e->tczIdx != imageTCZIndex(tcz->header) || !sameClassName((CharP)imageStrings + (size_t)((TCClass)(imageRecords + e->ofs))->name, className))
+      return false;
+
+   heap = heapCreate();
+   IF_HEAP_ERROR(heap)
+   {
+      *ret = !heap || heap->ex.errorCode == HEAP_MEMORY_ERROR ? CLASS_OUT_OF_MEMORY : null;
+      heapDestroy(heap);
+      return true;
+   }
+   heap->greedyAlloc = true;
+   base = (uint8*)heapAlloc(heap, e->size);
+   xmemmove(base, imageRecords + e->ofs, e->size);
+   c = (TCClass)base;
+   c->cp = tcz->header->cp;
+   c->heap = heap;
+   RELOCATE_STR(c->name);
+
+   // the interfaces and the superclass are stored by name
+   RELOCATE(c->interfaces);
+   for (i = 0; i < ARRAYLENV(c->interfaces); i++)
+      if ((c->interfaces[i] = loadClass(currentContext, (CharP)imageStrings + (size_t)c->interfaces[i], true)) == null)
+         HEAP_ERROR(heap, 11);
+   superName = c->superClass ? (CharP)imageStrings + (size_t)c->superClass : null;
+   c->superClass = null;
+   if (superName != null && (c->superClass = loadClass(currentContext, superName, true)) == null)
+   {
+      alert("restoreClass - Superclass not found: %s",superName);
+      HEAP_ERROR(heap, 10);
+   }
+
+   RELOCATE(c->i32InstanceFields); relocateFields(c->i32InstanceFields);
+   RELOCATE(c->objInstanceFields); relocateFields(c->objInstanceFields);
+   RELOCATE(c->v64InstanceFields); relocateFields(c->v64InstanceFields);
+   RELOCATE(c->i32StaticFields);   relocateFields(c->i32StaticFields);
+   RELOCATE(c->objStaticFields);   relocateFields(c->objStaticFields);
+   RELOCATE(c->v64StaticFields);   relocateFields(c->v64StaticFields);
+   if (c->i32StaticFields != null)
+      c->i32StaticValues = newPtrArrayOf(Int32, ARRAYLEN(c->i32StaticFields), heap);
+   if (c->objStaticFields != null)
+      c->objStaticValues = newPtrArrayOf(TCObject, ARRAYLEN(c->objStaticFields), heap);
+   if (c->v64StaticFields != null)
+      c->v64StaticValues = newPtrArrayOf(Double, ARRAYLEN(c->v64StaticFields), heap);
+   c->instanceFields[RegI] = c->i32InstanceFields;
+   c->instanceFields[RegO] = c->objInstanceFields;
+   c->instanceFields[RegD] = c->instanceFields[RegL] = c->v64InstanceFields;
+   c->staticFields[RegI] = c->i32StaticFields;
+   c->staticFields[RegO] = c->objStaticFields;
+   c->staticFields[RegD] = c->staticFields[RegL] = c->v64StaticFields;
+
+   RELOCATE(c->methods);
+   for (i = ARRAYLENV(c->methods), m = c->methods; i-- > 0; m++)
+   {
+      m->class_ = c;
+      RELOCATE_STR(m->name);
+      RELOCATE_STR(m->nativeSignature);
+      RELOCATE(m->code);
+      RELOCATE(m->cpParams);
+      RELOCATE(m->paramRegs);
+      RELOCATE(m->lineNumberLine);
+      RELOCATE(m->lineNumberStartPC);
+      RELOCATE(m->exceptionHandlers);
+      for (j = ARRAYLENV(m->exceptionHandlers), ex = m->exceptionHandlers; j-- > 0; ex++) // the pcs are stored as instruction indexes
+      {
+         RELOCATE_STR(ex->className);
+         ex->startPC = m->code + (size_t)ex->startPC;
+         ex->endPC = m->code + (size_t)ex->endPC;
+         ex->handlerPC = m->code + (size_t)ex->handlerPC;
+      }
+   }
+   RELOCATE(c->finalizeMethod); // only if declared in this class
+   if (c->finalizeMethod == null && c->superClass != null)
+      c->finalizeMethod = c->superClass->finalizeMethod;
+   buildVirtualTables(c, heap);
+   restoredClassCount++;
+   classImageInUse = true;
+   *ret = c;
+   return true;
+}
+
+/***********************************************/
+/**                 WRITING                   **/
+/***********************************************/
+
+typedef struct
+{
+   uint8* buf;
+   int32 size, capacity;
+} TImageBuffer, *ImageBuffer;
+
+typedef struct
+{
+   Heap heap; // used only to jump to the error handler
+   TImageBuffer tczs, classes, records, strings;
+   ConstantPool* cps; // the constant pool of each entry of tczs
+   int32 tczCount, classCount;
+   int32 rec; // start of the record being written
+   Hashtable htStrings, htClasses;
+} TImageWriter, *ImageWriter;
+
+static ImageWriter currentWriter; // htTraverse has no parameter for it
+
+// returns the offset of a zeroed area with the given size and alignment
+static int32 imgReserve(ImageWriter w, ImageBuffer b, int32 size, int32 align)
+{
+   int32 ofs = (b->size + align-1) & ~(align-1);
+   if (ofs + size > b->capacity)
+   {
+      int32 capacity = max32(b->capacity * 2, ofs + size + 4096);
+      uint8* buf = xrealloc(b->buf, capacity);
+      if (buf == null)
+         HEAP_ERROR(w->heap, HEAP_MEMORY_ERROR);
+      xmemzero(buf + b->capacity, capacity - b->capacity);
+      b->buf = buf;
+      b->capacity = capacity;
+   }
+   b->size = ofs + size;
+   return ofs;
+}
+
+#define REC_AT(w, rel) ((w)->records.buf + (w)->rec + (size_t)(rel))
+
+// copies the array to the current record, returning its offset in the record
+static void* putArray(ImageWriter w, void* a, int32 elemSize)
+{
+   int32 n, ofs;
+   if (a == null)
+      return null;
+   n = ARRAYLEN(a);
+   ofs = imgReserve(w, &w->records, TSIZE + n * elemSize, TSIZE) + TSIZE;
+   SET_ARRAYLEN(w->records.buf + ofs) = n;
+   xmemmove(w->records.buf + ofs, a, n * elemSize);
+   return (void*)(size_t)(ofs - w->rec);
+}
+
+// adds the string to the strings shared by all records, returning its offset there
+static CharP putString(ImageWriter w, CharP s)
+{
+   int32 hash, ofs;
+   if (s == null)
+      return null;
+   hash = hashCode(s);
+   ofs = htGet32(&w->htStrings, hash);
+   if (ofs == 0 || !strEq((CharP)w->strings.buf + ofs, s)) // on a collision, the string is just stored again
+   {
+      int32 len = xstrlen(s) + 1;
+      bool isNew = ofs == 0;
+      ofs = imgReserve(w, &w->strings, len, 1);
+      xmemmove(w->strings.buf + ofs, s, len);
+      if (isNew && !htPut32(&w->htStrings, hash, ofs))
+         HEAP_ERROR(w->heap, HEAP_MEMORY_ERROR);
+   }
+   return (CharP)(size_t)ofs;
+}
+
+static CharPArray putStrings(ImageWriter w, CharPArray a)
+{
+   CharPArray rel = putArray(w, a, sizeof(CharP));
+   int32 i;
+   for (i = ARRAYLENV(a); --i >= 0;)
+      ((CharP*)REC_AT(w, rel))[i] = putString(w, a[i]);
+   return rel;
+}
+
+static FieldArray putFields(ImageWriter w, FieldArray fields)
+{
+   FieldArray rel = putArray(w, fields, sizeof(TField));
+   int32 i;
+   for (i = ARRAYLENV(fields); --i >= 0;)
+   {
+      Field f = (Field)REC_AT(w, rel) + i;
+      f->name = putString(w, fields[i].name);
+      f->sourceClassName = putString(w, fields[i].sourceClassName);
+      f->targetClassName = putString(w, fields[i].targetClassName);
+   }
+   return rel;
+}
+
+static MethodArray putMethods(ImageWriter w, MethodArray methods)
+{
+   MethodArray rel = putArray(w, methods, sizeof(TMethod));
+   TMethod t;
+   Method m;
+   int32 i, j;
+   for (i = 0, m = methods; i < ARRAYLENV(methods); i++, m++)
+   {
+      xmemzero(&t, sizeof(t)); // the caches, the jitted code and the native binding start empty
+      t.iCount = m->iCount;
+      t.oCount = m->oCount;
+      t.v64Count = m->v64Count;
+      t.paramSkip = m->paramSkip;
+      t.paramCount = m->paramCount;
+      t.hashName = m->hashName;
+      t.hashParams = m->hashParams;
+      t.cpReturn = m->cpReturn;
+      t.returnReg = m->returnReg;
+      t.flags = m->flags;
+      t.name = putString(w, m->name);
+      t.nativeSignature = putString(w, m->nativeSignature);
+      t.code = putArray(w, m->code, sizeof(TCode));
+      t.cpParams = putArray(w, m->cpParams, sizeof(uint16));
+      t.paramRegs = putArray(w, m->paramRegs, sizeof(uint8));
+      t.lineNumberLine = putArray(w, m->lineNumberLine, sizeof(uint16));
+      t.lineNumberStartPC = putArray(w, m->lineNumberStartPC, sizeof(uint16));
+      t.exceptionHandlers = putArray(w, m->exceptionHandlers, sizeof(TException));
+      for (j = ARRAYLENV(m->exceptionHandlers); --j >= 0;)
+      {
+         Exception ex = (Exception)REC_AT(w, t.exceptionHandlers) + j, orig = &m->exceptionHandlers[j];
+         ex->className = putString(w, orig->className);
+         ex->startPC = (Code)(size_t)(orig->startPC - m->code);
+         ex->endPC = (Code)(size_t)(orig->endPC - m->code);
+         ex->handlerPC = (Code)(size_t)(orig->handlerPC - m->code);
+      }
+      xmemmove((Method)REC_AT(w, rel) + i, &t, sizeof(t));
+   }
+   return rel;
+}
+
+static void putConstantPool(ImageWriter w, ConstantPool cp, TClassImageTCZ* it)
+{
+   TConstantPool t;
+   int32 i, ofs;
+   w->rec = imgReserve(w, &w->records, sizeof(TConstantPool), TSIZE);
+   xmemzero(&t, sizeof(t)); // the bound fields and methods are created again
+   t.i32Count = cp->i32Count;
+   t.i64Count = cp->i64Count;
+   t.dblCount = cp->dblCount;
+   t.clsCount = cp->clsCount;
+   t.sfieldCount = cp->sfieldCount;
+   t.ifieldCount = cp->ifieldCount;
+   t.mtdCount = cp->mtdCount;
+   t.mtdfldCount = cp->mtdfldCount;
+   t.strCount = cp->strCount;
+   t.i32 = putArray(w, cp->i32, sizeof(int32));
+   t.i64 = putArray(w, cp->i64, sizeof(int64));
+   t.dbl = putArray(w, cp->dbl, sizeof(double));
+   t.sfieldField = putArray(w, cp->sfieldField, sizeof(uint16));
+   t.sfieldClass = putArray(w, cp->sfieldClass, sizeof(uint16));
+   t.ifieldField = putArray(w, cp->ifieldField, sizeof(uint16));
+   t.ifieldClass = putArray(w, cp->ifieldClass, sizeof(uint16));
+   t.mtdLens = putArray(w, cp->mtdLens, sizeof(uint8));
+   t.hashNames = putArray(w, cp->hashNames, sizeof(int32));
+   t.hashParams = putArray(w, cp->hashParams, sizeof(int32));
+   t.cls = putStrings(w, cp->cls);
+   t.mtdfld = putStrings(w, cp->mtdfld);
+   t.mtd = putArray(w, cp->mtd, sizeof(UInt16Array));
+   for (i = ARRAYLENV(cp->mtd); --i >= 0;)
+      if (cp->mtd[i] != null) // each method is its name, class and parameters
+      {
+         int32 len = (cp->mtdLens[i] + 2) * 2;
+         ofs = imgReserve(w, &w->records, len, 2);
+         xmemmove(w->records.buf + ofs, cp->mtd[i], len);
+         ((UInt16Array*)REC_AT(w, t.mtd))[i] = (UInt16Array)(size_t)(ofs - w->rec);
+      }
+   t.str = putArray(w, cp->str, sizeof(TCObject));
+   for (i = ARRAYLENV(cp->str); --i >= 0;)
+      if (cp->str[i] != null)
+      {
+         int32 len = String_charsLen(cp->str[i]);
+         ofs = imgReserve(w, &w->records, 4 + len * 2, 4);
+         *(int32*)(w->records.buf + ofs) = len;
+         xmemmove(w->records.buf + ofs + 4, String_charsStart(cp->str[i]), len * 2);
+         ((TCObject*)REC_AT(w, t.str))[i] = (TCObject)(size_t)(ofs - w->rec);
+      }
+   xmemmove(w->records.buf + w->rec, &t, sizeof(t));
+   it->cpOfs = w->rec;
+   it->cpSize = w->records.size - w->rec;
+}
+
+static void putClass(ImageWriter w, TCClass c)
+{
+   CharP name = c->name[0] == '[' ? "java.lang.Array" : c->name; // arrays are all loaded from java.lang.Array
+   int32 hash = hashCodeSlash2Dot(name), i, tczIdx;
+   TClassImageEntry* e;
+   TTCClass t;
+
+   for (tczIdx = w->tczCount; --tczIdx >= 0;)
+      if (w->cps[tczIdx] == c->cp)
+         break;
+   if (tczIdx < 0 || htGet32(&w->htClasses, hash) != 0) // a class may be stored only once
+      return;
+   if (!htPut32(&w->htClasses, hash, 1))
+      HEAP_ERROR(w->heap, HEAP_MEMORY_ERROR);
+
+   w->rec = imgReserve(w, &w->records, sizeof(TTCClass), TSIZE);
+   xmemzero(&t, sizeof(t)); // the static values, vtables and itables are created again
+   t.objOfs = c->objOfs;
+   t.v64Ofs = c->v64Ofs;
+   t.objSize = c->objSize;
+   t.flags = c->flags;
+   t.flags.bits2shift = t.flags.isObjectArray = 0; // set by loadClass for each array
+   t.dontFinalizeFieldIndex = c->dontFinalizeFieldIndex;
+   t.name = putString(w, name);
+   t.superClass = (TCClass)putString(w, c->superClass ? c->superClass->name : null);
+   t.interfaces = putArray(w, c->interfaces, sizeof(TCClass));
+   for (i = ARRAYLENV(c->interfaces); --i >= 0;)
+      ((TCClass*)REC_AT(w, t.interfaces))[i] = (TCClass)putString(w, c->interfaces[i]->name);
+   t.i32InstanceFields = putFields(w, c->i32InstanceFields);
+   t.objInstanceFields = putFields(w, c->objInstanceFields);
+   t.v64InstanceFields = putFields(w, c->v64InstanceFields);
+   t.i32StaticFields = putFields(w, c->i32StaticFields);
+   t.objStaticFields = putFields(w, c->objStaticFields);
+   t.v64StaticFields = putFields(w, c->v64StaticFields);
+   t.methods = putMethods(w, c->methods);
+   if (c->finalizeMethod != null && c->finalizeMethod->class_ == c)
+      t.finalizeMethod = (Method)((uint8*)t.methods + (c->finalizeMethod - c->methods) * sizeof(TMethod));
+   xmemmove(w->records.buf + w->rec, &t, sizeof(t));
+
+   e = (TClassImageEntry*)(w->classes.buf + imgReserve(w, &w->classes, sizeof(TClassImageEntry), 4));
+   e->hash = hash;
+   e->tczIdx = tczIdx;
+   e->ofs = w->rec;
+   e->size = w->records.size - w->rec;
+   w->classCount++;
+}
+
+static void putClassVisitor(int32 i32, VoidP ptr)
+{
+   UNUSED(i32);
+   putClass(currentWriter, (TCClass)ptr);
+}
+
+static bool writeImageFile(ImageWriter w, CharP path)
+{
+   TClassImageHeader h;
+   FILE* f;
+   bool ok;
+   int32 zero = 0, pad;
+
+   xmemzero(&h, sizeof(h));
+   h.magic = CLASS_IMAGE_MAGIC;
+   h.tczVersion = TCZ_VERSION;
+   h.opcodeCount = OPCODE_LENGTH;
+   h.pointerSize = TSIZE;
+   h.classSize = sizeof(TTCClass);
+   h.methodSize = sizeof(TMethod);
+   h.cpSize = sizeof(TConstantPool);
+   h.tczCount = w->tczCount;
+   h.classCount = w->classCount;
+   h.recordsOfs = sizeof(h) + w->tczs.size + w->classes.size;
+   pad = ((h.recordsOfs + 7) & ~7) - h.recordsOfs; // the records keep their alignment
+   h.recordsOfs += pad;
+   h.stringsOfs = h.recordsOfs + w->records.size;
+   h.size = h.stringsOfs + w->strings.size;
+   if ((f = fopen(path, "wb")) == null)
+      return false;
+   ok = fwrite(&h, 1, sizeof(h), f) == sizeof(h) &&
+        (int32)fwrite(w->tczs.buf, 1, w->tczs.size, f) == w->tczs.size &&
+        (int32)fwrite(w->classes.buf, 1, w->classes.size, f) == w->classes.size &&
+        (int32)fwrite(&zero, 1, pad, f) == pad &&
+        (int32)fwrite(w->records.buf, 1, w->records.size, f) == w->records.size &&
+        (int32)fwrite(w->strings.buf, 1, w->strings.size, f) == w->strings.size;
+   fclose(f);
+   return ok;
+}
+
+bool saveClassImage(CharP path)
+{
+   ImageWriter w = newX(ImageWriter);
+   VoidPs *list, *head;
+   bool ok = false;
+   int32 n;
+
+   if (w == null)
+      return false;
+   LOCKVAR(classLoaderLock);
+   w->heap = heapCreate();
+   IF_HEAP_ERROR(w->heap)
+      goto end;
+   w->htStrings = htNew(1023, null);
+   w->htClasses = htNew(511, null);
+   imgReserve(w, &w->strings, 1, 1); // offset 0 is the null string
+
+   // 1. the constant pool of each tcz
+   for (n = 0, list = head = openTCZs; list != null && (n == 0 || list != head); list = list->next)
+      n++;
+   w->cps = (ConstantPool*)xmalloc(max32(n,1) * sizeof(ConstantPool));
+   if (w->cps == null)
+      goto end;
+   if ((list = head) != null)
+      do
+      {
+         TCZFileHeader tczh = ((TCZFile)list->value)->header;
+         if (tczh->cp != null)
+         {
+            TClassImageTCZ* it = (TClassImageTCZ*)(w->tczs.buf + imgReserve(w, &w->tczs, sizeof(TClassImageTCZ), 4));
+            it->fingerprint = tczFingerprint(tczh);
+            w->cps[w->tczCount++] = tczh->cp;
+            putConstantPool(w, tczh->cp, it); // doesn't grow the tczs
+         }
+         list = list->next;
+      } while (list != head);
+
+   // 2. the loaded classes
+   currentWriter = w;
+   htTraverse(&htLoadedClasses, putClassVisitor);
+   currentWriter = null;
+
+   ok = writeImageFile(w, path);
+   if (ok)
+      debug("Class image written: %d classes of %d tczs, %d bytes", w->classCount, w->tczCount, w->records.size + w->strings.size);
+end:
+   UNLOCKVAR(classLoaderLock);
+   htFree(&w->htStrings, null);
+   htFree(&w->htClasses, null);
+   xfree(w->tczs.buf);
+   xfree(w->classes.buf);
+   xfree(w->records.buf);
+   xfree(w->strings.buf);
+   xfree(w->cps);
+   heapDestroy(w->heap);
+   xfree(w);
+   return ok;
+}
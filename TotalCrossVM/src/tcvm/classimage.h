@@ -0,0 +1,42 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#ifndef CLASSIMAGE_H
+#define CLASSIMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Name of the class image file, kept in the application's folder
+#define CLASS_IMAGE_NAME "startup.tci"
+
+/// Set by the -s command line option: the class image is written after the main window is constructed
+extern bool writeClassImage;
+/// Number of classes restored from the class image
+extern int32 restoredClassCount;
+/// Set when a class or constant pool is restored from the class image, since they point to its strings
+extern bool classImageInUse;
+
+/// Opens the given class image, if it exists and was written by this vm. Must be called before the first tcz is loaded. Returns
+/// false without closing the current image if a class or constant pool was restored from it, since they use its memory
+bool openClassImage(CharP path);
+/// Closes the class image. The classes and constant pools restored from it must have been freed
+void closeClassImage();
+/// Writes the classes and constant pools loaded so far to the given file
+bool saveClassImage(CharP path);
+/// Restores the constant pool of the given tcz from the class image. Returns false if it is not there or if the tcz changed
+bool restoreConstantPool(Context currentContext, ConstantPool t, TCZFile tcz, Heap heap);
+/// Reads the class at the current position of the given tcz, for the classes that are not in the class image (tcclass.c)
+TCClass readClass(Context currentContext, ConstantPool cp, TCZFile tcz);
+/// Restores the given class from the class image, without registering it nor calling its static initializer. Returns false
+/// if it is not there or if its tcz changed; otherwise c receives the class, or null or CLASS_OUT_OF_MEMORY like readClass
+bool restoreClass(Context currentContext, TCZFile tcz, CharP className, TCClass* c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -67,6 +67,14 @@ Context newContext(ThreadHandle thread, TCObject threadObj, bool bigContextSizes
       heapDestroy(heap);
       return null;
    }
+   if (!initParker(&c->parker))
+   {
+      LOCKVAR(omm);
+      contexts[i] = null;
+      UNLOCKVAR(omm);
+      heapDestroy(heap);
+      return null;
+   }
    
    c->heap = heap;
    c->threadObj = threadObj;
@@ -101,9 +109,11 @@ void deleteContext(Context c, bool destroyThread)
          break;
       }
    if (c->OutOfMemoryErrorObj != null) setObjectLock(c->OutOfMemoryErrorObj, UNLOCKED);
+   releaseNursery(c);
    UNLOCKVAR(omm);
    xfree(c->litebasePtr); // free litebase pointer
    DESTROY_MUTEX(c->usageLock);
+   destroyParker(&c->parker);
    heapDestroy(c->heap);
 }
 
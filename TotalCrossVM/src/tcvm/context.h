@@ -66,6 +66,17 @@ struct TContext
    // reflection
    bool parametersInArray;
 
+   // objectmemorymanager.c - young objects are allocated in [nurseryStart,nurseryEnd)
+   uint8 *nurseryStart, *nurseryTop, *nurseryEnd;
+   volatile int32 nurseryState; // changed only with atomic operations
+
+   // tcthread.c - the thin locks held by this context, once for each enter, and the monitor it is parked waiting for
+   TCObject lockStack[MONITOR_LOCK_STACK];
+   int32 lockStackTop;
+   volatile TCObject waitingMonitor;
+   Context nextWaiter;
+   TParker parker;
+
    // IMPORTANT: ALL IFDEFS MUST BE PLACED AT THE END, otherwise, other native libraries that 
    // use this header that do not define the same #defines, will have problems.
    #ifdef ENABLE_TEST_SUITE
@@ -0,0 +1,460 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#include "tcvm.h"
+
+#ifdef ENABLE_JIT
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * Baseline jit
+ *
+ * When a method is called JIT_THRESHOLD times, its instructions are translated one by one to x86-64 code, using
+ * a fixed template for each opcode. The registers are kept in the regI and regO arrays, so the interpreter can
+ * continue from any instruction. Only the instructions that work with int registers, int/byte/char arrays and
+ * the jumps are compiled; any other instruction ends the native code, which returns the address of the instruction
+ * so the interpreter executes it and the rest of the method. The same happens before an instruction that would throw
+ * an exception (null array, index out of bounds, division by zero), so the exception is thrown by the interpreter
+ * exactly as before.
+ *
+ * The generated function receives regI in rdi, regO in rsi, the method's code in rdx, which is copied to r8
+ * because idiv uses edx, and the native code of the instruction where it starts in rcx, to where it jumps. This
+ * lets the interpreter enter the code at the target of a jump backwards, using the offsets kept in the method's
+ * jitOffsets. eax, ecx, edx and r9 (that holds the array) are used as scratch registers.
+ *
+ * Only the instructions reachable from the method's start are compiled, and only methods that have a loop are kept.
+ * Each method is copied to its own pages, which are writable only until the code is complete; then they are made
+ * executable, and are never written again.
+ */
+
+#define JIT_MAX_OP_SIZE 64 // the largest template, plus the jump to an instruction already compiled
+
+typedef struct TJitChunk
+{
+   struct TJitChunk* next;
+   uint32 size;
+} TJitChunk, *JitChunk;
+
+static JitChunk jitChunks;
+DECLARE_MUTEX(jit);
+
+typedef struct
+{
+   uint8 *start, *p;
+   int32 codeLen;
+   Int32Array offsets; // offset of each instruction in the native code, or -1 if not compiled
+   Int32Array fixups; // position of each jump's displacement and the target instruction
+   Int32Array pending; // instructions that are target of jumps
+   int32 nfixups, npending;
+   bool hasLoop;
+} TJitState, *JitState;
+
+// x86 registers
+#define EAX 0
+#define ECX 1
+#define EDX 2
+
+// x86 condition codes
+#define CC_AE 0x3
+#define CC_E  0x4
+#define CC_NE 0x5
+#define CC_L  0xC
+#define CC_GE 0xD
+#define CC_LE 0xE
+#define CC_G  0xF
+
+#define EMIT(b) *s->p++ = (uint8)(b)
+
+static void emit32(JitState s, int32 v)
+{
+   xmemmove(s->p, &v, 4);
+   s->p += 4;
+}
+
+// op r32, [rdi + reg*4]
+static void emitRegI(JitState s, int32 opcode, int32 r, int32 reg)
+{
+   EMIT(opcode);
+   EMIT(0x87 | (r << 3));
+   emit32(s, reg * 4);
+}
+
+// op r64, [rsi + reg*8]
+static void emitRegO(JitState s, int32 opcode, int32 r, int32 reg)
+{
+   EMIT(0x48);
+   EMIT(opcode);
+   EMIT(0x86 | (r << 3));
+   emit32(s, reg * TSIZE);
+}
+
+#define LOAD_I(r, reg)  emitRegI(s, 0x8B, r, reg)
+#define STORE_I(r, reg) emitRegI(s, 0x89, r, reg)
+
+static void emitLoadImm(JitState s, int32 r, int32 v)
+{
+   EMIT(0xB8 + r);
+   emit32(s, v);
+}
+
+// mov r8, rdx; jmp rcx
+static void emitPrologue(JitState s)
+{
+   EMIT(0x49); EMIT(0x89); EMIT(0xD0);
+   EMIT(0xFF); EMIT(0xE1);
+}
+
+// lea rax, [r8 + pc*4]; ret
+static void emitExit(JitState s, int32 pc)
+{
+   EMIT(0x49); EMIT(0x8D); EMIT(0x80); emit32(s, pc * sizeof(TCode));
+   EMIT(0xC3);
+}
+
+// leaves to the interpreter at the given instruction if the condition is true
+static void emitExitIf(JitState s, int32 cc, int32 pc)
+{
+   EMIT(0x70 | (cc ^ 1)); EMIT(8); // jump over the exit if the condition is false
+   emitExit(s, pc);
+}
+
+// jumps to the target instruction, using cc as condition, or always if cc is -1
+static void emitJump(JitState s, int32 cc, int32 target)
+{
+   if (cc < 0)
+      EMIT(0xE9);
+   else
+   {
+      EMIT(0x0F); EMIT(0x80 | cc);
+   }
+   s->fixups[s->nfixups++] = (int32)(s->p - s->start);
+   s->fixups[s->nfixups++] = target;
+   emit32(s, 0);
+   s->pending[s->npending++] = target;
+}
+
+// loads the array object into r9 and its index into rax, leaving if the array is null or the index is out of bounds
+static void emitArray(JitState s, int32 base, int32 idx, bool checkBounds, int32 pc)
+{
+   EMIT(0x4C); EMIT(0x8B); EMIT(0x8E); emit32(s, base * TSIZE); // mov r9, [rsi + base*8]
+   EMIT(0x4D); EMIT(0x85); EMIT(0xC9);                          // test r9, r9
+   emitExitIf(s, CC_E, pc);
+   LOAD_I(EAX, idx);
+   if (checkBounds)
+   {
+      EMIT(0x41); EMIT(0x3B); EMIT(0x01);                       // cmp eax, [r9] - the array length. negative indexes are also above it
+      emitExitIf(s, CC_AE, pc);
+   }
+   EMIT(0x48); EMIT(0x63); EMIT(0xC0);                          // movsxd rax, eax
+}
+
+// the elements start right after the array length
+#define EMIT_ELEM(scale) EMIT(0x4C); EMIT(scale); EMIT(TSIZE)   // [r9 + rax*scale + TSIZE] using ecx
+#define SCALE1 0x01
+#define SCALE2 0x41
+#define SCALE4 0x81
+
+// ecx = ecx op imm32
+static void emitAluImm(JitState s, int32 ext, int32 v)
+{
+   EMIT(0x81); EMIT(0xC1 | (ext << 3)); emit32(s, v);
+}
+
+// regI[reg0] = eax op ecx
+static void emitAlu(JitState s, int32 opcode, int32 reg0)
+{
+   if (opcode == 0xAF) // imul eax, ecx
+   {
+      EMIT(0x0F); EMIT(0xAF); EMIT(0xC1);
+   }
+   else
+   if (opcode == 0xD3) // shifts: the extension is passed in reg0's high bits
+   {
+      EMIT(0xD3); EMIT(0xC0 | ((reg0 >> 8) << 3));
+   }
+   else
+   {
+      EMIT(opcode); EMIT(0xC8);
+   }
+   STORE_I(EAX, reg0 & 0xFF);
+}
+
+// eax = eax / ecx or edx = eax % ecx. Leaves if ecx is 0 or -1, because in the later the result may overflow
+static void emitDiv(JitState s, bool isMod, int32 reg0, int32 pc)
+{
+   EMIT(0x85); EMIT(0xC9);                  // test ecx, ecx
+   EMIT(0x74); EMIT(5);                     // je exit
+   EMIT(0x83); EMIT(0xF9); EMIT(0xFF);      // cmp ecx, -1
+   EMIT(0x75); EMIT(8);                     // jne over the exit
+   emitExit(s, pc);
+   EMIT(0x99);                              // cdq
+   EMIT(0xF7); EMIT(0xF9);                  // idiv ecx
+   STORE_I(isMod ? EDX : EAX, reg0);
+}
+
+static int32 jccOf(int32 op)
+{
+   switch (op)
+   {
+      case JEQ_regI_regI: case JEQ_regI_s6: case JEQ_regI_sym: case JEQ_regO_regO: case JEQ_regO_null: return CC_E;
+      case JNE_regI_regI: case JNE_regI_s6: case JNE_regI_sym: case JNE_regO_regO: case JNE_regO_null: return CC_NE;
+      case JLT_regI_regI: case JLT_regI_s6: return CC_L;
+      case JLE_regI_regI: case JLE_regI_s6: return CC_LE;
+      case JGT_regI_regI: case JGT_regI_s6: case DECJGTZ_regI: return CC_G;
+      default: return CC_GE;
+   }
+}
+
+// compiles the instructions starting at pc, until one that is not supported, an unconditional jump or one already compiled
+static void compileRun(JitState s, Method m, int32 pc)
+{
+   Int32Array i32 = m->class_->cp->i32;
+   Code code;
+   int32 target, op;
+
+   for (; pc < s->codeLen; pc++)
+   {
+      if (s->offsets[pc] >= 0) // continue in the already compiled code
+      {
+         emitJump(s, -1, pc);
+         return;
+      }
+      s->offsets[pc] = (int32)(s->p - s->start);
+      code = m->code + pc;
+      target = -1;
+      op = unfusedOpcode(code->op.op); // a superinstruction is compiled as its first instruction, followed by the second one
+      switch (op)
+      {
+         case MOV_regI_regI:  LOAD_I(EAX, code->reg_reg.reg1); STORE_I(EAX, code->reg_reg.reg0); break;
+         case MOV_regI_sym:   emitLoadImm(s, EAX, i32[code->reg_sym.sym]); STORE_I(EAX, code->reg_sym.reg); break;
+         case MOV_regI_s18:   emitLoadImm(s, EAX, (int32)code->s18_reg.s18); STORE_I(EAX, code->s18_reg.reg); break;
+         case MOV_regO_regO:  emitRegO(s, 0x8B, EAX, code->reg_reg.reg1); emitRegO(s, 0x89, EAX, code->reg_reg.reg0); break;
+         case MOV_regO_null:  emitRegO(s, 0xC7, 0, code->reg.reg); emit32(s, 0); break;
+         case MOV_regI_arlen:
+            EMIT(0x4C); EMIT(0x8B); EMIT(0x8E); emit32(s, code->reg_ar.base * TSIZE); // mov r9, [rsi + base*8]
+            EMIT(0x4D); EMIT(0x85); EMIT(0xC9);                                       // test r9, r9
+            emitExitIf(s, CC_E, pc);
+            EMIT(0x41); EMIT(0x8B); EMIT(0x01);                                       // mov eax, [r9]
+            STORE_I(EAX, code->reg_ar.reg);
+            break;
+         case MOV_regI_arc:
+         case MOV_regI_aru:   emitArray(s, code->reg_ar.base, code->reg_ar.idx, op == MOV_regI_arc, pc); EMIT(0x41); EMIT(0x8B); EMIT_ELEM(SCALE4); STORE_I(ECX, code->reg_ar.reg); break;
+         case MOV_regIb_arc:
+         case MOV_regIb_aru:  emitArray(s, code->reg_ar.base, code->reg_ar.idx, op == MOV_regIb_arc, pc); EMIT(0x41); EMIT(0x0F); EMIT(0xBE); EMIT_ELEM(SCALE1); STORE_I(ECX, code->reg_ar.reg); break;
+         case MOV_reg16_arc:
+         case MOV_reg16_aru:  emitArray(s, code->reg_ar.base, code->reg_ar.idx, op == MOV_reg16_arc, pc); EMIT(0x41); EMIT(0x0F); EMIT(0xB7); EMIT_ELEM(SCALE2); STORE_I(ECX, code->reg_ar.reg); break;
+         case MOV_arc_regI:
+         case MOV_aru_regI:   emitArray(s, code->reg_ar.base, code->reg_ar.idx, op == MOV_arc_regI, pc); LOAD_I(ECX, code->reg_ar.reg); EMIT(0x41); EMIT(0x89); EMIT_ELEM(SCALE4); break;
+         case MOV_arc_regIb:
+         case MOV_aru_regIb:  emitArray(s, code->reg_ar.base, code->reg_ar.idx, op == MOV_arc_regIb, pc); LOAD_I(ECX, code->reg_ar.reg); EMIT(0x41); EMIT(0x88); EMIT_ELEM(SCALE1); break;
+         case MOV_arc_reg16:
+         case MOV_aru_reg16:  emitArray(s, code->reg_ar.base, code->reg_ar.idx, op == MOV_arc_reg16, pc); LOAD_I(ECX, code->reg_ar.reg); EMIT(0x66); EMIT(0x41); EMIT(0x89); EMIT_ELEM(SCALE2); break;
+         case ADD_regI_arc_s6:
+         case ADD_regI_aru_s6:
+         case AND_regI_aru_s6:
+            emitArray(s, code->reg_s6_ar.base, code->reg_s6_ar.idx, op == ADD_regI_arc_s6, pc);
+            EMIT(0x41); EMIT(0x8B); EMIT_ELEM(SCALE4);
+            emitAluImm(s, op == AND_regI_aru_s6 ? 4 : 0, (int32)code->reg_s6_ar.s6);
+            STORE_I(ECX, code->reg_s6_ar.reg);
+            break;
+         case ADD_aru_regI_s6:
+            emitArray(s, code->reg_s6_ar.base, code->reg_s6_ar.idx, false, pc);
+            LOAD_I(ECX, code->reg_s6_ar.reg);
+            emitAluImm(s, 0, (int32)code->reg_s6_ar.s6);
+            EMIT(0x41); EMIT(0x89); EMIT_ELEM(SCALE4);
+            break;
+         case INC_regI:       EMIT(0x81); EMIT(0x87); emit32(s, code->inc.reg * 4); emit32(s, (int32)code->inc.s16); break;
+         case ADD_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0x01, code->reg_reg_reg.reg0); break;
+         case SUB_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0x29, code->reg_reg_reg.reg0); break;
+         case MUL_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0xAF, code->reg_reg_reg.reg0); break;
+         case AND_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0x21, code->reg_reg_reg.reg0); break;
+         case OR_regI_regI_regI:  LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0x09, code->reg_reg_reg.reg0); break;
+         case XOR_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0x31, code->reg_reg_reg.reg0); break;
+         case SHL_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0xD3, code->reg_reg_reg.reg0 | (4 << 8)); break; // the cpu masks the shift count with 0x1F, like the interpreter
+         case SHR_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0xD3, code->reg_reg_reg.reg0 | (7 << 8)); break;
+         case USHR_regI_regI_regI:LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitAlu(s, 0xD3, code->reg_reg_reg.reg0 | (5 << 8)); break;
+         case ADD_regI_regI_sym:  LOAD_I(EAX, code->reg_reg_sym.reg1); emitLoadImm(s, ECX, i32[code->reg_reg_sym.sym]); emitAlu(s, 0x01, code->reg_reg_sym.reg0); break;
+         case ADD_regI_s12_regI:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0x01, code->reg_reg_s12.reg0); break;
+         case SUB_regI_s12_regI:  emitLoadImm(s, EAX, (int32)code->reg_reg_s12.s12); LOAD_I(ECX, code->reg_reg_s12.reg1); emitAlu(s, 0x29, code->reg_reg_s12.reg0); break;
+         case MUL_regI_regI_s12:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0xAF, code->reg_reg_s12.reg0); break;
+         case AND_regI_regI_s12:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0x21, code->reg_reg_s12.reg0); break;
+         case OR_regI_regI_s12:   LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0x09, code->reg_reg_s12.reg0); break;
+         case XOR_regI_regI_s12:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0x31, code->reg_reg_s12.reg0); break;
+         case SHL_regI_regI_s12:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0xD3, code->reg_reg_s12.reg0 | (4 << 8)); break;
+         case SHR_regI_regI_s12:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0xD3, code->reg_reg_s12.reg0 | (7 << 8)); break;
+         case USHR_regI_regI_s12: LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitAlu(s, 0xD3, code->reg_reg_s12.reg0 | (5 << 8)); break;
+         case DIV_regI_regI_regI:
+         case MOD_regI_regI_regI: LOAD_I(EAX, code->reg_reg_reg.reg1); LOAD_I(ECX, code->reg_reg_reg.reg2); emitDiv(s, op == MOD_regI_regI_regI, code->reg_reg_reg.reg0, pc); break;
+         case DIV_regI_regI_s12:
+         case MOD_regI_regI_s12:  LOAD_I(EAX, code->reg_reg_s12.reg1); emitLoadImm(s, ECX, (int32)code->reg_reg_s12.s12); emitDiv(s, op == MOD_regI_regI_s12, code->reg_reg_s12.reg0, pc); break;
+         case CONV_regIb_regI:    LOAD_I(EAX, code->reg_reg.reg1); EMIT(0x0F); EMIT(0xBE); EMIT(0xC0); STORE_I(EAX, code->reg_reg.reg0); break;
+         case CONV_regIc_regI:    LOAD_I(EAX, code->reg_reg.reg1); EMIT(0x0F); EMIT(0xB7); EMIT(0xC0); STORE_I(EAX, code->reg_reg.reg0); break;
+         case CONV_regIs_regI:    LOAD_I(EAX, code->reg_reg.reg1); EMIT(0x0F); EMIT(0xBF); EMIT(0xC0); STORE_I(EAX, code->reg_reg.reg0); break;
+         case JEQ_regI_regI: case JNE_regI_regI: case JLT_regI_regI: case JLE_regI_regI: case JGT_regI_regI: case JGE_regI_regI:
+            LOAD_I(EAX, code->reg_reg_s12.reg0);
+            emitRegI(s, 0x3B, EAX, code->reg_reg_s12.reg1); // cmp eax, regI[reg1]
+            target = pc + code->reg_reg_s12.s12;
+            break;
+         case JEQ_regI_s6: case JNE_regI_s6: case JLT_regI_s6: case JLE_regI_s6: case JGT_regI_s6: case JGE_regI_s6:
+            LOAD_I(EAX, code->reg_s6_desloc.reg);
+            EMIT(0x3D); emit32(s, (int32)code->reg_s6_desloc.s6); // cmp eax, imm32
+            target = pc + code->reg_s6_desloc.desloc;
+            break;
+         case JEQ_regI_sym: case JNE_regI_sym:
+            LOAD_I(EAX, code->reg_sym_sdesloc.reg);
+            EMIT(0x3D); emit32(s, i32[code->reg_sym_sdesloc.sym]);
+            target = pc + code->reg_sym_sdesloc.desloc;
+            break;
+         case JEQ_regO_regO: case JNE_regO_regO:
+            emitRegO(s, 0x8B, EAX, code->reg_reg_s12.reg0);
+            emitRegO(s, 0x3B, EAX, code->reg_reg_s12.reg1);
+            target = pc + code->reg_reg_s12.s12;
+            break;
+         case JEQ_regO_null: case JNE_regO_null:
+            emitRegO(s, 0x8B, EAX, code->reg_reg_s12.reg0);
+            EMIT(0x48); EMIT(0x85); EMIT(0xC0); // test rax, rax
+            target = pc + code->reg_reg_s12.s12;
+            break;
+         case JGE_regI_arlen:
+            EMIT(0x4C); EMIT(0x8B); EMIT(0x8E); emit32(s, code->reg_arl_s12.base * TSIZE);
+            EMIT(0x4D); EMIT(0x85); EMIT(0xC9);
+            emitExitIf(s, CC_E, pc);
+            LOAD_I(EAX, code->reg_arl_s12.regI);
+            EMIT(0x41); EMIT(0x3B); EMIT(0x01); // cmp eax, [r9]
+            target = pc + code->reg_arl_s12.desloc;
+            break;
+         case DECJGTZ_regI:
+         case DECJGEZ_regI:
+            LOAD_I(EAX, code->reg_desloc.reg);
+            EMIT(0x83); EMIT(0xE8); EMIT(1); // sub eax, 1
+            STORE_I(EAX, code->reg_desloc.reg);
+            EMIT(0x85); EMIT(0xC0);          // test eax, eax
+            target = pc + code->reg_desloc.desloc;
+            break;
+         case JUMP_s24:
+            target = pc + code->s24.desloc;
+            if (target <= pc)
+               s->hasLoop = true;
+            emitJump(s, -1, target);
+            return;
+         default: // not supported: let the interpreter continue from here
+            emitExit(s, pc);
+            return;
+      }
+      if (target >= 0)
+      {
+         if (target <= pc)
+            s->hasLoop = true;
+         emitJump(s, jccOf(op), target);
+      }
+   }
+   s->codeLen = -1; // ran out of the code
+}
+
+// maps writable pages for the given code and offsets, which are made executable (and read-only) once they're copied
+static uint8* jitCopy(uint8* code, int32 codeSize, int32* offsets, int32 len, int32** jitOffsets)
+{
+   int32 pageSize = (int32)sysconf(_SC_PAGESIZE);
+   int32 offsetsStart = ((int32)sizeof(TJitChunk) + codeSize + 3) & ~3;
+   uint32 size = (uint32)((offsetsStart + len * 4 + pageSize - 1) & ~(pageSize - 1));
+   JitChunk c;
+   uint8* native;
+
+   if ((c = (JitChunk)mmap(null, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+      return null;
+   native = (uint8*)(c + 1);
+   xmemmove(native, code, codeSize);
+   xmemmove(((uint8*)c) + offsetsStart, offsets, len * 4);
+   c->size = size;
+   c->next = jitChunks;
+   if (mprotect(c, size, PROT_READ | PROT_EXEC) != 0)
+   {
+      munmap(c, size);
+      return null;
+   }
+   jitChunks = c;
+   *jitOffsets = (int32*)(((uint8*)c) + offsetsStart);
+   return native;
+}
+
+bool jitCompile(Method m)
+{
+   TJitState s;
+   uint8* native = null;
+   int32 i, len = ARRAYLENV(m->code);
+
+   if (len == 0 || m->flags.isNative || m->flags.isAbstract)
+      return false;
+   LOCKVAR(jit);
+   if (m->jitCode != null) // compiled by another thread
+   {
+      UNLOCKVAR(jit);
+      return true;
+   }
+   tzero(s);
+   s.codeLen = len;
+   s.offsets = newPtrArrayOf(Int32, len, null);
+   s.fixups = newPtrArrayOf(Int32, 4 * len + 4, null);
+   s.pending = newPtrArrayOf(Int32, 2 * len + 2, null);
+   s.start = s.p = (uint8*)xmalloc(16 + len * JIT_MAX_OP_SIZE);
+   if (s.offsets != null && s.fixups != null && s.pending != null && s.start != null)
+   {
+      for (i = 0; i < len; i++)
+         s.offsets[i] = -1;
+      emitPrologue(&s);
+      s.pending[s.npending++] = 0;
+      while (s.npending > 0 && s.codeLen > 0)
+      {
+         i = s.pending[--s.npending];
+         if (i < 0 || i >= len)
+            s.codeLen = -1;
+         else
+         if (s.offsets[i] < 0)
+            compileRun(&s, m, i);
+      }
+      if (s.codeLen > 0 && s.hasLoop)
+      {
+         for (i = 0; i < s.nfixups; i += 2)
+         {
+            int32 disp = s.offsets[s.fixups[i+1]] - (s.fixups[i] + 4);
+            xmemmove(s.start + s.fixups[i], &disp, 4);
+         }
+         if ((native = jitCopy(s.start, (int32)(s.p - s.start), s.offsets, len, &m->jitOffsets)) != null)
+         {
+            MEMORY_BARRIER(); // the offsets must be seen before the code by the other threads
+            m->jitCode = (JitCode)native;
+         }
+      }
+   }
+   xfree(s.start);
+   freeArray(s.offsets);
+   freeArray(s.fixups);
+   freeArray(s.pending);
+   UNLOCKVAR(jit);
+   return native != null;
+}
+
+bool initJit()
+{
+   SETUP_MUTEX;
+   INIT_MUTEX(jit);
+   return true;
+}
+
+void destroyJit()
+{
+   JitChunk c, next;
+   for (c = jitChunks; c != null; c = next)
+   {
+      next = c->next;
+      munmap(c, c->size);
+   }
+   jitChunks = null;
+   DESTROY_MUTEX(jit);
+}
+
+#endif
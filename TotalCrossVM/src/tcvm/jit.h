@@ -0,0 +1,65 @@
+// Copyright (C) 2000-2013 SuperWaba Ltda.
+// Copyright (C) 2014-2020 TotalCross Global Mobile Platform Ltda.
+//
+// SPDX-License-Identifier: LGPL-2.1-only
+
+#ifndef JIT_H
+#define JIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the jit emits native code only for the System V x86-64 calling convention
+#if defined(__x86_64__) && (defined(linux) || defined(ANDROID)) && !defined(DISABLE_JIT)
+ #define ENABLE_JIT
+#endif
+
+#ifdef ENABLE_JIT
+
+/// Number of invocations of a method, plus the jumps backwards taken in it, before it is compiled
+#define JIT_THRESHOLD 1000
+
+/// Compiles the given method, returning false if it has nothing worth compiling
+bool jitCompile(Method m);
+bool initJit();
+void destroyJit();
+
+/// Runs the compiled code from the given instruction, which returns the instruction where the interpreter must resume
+#define JIT_RUN(method, code, regI, regO)                                                                     \
+   code = method->jitCode(regI, regO, method->code, (uint8*)method->jitCode + method->jitOffsets[code - method->code]);
+
+/// Counts an invocation or a loop iteration, compiling the method when the counter reaches JIT_THRESHOLD. The counter
+/// stops there, so a method that the jit rejects is never compiled again
+#define JIT_COUNT(method) (method->jitCounter < JIT_THRESHOLD && ++method->jitCounter == JIT_THRESHOLD && jitCompile(method))
+
+/// Called when a method starts: runs the compiled code, if any
+#define JIT_ENTER(method, code, regI, regO)                                                                   \
+   if (method->jitCode != null || JIT_COUNT(method))                                                         \
+      JIT_RUN(method, code, regI, regO)
+
+/// Jumps by the given offset. A jump backwards is a loop iteration, which enters the compiled code if the target was
+/// compiled: this is how a long loop started by the interpreter is switched to the native code, and how a loop goes
+/// back to it after the interpreter runs an instruction that the jit does not support
+#define JIT_JUMP(method, code, regI, regO, desloc)                                                            \
+   {                                                                                                          \
+      int32 _desloc = (int32)(desloc);                                                                        \
+      code += _desloc;                                                                                        \
+      if (_desloc <= 0 && (method->jitCode != null || JIT_COUNT(method)) && method->jitOffsets[code - method->code] >= 0) \
+         JIT_RUN(method, code, regI, regO)                                                                    \
+   }
+
+#else
+
+#define initJit() true
+#define destroyJit()
+#define JIT_ENTER(method, code, regI, regO)
+#define JIT_JUMP(method, code, regI, regO, desloc) code += (int32)(desloc);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -113,6 +113,63 @@ pointer to next):
     |  ^====<===+ ^===<===+ |
     +==>===========>========+
 
+
+  Young objects
+  ~~~~~~~~~~~~~
+
+Most objects die right after being created, so each Context owns a nursery: a block of
+NURSERY_SIZE bytes taken from the free list, where small objects are allocated by just
+bumping a pointer, without locking the omm mutex nor touching any list. A young object is
+not inserted in any list, so it is the only kind of object whose prev is null.
+
++-------+-------+-------+----------------------+
+| obj1  | obj2  | obj3  |         free         |
++-------+-------+-------+----------------------+
+^start                  ^top                   ^end
+
+When the nursery is full, it is retired and a new one is taken. Once NURSERY_MAX_RETIRED
+nurseries were retired, a minor collection runs: only the young objects are marked,
+using as roots the contexts, the static fields, the locked objects and the old objects
+in the remembered set. Old objects are assumed to be alive, so the ones that point to
+young objects must be known: WRITE_BARRIER adds to the remembered set each old object
+that receives a young one. Then the nurseries are swept linearly: the survivors are
+promoted to the used (or locked) list, and each run of dead objects becomes a single
+free object.
+
+Only the NEWOBJ and NEWARRAY instructions allocate young objects, through createYoungObject
+and createYoungArrayObject; the objects created by the natives are always old. So a native
+only needs the barrier when it stores an object that it did not create (usually one of its
+parameters), even in a locked object, since it may be unlocked before the next minor
+collection. If the remembered set fills up, that collection visits all the old objects.
+
+A full gc first promotes all young objects, so it runs exactly as described above.
+
+
+  Incremental marking
+  ~~~~~~~~~~~~~~~~~~~
+
+When VMTWEAK_INCREMENTAL_GC is on, running out of memory starts a marking cycle instead
+of a full gc. The used objects are moved to the white list (instead of the free list),
+and the roots are only pushed to the object stack (gray). The heap grows with new chunks
+while the cycle runs; every GC_SLICE_ALLOCS allocations, up to GC_SLICE_BUDGET pending
+objects are marked (moved back to the used list). This is the classic tri-color scheme:
+white objects are in the white list, gray ones are in the object stack and black ones are
+in the used list.
+
+A black object must never point to a white one, so storing a reference in a field or an
+array element calls WRITE_BARRIER, which grays the stored object. Registers and static
+fields have no barrier; they are visited again when the stack empties, by a gc2 that
+finds the cycle in progress: the white objects go to the free list and it continues as
+usual. If that gc2 is skipped (e.g., Vm.disableGC), the cycle is cancelled and the white
+objects go back to the used list. Objects unlocked during the cycle are black, and young
+objects are not allocated. Natives that store an object that they did not create in an
+unlocked object must also call WRITE_BARRIER (or gcWriteBarrier, from a native library).
+
+Since the owner thread bumps the pointer without the omm lock, the nursery state is
+changed with atomic exchanges: the owner sets it to BUSY while allocating, and a
+collector (which always holds the omm lock) sets it to NONE, waiting while it is BUSY.
+Objects whose class has a finalize method, and big objects, are never young.
+
 ****************************************************************************************/
 
 // debugging conditionals
@@ -154,6 +211,27 @@ void soundTone(int32 frequency, int32 duration);
 #define MIN_SPACE_LEFT 16
 #define OBJARRAY_MAX_INDEX 128 // 4,8,12,16....4*OBJARRAY_MAX_INDEX
 
+#define GC_SLICE_ALLOCS 64    // allocations between two incremental marking slices
+#define GC_SLICE_BUDGET 4096  // objects marked in each slice
+
+#define NURSERY_SIZE (16*1024)
+#define NURSERY_MAX_OBJ_SIZE (NURSERY_SIZE/8) // bigger objects go directly to the free list
+#define NURSERY_MAX_RETIRED 32 // number of full nurseries that triggers a minor collection
+#define REMEMBERED_SET_SIZE 4096 // must be a power of 2
+
+// nursery states, changed with NURSERY_XCHG
+#define NURSERY_NONE 0
+#define NURSERY_IDLE 1
+#define NURSERY_BUSY 2
+
+#if defined(WIN32)
+#define NURSERY_XCHG(p,v) InterlockedExchange((LONG volatile*)(p),(v))
+#define NURSERY_SET(p,v)  InterlockedExchange((LONG volatile*)(p),(v))
+#else
+#define NURSERY_XCHG(p,v) __sync_lock_test_and_set((p),(v))
+#define NURSERY_SET(p,v)  do {__sync_synchronize(); *(p) = (v);} while (0)
+#endif
+
 static int32 size2idx(int32 size) // size must exclude sizeof(TObjectProperties) !
 {
    int32 index;
@@ -189,6 +267,10 @@ static int32 countObjectsInList(TCObject o, bool dump, int32 mark, int32 *size);
 
 static Hashtable htP1, htP2;
 
+static TCObjectArray whiteList; // objects not yet reached in an incremental marking cycle
+static TCObjectArray condemnedList; // where the marked objects are taken from: freeList or whiteList
+static int32 allocsSinceSlice;
+
 #ifdef DEBUG_OMM_LIST
 static void dumpList(TCObject o, bool showSize)
 {
@@ -312,12 +394,10 @@ static bool createChunk(uint32 size)
    return true;
 }
 
-static Hashtable htObjsPerClass;
-
 bool initObjectMemoryManager()
 {
    int32 i,skip = sizeof(TObjectProperties), size = skip+TSIZE, n = OBJARRAY_MAX_INDEX+1;
-   uint8 *f, *u, *l;
+   uint8 *f, *u, *l, *w;
    ommHeap = heapCreate();
    chunksHeap = heapCreate();
    if (chunksHeap == null) return false;
@@ -330,18 +410,24 @@ bool initObjectMemoryManager()
    f = heapAlloc(ommHeap, size * n); // here we alloc the whole block of objects
    u = heapAlloc(ommHeap, size * n);
    l = heapAlloc(ommHeap, size * 1); // the locked list is a single array
+   w = heapAlloc(ommHeap, size * n);
    f += skip;
    u += skip;
    l += skip;
+   w += skip;
    freeList = newPtrArrayOf(TCObject,n,ommHeap);
    usedList = newPtrArrayOf(TCObject,n,ommHeap);
    lockList = newPtrArrayOf(TCObject,1,ommHeap);
+   whiteList = newPtrArrayOf(TCObject,n,ommHeap);
    lockList[0] = (TCObject)l;
    for (i =0; i < n; i++) // and now we just assign the starting pointer of each block
    {
       freeList[i] = (TCObject)f; f += size;
       usedList[i] = (TCObject)u; u += size;
+      whiteList[i] = (TCObject)w; w += size;
    }
+   condemnedList = freeList;
+   incrementalMarking = false;
    markedAsUsed = 1;
    objStack = newStack(2048, sizeof(TObjectsToVisit), null); // must be > 1k!
    return objStack != null && createChunk(DEFAULT_CHUNK_SIZE); // create the first chunk
@@ -350,7 +436,7 @@ bool initObjectMemoryManager()
 void destroyObjectMemoryManager()
 {
    if (IS_VMTWEAK_ON(VMTWEAK_DUMP_MEMORY_STATS))
-      debug("M Times gc was called: %d. Total gc time: %d. Chunks created: %d. Max allocated: %d",tcSettings.gcCount ? *tcSettings.gcCount : 0, tcSettings.gcTime ? *tcSettings.gcTime : 0, tcSettings.chunksCreated ? *tcSettings.chunksCreated : 1, maxAllocated);
+      debug("M Times gc was called: %d (minor: %d, incremental slices: %d). Total gc time: %d. Chunks created: %d. Max allocated: %d. Young objects promoted: %d",tcSettings.gcCount ? *tcSettings.gcCount : 0, minorGCCount, gcSlices, tcSettings.gcTime ? *tcSettings.gcTime : 0, tcSettings.chunksCreated ? *tcSettings.chunksCreated : 1, maxAllocated, youngPromoted);
    stackDestroy(objStack);
    heapDestroy(chunksHeap);
    heapDestroy(ommHeap);
@@ -374,13 +460,321 @@ static TCObject allocObjWith(uint32 size)
    return o;
 }
 
+static uint32 takeFreeObject(TCObject o, uint32 size) // removes the object from the free list, returning what remains of it to the list. Returns the final size
+{
+   uint32 oSize = OBJ_SIZE(o);
+   int32 objectBytesRemaining; // may be < 0 !
+
+   removeNodeFromDblList(freeList[size2idx(oSize)], o);
+   if (oSize > size)
+   {
+      objectBytesRemaining = (int32)oSize - (int32)size - sizeof(TObjectProperties);
+      if (objectBytesRemaining >= MIN_SPACE_LEFT) // is there enough space to create another minimum object?
+      {
+         // make the rest of this object a free object
+         Chunk startOfNextChunk = ((uint8*)o) + size;
+         TCObject oremain = CHUNK2OBJECT(startOfNextChunk);
+         uint32 ridx = size2idx(objectBytesRemaining);
+         xmemzero(OBJ_PROPERTIES(oremain),sizeof(TObjectProperties));
+         OBJ_SIZE(oremain) = objectBytesRemaining;
+         insertNodeInDblList(freeList[ridx], oremain);
+         if (_TRACE_OBJCREATION) debug("G Allocd: %5d. Remaining object: %X with size %d at index %d",size,oremain,objectBytesRemaining,ridx);
+      }
+      else size = oSize; // not enough memory remains in the object, so keep the old size
+   }
+   OBJ_SIZE(o) = size;
+   return size;
+}
+
+static void insertFreeBlock(uint8* start, uint8* end) // makes a free object that spans from start to end
+{
+   TCObject o = CHUNK2OBJECT(start);
+   xmemzero(start, sizeof(TObjectProperties));
+   OBJ_SIZE(o) = (uint32)(end - start) - sizeof(TObjectProperties);
+   insertNodeInDblList(freeList[size2idx(OBJ_SIZE(o))], o);
+}
+
+static void freeObjectMutex(TCObject o)
+{
+   VoidP monitor;
+   if ((OBJ_PROPERTIES(o)->classAndMonitor & OBJ_MONITOR_MASK) != MONITOR_INFLATED) // only inflated monitors are in htMutexes
+      return;
+   LOCKVAR(mutexes);
+   monitor = htGetPtr(&htMutexes, (HTKey)o);
+   if (monitor)
+   {
+      htRemove(&htMutexes, (HTKey)o);
+      freeMutex(0, monitor);
+   }
+   UNLOCKVAR(mutexes);
+   OBJ_SETCLASS(o, OBJ_CLASS(o)); // the finalizer may still synchronize on it
+}
+
+/////////////////////////////////////  Young objects  /////////////////////////////////////
+
+typedef struct
+{
+   uint8 *start, *end;
+} TYoungRegion;
+
+static TYoungRegion retiredNurseries[NURSERY_MAX_RETIRED + MAX_CONTEXTS]; // there's at most one nursery per context besides the retired ones
+static int32 retiredCount;
+static bool markingYoung; // true while a minor collection is marking objects
+static Hashtable htObjsPerClass;
+
+// old objects that received a young one since the last minor collection. An open addressing hash set, so an object
+// that is changed in a loop is added once. It is never more than 3/4 full: more objects than that make it overflow
+static TCObject rememberedSet[REMEMBERED_SET_SIZE];
+static int32 rememberedCount;
+static bool rememberedOverflow;
+
+static void rememberObject(TCObject o) // omm must be locked
+{
+   uint32 i = ((uint32)(size_t)o >> 3) & (REMEMBERED_SET_SIZE-1);
+   if (rememberedOverflow)
+      return;
+   for (; rememberedSet[i] != null; i = (i+1) & (REMEMBERED_SET_SIZE-1))
+      if (rememberedSet[i] == o)
+         return;
+   if (rememberedCount == REMEMBERED_SET_SIZE/4*3)
+      rememberedOverflow = true;
+   else
+   {
+      rememberedSet[i] = o;
+      rememberedCount++;
+   }
+}
+
+static void clearRememberedSet() // called when there are no young objects left
+{
+   if (rememberedCount > 0)
+      xmemzero(rememberedSet, sizeof(rememberedSet));
+   rememberedCount = 0;
+   rememberedOverflow = false;
+}
+
+static void sweepYoungRegion(uint8* block, uint8* blockEnd, bool promoteAll) // all objects are promoted if promoteAll is true; otherwise, only the marked ones
+{
+   uint8* freeStart = null;
+   bool traceCreatedClassObjs = IS_VMTWEAK_ON(VMTWEAK_TRACE_CREATED_CLASSOBJS) && htObjsPerClass.items;
+   while (block < blockEnd)
+   {
+      ObjectProperties op = (ObjectProperties)block;
+      TCObject o = CHUNK2OBJECT(block);
+      uint32 size = op->size;
+      objCreated++;
+      if (promoteAll || op->lock || op->mark == markedAsUsed)
+      {
+         if (freeStart != null)
+         {
+            insertFreeBlock(freeStart, block);
+            freeStart = null;
+         }
+         op->mark = !markedAsUsed;
+         if (op->lock)
+         {
+            insertNodeInDblList(lockList[0], o);
+            objLocked++;
+         }
+         else
+            insertNodeInDblList(usedList[size2idx(size)], o);
+         youngPromoted++;
+      }
+      else
+      {
+         if (_TRACE_OBJDESTRUCTION) debug("G young object being freed: %X (%s)",o, OBJ_CLASS(o)->name);
+         if (traceCreatedClassObjs) htInc(&htObjsPerClass, (int32)OBJ_CLASS(o),-1);
+         freeObjectMutex(o);
+         if (freeStart == null)
+            freeStart = block;
+      }
+      block += sizeof(TObjectProperties) + size;
+   }
+   if (freeStart != null)
+      insertFreeBlock(freeStart, blockEnd);
+}
+
+static void retireNursery(Context c) // omm must be locked
+{
+   int32 state;
+   while ((state = NURSERY_XCHG(&c->nurseryState, NURSERY_NONE)) == NURSERY_BUSY) // the owner thread is allocating an object; wait it finish
+      Sleep(0);
+   if (state == NURSERY_IDLE)
+   {
+      uint8 *start = c->nurseryStart, *top = c->nurseryTop, *end = c->nurseryEnd;
+      c->nurseryStart = c->nurseryTop = c->nurseryEnd = null;
+      if (top != end) // give back the unused part. allocYoung ensures that it fits at least a minimum object
+         insertFreeBlock(top, end);
+      if (top == start)
+         return;
+      if (retiredCount == NURSERY_MAX_RETIRED + MAX_CONTEXTS) // can occur if many threads die between two collections
+         sweepYoungRegion(start, top, true);
+      else
+      {
+         retiredNurseries[retiredCount].start = start;
+         retiredNurseries[retiredCount].end = top;
+         retiredCount++;
+      }
+   }
+}
+
+static void retireAllNurseries()
+{
+   int32 i;
+   Context c;
+   for (i = 0; i < MAX_CONTEXTS; i++)
+      if ((c = contexts[i]) != null)
+         retireNursery(c);
+}
+
+static void promoteYoungObjects() // called by the full gc, that then runs as if no young object exists
+{
+   TYoungRegion* r;
+   retireAllNurseries();
+   for (r = retiredNurseries; retiredCount > 0; retiredCount--, r++)
+      sweepYoungRegion(r->start, r->end, true);
+   clearRememberedSet();
+}
+
+static void markObjects(TCObject o, bool dump);
+static void markPendingObjects(bool dump);
+static void markSlice(Context currentContext);
+static void startIncrementalMark(Context currentContext);
+static void pushObjectFields(TCObject o, TCClass c);
+static void markClass(int32 i32, VoidP ptr);
+static void markContexts();
+
+static void collectYoung() // minor collection. omm must be locked
+{
+   int32 i,iniT = getTimeStamp();
+   TCObjectArray usedL;
+   TCObject o;
+   TYoungRegion* r;
+   uint32 promoted0 = youngPromoted;
+
+   retireAllNurseries();
+   if (retiredCount == 0)
+      return;
+   runningGC = markingYoung = true;
+   // 1. mark the young objects reachable from the static fields and the contexts
+   if (CANTRAVERSE)
+      htTraverse(&htLoadedClasses, markClass);
+   markContexts();
+   // 2. the old objects are considered alive, so the fields of the ones that received young objects are roots too
+   if (rememberedOverflow) // too many of them: visit all
+   {
+      for (i = 0, usedL = usedList; i <= OBJARRAY_MAX_INDEX; i++, usedL++)
+         for (o = OBJ_PROPERTIES(*usedL)->next; o != null; o = OBJ_PROPERTIES(o)->next)
+         {
+            pushObjectFields(o, OBJ_CLASS(o));
+            markPendingObjects(false);
+         }
+      for (o = OBJ_PROPERTIES(*lockList)->next; o != null; o = OBJ_PROPERTIES(o)->next)
+      {
+         pushObjectFields(o, OBJ_CLASS(o));
+         markPendingObjects(false);
+      }
+   }
+   else
+   for (i = 0; i < REMEMBERED_SET_SIZE; i++)
+      if ((o = rememberedSet[i]) != null)
+      {
+         pushObjectFields(o, OBJ_CLASS(o));
+         markPendingObjects(false);
+      }
+   // 3. and so are the locked young objects
+   for (i = 0, r = retiredNurseries; i < retiredCount; i++, r++)
+   {
+      uint8* block;
+      for (block = r->start; block < r->end; block += sizeof(TObjectProperties) + ((ObjectProperties)block)->size)
+         if (((ObjectProperties)block)->lock)
+            markObjects(CHUNK2OBJECT(block), false);
+   }
+   markingYoung = false;
+   // 4. promote the survivors and free the others
+   for (r = retiredNurseries; retiredCount > 0; retiredCount--, r++)
+      sweepYoungRegion(r->start, r->end, false);
+   clearRememberedSet();
+   minorGCCount++;
+   runningGC = false;
+   if (COMPUTETIME) debug("G minor gc %d: %d objects promoted, elapsed: %d", minorGCCount, youngPromoted - promoted0, getTimeStamp() - iniT);
+}
+
+static bool refillNursery(Context c)
+{
+   TCObject o;
+   bool ok = false;
+   LOCKVAR(omm);
+   retireNursery(c);
+   if (incrementalMarking) // the marking cycle needs all objects in the lists
+   {
+      UNLOCKVAR(omm);
+      return false;
+   }
+   if (retiredCount >= NURSERY_MAX_RETIRED)
+      collectYoung();
+   if ((o = allocObjWith(NURSERY_SIZE)) != null) // if there's no free block big enough, the caller falls back to the free list, which may run the gc or create a chunk
+   {
+      uint32 size = takeFreeObject(o, NURSERY_SIZE);
+      c->nurseryStart = c->nurseryTop = (uint8*)OBJECT2CHUNK(o);
+      c->nurseryEnd = ((uint8*)o) + size;
+      NURSERY_SET(&c->nurseryState, NURSERY_IDLE);
+      ok = true;
+   }
+   UNLOCKVAR(omm);
+   return ok;
+}
+
+static TCObject allocYoung(Context c, uint32 size, TCClass cls, int32 alen) // size must be already aligned
+{
+   uint32 total = sizeof(TObjectProperties) + size, left;
+   int32 state;
+   uint8* top;
+   TCObject o;
+   ObjectProperties op;
+
+   if ((state = NURSERY_XCHG(&c->nurseryState, NURSERY_BUSY)) != NURSERY_IDLE || (uint32)(c->nurseryEnd - c->nurseryTop) < total)
+   {
+      NURSERY_SET(&c->nurseryState, state);
+      if (!refillNursery(c) || NURSERY_XCHG(&c->nurseryState, NURSERY_BUSY) != NURSERY_IDLE) // the nursery may had been taken by a collector, but this is very unlikely
+      {
+         NURSERY_SET(&c->nurseryState, NURSERY_NONE);
+         return null;
+      }
+   }
+   top = c->nurseryTop;
+   left = (uint32)(c->nurseryEnd - top) - total;
+   if (left > 0 && left < sizeof(TObjectProperties) + MIN_SPACE_LEFT) // not enough space to create another minimum object, so keep it in this one
+   {
+      size += left;
+      total += left;
+   }
+   xmemzero(top, total);
+   op = (ObjectProperties)top;
+   o = CHUNK2OBJECT(top);
+   op->size = size;
+   op->lock = 1; // objects are always locked
+   op->mark = !markedAsUsed;
+   if (alen >= 0) ARRAYOBJ_LEN(o) = alen;
+   op->classAndMonitor = (size_t)cls;
+   c->nurseryTop = top + total;
+   NURSERY_SET(&c->nurseryState, NURSERY_IDLE);
+   return o;
+}
+
+void releaseNursery(Context c)
+{
+   LOCKVAR(omm);
+   retireNursery(c);
+   UNLOCKVAR(omm);
+}
+
 extern bool iosLowMemory;
 static int32 consecutiveSkips;
 
-static TCObject allocObject(Context currentContext, uint32 size, TCClass cls, int32 alen)
+static TCObject allocObject(Context currentContext, uint32 size, TCClass cls, int32 alen, bool young) // young objects are allocated only if young is true
 {
    TCObject o = null;
-   ObjectProperties op;
 
 #ifdef darwin
    if (iosLowMemory/* && size > 1024*/)
@@ -405,64 +799,56 @@ static TCObject allocObject(Context currentContext, uint32 size, TCClass cls, in
       size = TSIZE;
    size = ((size+TSIZE-1)>>TSHIFT)<<TSHIFT; // make power of SIZE_T
 
+   if (young && size <= NURSERY_MAX_OBJ_SIZE && currentContext != null && cls->finalizeMethod == null && (o = allocYoung(currentContext, size, cls, alen)) != null)
+      return o;
+
    LOCKVAR(omm);
+   if (incrementalMarking && ++allocsSinceSlice >= GC_SLICE_ALLOCS)
+      markSlice(currentContext);
    o = allocObjWith(size);
    if (!o) // no more memory to create this object? Run the GC to free up memory
    {
-      if (size < 1024*1024 || ++consecutiveSkips > 16)
+      if (!incrementalMarking && (size < 1024*1024 || ++consecutiveSkips > 16)) // while marking, memory is only released when the cycle ends
       {
          #ifndef ENABLE_TEST_SUITE // test suite requires that no gc is run in this case - just create the chunk directly
-         gc2(currentContext,false);
-         o = allocObjWith(size);
+         if (IS_VMTWEAK_ON(VMTWEAK_INCREMENTAL_GC))
+            startIncrementalMark(currentContext); // the chunk created below is used until the cycle ends
+         else
+         {
+            gc2(currentContext,false);
+            o = allocObjWith(size);
+         }
          #endif
       }
       if (!o)
       {
+         bool created = createChunk(size > DEFAULT_CHUNK_SIZE ? size : DEFAULT_CHUNK_SIZE);
+         if (!created && incrementalMarking) // no more memory while marking: finish the cycle now
+         {
+            gc2(currentContext,false);
+            created = (o = allocObjWith(size)) != null || createChunk(size > DEFAULT_CHUNK_SIZE ? size : DEFAULT_CHUNK_SIZE);
+         }
          // still no memory? allocate a new chunk and place it at the OBJARRAY_MAX_INDEX
-         if (!createChunk(size > DEFAULT_CHUNK_SIZE ? size : DEFAULT_CHUNK_SIZE))
+         if (!created)
          {
             if (COMPUTETIME) alert("out of memory!");
             throwException(currentContext, OutOfMemoryError, null);
             goto end; // no more memory at all, quit.
          }
-         o = allocObjWith(size);
+         if (!o)
+            o = allocObjWith(size);
       }
    }
    // found a free object?
    if (o)
    {
-      uint32 oSize, oldIdx;
-      int32 objectBytesRemaining; // may be < 0 !
-      op = OBJ_PROPERTIES(o);
-      oSize = OBJ_SIZE(o);
-      oldIdx = size2idx(oSize);
-
       objCreated++;
-      //debug("G alloc obj size %d : %X (idx %d -> %d)",size, o, oldIdx,newIdx);
+      //debug("G alloc obj size %d : %X",size, o);
       // set as not marked
       OBJ_MARK(o) = !markedAsUsed;
       if (_TRACE_OBJCREATION) debug("G %X setting mark to %d at allocObject", o, OBJ_MARK(o));
       // remove the Object from the free list
-      removeNodeFromDblList(freeList[oldIdx], o);
-
-      if (oSize > size)
-      {
-         objectBytesRemaining = (int32)oSize - (int32)size - sizeof(TObjectProperties);
-         if (objectBytesRemaining >= MIN_SPACE_LEFT) // is there enough space to create another minimum object?
-         {
-            // make the rest of this object a free object
-            Chunk startOfNextChunk = ((uint8*)o) + size;
-            TCObject oremain = CHUNK2OBJECT(startOfNextChunk);
-            uint32 ridx = size2idx(objectBytesRemaining);
-            xmemzero(OBJ_PROPERTIES(oremain),sizeof(TObjectProperties));
-            OBJ_SIZE(oremain) = objectBytesRemaining;
-            insertNodeInDblList(freeList[ridx], oremain);
-            if (_TRACE_OBJCREATION) debug("G Allocd: %5d. Remaining object: %X with size %d at index %d. lock: %d. context: %X",size,oremain,objectBytesRemaining,ridx,OBJ_ISLOCKED(oremain),currentContext);
-            // and put it in the used list
-         }
-         else size = oSize; // not enough memory remains in the object, so keep the old size
-      }
-      OBJ_SIZE(o) = size;
+      size = takeFreeObject(o, size);
 
       // objects are always locked
       OBJ_SETLOCKED(o);
@@ -473,14 +859,14 @@ static TCObject allocObject(Context currentContext, uint32 size, TCClass cls, in
       // erase the object.
       xmemzero(o, size);
       if (alen >= 0) ARRAYOBJ_LEN(o) = alen;
-      OBJ_CLASS(o) = cls;
+      OBJ_SETCLASS(o, cls); // a recycled chunk may keep the monitor bits of the object freed there
    }
 end:
    UNLOCKVAR(omm);
    return o;
 }
 
-static TCObject privateCreateObject(Context currentContext, CharP className, bool callDefaultConstructor)
+static TCObject privateCreateObject(Context currentContext, CharP className, bool callDefaultConstructor, bool young)
 {
    TCClass c;
    uint32 objectSize;
@@ -491,7 +877,7 @@ static TCObject privateCreateObject(Context currentContext, CharP className, boo
       goto end;
 
    objectSize = c->objSize;
-   o = allocObject(currentContext, objectSize, c, -1);
+   o = allocObject(currentContext, objectSize, c, -1, young);
    if (!o)
       goto end;
    if (IS_VMTWEAK_ON(VMTWEAK_TRACE_CREATED_CLASSOBJS))
@@ -515,15 +901,20 @@ end:
 
 TC_API TCObject createObjectWithoutCallingDefaultConstructor(Context currentContext, CharP className)
 {
-   return privateCreateObject(currentContext, className, false);
+   return privateCreateObject(currentContext, className, false, false);
 }
 
 TC_API TCObject createObject(Context currentContext, CharP className)
 {
-   return privateCreateObject(currentContext, className, true);
+   return privateCreateObject(currentContext, className, true, false);
 }
 
-TCObject createArrayObject(Context currentContext, CharP type, int32 len)
+TCObject createYoungObject(Context currentContext, CharP className)
+{
+   return privateCreateObject(currentContext, className, false, true);
+}
+
+static TCObject privateCreateArrayObject(Context currentContext, CharP type, int32 len, bool young)
 {
    TCClass c;
    uint32 arraySize, objectSize;
@@ -537,7 +928,7 @@ TCObject createArrayObject(Context currentContext, CharP type, int32 len)
       goto end;
    arraySize = TC_ARRAYSIZE(c,len);
    objectSize = TSIZE + arraySize; // there's a single instance field in the Array class: length
-   o = allocObject(currentContext, objectSize, c, len);
+   o = allocObject(currentContext, objectSize, c, len, young);
    if (!o)
       goto end;
    if (IS_VMTWEAK_ON(VMTWEAK_TRACE_CREATED_CLASSOBJS))
@@ -550,6 +941,16 @@ end:
    return o;
 }
 
+TCObject createArrayObject(Context currentContext, CharP type, int32 len)
+{
+   return privateCreateArrayObject(currentContext, type, len, false);
+}
+
+TCObject createYoungArrayObject(Context currentContext, CharP type, int32 len)
+{
+   return privateCreateArrayObject(currentContext, type, len, true);
+}
+
 TCObject createByteArrayObject(Context currentContext, int32 len, const char *file, int32 line)
 {
    TCObject o = createArrayObject(currentContext, BYTE_ARRAY, len);
@@ -642,13 +1043,20 @@ TC_API void setObjectLock(TCObject o, LockState lock)
    LOCKVAR(omm);
    size = OBJ_SIZE(o);
    idx = size2idx(size);
+   if (OBJ_ISYOUNG(o)) // young objects are not in any list, and are counted as locked only when promoted
+   {
+      if (OBJ_ISLOCKED(o) == (lock == LOCKED))
+         alert("FATAL ERROR: YOUNG OBJECT %X (%s) IS ALREADY %s!", o, OBJ_CLASS(o)->name, lock == LOCKED ? "LOCKED" : "UNLOCKED");
+      OBJ_PROPERTIES(o)->lock = lock == LOCKED;
+   }
+   else
    if (lock == LOCKED)
    {
       if (OBJ_ISLOCKED(o))
          alert("FATAL ERROR: OBJECT %X (%s) IS BEING LOCKED BUT IT IS ALREADY LOCKED!", o, OBJ_CLASS(o)->name);
       OBJ_SETLOCKED(o);
-      // remove from the used list
-      removeNodeFromDblList(usedList[idx], o);
+      // remove from the used list (or from the white list, if it was not reached yet by an incremental marking)
+      removeNodeFromDblList(incrementalMarking && OBJ_MARK(o) != markedAsUsed ? whiteList[idx] : usedList[idx], o);
       insertNodeInDblList(lockList[0], o);
       objLocked++;
    }
@@ -663,6 +1071,11 @@ TC_API void setObjectLock(TCObject o, LockState lock)
       objLocked--;
    }
    OBJ_MARK(o) = !markedAsUsed;
+   if (incrementalMarking && lock == UNLOCKED && !OBJ_ISYOUNG(o)) // objects in the used list must be black while marking
+   {
+      OBJ_MARK(o) = markedAsUsed;
+      pushObjectFields(o, OBJ_CLASS(o));
+   }
    //if (_TRACE_OBJCREATION) debug("G %s object %X class %s. mark: %d",lock == LOCKED ? "locking" : "unlocking", o, OBJ_CLASS(o)->name, OBJ_MARK(o));
    UNLOCKVAR(omm);
 }
@@ -671,7 +1084,6 @@ CharP getSpaces(Context currentContext, int32 n);
 static void markSingleObject(TCObject o, bool dump) // NEVER call this directly, unless the Object has no instance fields nor is an array
 {
    TCClass c;
-   TObjectsToVisit objs;
    if (OBJ_PROPERTIES(o) == null)
    {
       debug("****** props is null: %X",o);
@@ -684,12 +1096,14 @@ static void markSingleObject(TCObject o, bool dump) // NEVER call this directly,
       debug("****** class is null: %X",o);
       return;
    }
+   if (markingYoung && !OBJ_ISYOUNG(o)) // in a minor collection, the old objects are roots, so they were already visited
+      return;
    if (OBJ_MARK(o) == markedAsUsed) // don't remove! this test is important
       return;
    // mark as used to avoid infinite recursion
    OBJ_MARK(o) = markedAsUsed;
    //if (_TRACE_OBJCREATION) debug("G %X setting mark to %d at markSingleObject", o, OBJ_MARK(o));
-   if (!OBJ_ISLOCKED(o)) // locked objects can't be revived, since they are not in the used/free lists
+   if (!OBJ_ISLOCKED(o) && !markingYoung) // locked and young objects can't be revived, since they are not in the used/free lists
    {
       // "revive" the object
       int32 size,idx;
@@ -698,11 +1112,17 @@ static void markSingleObject(TCObject o, bool dump) // NEVER call this directly,
       size = OBJ_SIZE(o);
       idx = size2idx(size);
       // remove from the free list
-      removeNodeFromDblList(freeList[idx], o);
+      removeNodeFromDblList(condemnedList[idx], o);
       // and put it in the used list
       insertNodeInDblList(usedList[idx], o);
       if (_TRACE_OBJCREATION) debug("G Object revived: %X (%s). mark: %d",o, OBJ_CLASS(o)->name, OBJ_MARK(o));
    }
+   pushObjectFields(o, c);
+}
+
+static void pushObjectFields(TCObject o, TCClass c)
+{
+   TObjectsToVisit objs;
    // if this object is an array, and the elements are objects (or arrays), then push them to be marked later
    if (c->flags.isObjectArray) // array of objects or array of arrays?
    {
@@ -721,17 +1141,25 @@ static void markSingleObject(TCObject o, bool dump) // NEVER call this directly,
 
 static void markObjects(TCObject o, bool dump)
 {
-   TObjectsToVisit objs;
-
    if (!o) return; // can occurr if concorrent threads are accessing the structure where this object is
    markSingleObject(o,dump);
+   if (!incrementalMarking) // otherwise, the object is left gray, to be visited by the next slice
+      markPendingObjects(dump);
+}
 
-   // Here we will mark recursively all objects inside this one.
+static bool markPendingObjectsUpTo(int32 budget) // marks up to budget objects (or all of them if budget is < 0). Returns true if there are no more objects to mark
+{
+   TObjectsToVisit objs;
+   TCObject o;
+
+   // Here we will mark recursively all objects inside the ones pushed.
    // First we go through all fields and array values (if applicable),
    // marking them, and pushing them to the recurse buffer.
    // Then we pop each and do the recursion.
-   while (stackPop(objStack, &objs))
+   while (budget-- != 0)
    {
+      if (!stackPop(objStack, &objs))
+         return true;
       do
       {
          o = *objs.start++;
@@ -739,8 +1167,15 @@ static void markObjects(TCObject o, bool dump)
       if (objs.n > 0) // if there still more objects to visit, push the structure back.
          stackPush(objStack, &objs);
       if (o != null)
-         markSingleObject(o,dump);
+         markSingleObject(o,false);
    }
+   return false;
+}
+
+static void markPendingObjects(bool dump)
+{
+   UNUSED(dump)
+   markPendingObjectsUpTo(-1);
 }
 
 static void markClass(int32 i32, VoidP ptr)
@@ -814,7 +1249,7 @@ static bool joinAdjacentObjects(uint8* block, uint32 size)
    while (block < blockEnd)
    {
       op = (ObjectProperties)block;
-      if (/*op->next == null || */op->class_ != null) // not empty object? skip  - guich@tc113_19: commented first part. since the blocks are added FIFO, retaining that block is not good. the idea here was to keep the first memory block created, but since the block was created for the constant pool strings, and these are locked, this comparison is uneeded.
+      if (/*op->next == null || */op->classAndMonitor != 0) // not empty object? skip  - guich@tc113_19: commented first part. since the blocks are added FIFO, retaining that block is not good. the idea here was to keep the first memory block created, but since the block was created for the constant pool strings, and these are locked, this comparison is uneeded.
       {
          usedCount++;
          if (COMPUTETIME) usedSize += op->size+sizeof(TObjectProperties);
@@ -834,7 +1269,7 @@ static bool joinAdjacentObjects(uint8* block, uint32 size)
             if (block >= blockEnd)
                break;
             op = (ObjectProperties)block;
-            if (op->class_ != null) // if next is not free, stop
+            if (op->classAndMonitor != 0) // if next is not free, stop
             {
                usedCount++;
                if (COMPUTETIME) usedSize += op->size+sizeof(TObjectProperties);
@@ -904,20 +1339,88 @@ static void markContexts()
       }
 }
 
+static void startIncrementalMark(Context currentContext) // omm must be locked
+{
+   int32 i,iniT = getTimeStamp();
+   TCObject o;
+   if (disableGC || IS_VMTWEAK_ON(VMTWEAK_DISABLE_GC) || destroyingApplication)
+      return;
+   runningGC = true;
+   promoteYoungObjects();
+   // 1. all used objects become white
+   for (i = 0; i <= OBJARRAY_MAX_INDEX; i++)
+      if (OBJ_PROPERTIES(usedList[i])->next != null)
+         moveDblList(usedList[i], whiteList[i]);
+   condemnedList = whiteList;
+   incrementalMarking = true;
+   allocsSinceSlice = 0;
+   // 2. and the roots become gray (markObjects won't go deeper while incrementalMarking is true)
+   if (CANTRAVERSE)
+      htTraverse(&htLoadedClasses, markClass);
+   for (o = OBJ_PROPERTIES(*lockList)->next; o != null; o = OBJ_PROPERTIES(o)->next)
+      markObjects(o,false);
+   markContexts();
+   runningGC = false;
+   if (COMPUTETIME) debug("G ====  INCREMENTAL GC INI: roots pushed in %d ms", getTimeStamp() - iniT);
+}
+
+static void markSlice(Context currentContext) // omm must be locked
+{
+   int32 iniT = getTimeStamp();
+   bool done;
+   runningGC = true;
+   allocsSinceSlice = 0;
+   done = markPendingObjectsUpTo(GC_SLICE_BUDGET);
+   runningGC = false;
+   gcSlices++;
+   if (COMPUTETIME) debug("G incremental slice %d: %d ms", gcSlices, getTimeStamp() - iniT);
+   if (done) // revisit the roots and release the white objects
+      gc2(currentContext, false);
+}
+
+static void cancelIncrementalMark() // used when the gc that would end the cycle is skipped. omm must be locked
+{
+   int32 i;
+   TObjectsToVisit objs;
+   TCObject o;
+   incrementalMarking = false;
+   condemnedList = freeList;
+   while (stackPop(objStack, &objs)) // the gray objects are dropped
+      ;
+   // the white objects go back to the used list, and all of them are unmarked again, as the next gc expects
+   for (i = 0; i <= OBJARRAY_MAX_INDEX; i++)
+   {
+      if (OBJ_PROPERTIES(whiteList[i])->next != null)
+         moveDblList(whiteList[i], usedList[i]);
+      for (o = OBJ_PROPERTIES(usedList[i])->next; o != null; o = OBJ_PROPERTIES(o)->next)
+         OBJ_MARK(o) = !markedAsUsed;
+   }
+   for (o = OBJ_PROPERTIES(*lockList)->next; o != null; o = OBJ_PROPERTIES(o)->next)
+      OBJ_MARK(o) = !markedAsUsed;
+}
+
+TC_API void gcWriteBarrier(TCObject owner, TCObject o)
+{
+   if (o == null)
+      return;
+   LOCKVAR(omm);
+   if (incrementalMarking)
+   {
+      if (OBJ_MARK(o) != markedAsUsed)
+         markSingleObject(o,false); // the object is now gray
+   }
+   else
+   if (owner != null && OBJ_ISYOUNG(o) && !OBJ_ISYOUNG(owner)) // checked again, since a minor collection may had promoted them
+      rememberObject(owner);
+   UNLOCKVAR(omm);
+}
+
 static void finalizeObject(TCObject o, TCClass c)
 {
    TCClass c0 = c;
    while (c != null) 
    {
-      MUTEX_TYPE* mutex;
-
-      mutex = htGetPtr(&htMutexes, (int32)o);
-      if (mutex)
-      {
-         DESTROY_MUTEX_VAR(*mutex);
-         xfree(mutex);
-         htRemove(&htMutexes, (int32)o);         
-      }
+      freeObjectMutex(o);
 
       if (c->finalizeMethod == null) 
          c = c->superClass;
@@ -1062,6 +1565,8 @@ void gc2(Context currentContext, bool lockOMM)
    if (disableGC || (IS_VMTWEAK_ON(VMTWEAK_DISABLE_GC) && freemem > CRITICAL_SIZE)) // use an agressive gc if memory is under 2MB - guich@tc114_18: let user control gc runs
    {
       skippedGC++;
+      if (incrementalMarking)
+         cancelIncrementalMark();
       if (COMPUTETIME) 
          debug("G ====  GC SKIPPED");
       if (lockOMM) UNLOCKVAR(omm);
@@ -1072,11 +1577,14 @@ void gc2(Context currentContext, bool lockOMM)
    //debug("gc %d (%dms / %d bytes)",tcSettings.gcCount ? *tcSettings.gcCount : 0,elapsed,freemem);
    if (destroyingApplication)
    {
+      if (incrementalMarking)
+         cancelIncrementalMark();
       UNLOCKVAR(omm);
       return;
    }
 
    runningGC = true;
+   promoteYoungObjects(); // from now on, all objects are in the lists
 
    traceCreatedClassObjs = IS_VMTWEAK_ON(VMTWEAK_TRACE_CREATED_CLASSOBJS) && htObjsPerClass.items;
    if (IS_VMTWEAK_ON(VMTWEAK_AUDIBLE_GC))
@@ -1105,6 +1613,16 @@ heaperror:
    }
 
    // 1. move the list of used objects to the free list
+   if (incrementalMarking) // finishing an incremental cycle: the used list has the black objects, so only the white ones are moved
+   {
+      incrementalMarking = false;
+      for (freeL=freeList, usedL=whiteList, i=0; i <= OBJARRAY_MAX_INDEX; i++, freeL++,usedL++)
+         if (OBJ_PROPERTIES(*usedL)->next != null)
+            moveDblList(*usedL, *freeL);
+      condemnedList = freeList;
+      markPendingObjects(false); // the gray ones
+   }
+   else
    for (freeL=freeList, usedL=usedList, i=0; i <= OBJARRAY_MAX_INDEX; i++, freeL++,usedL++)
       if (OBJ_PROPERTIES(*usedL)->next != null)
          moveDblList(*usedL, *freeL);
@@ -1173,7 +1691,7 @@ heaperror:
             {
                if (_TRACE_OBJCREATION) debug("G object being freed: %X (%s)",o, OBJ_CLASS(o)->name);
                if (traceCreatedClassObjs) htInc(&htObjsPerClass, (int32)OBJ_CLASS(o),-1);
-               OBJ_CLASS(o) = null; // set the object "free"
+               OBJ_SETCLASS(o, null); // set the object "free"
             }
    currentContext->litebasePtr = gcContext->litebasePtr; // update the ptr
    if (COMPUTETIME) debug("G finished finalizers");
@@ -29,6 +29,10 @@ TC_API TCObject createArrayObject(Context currentContext, CharP type, int32 len)
 typedef TCObject (*createArrayObjectFunc)(Context currentContext, CharP type, int32 len);
 TC_API TCObject createArrayObjectMulti(Context currentContext, CharP type, int32 count, uint8* dims, int32* regI); // always call passing target as a held variable!
 typedef TCObject (*createArrayObjectMultiFunc)(Context currentContext, CharP type, int32 count, uint8* dims, int32* regI); // always call passing target as a held variable!
+/// Same of createObjectWithoutCallingDefaultConstructor, but the object may be young. Only NEWOBJ uses it: see WRITE_BARRIER
+TCObject createYoungObject(Context currentContext, CharP className);
+/// Same of createArrayObject, but the array may be young. Only NEWARRAY uses it: see WRITE_BARRIER
+TCObject createYoungArrayObject(Context currentContext, CharP type, int32 len);
 /// only allocate space, you must transfer the char array by your own
 TC_API TCObject createStringObjectWithLen(Context currentContext, int32 len);
 typedef TCObject (*createStringObjectWithLenFunc)(Context currentContext, int32 len);
@@ -64,6 +68,8 @@ typedef void (*gcFunc)(Context currentContext);
 bool initObjectMemoryManager();
 void destroyObjectMemoryManager();
 void runFinalizers();
+/// Gives the context's nursery back to the memory manager. Called when the context is deleted
+void releaseNursery(Context c);
 void visitImages(VisitElementFunc onImage, int32 param);
 
 /// Changes the object lock state, in a NON-RECURSIVE way.
@@ -74,9 +80,23 @@ void visitImages(VisitElementFunc onImage, int32 param);
 TC_API void setObjectLock(TCObject o, LockState lock);
 typedef void (*setObjectLockFunc)(TCObject o, LockState lock);
 
+/// Grays o (which may be null) if an incremental gc is marking, or remembers the owner if it is old and o is young.
+/// Use WRITE_BARRIER instead
+TC_API void gcWriteBarrier(TCObject owner, TCObject o);
+typedef void (*gcWriteBarrierFunc)(TCObject owner, TCObject o);
+/// Must be used before storing o in a field or an array element of owner (which is null for static fields)
+#define WRITE_BARRIER(owner,o) do                                              \
+{                                                                              \
+   TCObject _wbOwner = (owner), _wbObj = (o);                                  \
+   if (_wbObj != null && (incrementalMarking ||                                \
+       (OBJ_ISYOUNG(_wbObj) && _wbOwner != null && !OBJ_ISYOUNG(_wbOwner))))   \
+      gcWriteBarrier(_wbOwner, _wbObj);                                        \
+} while (0)
+
 /// Returns a pointer to the Object properties given an Object
 #define OBJ_PROPERTIES(o) ((ObjectProperties)(((uint8*)(o))-sizeof(TObjectProperties)))
 #define OBJ_ISLOCKED(o)     (OBJ_PROPERTIES(o)->lock  == 1)
+#define OBJ_ISYOUNG(o)      (OBJ_PROPERTIES(o)->prev == null) // young objects are not in any list
 
 /** A Java Object is a Class instance.
  *
@@ -89,23 +109,24 @@ typedef void (*setObjectLockFunc)(TCObject o, LockState lock);
  */
 struct TObjectProperties
 {
-   TCClass class_;
+   volatile size_t classAndMonitor; // the object's class; the monitor state used by synchronized is kept in its 2 lower bits (see tcthread.h)
    TCObject next,prev;
    struct
    {
       uint32 size: 30; // object's size
       uint32 lock: 1;  // lock the object, preventing it from being gc'd. The initial purpose of locking an object was to lock all constant pool strings and speedup the garbage collector process.
       uint32 mark: 1;  // mark the object during a garbage collect.
-#if TBITS==64
-      uint32 dumb;
-#endif
    };
 };
 
 typedef uint8* Chunk;
 
+/// The bits of classAndMonitor that keep the monitor state. Classes are allocated with at least 4-byte alignment
+#define OBJ_MONITOR_MASK ((size_t)3)
 /// Returns the Class of a given Object
-#define OBJ_CLASS(o) OBJ_PROPERTIES(o)->class_ // get class from an object
+#define OBJ_CLASS(o) ((TCClass)(OBJ_PROPERTIES(o)->classAndMonitor & ~OBJ_MONITOR_MASK)) // get class from an object
+/// Sets the Class of a given Object, also resetting its monitor to unlocked. Use only when the object is created or freed
+#define OBJ_SETCLASS(o,c) OBJ_PROPERTIES(o)->classAndMonitor = (size_t)(c)
 
 /// Gets the length of a Java array Object. The array's type is stored in the OBJ_CLASS(o)->name ("[&B","[java.lang.String", etc)
 #define ARRAYOBJ_LEN(o) ((o)->arrayLen)
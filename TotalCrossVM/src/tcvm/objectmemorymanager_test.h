@@ -5,6 +5,7 @@
 
 static bool saveRestoreOMM(bool save)
 {
+   promoteYoungObjects(); // the nurseries belong to the lists being saved or destroyed
    if (save)
    {
       CANTRAVERSE = false;
@@ -389,3 +390,95 @@ TESTCASE(GarbageCollector) // #5
    finish:
    saveRestoreOMM(false);
 }
+
+TESTCASE(YoungObjects) // #DEPENDS(GarbageCollector)
+{
+   int32 nused;
+   TCObjectArray held = currentContext->regOStart;
+   TCObject old,young1,young2;
+   TCClass byteArrayClass;
+   uint32 minor0 = minorGCCount;
+
+   if (!saveRestoreOMM(true))
+   {
+      alert("Not enough memory to\nrun YoungObjects\ntest case.\nAborting tests!");
+      TEST_ABORT;
+   }
+   old = allocAndFillObj(currentContext,4,1); // the objects created by the natives are never young
+   byteArrayClass = OBJ_CLASS(old);
+   *held++ = old;
+   // 1. young objects are allocated one after the other
+   young1 = allocYoung(currentContext,8,byteArrayClass,8);
+   young2 = allocYoung(currentContext,8,byteArrayClass,8);
+   ASSERT1_EQUALS(NotNull, young1);
+   ASSERT1_EQUALS(NotNull, young2);
+   ASSERT1_EQUALS(True, OBJ_ISYOUNG(young1));
+   ASSERT1_EQUALS(True, OBJ_ISLOCKED(young1));
+   ASSERT2_EQUALS(Ptr, (uint8*)young2, (uint8*)young1 + 8 + sizeof(TObjectProperties));
+   setObjectLock(young1, UNLOCKED);
+   setObjectLock(young2, UNLOCKED);
+   // 2. only the held young object survives a minor collection
+   *held++ = young1;
+   currentContext->regO = held;
+   collectYoung();
+   nused = countObjectsIn(usedList,false,false,!markedAsUsed,null);
+   ASSERT2_EQUALS(I32, 2, nused); // old and young1
+   ASSERT1_EQUALS(False, OBJ_ISYOUNG(young1));
+   ASSERT2_EQUALS(I32, minor0 + 1, minorGCCount);
+
+   finish:
+   currentContext->regO = currentContext->regOStart;
+   saveRestoreOMM(false);
+}
+
+TESTCASE(MinorCollections) // #DEPENDS(YoungObjects)
+{
+   TCObjectArray held = currentContext->regOStart;
+   TCObjectArray elems;
+   TCObject old,young;
+   uint32 minor0 = minorGCCount;
+   int32 i, n = 0, last[4] = {0};
+
+   if (!saveRestoreOMM(true))
+   {
+      alert("Not enough memory to\nrun MinorCollections\ntest case.\nAborting tests!");
+      TEST_ABORT;
+   }
+   // 1. an old array, reachable only from a register
+   old = createArrayObject(currentContext, "[java.lang.Object", 4);
+   ASSERT1_EQUALS(NotNull, old);
+   ASSERT1_EQUALS(False, OBJ_ISYOUNG(old));
+   setObjectLock(old, UNLOCKED);
+   *held++ = old;
+   currentContext->regO = held;
+   elems = (TCObjectArray)ARRAYOBJ_START(old);
+   // 2. allocate young garbage through several minor collections, keeping some young objects only in the old array
+   while (minorGCCount < minor0 + 3 && n < 1000000)
+   {
+      young = createYoungArrayObject(currentContext, BYTE_ARRAY, 32);
+      ASSERT1_EQUALS(NotNull, young);
+      setObjectLock(young, UNLOCKED);
+      xmemset(ARRAYOBJ_START(young), (uint8)n, 32);
+      if ((n & 255) == 0)
+      {
+         i = (n >> 8) & 3;
+         WRITE_BARRIER(old, young);
+         elems[i] = young;
+         last[i] = n;
+      }
+      n++;
+   }
+   ASSERT1_EQUALS(True, minorGCCount >= minor0 + 3);
+   ASSERT1_EQUALS(False, rememberedOverflow); // so only the remembered set kept them
+   // 3. the kept objects survived, and their memory was not reused
+   for (i = 0; i < 4; i++)
+   {
+      ASSERT1_EQUALS(NotNull, elems[i]);
+      ASSERT1_EQUALS(NotNull, OBJ_CLASS(elems[i]));
+      ASSERT3_EQUALS(Filled, ARRAYOBJ_START(elems[i]), 32, (uint8)last[i]);
+   }
+
+   finish:
+   currentContext->regO = currentContext->regOStart;
+   saveRestoreOMM(false);
+}
@@ -166,6 +166,14 @@
 #define MONITOR_Exit         157
 #define MONITOR_Enter2       158
 #define MONITOR_Exit2        159
-#define OPCODE_LENGTH        160 // last opcode + 1
+// superinstructions: never stored in the tcz files, they replace the first instruction of a pair when the method is loaded (see fuseInstructions).
+// The second instruction is kept untouched, so a jump to it still works
+#define MOV_regI_field_JEQ_regI_s6      160
+#define MOV_regI_field_JNE_regI_s6      161
+#define MOV_regI_arc_MOV_regI_arc       162
+#define MOV_regI_aru_ADD_regI_regI_regI 163
+#define INC_regI_JLT_regI_regI          164
+#define INC_regI_JUMP_s24               165
+#define OPCODE_LENGTH        166 // last opcode + 1
 
 #endif
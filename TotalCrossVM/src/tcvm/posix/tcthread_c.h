@@ -61,6 +61,42 @@ static void privateThreadDestroy(ThreadHandle h, bool threadDestroyingItself)
 #endif
 }
 
+static bool privateInitParker(TParker* p)
+{
+   p->permit = false;
+   if (pthread_mutex_init(&p->mutex, null) != 0)
+      return false;
+   if (pthread_cond_init(&p->cond, null) != 0)
+   {
+      pthread_mutex_destroy(&p->mutex);
+      return false;
+   }
+   return true;
+}
+
+static void privateDestroyParker(TParker* p)
+{
+   pthread_cond_destroy(&p->cond);
+   pthread_mutex_destroy(&p->mutex);
+}
+
+static void privatePark(TParker* p)
+{
+   pthread_mutex_lock(&p->mutex);
+   while (!p->permit)
+      pthread_cond_wait(&p->cond, &p->mutex);
+   p->permit = false;
+   pthread_mutex_unlock(&p->mutex);
+}
+
+static void privateUnpark(TParker* p)
+{
+   pthread_mutex_lock(&p->mutex);
+   p->permit = true;
+   pthread_cond_signal(&p->cond);
+   pthread_mutex_unlock(&p->mutex);
+}
+
 static VoidP privateThreadFunc(VoidP argP)
 {
    ThreadArgs targs = (ThreadArgs)argP;
@@ -182,7 +182,8 @@ void readConstantPool(Context currentContext, ConstantPool t, TCZFile tcz, Heap
          }
       }
       t->boundNormal = (MethodPtrArray)newArray(sizeof(Method), t->mtdCount, heap);
-      t->boundVirtualMethod = (MethodAndClassPtrArray)newArray(TSIZE, t->mtdCount, heap);
+      t->boundVirtualMethod = (MethodPtrArray)newArray(sizeof(Method), t->mtdCount, heap);
+      t->boundInterfaceMethod = (MethodPtrArray)newArray(sizeof(Method), t->mtdCount, heap);
    }
 
    partSize = tczRead32(tcz);
@@ -367,6 +368,280 @@ static CharP createMethodSignature(Method m, Heap h)
    return hstrdup(fn, h);
 }
 
+/***********************************************/
+/**             SUPERINSTRUCTIONS             **/
+/***********************************************/
+
+// pairs replaced by a superinstruction: first, second, fused. Build the vm with TRACK_OPCODE_PAIRS to find the most frequent pairs of a workload
+static uint8 fusedPairs[][3] =
+{
+   {MOV_regI_field, JEQ_regI_s6,        MOV_regI_field_JEQ_regI_s6},
+   {MOV_regI_field, JNE_regI_s6,        MOV_regI_field_JNE_regI_s6},
+   {MOV_regI_arc,   MOV_regI_arc,       MOV_regI_arc_MOV_regI_arc},
+   {MOV_regI_aru,   ADD_regI_regI_regI, MOV_regI_aru_ADD_regI_regI_regI},
+   {INC_regI,       JLT_regI_regI,      INC_regI_JLT_regI_regI},
+   {INC_regI,       JUMP_s24,           INC_regI_JUMP_s24},
+};
+#define FUSED_PAIRS_COUNT ((int32)(sizeof(fusedPairs) / sizeof(fusedPairs[0])))
+
+int32 unfusedOpcode(int32 op)
+{
+   int32 i;
+   for (i = 0; i < FUSED_PAIRS_COUNT; i++)
+      if (fusedPairs[i][2] == op)
+         return fusedPairs[i][0];
+   return op;
+}
+
+// returns the number of TCodes used by the instruction, or 0 if it can't be known when the class is loaded
+static int32 instructionLength(ConstantPool cp, Code c)
+{
+   int32 n;
+   switch (c->op.op)
+   {
+      case CALL_normal:
+      case CALL_virtual:
+         n = cp->mtdLens[c->mtd.sym];
+         if ((n & 3) == 1) // the parameters skipped also depend on the return type, which is only known when the method is bound
+            return 0;
+         return 1 + ((3 + n) >> 2);
+      case SWITCH:
+         n = c->switch_reg.n;
+         return 2 + n + ((n + 1) >> 1);
+      case NEWARRAY_multi:
+         return 1 + ((c->newarray.lenOrRegIOrDims + 3) >> 2);
+      default:
+         return 1;
+   }
+}
+
+// returns the target of a jump instruction at the given pc, or -1 if it isn't one
+static int32 jumpTarget(Code c, int32 pc)
+{
+   switch (c->op.op)
+   {
+      case JEQ_regO_regO: case JEQ_regO_null: case JEQ_regI_regI: case JEQ_regL_regL: case JEQ_regD_regD:
+      case JNE_regO_regO: case JNE_regO_null: case JNE_regI_regI: case JNE_regL_regL: case JNE_regD_regD:
+      case JLT_regI_regI: case JLT_regL_regL: case JLT_regD_regD:
+      case JLE_regI_regI: case JLE_regL_regL: case JLE_regD_regD:
+      case JGT_regI_regI: case JGT_regL_regL: case JGT_regD_regD:
+      case JGE_regI_regI: case JGE_regL_regL: case JGE_regD_regD:
+         return pc + c->reg_reg_s12.s12;
+      case JEQ_regI_s6: case JNE_regI_s6: case JLT_regI_s6: case JLE_regI_s6: case JGT_regI_s6: case JGE_regI_s6:
+         return pc + c->reg_s6_desloc.desloc;
+      case JEQ_regI_sym: case JNE_regI_sym:
+         return pc + c->reg_sym_sdesloc.desloc;
+      case JGE_regI_arlen:
+         return pc + c->reg_arl_s12.desloc;
+      case DECJGTZ_regI: case DECJGEZ_regI:
+         return pc + c->reg_desloc.desloc;
+      case JUMP_s24:
+         return pc + c->s24.desloc;
+      default:
+         return -1;
+   }
+}
+
+// returns true if the instruction at pc may continue at an instruction in [from,to]
+static bool jumpsInto(Code code, int32 pc, int32 from, int32 to)
+{
+   Code c = code + pc;
+   int32 t, n;
+   uint16* addrs;
+   if (c->op.op == SWITCH)
+   {
+      n = c->switch_reg.n;
+      addrs = (uint16*)((int32*)(c+2) + n);
+      t = pc + c[1].two16.v1;
+      if (from <= t && t <= to)
+         return true;
+      while (n-- > 0)
+         if (from <= (t = pc + *addrs++) && t <= to)
+            return true;
+      return false;
+   }
+   t = jumpTarget(c, pc);
+   return from <= t && t <= to;
+}
+
+/* Stores in wI and wO the regI and regO written by the instruction (or -1), returning false if the instruction is not
+ * one of the simple ones allowed in the body of a loop whose bounds checks are removed. */
+static bool getWrittenRegs(Code c, int32* wI, int32* wO)
+{
+   *wI = *wO = -1;
+   switch (c->op.op)
+   {
+      case MOV_regI_regI: case CONV_regIb_regI: case CONV_regIc_regI: case CONV_regIs_regI: case CONV_regI_regL: case CONV_regI_regD:
+         *wI = c->reg_reg.reg0; break;
+      case MOV_regI_field:
+         *wI = c->field_reg.reg; break;
+      case MOV_regI_static:
+         *wI = c->static_reg.reg; break;
+      case MOV_regI_sym:
+         *wI = c->reg_sym.reg; break;
+      case MOV_regI_s18:
+         *wI = c->s18_reg.reg; break;
+      case MOV_regI_arlen: case MOV_regI_arc: case MOV_regI_aru: case MOV_regIb_arc: case MOV_regIb_aru: case MOV_reg16_arc: case MOV_reg16_aru:
+         *wI = c->reg_ar.reg; break;
+      case ADD_regI_regI_regI: case SUB_regI_regI_regI: case MUL_regI_regI_regI: case DIV_regI_regI_regI: case MOD_regI_regI_regI:
+      case SHR_regI_regI_regI: case SHL_regI_regI_regI: case USHR_regI_regI_regI: case AND_regI_regI_regI: case OR_regI_regI_regI: case XOR_regI_regI_regI:
+         *wI = c->reg_reg_reg.reg0; break;
+      case ADD_regI_s12_regI: case SUB_regI_s12_regI: case MUL_regI_regI_s12: case DIV_regI_regI_s12: case MOD_regI_regI_s12:
+      case SHR_regI_regI_s12: case SHL_regI_regI_s12: case USHR_regI_regI_s12: case AND_regI_regI_s12: case OR_regI_regI_s12: case XOR_regI_regI_s12:
+         *wI = c->reg_reg_s12.reg0; break;
+      case ADD_regI_regI_sym:
+         *wI = c->reg_reg_sym.reg0; break;
+      case ADD_regI_arc_s6: case ADD_regI_aru_s6: case AND_regI_aru_s6:
+         *wI = c->reg_s6_ar.reg; break;
+      case INC_regI:
+         *wI = c->inc.reg; break;
+      case DECJGTZ_regI: case DECJGEZ_regI:
+         *wI = c->reg_desloc.reg; break;
+      case MOV_regO_regO:
+         *wO = c->reg_reg.reg0; break;
+      case MOV_regO_field:
+         *wO = c->field_reg.reg; break;
+      case MOV_regO_static:
+         *wO = c->static_reg.reg; break;
+      case MOV_regO_sym:
+         *wO = c->reg_sym.reg; break;
+      case MOV_regO_arc: case MOV_regO_aru:
+         *wO = c->reg_ar.reg; break;
+      case MOV_regO_null:
+         *wO = c->reg.reg; break;
+      // instructions that don't write on regI nor regO
+      case MOV_reg64_reg64: case MOV_reg64_field: case MOV_reg64_static: case MOV_reg64_arc: case MOV_reg64_aru:
+      case MOV_regD_sym: case MOV_regL_sym: case MOV_regD_s18: case MOV_regL_s18:
+      case MOV_field_regI: case MOV_field_regO: case MOV_field_reg64: case MOV_static_regI: case MOV_static_regO: case MOV_static_reg64:
+      case MOV_arc_regI: case MOV_arc_regO: case MOV_arc_reg64: case MOV_arc_regIb: case MOV_arc_reg16:
+      case MOV_aru_regI: case MOV_aru_regO: case MOV_aru_reg64: case MOV_aru_regIb: case MOV_aru_reg16: case ADD_aru_regI_s6:
+      case ADD_regD_regD_regD: case ADD_regL_regL_regL: case SUB_regD_regD_regD: case SUB_regL_regL_regL: case MUL_regD_regD_regD: case MUL_regL_regL_regL:
+      case DIV_regD_regD_regD: case DIV_regL_regL_regL: case MOD_regD_regD_regD: case MOD_regL_regL_regL:
+      case SHR_regL_regL_regL: case SHL_regL_regL_regL: case USHR_regL_regL_regL: case AND_regL_regL_regL: case OR_regL_regL_regL: case XOR_regL_regL_regL:
+      case CONV_regL_regI: case CONV_regL_regD: case CONV_regD_regI: case CONV_regD_regL: case TEST_regO:
+         break;
+      default:
+         if (jumpTarget(c, 0) == -1) // the jumps are checked by the caller
+            return false;
+   }
+   return true;
+}
+
+// returns the unchecked version of an array access, or -1 if it is not a checked one
+static int32 uncheckedArrayOpcode(int32 op)
+{
+   switch (op)
+   {
+      case MOV_regI_arc:    return MOV_regI_aru;
+      case MOV_regO_arc:    return MOV_regO_aru;
+      case MOV_reg64_arc:   return MOV_reg64_aru;
+      case MOV_regIb_arc:   return MOV_regIb_aru;
+      case MOV_reg16_arc:   return MOV_reg16_aru;
+      case MOV_arc_regI:    return MOV_aru_regI;
+      case MOV_arc_regO:    return MOV_aru_regO;
+      case MOV_arc_reg64:   return MOV_aru_reg64;
+      case MOV_arc_regIb:   return MOV_aru_regIb;
+      case MOV_arc_reg16:   return MOV_aru_reg16;
+      case ADD_regI_arc_s6: return ADD_regI_aru_s6;
+      default:              return -1;
+   }
+}
+
+/* Removes the bounds checks of a simple counted loop that starts at h:
+ *    MOV_regI_s18 i, k (k >= 0)
+ * h: JGE_regI_arlen i, a, exit
+ *    ... body ...
+ *    JUMP_s24 h
+ * exit:
+ * If nothing else enters the loop, the body has no backward jumps (other than to h), and changes neither a nor i
+ * (except with INC_regI i, 1), then 0 <= i < a.length holds in the body until i is incremented, and a is not null,
+ * since JGE_regI_arlen would have failed otherwise. */
+static void removeLoopBoundsChecks(Method m, Code code, int32 n, uint8* starts, int32 h)
+{
+   Code c = code + h;
+   int32 i = c->reg_arl_s12.regI, a = c->reg_arl_s12.base, exit = h + c->reg_arl_s12.desloc, b = exit - 1;
+   int32 pc, t, op, wI, wO;
+   ExceptionArray ex;
+
+   if (h == 0 || b <= h || exit > n || !starts[b] || code[b].op.op != JUMP_s24 || b + code[b].s24.desloc != h)
+      return;
+   if (!starts[h-1] || code[h-1].op.op != MOV_regI_s18 || code[h-1].s18_reg.reg != i || code[h-1].s18_reg.s18 < 0)
+      return;
+   // nothing else can enter the loop
+   for (pc = 0; pc < n; pc++)
+      if (starts[pc] && (pc < h || pc > b) && jumpsInto(code, pc, h, b))
+         return;
+   for (t = ARRAYLENV(m->exceptionHandlers), ex = m->exceptionHandlers; t-- > 0; ex++)
+      if (code + h <= ex->handlerPC && ex->handlerPC <= code + b)
+         return;
+   // check the body
+   for (pc = h+1; pc < b; pc++)
+      if (starts[pc])
+      {
+         c = code + pc;
+         if ((t = jumpTarget(c, pc)) >= 0 && t < pc && t != h)
+            return;
+         if (!getWrittenRegs(c, &wI, &wO) || wO == a || (wI == i && (c->op.op != INC_regI || c->inc.s16 != 1)))
+            return;
+      }
+   // the checks of a[i] can be removed until i is incremented
+   for (pc = h+1; pc < b; pc++)
+      if (starts[pc])
+      {
+         c = code + pc;
+         if (c->op.op == INC_regI)
+         {
+            if (c->inc.reg == i)
+               break;
+         }
+         else
+         if ((op = uncheckedArrayOpcode(c->op.op)) >= 0)
+         {
+            if (c->op.op == ADD_regI_arc_s6 ? (c->reg_s6_ar.base == a && c->reg_s6_ar.idx == i) : (c->reg_ar.base == a && c->reg_ar.idx == i))
+               c->op.op = op;
+         }
+      }
+}
+
+/* Rewrites the code of a method that was just loaded: removes the redundant bounds checks of simple counted loops, then
+ * replaces the first instruction of the pairs in fusedPairs by a superinstruction. The code can't shrink, so the second
+ * instruction of a pair is kept: the superinstruction continues on it without a dispatch, and a jump to it still works. */
+void fuseInstructions(ConstantPool cp, Method m)
+{
+   int32 n = ARRAYLENV(m->code), pc, len, i;
+   Code code = m->code;
+   uint8* starts;
+   bool decoded = true, computedJump = false;
+
+   if (n < 2 || (starts = (uint8*)xmalloc(n)) == null)
+      return;
+   // find where each instruction starts
+   for (pc = 0; pc < n; pc += len)
+   {
+      if ((len = instructionLength(cp, code + pc)) == 0)
+      {
+         decoded = false; // from here on, we can't tell instructions from parameters
+         break;
+      }
+      starts[pc] = 1;
+      if (code[pc].op.op == JUMP_regI)
+         computedJump = true;
+   }
+   if (decoded && !computedJump) // the loop analysis needs to know all the jump targets
+      for (pc = 1; pc < n; pc++)
+         if (starts[pc] && code[pc].op.op == JGE_regI_arlen)
+            removeLoopBoundsChecks(m, code, n, starts, pc);
+   for (pc = 0; pc < n-1; pc++)
+      if (starts[pc] && starts[pc+1])
+         for (i = 0; i < FUSED_PAIRS_COUNT; i++)
+            if (code[pc].op.op == fusedPairs[i][0] && code[pc+1].op.op == fusedPairs[i][1])
+            {
+               code[pc].op.op = fusedPairs[i][2];
+               break;
+            }
+   xfree(starts);
+}
+
 #define ALL_1 255
 
 static void readMethod(ConstantPool cp, TCZFile tcz, Method m, TCClass c)
@@ -485,6 +760,8 @@ static void readMethod(ConstantPool cp, TCZFile tcz, Method m, TCClass c)
       m->nativeSignature = createMethodSignature(m, tcz->tempHeap);
    if (m->cpReturn > 0)
       m->returnReg = getRegType(cp, m->cpReturn);
+   if (m->code != null)
+      fuseInstructions(cp, m);
 }
 
 static FieldArray readFields(ConstantPool cp, int32 len, TCZFile tcz, FieldArray super, CharP sourceClass) // sourceClass: numeric fields must pass the source class, object fields must pass null
@@ -515,7 +792,180 @@ static FieldArray readFields(ConstantPool cp, int32 len, TCZFile tcz, FieldArray
    return f0;
 }
 
-static TCClass readClass(Context currentContext, ConstantPool cp, TCZFile tcz)
+/***********************************************/
+/**           VTABLES AND ITABLES             **/
+/***********************************************/
+
+// same as paramsEq, but for two already loaded methods
+static bool sameSignature(Method m1, Method m2)
+{
+   ConstantPool cp1, cp2;
+   UInt16Array p1, p2;
+   int32 n, s1, s2;
+
+   if (m1 == m2)
+      return true;
+   if (m1->hashName != m2->hashName || m1->hashParams != m2->hashParams || m1->paramCount != m2->paramCount || !strEq(m1->name, m2->name))
+      return false;
+   cp1 = m1->class_->cp;
+   cp2 = m2->class_->cp;
+   for (p1 = m1->cpParams, p2 = m2->cpParams, n = m1->paramCount; n-- > 0;)
+   {
+      s1 = *p1++;
+      s2 = *p2++;
+      if (((cp1 == cp2) || (s1 < DEFAULT_CONSTANTS_LEN && s2 < DEFAULT_CONSTANTS_LEN)) && s1 == s2)
+         continue;
+      if (!strEq(cp1->cls[s1], cp2->cls[s2]))
+         return false;
+   }
+   return true;
+}
+
+// constructors and static initializers have their names starting with <
+#define IS_VIRTUAL_METHOD(m) (!(m)->flags.isStatic && !(m)->flags.isPrivate && *(m)->name != '<')
+#define NEW_VTABLE_INDEX (NO_VTABLE_INDEX-1) // a method that does not override an inherited one, while its slot is not known
+
+Method findVirtualMethod(MethodPtrArray vtable, Method m)
+{
+   int32 i;
+   for (i = ARRAYLENV(vtable); i-- > 0;) // the newest methods are at the end
+      if (sameSignature(vtable[i], m))
+         return vtable[i];
+   return null;
+}
+
+Method getInterfaceMethod(TCClass c, Method m)
+{
+   ITable it = c->itables;
+   int32 n;
+   for (n = ARRAYLENV(it); n-- > 0; it++)
+      if (it->interface_ == m->class_)
+         return m->vtableIndex < ARRAYLENV(it->methods) ? it->methods[m->vtableIndex] : null;
+   return null;
+}
+
+static void addInterface(TCClass* list, int32* n, TCClass iface)
+{
+   int32 i;
+   for (i = *n; i-- > 0;)
+      if (list[i] == iface)
+         return;
+   list[(*n)++] = iface;
+}
+
+// returns true if c declares a method of the given interface
+static bool declaresInterfaceMethod(TCClass c, TCClass iface)
+{
+   Method m;
+   int32 i;
+   for (m = c->methods, i = ARRAYLENV(c->methods); i-- > 0; m++)
+      if (m->vtableIndex != NO_VTABLE_INDEX && findVirtualMethod(iface->vtable, m) != null)
+         return true;
+   return false;
+}
+
+/* Builds the vtable and the itables of a class being loaded, and returns the memory used by them.
+ * The vtable of a class starts with a copy of its superclass' one; the methods that override an
+ * inherited one reuse its slot, and the other ones are appended. The vtable of an interface holds
+ * the methods of its super interfaces followed by its own, and its itables just list the super interfaces.
+ * A class has an itable for each interface implemented by it or by its superclasses, which is shared
+ * with the superclass when this class does not implement any of the interface's methods. */
+int32 buildVirtualTables(TCClass c, Heap heap)
+{
+   MethodPtrArray superVT = c->superClass != null && !c->flags.isInterface ? c->superClass->vtable : null;
+   ITableArray superIT = c->superClass != null ? c->superClass->itables : null;
+   TCClass* ifaces;
+   TCClass iface;
+   ITable it;
+   Method m, sm;
+   int32 i, j, k, n, count, bytes = 0;
+
+   // 1. the vtable
+   count = ARRAYLENV(superVT);
+   if (c->flags.isInterface)
+      for (i = ARRAYLENV(c->interfaces); i-- > 0;)
+         count += ARRAYLENV(c->interfaces[i]->vtable);
+   for (m = c->methods, i = ARRAYLENV(c->methods); i-- > 0; m++)
+      if (!IS_VIRTUAL_METHOD(m))
+         m->vtableIndex = NO_VTABLE_INDEX;
+      else
+      if (superVT != null && (sm = findVirtualMethod(superVT, m)) != null)
+         m->vtableIndex = sm->vtableIndex;
+      else
+      {
+         m->vtableIndex = NEW_VTABLE_INDEX;
+         count++;
+      }
+   if (count > 0)
+   {
+      c->vtable = (MethodPtrArray)newArray(sizeof(Method), count, heap);
+      n = ARRAYLENV(superVT);
+      if (n > 0)
+         xmemmove(c->vtable, superVT, n * sizeof(Method));
+      if (c->flags.isInterface) // the methods of the super interfaces, without duplicates
+         for (i = 0; i < ARRAYLENV(c->interfaces); i++)
+            for (iface = c->interfaces[i], j = 0; j < ARRAYLENV(iface->vtable); j++)
+            {
+               for (k = n; k-- > 0;)
+                  if (c->vtable[k] == iface->vtable[j])
+                     break;
+               if (k < 0)
+                  c->vtable[n++] = iface->vtable[j];
+            }
+      for (m = c->methods, i = ARRAYLENV(c->methods); i-- > 0; m++)
+         if (m->vtableIndex != NO_VTABLE_INDEX)
+         {
+            if (m->vtableIndex == NEW_VTABLE_INDEX)
+               m->vtableIndex = (uint16)n++;
+            c->vtable[m->vtableIndex] = m;
+         }
+      SET_ARRAYLEN(c->vtable) = n; // duplicated super interface methods leave some unused slots at the end
+      bytes += TSIZE + count * sizeof(Method);
+   }
+
+   // 2. the itables
+   count = ARRAYLENV(superIT);
+   for (i = ARRAYLENV(c->interfaces); i-- > 0;)
+      count += 1 + ARRAYLENV(c->interfaces[i]->itables);
+   if (count > 0 && (ifaces = (TCClass*)xmalloc(count * sizeof(TCClass))) != null)
+   {
+      n = 0;
+      for (i = 0; i < ARRAYLENV(superIT); i++)
+         addInterface(ifaces, &n, superIT[i].interface_);
+      for (i = 0; i < ARRAYLENV(c->interfaces); i++)
+      {
+         iface = c->interfaces[i];
+         addInterface(ifaces, &n, iface);
+         for (j = 0; j < ARRAYLENV(iface->itables); j++)
+            addInterface(ifaces, &n, iface->itables[j].interface_);
+      }
+      c->itables = newArrayOf(ITable, n, heap);
+      bytes += TSIZE + n * sizeof(TITable);
+      for (i = 0, it = c->itables; i < n; i++, it++)
+      {
+         it->interface_ = iface = ifaces[i];
+         if (c->flags.isInterface || iface->vtable == null)
+            continue;
+         for (j = ARRAYLENV(superIT); j-- > 0;)
+            if (superIT[j].interface_ == iface)
+               break;
+         if (j >= 0 && !declaresInterfaceMethod(c, iface))
+            it->methods = superIT[j].methods;
+         else
+         {
+            k = ARRAYLEN(iface->vtable);
+            it->methods = (MethodPtrArray)newArray(sizeof(Method), k, heap);
+            while (--k >= 0)
+               it->methods[k] = findVirtualMethod(c->vtable, iface->vtable[k]);
+            bytes += TSIZE + ARRAYLEN(iface->vtable) * sizeof(Method);
+         }
+      }
+      xfree(ifaces);
+   }
+   return bytes;
+}
+
+TCClass readClass(Context currentContext, ConstantPool cp, TCZFile tcz)
 {
    int32 i, j, superI32, superObj, superV64, totalI32, totalObj, totalV64;
    uint16 u16;
@@ -636,6 +1086,9 @@ static TCClass readClass(Context currentContext, ConstantPool cp, TCZFile tcz)
    if (c->finalizeMethod == null && c->superClass != null) // if no finalize methods are defined in this class, inherit it from the super class
       c->finalizeMethod = c->superClass->finalizeMethod;
    //if (c->dontFinalize == null && c->superClass != null) c->dontFinalize = c->superClass->dontFinalize;
+   i = buildVirtualTables(c, heap);
+   if (IS_VMTWEAK_ON(VMTWEAK_DUMP_MEMORY_STATS))
+      debug("M vtable of %s: %d slots, %d itables, %d bytes", c->name, ARRAYLENV(c->vtable), ARRAYLENV(c->itables), i);
    return c;
 }
 
@@ -709,7 +1162,8 @@ TCClass loadClass(Context currentContext, CharP className, bool throwClassNotFou
          int32 fr = getFreeMemory(false);
          debug("**** READING CLASS %s", realClassName);
 #endif
-         ret = readClass(currentContext, tcz->header->cp, tcz);
+         if (!restoreClass(currentContext, tcz, realClassName, (TCClass*)&ret))
+            ret = readClass(currentContext, tcz->header->cp, tcz);
          tczClose(tcz);
 #ifdef TRACE_OBJCREATION
          debug("**** putting class %s in hashtable. Consumed: %d ****", realClassName, getFreeMemory(false)-fr);
@@ -377,6 +377,9 @@ typedef struct
 
 /// Definition of a NativeMethod: returns void and receives a NMParams structure.
 typedef void (*NativeMethod) (NMParams p);
+/// Native code generated by the jit for a method: receives the method's code and the native code of the instruction where it must
+/// start, runs it and returns the instruction where the interpreter must resume.
+typedef Code (*JitCode) (int32* regI, TCObject* regO, Code code, uint8* entry);
 
 /** Used to find the method reference on a virtual method call. */
 typedef struct METHOD_AND_CLASS // guich@tc110_67: create a linked list of bound methods
@@ -385,7 +388,14 @@ typedef struct METHOD_AND_CLASS // guich@tc110_67: create a linked list of bound
    Method m; // out
    struct METHOD_AND_CLASS* next;
 } TMethodAndClass, *MethodAndClass;
-typedef MethodAndClass** MethodAndClassPtrArray;
+
+#define INLINE_CACHE_SIZE 4 // classes cached per call site. A call site that sees more classes is megamorphic, and uses only the vtable
+
+/** Caches the methods called by a CALL_virtual opcode, for the last classes of "this" */
+typedef struct
+{
+   MethodAndClass entries[INLINE_CACHE_SIZE]; // filled in order and never replaced, so they can be read without locking
+} TInlineCache, *InlineCache;
 
 /** This is the constant pool (CP) loaded from a file. A CP may be related
  * to a single file or to a set of files.
@@ -408,7 +418,8 @@ struct TConstantPool
    UInt16Array boundIField;
    VoidPArray boundSField;  // will store a pointer directly to the static field inside the class
    MethodPtrArray boundNormal;
-   MethodAndClassPtrArray boundVirtualMethod;
+   MethodPtrArray boundVirtualMethod; // a method with the vtable slot of the called one
+   MethodPtrArray boundInterfaceMethod; // the called interface method, dispatched through the itables
 
    uint16 i32Count;
    uint16 i64Count;
@@ -461,6 +472,17 @@ struct TException
 #define FIELD_I64(o,c,idx) (((int64*)(FIELD_V64_OFFSET(o,c)))[idx])  // i64 and dbl point to the same structure
 #define FIELD_DBL(o,c,idx) (((double*)(FIELD_V64_OFFSET(o,c)))[idx])
 
+/// vtableIndex of the methods that are not dispatched through the vtable: static, private, constructors and static initializers
+#define NO_VTABLE_INDEX 0xFFFF
+
+/** The methods of a class that implement an interface, in the same order of the interface's vtable */
+typedef struct
+{
+   TCClass interface_;
+   MethodPtrArray methods; // null for the itables of an interface, which only list its super interfaces
+} TITable, *ITable;
+typedef TITable* ITableArray;
+
 /** This structure represents a Java class. */
 struct TTCClass
 {
@@ -506,6 +528,10 @@ struct TTCClass
    uint32 hash;
    // Used in reflection
    TCObject classObj;
+   // The virtual methods: the inherited ones, with the overridden slots replaced, followed by the new ones. For interfaces, the methods of the super interfaces followed by its own
+   MethodPtrArray vtable;
+   // One entry for each interface implemented by this class or by its superclasses
+   ITableArray itables;
 };
 
 /** Structure representing a method of a class. */
@@ -538,6 +564,16 @@ struct TMethod
    CharP nativeSignature; // 0x3C
    NativeMethod boundNM; // 0x40
    uint32 ref; // library reference
+   // The inline caches of the CALL_virtual opcodes, indexed by the opcode's position in the code. Created in the first cache miss
+   InlineCache* inlineCaches;
+   // The slot of this method in the class' vtable, or NO_VTABLE_INDEX
+   uint16 vtableIndex;
+   // Number of invocations and loop iterations, used to decide when the method is compiled. Stops at JIT_THRESHOLD
+   uint16 jitCounter;
+   // The native code of this method, if it was compiled
+   JitCode jitCode;
+   // The offset of each instruction in jitCode, or -1 if it was not compiled
+   int32* jitOffsets;
 };
 
 /** This structure represents a Java int, double, long and TCObject class field. */
@@ -627,6 +663,16 @@ bool paramsEq(ConstantPool cp1, UInt16Array params1, int32 n1, ConstantPool cp2,
 
 Type type2javaType(CharP type);
 bool isSuperClass(TCClass s, TCClass t);
+/// Returns the method of class c that implements the interface method m, or null if c does not implement it
+Method getInterfaceMethod(TCClass c, Method m);
+/// Returns the method of the given class' vtable that has the same signature of m, or null if none
+Method findVirtualMethod(MethodPtrArray vtable, Method m);
+/// Builds the vtable and the itables of a class being loaded, once its superclass, interfaces and methods are set. Returns the memory used
+int32 buildVirtualTables(TCClass c, Heap heap);
+/// Removes redundant bounds checks and replaces frequent pairs of instructions by superinstructions in the code of a loaded method
+void fuseInstructions(ConstantPool cp, Method m);
+/// Returns the first instruction of the given superinstruction, or op itself if it is not one
+int32 unfusedOpcode(int32 op);
 
 #define CLASS_OUT_OF_MEMORY ((TCClass)-1)
 
@@ -81,42 +81,238 @@ void threadDestroyAll()
       }
 }
 
-void freeMutex(int32 hash, VoidP pmutex)
+/************  MONITORS *************/
+
+typedef struct
 {
-   MUTEX_TYPE* mutex = (MUTEX_TYPE*)pmutex;
-   UNUSED(hash);
-   DESTROY_MUTEX_VAR(*mutex);
-   xfree(mutex);
+   MUTEX_TYPE mutex;
+   Context owner; // only the owner changes it to or from itself
+   int32 count;
+} TMonitor, *Monitor;
+
+static Context monitorWaiters; // the contexts parked waiting for a thin lock, linked by nextWaiter. Guarded by mutexes
+
+bool initParker(TParker* p)
+{
+   return privateInitParker(p);
 }
 
-bool lockMutex(size_t address)
+void destroyParker(TParker* p)
 {
-   MUTEX_TYPE* mutex;
+   privateDestroyParker(p);
+}
 
-   LOCKVAR(mutexes);
-   if (!(mutex = htGetPtr(&htMutexes, address)))
+void freeMutex(int32 hash, VoidP pmonitor)
+{
+   Monitor m = (Monitor)pmonitor;
+   UNUSED(hash);
+   DESTROY_MUTEX_VAR(m->mutex);
+   xfree(m);
+}
+
+// returns the TMonitor of the object, optionally creating it. mutexes must be locked. htMutexes is keyed by the whole
+// address, so two objects never share a TMonitor in 64-bit
+static Monitor getMonitor(TCObject o, bool create)
+{
+   Monitor m = (Monitor)htGetPtr(&htMutexes, (HTKey)o);
+   if (m == null && create && (m = newX(Monitor)) != null)
    {
-      if (!(mutex = (MUTEX_TYPE*)xmalloc(sizeof(MUTEX_TYPE))))
+      SETUP_MUTEX;
+      INIT_MUTEX_VAR(m->mutex);
+      if (!htPutPtr(&htMutexes, (HTKey)o, m))
       {
-         UNLOCKVAR(mutexes);
-         return false;
+         DESTROY_MUTEX_VAR(m->mutex);
+         xfree(m);
+         m = null; // the caller must not inflate onto it
       }
-      SETUP_MUTEX;
-      INIT_MUTEX_VAR(*mutex);
-      if (!htPutPtr(&htMutexes, address, mutex))
-      {                  
-         DESTROY_MUTEX_VAR(*mutex);
-         UNLOCKVAR(mutexes);
-         return false;
+   }
+   return m;
+}
+
+// unparks the contexts waiting for the object. mutexes must be locked
+static void wakeWaiters(TCObject o)
+{
+   Context *pc = &monitorWaiters, c;
+   while ((c = *pc) != null)
+      if (c->waitingMonitor == o)
+      {
+         *pc = c->nextWaiter;
+         c->nextWaiter = null;
+         c->waitingMonitor = null;
+         privateUnpark(&c->parker);
       }
+      else
+         pc = &c->nextWaiter;
+}
+
+// removes the context from the waiters, if it was woken up without being unparked
+static void stopWaiting(Context currentContext)
+{
+   Context *pc = &monitorWaiters;
+   LOCKVAR(mutexes);
+   if (currentContext->waitingMonitor != null)
+   {
+      while (*pc != currentContext)
+         pc = &(*pc)->nextWaiter;
+      *pc = currentContext->nextWaiter;
+      currentContext->nextWaiter = null;
+      currentContext->waitingMonitor = null;
    }
    UNLOCKVAR(mutexes);
-   RESERVE_MUTEX_VAR(*mutex); 
+}
+
+static bool holdsThinLock(Context currentContext, TCObject o)
+{
+   int32 i;
+   for (i = currentContext->lockStackTop; --i >= 0;)
+      if (currentContext->lockStack[i] == o)
+         return true;
+   return false;
+}
+
+// releases a thin lock that is no longer in the lockStack, waking the contexts waiting for it
+static void releaseThinLock(TCObject o)
+{
+   ObjectProperties op = OBJ_PROPERTIES(o);
+   size_t cls = op->classAndMonitor & ~OBJ_MONITOR_MASK;
+   if (!ATOMIC_CAS_PTR(&op->classAndMonitor, cls | MONITOR_THIN, cls)) // MONITOR_WAITING is only changed with mutexes locked
+   {
+      LOCKVAR(mutexes);
+      MEMORY_BARRIER();
+      op->classAndMonitor = cls;
+      wakeWaiters(o);
+      UNLOCKVAR(mutexes);
+   }
+}
+
+// turns the thin lock held by this context into a TMonitor, moving its enters from the lockStack to it, plus the extra ones
+static bool inflateMonitor(Context currentContext, TCObject o, int32 extra)
+{
+   ObjectProperties op = OBJ_PROPERTIES(o);
+   Monitor m;
+   int32 i, j, n = extra;
+
+   LOCKVAR(mutexes);
+   if ((m = getMonitor(o, true)) == null)
+   {
+      UNLOCKVAR(mutexes);
+      return false;
+   }
+   for (i = j = 0; i < currentContext->lockStackTop; i++)
+      if (currentContext->lockStack[i] == o)
+         n++;
+      else
+         currentContext->lockStack[j++] = currentContext->lockStack[i];
+   currentContext->lockStackTop = j;
+   RESERVE_MUTEX_VAR(m->mutex); // no other context can see it yet
+   m->owner = currentContext;
+   m->count = n;
+   MEMORY_BARRIER();
+   op->classAndMonitor = (op->classAndMonitor & ~OBJ_MONITOR_MASK) | MONITOR_INFLATED;
+   wakeWaiters(o); // they will now block on the mutex
+   UNLOCKVAR(mutexes);
    return true;
 }
 
-void unlockMutex(size_t address)
+bool monitorEnter(Context currentContext, TCObject o)
+{
+   ObjectProperties op = OBJ_PROPERTIES(o);
+   bool contended = false;
+   size_t w, cls;
+   Monitor m;
+
+   while (true)
+   {
+      w = op->classAndMonitor;
+      cls = w & ~OBJ_MONITOR_MASK;
+      switch (w & OBJ_MONITOR_MASK)
+      {
+         case MONITOR_UNLOCKED:
+            if (ATOMIC_CAS_PTR(&op->classAndMonitor, w, cls | MONITOR_THIN))
+            {
+               if (currentContext->lockStackTop == MONITOR_LOCK_STACK) // no room to keep it thin
+               {
+                  if (inflateMonitor(currentContext, o, 1))
+                     return true;
+                  releaseThinLock(o);
+                  return false;
+               }
+               currentContext->lockStack[currentContext->lockStackTop++] = o;
+               if (contended) // contended locks are inflated, so the next waits block on the mutex. If there's no memory, it just stays thin
+                  inflateMonitor(currentContext, o, 0);
+               return true;
+            }
+            break;
+         case MONITOR_INFLATED:
+            LOCKVAR(mutexes);
+            m = getMonitor(o, false);
+            UNLOCKVAR(mutexes);
+            if (m->owner == currentContext)
+               m->count++;
+            else
+            {
+               RESERVE_MUTEX_VAR(m->mutex);
+               m->owner = currentContext;
+               m->count = 1;
+            }
+            return true;
+         default: // thin lock, held by this context or by another one
+            if (holdsThinLock(currentContext, o)) // recursive enter: no other context changes the lock now
+            {
+               if (currentContext->lockStackTop == MONITOR_LOCK_STACK)
+                  return inflateMonitor(currentContext, o, 1);
+               currentContext->lockStack[currentContext->lockStackTop++] = o;
+               return true;
+            }
+            contended = true;
+            LOCKVAR(mutexes);
+            if (op->classAndMonitor == w && ((w & OBJ_MONITOR_MASK) == MONITOR_WAITING || ATOMIC_CAS_PTR(&op->classAndMonitor, w, cls | MONITOR_WAITING)))
+            {
+               currentContext->waitingMonitor = o;
+               currentContext->nextWaiter = monitorWaiters;
+               monitorWaiters = currentContext;
+               UNLOCKVAR(mutexes);
+               privatePark(&currentContext->parker); // until the owner releases or inflates it
+               if (currentContext->waitingMonitor != null)
+                  stopWaiting(currentContext);
+            }
+            else
+               UNLOCKVAR(mutexes); // changed meanwhile: try again
+      }
+   }
+}
+
+bool monitorExit(Context currentContext, TCObject o)
 {
-   MUTEX_TYPE* mutex = htGetPtr(&htMutexes, address);
-   RELEASE_MUTEX_VAR(*mutex);
-}
\ No newline at end of file
+   ObjectProperties op = OBJ_PROPERTIES(o);
+   TCObject* stack = currentContext->lockStack;
+   int32 i, top = currentContext->lockStackTop;
+   Monitor m;
+
+   if ((op->classAndMonitor & OBJ_MONITOR_MASK) == MONITOR_INFLATED)
+   {
+      LOCKVAR(mutexes);
+      m = getMonitor(o, false);
+      UNLOCKVAR(mutexes);
+      if (m == null || m->owner != currentContext)
+         return false;
+      if (--m->count == 0)
+      {
+         m->owner = null;
+         RELEASE_MUTEX_VAR(m->mutex);
+      }
+      return true;
+   }
+   for (i = top; --i >= 0;)
+      if (stack[i] == o)
+         break;
+   if (i < 0) // unlocked or held by another context
+      return false;
+   xmemmove(&stack[i], &stack[i+1], (top - i - 1) * sizeof(TCObject));
+   currentContext->lockStackTop = top - 1;
+   while (--i >= 0)
+      if (stack[i] == o) // still held
+         return true;
+   releaseThinLock(o);
+   return true;
+}
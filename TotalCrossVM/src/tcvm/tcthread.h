@@ -147,9 +147,82 @@ void threadCreateJava(Context currentContext, TCObject this_);
 void threadDestroy(ThreadHandle h, bool threadDestroyingItself); // must be used when exiting the application or the thread itself
 void threadDestroyAll(); // destroy all threads
 
-void freeMutex(int32 hash, VoidP mutex);
-bool lockMutex(size_t address);
-void unlockMutex(size_t address);
+void freeMutex(int32 hash, VoidP monitor); // frees a TMonitor of htMutexes
+
+/************  MONITORS *************
+
+The monitor state of an object is kept in the 2 lower bits of its classAndMonitor (see objectmemorymanager.h):
+   MONITOR_UNLOCKED - no context holds it
+   MONITOR_THIN     - held by a context, which keeps the object in its lockStack once for each enter
+   MONITOR_WAITING  - like MONITOR_THIN, but other contexts are parked waiting for its release
+   MONITOR_INFLATED - the monitor became a TMonitor of htMutexes, which keeps the owner and the enter count
+
+An uncontended enter is a single compare-and-swap, and the owner is found by looking in the lockStack, so no header
+space is needed for it. A context that finds the lock held by another one marks it as MONITOR_WAITING and parks; the
+owner wakes it on release, and the context that takes a contended lock inflates it, so the next waits block on the
+mutex of the TMonitor. Once inflated, the object keeps its TMonitor until it is freed. */
+
+#define MONITOR_UNLOCKED   0
+#define MONITOR_THIN       1
+#define MONITOR_INFLATED   2
+#define MONITOR_WAITING    3
+#define MONITOR_LOCK_STACK 8 // the number of thin lock enters a context can hold; more than that inflate the monitors
+
+#if defined(WIN32)
+ typedef HANDLE TParker; // an auto-reset event
+#else
+ typedef struct
+ {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool permit;
+ } TParker;
+#endif
+
+#if defined(WIN32)
+ #define ATOMIC_CAS(p,old,new) (InterlockedCompareExchange((LONG volatile*)(p), (LONG)(new), (LONG)(old)) == (LONG)(old))
+ #define MEMORY_BARRIER()      MemoryBarrier()
+ #define ATOMIC_ADD(p,v)       (InterlockedExchangeAdd((LONG volatile*)(p), (LONG)(v)) + (LONG)(v))
+ #if defined(_WIN64)
+  #define ATOMIC_CAS_PTR(p,old,new) (InterlockedCompareExchangePointer((PVOID volatile*)(p), (PVOID)(new), (PVOID)(old)) == (PVOID)(old))
+ #else
+  #define ATOMIC_CAS_PTR(p,old,new) ATOMIC_CAS(p,old,new)
+ #endif
+#else
+ #define ATOMIC_CAS(p,old,new) __sync_bool_compare_and_swap((p), (old), (new))
+ #define MEMORY_BARRIER()      __sync_synchronize()
+ #define ATOMIC_ADD(p,v)       __sync_add_and_fetch((p), (v)) // returns the new value
+ #define ATOMIC_CAS_PTR(p,old,new) __sync_bool_compare_and_swap((p), (old), (new))
+#endif
+
+/// Enters the monitor of the object, using the fast path if it is unlocked
+#define MONITOR_ENTER(c,o) (((c)->lockStackTop < MONITOR_LOCK_STACK && ATOMIC_CAS_PTR(&OBJ_PROPERTIES(o)->classAndMonitor, (size_t)OBJ_CLASS(o), (size_t)OBJ_CLASS(o) | MONITOR_THIN)) ? ((c)->lockStack[(c)->lockStackTop++] = (o), true) : monitorEnter(c,o))
+
+/// Slow path of MONITOR_ENTER: recursive enters, contention and inflated monitors. Returns false if the monitor could not be inflated (out of memory)
+bool monitorEnter(Context currentContext, TCObject o);
+/// Exits the monitor of the object. Returns false if this context does not hold it
+bool monitorExit(Context currentContext, TCObject o);
+/// Initializes the parker used by the context to wait for the monitors
+bool initParker(TParker* p);
+void destroyParker(TParker* p);
+
+/************  WORKER POOL *************
+
+A pool of worker threads, started on the first use and shared by the VM and the native libraries (see nm/ui/TileRaster.c).
+runPoolJobs hands the jobs to the workers, with the calling thread also running them, and waits until all of them are
+done. The jobs must not allocate objects nor touch the Context. If there are no workers, or if another thread is using
+them, the calling thread runs all the jobs, so each job must give the same result no matter which thread runs it. */
+
+#define POOL_MAX_WORKERS 8 // including the calling thread
+
+/// Runs the given job. worker is below POOL_MAX_WORKERS, and can be used to index scratch buffers
+typedef void (*PoolJobFunc)(VoidP arg, int32 job, int32 worker);
+
+/// Runs func for the jobs 0 to count-1 and waits until all of them are done
+TC_API void runPoolJobs(PoolJobFunc func, VoidP arg, int32 count);
+typedef void (*runPoolJobsFunc)(PoolJobFunc func, VoidP arg, int32 count);
+/// Stops the workers
+void destroyPoolWorkers();
 
 #define ThreadArgsFromObject(o) ((ThreadArgs)ARRAYOBJ_START(Thread_taskID(o)))
 #define ThreadHandleFromObject(o) ThreadArgsFromObject(o)->h
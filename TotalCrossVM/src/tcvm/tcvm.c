@@ -5,7 +5,7 @@
 
 #include "tcvm.h"
 
-#if defined(__GNUC__) && !defined(TRACK_USED_OPCODES)
+#if defined(__GNUC__) && !defined(TRACK_USED_OPCODES) && !defined(TRACK_OPCODE_PAIRS)
 #define DIRECT_JUMP
 #endif
 
@@ -18,6 +18,7 @@
  #define NEXT_OP0 goto *address[code->s24.op];
  #define FIRST_OP NEXT_OP0
  #define OPADDR(x) _address[x] = &&_##x;
+ #define NEXT_FUSED(x) code++; goto _##x; // superinstructions: go straight to the second instruction
 
  #define XOPTION(pref,x) pref##x
  #define XSELECT(addr,idx) goto *addr[idx];
@@ -25,6 +26,7 @@
  #define OPCODE(x) case x: DUMP_BYTECODE(#x)
  #define NEXT_OP  code++; goto mainLoop;
  #define NEXT_OP0 goto mainLoop;
+ #define NEXT_FUSED(x) NEXT_OP
  #define FIRST_OP switch (code->s24.op)
 
  #define XOPTION(pref,x) case x
@@ -141,6 +143,10 @@ bool checkArrayRange(Context currentContext, TCObject obj, int32 start, int32 co
    }                                                                          \
    else {exceptionMsg = "Getting instance field"; goto throwNullPointerException;}
 
+#ifdef TRACK_OPCODE_PAIRS
+uint32 opcodePairs[OPCODE_LENGTH][OPCODE_LENGTH]; // how many times each opcode ran right after another one; dumped by destroyDebug
+#endif
+
 #ifdef DIRECT_JUMP // use a direct jump if supported
 uint32 *_address[OPCODE_LENGTH];
 uint32 *_addrMtdParam[4];
@@ -151,6 +157,50 @@ uint32 *_addrInParamA[4];
 uint32 *_addrNMRet[4];
 #endif
 
+// adds the method called for the given class to the call site's inline cache, if there's room for it
+static void updateInlineCache(Method method, Code code, TCClass c, Method m)
+{
+   InlineCache ic;
+   MethodAndClass mac;
+   Heap heap = method->class_->heap;
+   int32 i, pc = (int32)(code - method->code);
+   if (method->inlineCaches != null && (ic = method->inlineCaches[pc]) != null && ic->entries[INLINE_CACHE_SIZE-1] != null) // megamorphic?
+      return;
+   LOCKVAR(metAndCls);
+   IF_HEAP_ERROR(heap) // just don't cache
+   {
+      UNLOCKVAR(metAndCls);
+      return;
+   }
+   // CALL_virtual reads the caches without the lock, so each one must be complete before being seen by the other threads
+   if (method->inlineCaches == null)
+   {
+      InlineCache* caches = (InlineCache*)heapAlloc(heap, TSIZE * ARRAYLENV(method->code));
+      MEMORY_BARRIER();
+      method->inlineCaches = caches;
+   }
+   if ((ic = method->inlineCaches[pc]) == null)
+   {
+      ic = newXH(InlineCache, heap);
+      MEMORY_BARRIER();
+      method->inlineCaches[pc] = ic;
+   }
+   for (i = 0; i < INLINE_CACHE_SIZE; i++)
+      if (ic->entries[i] == null)
+      {
+         mac = newXH(MethodAndClass, heap);
+         mac->c = c;
+         mac->m = m;
+         MEMORY_BARRIER();
+         ic->entries[i] = mac;
+         break;
+      }
+      else
+      if (ic->entries[i]->c == c) // another thread already cached it
+         break;
+   UNLOCKVAR(metAndCls);
+}
+
 /* Note: this code is highly optimized. So, even if some things seems not "natural", keep it that way! */
 TC_API TValue executeMethod(Context context, Method method, ...)
 {
@@ -161,6 +211,9 @@ TC_API TValue executeMethod(Context context, Method method, ...)
    int32 callStackMethodEnd = 0;
    // get method's variables
    register Code code = method->code;
+#ifdef TRACK_OPCODE_PAIRS
+   Code lastCode = null;
+#endif
    TCClass class_ = method->class_, c=null,thisClass;
    ConstantPool cp = class_->cp;
    uint32 nparam=0;
@@ -171,13 +224,13 @@ TC_API TValue executeMethod(Context context, Method method, ...)
    bool originalClassIsInterface,directNativeCall=false;
    CharP exceptionMsg = null;
    TCObject o=null;
-   Method newMethod=null;
+   Method newMethod=null,slotMethod;
    uint16 retv;
    VoidP sf;
    TValue returnedValue;
-   MethodAndClass mac,last;
-   MethodAndClass* macArray;
-   MethodAndClass* boundHead=null;
+   MethodAndClass mac;
+   InlineCache ic;
+   TCClass iface;
    int32 hashName,hashParams;
    ThreadHandle thread;
 
@@ -202,6 +255,7 @@ TC_API TValue executeMethod(Context context, Method method, ...)
       OPADDR(DIV_regD_regD_regD)  OPADDR(DIV_regL_regL_regL)  OPADDR(MOD_regI_regI_s12)   OPADDR(MOD_regI_regI_regI)  OPADDR(MOD_regD_regD_regD) OPADDR(MOD_regL_regL_regL)  OPADDR(SHR_regI_regI_s12)   OPADDR(SHR_regI_regI_regI)  OPADDR(SHR_regL_regL_regL) OPADDR(SHL_regI_regI_s12)   OPADDR(SHL_regI_regI_regI)  OPADDR(SHL_regL_regL_regL)  OPADDR(USHR_regI_regI_s12) OPADDR(USHR_regI_regI_regI) OPADDR(USHR_regL_regL_regL) OPADDR(AND_regI_regI_s12)   OPADDR(AND_regI_aru_s6)      OPADDR(AND_regI_regI_regI)  OPADDR(AND_regL_regL_regL)  OPADDR(OR_regI_regI_s12)    OPADDR(OR_regI_regI_regI)  OPADDR(OR_regL_regL_regL)   OPADDR(XOR_regI_regI_s12)   OPADDR(XOR_regI_regI_regI)  OPADDR(XOR_regL_regL_regL) OPADDR(JEQ_regO_regO)       OPADDR(JEQ_regO_null)       OPADDR(JEQ_regI_regI)       OPADDR(JEQ_regL_regL)      OPADDR(JEQ_regD_regD)       OPADDR(JEQ_regI_s6)         OPADDR(JEQ_regI_sym)
       OPADDR(JNE_regO_regO)       OPADDR(JNE_regO_null)       OPADDR(JNE_regI_regI)       OPADDR(JNE_regL_regL)       OPADDR(JNE_regD_regD)      OPADDR(JNE_regI_s6)         OPADDR(JNE_regI_sym)        OPADDR(JLT_regI_regI)       OPADDR(JLT_regL_regL)      OPADDR(JLT_regD_regD)       OPADDR(JLT_regI_s6)         OPADDR(JLE_regI_regI)       OPADDR(JLE_regL_regL)      OPADDR(JLE_regD_regD)       OPADDR(JLE_regI_s6)         OPADDR(JGT_regI_regI)       OPADDR(JGT_regL_regL)        OPADDR(JGT_regD_regD)       OPADDR(JGT_regI_s6)         OPADDR(JGE_regI_regI)       OPADDR(JGE_regL_regL)      OPADDR(JGE_regD_regD)       OPADDR(JGE_regI_s6)         OPADDR(JGE_regI_arlen)      OPADDR(DECJGTZ_regI)       OPADDR(DECJGEZ_regI)        OPADDR(TEST_regO)           OPADDR(JUMP_s24)            OPADDR(CONV_regI_regL)     OPADDR(CONV_regI_regD)      OPADDR(CONV_regIb_regI)     OPADDR(CONV_regIc_regI)
       OPADDR(CONV_regIs_regI)     OPADDR(CONV_regL_regI)      OPADDR(CONV_regL_regD)      OPADDR(CONV_regD_regI)      OPADDR(CONV_regD_regL)     OPADDR(RETURN_regI)         OPADDR(RETURN_regO)         OPADDR(RETURN_reg64)        OPADDR(RETURN_void)        OPADDR(RETURN_s24I)         OPADDR(RETURN_null)         OPADDR(RETURN_s24D)         OPADDR(RETURN_s24L)        OPADDR(RETURN_symI)         OPADDR(RETURN_symO)         OPADDR(RETURN_symD)         OPADDR(RETURN_symL)          OPADDR(SWITCH)              OPADDR(NEWARRAY_len)        OPADDR(NEWARRAY_regI)       OPADDR(NEWARRAY_multi)     OPADDR(NEWOBJ)              OPADDR(THROW)               OPADDR(INSTANCEOF)          OPADDR(CHECKCAST)          OPADDR(CALL_normal)         OPADDR(CALL_virtual)        OPADDR(JUMP_regI)           OPADDR(MONITOR_Enter)      OPADDR(MONITOR_Enter2)      OPADDR(MONITOR_Exit)        OPADDR(MONITOR_Exit2)
+      OPADDR(MOV_regI_field_JEQ_regI_s6) OPADDR(MOV_regI_field_JNE_regI_s6) OPADDR(MOV_regI_arc_MOV_regI_arc) OPADDR(MOV_regI_aru_ADD_regI_regI_regI) OPADDR(INC_regI_JLT_regI_regI) OPADDR(INC_regI_JUMP_s24)
    }
    address = _address;
    addrMtdParam = _addrMtdParam;
@@ -344,11 +398,18 @@ TC_API TValue executeMethod(Context context, Method method, ...)
       goto nativeMethodCall;
    }
 
+   JIT_ENTER(method, code, regI, regO)
+
 #ifndef DIRECT_JUMP // use a direct jump if supported
 mainLoop:
 #endif
 #ifdef TRACK_USED_OPCODES
    usedOpcodes[(code+1)->op.op] = 1;
+#endif
+#ifdef TRACK_OPCODE_PAIRS
+   if (code == lastCode+1) // only pairs that run in sequence can be fused
+      opcodePairs[lastCode->op.op][code->op.op]++;
+   lastCode = code;
 #endif
    FIRST_OP
    {
@@ -379,7 +440,7 @@ mainLoop:
       OPCODE(MOV_arc_regI)        ARRAYCHECK(code->reg)
       OPCODE(MOV_aru_regI)        ((int32 *)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]] = regI[code->reg_ar.reg]; NEXT_OP
       OPCODE(MOV_arc_regO)        ARRAYCHECK(code->reg)
-      OPCODE(MOV_aru_regO)        ((TCObject*)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]] = regO[code->reg_ar.reg]; NEXT_OP
+      OPCODE(MOV_aru_regO)        WRITE_BARRIER(regO[code->reg_ar.base], regO[code->reg_ar.reg]); ((TCObject*)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]] = regO[code->reg_ar.reg]; NEXT_OP
       OPCODE(MOV_arc_reg64)       ARRAYCHECK(code->reg)
       OPCODE(MOV_aru_reg64)       ((Value64)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]] = reg64[code->reg_ar.reg]; NEXT_OP
       OPCODE(MOV_arc_regIb)       ARRAYCHECK(code->reg)
@@ -391,7 +452,7 @@ mainLoop:
       OPCODE(MOV_reg16_arc)       ARRAYCHECK(code->reg)
       OPCODE(MOV_reg16_aru)       regI[code->reg_ar.reg] = ((uint16*)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]]; NEXT_OP
       OPCODE(MOV_field_regI)      GET_INSTANCE_FIELD(RegI) FIELD_I32(o,               retv) = regI[code->field_reg.reg]; NEXT_OP
-      OPCODE(MOV_field_regO)      GET_INSTANCE_FIELD(RegO) FIELD_OBJ(o, OBJ_CLASS(o), retv) = regO[code->field_reg.reg]; NEXT_OP
+      OPCODE(MOV_field_regO)      GET_INSTANCE_FIELD(RegO) WRITE_BARRIER(o, regO[code->field_reg.reg]); FIELD_OBJ(o, OBJ_CLASS(o), retv) = regO[code->field_reg.reg]; NEXT_OP
       OPCODE(MOV_field_reg64)     GET_INSTANCE_FIELD(RegD) FIELD_DBL(o, OBJ_CLASS(o), retv) = REGD(reg64)[code->field_reg.reg];NEXT_OP
       OPCODE(MOV_regI_field)      GET_INSTANCE_FIELD(RegI) regI[code->field_reg.reg] = FIELD_I32(o,               retv); NEXT_OP
       OPCODE(MOV_regO_field)      GET_INSTANCE_FIELD(RegO) regO[code->field_reg.reg] = FIELD_OBJ(o, OBJ_CLASS(o), retv); NEXT_OP
@@ -445,44 +506,46 @@ mainLoop:
       OPCODE(XOR_regI_regI_regI)  regI[code->reg_reg_reg.reg0] = regI[code->reg_reg_reg.reg1] ^ regI[code->reg_reg_reg.reg2]; NEXT_OP
       OPCODE(XOR_regL_regL_regL)  REGL(reg64)[code->reg_reg_reg.reg0] = REGL(reg64)[code->reg_reg_reg.reg1] ^ REGL(reg64)[code->reg_reg_reg.reg2]; NEXT_OP
       OPCODE(XOR_regI_regI_s12)   regI[code->reg_reg_s12.reg0] = regI[code->reg_reg_s12.reg1] ^ (int32)code->reg_reg_s12.s12; NEXT_OP
-      OPCODE(JEQ_regO_regO)       if (regO[code->reg_reg_s12.reg0]        == regO[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JEQ_regO_null)       if (regO[code->reg_reg_s12.reg0]        == 0)                                                 {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JEQ_regI_regI)       if (regI[code->reg_reg_s12.reg0]        == regI[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JEQ_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] == REGL(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JEQ_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] == REGD(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JEQ_regI_s6)         if (regI[code->reg_s6_desloc.reg]       == (int32)code->reg_s6_desloc.s6)                     {code += (int32)code->reg_s6_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JEQ_regI_sym)        if (regI[code->reg_sym_sdesloc.reg]     == cp->i32[code->reg_sym_sdesloc.sym])                {code += (int32)code->reg_sym_sdesloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regO_regO)       if (regO[code->reg_reg_s12.reg0]        != regO[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regO_null)       if (regO[code->reg_reg_s12.reg0]        != 0)                                                 {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regI_regI)       if (regI[code->reg_reg_s12.reg0]        != regI[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] != REGL(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] != REGD(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regI_s6)         if (regI[code->reg_s6_desloc.reg]       != (int32)code->reg_s6_desloc.s6)                     {code += (int32)code->reg_s6_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JNE_regI_sym)        if (regI[code->reg_sym_sdesloc.reg]     != cp->i32[code->reg_sym_sdesloc.sym])                {code += (int32)code->reg_sym_sdesloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JLT_regI_regI)       if (regI[code->reg_reg_s12.reg0]        <  regI[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JLT_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] <  REGL(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JLT_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] <  REGD(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JLT_regI_s6)         if (regI[code->reg_s6_desloc.reg]       <  (int32)code->reg_s6_desloc.s6)                     {code += (int32)code->reg_s6_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JLE_regI_regI)       if (regI[code->reg_reg_s12.reg0]        <= regI[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JLE_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] <= REGL(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JLE_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] <= REGD(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JLE_regI_s6)         if (regI[code->reg_s6_desloc.reg]       <= (int32)code->reg_s6_desloc.s6)                     {code += (int32)code->reg_s6_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JGT_regI_regI)       if (regI[code->reg_reg_s12.reg0]        >  regI[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JGT_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] >  REGL(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JGT_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] >  REGD(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JGT_regI_s6)         if (regI[code->reg_s6_desloc.reg]       >  (int32)code->reg_s6_desloc.s6)                     {code += (int32)code->reg_s6_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JGE_regI_regI)       if (regI[code->reg_reg_s12.reg0]        >= regI[code->reg_reg_s12.reg1])                      {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JGE_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] >= REGL(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JGE_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] >= REGD(reg64)[code->reg_reg_s12.reg1])               {code += (int32)code->reg_reg_s12.s12; NEXT_OP0} NEXT_OP
-      OPCODE(JGE_regI_s6)         if (regI[code->reg_s6_desloc.reg]       >= (int32)code->reg_s6_desloc.s6)                     {code += (int32)code->reg_s6_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(JGE_regI_arlen)      if (regI[code->reg_arl_s12.regI]        >= (int32)ARRAYOBJ_LEN(regO[code->reg_arl_s12.base])) {code += (int32)code->reg_arl_s12.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(DECJGTZ_regI)        if (--regI[code->reg_desloc.reg]        >  0)                                                 {code += (int32)code->reg_desloc.desloc; NEXT_OP0} NEXT_OP
-      OPCODE(DECJGEZ_regI)        if (--regI[code->reg_desloc.reg]        >= 0)                                                 {code += (int32)code->reg_desloc.desloc; NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regO_regO)       if (regO[code->reg_reg_s12.reg0]        == regO[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regO_null)       if (regO[code->reg_reg_s12.reg0]        == 0)                                                 {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regI_regI)       if (regI[code->reg_reg_s12.reg0]        == regI[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] == REGL(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] == REGD(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regI_s6)         if (regI[code->reg_s6_desloc.reg]       == (int32)code->reg_s6_desloc.s6)                     {JIT_JUMP(method, code, regI, regO, code->reg_s6_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JEQ_regI_sym)        if (regI[code->reg_sym_sdesloc.reg]     == cp->i32[code->reg_sym_sdesloc.sym])                {JIT_JUMP(method, code, regI, regO, code->reg_sym_sdesloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regO_regO)       if (regO[code->reg_reg_s12.reg0]        != regO[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regO_null)       if (regO[code->reg_reg_s12.reg0]        != 0)                                                 {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regI_regI)       if (regI[code->reg_reg_s12.reg0]        != regI[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] != REGL(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] != REGD(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regI_s6)         if (regI[code->reg_s6_desloc.reg]       != (int32)code->reg_s6_desloc.s6)                     {JIT_JUMP(method, code, regI, regO, code->reg_s6_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JNE_regI_sym)        if (regI[code->reg_sym_sdesloc.reg]     != cp->i32[code->reg_sym_sdesloc.sym])                {JIT_JUMP(method, code, regI, regO, code->reg_sym_sdesloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JLT_regI_regI)       if (regI[code->reg_reg_s12.reg0]        <  regI[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JLT_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] <  REGL(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JLT_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] <  REGD(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JLT_regI_s6)         if (regI[code->reg_s6_desloc.reg]       <  (int32)code->reg_s6_desloc.s6)                     {JIT_JUMP(method, code, regI, regO, code->reg_s6_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JLE_regI_regI)       if (regI[code->reg_reg_s12.reg0]        <= regI[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JLE_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] <= REGL(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JLE_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] <= REGD(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JLE_regI_s6)         if (regI[code->reg_s6_desloc.reg]       <= (int32)code->reg_s6_desloc.s6)                     {JIT_JUMP(method, code, regI, regO, code->reg_s6_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JGT_regI_regI)       if (regI[code->reg_reg_s12.reg0]        >  regI[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JGT_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] >  REGL(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JGT_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] >  REGD(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JGT_regI_s6)         if (regI[code->reg_s6_desloc.reg]       >  (int32)code->reg_s6_desloc.s6)                     {JIT_JUMP(method, code, regI, regO, code->reg_s6_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JGE_regI_regI)       if (regI[code->reg_reg_s12.reg0]        >= regI[code->reg_reg_s12.reg1])                      {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JGE_regL_regL)       if (REGL(reg64)[code->reg_reg_s12.reg0] >= REGL(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JGE_regD_regD)       if (REGD(reg64)[code->reg_reg_s12.reg0] >= REGD(reg64)[code->reg_reg_s12.reg1])               {JIT_JUMP(method, code, regI, regO, code->reg_reg_s12.s12) NEXT_OP0} NEXT_OP
+      OPCODE(JGE_regI_s6)         if (regI[code->reg_s6_desloc.reg]       >= (int32)code->reg_s6_desloc.s6)                     {JIT_JUMP(method, code, regI, regO, code->reg_s6_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(JGE_regI_arlen)      if (regI[code->reg_arl_s12.regI]        >= (int32)ARRAYOBJ_LEN(regO[code->reg_arl_s12.base])) {JIT_JUMP(method, code, regI, regO, code->reg_arl_s12.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(DECJGTZ_regI)        if (--regI[code->reg_desloc.reg]        >  0)                                                 {JIT_JUMP(method, code, regI, regO, code->reg_desloc.desloc) NEXT_OP0} NEXT_OP
+      OPCODE(DECJGEZ_regI)        if (--regI[code->reg_desloc.reg]        >= 0)                                                 {JIT_JUMP(method, code, regI, regO, code->reg_desloc.desloc) NEXT_OP0} NEXT_OP
       OPCODE(CALL_normal) // 33% of the calls
-         if ((newMethod = cp->boundNormal[code->mtd.sym]) != null) // note: there's no need to check here if this class is an interface because interface methods are never bound
+         if ((newMethod = cp->boundNormal[code->mtd.sym]) != null) // note: there's no need to check here if this class is an interface because interface methods are never bound here
             goto contCall;
-         else
-            goto notYetLinked;
+         if ((newMethod = cp->boundInterfaceMethod[code->mtd.sym]) != null && regO[code->mtd.this_] != null && // an interface method? dispatch through the itables
+            (newMethod = getInterfaceMethod(OBJ_CLASS(regO[code->mtd.this_]), newMethod)) != null && !newMethod->flags.isAbstract)
+            goto contCall;
+         goto notYetLinked;
       OPCODE(CALL_virtual) // 66% of the calls
          if (regO[code->mtd.this_] == null)
          {     
@@ -496,11 +559,20 @@ mainLoop:
           debug("NULL CLASS OBJECT: %X", regO[code->mtd.this_]);
 			 goto throwNullPointerException;
 		 }
-         if ((macArray = cp->boundVirtualMethod[code->mtd.sym]) != null && // was the method ever linked?
-            (mac = macArray[thisClass->hash&15]) != null &&                // map to the hash position
-            mac->c == thisClass) // 90% of the cases
+         if (method->inlineCaches != null && (ic = method->inlineCaches[code - method->code]) != null) // the call site was already executed
+            for (i = 0; i < INLINE_CACHE_SIZE && (mac = ic->entries[i]) != null; i++)
+               if (mac->c == thisClass) // monomorphic call sites always hit in the first one
+               {
+                  newMethod = mac->m;
+                  goto contCall;
+               }
+         if ((newMethod = cp->boundVirtualMethod[code->mtd.sym]) != null && // was the method ever linked?
+            newMethod->vtableIndex < ARRAYLENV(thisClass->vtable) &&       // the slot may not exist if "this" is not a subclass of the bound method's one
+            (slotMethod = thisClass->vtable[newMethod->vtableIndex]) != null &&
+            slotMethod->hashName == newMethod->hashName && slotMethod->hashParams == newMethod->hashParams && !slotMethod->flags.isAbstract)
          {
-            newMethod = mac->m;
+            newMethod = slotMethod;
+            updateInlineCache(method, code, thisClass, newMethod);
 contCall:
             regI  = context->regI; // same of regI += method->iCount
             regO  = context->regO;
@@ -629,6 +701,7 @@ noMoreParams:
                cp = class_->cp;
                method = newMethod;
                code = method->code;
+               JIT_ENTER(method, code, regI, regO)
                NEXT_OP0
             }
             // no else here!
@@ -713,35 +786,9 @@ popStackFrame:
          }
          else
          {
-            if (macArray == null) // have to create the array?
-            {
-               IF_HEAP_ERROR(cp->heap)
-               {                            
-                  exceptionMsg = "When expanding MAC array";
-                  goto throwOutOfMemoryError;
-               }
-               macArray = cp->boundVirtualMethod[code->mtd.sym] = (MethodAndClass*)heapAlloc(cp->heap, TSIZE*16);
-               boundHead = &macArray[thisClass->hash&15];
-               goto notYetLinked;
-            }
-            LOCKVAR(metAndCls);
-            boundHead = &macArray[thisClass->hash&15];
-            for (last=mac, mac = mac ? mac->next : null; mac != null; last = mac, mac = mac->next)
-               if (mac->c == thisClass)
-               {
-                  // move to front. increases first hit by 50%
-                  if (last)
-                     last->next = mac->next;
-                  mac->next = *boundHead;
-                  *boundHead = mac;
-                  // get the method's address and execute it.
-                  newMethod = mac->m;
-                  UNLOCKVAR(metAndCls);
-                  goto contCall;
-               }
-            UNLOCKVAR(metAndCls);
 notYetLinked:
             originalClassIsInterface = false;
+            iface = null;
             sym = cp->mtd[ code->mtd.sym ]; // virtual methods are directly referenced: mtd.sym is the index to an array that will point to the mtd table
             len = cp->mtdLens[code->mtd.sym];
             className = cp->cls[sym[0]];
@@ -778,6 +825,7 @@ notYetLinked:
                if (c->flags.isInterface) // if we're calling an interface method, use the current object's class instead
                {
                   originalClassIsInterface = true;
+                  iface = c;
                   if (regO[code->mtd.this_] == null)
                   {
                      exceptionMsg = "Calling an interface's method";
@@ -791,15 +839,19 @@ notYetLinked:
                for (newMethod = c->methods, i = ARRAYLENV(c->methods); i-- > 0; newMethod++)
                   if (newMethod->hashName == hashName && newMethod->hashParams == hashParams && strEq(newMethod->name, methodName) && paramsEq(cp, sym, len, c->cp, newMethod->cpParams)) // guich@tc110_21: after the hashcode match, we must ensure that the names also match.
                   {
-                     if (!originalClassIsInterface && !newMethod->flags.isAbstract) // if the class is not an interface nor the method abstract, bind it
+                     if (originalClassIsInterface) // bind the interface's method, whose slot is used to find the implementation in the itables
+                     {
+                        if (!newMethod->flags.isAbstract)
+                           cp->boundInterfaceMethod[code->mtd.sym] = findVirtualMethod(iface->vtable, newMethod);
+                     }
+                     else
+                     if (!newMethod->flags.isAbstract) // if the method is not abstract, bind it
                      {
                         if (code->op.op == CALL_virtual)
                         {
-                           MethodAndClass newMac = newXH(MethodAndClass, cp->heap);
-                           newMac->m = newMethod;
-                           newMac->c = OBJ_CLASS(regO[code->mtd.this_]);
-                           newMac->next = *boundHead;
-                           *boundHead = newMac;
+                           if (newMethod->vtableIndex != NO_VTABLE_INDEX)
+                              cp->boundVirtualMethod[code->mtd.sym] = newMethod; // any method in the same slot would do
+                           updateInlineCache(method, code, OBJ_CLASS(regO[code->mtd.this_]), newMethod);
                         }
                         else
                            cp->boundNormal[code->mtd.sym] = newMethod;
@@ -870,7 +922,7 @@ resumePreviousMethod:
             NEXT_OP
          }
          goto finishMethod;
-      OPCODE(JUMP_s24)  code += (int32)code->s24.desloc;  NEXT_OP0
+      OPCODE(JUMP_s24)  JIT_JUMP(method, code, regI, regO, code->s24.desloc) NEXT_OP0
       OPCODE(JUMP_regI) code = method->code + regI[code->reg.reg]; NEXT_OP0
       OPCODE(SWITCH) // switch (regI)
       {
@@ -910,10 +962,10 @@ resumePreviousMethod:
          }
          NEXT_OP0
       }
-      OPCODE(NEWARRAY_len)   if ((regO[code->newarray.regO] = createArrayObject(context, cp->cls[code->newarray.sym], code->newarray.lenOrRegIOrDims)) == null) {exceptionMsg = "When creating array with length"; goto throwOutOfMemoryError;} setObjectLock(regO[code->newarray.regO], UNLOCKED); NEXT_OP
-      OPCODE(NEWARRAY_regI)  if ((regO[code->newarray.regO] = createArrayObject(context, cp->cls[code->newarray.sym], regI[code->newarray.lenOrRegIOrDims])) == null) {exceptionMsg = "When creating array with register"; goto throwOutOfMemoryError;} setObjectLock(regO[code->newarray.regO], UNLOCKED); NEXT_OP
+      OPCODE(NEWARRAY_len)   if ((regO[code->newarray.regO] = createYoungArrayObject(context, cp->cls[code->newarray.sym], code->newarray.lenOrRegIOrDims)) == null) {exceptionMsg = "When creating array with length"; goto throwOutOfMemoryError;} setObjectLock(regO[code->newarray.regO], UNLOCKED); NEXT_OP
+      OPCODE(NEWARRAY_regI)  if ((regO[code->newarray.regO] = createYoungArrayObject(context, cp->cls[code->newarray.sym], regI[code->newarray.lenOrRegIOrDims])) == null) {exceptionMsg = "When creating array with register"; goto throwOutOfMemoryError;} setObjectLock(regO[code->newarray.regO], UNLOCKED); NEXT_OP
       OPCODE(NEWARRAY_multi) if ((regO[code->newarray.regO] = createArrayObjectMulti(context, cp->cls[code->newarray.sym], code->newarray.lenOrRegIOrDims, (uint8*)(code+1), regI)) == null) {exceptionMsg = "When creating multiple arrays"; goto throwOutOfMemoryError;} setObjectLock(regO[code->newarray.regO], UNLOCKED); code += (code->newarray.lenOrRegIOrDims+3)>>2; NEXT_OP
-      OPCODE(NEWOBJ)         if ((regO[code->reg_sym.reg]   = createObjectWithoutCallingDefaultConstructor(context, cp->cls[code->reg_sym.sym])) == null) {exceptionMsg = "When creating object"; goto throwOutOfMemoryError;} setObjectLock(regO[code->reg_sym.reg], UNLOCKED); NEXT_OP // do not call default constructor
+      OPCODE(NEWOBJ)         if ((regO[code->reg_sym.reg]   = createYoungObject(context, cp->cls[code->reg_sym.sym])) == null) {exceptionMsg = "When creating object"; goto throwOutOfMemoryError;} setObjectLock(regO[code->reg_sym.reg], UNLOCKED); NEXT_OP // do not call default constructor
       OPCODE(THROW)
          context->thrownException = regO[code->reg_reg.reg0];
 #ifdef ENABLE_TRACE
@@ -985,7 +1037,7 @@ handleException:
          if (o == null) {exceptionMsg = "On synchronized object's enter"; goto throwNullPointerException;}
          if (OBJ_CLASS(o) != lockClass) // check for totalcross.util.concurrent.Lock
          {            
-            if (!lockMutex((size_t)o))
+            if (!MONITOR_ENTER(context, o))
             {
                exceptionMsg = "When locking mutex";
                goto throwOutOfMemoryError;         
@@ -1009,7 +1061,13 @@ handleException:
             o = cp->str[code->reg_reg.reg0];
          if (o == null) {exceptionMsg = "On synchronized object's exit"; goto throwNullPointerException;}
          if (OBJ_CLASS(o) != lockClass) // check for totalcross.util.concurrent.Lock
-            unlockMutex((size_t)o);
+         {
+            if (!monitorExit(context, o))
+            {
+               tcvmCreateException(context, RuntimeException, (int32)(code-method->code), 0, "The synchronized object is not locked by this thread");
+               goto handleException;
+            }
+         }
          else
          {   
             TCObject mutex = Lock_mutex(o);
@@ -1022,6 +1080,13 @@ handleException:
          }
          NEXT_OP
       }
+      // superinstructions: run the first instruction and continue in the second one without a new dispatch
+      OPCODE(MOV_regI_field_JEQ_regI_s6)      GET_INSTANCE_FIELD(RegI) regI[code->field_reg.reg] = FIELD_I32(o, retv); NEXT_FUSED(JEQ_regI_s6)
+      OPCODE(MOV_regI_field_JNE_regI_s6)      GET_INSTANCE_FIELD(RegI) regI[code->field_reg.reg] = FIELD_I32(o, retv); NEXT_FUSED(JNE_regI_s6)
+      OPCODE(MOV_regI_arc_MOV_regI_arc)       ARRAYCHECK(code->reg) regI[code->reg_ar.reg] = ((int32*)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]]; NEXT_FUSED(MOV_regI_arc)
+      OPCODE(MOV_regI_aru_ADD_regI_regI_regI) regI[code->reg_ar.reg] = ((int32*)ARRAYOBJ_START(regO[code->reg_ar.base]))[regI[code->reg_ar.idx]]; NEXT_FUSED(ADD_regI_regI_regI)
+      OPCODE(INC_regI_JLT_regI_regI)          regI[code->inc.reg] += (int32)code->inc.s16; NEXT_FUSED(JLT_regI_regI)
+      OPCODE(INC_regI_JUMP_s24)               regI[code->inc.reg] += (int32)code->inc.s16; NEXT_FUSED(JUMP_s24)
       // end of opcodes
 #ifndef DIRECT_JUMP
       default:
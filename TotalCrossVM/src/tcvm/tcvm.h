@@ -133,6 +133,8 @@
 #include "tcthread.h"
 #include "tcz.h"
 #include "opcodes.h"
+#include "jit.h"
+#include "classimage.h"
 #include "utils.h"
 #include "debug.h"
 #include "objectmemorymanager.h"
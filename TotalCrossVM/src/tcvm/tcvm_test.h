@@ -311,6 +311,7 @@ static Method initMethod(Context currentContext, int op)
    testMethod.flags.isStatic = true;
    testMethod.class_ = testTypesClass;
    testMethod.code = code;
+   testMethod.jitCounter = 0; // the code is not an array, and changes in each test
    return &testMethod;
 }
 
@@ -3073,3 +3074,266 @@ TESTCASE(VM_DECJGEZ_regI) // if (--x >= 0) goto ....
    ASSERT2_EQUALS(Ptr, m->code+1, currentContext->code);
 finish: ;
 }
+TESTCASE(VM_JIT) // the compiled code must give the same results and throw the same exceptions of the interpreter
+{
+#ifdef ENABLE_JIT
+   TMethod jm, lm, rm;
+   TCObject array;
+   int32 i, *v;
+   Method m = initMethod(currentContext,BREAK); // loads the test class and clears the registers
+   if (m == null)
+      TEST_ABORT;
+   xmemzero(&jm, sizeof(jm));
+   xmemzero(&lm, sizeof(lm));
+   xmemzero(&rm, sizeof(rm));
+   jm.flags.isStatic = true;
+   jm.class_ = m->class_;
+   jm.code = newArrayOf(Code, 8, null);
+   // regI[0] = 0; for (regI[1] = 10; regI[1] > 0; regI[1]--) regI[0] += regO[1][regI[1]-1] / regI[4];
+   jm.code[0].s18_reg.op = MOV_regI_s18;        jm.code[0].s18_reg.reg = 0; jm.code[0].s18_reg.s18 = 0;
+   jm.code[1].s18_reg.op = MOV_regI_s18;        jm.code[1].s18_reg.reg = 1; jm.code[1].s18_reg.s18 = 10;
+   jm.code[2].reg_reg_s12.op = ADD_regI_s12_regI; jm.code[2].reg_reg_s12.reg0 = 2; jm.code[2].reg_reg_s12.reg1 = 1; jm.code[2].reg_reg_s12.s12 = -1;
+   jm.code[3].reg_ar.op = MOV_regI_arc;         jm.code[3].reg_ar.reg = 3; jm.code[3].reg_ar.base = 1; jm.code[3].reg_ar.idx = 2;
+   jm.code[4].reg_reg_reg.op = DIV_regI_regI_regI; jm.code[4].reg_reg_reg.reg0 = 3; jm.code[4].reg_reg_reg.reg1 = 3; jm.code[4].reg_reg_reg.reg2 = 4;
+   jm.code[5].reg_reg_reg.op = ADD_regI_regI_regI; jm.code[5].reg_reg_reg.reg0 = 0; jm.code[5].reg_reg_reg.reg1 = 0; jm.code[5].reg_reg_reg.reg2 = 3;
+   jm.code[6].reg_desloc.op = DECJGTZ_regI;     jm.code[6].reg_desloc.reg = 1; jm.code[6].reg_desloc.desloc = -4;
+   jm.code[7].op.op = BREAK; // not compiled: the interpreter finishes the method
+
+   array = createArrayObject(currentContext, INT_ARRAY, 10);
+   setObjectLock(array, UNLOCKED);
+   v = (int32*)ARRAYOBJ_START(array);
+   for (i = 0; i < 10; i++)
+      v[i] = i * 6;
+   currentContext->regO[1] = array;
+   currentContext->regI[4] = 3;
+   // interpreted
+   executeMethod(currentContext, &jm);
+   ASSERT1_EQUALS(Null, currentContext->thrownException);
+   ASSERT2_EQUALS(I32, currentContext->regI[0], 90);
+   // compiled
+   ASSERT1_EQUALS(True, jitCompile(&jm));
+   ASSERT1_EQUALS(NotNull, jm.jitCode);
+   currentContext->regI[0] = -1;
+   executeMethod(currentContext, &jm);
+   ASSERT1_EQUALS(Null, currentContext->thrownException);
+   ASSERT2_EQUALS(I32, currentContext->regI[0], 90);
+   ASSERT2_EQUALS(I32, currentContext->regI[1], 0);
+   // division by zero
+   currentContext->regI[4] = 0;
+   executeMethod(currentContext, &jm);
+   ASSERT1_EQUALS(NotNull, currentContext->thrownException);
+   ASSERT2_EQUALS(Sz, OBJ_CLASS(currentContext->thrownException)->name, throwableAsCharP[ArithmeticException]);
+   currentContext->thrownException = null;
+   // null array
+   currentContext->regI[4] = 3;
+   currentContext->regO[1] = null;
+   executeMethod(currentContext, &jm);
+   ASSERT1_EQUALS(NotNull, currentContext->thrownException);
+   ASSERT2_EQUALS(Sz, OBJ_CLASS(currentContext->thrownException)->name, throwableAsCharP[NullPointerException]);
+   currentContext->thrownException = null;
+   // a method called once is compiled by the jumps backwards of its loop, which continues in the native code
+   // regI[0] = 0; for (regI[1] = 3000; regI[1] > 0; regI[1]--) regI[0] += 2;
+   lm.flags.isStatic = true;
+   lm.class_ = m->class_;
+   lm.code = newArrayOf(Code, 5, null);
+   lm.code[0].s18_reg.op = MOV_regI_s18;        lm.code[0].s18_reg.reg = 0; lm.code[0].s18_reg.s18 = 0;
+   lm.code[1].s18_reg.op = MOV_regI_s18;        lm.code[1].s18_reg.reg = 1; lm.code[1].s18_reg.s18 = 3000;
+   lm.code[2].inc.op = INC_regI;                lm.code[2].inc.reg = 0; lm.code[2].inc.s16 = 2;
+   lm.code[3].reg_desloc.op = DECJGTZ_regI;     lm.code[3].reg_desloc.reg = 1; lm.code[3].reg_desloc.desloc = -1;
+   executeMethod(currentContext, &lm);
+   ASSERT1_EQUALS(NotNull, lm.jitCode);
+   ASSERT2_EQUALS(I32, lm.jitCounter, JIT_THRESHOLD);
+   ASSERT2_EQUALS(I32, currentContext->regI[0], 6000);
+   ASSERT2_EQUALS(I32, currentContext->regI[1], 0);
+   // a method rejected by the jit is not compiled again
+   rm.flags.isStatic = true;
+   rm.class_ = m->class_;
+   rm.code = newArrayOf(Code, 2, null);
+   rm.code[0].s18_reg.op = MOV_regI_s18;        rm.code[0].s18_reg.reg = 0; rm.code[0].s18_reg.s18 = 5;
+   rm.jitCounter = JIT_THRESHOLD - 1;
+   executeMethod(currentContext, &rm);
+   executeMethod(currentContext, &rm);
+   ASSERT1_EQUALS(Null, rm.jitCode);
+   ASSERT2_EQUALS(I32, rm.jitCounter, JIT_THRESHOLD);
+   ASSERT2_EQUALS(I32, currentContext->regI[0], 5);
+finish:
+   currentContext->thrownException = null;
+   freeArray(jm.code);
+   freeArray(lm.code);
+   freeArray(rm.code);
+#else
+   TEST_SKIP;
+finish: ;
+#endif
+}
+TESTCASE(VM_Superinstructions) // the bounds checks of the counted loop must be removed, and the fused code must give the same results
+{
+   TMethod fm;
+   TCObject array;
+   int32 i, *v;
+   Method m = initMethod(currentContext,BREAK); // loads the test class and clears the registers
+   if (m == null)
+      TEST_ABORT;
+   xmemzero(&fm, sizeof(fm));
+   fm.flags.isStatic = true;
+   fm.class_ = m->class_;
+   fm.code = newArrayOf(Code, 8, null);
+   // regI[0] = 0; for (regI[1] = 0; regI[1] < regO[1].length; regI[1]++) regI[0] += regO[1][regI[1]];
+   fm.code[0].s18_reg.op = MOV_regI_s18;          fm.code[0].s18_reg.reg = 0; fm.code[0].s18_reg.s18 = 0;
+   fm.code[1].s18_reg.op = MOV_regI_s18;          fm.code[1].s18_reg.reg = 1; fm.code[1].s18_reg.s18 = 0;
+   fm.code[2].reg_arl_s12.op = JGE_regI_arlen;    fm.code[2].reg_arl_s12.regI = 1; fm.code[2].reg_arl_s12.base = 1; fm.code[2].reg_arl_s12.desloc = 5;
+   fm.code[3].reg_ar.op = MOV_regI_arc;           fm.code[3].reg_ar.reg = 2; fm.code[3].reg_ar.base = 1; fm.code[3].reg_ar.idx = 1;
+   fm.code[4].reg_reg_reg.op = ADD_regI_regI_regI; fm.code[4].reg_reg_reg.reg0 = 0; fm.code[4].reg_reg_reg.reg1 = 0; fm.code[4].reg_reg_reg.reg2 = 2;
+   fm.code[5].inc.op = INC_regI;                  fm.code[5].inc.reg = 1; fm.code[5].inc.s16 = 1;
+   fm.code[6].s24.op = JUMP_s24;                  fm.code[6].s24.desloc = -4;
+   fm.code[7].op.op = BREAK;
+
+   fuseInstructions(fm.class_->cp, &fm);
+   ASSERT2_EQUALS(I32, fm.code[3].op.op, MOV_regI_aru_ADD_regI_regI_regI); // unchecked, then fused with the add
+   ASSERT2_EQUALS(I32, fm.code[4].op.op, ADD_regI_regI_regI); // the second instruction is kept
+   ASSERT2_EQUALS(I32, fm.code[5].op.op, INC_regI_JUMP_s24);
+   ASSERT2_EQUALS(I32, unfusedOpcode(fm.code[5].op.op), INC_regI);
+
+   array = createArrayObject(currentContext, INT_ARRAY, 10);
+   setObjectLock(array, UNLOCKED);
+   v = (int32*)ARRAYOBJ_START(array);
+   for (i = 0; i < 10; i++)
+      v[i] = i * 6;
+   currentContext->regO[1] = array;
+   executeMethod(currentContext, &fm);
+   ASSERT1_EQUALS(Null, currentContext->thrownException);
+   ASSERT2_EQUALS(I32, currentContext->regI[0], 270);
+   ASSERT2_EQUALS(I32, currentContext->regI[1], 10);
+
+   // a negative start may index out of bounds: the check must be kept
+   fm.code[1].s18_reg.s18 = -1;
+   fm.code[3].reg_ar.op = MOV_regI_arc;
+   fuseInstructions(fm.class_->cp, &fm);
+   ASSERT2_EQUALS(I32, fm.code[3].op.op, MOV_regI_arc);
+   executeMethod(currentContext, &fm);
+   ASSERT1_EQUALS(NotNull, currentContext->thrownException);
+   ASSERT2_EQUALS(Sz, OBJ_CLASS(currentContext->thrownException)->name, throwableAsCharP[ArrayIndexOutOfBoundsException]);
+finish:
+   currentContext->thrownException = null;
+   freeArray(fm.code);
+}
+TESTCASE(VM_MONITOR_Enter) // uncontended enters must use the thin lock, deep ones inflate it, and exiting a monitor not held must fail
+{
+   TCObject o;
+   ObjectProperties op;
+   int32 i;
+   Method m = initMethod(currentContext,MONITOR_Enter);
+   if (m == null)
+      TEST_ABORT;
+   o = createArrayObject(currentContext, INT_ARRAY, 1);
+   setObjectLock(o, UNLOCKED);
+   op = OBJ_PROPERTIES(o);
+   currentContext->regO[1] = o;
+   m->code[0].reg_reg.reg0 = 1;
+   m->code[1].reg_reg.op = MONITOR_Enter;
+   m->code[1].reg_reg.reg0 = 1;
+   executeMethod(currentContext, m);
+   ASSERT1_EQUALS(Null, currentContext->thrownException);
+   ASSERT2_EQUALS(I32, op->classAndMonitor & OBJ_MONITOR_MASK, MONITOR_THIN);
+   ASSERT2_EQUALS(I32, currentContext->lockStackTop, 2); // entered twice
+   ASSERT2_EQUALS(Sz, OBJ_CLASS(o)->name, INT_ARRAY); // the class is not changed by the monitor
+   m->code[0].reg_reg.op = m->code[1].reg_reg.op = MONITOR_Exit;
+   executeMethod(currentContext, m);
+   ASSERT1_EQUALS(Null, currentContext->thrownException);
+   ASSERT2_EQUALS(I32, op->classAndMonitor & OBJ_MONITOR_MASK, MONITOR_UNLOCKED);
+   ASSERT2_EQUALS(I32, currentContext->lockStackTop, 0);
+   // exiting again is an error
+   m->code[1].reg_reg.op = BREAK;
+   executeMethod(currentContext, m);
+   ASSERT1_EQUALS(NotNull, currentContext->thrownException);
+   currentContext->thrownException = null;
+   ASSERT1_EQUALS(False, monitorExit(currentContext, o));
+   // more enters than the lockStack holds inflate the monitor, which then keeps being used
+   for (i = 0; i <= MONITOR_LOCK_STACK; i++)
+      ASSERT1_EQUALS(True, MONITOR_ENTER(currentContext, o));
+   ASSERT2_EQUALS(I32, op->classAndMonitor & OBJ_MONITOR_MASK, MONITOR_INFLATED);
+   ASSERT2_EQUALS(I32, currentContext->lockStackTop, 0);
+   for (i = 0; i <= MONITOR_LOCK_STACK; i++)
+      ASSERT1_EQUALS(True, monitorExit(currentContext, o));
+   ASSERT1_EQUALS(False, monitorExit(currentContext, o));
+   ASSERT1_EQUALS(True, MONITOR_ENTER(currentContext, o));
+   ASSERT2_EQUALS(I32, op->classAndMonitor & OBJ_MONITOR_MASK, MONITOR_INFLATED);
+   ASSERT1_EQUALS(True, monitorExit(currentContext, o));
+finish:
+   currentContext->thrownException = null;
+}
+TESTCASE(VM_ClassImage) // the classes restored from the image must be equal to the ones read from the tcz. Also compares the time to load them both ways
+{
+   CharP names[] = {"java.lang.Object", "java.lang.String", "java.lang.Throwable", "java.lang.OutOfMemoryError", "totalcross.ui.image.Image"};
+   char path[MAX_PATHNAME];
+   TCClass orig, c = null;
+   TCZFile tcz;
+   int32 i, j, k, ts, readTime = 0, restoreTime = 0;
+   bool opened = false;
+
+   if (classImageInUse) // the vm uses the image opened at startup, which can't be replaced
+      TEST_SKIP;
+   xstrprintf(path, "%s/test.tci", appPath);
+   ASSERT1_EQUALS(True, saveClassImage(path));
+   ASSERT1_EQUALS(True, opened = openClassImage(path));
+   for (i = 0; i < (int32)(sizeof(names) / sizeof(CharP)); i++)
+   {
+      if ((orig = loadClass(currentContext, names[i], false)) == null)
+         continue;
+      tcz = tczGetFile(names[i], true);
+      ASSERT1_EQUALS(NotNull, tcz);
+      ASSERT1_EQUALS(True, restoreClass(currentContext, tcz, names[i], &c));
+      tczClose(tcz);
+      ASSERT1_EQUALS(NotNull, c);
+      ASSERT2_EQUALS(Sz, c->name, orig->name);
+      ASSERT2_EQUALS(Ptr, c->cp, orig->cp);
+      ASSERT2_EQUALS(Ptr, c->superClass, orig->superClass);
+      ASSERT2_EQUALS(I32, ARRAYLENV(c->interfaces), ARRAYLENV(orig->interfaces));
+      ASSERT2_EQUALS(U32, c->objSize, orig->objSize);
+      ASSERT2_EQUALS(I32, ARRAYLENV(c->i32StaticValues), ARRAYLENV(orig->i32StaticValues));
+      ASSERT2_EQUALS(I32, ARRAYLENV(c->objInstanceFields), ARRAYLENV(orig->objInstanceFields));
+      ASSERT2_EQUALS(I32, ARRAYLENV(c->vtable), ARRAYLENV(orig->vtable));
+      ASSERT2_EQUALS(I32, ARRAYLENV(c->methods), ARRAYLENV(orig->methods));
+      for (j = ARRAYLENV(c->methods); --j >= 0;)
+      {
+         Method m1 = &c->methods[j], m2 = &orig->methods[j];
+         ASSERT2_EQUALS(Sz, m1->name, m2->name);
+         ASSERT2_EQUALS(Ptr, m1->class_, c);
+         ASSERT2_EQUALS(U16, m1->vtableIndex, m2->vtableIndex);
+         ASSERT2_EQUALS(I32, ARRAYLENV(m1->code), ARRAYLENV(m2->code));
+         if (m1->code != null)
+            ASSERT3_EQUALS(Block, m1->code, m2->code, ARRAYLEN(m1->code) * sizeof(TCode));
+         ASSERT2_EQUALS(I32, ARRAYLENV(m1->exceptionHandlers), ARRAYLENV(m2->exceptionHandlers));
+         for (k = ARRAYLENV(m1->exceptionHandlers); --k >= 0;)
+            ASSERT2_EQUALS(I32, (int32)(m1->exceptionHandlers[k].handlerPC - m1->code), (int32)(m2->exceptionHandlers[k].handlerPC - m2->code));
+      }
+      heapDestroy(c->heap);
+      c = null;
+
+      // the benchmark: parsing the class from the tcz versus restoring it from the image
+      for (k = 0; k < 20; k++)
+      {
+         ts = getTimeStamp();
+         tcz = tczGetFile(names[i], true);
+         c = readClass(currentContext, tcz->header->cp, tcz);
+         tczClose(tcz);
+         readTime += getTimeStamp() - ts;
+         if (c != null && c != CLASS_OUT_OF_MEMORY)
+            heapDestroy(c->heap);
+         ts = getTimeStamp();
+         tcz = tczGetFile(names[i], true);
+         restoreClass(currentContext, tcz, names[i], &c);
+         tczClose(tcz);
+         restoreTime += getTimeStamp() - ts;
+         if (c != null && c != CLASS_OUT_OF_MEMORY)
+            heapDestroy(c->heap);
+         c = null;
+      }
+   }
+   TEST_OUTPUT(tc, "class image: loading the classes 20 times took %d ms from the tcz and %d ms from the image", readTime, restoreTime);
+finish:
+   if (c != null && c != CLASS_OUT_OF_MEMORY)
+      heapDestroy(c->heap);
+   if (opened)
+      closeClassImage();
+}
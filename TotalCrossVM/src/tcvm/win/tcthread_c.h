@@ -38,6 +38,36 @@ static void privateThreadDestroy(ThreadHandle h, bool threadDestroyingItself)
    CloseHandle(h);
 }
 
+#if defined(WP8)
+// the emulated threads can't wait for events, so a parked context just polls the monitor again
+static bool privateInitParker(TParker* p) {*p = null; return true;}
+static void privateDestroyParker(TParker* p) {}
+static void privatePark(TParker* p) {Sleep(1);}
+static void privateUnpark(TParker* p) {}
+#else
+static bool privateInitParker(TParker* p)
+{
+   return (*p = CreateEvent(null, false, false, null)) != null;
+}
+
+static void privateDestroyParker(TParker* p)
+{
+   if (*p != null)
+      CloseHandle(*p);
+   *p = null;
+}
+
+static void privatePark(TParker* p)
+{
+   WaitForSingleObject(*p, INFINITE);
+}
+
+static void privateUnpark(TParker* p)
+{
+   SetEvent(*p);
+}
+#endif
+
 DWORD WINAPI privateThreadFunc(VoidP argP)
 {
    ThreadArgs targs = (ThreadArgs)argP;
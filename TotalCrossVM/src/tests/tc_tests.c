@@ -1,6 +1,6 @@
 #include "tcvm.h"
 
-#define TEST_COUNT 347
+#define TEST_COUNT 357
 
 // Function prototypes
 void test_VM_PrimitiveTypeSizes(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
@@ -8,6 +8,7 @@ void test_VM_TestSetJmp(struct TestSuite *tc, Context currentContext);// tcvm/tc
 void test_Stack(struct TestSuite *tc, Context currentContext);     // tcvm/objectmemorymanager_test.h
 void test_DblList(struct TestSuite *tc, Context currentContext);   // tcvm/objectmemorymanager_test.h
 void test_GarbageCollector(struct TestSuite *tc, Context currentContext);// tcvm/objectmemorymanager_test.h
+void test_YoungObjects(struct TestSuite *tc, Context currentContext);// tcvm/objectmemorymanager_test.h
 void test_VM_LoadTestTCZ(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
 void test_VM_BREAK(struct TestSuite *tc, Context currentContext);  // tcvm/tcvm_test.h
 void test_tiF_isCardInserted_i(struct TestSuite *tc, Context currentContext);// nm/io/File_test.h
@@ -349,6 +350,15 @@ void test_VM_z7_CALL_virtual(struct TestSuite *tc, Context currentContext);// tc
 void test__doubleToStr(struct TestSuite *tc, Context currentContext);// util/utils_test.h
 void test__str2double(struct TestSuite *tc, Context currentContext);// util/utils_test.h
 void test__str2int64(struct TestSuite *tc, Context currentContext);// util/utils_test.h
+void test_VM_JIT(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
+void test_VM_Superinstructions(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
+void test_VM_MONITOR_Enter(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
+void test_VM_ClassImage(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
+void test_PixelKernels(struct TestSuite *tc, Context currentContext);// nm/ui/gfx_Graphics_test.h
+void test_GlyphCache(struct TestSuite *tc, Context currentContext);// nm/ui/font_Font_test.h
+void test_DisplayList(struct TestSuite *tc, Context currentContext);// nm/ui/gfx_Graphics_test.h
+void test_TiledRaster(struct TestSuite *tc, Context currentContext);// nm/ui/gfx_Graphics_test.h
+void test_MinorCollections(struct TestSuite *tc, Context currentContext);// tcvm/objectmemorymanager_test.h
 void test_VM_Cleanup(struct TestSuite *tc, Context currentContext);// tcvm/tcvm_test.h
 
 #ifdef ENABLE_TEST_SUITE
@@ -701,7 +711,17 @@ void fillTestCaseArray(testFunc *tests)
    tests[343] = test__doubleToStr;
    tests[344] = test__str2double;
    tests[345] = test__str2int64;
-   tests[346] = test_VM_Cleanup;
+   tests[346] = test_YoungObjects;
+   tests[347] = test_VM_JIT;
+   tests[348] = test_VM_Superinstructions;
+   tests[349] = test_VM_MONITOR_Enter;
+   tests[350] = test_VM_ClassImage;
+   tests[351] = test_PixelKernels;
+   tests[352] = test_GlyphCache;
+   tests[353] = test_DisplayList;
+   tests[354] = test_TiledRaster;
+   tests[355] = test_MinorCollections;
+   tests[356] = test_VM_Cleanup;
 }
 
 void startTestSuite(Context currentContext)
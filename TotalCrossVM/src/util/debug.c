@@ -22,6 +22,10 @@ void repaintActiveWindows(Context currentContext);
 ///////////////////////////////////////////////////////////////////////////
 //                                Debug                                  //
 ///////////////////////////////////////////////////////////////////////////
+#ifdef TRACK_OPCODE_PAIRS
+extern uint32 opcodePairs[OPCODE_LENGTH][OPCODE_LENGTH];
+#endif
+
 static char debugstrSmall[64]; // used during startup and exit, when debugstr is not valid, for SHORT MESSAGES!
 
 bool initDebug()
@@ -39,6 +43,27 @@ void destroyDebug()
    for (i =0; i <=255 ; i++)
       if (usedOpcodes[i] > 0)
          debug("%3d",i);
+#endif
+#ifdef TRACK_OPCODE_PAIRS
+   {
+      // dumps the most frequent pairs, which are the candidates to become superinstructions
+      int32 i, j, k, bestI, bestJ;
+      debug("===========\nMost frequent opcode pairs (first, second: count):");
+      for (k = 0; k < 64; k++)
+      {
+         for (i = bestI = bestJ = 0; i < OPCODE_LENGTH; i++)
+            for (j = 0; j < OPCODE_LENGTH; j++)
+               if (opcodePairs[i][j] > opcodePairs[bestI][bestJ])
+               {
+                  bestI = i;
+                  bestJ = j;
+               }
+         if (opcodePairs[bestI][bestJ] == 0)
+            break;
+         debug("%3d, %3d: %u", bestI, bestJ, opcodePairs[bestI][bestJ]);
+         opcodePairs[bestI][bestJ] = 0;
+      }
+   }
 #endif
    privateDestroyDebug();
    free(debugstr);
@@ -6,6 +6,11 @@
 #include "tcvm.h"
 #include "tcz.h"
 
+#ifdef TCZ_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #ifdef ANDROID // in Android, we use Java methods to read directly from the apk
 int32 callFindTCZ(CharP name)
 {
@@ -49,6 +54,9 @@ static int32 callReadTCZ(int32 apkIdx, uint8* buf, int32 offset, int32 length)
     . compressed names array (length)
     . compressed data chunks
 
+    An entry whose uncompressed size is negative was stored without compression (hot classes); its
+    data chunk is copied straight from the file, which, when mapped, costs only the page faults.
+
     The first record is the class that implements totalcross.MainClass.
 */
 
@@ -62,6 +70,18 @@ static bool tczReadMore(TCZFile f)
 {
    int32 n;
    bool ret = true;
+#ifdef TCZ_MMAP
+   if (f->header->map != null) // the input is the mapped file itself: no lock, no copy
+   {
+      n = f->header->mapSize - f->expectedFilePos;
+      if (n <= 0)
+         return false;
+      f->zs.next_in = f->header->map + f->expectedFilePos;
+      f->zs.avail_in = n;
+      f->expectedFilePos += n;
+      return true;
+   }
+#endif
    LOCKVAR(tcz);
 #ifdef ANDROID
    n = callReadTCZ(f->header->apkIdx, f->buf, f->expectedFilePos, TCZ_BUFFER_SIZE);
@@ -82,10 +102,38 @@ static bool tczReadMore(TCZFile f)
    return ret;
 }
 
+static int32 tczReadStored(TCZFile f, uint8* outBuf, int32 count)
+{
+   z_stream *zs = &f->zs;
+   int32 n, done = 0;
+   if (count > f->storedRemain)
+      count = f->storedRemain;
+   while (done < count)
+   {
+      if (zs->avail_in == 0 && !tczReadMore(f))
+      {
+         if (f->tempHeap != null)
+            HEAP_ERROR(f->tempHeap, HEAP_ZIP_ERROR);
+         else
+            debug("Error on stored tcz entry. Remain %d bytes",(int)(count - done));
+         break;
+      }
+      n = min32(count - done, (int32)zs->avail_in);
+      xmemmove(outBuf + done, zs->next_in, n);
+      zs->next_in += n;
+      zs->avail_in -= n;
+      done += n;
+   }
+   f->storedRemain -= done;
+   return done;
+}
+
 int32 tczRead(TCZFile f, void* outBuf, int32 count)
 {
    int32 err=0;
    z_stream *zs = &f->zs;
+   if (f->storedRemain >= 0)
+      return tczReadStored(f, (uint8*)outBuf, count);
    zs->avail_out = count;
    zs->next_out = outBuf;
    if (count == 0)
@@ -158,6 +206,11 @@ static void tczFinalizer(Heap heap, void* bag)
 {
    TCZFileHeader header = (TCZFileHeader)bag;
    UNUSED(heap);
+#ifdef TCZ_MMAP
+   if (header->map != null)
+      munmap(header->map, header->mapSize);
+   header->map = null;
+#endif
    fclose(header->fin);
    header->fin = null;
 }
@@ -171,12 +224,8 @@ static TCZFile tczNewInstance(TCZFile parent)
    ntcz = newX(TCZFile); // don't use the heap
    if (!ntcz)
       return null;
-   if (parent) // not first instance?
-   {
+   if (parent) // not first instance? nothing is allocated in the shared heap, so this can run concurrently
       ntcz->header = parent->header;
-      IF_HEAP_ERROR(ntcz->header->hheap)
-         goto error;
-   }
    else
    {
       hheap = heapCreate();
@@ -190,10 +239,11 @@ static TCZFile tczNewInstance(TCZFile parent)
    }
    //debug("tczNewInstance tcz %d from header %d - %d",(int32)ntcz, (int32)ntcz->header, ntcz->header->instanceCount);
    ntcz->zs.opaque = ntcz->header->hheap;
+   ntcz->storedRemain = -1;
    err = inflateInit(&ntcz->zs);
    if (err != Z_OK)
       goto error;
-   ntcz->header->instanceCount++;
+   ATOMIC_ADD(&ntcz->header->instanceCount, 1);
    return ntcz;
 error:
    if (hheap) heapDestroy(hheap);
@@ -201,6 +251,35 @@ error:
    return null;
 }
 
+uint32 tczEntriesCRC(TCZFileHeader h)
+{
+   int32 n = ARRAYLEN(h->names), pos = h->offsets[0], end = h->offsets[n], len;
+   uLong crc = crc32(0L, Z_NULL, 0);
+   uint8 buf[TCZ_BUFFER_SIZE];
+#ifdef TCZ_MMAP
+   if (h->map != null) // the mapped file is used directly
+      return (uint32)crc32(crc, h->map + pos, min32(end, h->mapSize) - pos);
+#endif
+   LOCKVAR(tcz);
+#ifndef ANDROID
+   fseek(h->fin, pos, SEEK_SET);
+#endif
+   for (; pos < end; pos += len)
+   {
+#ifdef ANDROID
+      len = callReadTCZ(h->apkIdx, buf, pos, min32(TCZ_BUFFER_SIZE, end - pos));
+#else
+      len = (int32)fread(buf, 1, min32(TCZ_BUFFER_SIZE, end - pos), h->fin);
+#endif
+      if (len <= 0)
+         break;
+      crc = crc32(crc, buf, len);
+   }
+   h->realFilePos = pos;
+   UNLOCKVAR(tcz);
+   return (uint32)crc;
+}
+
 void tczClose(TCZFile tcz)
 {
    if (tcz)
@@ -209,7 +288,7 @@ void tczClose(TCZFile tcz)
       inflateEnd(&tcz->zs);
       // remove the tcz from the list. Note that the first tcz added is usually the last one deleted; the exception to this is when we get an error while loading the constant pool.
       openTCZs = VoidPsRemove(openTCZs, tcz, null);
-      if (--tcz->header->instanceCount == 0) // if there are no more instances, destroy the heap
+      if (ATOMIC_ADD(&tcz->header->instanceCount, -1) == 0) // if there are no more instances, destroy the heap
       {
          // destroy the heaps
          if (tcz->header->cp)
@@ -246,7 +325,11 @@ static int32 findNamePosition(TCZFile tcz, CharP name)
 TCZFile tczFindName(TCZFile tcz, CharP name) // locates the name and also positions the stream at the place to start reading it
 {
    TCZFile ntcz = null;
-   int32 pos;
+   int32 pos, size;
+#ifdef TCZ_MMAP
+   bool mapped = tcz->header->map != null; // the names and offsets are read-only, and each instance reads from its own position in the map
+   if (!mapped)
+#endif
    LOCKVAR(tcz);
    pos = findNamePosition(tcz, name);
    if (pos == -1)
@@ -254,12 +337,24 @@ TCZFile tczFindName(TCZFile tcz, CharP name) // locates the name and also positi
    ntcz = tczNewInstance(tcz);
    if (!ntcz)
       goto end;
-   ntcz->header->realFilePos = ntcz->expectedFilePos = ntcz->header->offsets[pos];
+   ntcz->expectedFilePos = ntcz->header->offsets[pos];
+#ifdef TCZ_MMAP
+   if (!mapped)
+#endif
+   {
+      ntcz->header->realFilePos = ntcz->expectedFilePos;
 #ifndef ANDROID   
-   fseek(ntcz->header->fin, ntcz->expectedFilePos, SEEK_SET);
+      fseek(ntcz->header->fin, ntcz->expectedFilePos, SEEK_SET);
 #endif   
-   ntcz->uncompressedSize = tcz->header->uncompressedSizes[pos];
+   }
+   size = tcz->header->uncompressedSizes[pos];
+   if (TCZ_IS_STORED(size))
+      ntcz->storedRemain = size = -size;
+   ntcz->uncompressedSize = size;
 end:
+#ifdef TCZ_MMAP
+   if (!mapped)
+#endif
    UNLOCKVAR(tcz);
    return ntcz;
 }
@@ -320,6 +415,20 @@ TCZFile tczOpen(FILE* fin, CharP fileName)
    tcz->header->apkIdx = apkIdx;
 #else      
    tcz->header->fin = fin;
+#ifdef TCZ_MMAP
+   {
+      struct stat st;
+      if (fstat(fileno(fin), &st) == 0 && st.st_size > 0)
+      {
+         void* map = mmap(null, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(fin), 0);
+         if (map != MAP_FAILED) // if the map fails, fall back to fread
+         {
+            tcz->header->map = (uint8*)map;
+            tcz->header->mapSize = (int32)st.st_size;
+         }
+      }
+   }
+#endif
 #endif   
    tcz->header->version = version;
    tcz->header->attr = attr;
@@ -396,7 +505,8 @@ TCZFile tczLoad(Context currentContext, CharP tczName)
             return null;
          }
          t->header->cp = newXH(ConstantPool, cpHeap);
-         readConstantPool(currentContext, t->header->cp, t2, cpHeap);
+         if (!restoreConstantPool(currentContext, t->header->cp, t, cpHeap))
+            readConstantPool(currentContext, t->header->cp, t2, cpHeap);
          tczClose(t2);
       }
    }
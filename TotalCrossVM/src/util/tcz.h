@@ -20,6 +20,14 @@
 #define ATTR_WINDOWSIZE_600X800 256
 
 #define TCZ_BUFFER_SIZE 4096
+
+// on posix systems the whole tcz is mapped in memory, so entries are read without the tcz lock nor copies
+#if !defined(ANDROID) && !defined(WIN32)
+ #define TCZ_MMAP
+#endif
+
+/// An entry whose uncompressed size is stored negated was written without compression (see the /u deploy option)
+#define TCZ_IS_STORED(size) ((size) < 0)
 typedef struct TTCZFile TTCZFile;
 typedef TTCZFile* TCZFile;
 
@@ -38,7 +46,12 @@ struct TTCZFileHeader // common members to all instances
 #else      
    FILE* fin;
 #endif   
-   int32 instanceCount;
+#ifdef TCZ_MMAP
+   uint8* map; // the whole file, or null if it could not be mapped
+   int32 mapSize;
+#endif
+   int32 classImageIdx; // index+1 of this tcz in the class image, -1 if it is not there, 0 if not checked yet
+   int32 instanceCount; // changed atomically, since instances are created outside the tcz lock
    int32 realFilePos; // the current seek position
    ConstantPool cp; // this is the Global constant pool that came in this tcz file
    Heap hheap;
@@ -54,6 +67,7 @@ struct TTCZFile
    int32 expectedFilePos; // the expected seek position (may change if several instances are processing the same file)
    Heap tempHeap; // can be assigned by the user to branch to an error handler if something wrong happens
    int32 uncompressedSize;
+   int32 storedRemain; // bytes left of an uncompressed entry, or -1 if the entry must be inflated
    z_stream zs;
 };
 
@@ -87,6 +101,8 @@ TCZFile tczOpen(FILE* fin, CharP fileName);
 TCZFile tczLoad(Context currentContext, CharP tczName);
 /// Locates the given filename in all loaded tcz files, "strict" mode prevents mainClass package lookup
 TCZFile tczGetFile(CharP filename, bool strict);
+/// Returns the CRC32 of the compressed data of all entries of the tcz, which changes when any of them changes
+uint32 tczEntriesCRC(TCZFileHeader h);
 
 void destroyTCZ();
 